@@ -0,0 +1,1233 @@
+/*****************************************************************************
+ * bench.c
+ *****************************************************************************
+ * Copyright (C) 2026 L-SMASH project
+ *
+ * Authors: agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *****************************************************************************/
+
+/* This file is available under an ISC license. */
+
+/* A benchmark harness for regression tracking.
+ * All inputs are synthesized locally, and each benchmark reports one JSON object per line. */
+
+#include "cli.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#endif
+
+#include "importer/importer.h"
+
+#define eprintf( ... ) fprintf( stderr, __VA_ARGS__ )
+
+#define BENCH_PATH_MAX  1024
+
+typedef struct
+{
+    const char *dir;
+    const char *only;
+    FILE       *out;
+    uint32_t    frames;         /* the number of video frames in each elementary stream */
+    uint32_t    samples;        /* the number of video samples in each muxed movie */
+    uint32_t    fetches;        /* the number of random sample fetches */
+    uint64_t    seed;
+    int         keep;
+    int         failures;
+} bench_t;
+
+typedef struct
+{
+    const char *name;
+    const char *file_name;
+    const char *format;
+} bench_es_t;
+
+static const bench_es_t bench_es[] =
+{
+    { "h264", "bench.264",  "H.264" },
+    { "hevc", "bench.265",  "HEVC"  },
+    { "adts", "bench.aac",  "adts"  },
+    { "ac3",  "bench.ac3",  "AC-3"  },
+    { "wave", "bench.wav",  "WAVE"  },
+    { NULL,   NULL,         NULL    }
+};
+
+typedef enum
+{
+    BENCH_MUX_PLAIN     = 0,
+    BENCH_MUX_FASTSTART = 1,
+    BENCH_MUX_FRAGMENT  = 2,
+} bench_mux_mode;
+
+static const char *bench_mux_name[3]      = { "plain", "faststart", "fragment" };
+static const char *bench_mux_file_name[3] = { "bench_plain.mp4", "bench_faststart.mp4", "bench_fragment.mp4" };
+
+/* Remuxing reads the output of the muxing for 'src'. */
+typedef struct
+{
+    const char    *name;
+    const char    *file_name;
+    bench_mux_mode src;
+    bench_mux_mode dst;
+} bench_remux_t;
+
+static const bench_remux_t bench_remux[] =
+{
+    { "plain_to_fragment",     "bench_remux_fragment.mp4",  BENCH_MUX_PLAIN,    BENCH_MUX_FRAGMENT  },
+    { "fragment_to_faststart", "bench_remux_faststart.mp4", BENCH_MUX_FRAGMENT, BENCH_MUX_FASTSTART },
+    { NULL,                    NULL,                        0,                  0                   }
+};
+
+static void display_help( void )
+{
+    eprintf( "\n"
+             "L-SMASH benchmark harness rev%s  %s\n"
+             "Built on %s %s\n"
+             "\n"
+             "Usage: bench [options]\n"
+             "  options:\n"
+             "    --help            Display help\n"
+             "    --dir <path>      Directory for the synthetic inputs and outputs [.]\n"
+             "    --output <path>   Output the results into a file instead of stdout\n"
+             "    --frames <n>      Number of video frames in each elementary stream [3000]\n"
+             "    --samples <n>     Number of video samples in each muxed movie [500000]\n"
+             "                      Audio samples over the same duration are added.\n"
+             "    --fetches <n>     Number of random sample fetches [10000]\n"
+             "    --seed <n>        Seed for the synthetic inputs [1]\n"
+             "    --only <name>     Run only the benchmarks whose names contain <name>\n"
+             "    --keep            Don't remove the synthetic inputs and outputs\n"
+             "\n"
+             "Each result is output as a JSON object per line.\n",
+             LSMASH_REV, LSMASH_GIT_HASH, __DATE__, __TIME__ );
+}
+
+/*---- utilities ----*/
+static uint64_t bench_random( uint64_t *state )
+{
+    /* xorshift64* */
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * UINT64_C(2685821657736338717);
+}
+
+static uint32_t bench_random_range( uint64_t *state, uint32_t min, uint32_t max )
+{
+    return min + (uint32_t)((bench_random( state ) >> 32) % (max - min + 1));
+}
+
+static double bench_now( void )
+{
+#ifdef _WIN32
+    LARGE_INTEGER count;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter( &count );
+    QueryPerformanceFrequency( &frequency );
+    return (double)count.QuadPart / frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+static long bench_peak_rss( void )
+{
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if( getrusage( RUSAGE_SELF, &usage ) )
+        return 0;
+    /* ru_maxrss is in kilobytes except on macOS. */
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static const char *bench_path( bench_t *bench, const char *file_name, char *path )
+{
+    snprintf( path, BENCH_PATH_MAX, "%s/%s", bench->dir, file_name );
+    return path;
+}
+
+static int bench_enabled( bench_t *bench, const char *name )
+{
+    return !bench->only || strstr( name, bench->only );
+}
+
+static void bench_report
+(
+    bench_t              *bench,
+    const char           *name,
+    uint64_t              items,
+    uint64_t              bytes,
+    double                seconds,
+    const lsmash_stats_t *before
+)
+{
+    lsmash_stats_t after;
+    lsmash_get_stats( &after );
+    if( seconds <= 0 )
+        seconds = 1e-9;
+    fprintf( bench->out,
+             "{\"name\":\"%s\",\"items\":%"PRIu64",\"bytes\":%"PRIu64",\"seconds\":%.6f,"
+             "\"items_per_sec\":%.1f,\"mib_per_sec\":%.3f,\"peak_rss_kib\":%ld,"
+             "\"bytes_read\":%"PRIu64",\"bytes_written\":%"PRIu64","
+             "\"boxes_parsed\":%"PRIu64",\"boxes_written\":%"PRIu64"}\n",
+             name, items, bytes, seconds,
+             items / seconds, bytes / seconds / (1024.0 * 1024.0), bench_peak_rss(),
+             after.bytes_read    - before->bytes_read,
+             after.bytes_written - before->bytes_written,
+             after.boxes_parsed  - before->boxes_parsed,
+             after.boxes_written - before->boxes_written );
+    fflush( bench->out );
+}
+
+static void bench_report_error( bench_t *bench, const char *name, const char *message )
+{
+    fprintf( bench->out, "{\"name\":\"%s\",\"error\":\"%s\"}\n", name, message );
+    fflush( bench->out );
+    ++ bench->failures;
+}
+
+/* Run a benchmark in a child process so that the peak RSS is measured for each benchmark. */
+typedef int (*bench_func)( bench_t *bench, const void *arg );
+
+static void bench_run( bench_t *bench, const char *name, bench_func func, const void *arg )
+{
+    if( !bench_enabled( bench, name ) )
+        return;
+    fflush( bench->out );
+#ifdef _WIN32
+    if( func( bench, arg ) < 0 )
+        bench_report_error( bench, name, "failed" );
+#else
+    pid_t pid = fork();
+    if( pid < 0 )
+    {
+        bench_report_error( bench, name, "failed to fork" );
+        return;
+    }
+    if( pid == 0 )
+    {
+        int ret = func( bench, arg );
+        fflush( bench->out );
+        _exit( ret < 0 ? 1 : 0 );
+    }
+    int status;
+    if( waitpid( pid, &status, 0 ) != pid || !WIFEXITED( status ) )
+        bench_report_error( bench, name, "crashed" );
+    else if( WEXITSTATUS( status ) )
+        bench_report_error( bench, name, "failed" );
+#endif
+}
+
+/*---- synthetic elementary streams ----*/
+typedef struct
+{
+    uint8_t  data[64];
+    uint32_t pos;       /* in bits */
+} bench_bits_t;
+
+static void bits_put( bench_bits_t *bits, uint32_t width, uint32_t value )
+{
+    while( width-- )
+    {
+        if( (bits->pos & 7) == 0 )
+            bits->data[ bits->pos >> 3 ] = 0;
+        if( (value >> width) & 1 )
+            bits->data[ bits->pos >> 3 ] |= 0x80 >> (bits->pos & 7);
+        ++ bits->pos;
+    }
+}
+
+static void bits_put_ue( bench_bits_t *bits, uint32_t value )
+{
+    uint32_t length = 0;
+    for( uint32_t code = value + 1; code > 1; code >>= 1 )
+        ++length;
+    bits_put( bits, length, 0 );
+    bits_put( bits, length + 1, value + 1 );
+}
+
+static void bits_put_trailing( bench_bits_t *bits )
+{
+    bits_put( bits, 1, 1 );
+    while( bits->pos & 7 )
+        bits_put( bits, 1, 0 );
+}
+
+/* Write a NAL unit with emulation prevention.
+ * The payload following the header is filled with random nonzero bytes. */
+static int write_nalu( FILE *fp, bench_bits_t *header, uint32_t payload_size, uint64_t *state )
+{
+    static const uint8_t start_code[4] = { 0x00, 0x00, 0x00, 0x01 };
+    if( fwrite( start_code, 1, 4, fp ) != 4 )
+        return -1;
+    uint32_t zeros = 0;
+    for( uint32_t i = 0; i < (header->pos >> 3); i++ )
+    {
+        uint8_t byte = header->data[i];
+        if( zeros >= 2 && byte <= 0x03 )
+        {
+            fputc( 0x03, fp );
+            zeros = 0;
+        }
+        fputc( byte, fp );
+        zeros = byte ? 0 : zeros + 1;
+    }
+    if( zeros >= 2 && payload_size )
+        fputc( 0x03, fp );
+    uint8_t buf[4096];
+    while( payload_size )
+    {
+        uint32_t size = payload_size < sizeof(buf) ? payload_size : sizeof(buf);
+        for( uint32_t i = 0; i < size; i++ )
+            buf[i] = (uint8_t)(bench_random( state ) % 255 + 1);
+        if( fwrite( buf, 1, size, fp ) != size )
+            return -1;
+        payload_size -= size;
+    }
+    return 0;
+}
+
+/* A 320x240 progressive stream of I and P pictures with 24 frames per GOP. */
+#define BENCH_GOP_LENGTH 24
+
+static uint32_t bench_picture_size( uint64_t *state, int idr )
+{
+    return idr ? bench_random_range( state, 40000, 90000 ) : bench_random_range( state, 4000, 20000 );
+}
+
+static int generate_h264( bench_t *bench, const char *path, uint64_t *state )
+{
+    FILE *fp = fopen( path, "wb" );
+    if( !fp )
+        return -1;
+    int err = 0;
+    for( uint32_t i = 0; i < bench->frames && !err; i++ )
+    {
+        int idr = (i % BENCH_GOP_LENGTH) == 0;
+        bench_bits_t bits = { { 0 }, 0 };
+        if( idr )
+        {
+            /* SPS */
+            bits_put( &bits, 8, 0x67 );
+            bits_put( &bits, 8, 66 );       /* profile_idc: Baseline */
+            bits_put( &bits, 8, 0xC0 );     /* constraint_set0_flag and constraint_set1_flag */
+            bits_put( &bits, 8, 30 );       /* level_idc */
+            bits_put_ue( &bits, 0 );        /* seq_parameter_set_id */
+            bits_put_ue( &bits, 0 );        /* log2_max_frame_num_minus4 */
+            bits_put_ue( &bits, 2 );        /* pic_order_cnt_type */
+            bits_put_ue( &bits, 1 );        /* max_num_ref_frames */
+            bits_put( &bits, 1, 0 );        /* gaps_in_frame_num_value_allowed_flag */
+            bits_put_ue( &bits, 19 );       /* pic_width_in_mbs_minus1 */
+            bits_put_ue( &bits, 14 );       /* pic_height_in_map_units_minus1 */
+            bits_put( &bits, 1, 1 );        /* frame_mbs_only_flag */
+            bits_put( &bits, 1, 1 );        /* direct_8x8_inference_flag */
+            bits_put( &bits, 1, 0 );        /* frame_cropping_flag */
+            bits_put( &bits, 1, 0 );        /* vui_parameters_present_flag */
+            bits_put_trailing( &bits );
+            err = write_nalu( fp, &bits, 0, state );
+            /* PPS */
+            bits.pos = 0;
+            bits_put( &bits, 8, 0x68 );
+            bits_put_ue( &bits, 0 );        /* pic_parameter_set_id */
+            bits_put_ue( &bits, 0 );        /* seq_parameter_set_id */
+            bits_put( &bits, 1, 0 );        /* entropy_coding_mode_flag */
+            bits_put( &bits, 1, 0 );        /* bottom_field_pic_order_in_frame_present_flag */
+            bits_put_ue( &bits, 0 );        /* num_slice_groups_minus1 */
+            bits_put_ue( &bits, 0 );        /* num_ref_idx_l0_default_active_minus1 */
+            bits_put_ue( &bits, 0 );        /* num_ref_idx_l1_default_active_minus1 */
+            bits_put( &bits, 1, 0 );        /* weighted_pred_flag */
+            bits_put( &bits, 2, 0 );        /* weighted_bipred_idc */
+            bits_put_ue( &bits, 0 );        /* pic_init_qp_minus26 */
+            bits_put_ue( &bits, 0 );        /* pic_init_qs_minus26 */
+            bits_put_ue( &bits, 0 );        /* chroma_qp_index_offset */
+            bits_put( &bits, 1, 1 );        /* deblocking_filter_control_present_flag */
+            bits_put( &bits, 1, 0 );        /* constrained_intra_pred_flag */
+            bits_put( &bits, 1, 0 );        /* redundant_pic_cnt_present_flag */
+            bits_put_trailing( &bits );
+            err |= write_nalu( fp, &bits, 0, state );
+            bits.pos = 0;
+        }
+        /* slice header */
+        bits_put( &bits, 8, idr ? 0x65 : 0x41 );
+        bits_put_ue( &bits, 0 );                            /* first_mb_in_slice */
+        bits_put_ue( &bits, idr ? 7 : 5 );                  /* slice_type: all I or all P */
+        bits_put_ue( &bits, 0 );                            /* pic_parameter_set_id */
+        bits_put( &bits, 4, i % BENCH_GOP_LENGTH );         /* frame_num */
+        if( idr )
+            bits_put_ue( &bits, (i / BENCH_GOP_LENGTH) & 1 );   /* idr_pic_id */
+        else
+        {
+            bits_put( &bits, 1, 0 );                        /* num_ref_idx_active_override_flag */
+            bits_put( &bits, 1, 0 );                        /* ref_pic_list_modification_flag_l0 */
+        }
+        bits_put( &bits, 1, 0 );        /* no_output_of_prior_pics_flag or adaptive_ref_pic_marking_mode_flag */
+        if( idr )
+            bits_put( &bits, 1, 0 );    /* long_term_reference_flag */
+        bits_put_ue( &bits, 0 );        /* slice_qp_delta */
+        bits_put_ue( &bits, 1 );        /* disable_deblocking_filter_idc */
+        bits_put_trailing( &bits );
+        err |= write_nalu( fp, &bits, bench_picture_size( state, idr ), state );
+    }
+    fclose( fp );
+    return err;
+}
+
+static void bits_put_hevc_ptl( bench_bits_t *bits )
+{
+    bits_put( bits, 2, 0 );             /* general_profile_space */
+    bits_put( bits, 1, 0 );             /* general_tier_flag */
+    bits_put( bits, 5, 1 );             /* general_profile_idc: Main */
+    bits_put( bits, 32, 0x60000000 );   /* general_profile_compatibility_flags */
+    bits_put( bits, 1, 1 );             /* general_progressive_source_flag */
+    bits_put( bits, 1, 0 );             /* general_interlaced_source_flag */
+    bits_put( bits, 1, 0 );             /* general_non_packed_constraint_flag */
+    bits_put( bits, 1, 1 );             /* general_frame_only_constraint_flag */
+    bits_put( bits, 32, 0 );            /* general_reserved_zero_43bits and general_inbld_flag */
+    bits_put( bits, 12, 0 );
+    bits_put( bits, 8, 63 );            /* general_level_idc */
+}
+
+static int generate_hevc( bench_t *bench, const char *path, uint64_t *state )
+{
+    FILE *fp = fopen( path, "wb" );
+    if( !fp )
+        return -1;
+    int err = 0;
+    for( uint32_t i = 0; i < bench->frames && !err; i++ )
+    {
+        int idr = (i % BENCH_GOP_LENGTH) == 0;
+        bench_bits_t bits = { { 0 }, 0 };
+        if( idr )
+        {
+            /* VPS */
+            bits_put( &bits, 16, 32 << 9 | 1 );
+            bits_put( &bits, 4, 0 );        /* vps_video_parameter_set_id */
+            bits_put( &bits, 1, 1 );        /* vps_base_layer_internal_flag */
+            bits_put( &bits, 1, 1 );        /* vps_base_layer_available_flag */
+            bits_put( &bits, 6, 0 );        /* vps_max_layers_minus1 */
+            bits_put( &bits, 3, 0 );        /* vps_max_sub_layers_minus1 */
+            bits_put( &bits, 1, 1 );        /* vps_temporal_id_nesting_flag */
+            bits_put( &bits, 16, 0xFFFF );  /* vps_reserved_0xffff_16bits */
+            bits_put_hevc_ptl( &bits );
+            bits_put( &bits, 1, 1 );        /* vps_sub_layer_ordering_info_present_flag */
+            bits_put_ue( &bits, 1 );        /* vps_max_dec_pic_buffering_minus1 */
+            bits_put_ue( &bits, 0 );        /* vps_max_num_reorder_pics */
+            bits_put_ue( &bits, 0 );        /* vps_max_latency_increase_plus1 */
+            bits_put( &bits, 6, 0 );        /* vps_max_layer_id */
+            bits_put_ue( &bits, 0 );        /* vps_num_layer_sets_minus1 */
+            bits_put( &bits, 1, 0 );        /* vps_timing_info_present_flag */
+            bits_put( &bits, 1, 0 );        /* vps_extension_flag */
+            bits_put_trailing( &bits );
+            err = write_nalu( fp, &bits, 0, state );
+            /* SPS */
+            bits.pos = 0;
+            bits_put( &bits, 16, 33 << 9 | 1 );
+            bits_put( &bits, 4, 0 );        /* sps_video_parameter_set_id */
+            bits_put( &bits, 3, 0 );        /* sps_max_sub_layers_minus1 */
+            bits_put( &bits, 1, 1 );        /* sps_temporal_id_nesting_flag */
+            bits_put_hevc_ptl( &bits );
+            bits_put_ue( &bits, 0 );        /* sps_seq_parameter_set_id */
+            bits_put_ue( &bits, 1 );        /* chroma_format_idc */
+            bits_put_ue( &bits, 320 );      /* pic_width_in_luma_samples */
+            bits_put_ue( &bits, 240 );      /* pic_height_in_luma_samples */
+            bits_put( &bits, 1, 0 );        /* conformance_window_flag */
+            bits_put_ue( &bits, 0 );        /* bit_depth_luma_minus8 */
+            bits_put_ue( &bits, 0 );        /* bit_depth_chroma_minus8 */
+            bits_put_ue( &bits, 4 );        /* log2_max_pic_order_cnt_lsb_minus4 */
+            bits_put( &bits, 1, 1 );        /* sps_sub_layer_ordering_info_present_flag */
+            bits_put_ue( &bits, 1 );        /* sps_max_dec_pic_buffering_minus1 */
+            bits_put_ue( &bits, 0 );        /* sps_max_num_reorder_pics */
+            bits_put_ue( &bits, 0 );        /* sps_max_latency_increase_plus1 */
+            bits_put_ue( &bits, 0 );        /* log2_min_luma_coding_block_size_minus3 */
+            bits_put_ue( &bits, 1 );        /* log2_diff_max_min_luma_coding_block_size */
+            bits_put_ue( &bits, 0 );        /* log2_min_luma_transform_block_size_minus2 */
+            bits_put_ue( &bits, 2 );        /* log2_diff_max_min_luma_transform_block_size */
+            bits_put_ue( &bits, 0 );        /* max_transform_hierarchy_depth_inter */
+            bits_put_ue( &bits, 0 );        /* max_transform_hierarchy_depth_intra */
+            bits_put( &bits, 1, 0 );        /* scaling_list_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* amp_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* sample_adaptive_offset_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* pcm_enabled_flag */
+            bits_put_ue( &bits, 0 );        /* num_short_term_ref_pic_sets */
+            bits_put( &bits, 1, 0 );        /* long_term_ref_pics_present_flag */
+            bits_put( &bits, 1, 0 );        /* sps_temporal_mvp_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* strong_intra_smoothing_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* vui_parameters_present_flag */
+            bits_put( &bits, 1, 0 );        /* sps_extension_present_flag */
+            bits_put_trailing( &bits );
+            err |= write_nalu( fp, &bits, 0, state );
+            /* PPS */
+            bits.pos = 0;
+            bits_put( &bits, 16, 34 << 9 | 1 );
+            bits_put_ue( &bits, 0 );        /* pps_pic_parameter_set_id */
+            bits_put_ue( &bits, 0 );        /* pps_seq_parameter_set_id */
+            bits_put( &bits, 1, 0 );        /* dependent_slice_segments_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* output_flag_present_flag */
+            bits_put( &bits, 3, 0 );        /* num_extra_slice_header_bits */
+            bits_put( &bits, 1, 0 );        /* sign_data_hiding_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* cabac_init_present_flag */
+            bits_put_ue( &bits, 0 );        /* num_ref_idx_l0_default_active_minus1 */
+            bits_put_ue( &bits, 0 );        /* num_ref_idx_l1_default_active_minus1 */
+            bits_put_ue( &bits, 0 );        /* init_qp_minus26 */
+            bits_put( &bits, 1, 0 );        /* constrained_intra_pred_flag */
+            bits_put( &bits, 1, 0 );        /* transform_skip_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* cu_qp_delta_enabled_flag */
+            bits_put_ue( &bits, 0 );        /* pps_cb_qp_offset */
+            bits_put_ue( &bits, 0 );        /* pps_cr_qp_offset */
+            bits_put( &bits, 1, 0 );        /* pps_slice_chroma_qp_offsets_present_flag */
+            bits_put( &bits, 1, 0 );        /* weighted_pred_flag */
+            bits_put( &bits, 1, 0 );        /* weighted_bipred_flag */
+            bits_put( &bits, 1, 0 );        /* transquant_bypass_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* tiles_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* entropy_coding_sync_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* pps_loop_filter_across_slices_enabled_flag */
+            bits_put( &bits, 1, 0 );        /* deblocking_filter_control_present_flag */
+            bits_put( &bits, 1, 0 );        /* pps_scaling_list_data_present_flag */
+            bits_put( &bits, 1, 0 );        /* lists_modification_present_flag */
+            bits_put_ue( &bits, 0 );        /* log2_parallel_merge_level_minus2 */
+            bits_put( &bits, 1, 0 );        /* slice_segment_header_extension_present_flag */
+            bits_put( &bits, 1, 0 );        /* pps_extension_present_flag */
+            bits_put_trailing( &bits );
+            err |= write_nalu( fp, &bits, 0, state );
+            bits.pos = 0;
+        }
+        /* slice segment header */
+        bits_put( &bits, 16, (idr ? 19 : 1) << 9 | 1 );    /* IDR_W_RADL or TRAIL_R */
+        bits_put( &bits, 1, 1 );                            /* first_slice_segment_in_pic_flag */
+        if( idr )
+            bits_put( &bits, 1, 0 );                        /* no_output_of_prior_pics_flag */
+        bits_put_ue( &bits, 0 );                            /* slice_pic_parameter_set_id */
+        bits_put_ue( &bits, idr ? 2 : 1 );                  /* slice_type: I or P */
+        if( !idr )
+        {
+            bits_put( &bits, 8, i % BENCH_GOP_LENGTH );     /* slice_pic_order_cnt_lsb */
+            bits_put( &bits, 1, 0 );                        /* short_term_ref_pic_set_sps_flag */
+            bits_put_ue( &bits, 1 );                        /* num_negative_pics */
+            bits_put_ue( &bits, 0 );                        /* num_positive_pics */
+            bits_put_ue( &bits, 0 );                        /* delta_poc_s0_minus1 */
+            bits_put( &bits, 1, 1 );                        /* used_by_curr_pic_s0_flag */
+            bits_put( &bits, 1, 0 );                        /* num_ref_idx_active_override_flag */
+            bits_put_ue( &bits, 0 );                        /* five_minus_max_num_merge_cand */
+        }
+        bits_put_ue( &bits, 0 );                            /* slice_qp_delta */
+        bits_put_trailing( &bits );                         /* byte_alignment() */
+        err |= write_nalu( fp, &bits, bench_picture_size( state, idr ), state );
+    }
+    fclose( fp );
+    return err;
+}
+
+/* Audio streams have twice as many frames as the video streams, which is roughly the same duration. */
+static int generate_adts( bench_t *bench, const char *path, uint64_t *state )
+{
+    FILE *fp = fopen( path, "wb" );
+    if( !fp )
+        return -1;
+    uint8_t frame[8192];
+    int err = 0;
+    for( uint32_t i = 0; i < 2 * bench->frames && !err; i++ )
+    {
+        uint32_t frame_length = bench_random_range( state, 300, 800 );
+        frame[0] = 0xFF;
+        frame[1] = 0xF1;                        /* MPEG-4, layer 0, protection_absent */
+        frame[2] = (1 << 6) | (3 << 2);         /* AAC LC, 48kHz */
+        frame[3] = (2 << 6) | (frame_length >> 11);
+        frame[4] = (frame_length >> 3) & 0xFF;
+        frame[5] = ((frame_length & 0x07) << 5) | 0x1F;
+        frame[6] = 0xFC;                        /* adts_buffer_fullness = 0x7FF, one raw data block */
+        for( uint32_t j = 7; j < frame_length; j++ )
+            frame[j] = (uint8_t)bench_random( state );
+        err = fwrite( frame, 1, frame_length, fp ) != frame_length;
+    }
+    fclose( fp );
+    return err ? -1 : 0;
+}
+
+static int generate_ac3( bench_t *bench, const char *path, uint64_t *state )
+{
+    FILE *fp = fopen( path, "wb" );
+    if( !fp )
+        return -1;
+    uint8_t frame[1536];    /* 384kbps at 48kHz */
+    int err = 0;
+    for( uint32_t i = 0; i < 2 * bench->frames && !err; i++ )
+    {
+        frame[0] = 0x0B;
+        frame[1] = 0x77;
+        frame[2] = 0x00;
+        frame[3] = 0x00;
+        frame[4] = 0x1C;    /* fscod = 0, frmsizecod = 28 */
+        frame[5] = 0x40;    /* bsid = 8, bsmod = 0 */
+        frame[6] = 0x40;    /* acmod = 2, dsurmod = 0, lfeon = 0 */
+        for( uint32_t j = 7; j < sizeof(frame); j++ )
+            frame[j] = (uint8_t)bench_random( state );
+        err = fwrite( frame, 1, sizeof(frame), fp ) != sizeof(frame);
+    }
+    fclose( fp );
+    return err ? -1 : 0;
+}
+
+static void put_le( uint8_t *p, uint32_t value, int size )
+{
+    for( int i = 0; i < size; i++ )
+        p[i] = (value >> (8 * i)) & 0xFF;
+}
+
+static int generate_wave( bench_t *bench, const char *path, uint64_t *state )
+{
+    FILE *fp = fopen( path, "wb" );
+    if( !fp )
+        return -1;
+    /* 48kHz 16-bit stereo over the same duration as the video streams at 24fps */
+    uint32_t data_size = (uint32_t)((uint64_t)bench->frames * 48000 / 24 * 4);
+    uint8_t header[44];
+    memcpy( header, "RIFF", 4 );
+    put_le( header + 4, 36 + data_size, 4 );
+    memcpy( header + 8, "WAVEfmt ", 8 );
+    put_le( header + 16, 16, 4 );
+    put_le( header + 20, 1, 2 );            /* WAVE_FORMAT_PCM */
+    put_le( header + 22, 2, 2 );
+    put_le( header + 24, 48000, 4 );
+    put_le( header + 28, 48000 * 4, 4 );
+    put_le( header + 32, 4, 2 );
+    put_le( header + 34, 16, 2 );
+    memcpy( header + 36, "data", 4 );
+    put_le( header + 40, data_size, 4 );
+    int err = fwrite( header, 1, 44, fp ) != 44;
+    uint8_t buf[4096];
+    while( data_size && !err )
+    {
+        uint32_t size = data_size < sizeof(buf) ? data_size : sizeof(buf);
+        for( uint32_t i = 0; i < size; i++ )
+            buf[i] = (uint8_t)bench_random( state );
+        err = fwrite( buf, 1, size, fp ) != size;
+        data_size -= size;
+    }
+    fclose( fp );
+    return err ? -1 : 0;
+}
+
+static int generate_es( bench_t *bench )
+{
+    typedef int (*generator)( bench_t *, const char *, uint64_t * );
+    static const generator generators[] = { generate_h264, generate_hevc, generate_adts, generate_ac3, generate_wave };
+    for( int i = 0; bench_es[i].name; i++ )
+    {
+        char path[BENCH_PATH_MAX];
+        uint64_t state = bench->seed + i + 1;
+        if( generators[i]( bench, bench_path( bench, bench_es[i].file_name, path ), &state ) < 0 )
+        {
+            eprintf( "Error: failed to generate %s.\n", path );
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*---- importers ----*/
+static int bench_import( bench_t *bench, const void *arg )
+{
+    const bench_es_t *es = (const bench_es_t *)arg;
+    char name[64];
+    char path[BENCH_PATH_MAX];
+    bench_path( bench, es->file_name, path );
+    lsmash_root_t *root = lsmash_create_root();
+    if( !root )
+        return -1;
+    lsmash_stats_t stats;
+    lsmash_get_stats( &stats );
+    double start = bench_now();
+    importer_t *importer = lsmash_importer_open( root, path, es->format );
+    double end = bench_now();
+    if( !importer )
+    {
+        lsmash_destroy_root( root );
+        return -1;
+    }
+    sprintf( name, "import.%s.probe", es->name );
+    bench_report( bench, name, 1, 0, end - start, &stats );
+    lsmash_get_stats( &stats );
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    int ret = 0;
+    start = bench_now();
+    while( 1 )
+    {
+        lsmash_sample_t *sample = NULL;
+        ret = lsmash_importer_get_access_unit( importer, 1, &sample );
+        if( ret < 0 || ret == 2 )
+        {
+            lsmash_delete_sample( sample );
+            break;
+        }
+        if( sample )
+        {
+            ++count;
+            bytes += sample->length;
+            lsmash_delete_sample( sample );
+        }
+    }
+    end = bench_now();
+    lsmash_importer_close( importer );
+    lsmash_destroy_root( root );
+    if( ret < 0 )
+        return -1;
+    sprintf( name, "import.%s.get_access_unit", es->name );
+    bench_report( bench, name, count, bytes, end - start, &stats );
+    return 0;
+}
+
+/*---- muxing ----*/
+static lsmash_summary_t *bench_get_summary( bench_t *bench, const char *file_name, const char *format )
+{
+    char path[BENCH_PATH_MAX];
+    lsmash_root_t *root = lsmash_create_root();
+    if( !root )
+        return NULL;
+    importer_t *importer = lsmash_importer_open( root, bench_path( bench, file_name, path ), format );
+    lsmash_summary_t *summary = importer ? lsmash_duplicate_summary( importer, 1 ) : NULL;
+    lsmash_importer_close( importer );
+    lsmash_destroy_root( root );
+    return summary;
+}
+
+static uint32_t bench_add_track
+(
+    lsmash_root_t           *root,
+    lsmash_media_type        media_type,
+    uint32_t                 timescale,
+    lsmash_summary_t        *summary
+)
+{
+    uint32_t track_ID = lsmash_create_track( root, media_type );
+    if( !track_ID )
+        return 0;
+    lsmash_track_parameters_t track_param;
+    lsmash_initialize_track_parameters( &track_param );
+    track_param.mode = ISOM_TRACK_ENABLED | ISOM_TRACK_IN_MOVIE | ISOM_TRACK_IN_PREVIEW;
+    if( media_type == ISOM_MEDIA_HANDLER_TYPE_VIDEO_TRACK )
+    {
+        track_param.display_width  = 320 << 16;
+        track_param.display_height = 240 << 16;
+    }
+    else
+        track_param.audio_volume = 0x0100;
+    lsmash_media_parameters_t media_param;
+    lsmash_initialize_media_parameters( &media_param );
+    media_param.timescale = timescale;
+    if( lsmash_set_track_parameters( root, track_ID, &track_param )
+     || lsmash_set_media_parameters( root, track_ID, &media_param )
+     || lsmash_add_sample_entry( root, track_ID, summary ) == 0 )
+        return 0;
+    return track_ID;
+}
+
+static int bench_mux( bench_t *bench, const void *arg )
+{
+    bench_mux_mode mode = *(const bench_mux_mode *)arg;
+    lsmash_summary_t *video_summary = bench_get_summary( bench, "bench.264", "H.264" );
+    lsmash_summary_t *audio_summary = bench_get_summary( bench, "bench.aac", "adts" );
+    uint8_t *data = malloc( 256 );
+    lsmash_root_t *root = lsmash_create_root();
+    lsmash_file_parameters_t file_param = { 0 };
+    char path[BENCH_PATH_MAX];
+    int err = -1;
+    if( !video_summary || !audio_summary || !data || !root
+     || lsmash_open_file( bench_path( bench, bench_mux_file_name[mode], path ), 0, &file_param ) < 0 )
+        goto fail;
+    lsmash_brand_type brands[4] = { ISOM_BRAND_TYPE_ISOM, ISOM_BRAND_TYPE_ISO6, ISOM_BRAND_TYPE_AVC1, ISOM_BRAND_TYPE_MP41 };
+    file_param.major_brand   = ISOM_BRAND_TYPE_ISOM;
+    file_param.brands        = brands;
+    file_param.brand_count   = 4;
+    file_param.minor_version = 0;
+    if( mode == BENCH_MUX_FRAGMENT )
+        file_param.mode |= LSMASH_FILE_MODE_FRAGMENTED;
+    if( !lsmash_set_file( root, &file_param ) )
+        goto fail;
+    lsmash_movie_parameters_t movie_param;
+    lsmash_initialize_movie_parameters( &movie_param );
+    movie_param.timescale = 600;
+    if( lsmash_set_movie_parameters( root, &movie_param ) )
+        goto fail;
+    uint32_t video_track_ID = bench_add_track( root, ISOM_MEDIA_HANDLER_TYPE_VIDEO_TRACK, 24000, video_summary );
+    uint32_t audio_track_ID = bench_add_track( root, ISOM_MEDIA_HANDLER_TYPE_AUDIO_TRACK, 48000, audio_summary );
+    if( !video_track_ID || !audio_track_ID )
+        goto fail;
+    uint64_t state = bench->seed;
+    for( int i = 0; i < 256; i++ )
+        data[i] = (uint8_t)bench_random( &state );
+    /* 24000/1001 fps video and 48kHz audio with 1024 samples per frame */
+    uint64_t video_count = bench->samples;
+    uint64_t audio_count = video_count * 1001 * 48000 / (24000 * 1024);
+    uint64_t video_done  = 0;
+    uint64_t audio_done  = 0;
+    uint64_t bytes       = 0;
+    lsmash_stats_t stats;
+    lsmash_get_stats( &stats );
+    double start = bench_now();
+    while( video_done < video_count || audio_done < audio_count )
+    {
+        /* Interleave in decoding order. */
+        int is_video = audio_done >= audio_count
+                    || (video_done < video_count && video_done * 1001 * 48000 <= audio_done * 1024 * 24000);
+        uint32_t length = is_video ? bench_random_range( &state, 4, 67 ) : bench_random_range( &state, 4, 35 );
+        lsmash_sample_t *sample = lsmash_create_sample( length );
+        if( !sample )
+            goto fail;
+        memcpy( sample->data, data, length );
+        sample->index = 1;
+        if( is_video )
+        {
+            int sync = (video_done % BENCH_GOP_LENGTH) == 0;
+            if( mode == BENCH_MUX_FRAGMENT && sync && video_done )
+            {
+                if( lsmash_flush_pooled_samples( root, video_track_ID, 1001 )
+                 || lsmash_flush_pooled_samples( root, audio_track_ID, 1024 )
+                 || lsmash_create_fragment_movie( root ) )
+                {
+                    lsmash_delete_sample( sample );
+                    goto fail;
+                }
+            }
+            sample->dts = video_done * 1001;
+            sample->cts = sample->dts + 2002;
+            sample->prop.ra_flags = sync ? ISOM_SAMPLE_RANDOM_ACCESS_FLAG_SYNC : ISOM_SAMPLE_RANDOM_ACCESS_FLAG_NONE;
+            ++video_done;
+        }
+        else
+        {
+            sample->dts = audio_done * 1024;
+            sample->cts = sample->dts;
+            sample->prop.ra_flags = ISOM_SAMPLE_RANDOM_ACCESS_FLAG_SYNC;
+            ++audio_done;
+        }
+        bytes += length;
+        if( lsmash_append_sample( root, is_video ? video_track_ID : audio_track_ID, sample ) )
+            goto fail;
+    }
+    if( lsmash_flush_pooled_samples( root, video_track_ID, 1001 )
+     || lsmash_flush_pooled_samples( root, audio_track_ID, 1024 ) )
+        goto fail;
+    double end = bench_now();
+    char name[64];
+    sprintf( name, "mux.%s.append_sample", bench_mux_name[mode] );
+    bench_report( bench, name, video_done + audio_done, bytes, end - start, &stats );
+    lsmash_get_stats( &stats );
+    lsmash_adhoc_remux_t remux = { 4 * 1024 * 1024, NULL, NULL };
+    start = bench_now();
+    if( lsmash_finish_movie( root, mode == BENCH_MUX_FASTSTART ? &remux : NULL ) )
+        goto fail;
+    end = bench_now();
+    sprintf( name, "mux.%s.finish_movie", bench_mux_name[mode] );
+    bench_report( bench, name, video_done + audio_done, bytes, end - start, &stats );
+    err = 0;
+fail:
+    lsmash_cleanup_summary( video_summary );
+    lsmash_cleanup_summary( audio_summary );
+    free( data );
+    lsmash_destroy_root( root );
+    lsmash_close_file( &file_param );
+    return err;
+}
+
+/*---- demuxing ----*/
+static int bench_demux( bench_t *bench, const void *arg )
+{
+    bench_mux_mode mode = *(const bench_mux_mode *)arg;
+    char path[BENCH_PATH_MAX];
+    char name[64];
+    lsmash_root_t *root = lsmash_create_root();
+    lsmash_file_parameters_t file_param = { 0 };
+    int err = -1;
+    if( !root || lsmash_open_file( bench_path( bench, bench_mux_file_name[mode], path ), 1, &file_param ) < 0 )
+        goto fail;
+    lsmash_file_t *file = lsmash_set_file( root, &file_param );
+    if( !file )
+        goto fail;
+    lsmash_stats_t stats;
+    lsmash_get_stats( &stats );
+    double start = bench_now();
+    int64_t file_size = lsmash_read_file( file, &file_param );
+    double end = bench_now();
+    if( file_size < 0 )
+        goto fail;
+    lsmash_stats_t after;
+    lsmash_get_stats( &after );
+    sprintf( name, "demux.%s.read_file", bench_mux_name[mode] );
+    bench_report( bench, name, after.boxes_parsed - stats.boxes_parsed, after.bytes_read - stats.bytes_read, end - start, &stats );
+    /* timeline construction */
+    lsmash_movie_parameters_t movie_param;
+    lsmash_initialize_movie_parameters( &movie_param );
+    if( lsmash_get_movie_parameters( root, &movie_param ) )
+        goto fail;
+    uint64_t sample_count = 0;
+    lsmash_get_stats( &stats );
+    start = bench_now();
+    for( uint32_t i = 1; i <= movie_param.number_of_tracks; i++ )
+    {
+        uint32_t track_ID = lsmash_get_track_ID( root, i );
+        if( lsmash_construct_timeline( root, track_ID ) )
+            goto fail;
+        sample_count += lsmash_get_sample_count_in_media_timeline( root, track_ID );
+    }
+    end = bench_now();
+    sprintf( name, "demux.%s.construct_timeline", bench_mux_name[mode] );
+    bench_report( bench, name, sample_count, 0, end - start, &stats );
+    /* random sample fetch from the first track */
+    uint32_t track_ID = lsmash_get_track_ID( root, 1 );
+    uint32_t count    = lsmash_get_sample_count_in_media_timeline( root, track_ID );
+    if( count == 0 )
+        goto fail;
+    uint64_t state = bench->seed;
+    uint64_t bytes = 0;
+    lsmash_get_stats( &stats );
+    start = bench_now();
+    for( uint32_t i = 0; i < bench->fetches; i++ )
+    {
+        lsmash_sample_t *sample = lsmash_get_sample_from_media_timeline( root, track_ID, bench_random_range( &state, 1, count ) );
+        if( !sample )
+            goto fail;
+        bytes += sample->length;
+        lsmash_delete_sample( sample );
+    }
+    end = bench_now();
+    sprintf( name, "demux.%s.random_fetch", bench_mux_name[mode] );
+    bench_report( bench, name, bench->fetches, bytes, end - start, &stats );
+    err = 0;
+fail:
+    lsmash_destroy_root( root );
+    lsmash_close_file( &file_param );
+    return err;
+}
+
+/*---- remuxing ----*/
+#define BENCH_REMUX_MAX_TRACKS 8
+
+typedef struct
+{
+    uint32_t         in_track_ID;
+    uint32_t         out_track_ID;
+    uint32_t         timescale;
+    uint32_t         last_sample_delta;
+    uint32_t         sample_number;     /* the number of the next sample to fetch */
+    lsmash_sample_t *sample;            /* the sample fetched and not appended yet */
+} bench_remux_track_t;
+
+static int bench_remux_fetch( lsmash_root_t *root, bench_remux_track_t *track )
+{
+    track->sample = lsmash_get_sample_from_media_timeline( root, track->in_track_ID, track->sample_number );
+    if( track->sample )
+    {
+        ++ track->sample_number;
+        return 0;
+    }
+    /* No more samples if the next one doesn't exist. */
+    return lsmash_check_sample_existence_in_media_timeline( root, track->in_track_ID, track->sample_number ) ? -1 : 0;
+}
+
+static int bench_remux_run( bench_t *bench, const void *arg )
+{
+    const bench_remux_t *remux_case = (const bench_remux_t *)arg;
+    bench_remux_track_t track[BENCH_REMUX_MAX_TRACKS] = { { 0 } };
+    uint32_t num_tracks = 0;
+    char path[BENCH_PATH_MAX];
+    char name[64];
+    lsmash_root_t *in_root  = lsmash_create_root();
+    lsmash_root_t *out_root = lsmash_create_root();
+    lsmash_file_parameters_t in_param  = { 0 };
+    lsmash_file_parameters_t out_param = { 0 };
+    int err = -1;
+    if( !in_root || !out_root
+     || lsmash_open_file( bench_path( bench, bench_mux_file_name[ remux_case->src ], path ), 1, &in_param ) < 0 )
+        goto fail;
+    lsmash_file_t *in_file = lsmash_set_file( in_root, &in_param );
+    if( !in_file || lsmash_read_file( in_file, &in_param ) < 0 )
+        goto fail;
+    lsmash_movie_parameters_t movie_param;
+    lsmash_initialize_movie_parameters( &movie_param );
+    if( lsmash_get_movie_parameters( in_root, &movie_param )
+     || movie_param.number_of_tracks == 0
+     || movie_param.number_of_tracks > BENCH_REMUX_MAX_TRACKS
+     || lsmash_open_file( bench_path( bench, remux_case->file_name, path ), 0, &out_param ) < 0 )
+        goto fail;
+    lsmash_brand_type brands[4] = { ISOM_BRAND_TYPE_ISOM, ISOM_BRAND_TYPE_ISO6, ISOM_BRAND_TYPE_AVC1, ISOM_BRAND_TYPE_MP41 };
+    out_param.major_brand   = ISOM_BRAND_TYPE_ISOM;
+    out_param.brands        = brands;
+    out_param.brand_count   = 4;
+    out_param.minor_version = 0;
+    if( remux_case->dst == BENCH_MUX_FRAGMENT )
+        out_param.mode |= LSMASH_FILE_MODE_FRAGMENTED;
+    if( !lsmash_set_file( out_root, &out_param ) )
+        goto fail;
+    num_tracks = movie_param.number_of_tracks;
+    lsmash_initialize_movie_parameters( &movie_param );
+    movie_param.timescale = 600;
+    if( lsmash_set_movie_parameters( out_root, &movie_param ) )
+        goto fail;
+    for( uint32_t i = 0; i < num_tracks; i++ )
+    {
+        bench_remux_track_t *t = &track[i];
+        t->in_track_ID   = lsmash_get_track_ID( in_root, i + 1 );
+        t->sample_number = 1;
+        lsmash_track_parameters_t track_param;
+        lsmash_media_parameters_t media_param;
+        lsmash_initialize_track_parameters( &track_param );
+        lsmash_initialize_media_parameters( &media_param );
+        if( !t->in_track_ID
+         || lsmash_get_track_parameters( in_root, t->in_track_ID, &track_param )
+         || lsmash_get_media_parameters( in_root, t->in_track_ID, &media_param )
+         || lsmash_construct_timeline( in_root, t->in_track_ID )
+         || lsmash_get_last_sample_delta_from_media_timeline( in_root, t->in_track_ID, &t->last_sample_delta ) )
+            goto fail;
+        t->timescale    = media_param.timescale;
+        t->out_track_ID = lsmash_create_track( out_root, media_param.handler_type );
+        if( !t->out_track_ID )
+            goto fail;
+        track_param.track_ID = t->out_track_ID;
+        lsmash_summary_t *summary = lsmash_get_summary( in_root, t->in_track_ID, 1 );
+        int ret = summary
+               && !lsmash_set_track_parameters( out_root, t->out_track_ID, &track_param )
+               && !lsmash_set_media_parameters( out_root, t->out_track_ID, &media_param )
+               && lsmash_add_sample_entry( out_root, t->out_track_ID, summary ) != 0;
+        lsmash_cleanup_summary( summary );
+        if( !ret )
+            goto fail;
+    }
+    uint64_t items = 0;
+    uint64_t bytes = 0;
+    lsmash_stats_t stats;
+    lsmash_get_stats( &stats );
+    double start = bench_now();
+    /* The initial movie of a fragmented output has no samples. */
+    if( remux_case->dst == BENCH_MUX_FRAGMENT && lsmash_create_fragment_movie( out_root ) )
+        goto fail;
+    for( uint32_t i = 0; i < num_tracks; i++ )
+        if( bench_remux_fetch( in_root, &track[i] ) < 0 )
+            goto fail;
+    while( 1 )
+    {
+        /* Append the sample with the smallest DTS in seconds. */
+        bench_remux_track_t *t = NULL;
+        for( uint32_t i = 0; i < num_tracks; i++ )
+            if( track[i].sample
+             && (!t || (double)track[i].sample->dts / track[i].timescale < (double)t->sample->dts / t->timescale) )
+                t = &track[i];
+        if( !t )
+            break;
+        lsmash_sample_t *sample = t->sample;
+        t->sample = NULL;
+        /* Each movie fragment starts at a random access point of the first track. */
+        if( remux_case->dst == BENCH_MUX_FRAGMENT
+         && t == &track[0]
+         && t->sample_number > 2
+         && sample->prop.ra_flags != ISOM_SAMPLE_RANDOM_ACCESS_FLAG_NONE )
+        {
+            for( uint32_t i = 0; i < num_tracks; i++ )
+                if( lsmash_flush_pooled_samples( out_root, track[i].out_track_ID, track[i].last_sample_delta ) )
+                {
+                    lsmash_delete_sample( sample );
+                    goto fail;
+                }
+            if( lsmash_create_fragment_movie( out_root ) )
+            {
+                lsmash_delete_sample( sample );
+                goto fail;
+            }
+        }
+        ++items;
+        bytes += sample->length;
+        if( lsmash_append_sample( out_root, t->out_track_ID, sample ) )
+        {
+            lsmash_delete_sample( sample );
+            goto fail;
+        }
+        if( bench_remux_fetch( in_root, t ) < 0 )
+            goto fail;
+    }
+    for( uint32_t i = 0; i < num_tracks; i++ )
+        if( lsmash_flush_pooled_samples( out_root, track[i].out_track_ID, track[i].last_sample_delta ) )
+            goto fail;
+    double end = bench_now();
+    sprintf( name, "remux.%s.append_sample", remux_case->name );
+    bench_report( bench, name, items, bytes, end - start, &stats );
+    lsmash_get_stats( &stats );
+    lsmash_adhoc_remux_t remux = { 4 * 1024 * 1024, NULL, NULL };
+    start = bench_now();
+    if( lsmash_finish_movie( out_root, remux_case->dst == BENCH_MUX_FASTSTART ? &remux : NULL ) )
+        goto fail;
+    end = bench_now();
+    sprintf( name, "remux.%s.finish_movie", remux_case->name );
+    bench_report( bench, name, items, bytes, end - start, &stats );
+    err = 0;
+fail:
+    for( uint32_t i = 0; i < num_tracks; i++ )
+        lsmash_delete_sample( track[i].sample );
+    lsmash_destroy_root( in_root );
+    lsmash_destroy_root( out_root );
+    lsmash_close_file( &in_param );
+    lsmash_close_file( &out_param );
+    return err;
+}
+
+static void remove_files( bench_t *bench )
+{
+    char path[BENCH_PATH_MAX];
+    for( int i = 0; bench_es[i].name; i++ )
+        remove( bench_path( bench, bench_es[i].file_name, path ) );
+    for( int i = 0; i < 3; i++ )
+        remove( bench_path( bench, bench_mux_file_name[i], path ) );
+    for( int i = 0; bench_remux[i].name; i++ )
+        remove( bench_path( bench, bench_remux[i].file_name, path ) );
+}
+
+static int parse_count( const char *arg, uint32_t *count )
+{
+    char *end;
+    unsigned long value = strtoul( arg, &end, 10 );
+    if( *end || value == 0 || value > UINT32_MAX )
+        return -1;
+    *count = (uint32_t)value;
+    return 0;
+}
+
+int main( int argc, char *argv[] )
+{
+    bench_t bench = { 0 };
+    bench.dir     = ".";
+    bench.out     = stdout;
+    bench.frames  = 3000;
+    bench.samples = 500000;
+    bench.fetches = 10000;
+    bench.seed    = 1;
+    const char *output = NULL;
+    for( int i = 1; i < argc; i++ )
+    {
+        int has_value = i + 1 < argc;
+        if( !strcasecmp( argv[i], "--help" ) || !strcasecmp( argv[i], "-h" ) )
+        {
+            display_help();
+            return 0;
+        }
+        else if( !strcasecmp( argv[i], "--keep" ) )
+            bench.keep = 1;
+        else if( has_value && !strcasecmp( argv[i], "--dir" ) )
+            bench.dir = argv[++i];
+        else if( has_value && !strcasecmp( argv[i], "--output" ) )
+            output = argv[++i];
+        else if( has_value && !strcasecmp( argv[i], "--only" ) )
+            bench.only = argv[++i];
+        else if( has_value && !strcasecmp( argv[i], "--frames" ) )
+        {
+            if( parse_count( argv[++i], &bench.frames ) < 0 )
+                goto invalid;
+        }
+        else if( has_value && !strcasecmp( argv[i], "--samples" ) )
+        {
+            if( parse_count( argv[++i], &bench.samples ) < 0 )
+                goto invalid;
+        }
+        else if( has_value && !strcasecmp( argv[i], "--fetches" ) )
+        {
+            if( parse_count( argv[++i], &bench.fetches ) < 0 )
+                goto invalid;
+        }
+        else if( has_value && !strcasecmp( argv[i], "--seed" ) )
+            bench.seed = strtoull( argv[++i], NULL, 10 ) | 1;
+        else
+        {
+invalid:
+            eprintf( "Error: invalid option %s.\n", argv[i] );
+            display_help();
+            return 1;
+        }
+    }
+    if( output && !(bench.out = fopen( output, "w" )) )
+    {
+        eprintf( "Error: failed to open %s.\n", output );
+        return 1;
+    }
+    fprintf( bench.out, "{\"suite\":\"lsmash-bench\",\"version\":\"%d.%d.%d\",\"rev\":\"%s\",\"hash\":\"%s\","
+                        "\"frames\":%"PRIu32",\"samples\":%"PRIu32",\"fetches\":%"PRIu32",\"seed\":%"PRIu64"}\n",
+             LSMASH_VERSION_MAJOR, LSMASH_VERSION_MINOR, LSMASH_VERSION_MICRO, LSMASH_REV, LSMASH_GIT_HASH,
+             bench.frames, bench.samples, bench.fetches, bench.seed );
+    if( generate_es( &bench ) < 0 )
+    {
+        remove_files( &bench );
+        return 1;
+    }
+    for( int i = 0; bench_es[i].name; i++ )
+    {
+        char name[64];
+        sprintf( name, "import.%s", bench_es[i].name );
+        bench_run( &bench, name, bench_import, &bench_es[i] );
+    }
+    /* The demuxing and remuxing benchmarks read the outputs of the muxing ones. */
+    static const bench_mux_mode modes[3] = { BENCH_MUX_PLAIN, BENCH_MUX_FASTSTART, BENCH_MUX_FRAGMENT };
+    for( int i = 0; i < 3; i++ )
+    {
+        char name[64];
+        sprintf( name, "mux.%s", bench_mux_name[i] );
+        int enabled = bench_enabled( &bench, name );
+        sprintf( name, "demux.%s", bench_mux_name[i] );
+        enabled |= bench_enabled( &bench, name );
+        for( int j = 0; bench_remux[j].name; j++ )
+        {
+            sprintf( name, "remux.%s", bench_remux[j].name );
+            enabled |= bench_remux[j].src == modes[i] && bench_enabled( &bench, name );
+        }
+        if( !enabled )
+            continue;
+        /* Always mux so that the input for the demuxing is present. */
+        const char *only = bench.only;
+        bench.only = NULL;
+        sprintf( name, "mux.%s", bench_mux_name[i] );
+        bench_run( &bench, name, bench_mux, &modes[i] );
+        bench.only = only;
+        sprintf( name, "demux.%s", bench_mux_name[i] );
+        bench_run( &bench, name, bench_demux, &modes[i] );
+    }
+    for( int i = 0; bench_remux[i].name; i++ )
+    {
+        char name[64];
+        sprintf( name, "remux.%s", bench_remux[i].name );
+        bench_run( &bench, name, bench_remux_run, &bench_remux[i] );
+    }
+    if( !bench.keep )
+        remove_files( &bench );
+    if( output )
+        fclose( bench.out );
+    return bench.failures ? 1 : 0;
+}
@@ -46,13 +46,17 @@ static void display_help( void )
 {
     display_version();
     eprintf( "\n"
-             "Usage: boxdumper [option] input\n"
+             "Usage: boxdumper [options] input\n"
              "  options:\n"
              "    --help         Display help\n"
              "    --version      Display version information\n"
              "    --box          Dump box structure\n"
              "    --chapter      Extract chapter list\n"
-             "    --timestamp    Dump media timestamps\n" );
+             "    --timestamp    Dump media timestamps\n"
+             "    --json         Output box structure or media timestamps in JSON\n"
+             "    --cbor         Output box structure or media timestamps in CBOR\n"
+             "                   Media timestamps are output column by column together with\n"
+             "                   the sizes, the offsets and the random access flags of samples.\n" );
 }
 
 static int boxdumper_error
@@ -90,27 +94,28 @@ int main( int argc, char *argv[] )
     }
     int dump_box = 1;
     int chapter = 0;
+    lsmash_print_format format = LSMASH_PRINT_FORMAT_TEXT;
     char *filename;
     lsmash_get_mainargs( &argc, &argv );
-    if( argc > 2 )
+    for( int i = 1; i < argc - 1; i++ )
     {
-        if( !strcasecmp( argv[1], "--box" ) )
+        if( !strcasecmp( argv[i], "--box" ) )
             DO_NOTHING;
-        else if( !strcasecmp( argv[1], "--chapter" ) )
+        else if( !strcasecmp( argv[i], "--chapter" ) )
             chapter = 1;
-        else if( !strcasecmp( argv[1], "--timestamp" ) )
+        else if( !strcasecmp( argv[i], "--timestamp" ) )
             dump_box = 0;
+        else if( !strcasecmp( argv[i], "--json" ) )
+            format = LSMASH_PRINT_FORMAT_JSON;
+        else if( !strcasecmp( argv[i], "--cbor" ) )
+            format = LSMASH_PRINT_FORMAT_CBOR;
         else
         {
             display_help();
             return -1;
         }
-        filename = argv[2];
-    }
-    else
-    {
-        filename = argv[1];
     }
+    filename = argv[argc - 1];
     /* Open the input file. */
     lsmash_root_t *root = lsmash_create_root();
     if( !root )
@@ -126,6 +131,14 @@ int main( int argc, char *argv[] )
     lsmash_file_t *file = lsmash_set_file( root, &file_param );
     if( !file )
         return BOXDUMPER_ERR( "Failed to add a file into a ROOT.\n" );
+    if( dump_box && !chapter )
+    {
+        /* Print each box as soon as it is read so that huge fragmented files can be dumped. */
+        if( lsmash_print_movie_streaming( root, "-", format ) )
+            return BOXDUMPER_ERR( "Failed to dump box structure.\n" );
+        lsmash_destroy_root( root );
+        return 0;
+    }
     if( lsmash_read_file( file, &file_param ) < 0 )
         return BOXDUMPER_ERR( "Failed to read a file\n" );
     /* Dump the input file. */
@@ -134,48 +147,8 @@ int main( int argc, char *argv[] )
         if( lsmash_print_chapter_list( root ) )
             return BOXDUMPER_ERR( "Failed to extract chapter.\n" );
     }
-    else if( dump_box )
-    {
-        if( lsmash_print_movie( root, "-" ) )
-            return BOXDUMPER_ERR( "Failed to dump box structure.\n" );
-    }
-    else
-    {
-        lsmash_movie_parameters_t movie_param;
-        lsmash_initialize_movie_parameters( &movie_param );
-        lsmash_get_movie_parameters( root, &movie_param );
-        uint32_t num_tracks = movie_param.number_of_tracks;
-        for( uint32_t track_number = 1; track_number <= num_tracks; track_number++ )
-        {
-            uint32_t track_ID = lsmash_get_track_ID( root, track_number );
-            if( !track_ID )
-                return BOXDUMPER_ERR( "Failed to get track_ID.\n" );
-            lsmash_media_parameters_t media_param;
-            lsmash_initialize_media_parameters( &media_param );
-            if( lsmash_get_media_parameters( root, track_ID, &media_param ) )
-                return BOXDUMPER_ERR( "Failed to get media parameters.\n" );
-            if( lsmash_construct_timeline( root, track_ID ) )
-                return BOXDUMPER_ERR( "Failed to construct timeline.\n" );
-            uint32_t timeline_shift;
-            if( lsmash_get_composition_to_decode_shift_from_media_timeline( root, track_ID, &timeline_shift ) )
-                return BOXDUMPER_ERR( "Failed to get timestamps.\n" );
-            lsmash_media_ts_list_t ts_list;
-            if( lsmash_get_media_timestamps( root, track_ID, &ts_list ) )
-                return BOXDUMPER_ERR( "Failed to get timestamps.\n" );
-            fprintf( stdout, "track_ID: %"PRIu32"\n", track_ID );
-            fprintf( stdout, "Media timescale: %"PRIu32"\n", media_param.timescale );
-            lsmash_media_ts_t *ts_array = ts_list.timestamp;
-            if( !ts_array )
-            {
-                fprintf( stdout, "\n" );
-                continue;
-            }
-            for( uint32_t i = 0; i < ts_list.sample_count; i++ )
-                fprintf( stdout, "DTS = %"PRIu64", CTS = %"PRIu64"\n", ts_array[i].dts, ts_array[i].cts + timeline_shift );
-            lsmash_free( ts_array );
-            fprintf( stdout, "\n" );
-        }
-    }
+    else if( lsmash_print_media_timestamps( root, "-", format ) )
+        return BOXDUMPER_ERR( "Failed to dump media timestamps.\n" );
     lsmash_destroy_root( root );
     return 0;
 }
@@ -33,7 +33,7 @@
 
 #define MAX_NUM_OF_BRANDS 50
 #define MAX_NUM_OF_INPUTS 10
-#define MAX_NUM_OF_TRACKS 1
+#define MAX_NUM_OF_TRACKS 64
 
 typedef struct
 {
@@ -97,6 +97,7 @@ typedef struct
     char    *handler_name;
     uint32_t par_h;
     uint32_t par_v;
+    lsmash_codec_type_t lpcm_format;
 } input_track_option_t;
 
 typedef struct
@@ -276,10 +277,18 @@ static void display_help( void )
              "                                  <arg> is <string> or <string>/<string>\n"
              "    handler=<string>          Set media handler name\n"
              "    sbr                       Enable backward-compatible SBR explicit signaling mode\n"
+             "    lpcm-format=<string>      Convert uncompressed audio samples into the specified layout\n"
+             "                                  - twos : 8-bit signed or 16-bit big endian integer\n"
+             "                                  - sowt : 16-bit little endian integer\n"
+             "                                  - in24 : 24-bit big endian integer\n"
+             "                                  - in32 : 32-bit big endian integer\n"
+             "                                  - fl32 : 32-bit big endian float\n"
+             "                                  - fl64 : 64-bit big endian float\n"
              "    par=<integer>:<integer>   Specify pixel aspect ratio of the first sequence\n"
              "                              And never change ones in the media stream.\n"
              "How to use track options:\n"
              "    -i input?[track_option1],[track_option2]...\n"
+             "    Options for the following tracks of a multi-track input are separated by '?'.\n"
              "\n"
              "iTunes Metadata:\n"
              "    --album-name <string>     Album name\n"
@@ -692,6 +701,33 @@ static int parse_track_options( input_t *input )
                 char *track_parameter = strchr( track_option, '=' ) + 1;
                 track_opt->handler_name = track_parameter;
             }
+            else if( strstr( track_option, "lpcm-format=" ) )
+            {
+                const struct
+                {
+                    const char         *name;
+                    lsmash_codec_type_t type;
+                } lpcm_format_table[] =
+                    {
+                        { "twos", QT_CODEC_TYPE_TWOS_AUDIO },
+                        { "sowt", QT_CODEC_TYPE_SOWT_AUDIO },
+                        { "in24", QT_CODEC_TYPE_IN24_AUDIO },
+                        { "in32", QT_CODEC_TYPE_IN32_AUDIO },
+                        { "fl32", QT_CODEC_TYPE_FL32_AUDIO },
+                        { "fl64", QT_CODEC_TYPE_FL64_AUDIO },
+                        { NULL,   LSMASH_CODEC_TYPE_INITIALIZER }
+                    };
+                char *track_parameter = strchr( track_option, '=' ) + 1;
+                int i;
+                for( i = 0; lpcm_format_table[i].name; i++ )
+                    if( !strcasecmp( track_parameter, lpcm_format_table[i].name ) )
+                    {
+                        track_opt->lpcm_format = lpcm_format_table[i].type;
+                        break;
+                    }
+                if( !lpcm_format_table[i].name )
+                    return ERROR_MSG( "unknown LPCM format %s\n", track_parameter );
+            }
             else if( strstr( track_option, "sbr" ) )
                 track_opt->sbr = 1;
             else if( strstr( track_option, "par=" ) )
@@ -731,6 +767,12 @@ static void display_codec_name( lsmash_codec_type_t codec_type, uint32_t track_n
     DISPLAY_CODEC_NAME( ISOM_CODEC_TYPE_SAWB_AUDIO, Wideband AMR voice );
     DISPLAY_CODEC_NAME( ISOM_CODEC_TYPE_SAMR_AUDIO, Narrowband AMR voice );
     DISPLAY_CODEC_NAME(   QT_CODEC_TYPE_LPCM_AUDIO, Uncompressed Audio );
+    DISPLAY_CODEC_NAME(   QT_CODEC_TYPE_TWOS_AUDIO, Uncompressed Audio );
+    DISPLAY_CODEC_NAME(   QT_CODEC_TYPE_SOWT_AUDIO, Uncompressed Audio );
+    DISPLAY_CODEC_NAME(   QT_CODEC_TYPE_IN24_AUDIO, Uncompressed Audio );
+    DISPLAY_CODEC_NAME(   QT_CODEC_TYPE_IN32_AUDIO, Uncompressed Audio );
+    DISPLAY_CODEC_NAME(   QT_CODEC_TYPE_FL32_AUDIO, Uncompressed Audio );
+    DISPLAY_CODEC_NAME(   QT_CODEC_TYPE_FL64_AUDIO, Uncompressed Audio );
 #undef DISPLAY_CODEC_NAME
 }
 
@@ -752,6 +794,11 @@ static int open_input_files( muxer_t *muxer )
         input->num_of_tracks = lsmash_importer_get_track_count( input->importer );
         if( input->num_of_tracks == 0 )
             return ERROR_MSG( "there is no valid track in input file.\n" );
+        if( input->num_of_tracks > MAX_NUM_OF_TRACKS )
+        {
+            eprintf( "Warning: only the first %d tracks of %s are imported.\n", MAX_NUM_OF_TRACKS, input->file_name );
+            input->num_of_tracks = MAX_NUM_OF_TRACKS;
+        }
         if( opt->default_language )
              for( int i = 0; i < input->num_of_tracks; i ++ )
                  input->track[i].opt.ISO_language = opt->default_language;
@@ -764,6 +811,9 @@ static int open_input_files( muxer_t *muxer )
              input->current_track_number ++ )
         {
             input_track_t *in_track = &input->track[input->current_track_number - 1];
+            if( in_track->opt.lpcm_format.fourcc
+             && lsmash_importer_set_lpcm_format( input->importer, input->current_track_number, in_track->opt.lpcm_format ) < 0 )
+                return ERROR_MSG( "failed to set the LPCM format of track %"PRIu32".\n", input->current_track_number );
             int err = lsmash_importer_construct_timeline( input->importer, input->current_track_number );
             if( err < 0 && err != LSMASH_ERR_PATCH_WELCOME )
             {
@@ -816,7 +866,13 @@ static int open_input_files( muxer_t *muxer )
                 if( !opt->brand_3gx )
                     return ERROR_MSG( "the input seems AMR-NB/WB, available for 3GPP(2) file format.\n" );
             }
-            else if( lsmash_check_codec_type_identical( codec_type, QT_CODEC_TYPE_LPCM_AUDIO ) )
+            else if( lsmash_check_codec_type_identical( codec_type, QT_CODEC_TYPE_LPCM_AUDIO )
+                  || lsmash_check_codec_type_identical( codec_type, QT_CODEC_TYPE_TWOS_AUDIO )
+                  || lsmash_check_codec_type_identical( codec_type, QT_CODEC_TYPE_SOWT_AUDIO )
+                  || lsmash_check_codec_type_identical( codec_type, QT_CODEC_TYPE_IN24_AUDIO )
+                  || lsmash_check_codec_type_identical( codec_type, QT_CODEC_TYPE_IN32_AUDIO )
+                  || lsmash_check_codec_type_identical( codec_type, QT_CODEC_TYPE_FL32_AUDIO )
+                  || lsmash_check_codec_type_identical( codec_type, QT_CODEC_TYPE_FL64_AUDIO ) )
             {
                 if( opt->isom && !opt->qtff )
                     return ERROR_MSG( "the input seems Uncompressed Audio, at present available only for QuickTime file format.\n" );
@@ -1038,9 +1094,7 @@ static int prepare_output( muxer_t *muxer )
                     return ERROR_MSG( "not supported stream type.\n" );
             }
             /* Reset the movie timescale in order to match the media timescale if only one track is there. */
-            if( muxer->num_of_inputs        == 1
-             && current_input_number        == 1
-             && input->current_track_number == 1 )
+            if( out_movie->num_of_tracks == 1 )
             {
                 movie_param.timescale = media_param.timescale;
                 if( lsmash_set_movie_parameters( output->root, &movie_param ) )
@@ -1093,8 +1147,10 @@ static int do_mux( muxer_t *muxer )
     while( 1 )
     {
         input_t *input = &muxer->input[current_input_number - 1];
-        output_track_t *out_track = &out_movie->track[ out_movie->current_track_number - 1 ];
-        if( out_track->active )
+        /* Inactive input tracks have no corresponding output track. */
+        input_track_t  *in_track  = &input->track[input->current_track_number - 1];
+        output_track_t *out_track = in_track->active ? &out_movie->track[ out_movie->current_track_number - 1 ] : NULL;
+        if( out_track && out_track->active )
         {
             lsmash_sample_t *sample = out_track->sample;
             /* Get a new sample data if the track doesn't hold any one. */
@@ -1115,7 +1171,6 @@ static int do_mux( muxer_t *muxer )
                 {
                     /* Add a new sample entry if no duplications within the output track. */
                     int got_new_sample_entry = 1;
-                    input_track_t *in_track = &input->track[input->current_track_number - 1];
                     lsmash_summary_t *summary = lsmash_duplicate_summary( input->importer, input->current_track_number );
                     uint32_t summary_count = lsmash_count_summary( output->root, out_track->track_ID );
                     for( uint32_t desc_index = 1; desc_index <= summary_count; desc_index++ )
@@ -1206,7 +1261,8 @@ static int do_mux( muxer_t *muxer )
                     ++num_consecutive_sample_skip;      /* Skip appendig sample. */
             }
         }
-        if( ++ out_movie->current_track_number > out_movie->num_of_tracks )
+        if( in_track->active
+         && ++ out_movie->current_track_number > out_movie->num_of_tracks )
             out_movie->current_track_number = 1;    /* Back the first output track. */
         /* Move the next track. */
         if( ++ input->current_track_number > input->num_of_tracks )
@@ -21,6 +21,7 @@
 /* This file is available under an ISC license. */
 
 #include "cli.h"
+#include "common/thread.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -58,6 +59,8 @@ typedef struct
     uint32_t                 current_subseg_number;
     int (*open)( const char *filename, int open_mode, lsmash_file_parameters_t * );
     int (*close)( lsmash_file_parameters_t * );
+    int (*seg_open)( const char *filename, int open_mode, lsmash_file_parameters_t * );
+    int (*seg_close)( lsmash_file_parameters_t * );
 } output_file_t;
 
 typedef struct
@@ -117,6 +120,7 @@ typedef struct
 
 typedef struct
 {
+    char                    *name;
     lsmash_file_t           *fh;
     lsmash_file_parameters_t param;
     input_movie_t            movie;
@@ -157,8 +161,12 @@ typedef struct
     uint32_t             subseg_per_seg;
     int                  dash;
     int                  compact_size_table;
+    int                  passthrough;
     double               min_frag_duration;
     int                  dry_run;
+    int                  dash_threads;
+    int                  dash_worker;
+    lsmash_adhoc_remux_t *adhoc_remux;
 } remuxer_t;
 
 typedef struct
@@ -216,8 +224,8 @@ static void cleanup_output_movie( output_t *output )
     if( !(output->file.seg_param.mode & LSMASH_FILE_MODE_INITIALIZATION) )
     {
         lsmash_freep( &output->file.seg_param.brands );
-        if( output->file.close )
-            output->file.close( &output->file.seg_param );
+        if( output->file.seg_close )
+            output->file.seg_close( &output->file.seg_param );
     }
     lsmash_freep( &output->file.param.brands );
     if( output->file.close )
@@ -327,8 +335,16 @@ static void display_help( void )
              "      The value is the number of subsegments per segment.\n"
              "      If zero, Indexed self-initializing Media Segment is constructed.\n"
              "      This option requires --fragment.\n"
+             "  --dash-threads <integer>\n"
+             "      Specify the number of threads packaging media segments in parallel.\n"
+             "      If zero, the number of logical processors is used.\n"
+             "      This option requires --dash with a non-zero value.\n"
              "  --compact-size-table\n"
              "      Compress sample size tables if possible.\n"
+             "  --passthrough\n"
+             "      Copy the chunks of the input tracks verbatim instead of re-chunking samples.\n"
+             "      --max-chunk-duration and --max-chunk-size are ignored for the copied chunks.\n"
+             "      Tracks with seek are remuxed per sample. This option is ignored with --fragment.\n"
              "  --dry-run\n"
              "      Execute as a dry run.\n"
              "Track options:\n"
@@ -452,6 +468,7 @@ static int get_movie( input_t *input, char *input_name )
     if( !input->root )
         return ERROR_MSG( "failed to create a ROOT for an input file.\n" );
     input_file_t *in_file = &input->file;
+    in_file->name = input_name;
     if( lsmash_open_file( input_name, 1, &in_file->param ) < 0 )
         return ERROR_MSG( "failed to open an input file.\n" );
     in_file->fh = lsmash_set_file( input->root, &in_file->param );
@@ -785,8 +802,20 @@ static int parse_cli_option( int argc, char **argv, remuxer_t *remuxer )
             remuxer->subseg_per_seg = atoi( argv[i] );
             remuxer->dash           = 1;
         }
+        else if( !strcasecmp( argv[i], "--dash-threads" ) )
+        {
+            if( ++i == argc )
+                FAILED_PARSE_CLI_OPTION( "--dash-threads requires an argument.\n" );
+            remuxer->dash_threads = atoi( argv[i] );
+            if( remuxer->dash_threads < 0 )
+                FAILED_PARSE_CLI_OPTION( "%s is an invalid number of threads.\n", argv[i] );
+            if( remuxer->dash_threads == 0 )
+                remuxer->dash_threads = lsmash_get_cpu_count();
+        }
         else if( !strcasecmp( argv[i], "--compact-size-table" ) )
             remuxer->compact_size_table = 1;
+        else if( !strcasecmp( argv[i], "--passthrough" ) )
+            remuxer->passthrough = 1;
         else if( !strcasecmp( argv[i], "--dry-run" ) )
             remuxer->dry_run = 1;
         else
@@ -794,6 +823,16 @@ static int parse_cli_option( int argc, char **argv, remuxer_t *remuxer )
     }
     if( !remuxer->output->root )
         FAILED_PARSE_CLI_OPTION( "output file name is not specified.\n" );
+    if( remuxer->dash_threads > 1 && (remuxer->subseg_per_seg == 0 || remuxer->frag_base_track == 0) )
+    {
+        WARNING_MSG( "--dash-threads requires --dash with a non-zero value and --fragment.\n" );
+        remuxer->dash_threads = 1;
+    }
+    if( remuxer->passthrough && remuxer->frag_base_track )
+    {
+        WARNING_MSG( "--passthrough is not available with --fragment.\n" );
+        remuxer->passthrough = 0;
+    }
     /* Parse track options */
     /* Get the current track and media parameters */
     for( int i = 0; i < remuxer->num_input; i++ )
@@ -1191,6 +1230,15 @@ static int prepare_output( remuxer_t *remuxer )
         output->file.open  = lsmash_open_file;
         output->file.close = lsmash_close_file;
     }
+    output->file.seg_open  = output->file.open;
+    output->file.seg_close = output->file.close;
+    if( remuxer->dash_worker )
+    {
+        /* The initialization segment is written by the main thread.
+         * Workers write media segments only. */
+        output->file.open  = dry_open_file;
+        output->file.close = dry_close_file;
+    }
     if( output->file.open( output->file.name, 0, &output->file.param ) < 0 )
         return ERROR_MSG( "failed to open an output file.\n" );
     /* Count the number of output tracks. */
@@ -1395,7 +1443,7 @@ static int open_media_segment( output_t *output, lsmash_file_parameters_t *seg_p
     sprintf( seg_name + suffixless_length, "_%"PRIu32, output->current_seg_number );
     if( *p == '.' )
         memcpy( seg_name + suffixless_length + suffix_length, p, end - p );
-    int ret = out_file->open( seg_name, 0, seg_param );
+    int ret = out_file->seg_open( seg_name, 0, seg_param );
     if( ret == 0 )
         eprintf( "[Segment] out: %s\n", seg_name );
     lsmash_free( seg_name );
@@ -1439,10 +1487,11 @@ static int switch_segment( remuxer_t *remuxer )
         return ERROR_MSG( "failed to add an output segment file into a ROOT.\n" );
     /* Switch to the next segment.
      * After switching, close the previous segment if the previous is not the initialization segment. */
-    if( lsmash_switch_media_segment( output->root, segment, &moov_to_front ) < 0 )
+    if( lsmash_switch_media_segment( output->root, segment, remuxer->adhoc_remux ) < 0 )
         return ERROR_MSG( "failed to switch to the next segment.\n" );
-    if( !(out_file->seg_param.mode & LSMASH_FILE_MODE_INITIALIZATION) )
-        return out_file->close( &out_file->seg_param );
+    if( !(out_file->seg_param.mode & LSMASH_FILE_MODE_INITIALIZATION)
+     && out_file->seg_close( &out_file->seg_param ) < 0 )
+        return ERROR_MSG( "failed to close the previous segment.\n" );
     out_file->seg_param = seg_param;
     return 0;
 }
@@ -1490,197 +1539,295 @@ static void adjust_timestamp( output_track_t *out_track, lsmash_sample_t *sample
     }
 }
 
+static void get_active_input_tracks( remuxer_t *remuxer, input_t **in, input_track_t **in_track )
+{
+    uint32_t num_tracks = 0;
+    for( int i = 0; i < remuxer->num_input; i++ )
+        for( uint32_t j = 0; j < remuxer->input[i].file.movie.num_tracks; j++ )
+            if( remuxer->input[i].file.movie.track[j].active
+             && num_tracks < remuxer->output->file.movie.num_tracks )
+            {
+                in      [num_tracks] = &remuxer->input[i];
+                in_track[num_tracks] = &remuxer->input[i].file.movie.track[j];
+                ++num_tracks;
+            }
+}
+
+/*** Scheduling of samples ***/
+
+/* A binary min-heap of active tracks keyed on the DTS of their next samples.
+ * Ties are broken by the track number so that the order of tracks in the output is kept. */
+typedef struct
+{
+    double   dts;       /* in seconds */
+    uint32_t number;    /* the index in the table of active tracks */
+} track_queue_entry_t;
+
+typedef struct
+{
+    track_queue_entry_t *entry;
+    uint32_t             size;
+} track_queue_t;
+
+static inline int track_queue_precedes( const track_queue_entry_t *a, const track_queue_entry_t *b )
+{
+    return a->dts < b->dts || (a->dts == b->dts && a->number < b->number);
+}
+
+static void track_queue_sift_down( track_queue_t *queue, uint32_t i )
+{
+    track_queue_entry_t e = queue->entry[i];
+    while( 1 )
+    {
+        uint32_t child = 2 * i + 1;
+        if( child >= queue->size )
+            break;
+        if( child + 1 < queue->size
+         && track_queue_precedes( &queue->entry[child + 1], &queue->entry[child] ) )
+            ++child;
+        if( !track_queue_precedes( &queue->entry[child], &e ) )
+            break;
+        queue->entry[i] = queue->entry[child];
+        i = child;
+    }
+    queue->entry[i] = e;
+}
+
+/* The queue shall have room for the new entry. */
+static void track_queue_push( track_queue_t *queue, double dts, uint32_t number )
+{
+    track_queue_entry_t e = { dts, number };
+    uint32_t i = queue->size++;
+    while( i )
+    {
+        uint32_t parent = (i - 1) / 2;
+        if( !track_queue_precedes( &e, &queue->entry[parent] ) )
+            break;
+        queue->entry[i] = queue->entry[parent];
+        i = parent;
+    }
+    queue->entry[i] = e;
+}
+
+static void track_queue_pop( track_queue_t *queue )
+{
+    if( --queue->size )
+    {
+        queue->entry[0] = queue->entry[ queue->size ];
+        track_queue_sift_down( queue, 0 );
+    }
+}
+
+/* Change the key of the top entry. */
+static void track_queue_update_top( track_queue_t *queue, double dts )
+{
+    queue->entry[0].dts = dts;
+    track_queue_sift_down( queue, 0 );
+}
+
+/* Get the next sample of an input track and keep it in the track.
+ * Return 1 if the track reached the end of its media timeline. */
+static int fetch_next_sample( input_t *in, input_track_t *in_track, output_track_t *out_track )
+{
+    lsmash_sample_t *sample = lsmash_get_sample_from_media_timeline( in->root, in_track->track_ID, in_track->current_sample_number );
+    if( sample )
+    {
+        adapt_description_index( out_track, in_track, sample );
+        adjust_timestamp( out_track, sample );
+        in_track->sample = sample;
+        in_track->dts    = (double)sample->dts / in_track->media.param.timescale;
+        return 0;
+    }
+    if( lsmash_check_sample_existence_in_media_timeline( in->root, in_track->track_ID, in_track->current_sample_number ) )
+        return ERROR_MSG( "failed to get a sample.\n" );
+    lsmash_sample_t sample_info = { 0 };
+    if( lsmash_get_sample_info_from_media_timeline( in->root, in_track->track_ID, in_track->current_sample_number, &sample_info ) >= 0 )
+        return ERROR_MSG( "failed to get a sample.\n" );
+    /* No more appendable samples in this track. */
+    in_track->sample = NULL;
+    in_track->reach_end_of_media_timeline = 1;
+    return 1;
+}
+
+/* Decide whether a track appends its current sample while flushing the active movie fragment is pending.
+ * Wait as much as possible both to make the last sample within each track fragment close to the DTS of
+ * the first sample within the track fragment corresponding to the base track within the next movie
+ * fragment and to make all the track fragments within the next movie fragment start with RAP. */
+static int append_before_next_fragment( input_t *in, input_track_t *in_track, double frag_base_dts )
+{
+    if( in_track->sample->prop.ra_flags == ISOM_SAMPLE_RANDOM_ACCESS_FLAG_NONE )
+        return 1;
+    /* Check the DTS and random accessibilities of the next sample. */
+    lsmash_sample_t info;
+    if( lsmash_get_sample_info_from_media_timeline( in->root, in_track->track_ID, in_track->current_sample_number + 1, &info ) < 0 )
+        return 0;
+    return (info.prop.ra_flags != ISOM_SAMPLE_RANDOM_ACCESS_FLAG_NONE)
+        && ((double)info.dts / in_track->media.param.timescale <= frag_base_dts);
+}
+
+/* Append samples in the order of DTS across all the active tracks.
+ * For fragmented movies, every movie fragment starts with a random accessible sample of the base track.
+ * A track which cannot append its current sample into the active movie fragment leaves the queue, and
+ * the fragment is flushed when no track is left in the queue. */
 static int do_remux( remuxer_t *remuxer )
 {
-#define LSMASH_MAX( a, b ) ((a) > (b) ? (a) : (b))
-    input_t        *inputs    = remuxer->input;
-    output_t       *output    = remuxer->output;
-    output_movie_t *out_movie = &output->file.movie;
+    output_t       *output     = remuxer->output;
+    output_movie_t *out_movie  = &output->file.movie;
+    uint32_t        num_tracks = out_movie->num_tracks;
+    input_t **in = lsmash_malloc( num_tracks * (sizeof(input_t *) + sizeof(input_track_t *) + sizeof(track_queue_entry_t)) );
+    if( !in )
+        return ERROR_MSG( "failed to allocate the track map.\n" );
+    input_track_t **in_track = (input_track_t **)(in + num_tracks);
+    track_queue_t   queue    = { (track_queue_entry_t *)(in_track + num_tracks), 0 };
+    get_active_input_tracks( remuxer, in, in_track );
     set_reference_chapter_track( remuxer );
-    double   largest_dts                 = 0;   /* in seconds */
-    double   frag_base_dts               = 0;   /* in seconds */
-    uint32_t input_movie_number          = 1;
-    uint32_t num_consecutive_sample_skip = 0;
-    uint32_t num_active_input_tracks     = out_movie->num_tracks;
-    uint64_t total_media_size            = 0;
-    uint32_t progress_pos                = 0;
-    uint8_t  pending_flush_fragments     = (remuxer->frag_base_track != 0); /* For non-fragmented movie, always set to 0. */
-    while( 1 )
+    double   frag_base_dts           = 0;   /* in seconds */
+    uint32_t frag_base_sample_number = 0;   /* the sample of the base track starting the next movie fragment */
+    uint32_t num_waiting_tracks      = 0;   /* the number of tracks waiting for the next movie fragment */
+    uint64_t total_media_size        = 0;
+    uint32_t progress_pos            = 0;
+    int      pending_flush_fragments = 0;   /* For non-fragmented movie, always set to 0. */
+    int      ret                     = 0;
+    for( uint32_t t = 0; t < num_tracks; t++ )
     {
-        input_t       *in       = &inputs[input_movie_number - 1];
-        input_movie_t *in_movie = &in->file.movie;
-        input_track_t *in_track = &in_movie->track[ in_movie->current_track_number - 1 ];
-        if( !in_track->active )
+        /* A track might hold the sample fetched for a starting point. */
+        if( !in_track[t]->sample && !in_track[t]->reach_end_of_media_timeline
+         && (ret = fetch_next_sample( in[t], in_track[t], &out_movie->track[t] )) < 0 )
+            goto fail;
+        if( in_track[t]->sample )
+            track_queue_push( &queue, in_track[t]->dts, t );
+    }
+    if( remuxer->frag_base_track )
+    {
+        /* The very first movie fragment
+         * Create it before appending any sample so that the initial movie has no samples. */
+        if( (ret = handle_segmentation( remuxer )) < 0 )
+            goto fail;
+        if( lsmash_create_fragment_movie( output->root ) < 0 )
+        {
+            ret = ERROR_MSG( "failed to create a movie fragment.\n" );
+            goto fail;
+        }
+        input_track_t *base_track = in_track[ remuxer->frag_base_track - 1 ];
+        frag_base_dts           = base_track->dts;
+        frag_base_sample_number = base_track->current_sample_number;
+        for( uint32_t t = 0; t < num_tracks; t++ )
+            if( in_track[t]->sample )
+                in_track[t]->current_sample_index = in_track[t]->sample->index;
+    }
+    ret = 0;
+    while( queue.size || num_waiting_tracks )
+    {
+        if( queue.size == 0 )
         {
-            /* Move the next track. */
-            if( ++ in_movie->current_track_number > in_movie->num_tracks )
+            /* All the remaining tracks are waiting for the next movie fragment. */
+            if( flush_movie_fragment( remuxer ) < 0 )
+            {
+                ret = ERROR_MSG( "failed to flush a movie fragment.\n" );
+                break;
+            }
+            if( (ret = handle_segmentation( remuxer )) < 0 )
+                break;
+            if( lsmash_create_fragment_movie( output->root ) < 0 )
             {
-                /* Move the next input movie. */
-                in_movie->current_track_number = 1;
-                ++input_movie_number;
+                ret = ERROR_MSG( "failed to create a movie fragment.\n" );
+                break;
             }
-            if( input_movie_number > remuxer->num_input )
-                input_movie_number = 1;                 /* Back the first input movie. */
+            pending_flush_fragments = 0;
+            num_waiting_tracks      = 0;
+            for( uint32_t t = 0; t < num_tracks; t++ )
+                if( in_track[t]->sample )
+                {
+                    /* Start a new track fragment with the description of the sample. */
+                    in_track[t]->current_sample_index = in_track[t]->sample->index;
+                    track_queue_push( &queue, in_track[t]->dts, t );
+                }
             continue;
         }
-        /* Try append a sample in an input track where we didn't reach the end of media timeline. */
-        if( !in_track->reach_end_of_media_timeline )
+        uint32_t         t         = queue.entry[0].number;
+        input_track_t   *cur_track = in_track[t];
+        output_track_t  *out_track = &out_movie->track[t];
+        lsmash_sample_t *sample    = cur_track->sample;
+        int              append    = 1;
+        if( remuxer->frag_base_track )
         {
-            lsmash_sample_t *sample = in_track->sample;
-            /* Get a new sample data if the track doesn't hold any one. */
-            if( !sample )
+            int is_base_track = (remuxer->frag_base_track == t + 1);
+            if( pending_flush_fragments == 0
+             && is_base_track
+             && cur_track->current_sample_number != frag_base_sample_number
+             && sample->prop.ra_flags != ISOM_SAMPLE_RANDOM_ACCESS_FLAG_NONE )
             {
-                sample = lsmash_get_sample_from_media_timeline( in->root, in_track->track_ID, in_track->current_sample_number );
-                if( sample )
+                int over_duration = 1;
+                if( remuxer->min_frag_duration != 0.0 )
                 {
-                    output_track_t *out_track = &out_movie->track[ out_movie->current_track_number - 1 ];
-                    adapt_description_index( out_track, in_track, sample );
-                    adjust_timestamp( out_track, sample );
-                    in_track->sample = sample;
-                    in_track->dts    = (double)sample->dts / in_track->media.param.timescale;
+                    lsmash_sample_t info;
+                    if( lsmash_get_sample_info_from_media_timeline( in[t]->root, cur_track->track_ID, cur_track->current_sample_number + 1, &info ) >= 0 )
+                        over_duration = ((double)info.dts / cur_track->media.param.timescale) - frag_base_dts >= remuxer->min_frag_duration;
                 }
-                else
+                if( over_duration )
                 {
-                    if( lsmash_check_sample_existence_in_media_timeline( in->root, in_track->track_ID, in_track->current_sample_number ) )
-                    {
-                        ERROR_MSG( "failed to get a sample.\n" );
-                        break;
-                    }
-                    lsmash_sample_t sample_info = { 0 };
-                    if( lsmash_get_sample_info_from_media_timeline( in->root, in_track->track_ID, in_track->current_sample_number, &sample_info ) < 0 )
-                    {
-                        /* No more appendable samples in this track. */
-                        in_track->sample = NULL;
-                        in_track->reach_end_of_media_timeline = 1;
-                        if( --num_active_input_tracks == 0 )
-                            break;      /* end of muxing */
-                    }
-                    else
-                    {
-                        ERROR_MSG( "failed to get a sample.\n" );
-                        break;
-                    }
+                    frag_base_dts           = cur_track->dts;
+                    frag_base_sample_number = cur_track->current_sample_number;
+                    pending_flush_fragments = 1;
                 }
             }
-            if( sample )
+            int need_new_fragment = (sample->index != cur_track->current_sample_index);
+            if( pending_flush_fragments )
+                append = !is_base_track && !need_new_fragment && append_before_next_fragment( in[t], cur_track, frag_base_dts );
+            else
+                append = !need_new_fragment;
+            if( !append )
             {
-                /* Flushing the active movie fragment is pending until random accessible point sample within all active tracks are ready. */
-                if( remuxer->frag_base_track )
-                {
-                    if( pending_flush_fragments == 0 )
-                    {
-                        int over_duration = 1;
-                        if( remuxer->min_frag_duration != 0.0 )
-                        {
-                            lsmash_sample_t info;
-                            if( lsmash_get_sample_info_from_media_timeline( in->root, in_track->track_ID, in_track->current_sample_number + 1, &info ) >= 0 )
-                                over_duration = ((double)info.dts / in_track->media.param.timescale) - frag_base_dts >= remuxer->min_frag_duration;
-                        }
-                        if( remuxer->frag_base_track == out_movie->current_track_number
-                         && sample->prop.ra_flags != ISOM_SAMPLE_RANDOM_ACCESS_FLAG_NONE
-                         && over_duration )
-                        {
-                            pending_flush_fragments = 1;
-                            frag_base_dts = in_track->dts;
-                        }
-                    }
-                    else if( num_consecutive_sample_skip == num_active_input_tracks || total_media_size == 0 )
-                    {
-                        if( flush_movie_fragment( remuxer ) < 0 )
-                        {
-                            ERROR_MSG( "failed to flush a movie fragment.\n" );
-                            break;
-                        }
-                        if( handle_segmentation( remuxer ) < 0 )
-                            break;
-                        if( lsmash_create_fragment_movie( output->root ) < 0 )
-                        {
-                            ERROR_MSG( "failed to create a movie fragment.\n" );
-                            break;
-                        }
-                        pending_flush_fragments = 0;
-                    }
-                }
-                /* Append a sample if meeting a condition. */
-                int append = 0;
-                int need_new_fragment = (remuxer->frag_base_track && sample->index != in_track->current_sample_index);
-                if( pending_flush_fragments == 0 )
-                    append = (in_track->dts <= largest_dts || num_consecutive_sample_skip == num_active_input_tracks) && !need_new_fragment;
-                else if( remuxer->frag_base_track != out_movie->current_track_number && !need_new_fragment )
-                {
-                    /* Wait as much as possible both to make the last sample within each track fragment close to the DTS of
-                     * the first sample within the track fragment corresponding to the base track within the next movie
-                     * fragment and to make all the track fragments within the next movie fragment start with RAP. */
-                    if( sample->prop.ra_flags == ISOM_SAMPLE_RANDOM_ACCESS_FLAG_NONE )
-                        append = 1;
-                    else
-                    {
-                        /* Check the DTS and random accessibilities of the next sample. */
-                        lsmash_sample_t info;
-                        if( lsmash_get_sample_info_from_media_timeline( in->root, in_track->track_ID, in_track->current_sample_number + 1, &info ) < 0 )
-                            append = 0;
-                        else
-                            append = (info.prop.ra_flags != ISOM_SAMPLE_RANDOM_ACCESS_FLAG_NONE)
-                                  && ((double)info.dts / in_track->media.param.timescale <= frag_base_dts);
-                    }
-                }
-                if( append )
-                {
-                    if( sample->index )
-                    {
-                        output_track_t *out_track = &out_movie->track[ out_movie->current_track_number - 1 ];
-                        uint64_t sample_size     = sample->length;      /* sample might be deleted internally after appending. */
-                        uint64_t last_sample_dts = sample->dts;         /* same as above */
-                        uint32_t sample_index    = sample->index;       /* same as above */
-                        /* Append a sample into output movie. */
-                        if( lsmash_append_sample( output->root, out_track->track_ID, sample ) < 0 )
-                        {
-                            lsmash_delete_sample( sample );
-                            return ERROR_MSG( "failed to append a sample.\n" );
-                        }
-                        largest_dts                       = LSMASH_MAX( largest_dts, in_track->dts );
-                        in_track->sample                  = NULL;
-                        in_track->current_sample_number  += 1;
-                        in_track->current_sample_index    = sample_index;
-                        out_track->current_sample_number += 1;
-                        out_track->last_sample_dts        = last_sample_dts;
-                        num_consecutive_sample_skip       = 0;
-                        total_media_size                 += sample_size;
-                        /* Print, per 4 megabytes, total size of imported media. */
-                        if( (total_media_size >> 22) > progress_pos )
-                        {
-                            progress_pos = total_media_size >> 22;
-                            eprintf( "Importing: %"PRIu64" bytes\r", total_media_size );
-                        }
-                    }
-                    else
-                    {
-                        lsmash_delete_sample( sample );
-                        in_track->sample = NULL;
-                        in_track->current_sample_number += 1;
-                    }
-                }
-                else
-                    ++num_consecutive_sample_skip;      /* Skip appendig sample. */
+                /* Wait for the next movie fragment. */
+                track_queue_pop( &queue );
+                ++num_waiting_tracks;
+                continue;
             }
         }
-        /* Move the next track. */
-        if( ++ in_movie->current_track_number > in_movie->num_tracks )
+        if( sample->index )
         {
-            /* Move the next input movie. */
-            in_movie->current_track_number = 1;
-            ++input_movie_number;
+            uint64_t sample_size     = sample->length;      /* sample might be deleted internally after appending. */
+            uint64_t last_sample_dts = sample->dts;         /* same as above */
+            uint32_t sample_index    = sample->index;       /* same as above */
+            /* Append a sample into output movie. */
+            if( lsmash_append_sample( output->root, out_track->track_ID, sample ) < 0 )
+            {
+                lsmash_delete_sample( sample );
+                cur_track->sample = NULL;
+                ret = ERROR_MSG( "failed to append a sample.\n" );
+                break;
+            }
+            cur_track->current_sample_index   = sample_index;
+            out_track->current_sample_number += 1;
+            out_track->last_sample_dts        = last_sample_dts;
+            total_media_size                 += sample_size;
+            /* Print, per 4 megabytes, total size of imported media. */
+            if( (total_media_size >> 22) > progress_pos )
+            {
+                progress_pos = total_media_size >> 22;
+                eprintf( "Importing: %"PRIu64" bytes\r", total_media_size );
+            }
         }
-        if( input_movie_number > remuxer->num_input )
-            input_movie_number = 1;                 /* Back the first input movie. */
-        if( ++ out_movie->current_track_number > out_movie->num_tracks )
-            out_movie->current_track_number = 1;    /* Back the first track in the output movie. */
+        else
+            lsmash_delete_sample( sample );
+        cur_track->sample                 = NULL;
+        cur_track->current_sample_number += 1;
+        if( (ret = fetch_next_sample( in[t], cur_track, out_track )) < 0 )
+            break;
+        if( ret == 1 )
+            track_queue_pop( &queue );
+        else
+            track_queue_update_top( &queue, cur_track->dts );
+        ret = 0;
     }
-    for( uint32_t i = 0; i < out_movie->num_tracks; i++ )
+fail:
+    lsmash_free( in );
+    if( ret < 0 )
+        return ret;
+    for( uint32_t i = 0; i < num_tracks; i++ )
         if( lsmash_flush_pooled_samples( output->root, out_movie->track[i].track_ID, out_movie->track[i].last_sample_delta ) )
             return ERROR_MSG( "failed to flush samples.\n" );
     return 0;
-#undef LSMASH_MAX
 }
 
 static int construct_timeline_maps( remuxer_t *remuxer )
@@ -1734,6 +1881,614 @@ static int construct_timeline_maps( remuxer_t *remuxer )
     return 0;
 }
 
+/*** Parallel DASH segmentation ***/
+
+typedef struct
+{
+    uint32_t  num_tracks;
+    uint32_t  num_fragments;
+    uint32_t *start;            /* the sample number at which each track fragment starts
+                                 * [num_fragments + 1][num_tracks], the last row points at the end of each track */
+    uint64_t *skip_dt_interval; /* the DTS of the first sample of each track */
+} dash_plan_t;
+
+typedef struct
+{
+    remuxer_t            remuxer;
+    output_t             output;
+    lsmash_adhoc_remux_t adhoc_remux;
+    input_t             *source;
+    dash_plan_t         *plan;
+    uint32_t             first_fragment;
+    uint32_t             end_fragment;
+    int                  ret;
+    lsmash_thread_t      thread;
+} dash_worker_t;
+
+static void cleanup_dash_plan( dash_plan_t *plan )
+{
+    lsmash_freep( &plan->start );
+    lsmash_freep( &plan->skip_dt_interval );
+}
+
+/* Get input tracks in the order of output tracks. */
+static int add_dash_plan_boundary( uint32_t **boundary, uint32_t *num_boundaries, uint32_t *alloc, uint32_t sample_number )
+{
+    if( *num_boundaries == *alloc )
+    {
+        uint32_t *temp = lsmash_realloc( *boundary, 2 * *alloc * sizeof(uint32_t) );
+        if( !temp )
+            return ERROR_MSG( "failed to allocate fragment boundaries.\n" );
+        *boundary = temp;
+        *alloc   *= 2;
+    }
+    (*boundary)[ (*num_boundaries)++ ] = sample_number;
+    return 0;
+}
+
+/* Decide where all the track fragments start before remuxing so that each media segment can be built independently.
+ * Every movie fragment starts with a random accessible sample of the base track in the same manner as do_remux().
+ * The other tracks are cut at their closest past random accessible point to the start of the base track fragment.
+ * Return 1 if the input is not suitable for parallel segmentation. */
+static int build_dash_plan( remuxer_t *remuxer, input_t **in, input_track_t **in_track, dash_plan_t *plan )
+{
+    uint32_t num_tracks = remuxer->output->file.movie.num_tracks;
+    uint32_t base       = remuxer->frag_base_track - 1;
+    if( base >= num_tracks )
+        return 1;
+    for( uint32_t t = 0; t < num_tracks; t++ )
+        if( in_track[t]->num_summaries != 1 )
+            return 1;   /* Switching sample descriptions needs a new fragment at arbitrary points. */
+    /* Get the random accessible points of the base track. */
+    lsmash_root_t *base_root  = in[base]->root;
+    uint32_t       base_ID    = in_track[base]->track_ID;
+    uint32_t       timescale  = in_track[base]->media.param.timescale;
+    uint32_t       number     = in_track[base]->current_sample_number;
+    lsmash_sample_t info;
+    if( timescale == 0
+     || lsmash_get_sample_info_from_media_timeline( base_root, base_ID, number, &info ) < 0 )
+        return 1;
+    uint32_t  num_boundaries = 0;
+    uint32_t  alloc          = 256;
+    uint32_t *boundary       = lsmash_malloc( alloc * sizeof(uint32_t) );
+    if( !boundary )
+        return ERROR_MSG( "failed to allocate fragment boundaries.\n" );
+    if( add_dash_plan_boundary( &boundary, &num_boundaries, &alloc, number ) < 0 )
+        goto fail;
+    uint64_t base_skip     = info.dts;
+    double   frag_base_dts = 0;     /* in seconds */
+    lsmash_sample_t next;
+    int has_next = (lsmash_get_sample_info_from_media_timeline( base_root, base_ID, number + 1, &next ) >= 0);
+    while( has_next )
+    {
+        info = next;
+        ++number;
+        has_next = (lsmash_get_sample_info_from_media_timeline( base_root, base_ID, number + 1, &next ) >= 0);
+        if( info.prop.ra_flags == ISOM_SAMPLE_RANDOM_ACCESS_FLAG_NONE )
+            continue;
+        if( remuxer->min_frag_duration != 0.0 && has_next
+         && (double)(next.dts - base_skip) / timescale - frag_base_dts < remuxer->min_frag_duration )
+            continue;
+        if( add_dash_plan_boundary( &boundary, &num_boundaries, &alloc, number ) < 0 )
+            goto fail;
+        frag_base_dts = (double)(info.dts - base_skip) / timescale;
+    }
+    plan->num_tracks       = num_tracks;
+    plan->num_fragments    = num_boundaries;
+    plan->start            = lsmash_malloc( (num_boundaries + 1) * num_tracks * sizeof(uint32_t) );
+    plan->skip_dt_interval = lsmash_malloc( num_tracks * sizeof(uint64_t) );
+    if( !plan->start || !plan->skip_dt_interval )
+    {
+        ERROR_MSG( "failed to allocate a segmentation plan.\n" );
+        goto fail;
+    }
+    for( uint32_t f = 0; f < num_boundaries; f++ )
+        plan->start[f * num_tracks + base] = boundary[f];
+    plan->start[num_boundaries * num_tracks + base] = number + 1;
+    plan->skip_dt_interval[base] = base_skip;
+    /* Cut the other tracks. */
+    for( uint32_t t = 0; t < num_tracks; t++ )
+    {
+        if( t == base )
+            continue;
+        lsmash_root_t *root   = in[t]->root;
+        uint32_t       ID     = in_track[t]->track_ID;
+        uint32_t       ts     = in_track[t]->media.param.timescale;
+        uint32_t       first  = in_track[t]->current_sample_number;
+        uint32_t       last   = first; /* the last sample whose DTS is not greater than the start of the base track fragment */
+        uint64_t       dts;
+        if( ts == 0 )
+            goto fallback;
+        if( lsmash_get_dts_from_media_timeline( root, ID, first, &dts ) < 0 )
+        {
+            /* No samples in this track. */
+            for( uint32_t f = 0; f <= num_boundaries; f++ )
+                plan->start[f * num_tracks + t] = first;
+            plan->skip_dt_interval[t] = 0;
+            continue;
+        }
+        uint64_t skip = dts;
+        plan->skip_dt_interval[t] = skip;
+        plan->start[t] = first;
+        for( uint32_t f = 1; f < num_boundaries; f++ )
+        {
+            uint64_t base_dts;
+            if( lsmash_get_dts_from_media_timeline( base_root, base_ID, boundary[f], &base_dts ) < 0 )
+                goto fallback;
+            double frag_start = (double)(base_dts - base_skip) / timescale;
+            while( lsmash_get_dts_from_media_timeline( root, ID, last + 1, &dts ) >= 0
+                && (double)(dts - skip) / ts <= frag_start )
+                ++last;
+            uint32_t prev = plan->start[(f - 1) * num_tracks + t];
+            uint32_t rap_number;
+            if( lsmash_get_closest_random_accessible_point_from_media_timeline( root, ID, last, &rap_number ) < 0
+             || rap_number > last
+             || rap_number < prev )
+                rap_number = prev;
+            plan->start[f * num_tracks + t] = rap_number;
+        }
+        while( lsmash_get_dts_from_media_timeline( root, ID, last + 1, &dts ) >= 0 )
+            ++last;
+        plan->start[num_boundaries * num_tracks + t] = last + 1;
+    }
+    lsmash_free( boundary );
+    return 0;
+fallback:
+    lsmash_free( boundary );
+    cleanup_dash_plan( plan );
+    return 1;
+fail:
+    lsmash_free( boundary );
+    cleanup_dash_plan( plan );
+    return -1;
+}
+
+/* Get the smallest CTS within the samples from 'start' to 'end' - 1.
+ * If no samples there, get the CTS of the sample at 'start'. */
+static int get_smallest_cts( lsmash_root_t *root, uint32_t track_ID, uint32_t start, uint32_t end, uint64_t *cts )
+{
+    if( lsmash_get_cts_from_media_timeline( root, track_ID, start, cts ) < 0 )
+        return -1;
+    for( uint32_t number = start + 1; number < end; number++ )
+    {
+        uint64_t sample_cts;
+        if( lsmash_get_cts_from_media_timeline( root, track_ID, number, &sample_cts ) < 0 )
+            return -1;
+        if( *cts > sample_cts )
+            *cts = sample_cts;
+    }
+    return 0;
+}
+
+/* Switch from the initialization segment to the media segment containing 'first_fragment'
+ * and set up the timestamps so that the range starting from it continues from the previous one. */
+static int dash_open_range( remuxer_t *remuxer, dash_plan_t *plan, uint32_t first_fragment )
+{
+    output_t       *output     = remuxer->output;
+    output_movie_t *out_movie  = &output->file.movie;
+    uint32_t        num_tracks = plan->num_tracks;
+    input_t       **in         = lsmash_malloc( num_tracks * (sizeof(input_t *) + sizeof(input_track_t *)) );
+    if( !in )
+        return ERROR_MSG( "failed to allocate the track map.\n" );
+    input_track_t **in_track = (input_track_t **)(in + num_tracks);
+    get_active_input_tracks( remuxer, in, in_track );
+    for( uint32_t t = 0; t < num_tracks; t++ )
+    {
+        uint32_t first_sample = plan->start[t];
+        uint32_t range_sample = plan->start[first_fragment * num_tracks + t];
+        output_track_t *out_track = &out_movie->track[t];
+        out_track->skip_dt_interval        = plan->skip_dt_interval[t];
+        out_track->current_sample_number   = range_sample - first_sample + 1;
+        out_track->last_sample_dts         = 0;
+        in_track[t]->current_sample_number = range_sample;
+    }
+    output->current_seg_number = first_fragment / remuxer->subseg_per_seg + 1;
+    int ret = -1;
+    if( switch_segment( remuxer ) < 0 )
+    {
+        ERROR_MSG( "failed to switch to a segment.\n" );
+        goto fail;
+    }
+    if( lsmash_set_fragment_sequence_number( output->root, first_fragment + 1 ) < 0 )
+    {
+        ERROR_MSG( "failed to set the sequence number of a movie fragment.\n" );
+        goto fail;
+    }
+    /* The subsegments are contiguous on the composition timeline, so the subsegments preceding this range
+     * last from the earliest composition time of the first movie fragment to that of the first one in this range. */
+    for( uint32_t t = 0; first_fragment && t < num_tracks; t++ )
+    {
+        uint64_t first_cts;
+        uint64_t range_cts;
+        if( get_smallest_cts( in[t]->root, in_track[t]->track_ID, plan->start[t],
+                              plan->start[num_tracks + t], &first_cts ) < 0
+         || get_smallest_cts( in[t]->root, in_track[t]->track_ID, plan->start[first_fragment * num_tracks + t],
+                              plan->start[(first_fragment + 1) * num_tracks + t], &range_cts ) < 0 )
+            continue;   /* No samples in this range. */
+        if( lsmash_set_preceding_subsegment_duration( output->root, out_movie->track[t].track_ID,
+                                                      range_cts > first_cts ? range_cts - first_cts : 0 ) < 0 )
+        {
+            ERROR_MSG( "failed to set the duration of the preceding subsegments.\n" );
+            goto fail;
+        }
+    }
+    ret = 0;
+fail:
+    lsmash_free( in );
+    return ret;
+}
+
+/* Remux the movie fragments from 'first_fragment' to 'end_fragment' - 1 planned by build_dash_plan().
+ * The media segment containing 'first_fragment' shall be opened by dash_open_range() in advance. */
+static int dash_remux_fragments( remuxer_t *remuxer, dash_plan_t *plan, uint32_t first_fragment, uint32_t end_fragment )
+{
+    output_t       *output     = remuxer->output;
+    output_movie_t *out_movie  = &output->file.movie;
+    uint32_t        num_tracks = plan->num_tracks;
+    uint32_t        K          = remuxer->subseg_per_seg;
+    input_t       **in         = lsmash_malloc( num_tracks * (sizeof(input_t *) + sizeof(input_track_t *)) );
+    if( !in )
+        return ERROR_MSG( "failed to allocate the track map.\n" );
+    input_track_t **in_track = (input_track_t **)(in + num_tracks);
+    get_active_input_tracks( remuxer, in, in_track );
+    int ret = -1;
+    for( uint32_t f = first_fragment; f < end_fragment; f++ )
+    {
+        if( f != first_fragment )
+        {
+            if( flush_movie_fragment( remuxer ) < 0 )
+            {
+                ERROR_MSG( "failed to flush a movie fragment.\n" );
+                goto fail;
+            }
+            if( f % K == 0 )
+            {
+                ++ output->current_seg_number;
+                if( switch_segment( remuxer ) < 0 )
+                {
+                    ERROR_MSG( "failed to switch to a segment.\n" );
+                    goto fail;
+                }
+            }
+        }
+        if( lsmash_create_fragment_movie( output->root ) < 0 )
+        {
+            ERROR_MSG( "failed to create a movie fragment.\n" );
+            goto fail;
+        }
+        /* Append samples in DTS order across the tracks. */
+        uint32_t *end = &plan->start[(f + 1) * num_tracks];
+        while( 1 )
+        {
+            uint32_t t_min   = num_tracks;
+            double   dts_min = 0;
+            for( uint32_t t = 0; t < num_tracks; t++ )
+            {
+                if( in_track[t]->current_sample_number >= end[t] )
+                    continue;
+                if( !in_track[t]->sample )
+                {
+                    lsmash_sample_t *sample = lsmash_get_sample_from_media_timeline( in[t]->root, in_track[t]->track_ID, in_track[t]->current_sample_number );
+                    if( !sample )
+                    {
+                        ERROR_MSG( "failed to get a sample.\n" );
+                        goto fail;
+                    }
+                    adapt_description_index( &out_movie->track[t], in_track[t], sample );
+                    adjust_timestamp( &out_movie->track[t], sample );
+                    in_track[t]->sample = sample;
+                    in_track[t]->dts    = (double)sample->dts / in_track[t]->media.param.timescale;
+                }
+                if( t_min == num_tracks || in_track[t]->dts < dts_min )
+                {
+                    t_min   = t;
+                    dts_min = in_track[t]->dts;
+                }
+            }
+            if( t_min == num_tracks )
+                break;
+            input_track_t   *cur_track = in_track[t_min];
+            output_track_t  *out_track = &out_movie->track[t_min];
+            lsmash_sample_t *sample    = cur_track->sample;
+            cur_track->sample = NULL;
+            cur_track->current_sample_number += 1;
+            if( sample->index )
+            {
+                uint64_t last_sample_dts = sample->dts;     /* sample might be deleted internally after appending. */
+                uint32_t sample_index    = sample->index;   /* same as above */
+                if( lsmash_append_sample( output->root, out_track->track_ID, sample ) < 0 )
+                {
+                    lsmash_delete_sample( sample );
+                    ERROR_MSG( "failed to append a sample.\n" );
+                    goto fail;
+                }
+                cur_track->current_sample_index   = sample_index;
+                out_track->current_sample_number += 1;
+                out_track->last_sample_dts        = last_sample_dts;
+            }
+            else
+                lsmash_delete_sample( sample );
+        }
+    }
+    /* Flush the last movie fragment with the durations up to the first samples in the next range. */
+    for( uint32_t t = 0; t < num_tracks; t++ )
+        in_track[t]->reach_end_of_media_timeline = (in_track[t]->current_sample_number >= plan->start[plan->num_fragments * num_tracks + t]);
+    if( flush_movie_fragment( remuxer ) < 0 )
+    {
+        ERROR_MSG( "failed to flush a movie fragment.\n" );
+        goto fail;
+    }
+    ret = 0;
+fail:
+    for( uint32_t t = 0; t < num_tracks; t++ )
+        if( in_track[t]->sample )
+        {
+            lsmash_delete_sample( in_track[t]->sample );
+            in_track[t]->sample = NULL;
+        }
+    lsmash_free( in );
+    return ret;
+}
+
+static void *dash_worker_main( void *arg )
+{
+    dash_worker_t *worker  = (dash_worker_t *)arg;
+    remuxer_t     *remuxer = &worker->remuxer;
+    worker->ret = -1;
+    for( int i = 0; i < remuxer->num_input; i++ )
+    {
+        if( get_movie( &remuxer->input[i], worker->source[i].file.name ) < 0 )
+            goto fail;
+        remuxer->input[i].file.movie.movie_ID = i + 1;
+    }
+    remuxer->output->root = lsmash_create_root();
+    if( !remuxer->output->root )
+    {
+        ERROR_MSG( "failed to create a ROOT.\n" );
+        goto fail;
+    }
+    if( prepare_output( remuxer ) < 0
+     || construct_timeline_maps( remuxer ) < 0
+     || dash_open_range( remuxer, worker->plan, worker->first_fragment ) < 0
+     || dash_remux_fragments( remuxer, worker->plan, worker->first_fragment, worker->end_fragment ) < 0 )
+        goto fail;
+    /* Finish the last media segment in this range. The initialization segment of this worker is discarded. */
+    if( lsmash_finish_movie( remuxer->output->root, remuxer->adhoc_remux ) < 0 )
+    {
+        ERROR_MSG( "failed to finish a media segment.\n" );
+        goto fail;
+    }
+    worker->ret = 0;
+fail:
+    cleanup_remuxer( remuxer );
+    return NULL;
+}
+
+static int setup_dash_worker( remuxer_t *remuxer, dash_worker_t *worker )
+{
+    worker->remuxer              = *remuxer;
+    worker->remuxer.output       = &worker->output;
+    worker->remuxer.input        = lsmash_malloc_zero( remuxer->num_input * sizeof(input_t) );
+    worker->remuxer.track_option = lsmash_malloc_zero( remuxer->num_input * sizeof(track_media_option *) );
+    worker->remuxer.adhoc_remux  = &worker->adhoc_remux;
+    worker->remuxer.dash_worker  = 1;
+    worker->remuxer.ref_chap_available = 0;
+    worker->output.file.name     = remuxer->output->file.name;
+    worker->adhoc_remux          = *remuxer->adhoc_remux;
+    worker->adhoc_remux.func     = NULL;    /* Progress is not displayed from workers. */
+    worker->adhoc_remux.param    = NULL;
+    worker->source               = remuxer->input;
+    worker->ret                  = -1;
+    if( !worker->remuxer.input || !worker->remuxer.track_option )
+    {
+        /* cleanup_remuxer() requires both arrays. */
+        worker->remuxer.num_input = 0;
+        return ERROR_MSG( "failed to allocate a worker.\n" );
+    }
+    for( int i = 0; i < remuxer->num_input; i++ )
+    {
+        worker->remuxer.track_option[i] = lsmash_memdup( remuxer->track_option[i],
+                                                         remuxer->input[i].file.movie.num_tracks * sizeof(track_media_option) );
+        if( !worker->remuxer.track_option[i] && remuxer->input[i].file.movie.num_tracks )
+            return ERROR_MSG( "failed to allocate a worker.\n" );
+    }
+    return 0;
+}
+
+/* Build media segments in parallel.
+ * Each worker thread has its own ROOTs for the inputs and the output, and writes a contiguous range of media segments.
+ * The main thread writes the initialization segment and the last range, so that the duration of the whole
+ * presentation is written into the initialization segment when finishing the movie. */
+static int do_parallel_dash_remux( remuxer_t *remuxer )
+{
+    uint32_t num_tracks = remuxer->output->file.movie.num_tracks;
+    input_t **in = lsmash_malloc( num_tracks * (sizeof(input_t *) + sizeof(input_track_t *)) );
+    if( !in )
+        return ERROR_MSG( "failed to allocate the track map.\n" );
+    input_track_t **in_track = (input_track_t **)(in + num_tracks);
+    get_active_input_tracks( remuxer, in, in_track );
+    dash_plan_t plan = { 0 };
+    int ret = build_dash_plan( remuxer, in, in_track, &plan );
+    lsmash_free( in );
+    if( ret < 0 )
+        return ERROR_MSG( "failed to plan segmentation.\n" );
+    uint32_t K            = remuxer->subseg_per_seg;
+    uint32_t num_segments = ret == 0 ? (plan.num_fragments + K - 1) / K : 0;
+    if( num_segments < 2 )
+    {
+        cleanup_dash_plan( &plan );
+        WARNING_MSG( "parallel segmentation is not available for this input. Fall back to single thread.\n" );
+        return do_remux( remuxer );
+    }
+    uint32_t num_threads = (uint32_t)remuxer->dash_threads < num_segments ? (uint32_t)remuxer->dash_threads : num_segments;
+    dash_worker_t *worker = lsmash_malloc_zero( (num_threads - 1) * sizeof(dash_worker_t) );
+    if( !worker )
+    {
+        cleanup_dash_plan( &plan );
+        return ERROR_MSG( "failed to allocate workers.\n" );
+    }
+    set_reference_chapter_track( remuxer );
+    /* The main thread handles the last range.
+     * Write the initialization segment before starting workers in order that they can share the tables
+     * lazily initialized within the library. */
+    uint32_t first_fragment = (uint64_t)num_segments * (num_threads - 1) / num_threads * K;
+    ret = dash_open_range( remuxer, &plan, first_fragment );
+    uint32_t num_started = 0;
+    for( uint32_t w = 0; ret == 0 && w < num_threads - 1; w++ )
+    {
+        worker[w].plan           = &plan;
+        worker[w].first_fragment = (uint64_t)num_segments *  w      / num_threads * K;
+        worker[w].end_fragment   = (uint64_t)num_segments * (w + 1) / num_threads * K;
+        if( setup_dash_worker( remuxer, &worker[w] ) < 0 )
+        {
+            cleanup_remuxer( &worker[w].remuxer );
+            ret = -1;
+            break;
+        }
+        if( lsmash_thread_create( &worker[w].thread, dash_worker_main, &worker[w] ) < 0 )
+        {
+            cleanup_remuxer( &worker[w].remuxer );
+            ret = ERROR_MSG( "failed to create a thread.\n" );
+            break;
+        }
+        ++num_started;
+    }
+    if( ret == 0 )
+        ret = dash_remux_fragments( remuxer, &plan, first_fragment, plan.num_fragments );
+    for( uint32_t w = 0; w < num_started; w++ )
+        if( lsmash_thread_join( &worker[w].thread, NULL ) < 0 || worker[w].ret < 0 )
+            ret = -1;
+    lsmash_free( worker );
+    cleanup_dash_plan( &plan );
+    return ret;
+}
+
+/*** Passthrough remuxing ***/
+
+/* Check whether the samples of a track can be copied verbatim from the first sample. */
+static int is_passthrough_track( input_track_t *in_track, output_track_t *out_track )
+{
+    if( in_track->current_sample_number != 1 )
+        return 0;
+    for( uint32_t i = 0; i < in_track->num_summaries; i++ )
+        if( out_track->summary_remap[i] != i + 1 )
+            return 0;
+    return 1;
+}
+
+/* Remux by copying the chunks of the input tracks verbatim.
+ * The chunks are interleaved in the order of the DTS of their first samples.
+ * Samples which cannot be copied so, e.g. LPCM samples or samples in a track starting from a seek point, are appended one by one. */
+static int do_passthrough_remux( remuxer_t *remuxer )
+{
+    output_t       *output     = remuxer->output;
+    output_movie_t *out_movie  = &output->file.movie;
+    uint32_t        num_tracks = out_movie->num_tracks;
+    input_t **in = lsmash_malloc( num_tracks * (sizeof(input_t *) + sizeof(input_track_t *) + sizeof(track_queue_entry_t) + sizeof(int)) );
+    if( !in )
+        return ERROR_MSG( "failed to allocate the track map.\n" );
+    input_track_t **in_track    = (input_track_t **)(in + num_tracks);
+    track_queue_t   queue       = { (track_queue_entry_t *)(in_track + num_tracks), 0 };
+    int            *copy_chunks = (int *)(queue.entry + num_tracks);
+    get_active_input_tracks( remuxer, in, in_track );
+    for( uint32_t t = 0; t < num_tracks; t++ )
+    {
+        copy_chunks[t] = is_passthrough_track( in_track[t], &out_movie->track[t] );
+        lsmash_sample_t info;
+        if( lsmash_get_sample_info_from_media_timeline( in[t]->root, in_track[t]->track_ID, in_track[t]->current_sample_number, &info ) >= 0 )
+            track_queue_push( &queue, (double)info.dts / in_track[t]->media.param.timescale, t );
+    }
+    set_reference_chapter_track( remuxer );
+    uint64_t total_media_size = 0;
+    uint32_t progress_pos     = 0;
+    int      ret              = 0;
+    while( queue.size )
+    {
+        uint32_t        t         = queue.entry[0].number;
+        output_track_t *out_track = &out_movie->track[t];
+        uint32_t        count     = 0;
+        uint64_t        size      = 0;
+        if( copy_chunks[t] )
+        {
+            /* Get the information of the first and the last samples in the order of access
+             * since the media timeline is fast for sequential access. */
+            uint32_t        first = in_track[t]->current_sample_number;
+            lsmash_sample_t head;
+            lsmash_sample_t tail;
+            if( lsmash_get_sample_info_from_media_timeline( in[t]->root, in_track[t]->track_ID, first, &head ) < 0 )
+            {
+                ret = ERROR_MSG( "failed to get the information of a sample.\n" );
+                break;
+            }
+            int err = lsmash_append_chunk_from_media_timeline( output->root, out_track->track_ID,
+                                                               in[t]->root, in_track[t]->track_ID, first, &count );
+            if( err == LSMASH_ERR_PATCH_WELCOME )
+                copy_chunks[t] = 0;
+            else if( err < 0 )
+            {
+                ret = ERROR_MSG( "failed to append a chunk.\n" );
+                break;
+            }
+            else
+            {
+                if( lsmash_get_sample_info_from_media_timeline( in[t]->root, in_track[t]->track_ID, first + count - 1, &tail ) < 0 )
+                {
+                    ret = ERROR_MSG( "failed to get the information of a sample.\n" );
+                    break;
+                }
+                size                       = tail.pos + tail.length - head.pos;
+                out_track->last_sample_dts = tail.dts;
+            }
+        }
+        if( count == 0 )
+        {
+            lsmash_sample_t *sample = lsmash_get_sample_from_media_timeline( in[t]->root, in_track[t]->track_ID, in_track[t]->current_sample_number );
+            if( !sample )
+            {
+                ret = ERROR_MSG( "failed to get a sample.\n" );
+                break;
+            }
+            adapt_description_index( out_track, in_track[t], sample );
+            adjust_timestamp( out_track, sample );
+            if( sample->index == 0 )
+                lsmash_delete_sample( sample );
+            else
+            {
+                size                       = sample->length;
+                out_track->last_sample_dts = sample->dts;
+                if( lsmash_append_sample( output->root, out_track->track_ID, sample ) < 0 )
+                {
+                    lsmash_delete_sample( sample );
+                    ret = ERROR_MSG( "failed to append a sample.\n" );
+                    break;
+                }
+            }
+            count = 1;
+        }
+        in_track[t]->current_sample_number += count;
+        out_track->current_sample_number   += count;
+        total_media_size                   += size;
+        /* Print, per 4 megabytes, total size of imported media. */
+        if( (total_media_size >> 22) > progress_pos )
+        {
+            progress_pos = total_media_size >> 22;
+            eprintf( "Importing: %"PRIu64" bytes\r", total_media_size );
+        }
+        lsmash_sample_t info;
+        if( lsmash_get_sample_info_from_media_timeline( in[t]->root, in_track[t]->track_ID, in_track[t]->current_sample_number, &info ) < 0 )
+            track_queue_pop( &queue );      /* end of this track */
+        else
+            track_queue_update_top( &queue, (double)info.dts / in_track[t]->media.param.timescale );
+    }
+    lsmash_free( in );
+    if( ret < 0 )
+        return ret;
+    for( uint32_t i = 0; i < num_tracks; i++ )
+        if( lsmash_flush_pooled_samples( output->root, out_movie->track[i].track_ID, out_movie->track[i].last_sample_delta ) )
+            return ERROR_MSG( "failed to flush samples.\n" );
+    return 0;
+}
+
 static int finish_movie( remuxer_t *remuxer )
 {
     output_t *output = remuxer->output;
@@ -1742,7 +2497,7 @@ static int finish_movie( remuxer_t *remuxer )
         lsmash_set_tyrant_chapter( output->root, remuxer->chap_file, remuxer->add_bom_to_chpl );
     /* Finish muxing. */
     REFRESH_CONSOLE;
-    if( lsmash_finish_movie( output->root, &moov_to_front ) )
+    if( lsmash_finish_movie( output->root, remuxer->adhoc_remux ) )
         return -1;
     return remuxer->frag_base_track ? 0 : lsmash_write_lsmash_indicator( output->root );
 }
@@ -1804,8 +2559,12 @@ int main( int argc, char *argv[] )
         .subseg_per_seg           = 0,
         .dash                     = 0,
         .compact_size_table       = 0,
+        .passthrough              = 0,
         .min_frag_duration        = 0.0,
-        .dry_run                  = 0
+        .dry_run                  = 0,
+        .dash_threads             = 1,
+        .dash_worker              = 0,
+        .adhoc_remux              = &moov_to_front
     };
     if( parse_cli_option( argc, argv, &remuxer ) )
         return REMUXER_ERR( "failed to parse command line options.\n" );
@@ -1813,7 +2572,9 @@ int main( int argc, char *argv[] )
         return REMUXER_ERR( "failed to set up preparation for output.\n" );
     if( remuxer.frag_base_track && construct_timeline_maps( &remuxer ) )
         return REMUXER_ERR( "failed to construct timeline maps.\n" );
-    if( do_remux( &remuxer ) )
+    if( (remuxer.dash_threads > 1 ? do_parallel_dash_remux( &remuxer )
+       : remuxer.passthrough      ? do_passthrough_remux( &remuxer )
+       :                            do_remux( &remuxer )) )
         return REMUXER_ERR( "failed to remux movies.\n" );
     if( remuxer.frag_base_track == 0 && construct_timeline_maps( &remuxer ) )
         return REMUXER_ERR( "failed to construct timeline maps.\n" );
@@ -108,6 +108,7 @@ typedef struct
     uint32_t empty_delay_num;
     uint32_t empty_delay_den;
     int      dts_compression;
+    int      in_place;
 } opt_t;
 
 static void cleanup_root( root_t *h )
@@ -261,7 +262,7 @@ static int get_summaries( root_t *input, track_t *track )
     return 0;
 }
 
-static int get_movie( root_t *input, char *input_name )
+static int get_movie( root_t *input, char *input_name, int in_place )
 {
     if( !strcmp( input_name, "-" ) )
         return ERROR_MSG( "Standard input not supported.\n" );
@@ -269,7 +270,7 @@ static int get_movie( root_t *input, char *input_name )
     if( !input->root )
         return ERROR_MSG( "failed to create a ROOT for an input file.\n" );
     file_t *in_file = &input->file;
-    if( lsmash_open_file( input_name, 1, &in_file->param ) < 0 )
+    if( lsmash_open_file( input_name, in_place ? 2 : 1, &in_file->param ) < 0 )
         return ERROR_MSG( "failed to open an input file.\n" );
     in_file->fh = lsmash_set_file( input->root, &in_file->param );
     if( !in_file->fh )
@@ -334,7 +335,8 @@ static int get_movie( root_t *input, char *input_name )
             WARNING_MSG( "failed to get the last sample delta.\n" );
             continue;
         }
-        if( get_summaries( input, &track[i] ) )
+        /* The sample descriptions are left as they are when editing in place, so just check they exist. */
+        if( in_place ? lsmash_count_summary( input->root, track[i].track_ID ) == 0 : get_summaries( input, &track[i] ) )
         {
             WARNING_MSG( "failed to get valid summaries.\n" );
             continue;
@@ -342,7 +344,9 @@ static int get_movie( root_t *input, char *input_name )
         track[i].active                = 1;
         track[i].current_sample_number = 1;
     }
-    lsmash_destroy_children( lsmash_file_as_box( in_file->fh ) );
+    /* The boxes are written back into the file when editing in place. */
+    if( !in_place )
+        lsmash_destroy_children( lsmash_file_as_box( in_file->fh ) );
     return 0;
 }
 
@@ -831,6 +835,87 @@ static int edit_media_timeline( root_t *input, timecode_t *timecode, opt_t *opt
     return 0;
 }
 
+static int edit_timeline_map( lsmash_root_t *root, uint32_t track_ID, timecode_t *timecode, opt_t *opt )
+{
+    uint32_t movie_timescale = lsmash_get_movie_timescale( root );
+    uint32_t media_timescale = lsmash_get_media_timescale( root, track_ID );
+    uint64_t empty_delay     = timecode->empty_delay + (uint64_t)((double)((uint64_t)opt->empty_delay_num * media_timescale) / opt->empty_delay_den + 0.5);
+    uint64_t duration        = timecode->duration + empty_delay;
+    if( lsmash_delete_explicit_timeline_map( root, track_ID ) )
+        return ERROR_MSG( "Failed to delete explicit timeline maps.\n" );
+    if( empty_delay )
+    {
+        lsmash_edit_t empty_edit;
+        empty_edit.duration   = ((double)empty_delay / media_timescale) * movie_timescale;
+        empty_edit.start_time = ISOM_EDIT_MODE_EMPTY;
+        empty_edit.rate       = ISOM_EDIT_MODE_NORMAL;
+        if( lsmash_create_explicit_timeline_map( root, track_ID, empty_edit ) )
+            return ERROR_MSG( "Failed to create a empty duration.\n" );
+        duration  = ((double)duration / media_timescale) * movie_timescale;
+        duration -= empty_edit.duration;
+    }
+    else
+        duration  = ((double)duration / media_timescale) * movie_timescale;
+    lsmash_edit_t edit;
+    edit.duration   = duration;
+    edit.start_time = timecode->composition_delay + (uint64_t)((double)((uint64_t)opt->skip_duration_num * media_timescale) / opt->skip_duration_den + 0.5);
+    edit.rate       = ISOM_EDIT_MODE_NORMAL;
+    if( lsmash_create_explicit_timeline_map( root, track_ID, edit ) )
+        return ERROR_MSG( "Failed to create a explicit timeline map.\n" );
+    return 0;
+}
+
+static int scale_timeline_map( lsmash_root_t *root, uint32_t track_ID, uint32_t orig_media_timescale, uint32_t media_timescale )
+{
+    uint32_t edit_count = lsmash_count_explicit_timeline_map( root, track_ID );
+    for( uint32_t i = 1; i <= edit_count; i++ )
+    {
+        lsmash_edit_t edit;
+        if( lsmash_get_explicit_timeline_map( root, track_ID, i, &edit ) )
+            return ERROR_MSG( "Failed to get an explicit timeline map.\n" );
+        if( edit.start_time == ISOM_EDIT_MODE_EMPTY )
+            continue;
+        edit.start_time = ((double)edit.start_time / orig_media_timescale) * media_timescale + 0.5;
+        if( lsmash_modify_explicit_timeline_map( root, track_ID, i, edit ) )
+            return ERROR_MSG( "Failed to modify an explicit timeline map.\n" );
+    }
+    return 0;
+}
+
+static int edit_movie_in_place( movie_io_t *io, opt_t *opt, int edit_map )
+{
+    root_t  *input    = io->input;
+    track_t *track    = &input->file.movie.track[ opt->track_number - 1 ];
+    uint32_t track_ID = track->track_ID;
+    uint32_t orig_media_timescale = track->media_param.timescale;
+    if( !track->active )
+        return timelineeditor_error( io, "The track to edit is unavailable.\n" );
+    if( edit_media_timeline( input, io->timecode, opt ) )
+        return timelineeditor_error( io, "Failed to edit timeline.\n" );
+    /* Only the sample timing tables, the durations and the timeline map are updated.
+     * The media data and the tables to locate samples are left as they are. */
+    if( lsmash_update_sample_timing_tables( input->root, track_ID, track->media_param.timescale, track->last_sample_delta ) )
+        return timelineeditor_error( io, "Failed to update sample timing tables.\n" );
+    if( edit_map )
+    {
+        if( edit_timeline_map( input->root, track_ID, io->timecode, opt ) )
+            return timelineeditor_error( io, "Failed to edit timeline map.\n" );
+    }
+    else if( track->media_param.timescale != orig_media_timescale
+          && scale_timeline_map( input->root, track_ID, orig_media_timescale, track->media_param.timescale ) )
+        return timelineeditor_error( io, "Failed to convert timeline map.\n" );
+    if( lsmash_update_media_modification_time( input->root, track_ID )
+     || lsmash_update_track_modification_time( input->root, track_ID )
+     || lsmash_update_movie_modification_time( input->root ) )
+        return timelineeditor_error( io, "Failed to update modification time.\n" );
+    if( lsmash_write_movie_in_place( input->root ) )
+        return timelineeditor_error( io, "Failed to write the movie back into the input file.\n" );
+    cleanup_root( io->input );
+    cleanup_timecode( io->timecode );
+    eprintf( "Timeline editing completed!                                                    \n" );
+    return 0;
+}
+
 static int check_white_brand( lsmash_brand_type brand )
 {
     static const lsmash_brand_type brand_white_list[] =
@@ -888,6 +973,7 @@ static void display_help( void )
     display_version();
     eprintf( "\n"
              "Usage: timelineeditor [options] input output\n"
+             "       timelineeditor --in-place [options] input\n"
              "  options:\n"
              "    --help                       Display help\n"
              "    --version                    Display version information\n"
@@ -898,7 +984,9 @@ static void display_help( void )
              "    --skip            <rational> Skip start of media presentation in arbitrary units\n"
              "    --delay           <rational> Insert blank clip before actual media presentation in arbitrary units\n"
              "    --dts-compression            Eliminate composition delay with DTS hack\n"
-             "                                 Multiply media timescale and timebase automatically\n" );
+             "                                 Multiply media timescale and timebase automatically\n"
+             "    --in-place                   Edit the input file in place without copying media data\n"
+             "                                 Only the movie header boxes are rewritten\n" );
 }
 
 int main( int argc, char *argv[] )
@@ -936,12 +1024,18 @@ int main( int argc, char *argv[] )
         .skip_duration_den = 1,
         .empty_delay_num   = 0,
         .empty_delay_den   = 1,
-        .dts_compression   = 0
+        .dts_compression   = 0,
+        .in_place          = 0
     };
     /* Parse options. */
     lsmash_get_mainargs( &argc, &argv );
+    /* In-place editing takes no output file, so find it before parsing the other options. */
+    for( int i = 1; i < argc - 1; i++ )
+        if( !strcasecmp( argv[i], "--in-place" ) )
+            opt.in_place = 1;
+    int num_files = opt.in_place ? 1 : 2;
     int argn = 1;
-    while( argn < argc - 2 )
+    while( argn < argc - num_files )
     {
         if( !strcasecmp( argv[argn], "--track" ) )
         {
@@ -1000,17 +1094,21 @@ int main( int argc, char *argv[] )
             opt.dts_compression = 1;
             ++argn;
         }
+        else if( !strcasecmp( argv[argn], "--in-place" ) )
+            ++argn;
         else
             return TIMELINEEDITOR_ERR( "Invalid option.\n" );
     }
-    if( argn > argc - 2 )
+    if( argn > argc - num_files )
         return TIMELINEEDITOR_ERR( "Invalid arguments.\n" );
     /* Get input movies. */
-    if( get_movie( &input, argv[argn++] ) )
+    if( get_movie( &input, argv[argn++], opt.in_place ) )
         return TIMELINEEDITOR_ERR( "Failed to get input movie.\n" );
     movie_t *in_movie = &input.file.movie;
     if( opt.track_number && (opt.track_number > in_movie->num_tracks) )
         return TIMELINEEDITOR_ERR( "Invalid track number.\n" );
+    if( opt.in_place )
+        return edit_movie_in_place( &io, &opt, argc > 3 );
     /* Create output movie. */
     file_t *out_file = &output.file;
     output.root = lsmash_create_root();
@@ -1203,36 +1301,9 @@ int main( int argc, char *argv[] )
         if( lsmash_copy_timeline_map( output.root, out_movie->track[i].track_ID, input.root, in_movie->track[i].track_ID ) )
             return TIMELINEEDITOR_ERR( "Failed to copy a timeline map.\n" );
     /* Edit timeline map. */
-    if( argc > 3 )
-    {
-        track_t *out_track       = &out_movie->track[ opt.track_number - 1 ];
-        uint32_t track_ID        = out_track->track_ID;
-        uint32_t movie_timescale = lsmash_get_movie_timescale( output.root );
-        uint32_t media_timescale = lsmash_get_media_timescale( output.root, track_ID );
-        uint64_t empty_delay     = timecode.empty_delay + (uint64_t)((double)((uint64_t)opt.empty_delay_num * media_timescale) / opt.empty_delay_den + 0.5);
-        uint64_t duration        = timecode.duration + empty_delay;
-        if( lsmash_delete_explicit_timeline_map( output.root, track_ID ) )
-            return TIMELINEEDITOR_ERR( "Failed to delete explicit timeline maps.\n" );
-        if( empty_delay )
-        {
-            lsmash_edit_t empty_edit;
-            empty_edit.duration   = ((double)empty_delay / media_timescale) * movie_timescale;
-            empty_edit.start_time = ISOM_EDIT_MODE_EMPTY;
-            empty_edit.rate       = ISOM_EDIT_MODE_NORMAL;
-            if( lsmash_create_explicit_timeline_map( output.root, track_ID, empty_edit ) )
-                return TIMELINEEDITOR_ERR( "Failed to create a empty duration.\n" );
-            duration  = ((double)duration / media_timescale) * movie_timescale;
-            duration -= empty_edit.duration;
-        }
-        else
-            duration  = ((double)duration / media_timescale) * movie_timescale;
-        lsmash_edit_t edit;
-        edit.duration   = duration;
-        edit.start_time = timecode.composition_delay + (uint64_t)((double)((uint64_t)opt.skip_duration_num * media_timescale) / opt.skip_duration_den + 0.5);
-        edit.rate       = ISOM_EDIT_MODE_NORMAL;
-        if( lsmash_create_explicit_timeline_map( output.root, track_ID, edit ) )
-            return TIMELINEEDITOR_ERR( "Failed to create a explicit timeline map.\n" );
-    }
+    if( argc > 3
+     && edit_timeline_map( output.root, out_movie->track[ opt.track_number - 1 ].track_ID, &timecode, &opt ) )
+        return TIMELINEEDITOR_ERR( "Failed to edit timeline map.\n" );
     /* Finish muxing. */
     lsmash_adhoc_remux_t moov_to_front;
     moov_to_front.func = moov_to_front_callback;
@@ -27,6 +27,7 @@
 #include <inttypes.h>
 
 #include "core/box.h"
+#include "core/print.h"
 
 static const char *bit_stream_mode[] =
     {
@@ -196,21 +197,21 @@ int ac3_construct_specific_parameters( lsmash_codec_specific_t *dst, lsmash_code
         return LSMASH_ERR_INVALID_DATA;
     param->fscod      = (data[0] >> 6) & 0x03;                                  /* XXxx xxxx xxxx xxxx xxxx xxxx */
     param->bsid       = (data[0] >> 1) & 0x1F;                                  /* xxXX XXXx xxxx xxxx xxxx xxxx */
-    param->bsmod      = ((data[0] & 0x01) << 2) | ((data[2] >> 6) & 0x03);      /* xxxx xxxX XXxx xxxx xxxx xxxx */
+    param->bsmod      = ((data[0] & 0x01) << 2) | ((data[1] >> 6) & 0x03);      /* xxxx xxxX XXxx xxxx xxxx xxxx */
     param->acmod      = (data[1] >> 3) & 0x07;                                  /* xxxx xxxx xxXX Xxxx xxxx xxxx */
     param->lfeon      = (data[1] >> 2) & 0x01;                                  /* xxxx xxxx xxxx xXxx xxxx xxxx */
-    param->frmsizecod = ((data[1] & 0x03) << 3) | ((data[3] >> 5) & 0x07);      /* xxxx xxxx xxxx xxXX XXXx xxxx */
+    param->frmsizecod = ((data[1] & 0x03) << 3) | ((data[2] >> 5) & 0x07);      /* xxxx xxxx xxxx xxXX XXXx xxxx */
     param->frmsizecod <<= 1;
     return 0;
 }
 
-int ac3_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+int ac3_print_codec_specific( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     assert( box->manager & LSMASH_BINARY_CODED_BOX );
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: AC3 Specific Box]\n", isom_4cc2str( box->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+    isom_iprint_box( printer, indent++, isom_4cc2str( box->type.fourcc ), "AC3 Specific Box" );
+    isom_iprint_uint( printer, indent, "position", box->pos );
+    isom_iprint_uint( printer, indent, "size", box->size );
     if( box->size < AC3_SPECIFIC_BOX_LENGTH )
         return LSMASH_ERR_INVALID_DATA;
     uint8_t *data = box->binary;
@@ -221,22 +222,28 @@ int ac3_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, in
     uint8_t acmod         = (data[1] >> 3) & 0x07;
     uint8_t lfeon         = (data[1] >> 2) & 0x01;
     uint8_t bit_rate_code = ((data[1] & 0x03) << 3) | ((data[2] >> 5) & 0x07);
+    isom_iprint_uint( printer, indent, "fscod", fscod );
     if( fscod != 0x03 )
-        lsmash_ifprintf( fp, indent, "fscod = %"PRIu8" (%"PRIu32" Hz)\n", fscod, ac3_sample_rate_table[fscod] );
+        isom_iprint_note( printer, "%"PRIu32" Hz", ac3_sample_rate_table[fscod] );
     else
-        lsmash_ifprintf( fp, indent, "fscod = 0x03 (reserved)\n" );
-    lsmash_ifprintf( fp, indent, "bsid = %"PRIu8"\n", bsid );
-    lsmash_ifprintf( fp, indent, "bsmod = %"PRIu8" (%s)\n", bsmod, bit_stream_mode[bsmod + (acmod == 0x01 ? 1 : acmod > 0x01 ? 2 : 0)] );
-    lsmash_ifprintf( fp, indent, "acmod = %"PRIu8" (%s)\n", acmod, audio_coding_mode[acmod + (bsmod == 0x07 ? 8 : 0)] );
-    lsmash_ifprintf( fp, indent, "lfeon = %s\n", lfeon ? "1 (LFE)" : "0" );
+        isom_iprint_note( printer, "reserved" );
+    isom_iprint_uint( printer, indent, "bsid", bsid );
+    isom_iprint_uint( printer, indent, "bsmod", bsmod );
+    isom_iprint_note( printer, "%s", bit_stream_mode[bsmod + (acmod == 0x01 ? 1 : acmod > 0x01 ? 2 : 0)] );
+    isom_iprint_uint( printer, indent, "acmod", acmod );
+    isom_iprint_note( printer, "%s", audio_coding_mode[acmod + (bsmod == 0x07 ? 8 : 0)] );
+    isom_iprint_uint( printer, indent, "lfeon", lfeon );
+    if( lfeon )
+        isom_iprint_note( printer, "LFE" );
     static const uint32_t bit_rate[] =
         {
             32,   40,  48,  56,  64,  80,  96, 112, 128,
             160, 192, 224, 256, 320, 384, 448, 512, 576, 640,
             0   /* undefined */
         };
-    lsmash_ifprintf( fp, indent, "bit_rate_code = 0x%02"PRIx8" (%"PRIu32" kbit/s)\n", bit_rate_code, bit_rate[bit_rate_code] );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n", data[2] & 0x1F );
+    isom_iprint_hex( printer, indent, "bit_rate_code", bit_rate_code, 2 );
+    isom_iprint_note( printer, "%"PRIu32" kbit/s", bit_rate[bit_rate_code] );
+    isom_iprint_hex( printer, indent, "reserved", data[2] & 0x1F, 2 );
     return 0;
 }
 
@@ -673,24 +680,25 @@ void eac3_update_channel_count
               + independent_info->lfeon;                            /* LFE */
 }
 
-int eac3_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+int eac3_print_codec_specific( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     assert( box->manager & LSMASH_BINARY_CODED_BOX );
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: EC3 Specific Box]\n", isom_4cc2str( box->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+    isom_iprint_box( printer, indent++, isom_4cc2str( box->type.fourcc ), "EC3 Specific Box" );
+    isom_iprint_uint( printer, indent, "position", box->pos );
+    isom_iprint_uint( printer, indent, "size", box->size );
     if( box->size < EAC3_SPECIFIC_BOX_MIN_LENGTH )
         return LSMASH_ERR_INVALID_DATA;
     uint8_t *data = box->binary;
     isom_skip_box_common( &data );
-    lsmash_ifprintf( fp, indent, "data_rate = %"PRIu16" kbit/s\n", (data[0] << 5) | ((data[1] >> 3) & 0x1F) );
+    isom_iprint_uint( printer, indent, "data_rate", (data[0] << 5) | ((data[1] >> 3) & 0x1F) );
+    isom_iprint_unit( printer, "kbit/s" );
     uint8_t num_ind_sub = data[1] & 0x07;
-    lsmash_ifprintf( fp, indent, "num_ind_sub = %"PRIu8"\n", num_ind_sub );
+    isom_iprint_uint( printer, indent, "num_ind_sub", num_ind_sub );
     data += 2;
     for( int i = 0; i <= num_ind_sub; i++ )
     {
-        lsmash_ifprintf( fp, indent, "independent_substream[%d]\n", i );
+        isom_iprint_element( printer, indent, "independent_substream", i );
         int sub_indent = indent + 1;
         uint8_t fscod       = (data[0] >> 6) & 0x03;
         uint8_t bsid        = (data[0] >> 1) & 0x1F;
@@ -698,18 +706,23 @@ int eac3_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, i
         uint8_t acmod       = (data[1] >> 1) & 0x07;
         uint8_t lfeon       = data[1] & 0x01;
         uint8_t num_dep_sub = (data[2] >> 1) & 0x0F;
+        isom_iprint_uint( printer, sub_indent, "fscod", fscod );
         if( fscod != 0x03 )
-            lsmash_ifprintf( fp, sub_indent, "fscod = %"PRIu8" (%"PRIu32" Hz)\n", fscod, ac3_sample_rate_table[fscod] );
+            isom_iprint_note( printer, "%"PRIu32" Hz", ac3_sample_rate_table[fscod] );
         else
-            lsmash_ifprintf( fp, sub_indent, "fscod = 0x03 (reduced sample rate)\n" );
-        lsmash_ifprintf( fp, sub_indent, "bsid = %"PRIu8"\n", bsid );
+            isom_iprint_note( printer, "reduced sample rate" );
+        isom_iprint_uint( printer, sub_indent, "bsid", bsid );
+        isom_iprint_uint( printer, sub_indent, "bsmod", bsmod );
         if( bsmod < 0x08 )
-            lsmash_ifprintf( fp, sub_indent, "bsmod = %"PRIu8" (%s)\n", bsmod, bit_stream_mode[bsmod + (acmod == 0x01 ? 1 : acmod > 0x01 ? 2 : 0)] );
+            isom_iprint_note( printer, "%s", bit_stream_mode[bsmod + (acmod == 0x01 ? 1 : acmod > 0x01 ? 2 : 0)] );
         else
-            lsmash_ifprintf( fp, sub_indent, "bsmod = %"PRIu8" (Undefined service)\n" );
-        lsmash_ifprintf( fp, sub_indent, "acmod = %"PRIu8" (%s)\n", acmod, audio_coding_mode[acmod + (bsmod == 0x07 ? 8 : 0)] );
-        lsmash_ifprintf( fp, sub_indent, "lfeon = %s\n", lfeon ? "1 (LFE)" : "0" );
-        lsmash_ifprintf( fp, sub_indent, "num_dep_sub = %"PRIu8"\n", num_dep_sub );
+            isom_iprint_note( printer, "Undefined service" );
+        isom_iprint_uint( printer, sub_indent, "acmod", acmod );
+        isom_iprint_note( printer, "%s", audio_coding_mode[acmod + (bsmod == 0x07 ? 8 : 0)] );
+        isom_iprint_uint( printer, sub_indent, "lfeon", lfeon );
+        if( lfeon )
+            isom_iprint_note( printer, "LFE" );
+        isom_iprint_uint( printer, sub_indent, "num_dep_sub", num_dep_sub );
         data += 3;
         if( num_dep_sub > 0 )
         {
@@ -726,14 +739,14 @@ int eac3_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, i
                     "Lc/Rc pair"
                 };
             uint16_t chan_loc = ((data[-1] & 0x01) << 8) | data[0];
-            lsmash_ifprintf( fp, sub_indent, "chan_loc = 0x%04"PRIx16"\n", chan_loc );
+            isom_iprint_hex( printer, sub_indent, "chan_loc", chan_loc, 4 );
             for( int j = 0; j < 9; j++ )
                 if( (chan_loc >> j & 0x01) )
-                    lsmash_ifprintf( fp, sub_indent + 1, "%s\n", channel_location[j] );
+                    isom_iprint_label( printer, sub_indent + 1, channel_location[j] );
             data += 1;
         }
         else
-            lsmash_ifprintf( fp, sub_indent, "reserved = %"PRIu8"\n", data[2] & 0x01 );
+            isom_iprint_uint( printer, sub_indent, "reserved", data[2] & 0x01 );
     }
     return 0;
 }
@@ -27,6 +27,7 @@
 #include <inttypes.h>
 
 #include "core/box.h"
+#include "core/print.h"
 
 #define ALAC_SPECIFIC_BOX_LENGTH 36
 
@@ -79,31 +80,31 @@ int alac_construct_specific_parameters( lsmash_codec_specific_t *dst, lsmash_cod
     return 0;
 }
 
-int alac_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+int alac_print_codec_specific( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     assert( box->manager & LSMASH_BINARY_CODED_BOX );
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: ALAC Specific Box]\n", isom_4cc2str( box->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+    isom_iprint_box( printer, indent++, isom_4cc2str( box->type.fourcc ), "ALAC Specific Box" );
+    isom_iprint_uint( printer, indent, "position", box->pos );
+    isom_iprint_uint( printer, indent, "size", box->size );
     if( box->size < ALAC_SPECIFIC_BOX_LENGTH )
         return LSMASH_ERR_INVALID_DATA;
     uint8_t *data = box->binary;
     isom_skip_box_common( &data );
-    lsmash_ifprintf( fp, indent, "version = %"PRIu8"\n",           LSMASH_GET_BYTE( &data[0] ) );
-    lsmash_ifprintf( fp, indent, "flags = 0x%06"PRIx32"\n",        LSMASH_GET_BE24( &data[1] ) );
+    isom_iprint_uint( printer, indent, "version", LSMASH_GET_BYTE( &data[0] ) );
+    isom_iprint_hex( printer, indent, "flags", LSMASH_GET_BE24( &data[1] ), 6 );
     data += 4;
-    lsmash_ifprintf( fp, indent, "frameLength = %"PRIu32"\n",      LSMASH_GET_BE32( &data[0] ) );
-    lsmash_ifprintf( fp, indent, "compatibleVersion = %"PRIu8"\n", LSMASH_GET_BYTE( &data[4] ) );
-    lsmash_ifprintf( fp, indent, "bitDepth = %"PRIu8"\n",          LSMASH_GET_BYTE( &data[5] ) );
-    lsmash_ifprintf( fp, indent, "pb = %"PRIu8"\n",                LSMASH_GET_BYTE( &data[6] ) );
-    lsmash_ifprintf( fp, indent, "mb = %"PRIu8"\n",                LSMASH_GET_BYTE( &data[7] ) );
-    lsmash_ifprintf( fp, indent, "kb = %"PRIu8"\n",                LSMASH_GET_BYTE( &data[8] ) );
-    lsmash_ifprintf( fp, indent, "numChannels = %"PRIu8"\n",       LSMASH_GET_BYTE( &data[9] ) );
-    lsmash_ifprintf( fp, indent, "maxRun = %"PRIu16"\n",           LSMASH_GET_BE16( &data[10] ) );
-    lsmash_ifprintf( fp, indent, "maxFrameBytes = %"PRIu32"\n",    LSMASH_GET_BE32( &data[12] ) );
-    lsmash_ifprintf( fp, indent, "avgBitrate = %"PRIu32"\n",       LSMASH_GET_BE32( &data[16] ) );
-    lsmash_ifprintf( fp, indent, "sampleRate = %"PRIu32"\n",       LSMASH_GET_BE32( &data[20] ) );
+    isom_iprint_uint( printer, indent, "frameLength", LSMASH_GET_BE32( &data[0] ) );
+    isom_iprint_uint( printer, indent, "compatibleVersion", LSMASH_GET_BYTE( &data[4] ) );
+    isom_iprint_uint( printer, indent, "bitDepth", LSMASH_GET_BYTE( &data[5] ) );
+    isom_iprint_uint( printer, indent, "pb", LSMASH_GET_BYTE( &data[6] ) );
+    isom_iprint_uint( printer, indent, "mb", LSMASH_GET_BYTE( &data[7] ) );
+    isom_iprint_uint( printer, indent, "kb", LSMASH_GET_BYTE( &data[8] ) );
+    isom_iprint_uint( printer, indent, "numChannels", LSMASH_GET_BYTE( &data[9] ) );
+    isom_iprint_uint( printer, indent, "maxRun", LSMASH_GET_BE16( &data[10] ) );
+    isom_iprint_uint( printer, indent, "maxFrameBytes", LSMASH_GET_BE32( &data[12] ) );
+    isom_iprint_uint( printer, indent, "avgBitrate", LSMASH_GET_BE32( &data[16] ) );
+    isom_iprint_uint( printer, indent, "sampleRate", LSMASH_GET_BE32( &data[20] ) );
     return 0;
 }
 
@@ -27,6 +27,7 @@
 #include <inttypes.h>
 
 #include "core/box.h"
+#include "core/print.h"
 
 /*****************************************************************************
     ETSI TS 102 114 V1.2.1 (2002-12)
@@ -1677,13 +1678,13 @@ int dts_copy_codec_specific( lsmash_codec_specific_t *dst, lsmash_codec_specific
     return lsmash_append_dts_reserved_box( dst_data, src_data->box->data, src_data->box->size );
 }
 
-int dts_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+int dts_print_codec_specific( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     assert( box->manager & LSMASH_BINARY_CODED_BOX );
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: DTS Specific Box]\n", isom_4cc2str( box->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+    isom_iprint_box( printer, indent++, isom_4cc2str( box->type.fourcc ), "DTS Specific Box" );
+    isom_iprint_uint( printer, indent, "position", box->pos );
+    isom_iprint_uint( printer, indent, "size", box->size );
     if( box->size < DTS_SPECIFIC_BOX_MIN_LENGTH )
         return LSMASH_ERR_INVALID_DATA;
     uint8_t *data = box->binary;
@@ -1750,64 +1751,72 @@ int dts_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, in
             "Center height in rear",
             "Left/Right height in rear"
         };
-    lsmash_ifprintf( fp, indent, "DTSSamplingFrequency = %"PRIu32" Hz\n", DTSSamplingFrequency );
-    lsmash_ifprintf( fp, indent, "maxBitrate = %"PRIu32" bit/s\n", maxBitrate );
-    lsmash_ifprintf( fp, indent, "avgBitrate = %"PRIu32" bit/s\n", avgBitrate );
-    lsmash_ifprintf( fp, indent, "pcmSampleDepth = %"PRIu8" bits\n", pcmSampleDepth );
-    lsmash_ifprintf( fp, indent, "FrameDuration = %"PRIu8" (%"PRIu32" samples)\n", FrameDuration, frame_duration );
-    lsmash_ifprintf( fp, indent, "StreamConstruction = 0x%02"PRIx8"\n", StreamConstruction );
+    isom_iprint_uint( printer, indent, "DTSSamplingFrequency", DTSSamplingFrequency );
+    isom_iprint_unit( printer, "Hz" );
+    isom_iprint_uint( printer, indent, "maxBitrate", maxBitrate );
+    isom_iprint_unit( printer, "bit/s" );
+    isom_iprint_uint( printer, indent, "avgBitrate", avgBitrate );
+    isom_iprint_unit( printer, "bit/s" );
+    isom_iprint_uint( printer, indent, "pcmSampleDepth", pcmSampleDepth );
+    isom_iprint_unit( printer, "bits" );
+    isom_iprint_uint( printer, indent, "FrameDuration", FrameDuration );
+    isom_iprint_note( printer, "%"PRIu32" samples", frame_duration );
+    isom_iprint_hex( printer, indent, "StreamConstruction", StreamConstruction, 2 );
     if( construction_flags & (DTS_CORE_SUBSTREAM_CORE_FLAG | DTS_CORE_SUBSTREAM_XCH_FLAG | DTS_CORE_SUBSTREAM_X96_FLAG | DTS_CORE_SUBSTREAM_XXCH_FLAG) )
     {
-        lsmash_ifprintf( fp, indent + 1, "Core substream\n" );
+        isom_iprint_label( printer, indent + 1, "Core substream" );
         if( construction_flags & DTS_CORE_SUBSTREAM_CORE_FLAG )
-            lsmash_ifprintf( fp, indent + 2, "Core\n" );
+            isom_iprint_label( printer, indent + 2, "Core" );
         if( construction_flags & DTS_CORE_SUBSTREAM_XCH_FLAG )
-            lsmash_ifprintf( fp, indent + 2, "XCH\n" );
+            isom_iprint_label( printer, indent + 2, "XCH" );
         if( construction_flags & DTS_CORE_SUBSTREAM_X96_FLAG )
-            lsmash_ifprintf( fp, indent + 2, "X96\n" );
+            isom_iprint_label( printer, indent + 2, "X96" );
         if( construction_flags & DTS_CORE_SUBSTREAM_XXCH_FLAG )
-            lsmash_ifprintf( fp, indent + 2, "XXCH\n" );
+            isom_iprint_label( printer, indent + 2, "XXCH" );
     }
     if( construction_flags & (DTS_EXT_SUBSTREAM_CORE_FLAG | DTS_EXT_SUBSTREAM_XXCH_FLAG | DTS_EXT_SUBSTREAM_X96_FLAG
                             | DTS_EXT_SUBSTREAM_XBR_FLAG | DTS_EXT_SUBSTREAM_XLL_FLAG | DTS_EXT_SUBSTREAM_LBR_FLAG) )
     {
-        lsmash_ifprintf( fp, indent + 1, "Extension substream\n" );
+        isom_iprint_label( printer, indent + 1, "Extension substream" );
         if( construction_flags & DTS_EXT_SUBSTREAM_CORE_FLAG )
-            lsmash_ifprintf( fp, indent + 2, "Core\n" );
+            isom_iprint_label( printer, indent + 2, "Core" );
         if( construction_flags & DTS_EXT_SUBSTREAM_XXCH_FLAG )
-            lsmash_ifprintf( fp, indent + 2, "XXCH\n" );
+            isom_iprint_label( printer, indent + 2, "XXCH" );
         if( construction_flags & DTS_EXT_SUBSTREAM_X96_FLAG )
-            lsmash_ifprintf( fp, indent + 2, "X96\n" );
+            isom_iprint_label( printer, indent + 2, "X96" );
         if( construction_flags & DTS_EXT_SUBSTREAM_XBR_FLAG )
-            lsmash_ifprintf( fp, indent + 2, "XBR\n" );
+            isom_iprint_label( printer, indent + 2, "XBR" );
         if( construction_flags & DTS_EXT_SUBSTREAM_XLL_FLAG )
-            lsmash_ifprintf( fp, indent + 2, "XLL\n" );
+            isom_iprint_label( printer, indent + 2, "XLL" );
         if( construction_flags & DTS_EXT_SUBSTREAM_LBR_FLAG )
-            lsmash_ifprintf( fp, indent + 2, "LBR\n" );
+            isom_iprint_label( printer, indent + 2, "LBR" );
     }
-    lsmash_ifprintf( fp, indent, "CoreLFEPresent = %s\n", CoreLFEPresent ? "1 (LFE exists)" : "0 (no LFE)" );
-    if( core_layout_description[CoreLayout] )
-        lsmash_ifprintf( fp, indent, "CoreLayout = %"PRIu8" (%s)\n", CoreLayout, core_layout_description[CoreLayout] );
-    else
-        lsmash_ifprintf( fp, indent, "CoreLayout = %"PRIu8" (Undefined)\n", CoreLayout );
-    if( CoreSize )
-        lsmash_ifprintf( fp, indent, "CoreSize = %"PRIu16"\n", CoreSize );
-    else
-        lsmash_ifprintf( fp, indent, "CoreSize = 0 (no core substream exists)\n" );
-    lsmash_ifprintf( fp, indent, "StereoDownmix = %s\n", StereoDownmix ? "1 (embedded downmix present)" : "0 (no embedded downmix)" );
-    lsmash_ifprintf( fp, indent, "RepresentationType = %"PRIu8" (%s)\n", RepresentationType, representation_type_description[RepresentationType] );
-    lsmash_ifprintf( fp, indent, "ChannelLayout = 0x%04"PRIx16"\n", ChannelLayout );
+    isom_iprint_uint( printer, indent, "CoreLFEPresent", CoreLFEPresent );
+    isom_iprint_note( printer, CoreLFEPresent ? "LFE exists" : "no LFE" );
+    isom_iprint_uint( printer, indent, "CoreLayout", CoreLayout );
+    isom_iprint_note( printer, "%s", core_layout_description[CoreLayout] ? core_layout_description[CoreLayout] : "Undefined" );
+    isom_iprint_uint( printer, indent, "CoreSize", CoreSize );
+    if( !CoreSize )
+        isom_iprint_note( printer, "no core substream exists" );
+    isom_iprint_uint( printer, indent, "StereoDownmix", StereoDownmix );
+    isom_iprint_note( printer, StereoDownmix ? "embedded downmix present" : "no embedded downmix" );
+    isom_iprint_uint( printer, indent, "RepresentationType", RepresentationType );
+    isom_iprint_note( printer, "%s", representation_type_description[RepresentationType] );
+    isom_iprint_hex( printer, indent, "ChannelLayout", ChannelLayout, 4 );
     if( ChannelLayout )
         for( int i = 0; i < 16; i++ )
             if( (ChannelLayout >> i) & 0x01 )
-                lsmash_ifprintf( fp, indent + 1, "%s\n", channel_layout_description[i] );
-    lsmash_ifprintf( fp, indent, "MultiAssetFlag = %s\n", MultiAssetFlag ? "1 (multiple asset)" : "0 (single asset)" );
+                isom_iprint_label( printer, indent + 1, channel_layout_description[i] );
+    isom_iprint_uint( printer, indent, "MultiAssetFlag", MultiAssetFlag );
+    isom_iprint_note( printer, MultiAssetFlag ? "multiple asset" : "single asset" );
+    isom_iprint_uint( printer, indent, "LBRDurationMod", LBRDurationMod );
     if( LBRDurationMod )
-        lsmash_ifprintf( fp, indent, "LBRDurationMod = 1 (%"PRIu32" -> %"PRIu32" samples)\n", frame_duration, (frame_duration * 3) / 2 );
+        isom_iprint_note( printer, "%"PRIu32" -> %"PRIu32" samples", frame_duration, (frame_duration * 3) / 2 );
     else
-        lsmash_ifprintf( fp, indent, "LBRDurationMod = 0 (no LBR duration modifier)\n" );
-    lsmash_ifprintf( fp, indent, "ReservedBoxPresent = %s\n", ReservedBoxPresent ? "1 (ReservedBox present)" : "0 (no ReservedBox)" );
-    lsmash_ifprintf( fp, indent, "Reserved = 0x%02"PRIx8"\n", Reserved );
+        isom_iprint_note( printer, "no LBR duration modifier" );
+    isom_iprint_uint( printer, indent, "ReservedBoxPresent", ReservedBoxPresent );
+    isom_iprint_note( printer, ReservedBoxPresent ? "ReservedBox present" : "no ReservedBox" );
+    isom_iprint_hex( printer, indent, "Reserved", Reserved, 2 );
     return 0;
 }
 
@@ -27,6 +27,7 @@
 #include <inttypes.h>
 
 #include "core/box.h"
+#include "core/print.h"
 
 /***************************************************************************
     ITU-T Recommendation H.264 (04/13)
@@ -2458,17 +2459,17 @@ fail:
 
 int h264_print_codec_specific
 (
-    FILE          *fp,
-    lsmash_file_t *file,
-    isom_box_t    *box,
-    int            level
+    isom_printer_t *printer,
+    lsmash_file_t  *file,
+    isom_box_t     *box,
+    int             level
 )
 {
     assert( box->manager & LSMASH_BINARY_CODED_BOX );
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: AVC Configuration Box]\n", isom_4cc2str( box->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+    isom_iprint_box( printer, indent++, isom_4cc2str( box->type.fourcc ), "AVC Configuration Box" );
+    isom_iprint_uint( printer, indent, "position", box->pos );
+    isom_iprint_uint( printer, indent, "size", box->size );
     uint8_t     *data   = box->binary;
     uint32_t     offset = isom_skip_box_common( &data );
     lsmash_bs_t *bs     = lsmash_bs_create();
@@ -2480,25 +2481,25 @@ int h264_print_codec_specific
         lsmash_bs_cleanup( bs );
         return err;
     }
-    lsmash_ifprintf( fp, indent, "configurationVersion = %"PRIu8"\n", lsmash_bs_get_byte( bs ) );
+    isom_iprint_uint( printer, indent, "configurationVersion", lsmash_bs_get_byte( bs ) );
     uint8_t AVCProfileIndication = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "AVCProfileIndication = %"PRIu8"\n", AVCProfileIndication );
-    lsmash_ifprintf( fp, indent, "profile_compatibility = 0x%02"PRIx8"\n", lsmash_bs_get_byte( bs ) );
-    lsmash_ifprintf( fp, indent, "AVCLevelIndication = %"PRIu8"\n", lsmash_bs_get_byte( bs ) );
+    isom_iprint_uint( printer, indent, "AVCProfileIndication", AVCProfileIndication );
+    isom_iprint_hex( printer, indent, "profile_compatibility", lsmash_bs_get_byte( bs ), 2 );
+    isom_iprint_uint( printer, indent, "AVCLevelIndication", lsmash_bs_get_byte( bs ) );
     uint8_t temp8 = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n", (temp8 >> 2) & 0x3F );
-    lsmash_ifprintf( fp, indent, "lengthSizeMinusOne = %"PRIu8"\n", temp8 & 0x03 );
+    isom_iprint_hex( printer, indent, "reserved", (temp8 >> 2) & 0x3F, 2 );
+    isom_iprint_uint( printer, indent, "lengthSizeMinusOne", temp8 & 0x03 );
     temp8 = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n", (temp8 >> 5) & 0x07 );
+    isom_iprint_hex( printer, indent, "reserved", (temp8 >> 5) & 0x07, 2 );
     uint8_t numOfSequenceParameterSets = temp8 & 0x1f;
-    lsmash_ifprintf( fp, indent, "numOfSequenceParameterSets = %"PRIu8"\n", numOfSequenceParameterSets );
+    isom_iprint_uint( printer, indent, "numOfSequenceParameterSets", numOfSequenceParameterSets );
     for( uint8_t i = 0; i < numOfSequenceParameterSets; i++ )
     {
         uint16_t nalUnitLength = lsmash_bs_get_be16( bs );
         lsmash_bs_skip_bytes( bs, nalUnitLength );
     }
     uint8_t numOfPictureParameterSets = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "numOfPictureParameterSets = %"PRIu8"\n", numOfPictureParameterSets );
+    isom_iprint_uint( printer, indent, "numOfPictureParameterSets", numOfPictureParameterSets );
     for( uint8_t i = 0; i < numOfPictureParameterSets; i++ )
     {
         uint16_t nalUnitLength = lsmash_bs_get_be16( bs );
@@ -2509,15 +2510,15 @@ int h264_print_codec_specific
      && (lsmash_bs_get_pos( bs ) < (box->size - offset)) )
     {
         temp8 = lsmash_bs_get_byte( bs );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n", (temp8 >> 2) & 0x3F );
-        lsmash_ifprintf( fp, indent, "chroma_format = %"PRIu8"\n", temp8 & 0x03 );
+        isom_iprint_hex( printer, indent, "reserved", (temp8 >> 2) & 0x3F, 2 );
+        isom_iprint_uint( printer, indent, "chroma_format", temp8 & 0x03 );
         temp8 = lsmash_bs_get_byte( bs );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n", (temp8 >> 3) & 0x1F );
-        lsmash_ifprintf( fp, indent, "bit_depth_luma_minus8 = %"PRIu8"\n", temp8 & 0x7 );
+        isom_iprint_hex( printer, indent, "reserved", (temp8 >> 3) & 0x1F, 2 );
+        isom_iprint_uint( printer, indent, "bit_depth_luma_minus8", temp8 & 0x7 );
         temp8 = lsmash_bs_get_byte( bs );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n", (temp8 >> 3) & 0x1F );
-        lsmash_ifprintf( fp, indent, "bit_depth_chroma_minus8 = %"PRIu8"\n", temp8 & 0x7 );
-        lsmash_ifprintf( fp, indent, "numOfSequenceParameterSetExt = %"PRIu8"\n", lsmash_bs_get_byte( bs ) );
+        isom_iprint_hex( printer, indent, "reserved", (temp8 >> 3) & 0x1F, 2 );
+        isom_iprint_uint( printer, indent, "bit_depth_chroma_minus8", temp8 & 0x7 );
+        isom_iprint_uint( printer, indent, "numOfSequenceParameterSetExt", lsmash_bs_get_byte( bs ) );
     }
     lsmash_bs_cleanup( bs );
     return 0;
@@ -2569,20 +2570,20 @@ int h264_copy_codec_specific
 
 int h264_print_bitrate
 (
-    FILE          *fp,
-    lsmash_file_t *file,
-    isom_box_t    *box,
-    int            level
+    isom_printer_t *printer,
+    lsmash_file_t  *file,
+    isom_box_t     *box,
+    int             level
 )
 {
-    assert( fp && LSMASH_IS_EXISTING_BOX( file ) && LSMASH_IS_EXISTING_BOX( box ) );
+    assert( printer && LSMASH_IS_EXISTING_BOX( file ) && LSMASH_IS_EXISTING_BOX( box ) );
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: MPEG-4 Bit Rate Box]\n", isom_4cc2str( box->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+    isom_iprint_box( printer, indent++, isom_4cc2str( box->type.fourcc ), "MPEG-4 Bit Rate Box" );
+    isom_iprint_uint( printer, indent, "position", box->pos );
+    isom_iprint_uint( printer, indent, "size", box->size );
     isom_btrt_t *btrt = (isom_btrt_t *)box;
-    lsmash_ifprintf( fp, indent, "bufferSizeDB = %"PRIu32"\n", btrt->bufferSizeDB );
-    lsmash_ifprintf( fp, indent, "maxBitrate = %"PRIu32"\n", btrt->maxBitrate );
-    lsmash_ifprintf( fp, indent, "avgBitrate = %"PRIu32"\n", btrt->avgBitrate );
+    isom_iprint_uint( printer, indent, "bufferSizeDB", btrt->bufferSizeDB );
+    isom_iprint_uint( printer, indent, "maxBitrate", btrt->maxBitrate );
+    isom_iprint_uint( printer, indent, "avgBitrate", btrt->avgBitrate );
     return 0;
 }
@@ -27,6 +27,7 @@
 #include <inttypes.h>
 
 #include "core/box.h"
+#include "core/print.h"
 
 /***************************************************************************
     ITU-T Recommendation H.265 (04/13)
@@ -2995,17 +2996,17 @@ fail:
 
 int hevc_print_codec_specific
 (
-    FILE          *fp,
-    lsmash_file_t *file,
-    isom_box_t    *box,
-    int            level
+    isom_printer_t *printer,
+    lsmash_file_t  *file,
+    isom_box_t     *box,
+    int             level
 )
 {
     assert( box->manager & LSMASH_BINARY_CODED_BOX );
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: HEVC Configuration Box]\n", isom_4cc2str( box->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+    isom_iprint_box( printer, indent++, isom_4cc2str( box->type.fourcc ), "HEVC Configuration Box" );
+    isom_iprint_uint( printer, indent, "position", box->pos );
+    isom_iprint_uint( printer, indent, "size", box->size );
     uint8_t     *data   = box->binary;
     uint32_t     offset = isom_skip_box_common( &data );
     lsmash_bs_t *bs     = lsmash_bs_create();
@@ -3018,25 +3019,26 @@ int hevc_print_codec_specific
         return err;
     }
     uint8_t configurationVersion = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "configurationVersion = %"PRIu8"\n",                     configurationVersion );
+    isom_iprint_uint( printer, indent, "configurationVersion", configurationVersion );
     if( configurationVersion != HVCC_CONFIGURATION_VERSION )
     {
         lsmash_bs_cleanup( bs );
         return 0;
     }
     uint8_t temp8 = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "general_profile_space = %"PRIu8"\n",                    (temp8 >> 6) & 0x03 );
-    lsmash_ifprintf( fp, indent, "general_tier_flag = %"PRIu8"\n",                        (temp8 >> 5) & 0x01 );
-    lsmash_ifprintf( fp, indent, "general_profile_idc = %"PRIu8"\n",                       temp8       & 0x1F );
-    lsmash_ifprintf( fp, indent, "general_profile_compatibility_flags = 0x%08"PRIx32"\n", lsmash_bs_get_be32( bs ) );
+    isom_iprint_uint( printer, indent, "general_profile_space", (temp8 >> 6) & 0x03 );
+    isom_iprint_uint( printer, indent, "general_tier_flag", (temp8 >> 5) & 0x01 );
+    isom_iprint_uint( printer, indent, "general_profile_idc", temp8       & 0x1F );
+    isom_iprint_hex( printer, indent, "general_profile_compatibility_flags", lsmash_bs_get_be32( bs ), 8 );
     uint32_t temp32 = lsmash_bs_get_be32( bs );
     uint16_t temp16 = lsmash_bs_get_be16( bs );
-    lsmash_ifprintf( fp, indent, "general_constraint_indicator_flags = 0x%012"PRIx64"\n", ((uint64_t)temp32 << 16) | temp16 );
+    isom_iprint_hex( printer, indent, "general_constraint_indicator_flags", ((uint64_t)temp32 << 16) | temp16, 12 );
     uint8_t general_level_idc = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "general_level_idc = %"PRIu8" (Level %g)\n",             general_level_idc, general_level_idc / 30.0 );
+    isom_iprint_uint( printer, indent, "general_level_idc", general_level_idc );
+    isom_iprint_note( printer, "Level %g", general_level_idc / 30.0 );
     temp16 = lsmash_bs_get_be16( bs );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n",                             (temp16 >> 12) & 0x0F );
-    lsmash_ifprintf( fp, indent, "min_spatial_segmentation_idc = %"PRIu16"\n",             temp16        & 0x0FFF );
+    isom_iprint_hex( printer, indent, "reserved", (temp16 >> 12) & 0x0F, 2 );
+    isom_iprint_uint( printer, indent, "min_spatial_segmentation_idc", temp16        & 0x0FFF );
     temp8 = lsmash_bs_get_byte( bs );
     uint8_t parallelismType = temp8 & 0x03;
     static const char *parallelism_table[4] =
@@ -3046,42 +3048,42 @@ int hevc_print_codec_specific
             "Tile based",
             "Entropy coding synchronization based / WPP: Wavefront Parallel Processing"
         };
-    lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n",                             (temp8 >> 2) & 0x3F );
-    lsmash_ifprintf( fp, indent, "parallelismType = %"PRIu8" (%s)\n",                     parallelismType,
-                                                                                          parallelism_table[parallelismType] );
+    isom_iprint_hex( printer, indent, "reserved", (temp8 >> 2) & 0x3F, 2 );
+    isom_iprint_uint( printer, indent, "parallelismType", parallelismType );
+    isom_iprint_note( printer, "%s", parallelism_table[parallelismType] );
     temp8 = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n",                             (temp8 >> 2) & 0x3F );
-    lsmash_ifprintf( fp, indent, "chromaFormat = %"PRIu8"\n",                              temp8       & 0x03 );
+    isom_iprint_hex( printer, indent, "reserved", (temp8 >> 2) & 0x3F, 2 );
+    isom_iprint_uint( printer, indent, "chromaFormat", temp8       & 0x03 );
     temp8 = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n",                             (temp8 >> 3) & 0x1F );
-    lsmash_ifprintf( fp, indent, "bitDepthLumaMinus8 = %"PRIu8"\n",                        temp8       & 0x07 );
+    isom_iprint_hex( printer, indent, "reserved", (temp8 >> 3) & 0x1F, 2 );
+    isom_iprint_uint( printer, indent, "bitDepthLumaMinus8", temp8       & 0x07 );
     temp8 = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n",                             (temp8 >> 3) & 0x1F );
-    lsmash_ifprintf( fp, indent, "bitDepthChromaMinus8 = %"PRIu8"\n",                      temp8       & 0x07 );
-    lsmash_ifprintf( fp, indent, "avgFrameRate = %"PRIu16"\n",                            lsmash_bs_get_be16( bs ) );
+    isom_iprint_hex( printer, indent, "reserved", (temp8 >> 3) & 0x1F, 2 );
+    isom_iprint_uint( printer, indent, "bitDepthChromaMinus8", temp8       & 0x07 );
+    isom_iprint_uint( printer, indent, "avgFrameRate", lsmash_bs_get_be16( bs ) );
     temp8 = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "constantFrameRate = %"PRIu8"\n",                        (temp8 >> 6) & 0x03 );
-    lsmash_ifprintf( fp, indent, "numTemporalLayers = %"PRIu8"\n",                        (temp8 >> 3) & 0x07 );
-    lsmash_ifprintf( fp, indent, "temporalIdNested = %"PRIu8"\n",                         (temp8 >> 2) & 0x01 );
-    lsmash_ifprintf( fp, indent, "lengthSizeMinusOne = %"PRIu8"\n",                        temp8       & 0x03 );
+    isom_iprint_uint( printer, indent, "constantFrameRate", (temp8 >> 6) & 0x03 );
+    isom_iprint_uint( printer, indent, "numTemporalLayers", (temp8 >> 3) & 0x07 );
+    isom_iprint_uint( printer, indent, "temporalIdNested", (temp8 >> 2) & 0x01 );
+    isom_iprint_uint( printer, indent, "lengthSizeMinusOne", temp8       & 0x03 );
     uint8_t numOfArrays = lsmash_bs_get_byte( bs );
-    lsmash_ifprintf( fp, indent, "numOfArrays = %"PRIu8"\n", numOfArrays );
+    isom_iprint_uint( printer, indent, "numOfArrays", numOfArrays );
     for( uint8_t i = 0; i < numOfArrays; i++ )
     {
         int array_indent = indent + 1;
-        lsmash_ifprintf( fp, array_indent++, "array[%"PRIu8"]\n", i );
+        isom_iprint_element( printer, array_indent++, "array", i );
         temp8 = lsmash_bs_get_byte( bs );
-        lsmash_ifprintf( fp, array_indent, "array_completeness = %"PRIu8"\n", (temp8 >> 7) & 0x01 );
-        lsmash_ifprintf( fp, array_indent, "reserved = %"PRIu8"\n",           (temp8 >> 6) & 0x01 );
-        lsmash_ifprintf( fp, array_indent, "NAL_unit_type = %"PRIu8"\n",       temp8       & 0x3F );
+        isom_iprint_uint( printer, array_indent, "array_completeness", (temp8 >> 7) & 0x01 );
+        isom_iprint_uint( printer, array_indent, "reserved", (temp8 >> 6) & 0x01 );
+        isom_iprint_uint( printer, array_indent, "NAL_unit_type", temp8       & 0x3F );
         uint16_t numNalus = lsmash_bs_get_be16( bs );
-        lsmash_ifprintf( fp, array_indent, "numNalus = %"PRIu16"\n", numNalus );
+        isom_iprint_uint( printer, array_indent, "numNalus", numNalus );
         for( uint16_t j = 0; j < numNalus; j++ )
         {
             uint16_t nalUnitLength = lsmash_bs_get_be16( bs );
             lsmash_bs_skip_bytes( bs, nalUnitLength );
-            lsmash_ifprintf( fp, array_indent, "nalUnit[%"PRIu16"]\n", j );
-            lsmash_ifprintf( fp, array_indent + 1, "nalUnitLength = %"PRIu16"\n", nalUnitLength );
+            isom_iprint_element( printer, array_indent, "nalUnit", j );
+            isom_iprint_uint( printer, array_indent + 1, "nalUnitLength", nalUnitLength );
         }
     }
     lsmash_bs_cleanup( bs );
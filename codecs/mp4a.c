@@ -24,6 +24,7 @@
 
 #define MP4A_INTERNAL
 #include "core/box.h"
+#include "core/print.h"
 
 #include "mp4a.h"
 #include "mp4sys.h"
@@ -771,74 +772,76 @@ uint8_t *mp4a_export_AudioSpecificConfig( lsmash_mp4a_AudioObjectType aot,
     return data;
 }
 
-static void mp4a_print_GASpecificConfig( FILE *fp, mp4a_AudioSpecificConfig_t *asc, int indent )
+static void mp4a_print_GASpecificConfig( isom_printer_t *printer, mp4a_AudioSpecificConfig_t *asc, int indent )
 {
     mp4a_GASpecificConfig_t *gasc = (mp4a_GASpecificConfig_t *)asc->deepAudioSpecificConfig;
-    lsmash_ifprintf( fp, indent++, "[GASpecificConfig]\n" );
-    lsmash_ifprintf( fp, indent, "frameLengthFlag = %"PRIu8"\n", gasc->frameLengthFlag );
-    lsmash_ifprintf( fp, indent, "dependsOnCoreCoder = %"PRIu8"\n", gasc->dependsOnCoreCoder );
+    isom_iprint_box( printer, indent++, NULL, "GASpecificConfig" );
+    isom_iprint_uint( printer, indent, "frameLengthFlag", gasc->frameLengthFlag );
+    isom_iprint_uint( printer, indent, "dependsOnCoreCoder", gasc->dependsOnCoreCoder );
     if( gasc->dependsOnCoreCoder )
-        lsmash_ifprintf( fp, indent, "coreCoderDelay = %"PRIu16"\n", gasc->coreCoderDelay );
-    lsmash_ifprintf( fp, indent, "extensionFlag = %"PRIu8"\n", gasc->extensionFlag );
+        isom_iprint_uint( printer, indent, "coreCoderDelay", gasc->coreCoderDelay );
+    isom_iprint_uint( printer, indent, "extensionFlag", gasc->extensionFlag );
     if( !asc->channelConfiguration )
-        lsmash_ifprintf( fp, indent, "program_config_element()\n" );
+        isom_iprint_label( printer, indent, "program_config_element()" );
 }
 
-static void mp4a_print_MPEG_1_2_SpecificConfig( FILE *fp, mp4a_AudioSpecificConfig_t *asc, int indent )
+static void mp4a_print_MPEG_1_2_SpecificConfig( isom_printer_t *printer, mp4a_AudioSpecificConfig_t *asc, int indent )
 {
     mp4a_MPEG_1_2_SpecificConfig_t *mpeg_1_2_sc = (mp4a_MPEG_1_2_SpecificConfig_t *)asc->deepAudioSpecificConfig;
-    lsmash_ifprintf( fp, indent++, "[MPEG_1_2_SpecificConfig]\n" );
-    lsmash_ifprintf( fp, indent, "extension = %"PRIu8"\n", mpeg_1_2_sc->extension );
+    isom_iprint_box( printer, indent++, NULL, "MPEG_1_2_SpecificConfig" );
+    isom_iprint_uint( printer, indent, "extension", mpeg_1_2_sc->extension );
 }
 
-static void mp4a_print_ALSSpecificConfig( FILE *fp, mp4a_AudioSpecificConfig_t *asc, int indent )
+static void mp4a_print_ALSSpecificConfig( isom_printer_t *printer, mp4a_AudioSpecificConfig_t *asc, int indent )
 {
     mp4a_ALSSpecificConfig_t *alssc = (mp4a_ALSSpecificConfig_t *)asc->deepAudioSpecificConfig;
     const char *file_type [4] = { "raw", "wave", "aiff", "bwf" };
     const char *floating  [2] = { "integer", "IEEE 32-bit floating-point" };
     const char *endian    [2] = { "little", "big" };
     const char *ra_flag   [4] = { "not stored", "stored at the beginning of frame_data()", "stored at the end of ALSSpecificConfig", "?" };
-    lsmash_ifprintf( fp, indent++, "[ALSSpecificConfig]\n" );
-    lsmash_ifprintf( fp, indent, "als_id = 0x%"PRIx32"\n", alssc->als_id );
-    lsmash_ifprintf( fp, indent, "samp_freq = %"PRIu32" Hz\n", alssc->samp_freq );
-    lsmash_ifprintf( fp, indent, "samples = %"PRIu32"\n", alssc->samples );
-    lsmash_ifprintf( fp, indent, "channels = %"PRIu16"\n", alssc->channels );
+    isom_iprint_box( printer, indent++, NULL, "ALSSpecificConfig" );
+    isom_iprint_hex( printer, indent, "als_id", alssc->als_id, 0 );
+    isom_iprint_uint( printer, indent, "samp_freq", alssc->samp_freq );
+    isom_iprint_unit( printer, "Hz" );
+    isom_iprint_uint( printer, indent, "samples", alssc->samples );
+    isom_iprint_uint( printer, indent, "channels", alssc->channels );
+    isom_iprint_uint( printer, indent, "file_type", alssc->file_type );
     if( alssc->file_type <= 3 )
-        lsmash_ifprintf( fp, indent, "file_type = %"PRIu8" (%s file)\n", alssc->file_type, file_type[ alssc->file_type ] );
-    else
-        lsmash_ifprintf( fp, indent, "file_type = %"PRIu8"\n", alssc->file_type );
+        isom_iprint_note( printer, "%s file", file_type[ alssc->file_type ] );
+    isom_iprint_uint( printer, indent, "resolution", alssc->resolution );
     if( alssc->resolution <= 3 )
-        lsmash_ifprintf( fp, indent, "resolution = %"PRIu8" (%d-bit)\n", alssc->resolution, 8 * (1 + alssc->resolution) );
-    else
-        lsmash_ifprintf( fp, indent, "resolution = %"PRIu8"\n", alssc->resolution );
-    lsmash_ifprintf( fp, indent, "floating = %"PRIu8" (%s)\n", alssc->floating, floating[ alssc->floating ] );
+        isom_iprint_note( printer, "%d-bit", 8 * (1 + alssc->resolution) );
+    isom_iprint_uint( printer, indent, "floating", alssc->floating );
+    isom_iprint_note( printer, "%s", floating[ alssc->floating ] );
+    isom_iprint_uint( printer, indent, "msb_first", alssc->msb_first );
     if( alssc->resolution )
-        lsmash_ifprintf( fp, indent, "msb_first = %"PRIu8" (%s-endian)\n", alssc->msb_first, endian[ alssc->msb_first ] );
+        isom_iprint_note( printer, "%s-endian", endian[ alssc->msb_first ] );
     else
-        lsmash_ifprintf( fp, indent, "msb_first = %"PRIu8" (%ssigned data)\n", alssc->msb_first, ((const char *[2]){ "un", "" })[ alssc->msb_first ] );
-    lsmash_ifprintf( fp, indent, "frame_length = %"PRIu16"\n", alssc->frame_length );
-    lsmash_ifprintf( fp, indent, "random_access = %"PRIu8"\n", alssc->random_access );
-    lsmash_ifprintf( fp, indent, "ra_flag = %"PRIu8" (ra_unit_size is %s)\n", alssc->ra_flag, ra_flag[ alssc->ra_flag ] );
-    lsmash_ifprintf( fp, indent, "adapt_order = %"PRIu8"\n", alssc->adapt_order );
-    lsmash_ifprintf( fp, indent, "coef_table = %"PRIu8"\n", alssc->coef_table );
-    lsmash_ifprintf( fp, indent, "long_term_prediction = %"PRIu8"\n", alssc->long_term_prediction );
-    lsmash_ifprintf( fp, indent, "max_order = %"PRIu8"\n", alssc->max_order );
-    lsmash_ifprintf( fp, indent, "block_switching = %"PRIu8"\n", alssc->block_switching );
-    lsmash_ifprintf( fp, indent, "bgmc_mode = %"PRIu8"\n", alssc->bgmc_mode );
-    lsmash_ifprintf( fp, indent, "sb_part = %"PRIu8"\n", alssc->sb_part );
-    lsmash_ifprintf( fp, indent, "joint_stereo = %"PRIu8"\n", alssc->joint_stereo );
-    lsmash_ifprintf( fp, indent, "mc_coding = %"PRIu8"\n", alssc->mc_coding );
-    lsmash_ifprintf( fp, indent, "chan_config = %"PRIu8"\n", alssc->chan_config );
-    lsmash_ifprintf( fp, indent, "chan_sort = %"PRIu8"\n", alssc->chan_sort );
-    lsmash_ifprintf( fp, indent, "crc_enabled = %"PRIu8"\n", alssc->crc_enabled );
-    lsmash_ifprintf( fp, indent, "RLSLMS = %"PRIu8"\n", alssc->RLSLMS );
-    lsmash_ifprintf( fp, indent, "reserved = %"PRIu8"\n", alssc->reserved );
-    lsmash_ifprintf( fp, indent, "aux_data_enabled = %"PRIu8"\n", alssc->aux_data_enabled );
+        isom_iprint_note( printer, "%ssigned data", ((const char *[2]){ "un", "" })[ alssc->msb_first ] );
+    isom_iprint_uint( printer, indent, "frame_length", alssc->frame_length );
+    isom_iprint_uint( printer, indent, "random_access", alssc->random_access );
+    isom_iprint_uint( printer, indent, "ra_flag", alssc->ra_flag );
+    isom_iprint_note( printer, "ra_unit_size is %s", ra_flag[ alssc->ra_flag ] );
+    isom_iprint_uint( printer, indent, "adapt_order", alssc->adapt_order );
+    isom_iprint_uint( printer, indent, "coef_table", alssc->coef_table );
+    isom_iprint_uint( printer, indent, "long_term_prediction", alssc->long_term_prediction );
+    isom_iprint_uint( printer, indent, "max_order", alssc->max_order );
+    isom_iprint_uint( printer, indent, "block_switching", alssc->block_switching );
+    isom_iprint_uint( printer, indent, "bgmc_mode", alssc->bgmc_mode );
+    isom_iprint_uint( printer, indent, "sb_part", alssc->sb_part );
+    isom_iprint_uint( printer, indent, "joint_stereo", alssc->joint_stereo );
+    isom_iprint_uint( printer, indent, "mc_coding", alssc->mc_coding );
+    isom_iprint_uint( printer, indent, "chan_config", alssc->chan_config );
+    isom_iprint_uint( printer, indent, "chan_sort", alssc->chan_sort );
+    isom_iprint_uint( printer, indent, "crc_enabled", alssc->crc_enabled );
+    isom_iprint_uint( printer, indent, "RLSLMS", alssc->RLSLMS );
+    isom_iprint_uint( printer, indent, "reserved", alssc->reserved );
+    isom_iprint_uint( printer, indent, "aux_data_enabled", alssc->aux_data_enabled );
 }
 
-void mp4a_print_AudioSpecificConfig( FILE *fp, uint8_t *dsi_payload, uint32_t dsi_payload_length, int indent )
+void mp4a_print_AudioSpecificConfig( isom_printer_t *printer, uint8_t *dsi_payload, uint32_t dsi_payload_length, int indent )
 {
-    assert( fp && dsi_payload && dsi_payload_length );
+    assert( printer && dsi_payload && dsi_payload_length );
     mp4a_AudioSpecificConfig_t *asc = mp4a_get_AudioSpecificConfig( dsi_payload, dsi_payload_length );
     if( !asc )
         return;
@@ -891,22 +894,21 @@ void mp4a_print_AudioSpecificConfig( FILE *fp, uint8_t *dsi_payload, uint32_t ds
             "LD MPEG Surround",
             "SAOC-DE"
         };
-    lsmash_ifprintf( fp, indent++, "[AudioSpecificConfig]\n" );
+    isom_iprint_box( printer, indent++, NULL, "AudioSpecificConfig" );
+    isom_iprint_int( printer, indent, "audioObjectType", asc->audioObjectType );
     if( asc->audioObjectType < sizeof(audio_object_type) / sizeof(audio_object_type[0]) )
-        lsmash_ifprintf( fp, indent, "audioObjectType = %d (%s)\n", asc->audioObjectType, audio_object_type[ asc->audioObjectType ] );
-    else
-        lsmash_ifprintf( fp, indent, "audioObjectType = %d\n", asc->audioObjectType );
-    lsmash_ifprintf( fp, indent, "samplingFrequencyIndex = %"PRIu8"\n", asc->samplingFrequencyIndex );
+        isom_iprint_note( printer, "%s", audio_object_type[ asc->audioObjectType ] );
+    isom_iprint_uint( printer, indent, "samplingFrequencyIndex", asc->samplingFrequencyIndex );
     if( asc->samplingFrequencyIndex == 0xf )
-        lsmash_ifprintf( fp, indent, "samplingFrequency = %"PRIu32"\n", asc->samplingFrequency );
-    lsmash_ifprintf( fp, indent, "channelConfiguration = %"PRIu8"\n", asc->channelConfiguration );
+        isom_iprint_uint( printer, indent, "samplingFrequency", asc->samplingFrequency );
+    isom_iprint_uint( printer, indent, "channelConfiguration", asc->channelConfiguration );
     if( asc->extensionAudioObjectType == 5 )
     {
-        lsmash_ifprintf( fp, indent, "extensionSamplingFrequencyIndex = %"PRIu8"\n", asc->extensionSamplingFrequencyIndex );
+        isom_iprint_uint( printer, indent, "extensionSamplingFrequencyIndex", asc->extensionSamplingFrequencyIndex );
         if( asc->extensionSamplingFrequencyIndex == 0xf )
-            lsmash_ifprintf( fp, indent, "extensionSamplingFrequency = %"PRIu32"\n", asc->extensionSamplingFrequency );
+            isom_iprint_uint( printer, indent, "extensionSamplingFrequency", asc->extensionSamplingFrequency );
         if( asc->audioObjectType == 22 )
-            lsmash_ifprintf( fp, indent, "extensionChannelConfiguration = %"PRIu8"\n", asc->extensionChannelConfiguration );
+            isom_iprint_uint( printer, indent, "extensionChannelConfiguration", asc->extensionChannelConfiguration );
     }
     if( asc->deepAudioSpecificConfig )
         switch( asc->audioObjectType )
@@ -923,15 +925,15 @@ void mp4a_print_AudioSpecificConfig( FILE *fp, uint8_t *dsi_payload, uint32_t ds
             case MP4A_AUDIO_OBJECT_TYPE_ER_Twin_VQ :
             case MP4A_AUDIO_OBJECT_TYPE_ER_BSAC :
             case MP4A_AUDIO_OBJECT_TYPE_ER_AAC_LD :
-                mp4a_print_GASpecificConfig( fp, asc, indent );
+                mp4a_print_GASpecificConfig( printer, asc, indent );
                 break;
             case MP4A_AUDIO_OBJECT_TYPE_Layer_1 :
             case MP4A_AUDIO_OBJECT_TYPE_Layer_2 :
             case MP4A_AUDIO_OBJECT_TYPE_Layer_3 :
-                mp4a_print_MPEG_1_2_SpecificConfig( fp, asc, indent );
+                mp4a_print_MPEG_1_2_SpecificConfig( printer, asc, indent );
                 break;
             case MP4A_AUDIO_OBJECT_TYPE_ALS :
-                mp4a_print_ALSSpecificConfig( fp, asc, indent );
+                mp4a_print_ALSSpecificConfig( printer, asc, indent );
                 break;
             default :
                 break;
@@ -28,6 +28,7 @@
 #include <inttypes.h>
 
 #include "core/box.h"
+#include "core/print.h"
 
 #include "description.h"
 #include "mp4a.h"
@@ -764,9 +765,9 @@ int mp4sys_update_DecoderConfigDescriptor( mp4sys_ES_Descriptor_t *esd, uint32_t
     return 0;
 }
 
-void mp4sys_print_descriptor( FILE *fp, mp4sys_descriptor_t *descriptor, int indent );
+void mp4sys_print_descriptor( isom_printer_t *printer, mp4sys_descriptor_t *descriptor, int indent );
 
-static void mp4sys_print_descriptor_header( FILE *fp, mp4sys_descriptor_head_t *header, int indent )
+static void mp4sys_print_descriptor_header( isom_printer_t *printer, mp4sys_descriptor_head_t *header, int indent )
 {
     static const char *descriptor_names_table[256] =
         {
@@ -782,16 +783,13 @@ static void mp4sys_print_descriptor_header( FILE *fp, mp4sys_descriptor_head_t *
             [0x10] = "MP4_IOD",
             [0x11] = "MP4_OD"
         };
-    if( descriptor_names_table[ header->tag ] )
-        lsmash_ifprintf( fp, indent, "[tag = 0x%02"PRIx8": %s]\n", header->tag, descriptor_names_table[ header->tag ] );
-    else
-        lsmash_ifprintf( fp, indent, "[tag = 0x%02"PRIx8"]\n", header->tag );
-    lsmash_ifprintf( fp, ++indent, "expandableClassSize = %"PRIu32"\n", header->size );
+    isom_iprint_tag( printer, indent, header->tag, descriptor_names_table[ header->tag ] );
+    isom_iprint_uint( printer, ++indent, "expandableClassSize", header->size );
 }
 
-static void mp4sys_print_DecoderSpecificInfo( FILE *fp, mp4sys_descriptor_t *descriptor, int indent )
+static void mp4sys_print_DecoderSpecificInfo( isom_printer_t *printer, mp4sys_descriptor_t *descriptor, int indent )
 {
-    extern void mp4a_print_AudioSpecificConfig( FILE *, uint8_t *, uint32_t, int );
+    extern void mp4a_print_AudioSpecificConfig( isom_printer_t *, uint8_t *, uint32_t, int );
     if( !descriptor->parent || descriptor->parent->header.tag != MP4SYS_DESCRIPTOR_TAG_DecoderConfigDescrTag )
         return;
     mp4sys_DecoderConfigDescriptor_t *dcd = (mp4sys_DecoderConfigDescriptor_t *)descriptor->parent;
@@ -799,10 +797,10 @@ static void mp4sys_print_DecoderSpecificInfo( FILE *fp, mp4sys_descriptor_t *des
      || dcd->objectTypeIndication != MP4SYS_OBJECT_TYPE_Audio_ISO_14496_3 )
         return; /* We support only AudioSpecificConfig here currently. */
     mp4sys_DecoderSpecificInfo_t *dsi = (mp4sys_DecoderSpecificInfo_t *)descriptor;
-    mp4a_print_AudioSpecificConfig( fp, dsi->data, dsi->header.size, indent );
+    mp4a_print_AudioSpecificConfig( printer, dsi->data, dsi->header.size, indent );
 }
 
-static void mp4sys_print_DecoderConfigDescriptor( FILE *fp, mp4sys_descriptor_t *descriptor, int indent )
+static void mp4sys_print_DecoderConfigDescriptor( isom_printer_t *printer, mp4sys_descriptor_t *descriptor, int indent )
 {
     mp4sys_DecoderConfigDescriptor_t *dcd = (mp4sys_DecoderConfigDescriptor_t *)descriptor;
     static const char *object_type_indication_descriptions_table[256] =
@@ -870,163 +868,163 @@ static void mp4sys_print_DecoderConfigDescriptor( FILE *fp, mp4sys_descriptor_t
             "FontDataStream",
             "StreamingText"
         };
+    isom_iprint_hex( printer, indent, "objectTypeIndication", dcd->objectTypeIndication, 2 );
     if( object_type_indication_descriptions_table[ dcd->objectTypeIndication ] )
-        lsmash_ifprintf( fp, indent, "objectTypeIndication = 0x%02"PRIx8" (%s)\n", dcd->objectTypeIndication, object_type_indication_descriptions_table[ dcd->objectTypeIndication ] );
-    else
-        lsmash_ifprintf( fp, indent, "objectTypeIndication = 0x%02"PRIx8"\n", dcd->objectTypeIndication );
+        isom_iprint_note( printer, "%s", object_type_indication_descriptions_table[ dcd->objectTypeIndication ] );
+    isom_iprint_hex( printer, indent, "streamType", dcd->streamType, 2 );
     if( stream_type_descriptions_table[ dcd->streamType ] )
-        lsmash_ifprintf( fp, indent, "streamType = 0x%02"PRIx8" (%s)\n", dcd->streamType, stream_type_descriptions_table[ dcd->streamType ] );
-    else
-        lsmash_ifprintf( fp, indent, "streamType = 0x%02"PRIx8"\n", dcd->streamType );
-    lsmash_ifprintf( fp, indent, "upStream = %"PRIu8"\n", dcd->upStream );
-    lsmash_ifprintf( fp, indent, "reserved = %"PRIu8"\n", dcd->reserved );
-    lsmash_ifprintf( fp, indent, "bufferSizeDB = %"PRIu32"\n", dcd->bufferSizeDB );
-    lsmash_ifprintf( fp, indent, "maxBitrate = %"PRIu32"\n", dcd->maxBitrate );
-    lsmash_ifprintf( fp, indent, "avgBitrate = %"PRIu32"%s\n", dcd->avgBitrate, dcd->avgBitrate ? "" : " (variable bitrate)" );
+        isom_iprint_note( printer, "%s", stream_type_descriptions_table[ dcd->streamType ] );
+    isom_iprint_uint( printer, indent, "upStream", dcd->upStream );
+    isom_iprint_uint( printer, indent, "reserved", dcd->reserved );
+    isom_iprint_uint( printer, indent, "bufferSizeDB", dcd->bufferSizeDB );
+    isom_iprint_uint( printer, indent, "maxBitrate", dcd->maxBitrate );
+    isom_iprint_uint( printer, indent, "avgBitrate", dcd->avgBitrate );
+    if( !dcd->avgBitrate )
+        isom_iprint_note( printer, "variable bitrate" );
 }
 
-static void mp4sys_print_SLConfigDescriptor( FILE *fp, mp4sys_descriptor_t *descriptor, int indent )
+static void mp4sys_print_SLConfigDescriptor( isom_printer_t *printer, mp4sys_descriptor_t *descriptor, int indent )
 {
     mp4sys_SLConfigDescriptor_t *slcd = (mp4sys_SLConfigDescriptor_t *)descriptor;
-    lsmash_ifprintf( fp, indent, "predefined = %"PRIu8"\n", slcd->predefined );
+    isom_iprint_uint( printer, indent, "predefined", slcd->predefined );
     if( slcd->predefined == 0 )
     {
-        lsmash_ifprintf( fp, indent, "useAccessUnitStartFlag = %"PRIu8"\n", slcd->useAccessUnitStartFlag );
-        lsmash_ifprintf( fp, indent, "useAccessUnitEndFlag = %"PRIu8"\n", slcd->useAccessUnitEndFlag );
-        lsmash_ifprintf( fp, indent, "useRandomAccessPointFlag = %"PRIu8"\n", slcd->useRandomAccessPointFlag );
-        lsmash_ifprintf( fp, indent, "hasRandomAccessUnitsOnlyFlag = %"PRIu8"\n", slcd->hasRandomAccessUnitsOnlyFlag );
-        lsmash_ifprintf( fp, indent, "usePaddingFlag = %"PRIu8"\n", slcd->usePaddingFlag );
-        lsmash_ifprintf( fp, indent, "useTimeStampsFlag = %"PRIu8"\n", slcd->useTimeStampsFlag );
-        lsmash_ifprintf( fp, indent, "useIdleFlag = %"PRIu8"\n", slcd->useIdleFlag );
-        lsmash_ifprintf( fp, indent, "durationFlag = %"PRIu8"\n", slcd->durationFlag );
-        lsmash_ifprintf( fp, indent, "timeStampResolution = %"PRIu32"\n", slcd->timeStampResolution );
-        lsmash_ifprintf( fp, indent, "OCRResolution = %"PRIu32"\n", slcd->OCRResolution );
-        lsmash_ifprintf( fp, indent, "timeStampLength = %"PRIu8"\n", slcd->timeStampLength );
-        lsmash_ifprintf( fp, indent, "OCRLength = %"PRIu8"\n", slcd->OCRLength );
-        lsmash_ifprintf( fp, indent, "AU_Length = %"PRIu8"\n", slcd->AU_Length );
-        lsmash_ifprintf( fp, indent, "instantBitrateLength = %"PRIu8"\n", slcd->instantBitrateLength );
-        lsmash_ifprintf( fp, indent, "degradationPriorityLength = %"PRIu8"\n", slcd->degradationPriorityLength );
-        lsmash_ifprintf( fp, indent, "AU_seqNumLength = %"PRIu8"\n", slcd->AU_seqNumLength );
-        lsmash_ifprintf( fp, indent, "packetSeqNumLength = %"PRIu8"\n", slcd->packetSeqNumLength );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%01"PRIx8"\n", slcd->reserved );
+        isom_iprint_uint( printer, indent, "useAccessUnitStartFlag", slcd->useAccessUnitStartFlag );
+        isom_iprint_uint( printer, indent, "useAccessUnitEndFlag", slcd->useAccessUnitEndFlag );
+        isom_iprint_uint( printer, indent, "useRandomAccessPointFlag", slcd->useRandomAccessPointFlag );
+        isom_iprint_uint( printer, indent, "hasRandomAccessUnitsOnlyFlag", slcd->hasRandomAccessUnitsOnlyFlag );
+        isom_iprint_uint( printer, indent, "usePaddingFlag", slcd->usePaddingFlag );
+        isom_iprint_uint( printer, indent, "useTimeStampsFlag", slcd->useTimeStampsFlag );
+        isom_iprint_uint( printer, indent, "useIdleFlag", slcd->useIdleFlag );
+        isom_iprint_uint( printer, indent, "durationFlag", slcd->durationFlag );
+        isom_iprint_uint( printer, indent, "timeStampResolution", slcd->timeStampResolution );
+        isom_iprint_uint( printer, indent, "OCRResolution", slcd->OCRResolution );
+        isom_iprint_uint( printer, indent, "timeStampLength", slcd->timeStampLength );
+        isom_iprint_uint( printer, indent, "OCRLength", slcd->OCRLength );
+        isom_iprint_uint( printer, indent, "AU_Length", slcd->AU_Length );
+        isom_iprint_uint( printer, indent, "instantBitrateLength", slcd->instantBitrateLength );
+        isom_iprint_uint( printer, indent, "degradationPriorityLength", slcd->degradationPriorityLength );
+        isom_iprint_uint( printer, indent, "AU_seqNumLength", slcd->AU_seqNumLength );
+        isom_iprint_uint( printer, indent, "packetSeqNumLength", slcd->packetSeqNumLength );
+        isom_iprint_hex( printer, indent, "reserved", slcd->reserved, 1 );
     }
     if( slcd->durationFlag )
     {
-        lsmash_ifprintf( fp, indent, "timeScale = %"PRIu32"\n", slcd->timeScale );
-        lsmash_ifprintf( fp, indent, "accessUnitDuration = %"PRIu16"\n", slcd->accessUnitDuration );
-        lsmash_ifprintf( fp, indent, "compositionUnitDuration = %"PRIu16"\n", slcd->compositionUnitDuration );
+        isom_iprint_uint( printer, indent, "timeScale", slcd->timeScale );
+        isom_iprint_uint( printer, indent, "accessUnitDuration", slcd->accessUnitDuration );
+        isom_iprint_uint( printer, indent, "compositionUnitDuration", slcd->compositionUnitDuration );
     }
     if( !slcd->useTimeStampsFlag )
     {
-        lsmash_ifprintf( fp, indent, "startDecodingTimeStamp = %"PRIu64"\n", slcd->startDecodingTimeStamp );
-        lsmash_ifprintf( fp, indent, "startCompositionTimeStamp = %"PRIu64"\n", slcd->startCompositionTimeStamp );
+        isom_iprint_uint( printer, indent, "startDecodingTimeStamp", slcd->startDecodingTimeStamp );
+        isom_iprint_uint( printer, indent, "startCompositionTimeStamp", slcd->startCompositionTimeStamp );
     }
 }
 
-static void mp4sys_print_ES_Descriptor( FILE *fp, mp4sys_descriptor_t *descriptor, int indent )
+static void mp4sys_print_ES_Descriptor( isom_printer_t *printer, mp4sys_descriptor_t *descriptor, int indent )
 {
     mp4sys_ES_Descriptor_t *esd = (mp4sys_ES_Descriptor_t *)descriptor;
-    lsmash_ifprintf( fp, indent, "ES_ID = %"PRIu16"\n", esd->ES_ID );
-    lsmash_ifprintf( fp, indent, "streamDependenceFlag = %"PRIu8"\n", esd->streamDependenceFlag );
-    lsmash_ifprintf( fp, indent, "URL_Flag = %"PRIu8"\n", esd->URL_Flag );
-    lsmash_ifprintf( fp, indent, "OCRstreamFlag = %"PRIu8"\n", esd->OCRstreamFlag );
-    lsmash_ifprintf( fp, indent, "streamPriority = %"PRIu8"\n", esd->streamPriority );
+    isom_iprint_uint( printer, indent, "ES_ID", esd->ES_ID );
+    isom_iprint_uint( printer, indent, "streamDependenceFlag", esd->streamDependenceFlag );
+    isom_iprint_uint( printer, indent, "URL_Flag", esd->URL_Flag );
+    isom_iprint_uint( printer, indent, "OCRstreamFlag", esd->OCRstreamFlag );
+    isom_iprint_uint( printer, indent, "streamPriority", esd->streamPriority );
     if( esd->streamDependenceFlag )
-        lsmash_ifprintf( fp, indent, "dependsOn_ES_ID = %"PRIu16"\n", esd->dependsOn_ES_ID );
+        isom_iprint_uint( printer, indent, "dependsOn_ES_ID", esd->dependsOn_ES_ID );
     if( esd->URL_Flag )
     {
-        lsmash_ifprintf( fp, indent, "URLlength = %"PRIu8"\n", esd->URLlength );
-        lsmash_ifprintf( fp, indent, "URLstring = %s\n", esd->URLstring );
+        isom_iprint_uint( printer, indent, "URLlength", esd->URLlength );
+        isom_iprint_string( printer, indent, "URLstring", esd->URLstring );
     }
     if( esd->OCRstreamFlag )
-        lsmash_ifprintf( fp, indent, "OCR_ES_Id = %"PRIu16"\n", esd->OCR_ES_Id );
+        isom_iprint_uint( printer, indent, "OCR_ES_Id", esd->OCR_ES_Id );
 }
 
-static void mp4sys_print_ES_ID_Inc( FILE *fp, mp4sys_descriptor_t *descriptor, int indent )
+static void mp4sys_print_ES_ID_Inc( isom_printer_t *printer, mp4sys_descriptor_t *descriptor, int indent )
 {
     mp4sys_ES_ID_Inc_t *es_id_inc = (mp4sys_ES_ID_Inc_t *)descriptor;
-    lsmash_ifprintf( fp, indent, "Track_ID = %"PRIu32"\n", es_id_inc->Track_ID );
+    isom_iprint_uint( printer, indent, "Track_ID", es_id_inc->Track_ID );
 }
 
-static void mp4sys_print_ObjectDescriptor( FILE *fp, mp4sys_descriptor_t *descriptor, int indent )
+static void mp4sys_print_ObjectDescriptor( isom_printer_t *printer, mp4sys_descriptor_t *descriptor, int indent )
 {
     mp4sys_ObjectDescriptor_t *od = (mp4sys_ObjectDescriptor_t *)descriptor;
-    lsmash_ifprintf( fp, indent, "ObjectDescriptorID = %"PRIu16"\n", od->ObjectDescriptorID );
-    lsmash_ifprintf( fp, indent, "URL_Flag = %"PRIu8"\n", od->URL_Flag );
+    isom_iprint_uint( printer, indent, "ObjectDescriptorID", od->ObjectDescriptorID );
+    isom_iprint_uint( printer, indent, "URL_Flag", od->URL_Flag );
     if( od->header.tag == MP4SYS_DESCRIPTOR_TAG_InitialObjectDescrTag
      || od->header.tag == MP4SYS_DESCRIPTOR_TAG_MP4_IOD_Tag )
     {
-        lsmash_ifprintf( fp, indent, "includeInlineProfileLevelFlag = %"PRIu8"\n", od->includeInlineProfileLevelFlag );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%01"PRIx8"\n", od->reserved );
+        isom_iprint_uint( printer, indent, "includeInlineProfileLevelFlag", od->includeInlineProfileLevelFlag );
+        isom_iprint_hex( printer, indent, "reserved", od->reserved, 1 );
     }
     else
-        lsmash_ifprintf( fp, indent, "reserved = 0x%02"PRIx8"\n", od->reserved | (od->includeInlineProfileLevelFlag << 4) );
+        isom_iprint_hex( printer, indent, "reserved", od->reserved | (od->includeInlineProfileLevelFlag << 4), 2 );
     if( od->URL_Flag )
     {
-        lsmash_ifprintf( fp, indent, "URLlength = %"PRIu8"\n", od->URLlength );
-        lsmash_ifprintf( fp, indent, "URLstring = %s\n", od->URLstring );
+        isom_iprint_uint( printer, indent, "URLlength", od->URLlength );
+        isom_iprint_string( printer, indent, "URLstring", od->URLstring );
     }
     else
     {
         if( od->header.tag == MP4SYS_DESCRIPTOR_TAG_InitialObjectDescrTag
          || od->header.tag == MP4SYS_DESCRIPTOR_TAG_MP4_IOD_Tag )
         {
-            lsmash_ifprintf( fp, indent, "ODProfileLevelIndication = 0x%02"PRIx8"\n",       od->ODProfileLevelIndication );
-            lsmash_ifprintf( fp, indent, "sceneProfileLevelIndication = 0x%02"PRIx8"\n",    od->sceneProfileLevelIndication );
-            lsmash_ifprintf( fp, indent, "audioProfileLevelIndication = 0x%02"PRIx8"\n",    od->audioProfileLevelIndication );
-            lsmash_ifprintf( fp, indent, "visualProfileLevelIndication = 0x%02"PRIx8"\n",   od->visualProfileLevelIndication );
-            lsmash_ifprintf( fp, indent, "graphicsProfileLevelIndication = 0x%02"PRIx8"\n", od->graphicsProfileLevelIndication );
+            isom_iprint_hex( printer, indent, "ODProfileLevelIndication", od->ODProfileLevelIndication, 2 );
+            isom_iprint_hex( printer, indent, "sceneProfileLevelIndication", od->sceneProfileLevelIndication, 2 );
+            isom_iprint_hex( printer, indent, "audioProfileLevelIndication", od->audioProfileLevelIndication, 2 );
+            isom_iprint_hex( printer, indent, "visualProfileLevelIndication", od->visualProfileLevelIndication, 2 );
+            isom_iprint_hex( printer, indent, "graphicsProfileLevelIndication", od->graphicsProfileLevelIndication, 2 );
         }
     }
 }
 
-void mp4sys_print_descriptor( FILE *fp, mp4sys_descriptor_t *descriptor, int indent )
+void mp4sys_print_descriptor( isom_printer_t *printer, mp4sys_descriptor_t *descriptor, int indent )
 {
     if( !descriptor )
         return;
-    mp4sys_print_descriptor_header( fp, &descriptor->header, indent++ );
+    mp4sys_print_descriptor_header( printer, &descriptor->header, indent++ );
     switch( descriptor->header.tag )
     {
         case MP4SYS_DESCRIPTOR_TAG_ObjectDescrTag        :
         case MP4SYS_DESCRIPTOR_TAG_InitialObjectDescrTag :
         case MP4SYS_DESCRIPTOR_TAG_MP4_OD_Tag            :
         case MP4SYS_DESCRIPTOR_TAG_MP4_IOD_Tag           :
-            mp4sys_print_ObjectDescriptor( fp, descriptor, indent );
+            mp4sys_print_ObjectDescriptor( printer, descriptor, indent );
             break;
         case MP4SYS_DESCRIPTOR_TAG_ES_DescrTag :
-            mp4sys_print_ES_Descriptor( fp, descriptor, indent );
+            mp4sys_print_ES_Descriptor( printer, descriptor, indent );
             break;
         case MP4SYS_DESCRIPTOR_TAG_DecoderConfigDescrTag :
-            mp4sys_print_DecoderConfigDescriptor( fp, descriptor, indent );
+            mp4sys_print_DecoderConfigDescriptor( printer, descriptor, indent );
             break;
         case MP4SYS_DESCRIPTOR_TAG_DecSpecificInfoTag :
-            mp4sys_print_DecoderSpecificInfo( fp, descriptor, indent );
+            mp4sys_print_DecoderSpecificInfo( printer, descriptor, indent );
             break;
         case MP4SYS_DESCRIPTOR_TAG_SLConfigDescrTag :
-            mp4sys_print_SLConfigDescriptor( fp, descriptor, indent );
+            mp4sys_print_SLConfigDescriptor( printer, descriptor, indent );
             break;
         case MP4SYS_DESCRIPTOR_TAG_ES_ID_IncTag :
-            mp4sys_print_ES_ID_Inc( fp, descriptor, indent );
+            mp4sys_print_ES_ID_Inc( printer, descriptor, indent );
             break;
         default :
             break;
     }
     for( lsmash_entry_t *entry = descriptor->children.head; entry; entry = entry->next )
         if( entry->data )
-            mp4sys_print_descriptor( fp, entry->data, indent );
+            mp4sys_print_descriptor( printer, entry->data, indent );
 }
 
-int mp4sys_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+int mp4sys_print_codec_specific( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     assert( !(box->manager & LSMASH_BINARY_CODED_BOX) );
     isom_esds_t *esds = (isom_esds_t *)box;
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: Elemental Stream Descriptor Box]\n", isom_4cc2str( esds->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", esds->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", esds->size );
-    lsmash_ifprintf( fp, indent, "version = %"PRIu8"\n", esds->version );
-    lsmash_ifprintf( fp, indent, "flags = 0x%06"PRIx32"\n", esds->flags & 0x00ffffff );
-    mp4sys_print_descriptor( fp, (mp4sys_descriptor_t *)esds->ES, indent );
+    isom_iprint_box( printer, indent++, isom_4cc2str( esds->type.fourcc ), "Elemental Stream Descriptor Box" );
+    isom_iprint_uint( printer, indent, "position", esds->pos );
+    isom_iprint_uint( printer, indent, "size", esds->size );
+    isom_iprint_uint( printer, indent, "version", esds->version );
+    isom_iprint_hex( printer, indent, "flags", esds->flags & 0x00ffffff, 6 );
+    mp4sys_print_descriptor( printer, (mp4sys_descriptor_t *)esds->ES, indent );
     return 0;
 }
 
@@ -178,7 +178,7 @@ int mp4sys_update_DecoderConfigDescriptor
 
 uint32_t mp4sys_update_descriptor_size( mp4sys_descriptor_t *descriptor );
 int mp4sys_write_descriptor( lsmash_bs_t *bs, mp4sys_descriptor_t *descriptor );
-void mp4sys_print_descriptor( FILE *fp, mp4sys_descriptor_t *descriptor, int indent );
+void mp4sys_print_descriptor( isom_printer_t *printer, mp4sys_descriptor_t *descriptor, int indent );
 mp4sys_descriptor_t *mp4sys_get_descriptor( lsmash_bs_t *bs, mp4sys_descriptor_t *parent );
 
 int mp4sys_setup_summary_from_DecoderSpecificInfo( lsmash_audio_summary_t *summary, mp4sys_ES_Descriptor_t *esd );
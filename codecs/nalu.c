@@ -233,6 +233,46 @@ uint64_t nalu_find_first_start_code
     return first_sc_head_pos;
 }
 
+/* Score the byte stream format from the beginning of the given bytes by the number of plausible NAL unit headers in a row.
+ * Return 0 if the bytes never start with the first start code in the manner of nalu_find_first_start_code(). */
+int nalu_detect_byte_stream
+(
+    const uint8_t *data,
+    uint64_t       size,
+    int            eof,
+    uint32_t       nalu_header_length,
+    int          (*nalu_header_is_plausible)( const uint8_t *nalu_header )
+)
+{
+#define NALU_DETECT_MAX_NUM_NALUS 4
+    uint64_t pos = 0;
+    while( pos < size && data[pos] == 0x00 )
+        ++pos;
+    if( pos == size )
+        return eof ? 0 : 5; /* Nothing but zero bytes so far. */
+    if( data[pos] != 0x01 || pos < NALU_LONG_START_CODE_LENGTH - 1 )
+        return 0;
+    int count = 0;
+    for( ++pos; count < NALU_DETECT_MAX_NUM_NALUS && pos + nalu_header_length <= size; count++ )
+    {
+        if( !nalu_header_is_plausible( data + pos ) )
+            break;
+        /* Find the next start code. */
+        pos += nalu_header_length;
+        while( 1 )
+        {
+            const uint8_t *next = memchr( data + pos, 0x01, size - pos );
+            if( !next )
+                return 5 + (count + 1) * 15;
+            pos = next - data + 1;
+            if( next[-1] == 0x00 && next[-2] == 0x00 )
+                break;
+        }
+    }
+    return 5 + count * 15;
+#undef NALU_DETECT_MAX_NUM_NALUS
+}
+
 uint64_t nalu_get_codeNum
 (
     lsmash_bits_t *bits
@@ -94,6 +94,15 @@ uint64_t nalu_find_first_start_code
     lsmash_bs_t *bs
 );
 
+int nalu_detect_byte_stream
+(
+    const uint8_t *data,
+    uint64_t       size,
+    int            eof,
+    uint32_t       nalu_header_length,
+    int          (*nalu_header_is_plausible)( const uint8_t *nalu_header )
+);
+
 uint64_t nalu_get_codeNum
 (
     lsmash_bits_t *bits
@@ -27,6 +27,7 @@
 #include <inttypes.h>
 
 #include "core/box.h"
+#include "core/print.h"
 
 /***************************************************************************
     SMPTE 421M-2006
@@ -915,13 +916,13 @@ int vc1_copy_codec_specific( lsmash_codec_specific_t *dst, lsmash_codec_specific
     return 0;
 }
 
-int vc1_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+int vc1_print_codec_specific( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     assert( box->manager & LSMASH_BINARY_CODED_BOX );
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: VC1 Specific Box]\n", isom_4cc2str( box->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+    isom_iprint_box( printer, indent++, isom_4cc2str( box->type.fourcc ), "VC1 Specific Box" );
+    isom_iprint_uint( printer, indent, "position", box->pos );
+    isom_iprint_uint( printer, indent, "size", box->size );
     if( box->size < ISOM_BASEBOX_COMMON_SIZE + 7 )
         return LSMASH_ERR_INVALID_DATA;
     uint8_t *data = box->binary;
@@ -929,37 +930,22 @@ int vc1_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, in
     uint8_t profile = (data[0] >> 4) & 0x0F;
     if( profile != 12 )
         return 0;   /* We don't support profile other than 12 (Advanced profile). */
-    lsmash_ifprintf( fp, indent, "profile = %"PRIu8"\n", profile );
-    lsmash_ifprintf( fp, indent, "level = %"PRIu8"\n", (data[0] >> 1) & 0x07 );
-    lsmash_ifprintf( fp, indent, "reserved = %"PRIu8"\n", data[0] & 0x01 );
-    lsmash_ifprintf( fp, indent, "level = %"PRIu8"\n", (data[1] >> 5) & 0x07 );
-    lsmash_ifprintf( fp, indent, "cbr = %"PRIu8"\n", (data[1] >> 4) & 0x01 );
-    lsmash_ifprintf( fp, indent, "reserved1 = 0x%02"PRIx8"\n", (data[1] & 0x0F) | ((data[2] >> 6) & 0x03) );
-    lsmash_ifprintf( fp, indent, "no_interlace = %"PRIu8"\n", (data[2] >> 5) & 0x01 );
-    lsmash_ifprintf( fp, indent, "no_multiple_seq = %"PRIu8"\n", (data[2] >> 4) & 0x01 );
-    lsmash_ifprintf( fp, indent, "no_multiple_entry = %"PRIu8"\n", (data[2] >> 3) & 0x01 );
-    lsmash_ifprintf( fp, indent, "no_slice_code = %"PRIu8"\n", (data[2] >> 2) & 0x01 );
-    lsmash_ifprintf( fp, indent, "no_bframe = %"PRIu8"\n", (data[2] >> 1) & 0x01 );
-    lsmash_ifprintf( fp, indent, "reserved2 = %"PRIu8"\n", data[2] & 0x01 );
+    isom_iprint_uint( printer, indent, "profile", profile );
+    isom_iprint_uint( printer, indent, "level", (data[0] >> 1) & 0x07 );
+    isom_iprint_uint( printer, indent, "reserved", data[0] & 0x01 );
+    isom_iprint_uint( printer, indent, "level", (data[1] >> 5) & 0x07 );
+    isom_iprint_uint( printer, indent, "cbr", (data[1] >> 4) & 0x01 );
+    isom_iprint_hex( printer, indent, "reserved1", (data[1] & 0x0F) | ((data[2] >> 6) & 0x03), 2 );
+    isom_iprint_uint( printer, indent, "no_interlace", (data[2] >> 5) & 0x01 );
+    isom_iprint_uint( printer, indent, "no_multiple_seq", (data[2] >> 4) & 0x01 );
+    isom_iprint_uint( printer, indent, "no_multiple_entry", (data[2] >> 3) & 0x01 );
+    isom_iprint_uint( printer, indent, "no_slice_code", (data[2] >> 2) & 0x01 );
+    isom_iprint_uint( printer, indent, "no_bframe", (data[2] >> 1) & 0x01 );
+    isom_iprint_uint( printer, indent, "reserved2", data[2] & 0x01 );
     uint32_t framerate = LSMASH_GET_BE32( &data[3] );
-    lsmash_ifprintf( fp, indent, "framerate = %"PRIu32"\n", framerate );
+    isom_iprint_uint( printer, indent, "framerate", framerate );
     uint32_t seqhdr_ephdr_size = box->size - (data - box->binary + 7);
     if( seqhdr_ephdr_size )
-    {
-        lsmash_ifprintf( fp, indent, "seqhdr_ephdr[]\n" );
-        data += 7;
-        for( uint32_t i = 0; i < seqhdr_ephdr_size; i += 8 )
-        {
-            lsmash_ifprintf( fp, indent + 1, "" );
-            for( uint32_t j = 0; ; j++ )
-                if( j == 7 || (i + j == seqhdr_ephdr_size - 1) )
-                {
-                    fprintf( fp, "0x%02"PRIx8"\n", data[i + j] );
-                    break;
-                }
-                else
-                    fprintf( fp, "0x%02"PRIx8" ", data[i + j] );
-        }
-    }
+        isom_iprint_bytes( printer, indent, "seqhdr_ephdr", data + 7, seqhdr_ephdr_size );
     return 0;
 }
@@ -25,19 +25,20 @@
 #include <inttypes.h>
 
 #include "core/box.h"
+#include "core/print.h"
 
 #define WFEX_BOX_MIN_LENGTH 26
 
 #define WAVE_FORMAT_TAG_ID_WMA_V2 0x0161
 #define WAVE_FORMAT_TAG_ID_WMA_V3 0x0162
 
-int wma_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+int wma_print_codec_specific( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     assert( box->manager & LSMASH_BINARY_CODED_BOX );
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: General Extended Waveform Format Box]\n", isom_4cc2str( box->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+    isom_iprint_box( printer, indent++, isom_4cc2str( box->type.fourcc ), "General Extended Waveform Format Box" );
+    isom_iprint_uint( printer, indent, "position", box->pos );
+    isom_iprint_uint( printer, indent, "size", box->size );
     if( box->size < WFEX_BOX_MIN_LENGTH )
         return LSMASH_ERR_INVALID_DATA;
     uint8_t *data = box->binary;
@@ -48,36 +49,35 @@ int wma_print_codec_specific( FILE *fp, lsmash_file_t *file, isom_box_t *box, in
         "Windows Media Audio V2",
         "Windows Media Audio V3"
     };
+    isom_iprint_hex( printer, indent, "wFormatTag", wFormatTag, 4 );
     if( wFormatTag == WAVE_FORMAT_TAG_ID_WMA_V2
      || wFormatTag == WAVE_FORMAT_TAG_ID_WMA_V3 )
-        lsmash_ifprintf( fp, indent, "wFormatTag = 0x%04"PRIx16" (%s)\n", wFormatTag, codec_name[wFormatTag - WAVE_FORMAT_TAG_ID_WMA_V2] );
-    else
-        lsmash_ifprintf( fp, indent, "wFormatTag = 0x%04"PRIx16"\n", wFormatTag );
-    lsmash_ifprintf( fp, indent, "nChannels = %"PRIu16"\n",       LSMASH_GET_LE16( &data[ 2] ) );
-    lsmash_ifprintf( fp, indent, "nSamplesPerSec = %"PRIu32"\n",  LSMASH_GET_LE32( &data[ 4] ) );
-    lsmash_ifprintf( fp, indent, "nAvgBytesPerSec = %"PRIu32"\n", LSMASH_GET_LE32( &data[ 8] ) );
-    lsmash_ifprintf( fp, indent, "nBlockAlign = %"PRIu16"\n",     LSMASH_GET_LE16( &data[12] ) );
-    lsmash_ifprintf( fp, indent, "wBitsPerSample = %"PRIu16"\n",  LSMASH_GET_LE16( &data[14] ) );
+        isom_iprint_note( printer, "%s", codec_name[wFormatTag - WAVE_FORMAT_TAG_ID_WMA_V2] );
+    isom_iprint_uint( printer, indent, "nChannels", LSMASH_GET_LE16( &data[ 2] ) );
+    isom_iprint_uint( printer, indent, "nSamplesPerSec", LSMASH_GET_LE32( &data[ 4] ) );
+    isom_iprint_uint( printer, indent, "nAvgBytesPerSec", LSMASH_GET_LE32( &data[ 8] ) );
+    isom_iprint_uint( printer, indent, "nBlockAlign", LSMASH_GET_LE16( &data[12] ) );
+    isom_iprint_uint( printer, indent, "wBitsPerSample", LSMASH_GET_LE16( &data[14] ) );
     uint16_t cbSize = LSMASH_GET_BYTE( &data[16] );
-    lsmash_ifprintf( fp, indent, "cbSize = %"PRIu16"\n",           cbSize );
+    isom_iprint_uint( printer, indent, "cbSize", cbSize );
     switch( wFormatTag )
     {
         case WAVE_FORMAT_TAG_ID_WMA_V2 :
             if( cbSize < 10 )
                 return LSMASH_ERR_INVALID_DATA;
-            lsmash_ifprintf( fp, indent, "dwSamplesPerBlock = %"PRIu32"\n",  LSMASH_GET_LE32( &data[18] ) );
-            lsmash_ifprintf( fp, indent, "wEncodeOptions = 0x%04"PRIu16"\n", LSMASH_GET_LE16( &data[22] ) );
-            lsmash_ifprintf( fp, indent, "dwSuperBlockAlign = %"PRIu32"\n",  LSMASH_GET_LE32( &data[24] ) );
+            isom_iprint_uint( printer, indent, "dwSamplesPerBlock", LSMASH_GET_LE32( &data[18] ) );
+            isom_iprint_hex( printer, indent, "wEncodeOptions", LSMASH_GET_LE16( &data[22] ), 4 );
+            isom_iprint_uint( printer, indent, "dwSuperBlockAlign", LSMASH_GET_LE32( &data[24] ) );
             break;
         case WAVE_FORMAT_TAG_ID_WMA_V3 :
             if( cbSize < 18 )
                 return LSMASH_ERR_INVALID_DATA;
-            lsmash_ifprintf( fp, indent, "wValidBitsPerSample = %"PRIu16"\n", LSMASH_GET_LE16( &data[18] ) );
-            lsmash_ifprintf( fp, indent, "dwChannelMask = 0x%08"PRIu32"\n",   LSMASH_GET_LE32( &data[20] ) );
-            lsmash_ifprintf( fp, indent, "dwReserved1 = 0x%08"PRIu32"\n",     LSMASH_GET_LE32( &data[24] ) );
-            lsmash_ifprintf( fp, indent, "dwReserved2 = 0x%08"PRIu32"\n",     LSMASH_GET_LE32( &data[28] ) );
-            lsmash_ifprintf( fp, indent, "wEncodeOptions = 0x%04"PRIu16"\n",  LSMASH_GET_LE16( &data[32] ) );
-            lsmash_ifprintf( fp, indent, "wReserved3 = 0x%04"PRIu16"\n",      LSMASH_GET_LE16( &data[34] ) );
+            isom_iprint_uint( printer, indent, "wValidBitsPerSample", LSMASH_GET_LE16( &data[18] ) );
+            isom_iprint_hex( printer, indent, "dwChannelMask", LSMASH_GET_LE32( &data[20] ), 8 );
+            isom_iprint_hex( printer, indent, "dwReserved1", LSMASH_GET_LE32( &data[24] ), 8 );
+            isom_iprint_hex( printer, indent, "dwReserved2", LSMASH_GET_LE32( &data[28] ), 8 );
+            isom_iprint_hex( printer, indent, "wEncodeOptions", LSMASH_GET_LE16( &data[32] ), 4 );
+            isom_iprint_hex( printer, indent, "wReserved3", LSMASH_GET_LE16( &data[34] ), 4 );
             break;
         default :
             break;
@@ -25,16 +25,55 @@
 #include <stdlib.h>
 #include <string.h>
 
-void *lsmash_malloc( size_t size )
+static void *default_malloc( void *opaque, size_t size )
 {
     return malloc( size );
 }
 
+static void *default_realloc( void *opaque, void *ptr, size_t size )
+{
+    return realloc( ptr, size );
+}
+
+static void default_free( void *opaque, void *ptr )
+{
+    free( ptr );
+}
+
+static lsmash_allocator_t allocator = { default_malloc, default_realloc, default_free, NULL };
+
+int lsmash_set_allocator( const lsmash_allocator_t *new_allocator )
+{
+    if( new_allocator
+     && (!new_allocator->malloc || !new_allocator->realloc || !new_allocator->free) )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    /* Buffers kept for reuse shall be deallocated by the allocator which allocated them. */
+    lsmash_flush_sample_pool();
+    if( !new_allocator )
+    {
+        allocator = (lsmash_allocator_t){ default_malloc, default_realloc, default_free, NULL };
+        return 0;
+    }
+    allocator = *new_allocator;
+    return 0;
+}
+
+void lsmash_get_allocator( lsmash_allocator_t *current_allocator )
+{
+    if( current_allocator )
+        *current_allocator = allocator;
+}
+
+void *lsmash_malloc( size_t size )
+{
+    return allocator.malloc( allocator.opaque, size );
+}
+
 void *lsmash_malloc_zero( size_t size )
 {
     if( !size )
         return NULL;
-    void *p = malloc( size );
+    void *p = allocator.malloc( allocator.opaque, size );
     if( !p )
         return NULL;
     memset( p, 0, size );
@@ -43,14 +82,14 @@ void *lsmash_malloc_zero( size_t size )
 
 void *lsmash_realloc( void *ptr, size_t size )
 {
-    return realloc( ptr, size );
+    return allocator.realloc( allocator.opaque, ptr, size );
 }
 
 void *lsmash_memdup( const void *ptr, size_t size )
 {
     if( !ptr || size == 0 )
         return NULL;
-    void *dst = malloc( size );
+    void *dst = allocator.malloc( allocator.opaque, size );
     if( !dst )
         return NULL;
     memcpy( dst, ptr, size );
@@ -60,7 +99,8 @@ void *lsmash_memdup( const void *ptr, size_t size )
 void lsmash_free( void *ptr )
 {
     /* free() shall do nothing if a given address is NULL. */
-    free( ptr );
+    if( ptr )
+        allocator.free( allocator.opaque, ptr );
 }
 
 void lsmash_freep( void *ptrptr )
@@ -68,6 +108,6 @@ void lsmash_freep( void *ptrptr )
     if( !ptrptr )
         return;
     void **ptr = (void **)ptrptr;
-    free( *ptr );
+    lsmash_free( *ptr );
     *ptr = NULL;
 }
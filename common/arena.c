@@ -0,0 +1,130 @@
+/*****************************************************************************
+ * arena.c
+ *****************************************************************************
+ * Copyright (C) 2026 L-SMASH project
+ *
+ * Authors: agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *****************************************************************************/
+
+/* This file is available under an ISC license. */
+
+#include "internal.h" /* must be placed first */
+
+#include <string.h>
+
+#define ARENA_CHUNK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT  8
+
+struct lsmash_arena_chunk_tag
+{
+    lsmash_arena_chunk_t *next;
+    size_t                size;     /* the size of data */
+    size_t                used;
+    /* Make data aligned. */
+    union
+    {
+        uint64_t u64;
+        double   dbl;
+        void    *ptr;
+    } data[];
+};
+
+lsmash_arena_t *lsmash_arena_create( void )
+{
+    return lsmash_malloc_zero( sizeof(lsmash_arena_t) );
+}
+
+static lsmash_arena_chunk_t *arena_create_chunk( size_t size )
+{
+    lsmash_arena_chunk_t *chunk = lsmash_malloc( sizeof(lsmash_arena_chunk_t) + size );
+    if( !chunk )
+        return NULL;
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+void *lsmash_arena_alloc( lsmash_arena_t *arena, size_t size )
+{
+    if( !arena || !size )
+        return NULL;
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    lsmash_arena_chunk_t *chunk = arena->head;
+    if( !chunk || chunk->size - chunk->used < size )
+    {
+        if( size > ARENA_CHUNK_SIZE / 4 )
+        {
+            /* Allocate a dedicated chunk for a large object and place it behind the current one
+             * so that the rest of the current chunk can still be used. */
+            chunk = arena_create_chunk( size );
+            if( !chunk )
+                return NULL;
+            chunk->used = size;
+            if( arena->head )
+            {
+                chunk->next       = arena->head->next;
+                arena->head->next = chunk;
+            }
+            else
+                arena->head = chunk;
+            memset( chunk->data, 0, size );
+            return chunk->data;
+        }
+        if( arena->spare )
+        {
+            chunk        = arena->spare;
+            arena->spare = NULL;
+            chunk->used  = 0;
+        }
+        else
+        {
+            chunk = arena_create_chunk( ARENA_CHUNK_SIZE );
+            if( !chunk )
+                return NULL;
+        }
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+    void *p = (uint8_t *)chunk->data + chunk->used;
+    chunk->used += size;
+    memset( p, 0, size );
+    return p;
+}
+
+void lsmash_arena_reset( lsmash_arena_t *arena )
+{
+    if( !arena )
+        return;
+    for( lsmash_arena_chunk_t *chunk = arena->head; chunk; )
+    {
+        lsmash_arena_chunk_t *next = chunk->next;
+        if( !arena->spare && chunk->size == ARENA_CHUNK_SIZE )
+            arena->spare = chunk;
+        else
+            lsmash_free( chunk );
+        chunk = next;
+    }
+    arena->head = NULL;
+}
+
+void lsmash_arena_destroy( lsmash_arena_t *arena )
+{
+    if( !arena )
+        return;
+    lsmash_arena_reset( arena );
+    lsmash_free( arena->spare );
+    lsmash_free( arena );
+}
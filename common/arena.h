@@ -0,0 +1,42 @@
+/*****************************************************************************
+ * arena.h
+ *****************************************************************************
+ * Copyright (C) 2026 L-SMASH project
+ *
+ * Authors: agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *****************************************************************************/
+
+/* This file is available under an ISC license. */
+
+/* Bump allocator for objects sharing the same lifetime.
+ * Any object allocated from an arena is released only when the arena is reset or destroyed. */
+typedef struct lsmash_arena_chunk_tag lsmash_arena_chunk_t;
+
+typedef struct
+{
+    lsmash_arena_chunk_t *head;     /* the chunk allocating from now */
+    lsmash_arena_chunk_t *spare;    /* a chunk kept for reuse after reset */
+} lsmash_arena_t;
+
+lsmash_arena_t *lsmash_arena_create( void );
+
+/* Allocate a zero-initialized memory block. */
+void *lsmash_arena_alloc( lsmash_arena_t *arena, size_t size );
+
+/* Release all objects allocated from the arena at once.
+ * One chunk of the default size is kept for subsequent allocations. */
+void lsmash_arena_reset( lsmash_arena_t *arena );
+
+void lsmash_arena_destroy( lsmash_arena_t *arena );
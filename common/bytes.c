@@ -36,6 +36,33 @@ lsmash_bs_t *lsmash_bs_create( void )
     return bs;
 }
 
+/* Call the I/O functions of the stream through these so that performance counters see every call. */
+static int bs_stream_read( lsmash_bs_t *bs, uint8_t *buf, int size )
+{
+    /* With a positioned read, 'offset' is the position of the stream and seeks for reading are done lazily. */
+    int read_size = bs->pread ? bs->pread( bs->stream, buf, size, bs->offset )
+                              : bs->read ( bs->stream, buf, size );
+    lsmash_stats_add( LSMASH_STATS_READ_CALLS, 1 );
+    if( read_size > 0 )
+        lsmash_stats_add( LSMASH_STATS_BYTES_READ, read_size );
+    return read_size;
+}
+
+static int bs_stream_write( lsmash_bs_t *bs, uint8_t *buf, int size )
+{
+    int write_size = bs->write( bs->stream, buf, size );
+    lsmash_stats_add( LSMASH_STATS_WRITE_CALLS, 1 );
+    if( write_size > 0 )
+        lsmash_stats_add( LSMASH_STATS_BYTES_WRITTEN, write_size );
+    return write_size;
+}
+
+static int64_t bs_stream_seek( lsmash_bs_t *bs, int64_t offset, int whence )
+{
+    lsmash_stats_add( LSMASH_STATS_SEEK_CALLS, 1 );
+    return bs->seek( bs->stream, offset, whence );
+}
+
 static void bs_buffer_free( lsmash_bs_t *bs )
 {
     if( bs->buffer.internal )
@@ -155,8 +182,14 @@ int64_t lsmash_bs_write_seek( lsmash_bs_t *bs, int64_t offset, int whence )
         return LSMASH_ERR_NAMELESS;
     if( whence != SEEK_SET && whence != SEEK_CUR && whence != SEEK_END )
         return LSMASH_ERR_FUNCTION_PARAM;
+    if( bs->pread && whence == SEEK_CUR )
+    {
+        /* Reads may have left the position of the stream behind 'offset'. */
+        offset += bs->offset;
+        whence  = SEEK_SET;
+    }
     /* Try to seek the stream. */
-    int64_t ret = bs->seek( bs->stream, offset, whence );
+    int64_t ret = bs_stream_seek( bs, offset, whence );
     if( ret < 0 )
         return ret;
     bs->offset = bs_estimate_seek_offset( bs, offset, whence );
@@ -189,10 +222,21 @@ int64_t lsmash_bs_read_seek( lsmash_bs_t *bs, int64_t offset, int whence )
     }
     if( bs->unseekable )
         return LSMASH_ERR_NAMELESS;
-    /* Try to seek the stream. */
-    int64_t ret = bs->seek( bs->stream, offset, whence );
-    if( ret < 0 )
-        return ret;
+    int64_t ret;
+    if( bs->pread && whence != SEEK_END )
+    {
+        /* Positioned reads don't need the position of the stream, so just move 'offset'. */
+        ret = whence == SEEK_SET ? offset : (int64_t)bs->offset + offset;
+        if( ret < 0 )
+            return LSMASH_ERR_FUNCTION_PARAM;
+    }
+    else
+    {
+        /* Try to seek the stream. */
+        ret = bs_stream_seek( bs, offset, whence );
+        if( ret < 0 )
+            return ret;
+    }
     bs->offset  = ret;
     bs->written = LSMASH_MAX( bs->written, bs->offset );
     bs->eof     = 0;
@@ -306,7 +350,7 @@ int lsmash_bs_flush_buffer( lsmash_bs_t *bs )
      || (bs->stream && bs->write && !bs->buffer.data) )
         return 0;
     if( bs->error
-     || (bs->stream && bs->write && bs->write( bs->stream, lsmash_bs_get_buffer_data_start( bs ), bs->buffer.store ) != bs->buffer.store) )
+     || (bs->stream && bs->write && bs_stream_write( bs, lsmash_bs_get_buffer_data_start( bs ), bs->buffer.store ) != bs->buffer.store) )
     {
         bs_buffer_free( bs );
         bs->error = 1;
@@ -333,12 +377,41 @@ int lsmash_bs_write_data( lsmash_bs_t *bs, const uint8_t *buf, size_t size )
         bs->error = 1;
         return LSMASH_ERR_NAMELESS;
     }
-    int write_size = bs->write( bs->stream, (uint8_t *)buf, size );
+    int write_size = bs_stream_write( bs, (uint8_t *)buf, size );
     bs->written += write_size;
     bs->offset  += write_size;
     return write_size != size ? LSMASH_ERR_NAMELESS : 0;
 }
 
+/* Advance the stream by 'size' bytes without any data after flushing the buffer.
+ * Only streams ignoring the data written into them accept this. */
+int lsmash_bs_write_void( lsmash_bs_t *bs, uint64_t size )
+{
+    if( !bs )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    int err = lsmash_bs_flush_buffer( bs );
+    if( err < 0 )
+        return err;
+    if( bs->error || !bs->stream )
+    {
+        bs->error = 1;
+        return LSMASH_ERR_NAMELESS;
+    }
+    while( size )
+    {
+        int write_size = LSMASH_MIN( size, INT_MAX );
+        if( bs_stream_write( bs, NULL, write_size ) != write_size )
+        {
+            bs->error = 1;
+            return LSMASH_ERR_NAMELESS;
+        }
+        bs->written += write_size;
+        bs->offset  += write_size;
+        size        -= write_size;
+    }
+    return 0;
+}
+
 void *lsmash_bs_export_data( lsmash_bs_t *bs, uint32_t *length )
 {
     if( !bs || !bs->buffer.data || bs->buffer.store == 0 || bs->error )
@@ -370,11 +443,12 @@ static void bs_fill_buffer( lsmash_bs_t *bs )
     }
     /* Read bytes from the stream to fill the buffer. */
     lsmash_bs_dispose_past_data( bs );
+    lsmash_stats_add( LSMASH_STATS_BUFFER_REFILLS, 1 );
     while( bs->buffer.alloc > bs->buffer.store )
     {
         uint64_t invalid_buffer_size = bs->buffer.alloc - bs->buffer.store;
         int max_read_size = LSMASH_MIN( invalid_buffer_size, bs->buffer.max_size );
-        int read_size = bs->read( bs->stream, lsmash_bs_get_buffer_data_end( bs ), max_read_size );
+        int read_size = bs_stream_read( bs, lsmash_bs_get_buffer_data_end( bs ), max_read_size );
         if( read_size == 0 )
         {
             bs->eof = 1;
@@ -646,7 +720,7 @@ int lsmash_bs_read( lsmash_bs_t *bs, uint32_t size )
         bs->error = 1;
         return LSMASH_ERR_NAMELESS;
     }
-    int read_size = bs->read( bs->stream, lsmash_bs_get_buffer_data_end( bs ), size );
+    int read_size = bs_stream_read( bs, lsmash_bs_get_buffer_data_end( bs ), size );
     if( read_size == 0 )
     {
         bs->eof = 1;
@@ -674,7 +748,7 @@ int lsmash_bs_read_data( lsmash_bs_t *bs, uint8_t *buf, size_t *size )
         bs->error = 1;
         return LSMASH_ERR_NAMELESS;
     }
-    int read_size = bs->read( bs->stream, buf, *size );
+    int read_size = bs_stream_read( bs, buf, *size );
     if( read_size == 0 )
         bs->eof = 1;
     else if( read_size < 0 )
@@ -50,6 +50,8 @@ typedef struct
     int     (*read) ( void *opaque, uint8_t *buf, int size );
     int     (*write)( void *opaque, uint8_t *buf, int size );
     int64_t (*seek) ( void *opaque, int64_t offset, int whence );
+    int     (*pread)( void *opaque, uint8_t *buf, int size, uint64_t offset );  /* optional read at a given position
+                                                                                 * without moving the position of 'stream' */
 } lsmash_bs_t;
 
 static inline void lsmash_bs_reset_counter( lsmash_bs_t *bs )
@@ -122,6 +124,7 @@ void lsmash_bs_put_le16( lsmash_bs_t *bs, uint16_t value );
 void lsmash_bs_put_le32( lsmash_bs_t *bs, uint32_t value );
 int lsmash_bs_flush_buffer( lsmash_bs_t *bs );
 int lsmash_bs_write_data( lsmash_bs_t *bs, const uint8_t *buf, size_t size );
+int lsmash_bs_write_void( lsmash_bs_t *bs, uint64_t size );
 void *lsmash_bs_export_data( lsmash_bs_t *bs, uint32_t *length );
 
 /*---- bytestream reader ----*/
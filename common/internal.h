@@ -34,6 +34,8 @@
 #include "bytes.h"
 #include "bits.h"
 #include "multibuf.h"
+#include "arena.h"
 #include "list.h"
+#include "stats.h"
 
 #endif
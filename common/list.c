@@ -35,6 +35,7 @@ static void lsmash_list_clear
     list->last_accessed_number = 0;
     list->entry_count          = 0;
     list->eliminator           = NULL;
+    list->arena                = NULL;
 }
 
 void lsmash_list_init_orig
@@ -50,6 +51,7 @@ void lsmash_list_init_orig
     list->last_accessed_number = 0;
     list->entry_count          = 0;
     list->eliminator           = eliminator;
+    list->arena                = NULL;
 }
 
 lsmash_entry_list_t *lsmash_list_create_orig
@@ -81,7 +83,9 @@ int lsmash_list_add_entry
 {
     if( !list )
         return LSMASH_ERR_FUNCTION_PARAM;
-    lsmash_entry_t *entry = lsmash_malloc( sizeof(lsmash_entry_t) );
+    lsmash_entry_t *entry = list->arena
+                          ? lsmash_arena_alloc( list->arena, sizeof(lsmash_entry_t) )
+                          : lsmash_malloc( sizeof(lsmash_entry_t) );
     if( !entry )
         return LSMASH_ERR_MEMORY_ALLOC;
     entry->next = NULL;
@@ -139,7 +143,8 @@ int lsmash_list_remove_entry_direct
         list->last_accessed_entry  = NULL;
         list->last_accessed_number = 0;
     }
-    lsmash_free( entry );
+    if( !list->arena )
+        lsmash_free( entry );
     list->entry_count -= 1;
     return 0;
 }
@@ -175,12 +180,15 @@ void lsmash_list_remove_entries
         lsmash_entry_t *next = entry->next;
         if( entry->data )
             list->eliminator( entry->data );
-        lsmash_free( entry );
+        if( !list->arena )
+            lsmash_free( entry );
         entry = next;
     }
     lsmash_entry_data_eliminator eliminator = list->eliminator;
+    lsmash_arena_t              *arena      = list->arena;
     lsmash_list_clear( list );
     list->eliminator = eliminator;
+    list->arena      = arena;
 }
 
 void lsmash_list_move_entries
@@ -191,8 +199,10 @@ void lsmash_list_move_entries
 {
     *dst = *src;
     lsmash_entry_data_eliminator eliminator = src->eliminator;
+    lsmash_arena_t              *arena      = src->arena;
     lsmash_list_clear( src );
     src->eliminator = eliminator;
+    src->arena      = arena;
 }
 
 lsmash_entry_t *lsmash_list_get_entry
@@ -40,6 +40,7 @@ typedef struct
     uint32_t                     last_accessed_number;
     uint32_t                     entry_count;
     lsmash_entry_data_eliminator eliminator;
+    lsmash_arena_t              *arena;     /* If set, entries are allocated from this arena and never freed one by one. */
 } lsmash_entry_list_t;
 
 /* Utility macros to avoid 'lsmash_entry_data_eliminator' casts to the 'eliminator' argument */
@@ -0,0 +1,167 @@
+/*****************************************************************************
+ * stats.c
+ *****************************************************************************
+ * Copyright (C) 2026 L-SMASH project
+ *
+ * Authors: agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *****************************************************************************/
+
+/* This file is available under an ISC license. */
+
+#include "internal.h" /* must be placed first */
+
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if !defined( __GNUC__ ) && !defined( _MSC_VER )
+#include "thread.h"
+#define STATS_USE_MUTEX
+static lsmash_mutex_t stats_mutex = LSMASH_MUTEX_INITIALIZER;
+#endif
+
+static uint64_t stats_counter[LSMASH_STATS_COUNTER_NUM];
+static uint64_t stats_span_count[LSMASH_TRACE_SPAN_COUNT];
+static uint64_t stats_span_time [LSMASH_TRACE_SPAN_COUNT];
+
+static lsmash_trace_callback trace_func;
+static void                 *trace_param;
+
+static inline void stats_atomic_add( uint64_t *counter, uint64_t n )
+{
+#if defined( __GNUC__ )
+    __atomic_fetch_add( counter, n, __ATOMIC_RELAXED );
+#elif defined( _MSC_VER )
+    InterlockedExchangeAdd64( (volatile LONG64 *)counter, (LONG64)n );
+#else
+    lsmash_mutex_lock( &stats_mutex );
+    *counter += n;
+    lsmash_mutex_unlock( &stats_mutex );
+#endif
+}
+
+static inline uint64_t stats_atomic_load( uint64_t *counter )
+{
+#if defined( __GNUC__ )
+    return __atomic_load_n( counter, __ATOMIC_RELAXED );
+#elif defined( _MSC_VER )
+    return (uint64_t)InterlockedCompareExchange64( (volatile LONG64 *)counter, 0, 0 );
+#else
+    lsmash_mutex_lock( &stats_mutex );
+    uint64_t value = *counter;
+    lsmash_mutex_unlock( &stats_mutex );
+    return value;
+#endif
+}
+
+static inline void stats_atomic_clear( uint64_t *counter )
+{
+#if defined( __GNUC__ )
+    __atomic_store_n( counter, 0, __ATOMIC_RELAXED );
+#elif defined( _MSC_VER )
+    InterlockedExchange64( (volatile LONG64 *)counter, 0 );
+#else
+    lsmash_mutex_lock( &stats_mutex );
+    *counter = 0;
+    lsmash_mutex_unlock( &stats_mutex );
+#endif
+}
+
+/* Monotonic time in nanoseconds. */
+static uint64_t stats_get_time( void )
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER count;
+    if( !QueryPerformanceFrequency( &frequency ) || !QueryPerformanceCounter( &count ) )
+        return 0;
+    return (uint64_t)(count.QuadPart / frequency.QuadPart) * 1000000000
+         + (uint64_t)(count.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+#else
+    struct timespec ts;
+    if( clock_gettime( CLOCK_MONOTONIC, &ts ) != 0 )
+        return 0;
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+void lsmash_stats_add( lsmash_stats_counter counter, uint64_t n )
+{
+    stats_atomic_add( &stats_counter[counter], n );
+}
+
+uint64_t lsmash_stats_begin_span( lsmash_trace_span span, const char *name )
+{
+    uint64_t start = stats_get_time();
+    if( trace_func )
+        trace_func( trace_param, span, name, 0, start );
+    return start;
+}
+
+void lsmash_stats_end_span( lsmash_trace_span span, const char *name, uint64_t start )
+{
+    uint64_t end = stats_get_time();
+    stats_atomic_add( &stats_span_count[span], 1 );
+    stats_atomic_add( &stats_span_time [span], end - start );
+    if( trace_func )
+        trace_func( trace_param, span, name, 1, end );
+}
+
+/*******************************
+    public interfaces
+*******************************/
+
+void lsmash_get_stats( lsmash_stats_t *stats )
+{
+    if( !stats )
+        return;
+    stats->bytes_read      = stats_atomic_load( &stats_counter[LSMASH_STATS_BYTES_READ     ] );
+    stats->bytes_written   = stats_atomic_load( &stats_counter[LSMASH_STATS_BYTES_WRITTEN  ] );
+    stats->read_calls      = stats_atomic_load( &stats_counter[LSMASH_STATS_READ_CALLS     ] );
+    stats->write_calls     = stats_atomic_load( &stats_counter[LSMASH_STATS_WRITE_CALLS    ] );
+    stats->seek_calls      = stats_atomic_load( &stats_counter[LSMASH_STATS_SEEK_CALLS     ] );
+    stats->buffer_refills  = stats_atomic_load( &stats_counter[LSMASH_STATS_BUFFER_REFILLS ] );
+    stats->samples_pooled  = stats_atomic_load( &stats_counter[LSMASH_STATS_SAMPLES_POOLED ] );
+    stats->samples_flushed = stats_atomic_load( &stats_counter[LSMASH_STATS_SAMPLES_FLUSHED] );
+    stats->chunks_created  = stats_atomic_load( &stats_counter[LSMASH_STATS_CHUNKS_CREATED ] );
+    stats->boxes_parsed    = stats_atomic_load( &stats_counter[LSMASH_STATS_BOXES_PARSED   ] );
+    stats->boxes_written   = stats_atomic_load( &stats_counter[LSMASH_STATS_BOXES_WRITTEN  ] );
+    for( int i = 0; i < LSMASH_TRACE_SPAN_COUNT; i++ )
+    {
+        stats->span_count[i] = stats_atomic_load( &stats_span_count[i] );
+        stats->span_time [i] = stats_atomic_load( &stats_span_time [i] );
+    }
+}
+
+void lsmash_reset_stats( void )
+{
+    for( int i = 0; i < LSMASH_STATS_COUNTER_NUM; i++ )
+        stats_atomic_clear( &stats_counter[i] );
+    for( int i = 0; i < LSMASH_TRACE_SPAN_COUNT; i++ )
+    {
+        stats_atomic_clear( &stats_span_count[i] );
+        stats_atomic_clear( &stats_span_time [i] );
+    }
+}
+
+void lsmash_set_trace_callback( lsmash_trace_callback func, void *param )
+{
+    trace_func  = func;
+    trace_param = param;
+}
@@ -0,0 +1,53 @@
+/*****************************************************************************
+ * stats.h
+ *****************************************************************************
+ * Copyright (C) 2026 L-SMASH project
+ *
+ * Authors: agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *****************************************************************************/
+
+/* This file is available under an ISC license. */
+
+#ifndef LSMASH_STATS_H
+#define LSMASH_STATS_H
+
+/* Performance counters shared by the whole process.
+ * The public view of them is lsmash_stats_t. */
+typedef enum
+{
+    LSMASH_STATS_BYTES_READ = 0,
+    LSMASH_STATS_BYTES_WRITTEN,
+    LSMASH_STATS_READ_CALLS,
+    LSMASH_STATS_WRITE_CALLS,
+    LSMASH_STATS_SEEK_CALLS,
+    LSMASH_STATS_BUFFER_REFILLS,
+    LSMASH_STATS_SAMPLES_POOLED,
+    LSMASH_STATS_SAMPLES_FLUSHED,
+    LSMASH_STATS_CHUNKS_CREATED,
+    LSMASH_STATS_BOXES_PARSED,
+    LSMASH_STATS_BOXES_WRITTEN,
+    LSMASH_STATS_COUNTER_NUM
+} lsmash_stats_counter;
+
+void lsmash_stats_add( lsmash_stats_counter counter, uint64_t n );
+
+/* Mark the beginning of a timing span and notify the trace callback if any.
+ * Return the time to be passed to lsmash_stats_end_span(). */
+uint64_t lsmash_stats_begin_span( lsmash_trace_span span, const char *name );
+
+/* Mark the end of a timing span which began at 'start' and account the elapsed time. */
+void lsmash_stats_end_span( lsmash_trace_span span, const char *name, uint64_t start );
+
+#endif
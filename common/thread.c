@@ -0,0 +1,124 @@
+/*****************************************************************************
+ * thread.c
+ *****************************************************************************
+ * Copyright (C) 2026 L-SMASH project
+ *
+ * Authors: agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *****************************************************************************/
+
+/* This file is available under an ISC license. */
+
+#include "internal.h" /* must be placed first */
+
+#include "thread.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+static DWORD WINAPI thread_start( LPVOID param )
+{
+    lsmash_thread_t *thread = (lsmash_thread_t *)param;
+    thread->ret = thread->func( thread->arg );
+    return 0;
+}
+#endif
+
+int lsmash_thread_create( lsmash_thread_t *thread, lsmash_thread_func func, void *arg )
+{
+    if( !thread || !func )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    thread->func = func;
+    thread->arg  = arg;
+    thread->ret  = NULL;
+#ifdef _WIN32
+    thread->handle = CreateThread( NULL, 0, thread_start, thread, 0, NULL );
+    if( !thread->handle )
+        return LSMASH_ERR_NAMELESS;
+#else
+    if( pthread_create( &thread->handle, NULL, func, arg ) )
+        return LSMASH_ERR_NAMELESS;
+#endif
+    return 0;
+}
+
+int lsmash_thread_join( lsmash_thread_t *thread, void **ret )
+{
+    if( !thread )
+        return LSMASH_ERR_FUNCTION_PARAM;
+#ifdef _WIN32
+    if( WaitForSingleObject( thread->handle, INFINITE ) != WAIT_OBJECT_0 )
+        return LSMASH_ERR_NAMELESS;
+    CloseHandle( thread->handle );
+#else
+    if( pthread_join( thread->handle, &thread->ret ) )
+        return LSMASH_ERR_NAMELESS;
+#endif
+    if( ret )
+        *ret = thread->ret;
+    return 0;
+}
+
+int lsmash_mutex_init( lsmash_mutex_t *mutex )
+{
+#ifdef _WIN32
+    InitializeSRWLock( mutex );
+    return 0;
+#else
+    return pthread_mutex_init( mutex, NULL ) ? LSMASH_ERR_NAMELESS : 0;
+#endif
+}
+
+void lsmash_mutex_destroy( lsmash_mutex_t *mutex )
+{
+#ifdef _WIN32
+    /* Nothing to do for SRW locks. */
+#else
+    pthread_mutex_destroy( mutex );
+#endif
+}
+
+void lsmash_mutex_lock( lsmash_mutex_t *mutex )
+{
+#ifdef _WIN32
+    AcquireSRWLockExclusive( mutex );
+#else
+    pthread_mutex_lock( mutex );
+#endif
+}
+
+void lsmash_mutex_unlock( lsmash_mutex_t *mutex )
+{
+#ifdef _WIN32
+    ReleaseSRWLockExclusive( mutex );
+#else
+    pthread_mutex_unlock( mutex );
+#endif
+}
+
+int lsmash_get_cpu_count( void )
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo( &info );
+    return info.dwNumberOfProcessors ? (int)info.dwNumberOfProcessors : 1;
+#elif defined( _SC_NPROCESSORS_ONLN )
+    long count = sysconf( _SC_NPROCESSORS_ONLN );
+    return count > 0 ? (int)count : 1;
+#else
+    return 1;
+#endif
+}
@@ -0,0 +1,78 @@
+/*****************************************************************************
+ * thread.h
+ *****************************************************************************
+ * Copyright (C) 2026 L-SMASH project
+ *
+ * Authors: agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *****************************************************************************/
+
+/* This file is available under an ISC license. */
+
+#ifndef LSMASH_THREAD_H
+#define LSMASH_THREAD_H
+
+/* Minimal threading primitives.
+ * This header is not included by internal.h since it pulls platform headers in.
+ * Include it explicitly where threads or mutexes are needed. */
+
+#ifdef _WIN32
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600 /* for SRWLOCK */
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+typedef void *(*lsmash_thread_func)( void *arg );
+
+typedef struct
+{
+#ifdef _WIN32
+    HANDLE             handle;
+#else
+    pthread_t          handle;
+#endif
+    lsmash_thread_func func;
+    void              *arg;
+    void              *ret;
+} lsmash_thread_t;
+
+#ifdef _WIN32
+typedef SRWLOCK         lsmash_mutex_t;
+#define LSMASH_MUTEX_INITIALIZER SRWLOCK_INIT
+#else
+typedef pthread_mutex_t lsmash_mutex_t;
+#define LSMASH_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+#endif
+
+/* Start 'func' with 'arg' on a new thread.
+ * 'thread' shall stay valid until lsmash_thread_join() returns. */
+int lsmash_thread_create( lsmash_thread_t *thread, lsmash_thread_func func, void *arg );
+
+/* Wait for the termination of 'thread' and set the return value of its function to 'ret' if 'ret' is not NULL. */
+int lsmash_thread_join( lsmash_thread_t *thread, void **ret );
+
+/* A mutex with static storage duration can be initialized by LSMASH_MUTEX_INITIALIZER instead. */
+int lsmash_mutex_init( lsmash_mutex_t *mutex );
+void lsmash_mutex_destroy( lsmash_mutex_t *mutex );
+void lsmash_mutex_lock( lsmash_mutex_t *mutex );
+void lsmash_mutex_unlock( lsmash_mutex_t *mutex );
+
+/* Return the number of online logical processors, or 1 if unknown. */
+int lsmash_get_cpu_count( void );
+
+#endif
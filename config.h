@@ -0,0 +1,2 @@
+#define LSMASH_REV "39"
+#define LSMASH_GIT_HASH "465b0b1"
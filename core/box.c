@@ -31,6 +31,7 @@
 #include "read.h"
 #include "print.h"
 #include "timeline.h"
+#include "file.h"
 
 #include "codecs/mp4a.h"
 #include "codecs/mp4sys.h"
@@ -72,7 +73,7 @@ void isom_init_box_common_orig
     isom_set_box_writer( box );
 }
 
-static void isom_reorder_tail_box( isom_box_t *parent )
+void isom_reorder_tail_box( isom_box_t *parent )
 {
     /* Reorder the appended box by 'precedence'. */
     lsmash_entry_t *x = parent->extensions.tail;
@@ -416,7 +417,27 @@ void isom_remove_extension_box( isom_box_t *ext )
     if( ext->destruct )
         ext->destruct( ext );
     isom_remove_all_extension_boxes( &ext->extensions );
-    lsmash_free( ext );
+    isom_free_box( ext );
+}
+
+/* Free the memory block of a box itself.
+ * Boxes allocated from an arena are left as they are until the arena is released. */
+void isom_free_box( void *opaque_box )
+{
+    isom_box_t *box = (isom_box_t *)opaque_box;
+    if( box && !(box->manager & LSMASH_ARENA_BOX) )
+        lsmash_free( box );
+}
+
+/* Get the arena which child boxes of a given box shall be allocated from.
+ * Files are never allocated from any arena since each file owns its arena. */
+lsmash_arena_t *isom_get_box_arena( void *parent_box )
+{
+    isom_box_t *parent = (isom_box_t *)parent_box;
+    if( LSMASH_IS_NON_EXISTING_BOX( parent )
+     || (void *)parent == (void *)parent->root )
+        return NULL;
+    return parent->file->arena;
 }
 
 void isom_remove_all_extension_boxes( lsmash_entry_list_t *extensions )
@@ -608,6 +629,7 @@ static void isom_remove_file_abstract( isom_file_abstract_t *file_abstract )
         return;
     isom_printer_destory_list( file_abstract );
     isom_remove_timelines( file_abstract );
+    isom_remove_read_mutex( file_abstract );
     lsmash_free( file_abstract->compatible_brands );
     lsmash_bs_cleanup( file_abstract->bs );
     lsmash_importer_destroy( file_abstract->importer );
@@ -616,6 +638,13 @@ static void isom_remove_file_abstract( isom_file_abstract_t *file_abstract )
         lsmash_list_destroy( file_abstract->fragment->pool );
         lsmash_free( file_abstract->fragment );
     }
+    if( file_abstract->arena )
+    {
+        /* Remove the children before their memory is released. */
+        isom_remove_all_extension_boxes( &file_abstract->extensions );
+        lsmash_arena_destroy( file_abstract->arena );
+        file_abstract->arena = NULL;
+    }
     REMOVE_BOX_IN_LIST( file_abstract );
 }
 
@@ -641,6 +670,7 @@ static void isom_remove_trak( isom_trak_t *trak )
         lsmash_list_destroy( trak->cache->roll.pool );
         lsmash_free( trak->cache->rap );
         lsmash_free( trak->cache->fragment );
+        lsmash_free( trak->cache->bitrate );
         lsmash_free( trak->cache );
     }
     REMOVE_BOX_IN_LIST( trak );
@@ -1163,13 +1193,14 @@ uint64_t isom_update_box_size( void *opaque_box )
 #define CREATE_BOX( box_name, parent_name, box_type, precedence, has_destructor )      \
     if( LSMASH_IS_NON_EXISTING_BOX( (isom_box_t *)parent_name ) )                      \
         return isom_non_existing_##box_name();                                         \
-    isom_##box_name##_t *box_name = ALLOCATE_BOX( box_name );                          \
+    isom_##box_name##_t *box_name = ALLOCATE_BOX( box_name,                            \
+                                                  isom_get_box_arena( parent_name ) ); \
     if( LSMASH_IS_NON_EXISTING_BOX( box_name ) )                                       \
         return box_name;                                                               \
     INIT_BOX_COMMON ## has_destructor( box_name, parent_name, box_type, precedence );  \
     if( isom_add_box_to_extension_list( parent_name, box_name ) < 0 )                  \
     {                                                                                  \
-        lsmash_free( box_name );                                                       \
+        isom_free_box( box_name );                                                     \
         return isom_non_existing_##box_name();                                         \
     }
 #define CREATE_LIST_BOX( box_name, parent_name, box_type, precedence, has_destructor )  \
@@ -1233,7 +1264,7 @@ isom_tref_type_t *isom_add_track_reference_type( isom_tref_t *tref, isom_track_r
 {
     if( LSMASH_IS_NON_EXISTING_BOX( tref ) )
         return isom_non_existing_tref_type();
-    isom_tref_type_t *tref_type = ALLOCATE_BOX( tref_type );
+    isom_tref_type_t *tref_type = ALLOCATE_BOX( tref_type, isom_get_box_arena( tref ) );
     if( LSMASH_IS_NON_EXISTING_BOX( tref_type ) )
         return tref_type;
     /* Initialize common fields. */
@@ -1248,7 +1279,7 @@ isom_tref_type_t *isom_add_track_reference_type( isom_tref_t *tref, isom_track_r
     isom_set_box_writer( (isom_box_t *)tref_type );
     if( isom_add_box_to_extension_list( tref, tref_type ) < 0 )
     {
-        lsmash_free( tref_type );
+        isom_free_box( tref_type );
         return isom_non_existing_tref_type();
     }
     if( lsmash_list_add_entry( &tref->ref_list, tref_type ) < 0 )
@@ -1376,13 +1407,13 @@ isom_dref_entry_t *isom_add_dref_entry( isom_dref_t *dref, lsmash_box_type_t typ
 {
     if( LSMASH_IS_NON_EXISTING_BOX( dref ) )
         return isom_non_existing_dref_entry();
-    isom_dref_entry_t *dref_entry = ALLOCATE_BOX( dref_entry );
+    isom_dref_entry_t *dref_entry = ALLOCATE_BOX( dref_entry, isom_get_box_arena( dref ) );
     if( LSMASH_IS_NON_EXISTING_BOX( dref_entry ) )
         return dref_entry;
     isom_init_box_common( dref_entry, dref, type, LSMASH_BOX_PRECEDENCE_ISOM_DREF_ENTRY, isom_remove_dref_entry );
     if( isom_add_box_to_extension_list( dref, dref_entry ) < 0 )
     {
-        lsmash_free( dref_entry );
+        isom_free_box( dref_entry );
         return isom_non_existing_dref_entry();
     }
     if( lsmash_list_add_entry( &dref->list, dref_entry ) < 0 )
@@ -1422,7 +1453,7 @@ static void *isom_add_sample_description_entry
 isom_visual_entry_t *isom_add_visual_description( isom_stsd_t *stsd, lsmash_codec_type_t sample_type )
 {
     assert( LSMASH_IS_EXISTING_BOX( stsd ) );
-    isom_visual_entry_t *visual = ALLOCATE_BOX( visual_entry );
+    isom_visual_entry_t *visual = ALLOCATE_BOX( visual_entry, isom_get_box_arena( stsd ) );
     if( LSMASH_IS_NON_EXISTING_BOX( visual ) )
         return visual;
     isom_init_box_common( visual, stsd, sample_type, LSMASH_BOX_PRECEDENCE_HM, isom_remove_visual_description );
@@ -1433,7 +1464,7 @@ isom_visual_entry_t *isom_add_visual_description( isom_stsd_t *stsd, lsmash_code
 isom_audio_entry_t *isom_add_audio_description( isom_stsd_t *stsd, lsmash_codec_type_t sample_type )
 {
     assert( LSMASH_IS_EXISTING_BOX( stsd ) );
-    isom_audio_entry_t *audio = ALLOCATE_BOX( audio_entry );
+    isom_audio_entry_t *audio = ALLOCATE_BOX( audio_entry, isom_get_box_arena( stsd ) );
     if( LSMASH_IS_NON_EXISTING_BOX( audio ) )
         return audio;
     isom_init_box_common( audio, stsd, sample_type, LSMASH_BOX_PRECEDENCE_HM, isom_remove_audio_description );
@@ -1444,7 +1475,7 @@ isom_audio_entry_t *isom_add_audio_description( isom_stsd_t *stsd, lsmash_codec_
 isom_hint_entry_t *isom_add_hint_description( isom_stsd_t *stsd, lsmash_codec_type_t sample_type )
 {
     assert( stsd );
-    isom_hint_entry_t *hint = ALLOCATE_BOX( hint_entry );
+    isom_hint_entry_t *hint = ALLOCATE_BOX( hint_entry, isom_get_box_arena( stsd ) );
     if ( LSMASH_IS_NON_EXISTING_BOX( hint ) )
         return hint;
     isom_init_box_common( hint, stsd, sample_type, LSMASH_BOX_PRECEDENCE_HM, isom_remove_hint_description );
@@ -1454,7 +1485,7 @@ isom_hint_entry_t *isom_add_hint_description( isom_stsd_t *stsd, lsmash_codec_ty
 isom_qt_text_entry_t *isom_add_qt_text_description( isom_stsd_t *stsd )
 {
     assert( LSMASH_IS_EXISTING_BOX( stsd ) );
-    isom_qt_text_entry_t *text = ALLOCATE_BOX( qt_text_entry );
+    isom_qt_text_entry_t *text = ALLOCATE_BOX( qt_text_entry, isom_get_box_arena( stsd ) );
     if( LSMASH_IS_NON_EXISTING_BOX( text ) )
         return text;
     isom_init_box_common( text, stsd, QT_CODEC_TYPE_TEXT_TEXT, LSMASH_BOX_PRECEDENCE_HM, isom_remove_qt_text_description );
@@ -1464,7 +1495,7 @@ isom_qt_text_entry_t *isom_add_qt_text_description( isom_stsd_t *stsd )
 isom_tx3g_entry_t *isom_add_tx3g_description( isom_stsd_t *stsd )
 {
     assert( LSMASH_IS_EXISTING_BOX( stsd ) );
-    isom_tx3g_entry_t *tx3g = ALLOCATE_BOX( tx3g_entry );
+    isom_tx3g_entry_t *tx3g = ALLOCATE_BOX( tx3g_entry, isom_get_box_arena( stsd ) );
     if( LSMASH_IS_NON_EXISTING_BOX( tx3g ) )
         return tx3g;
     isom_init_box_common( tx3g, stsd, ISOM_CODEC_TYPE_TX3G_TEXT, LSMASH_BOX_PRECEDENCE_HM, isom_remove_tx3g_description );
@@ -1743,7 +1774,7 @@ static int64_t fake_file_seek
 /* Public functions */
 lsmash_root_t *lsmash_create_root( void )
 {
-    lsmash_root_t *root = ALLOCATE_BOX( root_abstract );
+    lsmash_root_t *root = ALLOCATE_BOX( root_abstract, NULL );
     if( LSMASH_IS_NON_EXISTING_BOX( root ) )
         return NULL;
     root->root = root;
@@ -1838,7 +1869,7 @@ lsmash_box_t *lsmash_create_box
 {
     if( !lsmash_check_box_type_specified( &type ) )
         return NULL;
-    isom_unknown_box_t *box = ALLOCATE_BOX( unknown );
+    isom_unknown_box_t *box = ALLOCATE_BOX( unknown, NULL );
     if( LSMASH_IS_NON_EXISTING_BOX( box ) )
         return NULL;
     if( size && data )
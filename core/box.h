@@ -41,6 +41,7 @@ typedef struct lsmash_box_tag isom_box_t;
 typedef struct isom_unknown_box_tag isom_unknown_box_t;
 typedef struct isom_mdhd_tag isom_mdhd_t;
 typedef struct isom_stbl_tag isom_stbl_t;
+typedef struct isom_printer_tag isom_printer_t;
 
 typedef void (*isom_extension_destructor_t)( void *extension_data );
 typedef int (*isom_extension_writer_t)( lsmash_bs_t *bs, isom_box_t *box );
@@ -90,6 +91,7 @@ typedef int (*isom_bitrate_updater_t)( isom_stbl_t *stbl, isom_mdhd_t *mdhd, uin
 #define LSMASH_NON_EXISTING_BOX  0x800  /* This flag indicates a read only non-existing box constant.
                                          * Don't use for wild boxes other than non-existing box constants
                                          * because this flags prevents attempting to freeing its box. */
+#define LSMASH_ARENA_BOX         0x1000 /* This box is allocated from the arena of the file and freed together with it. */
 
 /* Use these macros for checking existences of boxes.
  * If the result of LSMASH_IS_EXISTING_BOX is 0, the evaluated box is read only.
@@ -1500,6 +1502,7 @@ typedef struct
     uint64_t size;              /* total size of samples in the pool */
     uint32_t sample_count;      /* number of samples in the pool */
     uint8_t *data;              /* actual data of samples in the pool */
+    uint8_t  size_only;         /* If set to 1, the pool has no data but the size of samples to estimate the output. */
 } isom_sample_pool_t;
 
 typedef struct
@@ -1578,6 +1581,30 @@ typedef struct
     isom_subsegment_t subsegment;
 } isom_fragment_t;
 
+typedef struct
+{
+    uint32_t sample_count;  /* the number of samples added with the sample description */
+    uint32_t bufferSizeDB;  /* the largest sample size */
+    uint32_t max_rate;      /* the largest number of bytes in a window of one second */
+    uint32_t rate;          /* the number of bytes in the current window */
+    uint64_t total_size;    /* the total number of bytes */
+    uint64_t first_dts;     /* the DTS of the first sample */
+    uint64_t last_dts;      /* the DTS of the last sample relative to 'first_dts' */
+    uint64_t window_dts;    /* the DTS where the current window starts relative to 'first_dts' */
+} isom_bitrate_t;
+
+typedef struct
+{
+    uint32_t sample_count;  /* the number of samples measured */
+    uint32_t delta_count;   /* the number of samples whose sample_delta is in 'stts' */
+    uint64_t last_dts;      /* the DTS of the last sample accumulated from 'stts' */
+    int64_t  min_cts;       /* the smallest CTS accumulated from 'stts' and 'ctts' */
+    int64_t  max_cts;       /* the largest CTS accumulated from 'stts' and 'ctts' */
+    int64_t  max2_cts;      /* the second largest CTS accumulated from 'stts' and 'ctts' */
+    int64_t  min_offset;    /* the smallest composition time offset */
+    int64_t  max_offset;    /* the largest composition time offset */
+} isom_timing_t;
+
 typedef struct
 {
     uint8_t           all_sync;     /* if all samples are sync sample */
@@ -1587,6 +1614,10 @@ typedef struct
     isom_grouping_t   roll;
     isom_rap_group_t *rap;
     isom_fragment_t  *fragment;
+    isom_timing_t     timing;           /* the timing statistics to get the media duration without rescans */
+    isom_bitrate_t   *bitrate;          /* the bitrate statistics for each sample description */
+    uint32_t          bitrate_count;    /* the number of sample descriptions in 'bitrate' */
+    uint8_t           stats_invalid;    /* if the sample tables were changed in a way not reflected in the statistics */
 } isom_cache_t;
 
 /** Movie Fragments Boxes **/
@@ -2013,13 +2044,18 @@ struct lsmash_file_tag
         lsmash_bs_t             *bs;        /* bytestream manager */
         isom_fragment_manager_t *fragment;  /* movie fragment manager */
         lsmash_entry_list_t     *print;
+        isom_printer_t          *printer;   /* the printer of boxes as soon as read, or NULL if printing is deferred */
         lsmash_entry_list_t     *timeline;
+        struct isom_timeline_tag *last_accessed_timeline;  /* the timeline found last by its track_ID */
         lsmash_file_t           *initializer;   /* A file containing the initialization information of whole movie including subsequent segments
                                                  * For ISOBMFF, an initializer corresponds to a file containing the 'moov' box.
                                                  * ROOT-to-initializer is designed to be a one-to-one relationship while initializer-to-file
                                                  * is designed to be a one-to-many relationship. */
         struct importer_tag     *importer;      /* An importer of this file
                                                  * Importer-to-file is designed to be a one-to-one relationship. */
+        lsmash_arena_t          *arena;         /* the allocator of boxes and their tables in this file if opened only for reading */
+        void                    *read_mutex;    /* the lock to serialize reads by track readers if the stream has no 'pread' */
+        uint64_t                 direct_read_end; /* the end of the last sample read bypassing the buffer */
         uint64_t  fragment_count;           /* the number of movie fragments we created */
         double    max_chunk_duration;       /* max duration per chunk in seconds */
         double    max_async_tolerance;      /* max tolerance, in seconds, for amount of interleaving asynchronization between tracks */
@@ -2448,6 +2484,12 @@ int isom_pool_sample
     uint32_t            samples_per_packet
 );
 
+int isom_put_pooled_samples
+(
+    lsmash_bs_t        *bs,
+    isom_sample_pool_t *pool
+);
+
 int isom_append_sample_by_type
 (
     void                *track,
@@ -2665,5 +2707,10 @@ void isom_remove_all_extension_boxes( lsmash_entry_list_t *extensions );
 isom_box_t *isom_get_extension_box( lsmash_entry_list_t *extensions, lsmash_box_type_t box_type );
 void *isom_get_extension_box_format( lsmash_entry_list_t *extensions, lsmash_box_type_t box_type );
 void isom_remove_box_by_itself( void *opaque_box );
+/* Move the tail box of 'parent' to the position by its precedence.
+ * Boxes added into a file opened for reading are not reordered automatically. */
+void isom_reorder_tail_box( isom_box_t *parent );
+void isom_free_box( void *opaque_box );
+lsmash_arena_t *isom_get_box_arena( void *parent_box );
 
 #endif
@@ -22,6 +22,8 @@
 
 #include "common/internal.h" /* must be placed first */
 
+#include <string.h>
+
 #include "box.h"
 #include "box_default.h"
 
@@ -259,18 +261,26 @@ DEFINE_SIMPLE_CONTAINER_BOX_DEFAULT_CONSTANT( file_abstract, ftyp, moov, mdat, m
 
 /* Allocate box by default settings.
  *
- * Use this function to allocate boxes as much as possible, it covers forgetful settings. */
+ * Use this function to allocate boxes as much as possible, it covers forgetful settings.
+ * If 'arena' is not NULL, the box is allocated from it and released together with it. */
 void *allocate_box_by_default
 (
-    const void  *nonexist_ptr,
-    const size_t data_type_size
+    const void     *nonexist_ptr,
+    const size_t    data_type_size,
+    lsmash_arena_t *arena
 )
 {
     assert( data_type_size >= offsetof( isom_box_t, manager ) + sizeof(((isom_box_t *)0)->manager) );
-    isom_box_t *box = (isom_box_t *)lsmash_memdup( nonexist_ptr, data_type_size );
+    isom_box_t *box = arena
+                    ? (isom_box_t *)lsmash_arena_alloc( arena, data_type_size )
+                    : (isom_box_t *)lsmash_malloc( data_type_size );
     if( !box )
         return (void *)nonexist_ptr;
+    memcpy( box, nonexist_ptr, data_type_size );
     box->manager &= ~LSMASH_NON_EXISTING_BOX;
+    if( arena )
+        box->manager |= LSMASH_ARENA_BOX;
     lsmash_list_init( &box->extensions, isom_remove_extension_box );
+    box->extensions.arena = arena;
     return (void *)box;
 }
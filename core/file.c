@@ -20,17 +20,26 @@
 
 /* This file is available under an ISC license. */
 
+#ifdef HAVE_COPY_FILE_RANGE
+#define _GNU_SOURCE /* for copy_file_range() */
+#endif
 #include "common/internal.h" /* must be placed first */
 
 /* for _setmode() */
 #ifdef _WIN32
 #include <io.h>
+#else
+/* for pread(), pwrite() and copy_file_range() */
+#include <unistd.h>
 #endif
 
 #include <string.h>
 #include <fcntl.h>
 
+#include "common/thread.h"
+
 #include "box.h"
+#include "file.h"
 #include "read.h"
 #include "fragment.h"
 
@@ -252,6 +261,254 @@ int isom_check_mandatory_boxes
     return 0;
 }
 
+static int default_io_stream_get_descriptor( lsmash_bs_t *bs );
+static int estimate_io_stream_write( void *opaque, uint8_t *buf, int size );
+static void estimate_io_stream_extend( void *opaque, uint64_t size );
+
+#ifndef _WIN32
+#define REARRANGE_BUFFER_SIZE          (16 * 1024 * 1024)   /* 16MiB, a multiple of the page size */
+#define REARRANGE_MIN_KERNEL_COPY_SIZE (64 * 1024)          /* Smaller chunks are slower than copying via a buffer. */
+
+static int isom_pwrite_all( int fd, const uint8_t *buf, size_t size, uint64_t pos )
+{
+    for( size_t done = 0; done < size; )
+    {
+        ssize_t n = pwrite( fd, buf + done, size - done, pos + done );
+        if( n <= 0 )
+            return LSMASH_ERR_NAMELESS;
+        done += n;
+    }
+    return 0;
+}
+
+static int isom_pread_all( int fd, uint8_t *buf, size_t size, uint64_t pos )
+{
+    for( size_t done = 0; done < size; )
+    {
+        ssize_t n = pread( fd, buf + done, size - done, pos + done );
+        if( n <= 0 )
+            return LSMASH_ERR_NAMELESS;
+        done += n;
+    }
+    return 0;
+}
+
+#ifdef HAVE_COPY_FILE_RANGE
+/* The source and the destination shall not overlap each other. */
+static int isom_copy_file_range( int fd, uint64_t src_pos, uint64_t dst_pos, uint64_t size )
+{
+    off_t src = src_pos;
+    off_t dst = dst_pos;
+    while( size )
+    {
+        ssize_t n = copy_file_range( fd, &src, fd, &dst, size, 0 );
+        if( n <= 0 )
+            return LSMASH_ERR_NAMELESS;
+        size -= n;
+    }
+    return 0;
+}
+#endif
+
+/* Move the rest of data by a plain file descriptor.
+ * Data is copied from the back to the front since the destination is always behind the source.
+ * This never overwrites the data not moved yet, so the stream needs no seek per read and per write.
+ * Chunks not larger than the distance of the move are copied in the kernel if possible.
+ * Return 1 if this method is unavailable. */
+static int isom_rearrange_data_backward
+(
+    lsmash_file_t        *file,
+    lsmash_adhoc_remux_t *remux,
+    uint8_t              *head,
+    size_t                head_size,
+    uint64_t              read_pos,
+    uint64_t              write_pos,
+    uint64_t              file_size
+)
+{
+    lsmash_bs_t *bs      = file->bs;
+    uint64_t     shift   = write_pos - (read_pos - head_size);
+    uint64_t     src_end = file_size - shift;   /* the end of data before moving */
+    if( src_end < read_pos )
+        return 1;
+    /* Make the pending writes visible to the file descriptor. */
+    int ret = lsmash_bs_flush_buffer( bs );
+    if( ret < 0 )
+        return ret;
+    int fd = default_io_stream_get_descriptor( bs );
+    if( fd < 0 )
+        return 1;
+    uint8_t *buf = NULL;
+#ifdef HAVE_COPY_FILE_RANGE
+    int kernel_copy = (shift >= REARRANGE_MIN_KERNEL_COPY_SIZE);
+#endif
+    uint64_t end = src_end;
+    while( end > read_pos )
+    {
+        uint64_t start;
+#ifdef HAVE_COPY_FILE_RANGE
+        if( kernel_copy )
+        {
+            start = end - read_pos > shift ? end - shift : read_pos;
+            if( isom_copy_file_range( fd, start, start + shift, end - start ) == 0 )
+                goto next;
+            /* Retry this chunk and copy the rest through the buffer.
+             * The source of this chunk is intact since it doesn't overlap the destination. */
+            kernel_copy = 0;
+        }
+#endif
+        if( !buf )
+        {
+            buf = lsmash_malloc( REARRANGE_BUFFER_SIZE );
+            if( !buf )
+                return LSMASH_ERR_MEMORY_ALLOC;
+        }
+        /* Keep the source offsets aligned to the buffer size except for the first and last chunks. */
+        start = ((end - 1) / REARRANGE_BUFFER_SIZE) * REARRANGE_BUFFER_SIZE;
+        if( start < read_pos )
+            start = read_pos;
+        if( (ret = isom_pread_all ( fd, buf, end - start, start ))         < 0
+         || (ret = isom_pwrite_all( fd, buf, end - start, start + shift )) < 0 )
+            goto fail;
+#ifdef HAVE_COPY_FILE_RANGE
+next:
+#endif
+        end = start;
+        if( remux->func )
+            remux->func( remux->param, write_pos + (src_end - end), file_size ); // FIXME:
+    }
+    /* Write the data read before the boxes moved to front was written. */
+    if( (ret = isom_pwrite_all( fd, head, head_size, write_pos )) < 0 )
+        goto fail;
+    /* Place the stream at the end of the file as if all data was written through it. */
+    int64_t ret64 = lsmash_bs_write_seek( bs, file_size, SEEK_SET );
+    if( ret64 < 0 )
+    {
+        ret = ret64;
+        goto fail;
+    }
+    bs->written += src_end - read_pos + head_size;
+    if( remux->func )
+        remux->func( remux->param, file_size, file_size ); // FIXME:
+    ret = 0;
+fail:
+    lsmash_free( buf );
+    return ret;
+}
+#endif
+
+#ifndef _WIN32
+/* Copy the data between plain files by their descriptors.
+ * The data is copied in the kernel if possible, and by positioned reads otherwise.
+ * Return 1 if this method is unavailable. */
+static int isom_copy_data_by_descriptor
+(
+    lsmash_bs_t *dst_bs,
+    lsmash_bs_t *src_bs,
+    uint64_t     src_pos,
+    uint64_t     size
+)
+{
+    int ret = lsmash_bs_flush_buffer( dst_bs );
+    if( ret < 0 )
+        return ret;
+    int dst_fd = default_io_stream_get_descriptor( dst_bs );
+    int src_fd = default_io_stream_get_descriptor( src_bs );
+    if( dst_fd < 0 || src_fd < 0 )
+        return 1;
+    int64_t dst_pos = dst_bs->seek( dst_bs->stream, 0, SEEK_CUR );
+    if( dst_pos < 0 )
+        return 1;
+    uint64_t done = 0;
+#ifdef HAVE_COPY_FILE_RANGE
+    if( size >= REARRANGE_MIN_KERNEL_COPY_SIZE )
+        while( done < size )
+        {
+            off_t src = src_pos + done;
+            off_t dst = dst_pos + done;
+            ssize_t n = copy_file_range( src_fd, &src, dst_fd, &dst, size - done, 0 );
+            if( n <= 0 )
+                break;  /* Copy the rest through the buffer. */
+            done += n;
+        }
+#endif
+    if( done < size )
+    {
+        size_t   buf_size = size - done < REARRANGE_BUFFER_SIZE ? size - done : REARRANGE_BUFFER_SIZE;
+        uint8_t *buf      = lsmash_malloc( buf_size );
+        if( !buf )
+            return LSMASH_ERR_MEMORY_ALLOC;
+        for( ; done < size; done += buf_size )
+        {
+            if( buf_size > size - done )
+                buf_size = size - done;
+            if( (ret = isom_pread_all ( src_fd, buf, buf_size, src_pos + done )) < 0
+             || (ret = isom_pwrite_all( dst_fd, buf, buf_size, dst_pos + done )) < 0 )
+                break;
+        }
+        lsmash_free( buf );
+        if( ret < 0 )
+            return ret;
+    }
+    /* Place the stream at the end of the copied data as if it was written through the stream. */
+    int64_t ret64 = lsmash_bs_write_seek( dst_bs, dst_pos + size, SEEK_SET );
+    if( ret64 < 0 )
+        return ret64;
+    dst_bs->written += size;
+    return 0;
+}
+#endif
+
+int isom_copy_media_data
+(
+    lsmash_file_t *dst,
+    lsmash_file_t *src,
+    uint64_t       src_pos,
+    uint64_t       size
+)
+{
+    if( !dst->bs || !src->bs )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    if( size == 0 )
+        return 0;
+    /* Nothing has to be read to estimate the output. */
+    if( isom_is_estimation_stream( dst->bs ) )
+        return lsmash_bs_write_void( dst->bs, size );
+#ifndef _WIN32
+    /* Try the fast path for plain files. */
+    int fast = isom_copy_data_by_descriptor( dst->bs, src->bs, src_pos, size );
+    if( fast <= 0 )
+        return fast;
+#endif
+    /* Transfer the data through the streams by large blocks. */
+    int      ret      = 0;
+    size_t   buf_size = size < BS_MAX_DEFAULT_READ_SIZE ? size : BS_MAX_DEFAULT_READ_SIZE;
+    uint8_t *buf      = lsmash_malloc( buf_size );
+    if( !buf )
+        return LSMASH_ERR_MEMORY_ALLOC;
+    if( lsmash_bs_read_seek( src->bs, src_pos, SEEK_SET ) < 0
+     || (ret = lsmash_bs_flush_buffer( dst->bs )) < 0 )
+    {
+        ret = ret < 0 ? ret : LSMASH_ERR_NAMELESS;
+        goto fail;
+    }
+    for( uint64_t done = 0; done < size; done += buf_size )
+    {
+        if( buf_size > size - done )
+            buf_size = size - done;
+        if( lsmash_bs_get_bytes_ex( src->bs, buf_size, buf ) != buf_size )
+        {
+            ret = LSMASH_ERR_INVALID_DATA;
+            break;
+        }
+        if( (ret = lsmash_bs_write_data( dst->bs, buf, buf_size )) < 0 )
+            break;
+    }
+fail:
+    lsmash_free( buf );
+    return ret;
+}
+
 int isom_rearrange_data
 (
     lsmash_file_t        *file,
@@ -265,6 +522,23 @@ int isom_rearrange_data
 )
 {
     assert( remux );
+    if( isom_is_estimation_stream( file->bs ) )
+    {
+        /* Moving data within a virtual file changes nothing but its size. */
+        estimate_io_stream_extend( file->bs->stream, file_size );
+        int64_t ret64 = lsmash_bs_write_seek( file->bs, file_size, SEEK_SET );
+        if( ret64 < 0 )
+            return ret64;
+        if( remux->func )
+            remux->func( remux->param, file_size, file_size );
+        return 0;
+    }
+#ifndef _WIN32
+    /* Try the fast path for plain files. */
+    int fast = isom_rearrange_data_backward( file, remux, buf[0], read_num, read_pos, write_pos, file_size );
+    if( fast <= 0 )
+        return fast;
+#endif
     /* Copy-pastan */
     int buf_switch = 1;
     lsmash_bs_t *bs = file->bs;
@@ -410,6 +684,11 @@ typedef struct
     int   is_standard_stream;   /* If set to 1, 'file_ptr' points to standard stream (i.e. stdin, stdout or stderr).
                                  * This flag prevents from accidentally closing standard streams. */
     lsmash_file_mode file_mode;
+    /* a virtual file for estimation of the output, where 'file_ptr' is NULL */
+    int      is_virtual;
+    uint64_t pos;
+    uint64_t size;
+    lsmash_output_estimate_t estimate;
 } default_io_stream_t;
 
 static default_io_stream_t *default_io_stream_open( const char *filename, int open_mode )
@@ -436,11 +715,33 @@ static default_io_stream_t *default_io_stream_open( const char *filename, int op
         memcpy( mode, "rb", 3 );
         stream->file_mode = LSMASH_FILE_MODE_READ;
     }
+    else if( open_mode == 2 )
+    {
+        memcpy( mode, "r+b", 4 );
+        stream->file_mode = LSMASH_FILE_MODE_READ;
+    }
+    else if( open_mode == 3 )
+    {
+        stream->file_mode = LSMASH_FILE_MODE_WRITE
+                          | LSMASH_FILE_MODE_BOX
+                          | LSMASH_FILE_MODE_INITIALIZATION
+                          | LSMASH_FILE_MODE_MEDIA;
+        stream->is_virtual = 1;
+        /* Behave like stdout if "-" is given. */
+        if( !strcmp( filename, "-" ) )
+        {
+            stream->is_standard_stream = 1;
+            stream->file_mode         |= LSMASH_FILE_MODE_FRAGMENTED;
+        }
+        return stream;
+    }
     else
         assert( 0 );
     if( !strcmp( filename, "-" ) )
     {
-        if( stream->file_mode & LSMASH_FILE_MODE_READ )
+        if( open_mode == 2 )
+            stream->file_ptr = NULL;
+        else if( stream->file_mode & LSMASH_FILE_MODE_READ )
         {
             stream->file_ptr           = stdin;
             stream->is_standard_stream = 1;
@@ -463,7 +764,7 @@ static int default_io_stream_close( default_io_stream_t *stream )
 {
     if( !stream )
         return 0;
-    int ret = stream->is_standard_stream ? 0 : fclose( stream->file_ptr );
+    int ret = (stream->is_standard_stream || stream->is_virtual) ? 0 : fclose( stream->file_ptr );
     lsmash_free( stream );
     return ret;
 }
@@ -486,6 +787,165 @@ static int64_t default_io_stream_seek( void *opaque, int64_t offset, int whence
     return lsmash_ftell( ((default_io_stream_t *)opaque)->file_ptr );
 }
 
+#ifndef _WIN32
+/* A positioned read doesn't move the position of the stream, so track readers can issue it concurrently. */
+static int default_io_stream_pread( void *opaque, uint8_t *buf, int size, uint64_t offset )
+{
+    ssize_t read_size = pread( fileno( ((default_io_stream_t *)opaque)->file_ptr ), buf, size, (off_t)offset );
+    return read_size < 0 ? LSMASH_ERR_NAMELESS : (int)read_size;
+}
+#endif
+
+/* A virtual file only tracks its position and size. */
+static int estimate_io_stream_read( void *opaque, uint8_t *buf, int size )
+{
+    default_io_stream_t *stream = (default_io_stream_t *)opaque;
+    if( stream->pos >= stream->size )
+        return 0;
+    int read_size = LSMASH_MIN( (uint64_t)size, stream->size - stream->pos );
+    memset( buf, 0, read_size );
+    stream->pos += read_size;
+    return read_size;
+}
+
+static int estimate_io_stream_write( void *opaque, uint8_t *buf, int size )
+{
+    default_io_stream_t *stream = (default_io_stream_t *)opaque;
+    stream->pos += size;
+    estimate_io_stream_extend( stream, stream->pos );
+    return size;
+}
+
+static int64_t estimate_io_stream_seek( void *opaque, int64_t offset, int whence )
+{
+    default_io_stream_t *stream = (default_io_stream_t *)opaque;
+    int64_t pos;
+    if( whence == SEEK_SET )
+        pos = offset;
+    else if( whence == SEEK_CUR )
+        pos = stream->pos + offset;
+    else if( whence == SEEK_END )
+        pos = stream->size + offset;
+    else
+        return LSMASH_ERR_FUNCTION_PARAM;
+    if( pos < 0 )
+        return LSMASH_ERR_NAMELESS;
+    stream->pos = pos;
+    return pos;
+}
+
+static void estimate_io_stream_extend( void *opaque, uint64_t size )
+{
+    default_io_stream_t *stream = (default_io_stream_t *)opaque;
+    if( stream->size < size )
+        stream->size = size;
+}
+
+int isom_is_estimation_stream( lsmash_bs_t *bs )
+{
+    return bs && bs->stream && bs->write == estimate_io_stream_write;
+}
+
+void isom_estimate_written_box( lsmash_bs_t *bs, isom_box_t *box )
+{
+    if( !isom_is_estimation_stream( bs )
+     || !(box->manager & LSMASH_WRITTEN_BOX)
+     || LSMASH_IS_NON_EXISTING_BOX( box->parent )
+     || box->parent != (isom_box_t *)box->file )
+        return;
+    lsmash_output_estimate_t *estimate = &((default_io_stream_t *)bs->stream)->estimate;
+    if( lsmash_check_box_type_identical( box->type, ISOM_BOX_TYPE_MOOV ) )
+        estimate->moov_size = box->size;
+    else if( lsmash_check_box_type_identical( box->type, ISOM_BOX_TYPE_MOOF ) )
+    {
+        ++ estimate->fragment_count;
+        estimate->moof_size += box->size;
+    }
+    else if( lsmash_check_box_type_identical( box->type, ISOM_BOX_TYPE_SIDX ) )
+    {
+        ++ estimate->sidx_count;
+        estimate->sidx_size += box->size;
+    }
+    else if( lsmash_check_box_type_identical( box->type, ISOM_BOX_TYPE_MFRA ) )
+        estimate->mfra_size = box->size;
+}
+
+/* Get the file descriptor of a regular file opened by lsmash_open_file().
+ * The data buffered in the stream is flushed so that it can be seen through the descriptor.
+ * Return a negative value if the stream is not such one. */
+static int default_io_stream_get_descriptor( lsmash_bs_t *bs )
+{
+#ifndef _WIN32
+    if( bs->write != default_io_stream_write
+     || bs->seek  != default_io_stream_seek
+     || !bs->stream )
+        return -1;
+    default_io_stream_t *stream = (default_io_stream_t *)bs->stream;
+    if( stream->is_standard_stream
+     || fflush( stream->file_ptr ) != 0 )
+        return -1;
+    return fileno( stream->file_ptr );
+#else
+    return -1;
+#endif
+}
+
+int isom_read_file_at
+(
+    lsmash_file_t *file,
+    uint64_t       pos,
+    uint8_t       *buf,
+    uint32_t       size
+)
+{
+    lsmash_bs_t *bs = file->bs;
+    if( !bs || !bs->read )
+        return LSMASH_ERR_NAMELESS;
+    uint32_t done = 0;
+    if( bs->pread )
+        while( done < size )
+        {
+            int read_size = bs->pread( bs->stream, buf + done, size - done, pos + done );
+            if( read_size <= 0 )
+                break;
+            done += read_size;
+        }
+    else
+    {
+        /* The stream is shared, so seek it under the lock and restore its position for the bytestream manager. */
+        if( !file->read_mutex || !bs->seek )
+            return LSMASH_ERR_PATCH_WELCOME;
+        lsmash_mutex_lock( (lsmash_mutex_t *)file->read_mutex );
+        int64_t current_pos = bs->seek( bs->stream, 0, SEEK_CUR );
+        if( current_pos >= 0 && bs->seek( bs->stream, pos, SEEK_SET ) >= 0 )
+        {
+            while( done < size )
+            {
+                int read_size = bs->read( bs->stream, buf + done, size - done );
+                if( read_size <= 0 )
+                    break;
+                done += read_size;
+            }
+            bs->seek( bs->stream, current_pos, SEEK_SET );
+        }
+        lsmash_mutex_unlock( (lsmash_mutex_t *)file->read_mutex );
+    }
+    lsmash_stats_add( LSMASH_STATS_READ_CALLS, 1 );
+    lsmash_stats_add( LSMASH_STATS_BYTES_READ, done );
+    return done == size ? 0 : LSMASH_ERR_NAMELESS;
+}
+
+void isom_remove_read_mutex
+(
+    lsmash_file_t *file
+)
+{
+    if( !file->read_mutex )
+        return;
+    lsmash_mutex_destroy( (lsmash_mutex_t *)file->read_mutex );
+    lsmash_freep( &file->read_mutex );
+}
+
 /*******************************
     public interfaces
 *******************************/
@@ -499,6 +959,8 @@ void lsmash_discard_boxes
      || LSMASH_IS_NON_EXISTING_BOX( root->file ) )
         return;
     isom_remove_all_extension_boxes( &root->file->extensions );
+    /* All boxes and tables in the arena have been just removed. */
+    lsmash_arena_reset( root->file->arena );
 }
 
 int lsmash_open_file
@@ -508,7 +970,7 @@ int lsmash_open_file
     lsmash_file_parameters_t *param
 )
 {
-    if( !filename || !param || (open_mode != 0 && open_mode != 1) )
+    if( !filename || !param || open_mode < 0 || open_mode > 3 )
         return LSMASH_ERR_FUNCTION_PARAM;
     default_io_stream_t *stream = default_io_stream_open( filename, open_mode );
     if( !stream )
@@ -516,9 +978,25 @@ int lsmash_open_file
     memset( param, 0, sizeof(lsmash_file_parameters_t) );
     param->mode                = stream->file_mode;
     param->opaque              = (void *)stream;
-    param->read                = default_io_stream_read;
-    param->write               = default_io_stream_write;
-    param->seek                = stream->is_standard_stream ? NULL : default_io_stream_seek;
+    if( stream->is_virtual )
+    {
+        param->read  = estimate_io_stream_read;
+        param->write = estimate_io_stream_write;
+        param->seek  = stream->is_standard_stream ? NULL : estimate_io_stream_seek;
+    }
+    else
+    {
+        param->read  = default_io_stream_read;
+        param->write = default_io_stream_write;
+        param->seek  = stream->is_standard_stream ? NULL : default_io_stream_seek;
+#ifndef _WIN32
+        if( open_mode == 1 && !stream->is_standard_stream )
+        {
+            param->mode |= LSMASH_FILE_MODE_PREAD;
+            param->pread = default_io_stream_pread;
+        }
+#endif
+    }
     param->major_brand         = 0;
     param->brands              = NULL;
     param->brand_count         = 0;
@@ -542,6 +1020,32 @@ int lsmash_close_file
     return ret == 0 ? 0 : LSMASH_ERR_UNKNOWN;
 }
 
+int lsmash_get_output_estimate
+(
+    lsmash_root_t            *root,
+    lsmash_output_estimate_t *estimate
+)
+{
+    if( isom_check_initializer_present( root ) < 0 || !estimate )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    lsmash_file_t *file = root->file;
+    if( !isom_is_estimation_stream( file->bs ) )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    default_io_stream_t *stream = (default_io_stream_t *)file->bs->stream;
+    *estimate = stream->estimate;
+    /* Data still in the buffer is not written into the stream yet. */
+    estimate->file_size        = LSMASH_MAX( stream->size, stream->pos + file->bs->buffer.store );
+    estimate->co64_track_count = 0;
+    for( lsmash_entry_t *entry = file->initializer->moov->trak_list.head; entry; entry = entry->next )
+    {
+        isom_trak_t *trak = (isom_trak_t *)entry->data;
+        if( LSMASH_IS_EXISTING_BOX( trak )
+         && trak->mdia->minf->stbl->stco->large_presentation )
+            ++ estimate->co64_track_count;
+    }
+    return 0;
+}
+
 lsmash_file_t *lsmash_set_file
 (
     lsmash_root_t            *root,
@@ -564,9 +1068,37 @@ lsmash_file_t *lsmash_set_file
     file->bs->seek            = param->seek;
     file->bs->unseekable      = (param->seek == NULL);
     file->bs->buffer.max_size = param->max_read_size;
+    /* Positioned reads don't follow the position of the stream, which writing relies on. */
+    if( param->seek
+     && (file->flags & LSMASH_FILE_MODE_PREAD)
+     && !(file->flags & LSMASH_FILE_MODE_WRITE) )
+        file->bs->pread       = param->pread;
     file->max_chunk_duration  = param->max_chunk_duration;
     file->max_async_tolerance = LSMASH_MAX( param->max_async_tolerance, 2 * param->max_chunk_duration );
     file->max_chunk_size      = param->max_chunk_size;
+    if( (file->flags & (LSMASH_FILE_MODE_READ | LSMASH_FILE_MODE_DUMP))
+     && !(file->flags & LSMASH_FILE_MODE_WRITE) )
+    {
+        /* Boxes read from a file are never removed one by one until the file is closed or
+         * its boxes are discarded, so allocate them and their tables from a per-file arena. */
+        file->arena = lsmash_arena_create();
+        if( !file->arena )
+            goto fail;
+        file->extensions.arena = file->arena;
+        if( !file->bs->pread && !file->bs->unseekable )
+        {
+            /* Track readers share the stream, so serialize their reads. */
+            lsmash_mutex_t *mutex = lsmash_malloc( sizeof(lsmash_mutex_t) );
+            if( !mutex )
+                goto fail;
+            if( lsmash_mutex_init( mutex ) < 0 )
+            {
+                lsmash_free( mutex );
+                goto fail;
+            }
+            file->read_mutex = mutex;
+        }
+    }
     if( (file->flags & LSMASH_FILE_MODE_WRITE)
      && (file->flags & LSMASH_FILE_MODE_BOX) )
     {
@@ -41,3 +41,41 @@ int isom_rearrange_data
     uint64_t              write_pos,
     uint64_t              file_size
 );
+
+/* Return 1 if the stream is the one of a virtual file for estimation of the output, or 0 otherwise. */
+int isom_is_estimation_stream
+(
+    lsmash_bs_t *bs
+);
+
+/* Account a top-level box just written into the stream of a virtual file for estimation of the output. */
+void isom_estimate_written_box
+(
+    lsmash_bs_t *bs,
+    isom_box_t  *box
+);
+
+/* Read 'size' bytes at 'pos' in the stream of 'file' into 'buf' without changing the state of its bytestream manager.
+ * This function can be called from multiple threads concurrently.
+ * Return 0 if successful, or a negative value otherwise. */
+int isom_read_file_at
+(
+    lsmash_file_t *file,
+    uint64_t       pos,
+    uint8_t       *buf,
+    uint32_t       size
+);
+
+void isom_remove_read_mutex
+(
+    lsmash_file_t *file
+);
+
+/* Copy 'size' bytes at 'src_pos' in the stream of 'src' to the current position in the stream of 'dst'. */
+int isom_copy_media_data
+(
+    lsmash_file_t *dst,
+    lsmash_file_t *src,
+    uint64_t       src_pos,
+    uint64_t       size
+);
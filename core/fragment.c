@@ -82,6 +82,43 @@ int lsmash_create_fragment_movie( lsmash_root_t *root )
     return 0;
 }
 
+int lsmash_set_fragment_sequence_number
+(
+    lsmash_root_t *root,
+    uint32_t       sequence_number
+)
+{
+    if( isom_check_initializer_present( root ) < 0
+     || sequence_number == 0 )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    lsmash_file_t *file = root->file;
+    if( !file->fragment )
+        return LSMASH_ERR_NAMELESS;
+    file->fragment_count = sequence_number - 1;
+    return 0;
+}
+
+int lsmash_set_preceding_subsegment_duration
+(
+    lsmash_root_t *root,
+    uint32_t       track_ID,
+    uint64_t       duration
+)
+{
+    if( isom_check_initializer_present( root ) < 0 )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    lsmash_file_t *file = root->file;
+    if( !file->fragment )
+        return LSMASH_ERR_NAMELESS;
+    isom_trak_t *trak = isom_get_trak( file->initializer, track_ID );
+    if( LSMASH_IS_NON_EXISTING_BOX( trak )
+     || !trak->cache
+     || !trak->cache->fragment )
+        return LSMASH_ERR_NAMELESS;
+    trak->cache->fragment->subsegment.segment_duration = duration;
+    return 0;
+}
+
 static inline uint64_t isom_fragment_get_implicit_segment_duration
 (
     isom_cache_t *cache
@@ -1248,7 +1285,7 @@ int isom_append_fragment_track_run
         return LSMASH_ERR_MEMORY_ALLOC;
     frag_manager->sample_count += chunk->pool->sample_count;
     frag_manager->pool_size    += chunk->pool->size;
-    chunk->pool = isom_create_sample_pool( chunk->pool->size );
+    chunk->pool = isom_create_sample_pool( chunk->pool->size_only ? 0 : chunk->pool->size );
     return chunk->pool ? 0 : LSMASH_ERR_MEMORY_ALLOC;
 }
 
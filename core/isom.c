@@ -388,6 +388,7 @@ static int isom_add_stco_entry( isom_stbl_t *stbl, uint64_t chunk_offset )
 {
     if( !stbl->stco->list )
         return LSMASH_ERR_NAMELESS;
+    lsmash_stats_add( LSMASH_STATS_CHUNKS_CREATED, 1 );
     if( stbl->stco->large_presentation )
         return isom_add_co64_entry( stbl, chunk_offset );
     if( chunk_offset > UINT32_MAX )
@@ -542,6 +543,17 @@ uint32_t isom_get_sample_count( isom_trak_t *trak )
     return isom_get_sample_count_from_sample_table( trak->mdia->minf->stbl );
 }
 
+/* Get the timing statistics measured while adding samples if they cover the whole sample table. */
+static isom_timing_t *isom_get_timing_statistics( isom_trak_t *trak )
+{
+    isom_cache_t *cache = trak->cache;
+    if( !cache
+     || cache->stats_invalid
+     || cache->timing.sample_count != isom_get_sample_count( trak ) )
+        return NULL;
+    return &cache->timing;
+}
+
 static uint64_t isom_get_dts( isom_stts_t *stts, uint32_t sample_number )
 {
     if( !stts->list )
@@ -649,7 +661,14 @@ static int isom_update_mdhd_duration( isom_trak_t *trak, uint32_t last_sample_de
     else if( LSMASH_IS_NON_EXISTING_BOX( ctts ) )
     {
         /* use dts instead of cts */
-        mdhd->duration = isom_get_dts( stts, sample_count );
+        isom_timing_t *timing = isom_get_timing_statistics( trak );
+        mdhd->duration = timing && timing->delta_count == sample_count
+                       ? timing->last_dts
+                       : isom_get_dts( stts, sample_count );
+        /* Without the sample_delta of the last sample, changing the last one in 'stts' moves the last sample. */
+        if( timing && timing->delta_count < sample_count
+         && (last_sample_delta || last_stts_data->sample_count == 1) )
+            trak->cache->stats_invalid = 1;
         int err;
         if( last_sample_delta )
         {
@@ -681,58 +700,77 @@ static int isom_update_mdhd_duration( isom_trak_t *trak, uint32_t last_sample_de
         int64_t  max_offset = 0;
         int64_t  min_offset = UINT32_MAX;
         int32_t  ctd_shift  = trak->cache->timestamp.ctd_shift;
-        uint32_t j = 0;
-        uint32_t k = 0;
-        lsmash_entry_t *stts_entry = stts->list->head;
-        lsmash_entry_t *ctts_entry = ctts->list->head;
-        for( uint32_t i = 0; i < sample_count; i++ )
+        isom_timing_t *timing = isom_get_timing_statistics( trak );
+        if( timing )
         {
-            if( !ctts_entry || !stts_entry )
-                return LSMASH_ERR_INVALID_DATA;
-            isom_stts_entry_t *stts_data = (isom_stts_entry_t *)stts_entry->data;
-            isom_ctts_entry_t *ctts_data = (isom_ctts_entry_t *)ctts_entry->data;
-            if( !stts_data || !ctts_data )
+            /* The statistics measured while adding samples give the same results as the scan of the tables. */
+            if( timing->delta_count < sample_count )
                 return LSMASH_ERR_INVALID_DATA;
-            if( ctts_data->sample_offset != ISOM_NON_OUTPUT_SAMPLE_OFFSET )
+            dts        = timing->last_dts;
+            max_offset = timing->max_offset;
+            min_offset = timing->min_offset;
+            if( timing->min_cts != INT64_MAX )
             {
-                uint64_t cts;
-                if( ctd_shift )
+                min_cts  = timing->min_cts + ctd_shift;
+                max_cts  = LSMASH_MAX( timing->max_cts + ctd_shift, 0 );
+                max2_cts = timing->max2_cts != INT64_MIN ? LSMASH_MAX( timing->max2_cts + ctd_shift, 0 ) : 0;
+            }
+        }
+        else
+        {
+            uint32_t j = 0;
+            uint32_t k = 0;
+            lsmash_entry_t *stts_entry = stts->list->head;
+            lsmash_entry_t *ctts_entry = ctts->list->head;
+            for( uint32_t i = 0; i < sample_count; i++ )
+            {
+                if( !ctts_entry || !stts_entry )
+                    return LSMASH_ERR_INVALID_DATA;
+                isom_stts_entry_t *stts_data = (isom_stts_entry_t *)stts_entry->data;
+                isom_ctts_entry_t *ctts_data = (isom_ctts_entry_t *)ctts_entry->data;
+                if( !stts_data || !ctts_data )
+                    return LSMASH_ERR_INVALID_DATA;
+                if( ctts_data->sample_offset != ISOM_NON_OUTPUT_SAMPLE_OFFSET )
                 {
-                    /* Anyway, add composition to decode timeline shift for calculating maximum and minimum CTS correctly. */
-                    int64_t sample_offset = (int32_t)ctts_data->sample_offset;
-                    cts = dts + sample_offset + ctd_shift;
-                    max_offset = LSMASH_MAX( max_offset, sample_offset );
-                    min_offset = LSMASH_MIN( min_offset, sample_offset );
+                    uint64_t cts;
+                    if( ctd_shift )
+                    {
+                        /* Anyway, add composition to decode timeline shift for calculating maximum and minimum CTS correctly. */
+                        int64_t sample_offset = (int32_t)ctts_data->sample_offset;
+                        cts = dts + sample_offset + ctd_shift;
+                        max_offset = LSMASH_MAX( max_offset, sample_offset );
+                        min_offset = LSMASH_MIN( min_offset, sample_offset );
+                    }
+                    else
+                    {
+                        cts = dts + ctts_data->sample_offset;
+                        max_offset = LSMASH_MAX( max_offset, ctts_data->sample_offset );
+                        min_offset = LSMASH_MIN( min_offset, ctts_data->sample_offset );
+                    }
+                    min_cts = LSMASH_MIN( min_cts, cts );
+                    if( max_cts < cts )
+                    {
+                        max2_cts = max_cts;
+                        max_cts  = cts;
+                    }
+                    else if( max2_cts < cts )
+                        max2_cts = cts;
                 }
-                else
+                dts += stts_data->sample_delta;
+                /* If finished sample_count of current entry, move to next. */
+                if( ++j == ctts_data->sample_count )
                 {
-                    cts = dts + ctts_data->sample_offset;
-                    max_offset = LSMASH_MAX( max_offset, ctts_data->sample_offset );
-                    min_offset = LSMASH_MIN( min_offset, ctts_data->sample_offset );
+                    ctts_entry = ctts_entry->next;
+                    j = 0;
                 }
-                min_cts = LSMASH_MIN( min_cts, cts );
-                if( max_cts < cts )
+                if( ++k == stts_data->sample_count )
                 {
-                    max2_cts = max_cts;
-                    max_cts  = cts;
+                    stts_entry = stts_entry->next;
+                    k = 0;
                 }
-                else if( max2_cts < cts )
-                    max2_cts = cts;
-            }
-            dts += stts_data->sample_delta;
-            /* If finished sample_count of current entry, move to next. */
-            if( ++j == ctts_data->sample_count )
-            {
-                ctts_entry = ctts_entry->next;
-                j = 0;
-            }
-            if( ++k == stts_data->sample_count )
-            {
-                stts_entry = stts_entry->next;
-                k = 0;
             }
+            dts -= last_stts_data->sample_delta;
         }
-        dts -= last_stts_data->sample_delta;
         if( file->fragment )
             /* Overall presentation is extended exceeding this initial movie.
              * So, any players shall display the movie exceeding the durations
@@ -905,6 +943,125 @@ static inline int isom_increment_sample_number_in_entry
     return 0;
 }
 
+static void isom_convert_bitrate_description
+(
+    double    duration,
+    uint64_t  total_size,
+    uint32_t  max_rate,
+    uint32_t *maxBitrate,
+    uint32_t *avgBitrate
+)
+{
+    *avgBitrate = (uint32_t)(total_size / duration);
+    *maxBitrate = max_rate ? max_rate : *avgBitrate;
+    /* Convert to bits per second. */
+    *maxBitrate *= 8;
+    *avgBitrate *= 8;
+}
+
+/* Get the bitrate statistics of a sample description accumulated while adding samples.
+ * Return NULL if they don't cover the whole sample table. */
+static isom_bitrate_t *isom_get_bitrate_statistics
+(
+    isom_cache_t *cache,
+    isom_stbl_t  *stbl,
+    uint32_t      sample_description_index
+)
+{
+    static isom_bitrate_t no_sample = { 0 };
+    if( !cache
+     || cache->stats_invalid )
+        return NULL;
+    uint32_t sample_count = 0;
+    for( uint32_t i = 0; i < cache->bitrate_count; i++ )
+        sample_count += cache->bitrate[i].sample_count;
+    if( sample_count != isom_get_sample_count_from_sample_table( stbl ) )
+        return NULL;
+    return sample_description_index <= cache->bitrate_count
+         ? &cache->bitrate[sample_description_index - 1]
+         : &no_sample;
+}
+
+static int isom_add_bitrate_statistics
+(
+    isom_trak_t *trak,
+    uint32_t     sample_description_index,
+    uint32_t     size,
+    uint64_t     dts
+)
+{
+    isom_cache_t *cache = trak->cache;
+    if( sample_description_index == 0 )
+        return LSMASH_ERR_INVALID_DATA;
+    if( sample_description_index > cache->bitrate_count )
+    {
+        isom_bitrate_t *bitrate = lsmash_realloc( cache->bitrate, sample_description_index * sizeof(isom_bitrate_t) );
+        if( !bitrate )
+            return LSMASH_ERR_MEMORY_ALLOC;
+        memset( bitrate + cache->bitrate_count, 0, (sample_description_index - cache->bitrate_count) * sizeof(isom_bitrate_t) );
+        cache->bitrate       = bitrate;
+        cache->bitrate_count = sample_description_index;
+    }
+    isom_bitrate_t *bitrate = &cache->bitrate[sample_description_index - 1];
+    if( bitrate->sample_count == 0 )
+        bitrate->first_dts = dts;
+    /* Measure in the same way as isom_calculate_bitrate_description(). */
+    dts -= bitrate->first_dts;
+    ++ bitrate->sample_count;
+    if( bitrate->bufferSizeDB < size )
+        bitrate->bufferSizeDB = size;
+    bitrate->total_size += size;
+    bitrate->rate       += size;
+    bitrate->last_dts    = dts;
+    if( dts > bitrate->window_dts + trak->mdia->mdhd->timescale )
+    {
+        if( bitrate->rate > bitrate->max_rate )
+            bitrate->max_rate = bitrate->rate;
+        bitrate->window_dts = dts;
+        bitrate->rate       = 0;
+    }
+    return 0;
+}
+
+/* Measure 'count' consecutive samples of the same size, one timescale unit apart from each other, at once. */
+static int isom_add_bitrate_statistics_run
+(
+    isom_trak_t *trak,
+    uint32_t     sample_description_index,
+    uint32_t     size,
+    uint64_t     dts,
+    uint32_t     count
+)
+{
+    int err = isom_add_bitrate_statistics( trak, sample_description_index, size, dts );
+    if( err < 0 )
+        return err;
+    isom_bitrate_t *bitrate   = &trak->cache->bitrate[sample_description_index - 1];
+    uint64_t        timescale = trak->mdia->mdhd->timescale;
+    uint64_t        rel_dts   = bitrate->last_dts;
+    uint32_t        remaining = count - 1;
+    while( remaining )
+    {
+        /* The samples until the end of the current window don't move the window. */
+        uint64_t window_end = bitrate->window_dts + timescale;
+        uint32_t n = rel_dts + 1 > window_end ? 1 : (uint32_t)LSMASH_MIN( (uint64_t)remaining, window_end - rel_dts );
+        rel_dts += n;
+        bitrate->sample_count += n;
+        bitrate->total_size   += (uint64_t)size * n;
+        bitrate->rate         += size * n;
+        bitrate->last_dts      = rel_dts;
+        if( rel_dts > window_end )
+        {
+            if( bitrate->rate > bitrate->max_rate )
+                bitrate->max_rate = bitrate->rate;
+            bitrate->window_dts = rel_dts;
+            bitrate->rate       = 0;
+        }
+        remaining -= n;
+    }
+    return 0;
+}
+
 int isom_calculate_bitrate_description
 (
     isom_stbl_t *stbl,
@@ -915,6 +1072,15 @@ int isom_calculate_bitrate_description
     uint32_t     sample_description_index
 )
 {
+    double duration = (double)mdhd->duration / mdhd->timescale;
+    /* Samples added in this session have been measured already, so no need to scan the sample tables. */
+    isom_bitrate_t *bitrate = isom_get_bitrate_statistics( ((isom_trak_t *)mdhd->parent->parent)->cache, stbl, sample_description_index );
+    if( bitrate )
+    {
+        *bufferSizeDB = bitrate->bufferSizeDB;
+        isom_convert_bitrate_description( duration, bitrate->total_size, bitrate->max_rate, maxBitrate, avgBitrate );
+        return 0;
+    }
     isom_stsz_t *stsz = stbl->stsz;
     lsmash_entry_list_t *stsz_list  = LSMASH_IS_EXISTING_BOX( stsz ) ? stsz->list : stbl->stz2->list;
     lsmash_entry_t *stsz_entry      = stsz_list ? stsz_list->head : NULL;
@@ -926,15 +1092,15 @@ int isom_calculate_bitrate_description
     if( next_stsc_entry && !next_stsc_entry->data )
         return LSMASH_ERR_INVALID_DATA;
     uint32_t rate                   = 0;
+    uint32_t max_rate               = 0;
+    uint64_t total_size             = 0;
     uint64_t dts                    = 0;
-    uint32_t time_wnd               = 0;
+    uint64_t time_wnd               = 0;
     uint32_t chunk_number           = 0;
     uint32_t sample_number_in_stts  = 1;
     uint32_t sample_number_in_chunk = 1;
     uint32_t constant_sample_size   = LSMASH_IS_EXISTING_BOX( stsz ) ? stsz->sample_size : 0;
     *bufferSizeDB = 0;
-    *maxBitrate   = 0;
-    *avgBitrate   = 0;
     while( stts_entry )
     {
         int err;
@@ -1035,23 +1201,17 @@ int isom_calculate_bitrate_description
         /* Calculate bitrate description. */
         if( *bufferSizeDB < size )
             *bufferSizeDB = size;
-        *avgBitrate += size;
-        rate += size;
+        total_size += size;
+        rate       += size;
         if( dts > time_wnd + mdhd->timescale )
         {
-            if( rate > *maxBitrate )
-                *maxBitrate = rate;
+            if( rate > max_rate )
+                max_rate = rate;
             time_wnd = dts;
             rate = 0;
         }
     }
-    double duration = (double)mdhd->duration / mdhd->timescale;
-    *avgBitrate = (uint32_t)(*avgBitrate / duration);
-    if( *maxBitrate == 0 )
-        *maxBitrate = *avgBitrate;
-    /* Convert to bits per second. */
-    *maxBitrate *= 8;
-    *avgBitrate *= 8;
+    isom_convert_bitrate_description( duration, total_size, max_rate, maxBitrate, avgBitrate );
     return 0;
 }
 
@@ -1714,7 +1874,54 @@ uint64_t lsmash_get_media_duration( lsmash_root_t *root, uint32_t track_ID )
     isom_trak_t *trak = isom_get_trak( root->file->initializer, track_ID );
     if( LSMASH_IS_NON_EXISTING_BOX( trak->mdia->mdhd ) )
         return 0;
-    return trak->mdia->mdhd->duration;
+    /* While muxing, the media duration is updated only at flushing, so follow the samples added after it.
+     * The last sample lasts as long as the last sample_delta in 'stts' until its duration is given. */
+    uint64_t       duration = trak->mdia->mdhd->duration;
+    isom_timing_t *timing   = isom_get_timing_statistics( trak );
+    isom_stts_t   *stts     = trak->mdia->minf->stbl->stts;
+    if( timing
+     && timing->sample_count
+     && stts->list
+     && stts->list->tail )
+        duration = LSMASH_MAX( duration, timing->last_dts + ((isom_stts_entry_t *)stts->list->tail->data)->sample_delta );
+    return duration;
+}
+
+int lsmash_get_bitrate( lsmash_root_t *root, uint32_t track_ID, uint32_t sample_description_index, lsmash_bitrate_t *bitrate )
+{
+    if( isom_check_initializer_present( root ) < 0
+     || sample_description_index == 0
+     || !bitrate )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    isom_trak_t *trak = isom_get_trak( root->file->initializer, track_ID );
+    isom_mdhd_t *mdhd = trak->mdia->mdhd;
+    isom_stbl_t *stbl = trak->mdia->minf->stbl;
+    if( LSMASH_IS_NON_EXISTING_BOX( mdhd )
+     || mdhd->timescale == 0
+     || sample_description_index > stbl->stsd->list.entry_count )
+        return LSMASH_ERR_NAMELESS;
+    isom_bitrate_t *stats = isom_get_bitrate_statistics( trak->cache, stbl, sample_description_index );
+    if( !stats )
+    {
+        if( mdhd->duration == 0
+         || !stbl->stts->list
+         || !stbl->stsc->list )
+            return LSMASH_ERR_NAMELESS;
+        return isom_calculate_bitrate_description( stbl, mdhd, &bitrate->bufferSizeDB, &bitrate->maxBitrate, &bitrate->avgBitrate,
+                                                   sample_description_index );
+    }
+    /* While muxing, the media duration is not updated yet, so use the span of the samples added so far. */
+    uint64_t duration = LSMASH_MAX( mdhd->duration, stats->last_dts );
+    bitrate->bufferSizeDB = stats->bufferSizeDB;
+    if( duration == 0 )
+    {
+        bitrate->maxBitrate = 8 * stats->max_rate;
+        bitrate->avgBitrate = 0;
+        return 0;
+    }
+    isom_convert_bitrate_description( (double)duration / mdhd->timescale, stats->total_size, stats->max_rate,
+                                      &bitrate->maxBitrate, &bitrate->avgBitrate );
+    return 0;
 }
 
 uint64_t lsmash_get_track_duration( lsmash_root_t *root, uint32_t track_ID )
@@ -2475,7 +2682,7 @@ int isom_establish_movie( lsmash_file_t *file )
     return 0;
 }
 
-int lsmash_finish_movie
+static int isom_finish_movie
 (
     lsmash_root_t        *root,
     lsmash_adhoc_remux_t *remux
@@ -2595,6 +2802,188 @@ fail:
     return err;
 }
 
+int lsmash_finish_movie
+(
+    lsmash_root_t        *root,
+    lsmash_adhoc_remux_t *remux
+)
+{
+    uint64_t start = lsmash_stats_begin_span( LSMASH_TRACE_SPAN_FINISH_MOVIE, NULL );
+    int ret = isom_finish_movie( root, remux );
+    lsmash_stats_end_span( LSMASH_TRACE_SPAN_FINISH_MOVIE, NULL, start );
+    return ret;
+}
+
+static int isom_read_top_level_box_header
+(
+    lsmash_bs_t *bs,
+    uint64_t     pos,
+    uint64_t     file_size,
+    uint64_t    *size,
+    uint32_t    *type
+)
+{
+    uint8_t buf[ISOM_BASEBOX_COMMON_SIZE + 8];
+    if( file_size - pos < ISOM_BASEBOX_COMMON_SIZE
+     || bs->seek( bs->stream, pos, SEEK_SET ) != (int64_t)pos
+     || bs->read( bs->stream, buf, ISOM_BASEBOX_COMMON_SIZE ) != ISOM_BASEBOX_COMMON_SIZE )
+        return LSMASH_ERR_NAMELESS;
+    *size = LSMASH_GET_BE32( &buf[0] );
+    *type = LSMASH_GET_BE32( &buf[4] );
+    if( *size == 0 )
+        *size = file_size - pos;    /* The box extends to the end of the file. */
+    else if( *size == 1 )
+    {
+        if( bs->read( bs->stream, &buf[8], 8 ) != 8 )
+            return LSMASH_ERR_NAMELESS;
+        *size = LSMASH_GET_BE64( &buf[8] );
+    }
+    if( *size < ISOM_BASEBOX_COMMON_SIZE
+     || *size > file_size - pos )
+        return LSMASH_ERR_INVALID_DATA;
+    return 0;
+}
+
+static int isom_write_bytes_at
+(
+    lsmash_bs_t *bs,
+    uint64_t     pos,
+    uint8_t     *data,
+    uint64_t     size
+)
+{
+    if( bs->seek( bs->stream, pos, SEEK_SET ) != (int64_t)pos )
+        return LSMASH_ERR_NAMELESS;
+    while( size )
+    {
+        int write_size = LSMASH_MIN( size, 1 << 30 );
+        if( bs->write( bs->stream, data, write_size ) != write_size )
+            return LSMASH_ERR_NAMELESS;
+        data += write_size;
+        size -= write_size;
+    }
+    return 0;
+}
+
+static int isom_put_free_space( lsmash_bs_t *bs, uint64_t pos, uint64_t size )
+{
+    uint8_t header[ISOM_BASEBOX_COMMON_SIZE + 8];
+    uint32_t header_size = ISOM_BASEBOX_COMMON_SIZE;
+    if( size > UINT32_MAX )
+    {
+        LSMASH_SET_BE32( &header[0], 1 );
+        LSMASH_SET_BE64( &header[8], size );
+        header_size += 8;
+    }
+    else
+        LSMASH_SET_BE32( &header[0], size );
+    LSMASH_SET_BE32( &header[4], ISOM_BOX_TYPE_FREE.fourcc );
+    return isom_write_bytes_at( bs, pos, header, header_size );
+}
+
+/* Check if a box can be placed into a space. Remaining space must be able to be a Free Space Box. */
+static inline int isom_check_box_fits_space( uint64_t box_size, uint64_t space )
+{
+    return box_size == space || box_size + ISOM_BASEBOX_COMMON_SIZE <= space;
+}
+
+static inline int isom_check_free_space_box( uint32_t type )
+{
+    return type == ISOM_BOX_TYPE_FREE.fourcc || type == ISOM_BOX_TYPE_SKIP.fourcc;
+}
+
+int lsmash_write_movie_in_place
+(
+    lsmash_root_t *root
+)
+{
+    if( isom_check_initializer_present( root ) < 0 )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    lsmash_file_t *file = root->file;
+    lsmash_bs_t   *bs   = file->bs;
+    isom_moov_t   *moov = file->moov;
+    if( file != file->initializer
+     || !(file->flags & LSMASH_FILE_MODE_READ)
+     ||  (file->flags & LSMASH_FILE_MODE_WRITE)
+     || !bs || !bs->read || !bs->write || !bs->seek
+     || LSMASH_IS_NON_EXISTING_BOX( moov ) )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    if( file->fragment || LSMASH_IS_EXISTING_BOX( moov->mvex ) )
+        return LSMASH_ERR_PATCH_WELCOME;
+    uint64_t old_pos  = moov->pos;
+    uint64_t old_size = moov->size;
+    int64_t  file_size = bs->seek( bs->stream, 0, SEEK_END );
+    if( file_size < 0 || old_pos + old_size > (uint64_t)file_size )
+        return LSMASH_ERR_NAMELESS;
+    /* Serialize the new Movie Box. */
+    if( isom_update_box_size( moov ) == 0 )
+        return LSMASH_ERR_INVALID_DATA;
+    lsmash_bs_t *moov_bs = lsmash_bs_create();
+    if( !moov_bs )
+        return LSMASH_ERR_MEMORY_ALLOC;
+    int err = isom_write_box( moov_bs, (isom_box_t *)moov );
+    if( err < 0 )
+        goto fail;
+    uint64_t new_size = moov_bs->buffer.store;
+    if( moov_bs->error || new_size != moov->size )
+    {
+        err = LSMASH_ERR_INVALID_DATA;
+        goto fail;
+    }
+    /* Decide where the new Movie Box is placed.
+     * First, try the old Movie Box and the following Free Space Boxes. */
+    uint64_t new_pos = file_size;
+    uint64_t space   = new_size;
+    uint64_t end     = old_pos + old_size;
+    uint64_t box_size;
+    uint32_t box_type;
+    while( end < (uint64_t)file_size
+        && isom_read_top_level_box_header( bs, end, file_size, &box_size, &box_type ) == 0
+        && isom_check_free_space_box( box_type ) )
+        end += box_size;
+    if( isom_check_box_fits_space( new_size, end - old_pos )
+     || (end == (uint64_t)file_size && new_size >= end - old_pos) )
+    {
+        new_pos = old_pos;
+        space   = LSMASH_MAX( new_size, end - old_pos );
+    }
+    else
+        /* Next, try any other Free Space Box at the top level. */
+        for( uint64_t pos = 0;
+             pos < (uint64_t)file_size
+          && isom_read_top_level_box_header( bs, pos, file_size, &box_size, &box_type ) == 0;
+             pos += box_size )
+            if( isom_check_free_space_box( box_type )
+             && (pos + box_size <= old_pos || pos >= end)
+             && isom_check_box_fits_space( new_size, box_size ) )
+            {
+                new_pos = pos;
+                space   = box_size;
+                break;
+            }
+    /* Otherwise, append the new Movie Box at the end of the file. */
+    if( (err = isom_write_bytes_at( bs, new_pos, moov_bs->buffer.data, new_size )) < 0 )
+        goto fail;
+    if( space > new_size
+     && (err = isom_put_free_space( bs, new_pos + new_size, space - new_size )) < 0 )
+        goto fail;
+    if( new_pos != old_pos )
+    {
+        /* Turn the old Movie Box into a Free Space Box. */
+        uint8_t type[4];
+        LSMASH_SET_BE32( &type[0], ISOM_BOX_TYPE_FREE.fourcc );
+        if( (err = isom_write_bytes_at( bs, old_pos + 4, type, 4 )) < 0 )
+            goto fail;
+    }
+    moov->pos = new_pos;
+    /* The buffered data for reading is no longer valid. */
+    lsmash_bs_empty( bs );
+    err = 0;
+fail:
+    lsmash_bs_cleanup( moov_bs );
+    return err;
+}
+
 int lsmash_set_last_sample_delta( lsmash_root_t *root, uint32_t track_ID, uint32_t sample_delta )
 {
     if( isom_check_initializer_present( root ) < 0 || track_ID == 0 )
@@ -2634,11 +3023,16 @@ int lsmash_set_last_sample_delta( lsmash_root_t *root, uint32_t track_ID, uint32
          * This duration is also the duration of the last sample. */
         if( (err = isom_add_stts_entry( stbl, sample_delta )) < 0 )
             return err;
+        ++ trak->cache->timing.delta_count;
         return lsmash_update_track_duration( root, track_ID, 0 );
     }
+    isom_timing_t *timing = isom_get_timing_statistics( trak );
     uint32_t i = 0;
-    for( lsmash_entry_t *entry = stts->list->head; entry; entry = entry->next )
-        i += ((isom_stts_entry_t *)entry->data)->sample_count;
+    if( timing )
+        i = timing->delta_count;
+    else
+        for( lsmash_entry_t *entry = stts->list->head; entry; entry = entry->next )
+            i += ((isom_stts_entry_t *)entry->data)->sample_count;
     if( sample_count < i )
         return LSMASH_ERR_INVALID_DATA;
     int no_last = (sample_count > i);
@@ -2683,6 +3077,7 @@ int lsmash_set_last_sample_delta( lsmash_root_t *root, uint32_t track_ID, uint32
             ++ last_stts_data->sample_count;
         else if( (err = isom_add_stts_entry( stbl, sample_delta )) < 0 )
             return err;
+        ++ trak->cache->timing.delta_count;
     }
     /* The duration of the last sample is already set. Replace it with a new one. */
     else if( (err = isom_replace_last_sample_delta( stbl, sample_delta )) < 0 )
@@ -2743,8 +3138,15 @@ int lsmash_create_explicit_timeline_map( lsmash_root_t *root, uint32_t track_ID,
                   : trak->tkhd->duration ? trak->tkhd->duration
                   : isom_update_tkhd_duration( trak ) < 0 ? 0
                   : trak->tkhd->duration;
-    if( (LSMASH_IS_NON_EXISTING_BOX( trak->edts )       && LSMASH_IS_BOX_ADDITION_FAILURE( isom_add_edts( trak ) ))
-     || (LSMASH_IS_NON_EXISTING_BOX( trak->edts->elst ) && LSMASH_IS_BOX_ADDITION_FAILURE( isom_add_elst( trak->edts ) )) )
+    if( LSMASH_IS_NON_EXISTING_BOX( trak->edts ) )
+    {
+        if( LSMASH_IS_BOX_ADDITION_FAILURE( isom_add_edts( trak ) ) )
+            return LSMASH_ERR_NAMELESS;
+        if( root->file->flags & LSMASH_FILE_MODE_READ )
+            isom_reorder_tail_box( (isom_box_t *)trak );
+    }
+    if( LSMASH_IS_NON_EXISTING_BOX( trak->edts->elst )
+     && LSMASH_IS_BOX_ADDITION_FAILURE( isom_add_elst( trak->edts ) ) )
         return LSMASH_ERR_NAMELESS;
     int err = isom_add_elst_entry( trak->edts->elst, edit.duration, edit.start_time, edit.rate );
     if( err < 0 )
@@ -2839,56 +3241,6 @@ int lsmash_update_movie_modification_time( lsmash_root_t *root )
 }
 
 /*---- sample manipulators ----*/
-lsmash_sample_t *lsmash_create_sample( uint32_t size )
-{
-    lsmash_sample_t *sample = lsmash_malloc_zero( sizeof(lsmash_sample_t) );
-    if( !sample )
-        return NULL;
-    if( size == 0 )
-        return sample;
-    sample->data = lsmash_malloc( size );
-    if( !sample->data )
-    {
-        lsmash_free( sample );
-        return NULL;
-    }
-    sample->length = size;
-    return sample;
-}
-
-int lsmash_sample_alloc( lsmash_sample_t *sample, uint32_t size )
-{
-    if( !sample )
-        return LSMASH_ERR_FUNCTION_PARAM;
-    if( size == 0 )
-    {
-        lsmash_free( sample->data );
-        sample->data   = NULL;
-        sample->length = 0;
-        return 0;
-    }
-    if( size == sample->length )
-        return 0;
-    uint8_t *data;
-    if( !sample->data )
-        data = lsmash_malloc( size );
-    else
-        data = lsmash_realloc( sample->data, size );
-    if( !data )
-        return LSMASH_ERR_MEMORY_ALLOC;
-    sample->data   = data;
-    sample->length = size;
-    return 0;
-}
-
-void lsmash_delete_sample( lsmash_sample_t *sample )
-{
-    if( !sample )
-        return;
-    lsmash_free( sample->data );
-    lsmash_free( sample );
-}
-
 isom_sample_pool_t *isom_create_sample_pool( uint64_t size )
 {
     isom_sample_pool_t *pool = lsmash_malloc_zero( sizeof(isom_sample_pool_t) );
@@ -3026,6 +3378,32 @@ void isom_update_cache_timestamp
     }
 }
 
+static void isom_add_timing_statistics( isom_timing_t *timing, uint64_t stts_dts, int64_t sample_offset, int non_output_sample )
+{
+    if( timing->sample_count++ == 0 )
+    {
+        timing->min_cts    = INT64_MAX;
+        timing->max_cts    = INT64_MIN;
+        timing->max2_cts   = INT64_MIN;
+        timing->min_offset = UINT32_MAX;
+        timing->max_offset = 0;
+    }
+    timing->last_dts = stts_dts;
+    if( non_output_sample )
+        return;
+    int64_t stts_cts = (int64_t)stts_dts + sample_offset;
+    timing->min_offset = LSMASH_MIN( timing->min_offset, sample_offset );
+    timing->max_offset = LSMASH_MAX( timing->max_offset, sample_offset );
+    timing->min_cts    = LSMASH_MIN( timing->min_cts, stts_cts );
+    if( timing->max_cts < stts_cts )
+    {
+        timing->max2_cts = timing->max_cts;
+        timing->max_cts  = stts_cts;
+    }
+    else if( timing->max2_cts < stts_cts )
+        timing->max2_cts = stts_cts;
+}
+
 static int isom_add_timestamp( isom_stbl_t *stbl, isom_cache_t *cache, lsmash_file_t *file, uint64_t dts, uint64_t cts )
 {
     if( !cache || !stbl->stts->list )
@@ -3035,9 +3413,18 @@ static int isom_add_timestamp( isom_stbl_t *stbl, isom_cache_t *cache, lsmash_fi
     if( err < 0 )
         return err;
     uint32_t sample_count = isom_get_sample_count_from_sample_table( stbl );
+    /* Measure the DTS accumulated from 'stts' as the media duration is calculated from it.
+     * The first sample is at 0, and each sample is after the sample_delta of the previous one.
+     * If the previous sample has it already, the sample_delta added below is of this sample. */
+    isom_timing_t *timing = &cache->timing;
+    uint64_t stts_dts = timing->last_dts;
+    if( timing->delta_count == timing->sample_count && stbl->stts->list->tail )
+        stts_dts += ((isom_stts_entry_t *)stbl->stts->list->tail->data)->sample_delta;
     uint32_t sample_delta = sample_count > 1 ? isom_add_dts( stbl, dts, cache->timestamp.dts ) : 0;
     if( sample_count > 1 && sample_delta == 0 )
         return LSMASH_ERR_INVALID_DATA;
+    if( sample_count > 1 && timing->delta_count++ < timing->sample_count )
+        stts_dts += sample_delta;
     if( (err = isom_add_cts( stbl, dts, cts, non_output_sample )) < 0 )
         return err;
     int32_t ctd_shift = cache->timestamp.ctd_shift;
@@ -3052,6 +3439,7 @@ static int isom_add_timestamp( isom_stbl_t *stbl, isom_cache_t *cache, lsmash_fi
         ctd_shift = dts - cts;
     }
     isom_update_cache_timestamp( cache, dts, cts, ctd_shift, sample_delta, non_output_sample );
+    isom_add_timing_statistics( timing, stts_dts, cts >= dts ? (int64_t)(cts - dts) : -(int64_t)(dts - cts), non_output_sample );
     return 0;
 }
 
@@ -3614,18 +4002,18 @@ static int isom_update_chunk_tables
 (
     isom_stbl_t   *stbl,
     lsmash_file_t *media_file,
-    isom_chunk_t  *current
+    uint32_t       chunk_number,
+    uint32_t       samples_per_chunk,
+    uint32_t       sample_description_index
 )
 {
     isom_stsc_entry_t *last_stsc_data = stbl->stsc->list->tail ? (isom_stsc_entry_t *)stbl->stsc->list->tail->data : NULL;
     /* Create a new chunk sequence in this track if needed. */
     int err;
     if( (!last_stsc_data
-      || current->pool->sample_count       != last_stsc_data->samples_per_chunk
-      || current->sample_description_index != last_stsc_data->sample_description_index)
-     && (err = isom_add_stsc_entry( stbl, current->chunk_number,
-                                          current->pool->sample_count,
-                                          current->sample_description_index )) < 0 )
+      || samples_per_chunk        != last_stsc_data->samples_per_chunk
+      || sample_description_index != last_stsc_data->sample_description_index)
+     && (err = isom_add_stsc_entry( stbl, chunk_number, samples_per_chunk, sample_description_index )) < 0 )
         return err;
     /* Add a new chunk offset in this track. */
     uint64_t offset = media_file->size;
@@ -3677,7 +4065,8 @@ static int isom_add_sample_to_chunk
         return 0;   /* No need to flush current cached chunk, the current sample must be put into that. */
     /* NOTE: chunk relative stuff must be pushed into file after a chunk is fully determined with its contents.
      * Now the current cached chunk is fixed, actually add the chunk relative properties to its file accordingly. */
-    int err = isom_update_chunk_tables( trak->mdia->minf->stbl, media_file, current );
+    int err = isom_update_chunk_tables( trak->mdia->minf->stbl, media_file, current->chunk_number,
+                                        current->pool->sample_count, current->sample_description_index );
     if( err < 0 )
         return err;
     /* Update and re-initialize cache, using the current sample */
@@ -3697,18 +4086,55 @@ static int isom_write_pooled_samples( lsmash_file_t *file, isom_sample_pool_t *p
      || !(file->flags & LSMASH_FILE_MODE_MEDIA)
      || ((file->flags & LSMASH_FILE_MODE_BOX) && LSMASH_IS_NON_EXISTING_BOX( file->mdat )) )
         return LSMASH_ERR_INVALID_DATA;
-    lsmash_bs_put_bytes( file->bs, pool->size, pool->data );
-    int err = lsmash_bs_flush_buffer( file->bs );
-    if( err < 0 )
+    int err;
+    if( (err = isom_put_pooled_samples( file->bs, pool )) < 0
+     || (err = lsmash_bs_flush_buffer( file->bs ))        < 0 )
         return err;
     if( LSMASH_IS_EXISTING_BOX( file->mdat ) )
         file->mdat->media_size += pool->size;
     file->size += pool->size;
     pool->sample_count = 0;
     pool->size         = 0;
+    pool->size_only    = 0;
     return 0;
 }
 
+/* Add the entries for a sample except for the chunk it belongs to. The sample data is not referenced. */
+static int isom_add_sample_to_tables
+(
+    isom_trak_t     *trak,
+    lsmash_sample_t *sample
+)
+{
+    int err;
+    isom_stbl_t *stbl = trak->mdia->minf->stbl;
+    /* Add a sample_size and increment sample_count. */
+    uint32_t sample_count = isom_add_size( stbl, sample->length );
+    if( sample_count == 0 )
+        return LSMASH_ERR_NAMELESS;
+    /* Add a decoding timestamp and a composition timestamp. */
+    if( (err = isom_add_timestamp( stbl, trak->cache, trak->file, sample->dts, sample->cts )) < 0 )
+        return err;
+    /* Measure the bitrate. */
+    if( (err = isom_add_bitrate_statistics( trak, sample->index, sample->length, sample->dts )) < 0 )
+        return err;
+    /* Add a sync point if needed. */
+    if( (err = isom_add_sync_point( stbl, trak->cache, sample_count, &sample->prop )) < 0 )
+        return err;
+    /* Add a partial sync point if needed. */
+    if( (err = isom_add_partial_sync( stbl, trak->file, sample_count, &sample->prop )) < 0 )
+        return err;
+    /* Add leading, independent, disposable and redundant information if needed. */
+    if( stbl->add_dependency_type
+     && (err = stbl->add_dependency_type( stbl, trak->file, &sample->prop )) < 0 )
+        return err;
+    /* Group samples into random access point type if needed. */
+    if( (err = isom_group_random_access( (isom_box_t *)stbl, trak->cache, sample )) < 0 )
+        return err;
+    /* Group samples into random access recovery point type if needed. */
+    return isom_group_roll_recovery( (isom_box_t *)stbl, trak->cache, sample );
+}
+
 int isom_update_sample_tables
 (
     isom_trak_t         *trak,
@@ -3739,7 +4165,8 @@ int isom_update_sample_tables
             if( sample_count == 0 )
                 return LSMASH_ERR_NAMELESS;
             /* Add a decoding timestamp and a composition timestamp. */
-            if( (err = isom_add_timestamp( stbl, trak->cache, trak->file, sample_dts, sample_cts )) < 0 )
+            if( (err = isom_add_timestamp( stbl, trak->cache, trak->file, sample_dts, sample_cts )) < 0
+             || (err = isom_add_bitrate_statistics( trak, sample->index, 1, sample_dts )) < 0 )
                 return err;
             sample_dts += sample_duration;
             sample_cts += sample_duration;
@@ -3748,29 +4175,7 @@ int isom_update_sample_tables
     }
     else
     {
-        isom_stbl_t *stbl = trak->mdia->minf->stbl;
-        /* Add a sample_size and increment sample_count. */
-        uint32_t sample_count = isom_add_size( stbl, sample->length );
-        if( sample_count == 0 )
-            return LSMASH_ERR_NAMELESS;
-        /* Add a decoding timestamp and a composition timestamp. */
-        if( (err = isom_add_timestamp( stbl, trak->cache, trak->file, sample->dts, sample->cts )) < 0 )
-            return err;
-        /* Add a sync point if needed. */
-        if( (err = isom_add_sync_point( stbl, trak->cache, sample_count, &sample->prop )) < 0 )
-            return err;
-        /* Add a partial sync point if needed. */
-        if( (err = isom_add_partial_sync( stbl, trak->file, sample_count, &sample->prop )) < 0 )
-            return err;
-        /* Add leading, independent, disposable and redundant information if needed. */
-        if( stbl->add_dependency_type
-         && (err = stbl->add_dependency_type( stbl, trak->file, &sample->prop )) < 0 )
-            return err;
-        /* Group samples into random access point type if needed. */
-        if( (err = isom_group_random_access( (isom_box_t *)stbl, trak->cache, sample )) < 0 )
-            return err;
-        /* Group samples into random access recovery point type if needed. */
-        if( (err = isom_group_roll_recovery( (isom_box_t *)stbl, trak->cache, sample )) < 0 )
+        if( (err = isom_add_sample_to_tables( trak, sample )) < 0 )
             return err;
         *samples_per_packet = 1;
     }
@@ -3810,6 +4215,16 @@ static int isom_output_cached_chunk( isom_trak_t *trak )
 int isom_pool_sample( isom_sample_pool_t *pool, lsmash_sample_t *sample, uint32_t samples_per_packet )
 {
     uint64_t pool_size = pool->size + sample->length;
+    lsmash_stats_add( LSMASH_STATS_SAMPLES_POOLED, samples_per_packet );
+    if( !sample->data || pool->size_only )
+    {
+        /* A sample without data, allowed only to estimate the output, makes the pool keep the size alone. */
+        pool->size_only     = 1;
+        pool->size          = pool_size;
+        pool->sample_count += samples_per_packet;
+        lsmash_delete_sample( sample );
+        return 0;
+    }
     if( pool->alloc < pool_size )
     {
         uint8_t *data;
@@ -3830,34 +4245,32 @@ int isom_pool_sample( isom_sample_pool_t *pool, lsmash_sample_t *sample, uint32_
     return 0;
 }
 
-static int isom_append_sample_internal
-(
-    isom_trak_t         *trak,
-    lsmash_sample_t     *sample,
-    isom_sample_entry_t *sample_entry
-)
+int isom_put_pooled_samples( lsmash_bs_t *bs, isom_sample_pool_t *pool )
 {
-    uint32_t samples_per_packet;
-    int ret = isom_update_sample_tables( trak, sample, &samples_per_packet, sample_entry );
-    if( ret < 0 )
-        return ret;
-    /* ret == 1 means pooled samples must be flushed. */
-    isom_sample_pool_t *current_pool = trak->cache->chunk.pool;
-    if( ret == 1 )
+    lsmash_stats_add( LSMASH_STATS_SAMPLES_FLUSHED, pool->sample_count );
+    if( !pool->size_only )
     {
-        /* The sample_description_index in the cache is one of the next written chunk.
-         * Therefore, it cannot be referenced here. */
-        lsmash_entry_list_t *stsc_list      = trak->mdia->minf->stbl->stsc->list;
-        isom_stsc_entry_t   *last_stsc_data = (isom_stsc_entry_t *)stsc_list->tail->data;
-        lsmash_file_t       *file           = isom_get_written_media_file( trak, last_stsc_data->sample_description_index );
-        if( (ret = isom_write_pooled_samples( file, current_pool )) < 0 )
-            return ret;
+        lsmash_bs_put_bytes( bs, pool->size, pool->data );
+        return 0;
     }
-    /* Arbitration system between tracks with extremely scattering dts.
-     * Here, we check whether asynchronization between the tracks exceeds the tolerance.
-     * If a track has too old "first DTS" in its cached chunk than current sample's DTS, then its pooled samples must be flushed.
-     * We don't consider presentation of media since any edit can pick an arbitrary portion of media in track.
-     * Note: you needn't read this loop until you grasp the basic handling of chunks. */
+    if( !isom_is_estimation_stream( bs ) )
+        return LSMASH_ERR_INVALID_DATA;
+    return lsmash_bs_write_void( bs, pool->size );
+}
+
+/* Arbitration system between tracks with extremely scattering dts.
+ * Here, we check whether asynchronization between the tracks exceeds the tolerance.
+ * If a track has too old "first DTS" in its cached chunk than current sample's DTS, then its pooled samples must be flushed.
+ * We don't consider presentation of media since any edit can pick an arbitrary portion of media in track.
+ * If 'check_only' is set, return 1 if any cached chunk would be flushed, otherwise 0, without flushing.
+ * Note: you needn't read this function until you grasp the basic handling of chunks. */
+static int isom_arbitrate_cached_chunks
+(
+    isom_trak_t *trak,
+    uint64_t     dts,
+    int          check_only
+)
+{
     lsmash_file_t *file = trak->file;
     double tolerance = file->max_async_tolerance;
     for( lsmash_entry_t *entry = file->moov->trak_list.head; entry; entry = entry->next )
@@ -3874,10 +4287,16 @@ static int isom_append_sample_internal
         isom_chunk_t *chunk = &other->cache->chunk;
         if( !chunk->pool || chunk->pool->sample_count == 0 )
             continue;
-        double diff = ((double)sample->dts      /  trak->mdia->mdhd->timescale)
+        double diff = ((double)dts              /  trak->mdia->mdhd->timescale)
                     - ((double)chunk->first_dts / other->mdia->mdhd->timescale);
-        if( diff > tolerance && (ret = isom_output_cached_chunk( other )) < 0 )
-            return ret;
+        if( diff > tolerance )
+        {
+            if( check_only )
+                return 1;
+            int err = isom_output_cached_chunk( other );
+            if( err < 0 )
+                return err;
+        }
         /* Note: we don't flush the cached chunk in the current track and the current sample here
          * even if the conditional expression of '-diff > tolerance' meets.
          * That's useless because appending a sample to another track would be a good equivalent.
@@ -3887,10 +4306,264 @@ static int isom_append_sample_internal
          * To completely avoid this, we need to observe at least whether the current sample will be placed
          * right next to the previous chunk of the same track or not. */
     }
+    return 0;
+}
+
+static int isom_append_sample_internal
+(
+    isom_trak_t         *trak,
+    lsmash_sample_t     *sample,
+    isom_sample_entry_t *sample_entry
+)
+{
+    uint32_t samples_per_packet;
+    int ret = isom_update_sample_tables( trak, sample, &samples_per_packet, sample_entry );
+    if( ret < 0 )
+        return ret;
+    /* ret == 1 means pooled samples must be flushed. */
+    isom_sample_pool_t *current_pool = trak->cache->chunk.pool;
+    if( ret == 1 )
+    {
+        /* The sample_description_index in the cache is one of the next written chunk.
+         * Therefore, it cannot be referenced here. */
+        lsmash_entry_list_t *stsc_list      = trak->mdia->minf->stbl->stsc->list;
+        isom_stsc_entry_t   *last_stsc_data = (isom_stsc_entry_t *)stsc_list->tail->data;
+        lsmash_file_t       *file           = isom_get_written_media_file( trak, last_stsc_data->sample_description_index );
+        if( (ret = isom_write_pooled_samples( file, current_pool )) < 0 )
+            return ret;
+    }
+    if( (ret = isom_arbitrate_cached_chunks( trak, sample->dts, 0 )) < 0 )
+        return ret;
     /* anyway the current sample must be pooled. */
     return isom_pool_sample( current_pool, sample, samples_per_packet );
 }
 
+/* Get the number of the LPCMFrames, from the first one of 'count' frames starting at 'dts', that can be appended at once
+ * to the current chunk by isom_append_lpcm_frame_run(), i.e. giving the same result as appending each of them
+ * by isom_append_sample_internal().
+ * Return 0 if the next frame must be appended individually, e.g. it starts a new chunk or changes the sample tables. */
+static uint32_t isom_get_lpcm_frame_run_length
+(
+    isom_trak_t         *trak,
+    lsmash_sample_t     *sample,
+    isom_audio_entry_t  *audio,
+    uint64_t             dts,
+    uint32_t             count,
+    uint32_t            *entry_size
+)
+{
+    isom_stbl_t  *stbl  = trak->mdia->minf->stbl;
+    isom_cache_t *cache = trak->cache;
+    isom_chunk_t *chunk = &cache->chunk;
+    isom_stsz_t  *stsz  = stbl->stsz;
+    /* Each frame shall be put into the current chunk. */
+    if( !chunk->pool
+     || chunk->pool->sample_count == 0
+     || chunk->sample_description_index != sample->index
+     || dts < chunk->first_dts )
+        return 0;
+    /* The sample tables shall be extended by just increasing the counts. */
+    isom_timing_t *timing = &cache->timing;
+    if( LSMASH_IS_NON_EXISTING_BOX( stsz )
+     || stsz->list
+     || stsz->sample_count == 0
+     || !stbl->stts->list
+     || !stbl->stts->list->tail
+     || ((isom_stts_entry_t *)stbl->stts->list->tail->data)->sample_delta != 1
+     || LSMASH_IS_EXISTING_BOX( stbl->ctts )
+     || sample->cts != sample->dts
+     || cache->timestamp.dts + 1 != dts
+     || cache->timestamp.ctd_shift < 0
+     || timing->sample_count == 0
+     || timing->delta_count + 1 != timing->sample_count
+     || timing->max_cts > (int64_t)timing->last_dts
+     || cache->bitrate_count < sample->index
+     || cache->bitrate[sample->index - 1].sample_count == 0 )
+        return 0;
+    if( (audio->manager & LSMASH_AUDIO_DESCRIPTION)
+     && (audio->manager & LSMASH_QTFF_BASE)
+     && (audio->version == 1)
+     && (audio->compression_ID != QT_AUDIO_COMPRESSION_ID_VARIABLE_COMPRESSION) )
+    {
+        /* Each frame is described as a single uncompressed sample, see isom_update_sample_tables(). */
+        if( audio->samplesPerPacket != 1
+         || (audio->samplerate >> 16) == 0
+         || trak->mdia->mdhd->timescale / (audio->samplerate >> 16) != 1 )
+            return 0;
+        *entry_size = 1;
+    }
+    else
+    {
+        /* Each frame shall be a sync sample without any additional description. */
+        lsmash_sample_property_t *prop = &sample->prop;
+        if( !(prop->ra_flags & ISOM_SAMPLE_RANDOM_ACCESS_FLAG_SYNC)
+         || (prop->ra_flags & QT_SAMPLE_RANDOM_ACCESS_FLAG_PARTIAL_SYNC)
+         || !cache->all_sync
+         || (stbl->add_dependency_type
+          && (LSMASH_IS_EXISTING_BOX( stbl->sdtp )
+           || prop->allow_earlier || prop->leading || prop->independent || prop->disposable || prop->redundant))
+         || stbl->sbgp_list.entry_count )
+            return 0;
+        *entry_size = audio->constBytesPerAudioPacket;
+    }
+    if( stsz->sample_size != *entry_size )
+        return 0;
+    /* Limit the frames by the chunk size. */
+    uint32_t       frame_size = audio->constBytesPerAudioPacket;
+    lsmash_file_t *media_file = isom_get_written_media_file( trak, chunk->sample_description_index );
+    if( media_file->max_chunk_size < chunk->pool->size + frame_size )
+        return 0;
+    count = LSMASH_MIN( count, (media_file->max_chunk_size - chunk->pool->size) / frame_size );
+    /* Limit the frames by the chunk duration.
+     * The condition is monotonic over the frames, so search the last frame meeting it. */
+    double   timescale = trak->mdia->mdhd->timescale;
+    uint32_t lo = 0;
+    uint32_t hi = count;
+    while( lo < hi )
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if( media_file->max_chunk_duration >= ((double)(dts + mid - chunk->first_dts) / timescale) )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* Append 'count' LPCMFrames from 'data' to the current chunk at once. */
+static int isom_append_lpcm_frame_run
+(
+    isom_trak_t     *trak,
+    lsmash_sample_t *sample,
+    uint8_t         *data,
+    uint32_t         frame_size,
+    uint32_t         entry_size,
+    uint64_t         dts,
+    uint32_t         count
+)
+{
+    isom_stbl_t  *stbl  = trak->mdia->minf->stbl;
+    isom_cache_t *cache = trak->cache;
+    /* Extend the sample tables. */
+    int err = isom_add_bitrate_statistics_run( trak, sample->index, entry_size, dts, count );
+    if( err < 0 )
+        return err;
+    stbl->stsz->sample_count += count;
+    ((isom_stts_entry_t *)stbl->stts->list->tail->data)->sample_count += count;
+    isom_timing_t *timing = &cache->timing;
+    int64_t first_cts = (int64_t)timing->last_dts + 1;
+    timing->sample_count += count;
+    timing->delta_count  += count;
+    timing->last_dts     += count;
+    timing->min_offset    = LSMASH_MIN( timing->min_offset, 0 );
+    timing->max_offset    = LSMASH_MAX( timing->max_offset, 0 );
+    timing->min_cts       = LSMASH_MIN( timing->min_cts, first_cts );
+    timing->max2_cts      = count > 1 ? (int64_t)timing->last_dts - 1 : timing->max_cts;
+    timing->max_cts       = (int64_t)timing->last_dts;
+    isom_update_cache_timestamp( cache, dts + count - 1, dts + count - 1, cache->timestamp.ctd_shift, 1, 0 );
+    /* Flush the cached chunks of the other tracks in the same order as appending each frame.
+     * The arbitration is monotonic over the frames, so search the first frame requiring any flush. */
+    uint32_t start = 0;
+    while( start < count )
+    {
+        if( (err = isom_arbitrate_cached_chunks( trak, dts + count - 1, 1 )) <= 0 )
+        {
+            if( err < 0 )
+                return err;
+            break;
+        }
+        uint32_t lo = start;
+        uint32_t hi = count - 1;
+        while( lo < hi )
+        {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if( (err = isom_arbitrate_cached_chunks( trak, dts + mid, 1 )) < 0 )
+                return err;
+            if( err )
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        if( (err = isom_arbitrate_cached_chunks( trak, dts + lo, 0 )) < 0 )
+            return err;
+        start = lo + 1;
+    }
+    /* Pool the frames with a single copy. */
+    isom_sample_pool_t *pool = cache->chunk.pool;
+    uint64_t pool_size = pool->size + (uint64_t)frame_size * count;
+    lsmash_stats_add( LSMASH_STATS_SAMPLES_POOLED, count );
+    if( data && !pool->size_only )
+    {
+        if( pool->alloc < pool_size )
+        {
+            uint64_t alloc = pool_size + (1<<16);
+            uint8_t *pool_data = lsmash_realloc( pool->data, alloc );
+            if( !pool_data )
+                return LSMASH_ERR_MEMORY_ALLOC;
+            pool->data  = pool_data;
+            pool->alloc = alloc;
+        }
+        memcpy( pool->data + pool->size, data, (uint64_t)frame_size * count );
+    }
+    else
+        pool->size_only = 1;
+    pool->size          = pool_size;
+    pool->sample_count += count;
+    return 0;
+}
+
+/* Append a sample consisting of multiple LPCMFrames.
+ * Each frame is a sample in the sample tables, but the frames within a chunk are recorded by runs instead of one by one. */
+static int isom_append_lpcm_frames
+(
+    isom_trak_t         *trak,
+    lsmash_sample_t     *sample,
+    isom_sample_entry_t *sample_entry
+)
+{
+    isom_audio_entry_t *audio = (isom_audio_entry_t *)sample_entry;
+    uint32_t frame_size = audio->constBytesPerAudioPacket;
+    if( frame_size == 0 || sample->length % frame_size )
+        return LSMASH_ERR_INVALID_DATA;
+    uint32_t frame_count = sample->length / frame_size;
+    uint64_t dts = sample->dts;
+    for( uint32_t i = 0; i < frame_count; )
+    {
+        uint8_t *data = sample->data ? sample->data + (uint64_t)i * frame_size : NULL;
+        uint32_t entry_size;
+        uint32_t run  = isom_get_lpcm_frame_run_length( trak, sample, audio, dts + i, frame_count - i, &entry_size );
+        if( run )
+        {
+            int err = isom_append_lpcm_frame_run( trak, sample, data, frame_size, entry_size, dts + i, run );
+            if( err < 0 )
+                return err;
+            i += run;
+            continue;
+        }
+        /* Append the next frame individually. */
+        lsmash_sample_t *lpcm_sample = lsmash_create_sample( data ? frame_size : 0 );
+        if( !lpcm_sample )
+            return LSMASH_ERR_MEMORY_ALLOC;
+        if( data )
+            memcpy( lpcm_sample->data, data, frame_size );
+        else
+            lpcm_sample->length = frame_size;
+        lpcm_sample->dts   = dts + i;
+        lpcm_sample->cts   = sample->cts + i;
+        lpcm_sample->prop  = sample->prop;
+        lpcm_sample->index = sample->index;
+        int err = isom_append_sample_internal( trak, lpcm_sample, sample_entry );
+        if( err < 0 )
+        {
+            lsmash_delete_sample( lpcm_sample );
+            return err;
+        }
+        ++i;
+    }
+    lsmash_delete_sample( sample );
+    return 0;
+}
+
 int isom_append_sample_by_type
 (
     void                *track,
@@ -3911,10 +4584,13 @@ int isom_append_sample_by_type
         uint64_t cts = sample->cts;
         for( uint32_t offset = 0; offset < sample->length; offset += frame_size )
         {
-            lsmash_sample_t *lpcm_sample = lsmash_create_sample( frame_size );
+            lsmash_sample_t *lpcm_sample = lsmash_create_sample( sample->data ? frame_size : 0 );
             if( !lpcm_sample )
                 return LSMASH_ERR_MEMORY_ALLOC;
-            memcpy( lpcm_sample->data, sample->data + offset, frame_size );
+            if( sample->data )
+                memcpy( lpcm_sample->data, sample->data + offset, frame_size );
+            else
+                lpcm_sample->length = frame_size;
             lpcm_sample->dts   = dts++;
             lpcm_sample->cts   = cts++;
             lpcm_sample->prop  = sample->prop;
@@ -3929,8 +4605,9 @@ int isom_append_sample_by_type
         lsmash_delete_sample( sample );
         return 0;
     }
-    else if( lsmash_check_codec_type_identical( sample_entry->type, ISOM_CODEC_TYPE_RTP_HINT  )
-          || lsmash_check_codec_type_identical( sample_entry->type, ISOM_CODEC_TYPE_RRTP_HINT ) )
+    else if( sample->data
+          && (lsmash_check_codec_type_identical( sample_entry->type, ISOM_CODEC_TYPE_RTP_HINT  )
+           || lsmash_check_codec_type_identical( sample_entry->type, ISOM_CODEC_TYPE_RRTP_HINT )) )
     {
         /* calculate PDU statistics for hmhd box. 
          * It requires accessing sample data to get the number of packets per sample. */
@@ -3957,27 +4634,39 @@ int isom_append_sample_by_type
     return func_append_sample( track, sample, sample_entry );
 }
 
-/* This function is for non-fragmented movie. */
-static int isom_append_sample
-(
-    lsmash_file_t       *file,
-    isom_trak_t         *trak,
-    lsmash_sample_t     *sample,
-    isom_sample_entry_t *sample_entry
-)
+/* If there is no available Media Data Box to write samples, add and write a new one before any chunk offset is decided. */
+static int isom_prepare_media_data_box( lsmash_file_t *file )
 {
-    /* If there is no available Media Data Box to write samples, add and write a new one before any chunk offset is decided. */
-    int err;
     int mdat_absent = LSMASH_IS_NON_EXISTING_BOX( file->mdat );
     if( mdat_absent || !(file->mdat->manager & LSMASH_INCOMPLETE_BOX) )
     {
         if( mdat_absent && LSMASH_IS_BOX_ADDITION_FAILURE( isom_add_mdat( file ) ) )
             return LSMASH_ERR_NAMELESS;
         file->mdat->manager |= LSMASH_PLACEHOLDER;
-        if( (err = isom_write_box( file->bs, (isom_box_t *)file->mdat )) < 0 )
+        int err = isom_write_box( file->bs, (isom_box_t *)file->mdat );
+        if( err < 0 )
             return err;
         file->size += file->mdat->size;
     }
+    return 0;
+}
+
+/* This function is for non-fragmented movie. */
+static int isom_append_sample
+(
+    lsmash_file_t       *file,
+    isom_trak_t         *trak,
+    lsmash_sample_t     *sample,
+    isom_sample_entry_t *sample_entry
+)
+{
+    int err = isom_prepare_media_data_box( file );
+    if( err < 0 )
+        return err;
+    if( isom_is_lpcm_audio( sample_entry )
+     && sample->length > ((isom_audio_entry_t *)sample_entry)->constBytesPerAudioPacket
+     && sample->cts != LSMASH_TIMESTAMP_UNDEFINED )
+        return isom_append_lpcm_frames( trak, sample, sample_entry );
     return isom_append_sample_by_type( trak, sample, sample_entry, (int (*)( void *, lsmash_sample_t *, isom_sample_entry_t * ))isom_append_sample_internal );
 }
 
@@ -4055,15 +4744,32 @@ int lsmash_flush_pooled_samples( lsmash_root_t *root, uint32_t track_ID, uint32_
     return lsmash_set_last_sample_delta( root, track_ID, last_sample_delta );
 }
 
+/* Write File Type Box here if it was not written yet. */
+static int isom_write_pending_ftyp( lsmash_file_t *file )
+{
+    if( (file->flags & LSMASH_FILE_MODE_INITIALIZATION)
+     && LSMASH_IS_EXISTING_BOX( file->ftyp )
+     && !(file->ftyp->manager & LSMASH_WRITTEN_BOX) )
+    {
+        int err = isom_write_box( file->bs, (isom_box_t *)file->ftyp );
+        if( err < 0 )
+            return err;
+        file->size += file->ftyp->size;
+    }
+    return 0;
+}
+
 int lsmash_append_sample( lsmash_root_t *root, uint32_t track_ID, lsmash_sample_t *sample )
 {
     if( isom_check_initializer_present( root ) < 0
      || track_ID     == 0
      || sample       == NULL
-     || sample->data == NULL
      || sample->dts  == LSMASH_TIMESTAMP_UNDEFINED )
         return LSMASH_ERR_FUNCTION_PARAM;
     lsmash_file_t *file = root->file;
+    /* Only the size of sample is needed to estimate the output. */
+    if( !sample->data && !isom_is_estimation_stream( file->bs ) )
+        return LSMASH_ERR_FUNCTION_PARAM;
     /* We think max_chunk_duration == 0, which means all samples will be cached on memory, should be prevented.
      * This means removal of a feature that we used to have, but anyway very alone chunk does not make sense. */
     if( !file->bs
@@ -4071,17 +4777,9 @@ int lsmash_append_sample( lsmash_root_t *root, uint32_t track_ID, lsmash_sample_
      || file->max_chunk_duration  == 0
      || file->max_async_tolerance == 0 )
         return LSMASH_ERR_NAMELESS;
-    /* Write File Type Box here if it was not written yet. */
-    if( file->flags & LSMASH_FILE_MODE_INITIALIZATION )
-    {
-        if( LSMASH_IS_EXISTING_BOX( file->ftyp ) && !(file->ftyp->manager & LSMASH_WRITTEN_BOX) )
-        {
-            int err = isom_write_box( file->bs, (isom_box_t *)file->ftyp );
-            if( err < 0 )
-                return err;
-            file->size += file->ftyp->size;
-        }
-    }
+    int err = isom_write_pending_ftyp( file );
+    if( err < 0 )
+        return err;
     /* Get a sample initializer. */
     isom_trak_t *trak = isom_get_trak( file->initializer, track_ID );
     if( LSMASH_IS_NON_EXISTING_BOX( trak->file )
@@ -4103,6 +4801,141 @@ int lsmash_append_sample( lsmash_root_t *root, uint32_t track_ID, lsmash_sample_
     return isom_append_sample( file, trak, sample, sample_entry );
 }
 
+/* Check the timestamps of the samples to be appended in the same way as isom_add_timestamp() does. */
+static int isom_check_appended_timestamps( isom_trak_t *trak, lsmash_sample_t *samples, uint32_t count )
+{
+    int      has_prev = isom_get_sample_count_from_sample_table( trak->mdia->minf->stbl ) > 0;
+    uint64_t prev_dts = trak->cache->timestamp.dts;
+    for( uint32_t i = 0; i < count; i++ )
+    {
+        uint64_t dts = samples[i].dts;
+        uint64_t cts = samples[i].cts;
+        int non_output_sample = (cts == LSMASH_TIMESTAMP_UNDEFINED);
+        int err = isom_check_sample_offset_compatibility( trak->file, dts, cts, non_output_sample );
+        if( err < 0 )
+            return err;
+        if( (has_prev && dts <= prev_dts)
+         || (!non_output_sample && cts < dts && (dts - cts) > INT32_MAX) )
+            return LSMASH_ERR_INVALID_DATA;
+        has_prev = 1;
+        prev_dts = dts;
+    }
+    return 0;
+}
+
+int lsmash_append_chunk_from_media_timeline
+(
+    lsmash_root_t *root,
+    uint32_t       track_ID,
+    lsmash_root_t *src_root,
+    uint32_t       src_track_ID,
+    uint32_t       sample_number,
+    uint32_t      *sample_count
+)
+{
+    if( isom_check_initializer_present( root ) < 0
+     || track_ID == 0
+     || !sample_count )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    lsmash_file_t *file = root->file;
+    if( !file->bs
+     || !(file->flags & LSMASH_FILE_MODE_BOX)
+     || file != file->initializer )
+        return LSMASH_ERR_NAMELESS;
+    if( file->fragment )
+        return LSMASH_ERR_PATCH_WELCOME;
+    isom_trak_t *trak = isom_get_trak( file, track_ID );
+    if( LSMASH_IS_NON_EXISTING_BOX( trak->file )
+     || LSMASH_IS_NON_EXISTING_BOX( trak->tkhd )
+     ||  trak->mdia->mdhd->timescale == 0
+     || !trak->cache
+     || !trak->mdia->minf->stbl->stsc->list )
+        return LSMASH_ERR_NAMELESS;
+    isom_timeline_t *timeline = isom_get_timeline( src_root, src_track_ID );
+    if( !timeline )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    /* Get the range of the samples to be copied. */
+    lsmash_file_t *src_file;
+    uint64_t       src_pos;
+    uint64_t       length;
+    uint32_t count = isom_timeline_get_chunk_range( timeline, sample_number, &src_file, &src_pos, &length );
+    if( count == 0 )
+        return LSMASH_ERR_PATCH_WELCOME;
+    if( !src_file->bs )
+        return LSMASH_ERR_NAMELESS;
+    /* Get and check all the samples before any change of the destination
+     * so that a failure doesn't leave samples without their chunk or data in the tables. */
+    lsmash_sample_t *samples = lsmash_malloc( count * sizeof(lsmash_sample_t) );
+    if( !samples )
+        return LSMASH_ERR_MEMORY_ALLOC;
+    int err;
+    for( uint32_t i = 0; i < count; i++ )
+        if( (err = lsmash_get_sample_info_from_media_timeline( src_root, src_track_ID, sample_number + i, &samples[i] )) < 0 )
+            goto fail;
+    /* Samples which need any handling of their data cannot be copied verbatim. */
+    uint32_t sample_description_index = samples[0].index;
+    isom_sample_entry_t *sample_entry = (isom_sample_entry_t *)lsmash_list_get_entry_data( &trak->mdia->minf->stbl->stsd->list, sample_description_index );
+    if( LSMASH_IS_NON_EXISTING_BOX( sample_entry ) )
+    {
+        err = LSMASH_ERR_NAMELESS;
+        goto fail;
+    }
+    isom_audio_entry_t *audio = (isom_audio_entry_t *)sample_entry;
+    if( isom_is_lpcm_audio( sample_entry )
+     || lsmash_check_codec_type_identical( sample_entry->type, ISOM_CODEC_TYPE_RTP_HINT  )
+     || lsmash_check_codec_type_identical( sample_entry->type, ISOM_CODEC_TYPE_RRTP_HINT )
+     || ((audio->manager & LSMASH_AUDIO_DESCRIPTION)
+      && (audio->manager & LSMASH_QTFF_BASE)
+      && (audio->version == 1)
+      && (audio->compression_ID != QT_AUDIO_COMPRESSION_ID_VARIABLE_COMPRESSION)) )
+    {
+        err = LSMASH_ERR_PATCH_WELCOME;
+        goto fail;
+    }
+    if( (err = isom_check_appended_timestamps( trak, samples, count )) < 0
+     || (err = isom_write_pending_ftyp( file )) < 0
+     || (err = isom_prepare_media_data_box( file )) < 0 )
+        goto fail;
+    lsmash_file_t *media_file = isom_get_written_media_file( trak, sample_description_index );
+    if( LSMASH_IS_NON_EXISTING_BOX( media_file )
+     || !media_file->bs
+     || !(media_file->flags & LSMASH_FILE_MODE_WRITE)
+     || !(media_file->flags & LSMASH_FILE_MODE_MEDIA)
+     || ((media_file->flags & LSMASH_FILE_MODE_BOX) && LSMASH_IS_NON_EXISTING_BOX( media_file->mdat )) )
+    {
+        err = LSMASH_ERR_INVALID_DATA;
+        goto fail;
+    }
+    /* The copied chunk follows the samples pooled in this track. */
+    isom_chunk_t *chunk = &trak->cache->chunk;
+    if( chunk->pool
+     && chunk->pool->sample_count
+     && (err = isom_output_cached_chunk( trak )) < 0 )
+        goto fail;
+    /* Copy the data first, then add the chunk at the position before the data and its samples to the tables. */
+    if( (err = isom_copy_media_data( media_file, src_file, src_pos, length )) < 0 )
+        goto fail;
+    err = isom_update_chunk_tables( trak->mdia->minf->stbl, media_file, chunk->chunk_number + 1,
+                                    count, sample_description_index );
+    if( LSMASH_IS_EXISTING_BOX( media_file->mdat ) )
+        media_file->mdat->media_size += length;
+    media_file->size += length;
+    if( err < 0 )
+        goto fail;
+    chunk->chunk_number            += 1;
+    chunk->sample_description_index = sample_description_index;
+    chunk->first_dts                = samples[0].dts;
+    for( uint32_t i = 0; i < count; i++ )
+        if( (err = isom_add_sample_to_tables( trak, &samples[i] )) < 0 )
+            goto fail;
+    lsmash_free( samples );
+    *sample_count = count;
+    return 0;
+fail:
+    lsmash_free( samples );
+    return err;
+}
+
 /*---- misc functions ----*/
 
 int lsmash_delete_explicit_timeline_map( lsmash_root_t *root, uint32_t track_ID )
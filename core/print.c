@@ -26,11 +26,16 @@
 #include <string.h>
 #include <inttypes.h>
 #include <stdarg.h> /* for isom_iprintf */
+#include <errno.h>
 
 #include "box.h"
+#include "file.h"
+#include "print.h"
+#include "read.h"
+#include "timeline.h"
 
 
-typedef int (*isom_print_box_t)( FILE *, lsmash_file_t *, isom_box_t *, int );
+typedef int (*isom_print_box_t)( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
 
 typedef struct
 {
@@ -39,11 +44,608 @@ typedef struct
     isom_print_box_t func;
 } isom_print_entry_t;
 
-static void isom_ifprintf_duration( FILE *fp, int indent, char *field_name, uint64_t duration, uint32_t timescale )
+/*** Printer ***/
+
+#define ISOM_EMITTER_MAX_DEPTH 128
+
+typedef struct
+{
+    FILE               *fp;
+    lsmash_print_format format;
+    int                 depth;
+    int                 after_key;
+    uint8_t             nonempty[ISOM_EMITTER_MAX_DEPTH];   /* whether any item has been put into the container at each depth */
+    char                closer  [ISOM_EMITTER_MAX_DEPTH];   /* the character closing the JSON container at each depth */
+} isom_emitter_t;
+
+static void isom_emitter_init( isom_emitter_t *emitter, FILE *fp, lsmash_print_format format )
+{
+    memset( emitter, 0, sizeof(isom_emitter_t) );
+    emitter->fp     = fp;
+    emitter->format = format;
+}
+
+static void isom_cbor_put_head( FILE *fp, uint8_t major_type, uint64_t argument )
+{
+    uint8_t head[9];
+    int     length;
+    if( argument < 24 )
+    {
+        head[0] = (major_type << 5) | argument;
+        length  = 1;
+    }
+    else
+    {
+        int additional = argument <= UINT8_MAX  ? 24
+                       : argument <= UINT16_MAX ? 25
+                       : argument <= UINT32_MAX ? 26
+                       :                          27;
+        head[0] = (major_type << 5) | additional;
+        length  = 1 + (1 << (additional - 24));
+        for( int i = length - 1; i > 0; i-- )
+        {
+            head[i] = argument & 0xff;
+            argument >>= 8;
+        }
+    }
+    fwrite( head, 1, length, fp );
+}
+
+/* Return the length of the valid UTF-8 sequence starting at 'str', or 0 if invalid. */
+static int isom_get_utf8_sequence_length( const uint8_t *str, size_t size )
+{
+    int length = str[0] < 0x80 ? 1
+               : str[0] < 0xc2 ? 0
+               : str[0] < 0xe0 ? 2
+               : str[0] < 0xf0 ? 3
+               : str[0] < 0xf5 ? 4
+               :                 0;
+    if( length == 0 || (size_t)length > size )
+        return 0;
+    for( int i = 1; i < length; i++ )
+        if( (str[i] & 0xc0) != 0x80 )
+            return 0;
+    /* Reject overlong forms, surrogates and code points over U+10FFFF. */
+    if( (str[0] == 0xe0 && str[1] < 0xa0)
+     || (str[0] == 0xed && str[1] > 0x9f)
+     || (str[0] == 0xf0 && str[1] < 0x90)
+     || (str[0] == 0xf4 && str[1] > 0x8f) )
+        return 0;
+    return length;
+}
+
+static void isom_emit_separator( isom_emitter_t *emitter )
+{
+    if( emitter->after_key )
+    {
+        emitter->after_key = 0;
+        return;
+    }
+    if( emitter->format == LSMASH_PRINT_FORMAT_JSON && emitter->nonempty[ emitter->depth ] )
+        fputc( ',', emitter->fp );
+    emitter->nonempty[ emitter->depth ] = 1;
+}
+
+static int isom_emit_begin( isom_emitter_t *emitter, int is_map )
+{
+    if( emitter->depth + 1 >= ISOM_EMITTER_MAX_DEPTH )
+        return LSMASH_ERR_PATCH_WELCOME;
+    isom_emit_separator( emitter );
+    if( emitter->format == LSMASH_PRINT_FORMAT_JSON )
+        fputc( is_map ? '{' : '[', emitter->fp );
+    else
+        fputc( is_map ? 0xbf : 0x9f, emitter->fp );   /* indefinite length */
+    ++ emitter->depth;
+    emitter->nonempty[ emitter->depth ] = 0;
+    emitter->closer  [ emitter->depth ] = is_map ? '}' : ']';
+    return 0;
+}
+
+static void isom_emit_end( isom_emitter_t *emitter )
+{
+    if( emitter->format == LSMASH_PRINT_FORMAT_JSON )
+        fputc( emitter->closer[ emitter->depth ], emitter->fp );
+    else
+        fputc( 0xff, emitter->fp );     /* break */
+    -- emitter->depth;
+}
+
+static void isom_emit_string( isom_emitter_t *emitter, const char *str, size_t length )
+{
+    const uint8_t *s = (const uint8_t *)str;
+    isom_emit_separator( emitter );
+    if( emitter->format == LSMASH_PRINT_FORMAT_CBOR )
+    {
+        /* Text strings shall be valid UTF-8, so put any other as a byte string. */
+        size_t i = 0;
+        for( int n; i < length && (n = isom_get_utf8_sequence_length( s + i, length - i )) > 0; i += n );
+        isom_cbor_put_head( emitter->fp, i == length ? 3 : 2, length );
+        fwrite( str, 1, length, emitter->fp );
+        return;
+    }
+    FILE *fp = emitter->fp;
+    fputc( '"', fp );
+    for( size_t i = 0; i < length; )
+    {
+        int n = isom_get_utf8_sequence_length( s + i, length - i );
+        if( n == 1 && s[i] >= 0x20 && s[i] != '"' && s[i] != '\\' )
+            fputc( s[i], fp );
+        else if( n > 1 )
+            fwrite( s + i, 1, n, fp );
+        else if( s[i] == '"' || s[i] == '\\' )
+            fprintf( fp, "\\%c", s[i] );
+        else
+        {
+            /* Control characters and bytes not forming UTF-8, which are regarded as Latin-1. */
+            fprintf( fp, "\\u%04x", s[i] );
+            n = 1;
+        }
+        i += n;
+    }
+    fputc( '"', fp );
+}
+
+static void isom_emit_key( isom_emitter_t *emitter, const char *key )
+{
+    isom_emit_string( emitter, key, strlen( key ) );
+    if( emitter->format == LSMASH_PRINT_FORMAT_JSON )
+        fputc( ':', emitter->fp );
+    emitter->after_key = 1;
+}
+
+static void isom_emit_uint( isom_emitter_t *emitter, uint64_t value )
+{
+    isom_emit_separator( emitter );
+    if( emitter->format == LSMASH_PRINT_FORMAT_JSON )
+        fprintf( emitter->fp, "%"PRIu64, value );
+    else
+        isom_cbor_put_head( emitter->fp, 0, value );
+}
+
+static void isom_emit_int( isom_emitter_t *emitter, int64_t value )
+{
+    if( value >= 0 )
+    {
+        isom_emit_uint( emitter, value );
+        return;
+    }
+    isom_emit_separator( emitter );
+    if( emitter->format == LSMASH_PRINT_FORMAT_JSON )
+        fprintf( emitter->fp, "%"PRId64, value );
+    else
+        isom_cbor_put_head( emitter->fp, 1, (uint64_t)(-(value + 1)) );
+}
+
+static void isom_emit_double( isom_emitter_t *emitter, double value )
+{
+    /* Test the exponent bits since the comparisons with NaN are not reliable under fast math. */
+    uint64_t bits;
+    memcpy( &bits, &value, sizeof(uint64_t) );
+    isom_emit_separator( emitter );
+    if( emitter->format == LSMASH_PRINT_FORMAT_JSON )
+    {
+        if( (bits & 0x7ff0000000000000ULL) == 0x7ff0000000000000ULL )
+            fprintf( emitter->fp, "null" );     /* JSON has no representation of infinities and NaNs. */
+        else
+            fprintf( emitter->fp, "%.17g", value );
+        return;
+    }
+    fputc( 0xfb, emitter->fp );    /* double-precision float */
+    for( int i = 56; i >= 0; i -= 8 )
+        fputc( (bits >> i) & 0xff, emitter->fp );
+}
+
+static void isom_emit_bytes( isom_emitter_t *emitter, const uint8_t *data, uint32_t size )
+{
+    if( emitter->format == LSMASH_PRINT_FORMAT_CBOR )
+    {
+        isom_emit_separator( emitter );
+        isom_cbor_put_head( emitter->fp, 2, size );
+        fwrite( data, 1, size, emitter->fp );
+        return;
+    }
+    /* JSON has no byte strings, so put the bytes as an array of numbers. */
+    isom_emit_begin( emitter, 0 );
+    for( uint32_t i = 0; i < size; i++ )
+        isom_emit_uint( emitter, data[i] );
+    isom_emit_end( emitter );
+}
+
+/* The printer formats the fields described by the box printers.
+ * For the structured formats, each field becomes a node and the fields indented deeper become its children. */
+#define ISOM_PRINTER_MAX_NODE_DEPTH ((ISOM_EMITTER_MAX_DEPTH - 4) / 2)
+
+struct isom_printer_tag
+{
+    isom_emitter_t emitter;
+    int            line_open;       /* whether the current line of the text is not terminated yet */
+    int            error;
+    int            depth;
+    struct
+    {
+        int indent;
+        int has_children;
+        int has_note;
+    } node[ISOM_PRINTER_MAX_NODE_DEPTH];
+};
+
+static isom_printer_t *isom_printer_create( FILE *destination, lsmash_print_format format )
+{
+    isom_printer_t *printer = lsmash_malloc_zero( sizeof(isom_printer_t) );
+    if( !printer )
+        return NULL;
+    isom_emitter_init( &printer->emitter, destination, format );
+    if( format != LSMASH_PRINT_FORMAT_TEXT )
+        isom_emit_begin( &printer->emitter, 0 );
+    return printer;
+}
+
+static inline int isom_printer_is_text( isom_printer_t *printer )
+{
+    return printer->emitter.format == LSMASH_PRINT_FORMAT_TEXT;
+}
+
+static void isom_printer_close_node( isom_printer_t *printer )
+{
+    if( printer->node[ --printer->depth ].has_children )
+        isom_emit_end( &printer->emitter );
+    isom_emit_end( &printer->emitter );
+}
+
+/* Start a node at 'indent'.
+ * Return 1 for the text, 0 for the structured formats, or -1 if the node cannot be put. */
+static int isom_printer_open_node( isom_printer_t *printer, int indent )
+{
+    isom_emitter_t *emitter = &printer->emitter;
+    if( emitter->format == LSMASH_PRINT_FORMAT_TEXT )
+    {
+        if( printer->line_open )
+            fputc( '\n', emitter->fp );
+        printer->line_open = 1;
+        return 1;
+    }
+    while( printer->depth && printer->node[ printer->depth - 1 ].indent >= indent )
+        isom_printer_close_node( printer );
+    if( printer->depth == ISOM_PRINTER_MAX_NODE_DEPTH )
+    {
+        printer->error = LSMASH_ERR_PATCH_WELCOME;
+        return -1;
+    }
+    if( printer->depth && !printer->node[ printer->depth - 1 ].has_children )
+    {
+        isom_emit_key( emitter, "children" );
+        isom_emit_begin( emitter, 0 );
+        printer->node[ printer->depth - 1 ].has_children = 1;
+    }
+    isom_emit_begin( emitter, 1 );
+    printer->node[ printer->depth ].indent       = indent;
+    printer->node[ printer->depth ].has_children = 0;
+    printer->node[ printer->depth ].has_note     = 0;
+    ++ printer->depth;
+    return 0;
+}
+
+/* Start a field, and put its value next if 'has_value'. */
+static int isom_printer_begin_field( isom_printer_t *printer, int indent, const char *name, const uint64_t *index, int has_value )
+{
+    int text = isom_printer_open_node( printer, indent );
+    if( text < 0 )
+        return text;
+    isom_emitter_t *emitter = &printer->emitter;
+    if( text )
+    {
+        lsmash_ifprintf( emitter->fp, indent, "%s", name );
+        if( index )
+            fprintf( emitter->fp, "[%"PRIu64"]", *index );
+        if( has_value )
+            fprintf( emitter->fp, " = " );
+        return 1;
+    }
+    isom_emit_key   ( emitter, "name" );
+    isom_emit_string( emitter, name, strlen( name ) );
+    if( index )
+    {
+        isom_emit_key ( emitter, "index" );
+        isom_emit_uint( emitter, *index );
+    }
+    if( has_value )
+        isom_emit_key( emitter, "value" );
+    return 0;
+}
+
+/* Put 'str' as an attribute named 'key' of the last node, or between 'prefix' and 'suffix' in the current line of the text. */
+static void isom_printer_put_attribute( isom_printer_t *printer, const char *key, const char *prefix, const char *suffix, const char *str )
+{
+    if( isom_printer_is_text( printer ) )
+    {
+        if( printer->line_open )
+            fprintf( printer->emitter.fp, "%s%s%s", prefix, str, suffix );
+        return;
+    }
+    if( printer->depth == 0 || printer->node[ printer->depth - 1 ].has_children )
+        return;
+    int *has_note = &printer->node[ printer->depth - 1 ].has_note;
+    if( !strcmp( key, "note" ) )
+    {
+        /* Keys in a map shall be unique. */
+        if( *has_note )
+            return;
+        *has_note = 1;
+    }
+    isom_emit_key   ( &printer->emitter, key );
+    isom_emit_string( &printer->emitter, str, strlen( str ) );
+}
+
+/* Finish the output of the fields printed so far. */
+static int isom_printer_flush( isom_printer_t *printer )
+{
+    if( printer->line_open )
+    {
+        fputc( '\n', printer->emitter.fp );
+        printer->line_open = 0;
+    }
+    return printer->error;
+}
+
+/* Finish the output and free the printer. */
+static int isom_printer_destroy( isom_printer_t *printer )
+{
+    int ret = isom_printer_flush( printer );
+    if( !isom_printer_is_text( printer ) )
+    {
+        while( printer->depth )
+            isom_printer_close_node( printer );
+        isom_emit_end( &printer->emitter );
+        if( printer->emitter.format == LSMASH_PRINT_FORMAT_JSON )
+            fputc( '\n', printer->emitter.fp );
+    }
+    lsmash_free( printer );
+    return ret;
+}
+
+void isom_iprint_box( isom_printer_t *printer, int indent, const char *type, const char *name )
+{
+    int text = isom_printer_open_node( printer, indent );
+    if( text < 0 )
+        return;
+    isom_emitter_t *emitter = &printer->emitter;
+    if( text )
+    {
+        if( type && name )
+            lsmash_ifprintf( emitter->fp, indent, "[%s: %s]", type, name );
+        else
+            lsmash_ifprintf( emitter->fp, indent, "[%s]", type ? type : name );
+        return;
+    }
+    if( type )
+    {
+        isom_emit_key   ( emitter, "box" );
+        isom_emit_string( emitter, type, strlen( type ) );
+    }
+    if( name )
+    {
+        isom_emit_key   ( emitter, "name" );
+        isom_emit_string( emitter, name, strlen( name ) );
+    }
+}
+
+void isom_iprint_tag( isom_printer_t *printer, int indent, uint8_t tag, const char *name )
+{
+    int text = isom_printer_open_node( printer, indent );
+    if( text < 0 )
+        return;
+    isom_emitter_t *emitter = &printer->emitter;
+    if( text )
+    {
+        if( name )
+            lsmash_ifprintf( emitter->fp, indent, "[tag = 0x%02"PRIx8": %s]", tag, name );
+        else
+            lsmash_ifprintf( emitter->fp, indent, "[tag = 0x%02"PRIx8"]", tag );
+        return;
+    }
+    isom_emit_key ( emitter, "tag" );
+    isom_emit_uint( emitter, tag );
+    if( name )
+    {
+        isom_emit_key   ( emitter, "name" );
+        isom_emit_string( emitter, name, strlen( name ) );
+    }
+}
+
+void isom_iprint_label( isom_printer_t *printer, int indent, const char *name )
+{
+    isom_printer_begin_field( printer, indent, name, NULL, 0 );
+}
+
+void isom_iprint_element( isom_printer_t *printer, int indent, const char *name, uint64_t index )
+{
+    isom_printer_begin_field( printer, indent, name, &index, 0 );
+}
+
+static void isom_printer_put_uint( isom_printer_t *printer, int text, uint64_t value )
+{
+    if( text > 0 )
+        fprintf( printer->emitter.fp, "%"PRIu64, value );
+    else if( text == 0 )
+        isom_emit_uint( &printer->emitter, value );
+}
+
+static void isom_printer_put_int( isom_printer_t *printer, int text, int64_t value )
+{
+    if( text > 0 )
+        fprintf( printer->emitter.fp, "%"PRId64, value );
+    else if( text == 0 )
+        isom_emit_int( &printer->emitter, value );
+}
+
+static void isom_printer_put_float( isom_printer_t *printer, int text, double value )
+{
+    if( text > 0 )
+        fprintf( printer->emitter.fp, "%f", value );
+    else if( text == 0 )
+        isom_emit_double( &printer->emitter, value );
+}
+
+static void isom_printer_put_string( isom_printer_t *printer, int text, const char *value, size_t length )
+{
+    if( text > 0 )
+        fwrite( value, 1, length, printer->emitter.fp );
+    else if( text == 0 )
+        isom_emit_string( &printer->emitter, value, length );
+}
+
+static void isom_printer_put_fourcc( isom_printer_t *printer, int text, uint32_t fourcc )
+{
+    if( text > 0 )
+        fprintf( printer->emitter.fp, "%s", isom_4cc2str( fourcc ) );
+    else if( text == 0 )
+    {
+        char str[4] = { fourcc >> 24, fourcc >> 16, fourcc >> 8, fourcc };
+        isom_emit_string( &printer->emitter, str, 4 );
+    }
+}
+
+void isom_iprint_uint( isom_printer_t *printer, int indent, const char *name, uint64_t value )
+{
+    isom_printer_put_uint( printer, isom_printer_begin_field( printer, indent, name, NULL, 1 ), value );
+}
+
+void isom_iprint_int( isom_printer_t *printer, int indent, const char *name, int64_t value )
+{
+    isom_printer_put_int( printer, isom_printer_begin_field( printer, indent, name, NULL, 1 ), value );
+}
+
+void isom_iprint_hex( isom_printer_t *printer, int indent, const char *name, uint64_t value, int digits )
+{
+    /* Signed fields are sign-extended on the way here, so keep only the bits of the field. */
+    if( digits > 0 && digits < 16 )
+        value &= (UINT64_C(1) << (4 * digits)) - 1;
+    int text = isom_printer_begin_field( printer, indent, name, NULL, 1 );
+    if( text > 0 )
+        fprintf( printer->emitter.fp, "0x%0*"PRIx64, digits, value );
+    else if( text == 0 )
+        isom_emit_uint( &printer->emitter, value );
+}
+
+void isom_iprint_float( isom_printer_t *printer, int indent, const char *name, double value )
+{
+    isom_printer_put_float( printer, isom_printer_begin_field( printer, indent, name, NULL, 1 ), value );
+}
+
+void isom_iprint_string( isom_printer_t *printer, int indent, const char *name, const char *value )
+{
+    isom_printer_put_string( printer, isom_printer_begin_field( printer, indent, name, NULL, 1 ), value, strlen( value ) );
+}
+
+void isom_iprint_fourcc( isom_printer_t *printer, int indent, const char *name, uint32_t fourcc )
+{
+    isom_printer_put_fourcc( printer, isom_printer_begin_field( printer, indent, name, NULL, 1 ), fourcc );
+}
+
+void isom_iprint_bytes( isom_printer_t *printer, int indent, const char *name, const uint8_t *data, uint32_t size )
+{
+    if( !isom_printer_is_text( printer ) )
+    {
+        if( isom_printer_begin_field( printer, indent, name, NULL, 1 ) == 0 )
+            isom_emit_bytes( &printer->emitter, data, size );
+        return;
+    }
+    /* Print the bytes in rows of 8. */
+    FILE *fp = printer->emitter.fp;
+    isom_printer_open_node( printer, indent );
+    lsmash_ifprintf( fp, indent++, "%s[]", name );
+    for( uint32_t i = 0; i < size; i += 8 )
+    {
+        fputc( '\n', fp );
+        lsmash_ifprintf( fp, indent, "" );
+        for( uint32_t j = i; j < size && j < i + 8; j++ )
+            fprintf( fp, j == i ? "0x%02"PRIx8 : " 0x%02"PRIx8, data[j] );
+    }
+}
+
+void isom_iprint_uint_at( isom_printer_t *printer, int indent, const char *name, uint64_t index, uint64_t value )
+{
+    isom_printer_put_uint( printer, isom_printer_begin_field( printer, indent, name, &index, 1 ), value );
+}
+
+void isom_iprint_int_at( isom_printer_t *printer, int indent, const char *name, uint64_t index, int64_t value )
+{
+    isom_printer_put_int( printer, isom_printer_begin_field( printer, indent, name, &index, 1 ), value );
+}
+
+void isom_iprint_float_at( isom_printer_t *printer, int indent, const char *name, uint64_t index, double value )
+{
+    isom_printer_put_float( printer, isom_printer_begin_field( printer, indent, name, &index, 1 ), value );
+}
+
+void isom_iprint_fourcc_at( isom_printer_t *printer, int indent, const char *name, uint64_t index, uint32_t fourcc )
+{
+    isom_printer_put_fourcc( printer, isom_printer_begin_field( printer, indent, name, &index, 1 ), fourcc );
+}
+
+void isom_iprint_note( isom_printer_t *printer, const char *format, ... )
+{
+    char note[256];
+    va_list args;
+    va_start( args, format );
+    vsnprintf( note, sizeof(note), format, args );
+    va_end( args );
+    isom_printer_put_attribute( printer, "note", " (", ")", note );
+}
+
+void isom_iprint_unit( isom_printer_t *printer, const char *unit )
+{
+    isom_printer_put_attribute( printer, "unit", " ", "", unit );
+}
+
+/* Put the values of a field as an array in the structured formats. */
+static void isom_printer_put_uint_array( isom_printer_t *printer, int indent, const char *name, const uint64_t *index, const uint64_t *value, int count )
+{
+    if( isom_printer_begin_field( printer, indent, name, index, 1 ) < 0 )
+        return;
+    if( isom_emit_begin( &printer->emitter, 0 ) < 0 )
+    {
+        printer->error = LSMASH_ERR_PATCH_WELCOME;
+        return;
+    }
+    for( int i = 0; i < count; i++ )
+        isom_emit_uint( &printer->emitter, value[i] );
+    isom_emit_end( &printer->emitter );
+}
+
+/* Put the value of a field that is absent, which is described by 'str' in the text. */
+static void isom_ifprintf_none( isom_printer_t *printer, int indent, const char *name, const uint64_t *index, const char *str )
+{
+    int text = isom_printer_begin_field( printer, indent, name, index, 1 );
+    if( text > 0 )
+        fprintf( printer->emitter.fp, "%s", str );
+    else if( text == 0 )
+    {
+        isom_emit_separator( &printer->emitter );
+        if( printer->emitter.format == LSMASH_PRINT_FORMAT_JSON )
+            fprintf( printer->emitter.fp, "null" );
+        else
+            fputc( 0xf6, printer->emitter.fp );     /* null */
+    }
+}
+
+/* Put a string field, which is printed as 'name: value' in the text. */
+static void isom_ifprintf_property( isom_printer_t *printer, int indent, char *field_name, char *value )
+{
+    if( !isom_printer_is_text( printer ) )
+    {
+        isom_iprint_string( printer, indent, field_name, value );
+        return;
+    }
+    isom_printer_open_node( printer, indent );
+    lsmash_ifprintf( printer->emitter.fp, indent, "%s: %s", field_name, value );
+}
+
+static void isom_ifprintf_duration( isom_printer_t *printer, int indent, char *field_name, uint64_t duration, uint32_t timescale )
 {
     if( !timescale )
     {
-        lsmash_ifprintf( fp, indent, "duration = %"PRIu64"\n", duration );
+        isom_iprint_uint( printer, indent, "duration", duration );
         return;
     }
     int dur = duration / timescale;
@@ -51,9 +653,8 @@ static void isom_ifprintf_duration( FILE *fp, int indent, char *field_name, uint
     int min  = (dur /   60) % 60;
     int sec  =  dur         % 60;
     int ms   = ((double)duration / timescale - (hour * 3600 + min * 60 + sec)) * 1e3 + 0.5;
-    static char str[32];
-    sprintf( str, "%02d:%02d:%02d.%03d", hour, min, sec, ms );
-    lsmash_ifprintf( fp, indent, "%s = %"PRIu64" (%s)\n", field_name, duration, str );
+    isom_iprint_uint( printer, indent, field_name, duration );
+    isom_iprint_note( printer, "%02d:%02d:%02d.%03d", hour, min, sec, ms );
 }
 
 static char *isom_mp4time2utc( uint64_t mp4time )
@@ -82,31 +683,74 @@ static char *isom_mp4time2utc( uint64_t mp4time )
     int min  = (mp4time /   60) % 60;
     int sec  =  mp4time         % 60;
     static char utc[64];
-    sprintf( utc, "UTC %d/%02d/%02d, %02d:%02d:%02d\n", year, month, day, hour, min, sec );
+    sprintf( utc, "UTC %d/%02d/%02d, %02d:%02d:%02d", year, month, day, hour, min, sec );
     return utc;
 }
 
-static void isom_ifprintf_matrix( FILE *fp, int indent, int32_t *matrix )
+/* The text shows the time in UTC, and the structured formats the seconds since 1904 annotated with the UTC. */
+static void isom_ifprintf_time( isom_printer_t *printer, int indent, char *field_name, uint64_t mp4time )
 {
-    lsmash_ifprintf( fp, indent, "| a, b, u |   | %f, %f, %f |\n", lsmash_fixed2double( matrix[0], 16 ),
-                                                            lsmash_fixed2double( matrix[1], 16 ),
-                                                            lsmash_fixed2double( matrix[2], 30 ) );
-    lsmash_ifprintf( fp, indent, "| c, d, v | = | %f, %f, %f |\n", lsmash_fixed2double( matrix[3], 16 ),
-                                                            lsmash_fixed2double( matrix[4], 16 ),
-                                                            lsmash_fixed2double( matrix[5], 30 ) );
-    lsmash_ifprintf( fp, indent, "| x, y, w |   | %f, %f, %f |\n", lsmash_fixed2double( matrix[6], 16 ),
-                                                            lsmash_fixed2double( matrix[7], 16 ),
-                                                            lsmash_fixed2double( matrix[8], 30 ) );
+    if( isom_printer_is_text( printer ) )
+        isom_iprint_string( printer, indent, field_name, isom_mp4time2utc( mp4time ) );
+    else
+    {
+        isom_iprint_uint( printer, indent, field_name, mp4time );
+        isom_iprint_note( printer, "%s", isom_mp4time2utc( mp4time ) );
+    }
 }
 
-static void isom_ifprintf_rgb_color( FILE *fp, int indent, uint16_t *color )
+static void isom_ifprintf_matrix( isom_printer_t *printer, int indent, char *field_name, int32_t *matrix )
 {
-    lsmash_ifprintf( fp, indent, "{ R, G, B } = { %"PRIu16", %"PRIu16", %"PRIu16" }\n", color[0], color[1], color[2] );
+    double value[9];
+    for( int i = 0; i < 9; i++ )
+        value[i] = lsmash_fixed2double( matrix[i], i % 3 == 2 ? 30 : 16 );
+    if( !isom_printer_is_text( printer ) )
+    {
+        /* Put the elements in the order of the rows. */
+        if( isom_printer_begin_field( printer, indent, field_name, NULL, 1 ) < 0 )
+            return;
+        if( isom_emit_begin( &printer->emitter, 0 ) < 0 )
+        {
+            printer->error = LSMASH_ERR_PATCH_WELCOME;
+            return;
+        }
+        for( int i = 0; i < 9; i++ )
+            isom_emit_double( &printer->emitter, value[i] );
+        isom_emit_end( &printer->emitter );
+        return;
+    }
+    FILE *fp = printer->emitter.fp;
+    isom_iprint_label( printer, indent++, field_name );
+    isom_printer_open_node( printer, indent );
+    lsmash_ifprintf( fp, indent, "| a, b, u |   | %f, %f, %f |\n", value[0], value[1], value[2] );
+    lsmash_ifprintf( fp, indent, "| c, d, v | = | %f, %f, %f |\n", value[3], value[4], value[5] );
+    lsmash_ifprintf( fp, indent, "| x, y, w |   | %f, %f, %f |",   value[6], value[7], value[8] );
+}
+
+static void isom_ifprintf_rgb_color( isom_printer_t *printer, int indent, char *field_name, uint16_t *color )
+{
+    uint64_t value[3] = { color[0], color[1], color[2] };
+    if( !isom_printer_is_text( printer ) )
+    {
+        isom_printer_put_uint_array( printer, indent, field_name, NULL, value, 3 );
+        return;
+    }
+    isom_iprint_label( printer, indent++, field_name );
+    isom_printer_open_node( printer, indent );
+    lsmash_ifprintf( printer->emitter.fp, indent, "{ R, G, B } = { %"PRIu16", %"PRIu16", %"PRIu16" }", color[0], color[1], color[2] );
 }
 
-static void isom_ifprintf_rgba_color( FILE *fp, int indent, uint8_t *color )
+static void isom_ifprintf_rgba_color( isom_printer_t *printer, int indent, char *field_name, uint8_t *color )
 {
-    lsmash_ifprintf( fp, indent, "{ R, G, B, A } = { %"PRIu8", %"PRIu8", %"PRIu8", %"PRIu8" }\n", color[0], color[1], color[2], color[3] );
+    uint64_t value[4] = { color[0], color[1], color[2], color[3] };
+    if( !isom_printer_is_text( printer ) )
+    {
+        isom_printer_put_uint_array( printer, indent, field_name, NULL, value, 4 );
+        return;
+    }
+    isom_iprint_label( printer, indent++, field_name );
+    isom_printer_open_node( printer, indent );
+    lsmash_ifprintf( printer->emitter.fp, indent, "{ R, G, B, A } = { %"PRIu8", %"PRIu8", %"PRIu8", %"PRIu8" }", color[0], color[1], color[2], color[3] );
 }
 
 static char *isom_unpack_iso_language( uint16_t language )
@@ -119,7 +763,7 @@ static char *isom_unpack_iso_language( uint16_t language )
     return unpacked;
 }
 
-static void isom_ifprintf_sample_description_common_reserved( FILE *fp, int indent, uint8_t *reserved )
+static void isom_ifprintf_sample_description_common_reserved( isom_printer_t *printer, int indent, uint8_t *reserved )
 {
     uint64_t temp = ((uint64_t)reserved[0] << 40)
                   | ((uint64_t)reserved[1] << 32)
@@ -127,10 +771,10 @@ static void isom_ifprintf_sample_description_common_reserved( FILE *fp, int inde
                   | ((uint64_t)reserved[3] << 16)
                   | ((uint64_t)reserved[4] <<  8)
                   |  (uint64_t)reserved[5];
-    lsmash_ifprintf( fp, indent, "reserved = 0x%012"PRIx64"\n", temp );
+    isom_iprint_hex( printer, indent, "reserved", temp, 12 );
 }
 
-static void isom_ifprintf_sample_flags( FILE *fp, int indent, char *field_name, isom_sample_flags_t *flags )
+static void isom_ifprintf_sample_flags( isom_printer_t *printer, int indent, char *field_name, isom_sample_flags_t *flags )
 {
     uint32_t temp = (flags->reserved                  << 28)
                   | (flags->is_leading                << 26)
@@ -140,102 +784,166 @@ static void isom_ifprintf_sample_flags( FILE *fp, int indent, char *field_name,
                   | (flags->sample_padding_value      << 17)
                   | (flags->sample_is_non_sync_sample << 16)
                   |  flags->sample_degradation_priority;
-    lsmash_ifprintf( fp, indent++, "%s = 0x%08"PRIx32"\n", field_name, temp );
-    if     ( flags->is_leading == ISOM_SAMPLE_IS_UNDECODABLE_LEADING       ) lsmash_ifprintf( fp, indent, "undecodable leading\n" );
-    else if( flags->is_leading == ISOM_SAMPLE_IS_NOT_LEADING               ) lsmash_ifprintf( fp, indent, "non-leading\n" );
-    else if( flags->is_leading == ISOM_SAMPLE_IS_DECODABLE_LEADING         ) lsmash_ifprintf( fp, indent, "decodable leading\n" );
-    if     ( flags->sample_depends_on == ISOM_SAMPLE_IS_INDEPENDENT        ) lsmash_ifprintf( fp, indent, "independent\n" );
-    else if( flags->sample_depends_on == ISOM_SAMPLE_IS_NOT_INDEPENDENT    ) lsmash_ifprintf( fp, indent, "dependent\n" );
-    if     ( flags->sample_is_depended_on == ISOM_SAMPLE_IS_NOT_DISPOSABLE ) lsmash_ifprintf( fp, indent, "non-disposable\n" );
-    else if( flags->sample_is_depended_on == ISOM_SAMPLE_IS_DISPOSABLE     ) lsmash_ifprintf( fp, indent, "disposable\n" );
-    if     ( flags->sample_has_redundancy == ISOM_SAMPLE_HAS_REDUNDANCY    ) lsmash_ifprintf( fp, indent, "redundant\n" );
-    else if( flags->sample_has_redundancy == ISOM_SAMPLE_HAS_NO_REDUNDANCY ) lsmash_ifprintf( fp, indent, "non-redundant\n" );
+    isom_iprint_hex( printer, indent++, field_name, temp, 8 );
+    static const char *is_leading           [4] = { NULL, "undecodable leading", "non-leading",    "decodable leading" };
+    static const char *depends_on           [4] = { NULL, "dependent",           "independent",    NULL };
+    static const char *is_depended_on       [4] = { NULL, "non-disposable",      "disposable",     NULL };
+    static const char *has_redundancy       [4] = { NULL, "redundant",           "non-redundant",  NULL };
+    static const char *is_non_sync_sample   [2] = { "sync sample", "non-sync sample" };
+    if( !isom_printer_is_text( printer ) )
+    {
+        /* Put each flag as a number annotated with its meaning. */
+        const struct
+        {
+            char       *name;
+            uint32_t    value;
+            const char *meaning;
+        } field[] =
+            {
+                { "is_leading",                  flags->is_leading,                is_leading        [ flags->is_leading            ] },
+                { "sample_depends_on",           flags->sample_depends_on,         depends_on        [ flags->sample_depends_on     ] },
+                { "sample_is_depended_on",       flags->sample_is_depended_on,     is_depended_on    [ flags->sample_is_depended_on ] },
+                { "sample_has_redundancy",       flags->sample_has_redundancy,     has_redundancy    [ flags->sample_has_redundancy ] },
+                { "sample_padding_value",        flags->sample_padding_value,      NULL },
+                { "sample_is_non_sync_sample",   flags->sample_is_non_sync_sample, is_non_sync_sample[ flags->sample_is_non_sync_sample ] },
+                { "sample_degradation_priority", flags->sample_degradation_priority, NULL }
+            };
+        for( size_t i = 0; i < sizeof(field) / sizeof(field[0]); i++ )
+        {
+            isom_iprint_uint( printer, indent, field[i].name, field[i].value );
+            if( field[i].meaning )
+                isom_iprint_note( printer, "%s", field[i].meaning );
+        }
+        return;
+    }
+    if( is_leading[ flags->is_leading ] )
+        isom_iprint_label( printer, indent, is_leading[ flags->is_leading ] );
+    if( depends_on[ flags->sample_depends_on ] )
+        isom_iprint_label( printer, indent, depends_on[ flags->sample_depends_on ] );
+    if( is_depended_on[ flags->sample_is_depended_on ] )
+        isom_iprint_label( printer, indent, is_depended_on[ flags->sample_is_depended_on ] );
+    if( has_redundancy[ flags->sample_has_redundancy ] )
+        isom_iprint_label( printer, indent, has_redundancy[ flags->sample_has_redundancy ] );
     if( flags->sample_padding_value )
-        lsmash_ifprintf( fp, indent, "padding_bits = %"PRIu8"\n", flags->sample_padding_value );
-    lsmash_ifprintf( fp, indent, flags->sample_is_non_sync_sample ? "non-sync sample\n" : "sync sample\n" );
-    lsmash_ifprintf( fp, indent, "degradation_priority = %"PRIu16"\n", flags->sample_degradation_priority );
+        isom_iprint_uint( printer, indent, "padding_bits", flags->sample_padding_value );
+    isom_iprint_label( printer, indent, is_non_sync_sample[ flags->sample_is_non_sync_sample ] );
+    isom_iprint_uint( printer, indent, "degradation_priority", flags->sample_degradation_priority );
+}
+
+/* The text shows the UUID in the canonical form, and the structured formats the 16 bytes. */
+static void isom_ifprintf_uuid( isom_printer_t *printer, int indent, char *field_name, uint32_t fourcc, const uint8_t *id )
+{
+    uint8_t uuid[16];
+    LSMASH_SET_BE32( &uuid[0], fourcc );
+    memcpy( &uuid[4], id, 12 );
+    if( !isom_printer_is_text( printer ) )
+    {
+        isom_iprint_bytes( printer, indent, field_name, uuid, 16 );
+        return;
+    }
+    char str[40];
+    sprintf( str, "0x%08"PRIx32"-%04"PRIx16"-%04"PRIx16"-%04"PRIx16"-%04"PRIx16"%08"PRIx32,
+             LSMASH_GET_BE32( &uuid[ 0] ),
+             LSMASH_GET_BE16( &uuid[ 4] ),
+             LSMASH_GET_BE16( &uuid[ 6] ),
+             LSMASH_GET_BE16( &uuid[ 8] ),
+             LSMASH_GET_BE16( &uuid[10] ),
+             LSMASH_GET_BE32( &uuid[12] ) );
+    isom_iprint_string( printer, indent, field_name, str );
+}
+
+/* The text shows the bytes as a hexadecimal number, or 'str' instead if any, and the structured formats put them as they are. */
+static void isom_ifprintf_binary( isom_printer_t *printer, int indent, char *field_name, uint8_t *data, uint32_t size, char *str )
+{
+    if( !isom_printer_is_text( printer ) )
+    {
+        isom_iprint_bytes( printer, indent, field_name, data, size );
+        return;
+    }
+    FILE *fp = printer->emitter.fp;
+    isom_printer_begin_field( printer, indent, field_name, NULL, 1 );
+    if( str )
+        fprintf( fp, "%s", str );
+    else if( size )
+    {
+        fprintf( fp, "0x" );
+        for( uint32_t i = 0; i < size; i++ )
+            fprintf( fp, "%02"PRIx8, data[i] );
+    }
 }
 
-static inline int isom_print_simple( FILE *fp, isom_box_t *box, int level, char *name )
+static inline int isom_print_simple( isom_printer_t *printer, isom_box_t *box, int level, char *name )
 {
     int indent = level;
     if( box->type.fourcc != ISOM_BOX_TYPE_UUID.fourcc )
     {
-        lsmash_ifprintf( fp, indent++, "[%s: %s]\n", isom_4cc2str( box->type.fourcc ), name );
-        lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-        lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+        isom_iprint_box( printer, indent++, isom_4cc2str( box->type.fourcc ), name );
+        isom_iprint_uint( printer, indent, "position", box->pos );
+        isom_iprint_uint( printer, indent, "size", box->size );
     }
     else
     {
-        lsmash_ifprintf( fp, indent++, "[uuid: UUID Box]\n" );
-        lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-        lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
-        lsmash_ifprintf( fp, indent++, "usertype\n" );
+        isom_iprint_box( printer, indent++, "uuid", "UUID Box" );
+        isom_iprint_uint( printer, indent, "position", box->pos );
+        isom_iprint_uint( printer, indent, "size", box->size );
+        isom_iprint_label( printer, indent++, "usertype" );
         if( isom_is_printable_4cc( box->type.user.fourcc ) )
-            lsmash_ifprintf( fp, indent, "type = %s\n", isom_4cc2str( box->type.user.fourcc ) );
-        lsmash_ifprintf( fp, indent, "name = %s\n", name );
-        lsmash_ifprintf( fp, indent, "uuid = 0x%08"PRIx32"-%04"PRIx16"-%04"PRIx16"-%04"PRIx16"-%04"PRIx16"0x%08"PRIx32"\n",
-                         box->type.user.fourcc,
-                         (box->type.user.id[0] << 8) | box->type.user.id[1], (box->type.user.id[2] << 8) | box->type.user.id[3],
-                         (box->type.user.id[4] << 8) | box->type.user.id[5], (box->type.user.id[6] << 8) | box->type.user.id[7],
-                         (box->type.user.id[8] << 24) | (box->type.user.id[9] << 16) | (box->type.user.id[10] << 8) | box->type.user.id[11] );
+            isom_iprint_fourcc( printer, indent, "type", box->type.user.fourcc );
+        isom_iprint_string( printer, indent, "name", name );
+        isom_ifprintf_uuid( printer, indent, "uuid", box->type.user.fourcc, box->type.user.id );
     }
     return 0;
 }
 
-static void isom_print_basebox_common( FILE *fp, int indent, isom_box_t *box, char *name )
+static void isom_print_basebox_common( isom_printer_t *printer, int indent, isom_box_t *box, char *name )
 {
-    isom_print_simple( fp, box, indent, name );
+    isom_print_simple( printer, box, indent, name );
 }
 
-static void isom_print_fullbox_common( FILE *fp, int indent, isom_box_t *box, char *name )
+static void isom_print_fullbox_common( isom_printer_t *printer, int indent, isom_box_t *box, char *name )
 {
-    isom_print_simple( fp, box, indent++, name );
-    lsmash_ifprintf( fp, indent, "version = %"PRIu8"\n", box->version );
-    lsmash_ifprintf( fp, indent, "flags = 0x%06"PRIx32"\n", box->flags & 0x00ffffff );
+    isom_print_simple( printer, box, indent++, name );
+    isom_iprint_uint( printer, indent, "version", box->version );
+    isom_iprint_hex( printer, indent, "flags", box->flags & 0x00ffffff, 6 );
 }
 
-static void isom_print_box_common( FILE *fp, int indent, isom_box_t *box, char *name )
+static void isom_print_box_common( isom_printer_t *printer, int indent, isom_box_t *box, char *name )
 {
     isom_box_t *parent = box->parent;
     if( lsmash_check_box_type_identical( parent->type, ISOM_BOX_TYPE_STSD ) )
     {
-        isom_print_basebox_common( fp, indent, box, name );
+        isom_print_basebox_common( printer, indent, box, name );
         return;
     }
     if( isom_is_fullbox( box ) )
-        isom_print_fullbox_common( fp, indent, box, name );
+        isom_print_fullbox_common( printer, indent, box, name );
     else
-        isom_print_basebox_common( fp, indent, box, name );
+        isom_print_basebox_common( printer, indent, box, name );
 }
 
-static int isom_print_unknown( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_unknown( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     int indent = level;
     if( box->type.fourcc != ISOM_BOX_TYPE_UUID.fourcc )
     {
-        lsmash_ifprintf( fp, indent++, "[%s]\n", isom_4cc2str( box->type.fourcc ) );
-        lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-        lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+        isom_iprint_box( printer, indent++, isom_4cc2str( box->type.fourcc ), NULL );
+        isom_iprint_uint( printer, indent, "position", box->pos );
+        isom_iprint_uint( printer, indent, "size", box->size );
     }
     else
     {
-        lsmash_ifprintf( fp, indent++, "[uuid: UUID Box]\n" );
-        lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-        lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
-        lsmash_ifprintf( fp, indent++, "usertype\n" );
+        isom_iprint_box( printer, indent++, "uuid", "UUID Box" );
+        isom_iprint_uint( printer, indent, "position", box->pos );
+        isom_iprint_uint( printer, indent, "size", box->size );
+        isom_iprint_label( printer, indent++, "usertype" );
         if( isom_is_printable_4cc( box->type.user.fourcc ) )
-            lsmash_ifprintf( fp, indent, "type = %s\n", isom_4cc2str( box->type.user.fourcc ) );
-        lsmash_ifprintf( fp, indent, "uuid = 0x%08"PRIx32"-%04"PRIx16"-%04"PRIx16"-%04"PRIx16"-%04"PRIx16"%08"PRIx32"\n",
-                         box->type.user.fourcc,
-                         (box->type.user.id[0] << 8) | box->type.user.id[1], (box->type.user.id[2] << 8) | box->type.user.id[3],
-                         (box->type.user.id[4] << 8) | box->type.user.id[5], (box->type.user.id[6] << 8) | box->type.user.id[7],
-                         (box->type.user.id[8] << 24) | (box->type.user.id[9] << 16) | (box->type.user.id[10] << 8) | box->type.user.id[11] );
+            isom_iprint_fourcc( printer, indent, "type", box->type.user.fourcc );
+        isom_ifprintf_uuid( printer, indent, "uuid", box->type.user.fourcc, box->type.user.id );
     }
     return 0;
 }
 
-static void isom_print_brand_description( FILE *fp, lsmash_brand_type brand )
+static void isom_print_brand_description( isom_printer_t *printer, lsmash_brand_type brand )
 {
     if( brand == 0 )
         return;
@@ -336,315 +1044,331 @@ static void isom_print_brand_description( FILE *fp, lsmash_brand_type brand )
     for( int i = 0; brand_description_table[i].description; i++ )
         if( brand == brand_description_table[i].brand )
         {
-            fprintf( fp, " : %s\n", brand_description_table[i].description );
+            isom_printer_put_attribute( printer, "note", " : ", "", brand_description_table[i].description );
             return;
         }
-    fprintf( fp, "\n" );
 }
 
 static void isom_print_file_type
 (
-    FILE     *fp,
-    int       indent,
-    uint32_t  major_brand,
-    uint32_t  minor_version,
-    uint32_t  brand_count,
-    uint32_t *compatible_brands
+    isom_printer_t *printer,
+    int             indent,
+    uint32_t        major_brand,
+    uint32_t        minor_version,
+    uint32_t        brand_count,
+    uint32_t       *compatible_brands
 )
 {
-    lsmash_ifprintf( fp, indent, "major_brand = %s", isom_4cc2str( major_brand ) );
-    isom_print_brand_description( fp, major_brand );
-    lsmash_ifprintf( fp, indent, "minor_version = %"PRIu32"\n", minor_version );
-    lsmash_ifprintf( fp, indent++, "compatible_brands\n" );
+    isom_iprint_fourcc( printer, indent, "major_brand", major_brand );
+    isom_print_brand_description( printer, major_brand );
+    isom_iprint_uint( printer, indent, "minor_version", minor_version );
+    isom_iprint_label( printer, indent++, "compatible_brands" );
     for( uint32_t i = 0; i < brand_count; i++ )
     {
         if( compatible_brands[i] )
         {
-            lsmash_ifprintf( fp, indent, "brand[%"PRIu32"] = %s", i, isom_4cc2str( compatible_brands[i] ) );
-            isom_print_brand_description( fp, compatible_brands[i] );
+            isom_iprint_fourcc_at( printer, indent, "brand", i, compatible_brands[i] );
+            isom_print_brand_description( printer, compatible_brands[i] );
         }
         else
-            lsmash_ifprintf( fp, indent, "brand[%"PRIu32"] = (void)\n", i );
+        {
+            uint64_t index = i;
+            isom_ifprintf_none( printer, indent, "brand", &index, "(void)" );
+        }
     }
 }
 
-static int isom_print_ftyp( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_ftyp( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_ftyp_t *ftyp = (isom_ftyp_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "File Type Box" );
-    isom_print_file_type( fp, indent, ftyp->major_brand, ftyp->minor_version, ftyp->brand_count, ftyp->compatible_brands );
+    isom_print_box_common( printer, indent++, box, "File Type Box" );
+    isom_print_file_type( printer, indent, ftyp->major_brand, ftyp->minor_version, ftyp->brand_count, ftyp->compatible_brands );
     return 0;
 }
 
-static int isom_print_styp( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_styp( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     /* Print 'valid' if this box is the first box in a file. */
     int valid;
-    if( file->print
-     && file->print->head
-     && file->print->head->data )
+    if( file->printer )
+        valid = (box->pos == 0);
+    else if( file->print
+          && file->print->head
+          && file->print->head->data )
         valid = (box == ((isom_print_entry_t *)file->print->head->data)->box);
     else
         valid = 0;
     char *name = valid ? "Segment Type Box (valid)" : "Segment Type Box";
     isom_styp_t *styp = (isom_styp_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, name );
-    isom_print_file_type( fp, indent, styp->major_brand, styp->minor_version, styp->brand_count, styp->compatible_brands );
+    isom_print_box_common( printer, indent++, box, name );
+    isom_print_file_type( printer, indent, styp->major_brand, styp->minor_version, styp->brand_count, styp->compatible_brands );
     return 0;
 }
 
-static int isom_print_sidx( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_sidx( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_sidx_t *)box)->list )
         return -1;
     isom_sidx_t *sidx = (isom_sidx_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Segment Index Box" );
-    lsmash_ifprintf( fp, indent, "reference_ID = %"PRIu32"\n", sidx->reference_ID );
-    lsmash_ifprintf( fp, indent, "timescale = %"PRIu32"\n", sidx->timescale );
-    lsmash_ifprintf( fp, indent, "earliest_presentation_time = %"PRIu64"\n", sidx->earliest_presentation_time );
-    lsmash_ifprintf( fp, indent, "first_offset = %"PRIu64"\n", sidx->first_offset );
-    lsmash_ifprintf( fp, indent, "reserved = %"PRIu16"\n", sidx->reserved );
-    lsmash_ifprintf( fp, indent, "reference_count = %"PRIu16"\n", sidx->reference_count );
+    isom_print_box_common( printer, indent++, box, "Segment Index Box" );
+    isom_iprint_uint( printer, indent, "reference_ID", sidx->reference_ID );
+    isom_iprint_uint( printer, indent, "timescale", sidx->timescale );
+    isom_iprint_uint( printer, indent, "earliest_presentation_time", sidx->earliest_presentation_time );
+    isom_iprint_uint( printer, indent, "first_offset", sidx->first_offset );
+    isom_iprint_uint( printer, indent, "reserved", sidx->reserved );
+    isom_iprint_uint( printer, indent, "reference_count", sidx->reference_count );
     uint32_t i = 0;
     for( lsmash_entry_t *entry = sidx->list->head; entry; entry = entry->next )
     {
         isom_sidx_referenced_item_t *data = (isom_sidx_referenced_item_t *)entry->data;
-        lsmash_ifprintf( fp, indent++, "entry[%"PRIu32"]\n", i++ );
-        lsmash_ifprintf( fp, indent, "reference_type = %"PRIu8" (%s)\n", data->reference_type, data->reference_type ? "index" : "media" );
-        lsmash_ifprintf( fp, indent, "reference_size = %"PRIu32"\n", data->reference_size );
-        lsmash_ifprintf( fp, indent, "subsegment_duration = %"PRIu32"\n", data->subsegment_duration );
-        lsmash_ifprintf( fp, indent, "starts_with_SAP = %"PRIu8"%s\n", data->starts_with_SAP, data->starts_with_SAP ? " (yes)" : "" );
-        lsmash_ifprintf( fp, indent, "SAP_type = %"PRIu8"%s\n", data->SAP_type, data->SAP_type == 0 ? " (unknown)" : "" );
-        lsmash_ifprintf( fp, indent--, "SAP_delta_time = %"PRIu32"\n", data->SAP_delta_time );
+        isom_iprint_element( printer, indent++, "entry", i++ );
+        isom_iprint_uint( printer, indent, "reference_type", data->reference_type );
+        isom_iprint_note( printer, "%s", data->reference_type ? "index" : "media" );
+        isom_iprint_uint( printer, indent, "reference_size", data->reference_size );
+        isom_iprint_uint( printer, indent, "subsegment_duration", data->subsegment_duration );
+        isom_iprint_uint( printer, indent, "starts_with_SAP", data->starts_with_SAP );
+        if( data->starts_with_SAP )
+            isom_iprint_note( printer, "yes" );
+        isom_iprint_uint( printer, indent, "SAP_type", data->SAP_type );
+        if( data->SAP_type == 0 )
+            isom_iprint_note( printer, "unknown" );
+        isom_iprint_uint( printer, indent--, "SAP_delta_time", data->SAP_delta_time );
     }
     return 0;
 }
 
-static int isom_print_moov( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_moov( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Movie Box" );
+    return isom_print_simple( printer, box, level, "Movie Box" );
 }
 
-static int isom_print_mvhd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_mvhd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_mvhd_t *mvhd = (isom_mvhd_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Movie Header Box" );
-    lsmash_ifprintf( fp, indent, "creation_time = %s", isom_mp4time2utc( mvhd->creation_time ) );
-    lsmash_ifprintf( fp, indent, "modification_time = %s", isom_mp4time2utc( mvhd->modification_time ) );
-    lsmash_ifprintf( fp, indent, "timescale = %"PRIu32"\n", mvhd->timescale );
-    isom_ifprintf_duration( fp, indent, "duration", mvhd->duration, mvhd->timescale );
-    lsmash_ifprintf( fp, indent, "rate = %f\n", lsmash_fixed2double( mvhd->rate, 16 ) );
-    lsmash_ifprintf( fp, indent, "volume = %f\n", lsmash_fixed2double( mvhd->volume, 8 ) );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%04"PRIx16"\n", mvhd->reserved );
+    isom_print_box_common( printer, indent++, box, "Movie Header Box" );
+    isom_ifprintf_time( printer, indent, "creation_time", mvhd->creation_time );
+    isom_ifprintf_time( printer, indent, "modification_time", mvhd->modification_time );
+    isom_iprint_uint( printer, indent, "timescale", mvhd->timescale );
+    isom_ifprintf_duration( printer, indent, "duration", mvhd->duration, mvhd->timescale );
+    isom_iprint_float( printer, indent, "rate", lsmash_fixed2double( mvhd->rate, 16 ) );
+    isom_iprint_float( printer, indent, "volume", lsmash_fixed2double( mvhd->volume, 8 ) );
+    isom_iprint_hex( printer, indent, "reserved", mvhd->reserved, 4 );
     if( file->qt_compatible )
     {
-        lsmash_ifprintf( fp, indent, "preferredLong1 = 0x%08"PRIx32"\n", mvhd->preferredLong[0] );
-        lsmash_ifprintf( fp, indent, "preferredLong2 = 0x%08"PRIx32"\n", mvhd->preferredLong[1] );
-        lsmash_ifprintf( fp, indent, "transformation matrix\n" );
-        isom_ifprintf_matrix( fp, indent + 1, mvhd->matrix );
-        lsmash_ifprintf( fp, indent, "previewTime = %"PRId32"\n", mvhd->previewTime );
-        lsmash_ifprintf( fp, indent, "previewDuration = %"PRId32"\n", mvhd->previewDuration );
-        lsmash_ifprintf( fp, indent, "posterTime = %"PRId32"\n", mvhd->posterTime );
-        lsmash_ifprintf( fp, indent, "selectionTime = %"PRId32"\n", mvhd->selectionTime );
-        lsmash_ifprintf( fp, indent, "selectionDuration = %"PRId32"\n", mvhd->selectionDuration );
-        lsmash_ifprintf( fp, indent, "currentTime = %"PRId32"\n", mvhd->currentTime );
+        isom_iprint_hex( printer, indent, "preferredLong1", mvhd->preferredLong[0], 8 );
+        isom_iprint_hex( printer, indent, "preferredLong2", mvhd->preferredLong[1], 8 );
+        isom_ifprintf_matrix( printer, indent, "transformation matrix", mvhd->matrix );
+        isom_iprint_int( printer, indent, "previewTime", mvhd->previewTime );
+        isom_iprint_int( printer, indent, "previewDuration", mvhd->previewDuration );
+        isom_iprint_int( printer, indent, "posterTime", mvhd->posterTime );
+        isom_iprint_int( printer, indent, "selectionTime", mvhd->selectionTime );
+        isom_iprint_int( printer, indent, "selectionDuration", mvhd->selectionDuration );
+        isom_iprint_int( printer, indent, "currentTime", mvhd->currentTime );
     }
     else
     {
-        lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", mvhd->preferredLong[0] );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", mvhd->preferredLong[1] );
-        lsmash_ifprintf( fp, indent, "transformation matrix\n" );
-        isom_ifprintf_matrix( fp, indent + 1, mvhd->matrix );
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%08"PRIx32"\n", mvhd->previewTime );
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%08"PRIx32"\n", mvhd->previewDuration );
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%08"PRIx32"\n", mvhd->posterTime );
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%08"PRIx32"\n", mvhd->selectionTime );
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%08"PRIx32"\n", mvhd->selectionDuration );
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%08"PRIx32"\n", mvhd->currentTime );
+        isom_iprint_hex( printer, indent, "reserved", mvhd->preferredLong[0], 8 );
+        isom_iprint_hex( printer, indent, "reserved", mvhd->preferredLong[1], 8 );
+        isom_ifprintf_matrix( printer, indent, "transformation matrix", mvhd->matrix );
+        isom_iprint_hex( printer, indent, "pre_defined", mvhd->previewTime, 8 );
+        isom_iprint_hex( printer, indent, "pre_defined", mvhd->previewDuration, 8 );
+        isom_iprint_hex( printer, indent, "pre_defined", mvhd->posterTime, 8 );
+        isom_iprint_hex( printer, indent, "pre_defined", mvhd->selectionTime, 8 );
+        isom_iprint_hex( printer, indent, "pre_defined", mvhd->selectionDuration, 8 );
+        isom_iprint_hex( printer, indent, "pre_defined", mvhd->currentTime, 8 );
     }
-    lsmash_ifprintf( fp, indent, "next_track_ID = %"PRIu32"\n", mvhd->next_track_ID );
+    isom_iprint_uint( printer, indent, "next_track_ID", mvhd->next_track_ID );
     return 0;
 }
 
-static void isom_pring_qt_color_table( FILE *fp, int indent, isom_qt_color_table_t *color_table )
+static void isom_pring_qt_color_table( isom_printer_t *printer, int indent, isom_qt_color_table_t *color_table )
 {
     isom_qt_color_array_t *array = color_table->array;
     if( !array )
         return;
-    lsmash_ifprintf( fp, indent, "ctSeed = %"PRIu32"\n", color_table->seed );
-    lsmash_ifprintf( fp, indent, "ctFlags = 0x%04"PRIx16"\n", color_table->flags );
-    lsmash_ifprintf( fp, indent, "ctSize = %"PRIu16"\n", color_table->size );
-    lsmash_ifprintf( fp, indent++, "ctTable\n" );
+    isom_iprint_uint( printer, indent, "ctSeed", color_table->seed );
+    isom_iprint_hex( printer, indent, "ctFlags", color_table->flags, 4 );
+    isom_iprint_uint( printer, indent, "ctSize", color_table->size );
+    isom_iprint_label( printer, indent++, "ctTable" );
     for( uint16_t i = 0; i <= color_table->size; i++ )
-        lsmash_ifprintf( fp, indent,
-                         "color[%"PRIu16"] = { 0x%04"PRIx16", 0x%04"PRIx16", 0x%04"PRIx16", 0x%04"PRIx16" }\n",
+    {
+        uint64_t index    = i;
+        uint64_t value[4] = { array[i].value, array[i].r, array[i].g, array[i].b };
+        if( !isom_printer_is_text( printer ) )
+        {
+            isom_printer_put_uint_array( printer, indent, "color", &index, value, 4 );
+            continue;
+        }
+        isom_printer_open_node( printer, indent );
+        lsmash_ifprintf( printer->emitter.fp, indent,
+                         "color[%"PRIu16"] = { 0x%04"PRIx16", 0x%04"PRIx16", 0x%04"PRIx16", 0x%04"PRIx16" }",
                          i, array[i].value, array[i].r, array[i].g, array[i].b );
+    }
 }
 
-static int isom_print_ctab( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_ctab( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_ctab_t *ctab = (isom_ctab_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent, box, "Color Table Box" );
-    isom_pring_qt_color_table( fp, indent + 1, &ctab->color_table );
+    isom_print_box_common( printer, indent, box, "Color Table Box" );
+    isom_pring_qt_color_table( printer, indent + 1, &ctab->color_table );
     return 0;
 }
 
-static int isom_print_iods( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_iods( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    extern void mp4sys_print_descriptor( FILE *, void *, int );
+    extern void mp4sys_print_descriptor( isom_printer_t *, void *, int );
     isom_iods_t *iods = (isom_iods_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent, box, "Object Descriptor Box" );
-    mp4sys_print_descriptor( fp, iods->OD, indent + 1 );
+    isom_print_box_common( printer, indent, box, "Object Descriptor Box" );
+    mp4sys_print_descriptor( printer, iods->OD, indent + 1 );
     return 0;
 }
 
-static int isom_print_trak( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_trak( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Track Box" );
+    return isom_print_simple( printer, box, level, "Track Box" );
 }
 
-static int isom_print_tkhd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_tkhd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_tkhd_t *tkhd = (isom_tkhd_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Track Header Box" );
+    isom_print_box_common( printer, indent++, box, "Track Header Box" );
     ++indent;
     if( tkhd->flags & ISOM_TRACK_ENABLED )
-        lsmash_ifprintf( fp, indent, "Track enabled\n" );
+        isom_iprint_label( printer, indent, "Track enabled" );
     else
-        lsmash_ifprintf( fp, indent, "Track disabled\n" );
+        isom_iprint_label( printer, indent, "Track disabled" );
     if( tkhd->flags & ISOM_TRACK_IN_MOVIE )
-        lsmash_ifprintf( fp, indent, "Track in movie\n" );
+        isom_iprint_label( printer, indent, "Track in movie" );
     if( tkhd->flags & ISOM_TRACK_IN_PREVIEW )
-        lsmash_ifprintf( fp, indent, "Track in preview\n" );
+        isom_iprint_label( printer, indent, "Track in preview" );
     if( file->qt_compatible && (tkhd->flags & QT_TRACK_IN_POSTER) )
-        lsmash_ifprintf( fp, indent, "Track in poster\n" );
-    lsmash_ifprintf( fp, --indent, "creation_time = %s", isom_mp4time2utc( tkhd->creation_time ) );
-    lsmash_ifprintf( fp, indent, "modification_time = %s", isom_mp4time2utc( tkhd->modification_time ) );
-    lsmash_ifprintf( fp, indent, "track_ID = %"PRIu32"\n", tkhd->track_ID );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", tkhd->reserved1 );
+        isom_iprint_label( printer, indent, "Track in poster" );
+    isom_ifprintf_time( printer, --indent, "creation_time", tkhd->creation_time );
+    isom_ifprintf_time( printer, indent, "modification_time", tkhd->modification_time );
+    isom_iprint_uint( printer, indent, "track_ID", tkhd->track_ID );
+    isom_iprint_hex( printer, indent, "reserved", tkhd->reserved1, 8 );
     if( file->moov && file->moov->mvhd )
-        isom_ifprintf_duration( fp, indent, "duration", tkhd->duration, file->moov->mvhd->timescale );
+        isom_ifprintf_duration( printer, indent, "duration", tkhd->duration, file->moov->mvhd->timescale );
     else
-        isom_ifprintf_duration( fp, indent, "duration", tkhd->duration, 0 );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", tkhd->reserved2[0] );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", tkhd->reserved2[1] );
-    lsmash_ifprintf( fp, indent, "layer = %"PRId16"\n", tkhd->layer );
-    lsmash_ifprintf( fp, indent, "alternate_group = %"PRId16"\n", tkhd->alternate_group );
-    lsmash_ifprintf( fp, indent, "volume = %f\n", lsmash_fixed2double( tkhd->volume, 8 ) );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%04"PRIx16"\n", tkhd->reserved3 );
-    lsmash_ifprintf( fp, indent, "transformation matrix\n" );
-    isom_ifprintf_matrix( fp, indent + 1, tkhd->matrix );
-    lsmash_ifprintf( fp, indent, "width = %f\n", lsmash_fixed2double( tkhd->width, 16 ) );
-    lsmash_ifprintf( fp, indent, "height = %f\n", lsmash_fixed2double( tkhd->height, 16 ) );
+        isom_ifprintf_duration( printer, indent, "duration", tkhd->duration, 0 );
+    isom_iprint_hex( printer, indent, "reserved", tkhd->reserved2[0], 8 );
+    isom_iprint_hex( printer, indent, "reserved", tkhd->reserved2[1], 8 );
+    isom_iprint_int( printer, indent, "layer", tkhd->layer );
+    isom_iprint_int( printer, indent, "alternate_group", tkhd->alternate_group );
+    isom_iprint_float( printer, indent, "volume", lsmash_fixed2double( tkhd->volume, 8 ) );
+    isom_iprint_hex( printer, indent, "reserved", tkhd->reserved3, 4 );
+    isom_ifprintf_matrix( printer, indent, "transformation matrix", tkhd->matrix );
+    isom_iprint_float( printer, indent, "width", lsmash_fixed2double( tkhd->width, 16 ) );
+    isom_iprint_float( printer, indent, "height", lsmash_fixed2double( tkhd->height, 16 ) );
     return 0;
 }
 
-static int isom_print_tapt( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_tapt( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Track Aperture Mode Dimensions Box" );
+    return isom_print_simple( printer, box, level, "Track Aperture Mode Dimensions Box" );
 }
 
-static int isom_print_clef( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_clef( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_clef_t *clef = (isom_clef_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Track Clean Aperture Dimensions Box" );
-    lsmash_ifprintf( fp, indent, "width = %f\n", lsmash_fixed2double( clef->width, 16 ) );
-    lsmash_ifprintf( fp, indent, "height = %f\n", lsmash_fixed2double( clef->height, 16 ) );
+    isom_print_box_common( printer, indent++, box, "Track Clean Aperture Dimensions Box" );
+    isom_iprint_float( printer, indent, "width", lsmash_fixed2double( clef->width, 16 ) );
+    isom_iprint_float( printer, indent, "height", lsmash_fixed2double( clef->height, 16 ) );
     return 0;
 }
 
-static int isom_print_prof( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_prof( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_prof_t *prof = (isom_prof_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Track Production Aperture Dimensions Box" );
-    lsmash_ifprintf( fp, indent, "width = %f\n", lsmash_fixed2double( prof->width, 16 ) );
-    lsmash_ifprintf( fp, indent, "height = %f\n", lsmash_fixed2double( prof->height, 16 ) );
+    isom_print_box_common( printer, indent++, box, "Track Production Aperture Dimensions Box" );
+    isom_iprint_float( printer, indent, "width", lsmash_fixed2double( prof->width, 16 ) );
+    isom_iprint_float( printer, indent, "height", lsmash_fixed2double( prof->height, 16 ) );
     return 0;
 }
 
-static int isom_print_enof( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_enof( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_enof_t *enof = (isom_enof_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Track Encoded Pixels Dimensions Box" );
-    lsmash_ifprintf( fp, indent, "width = %f\n", lsmash_fixed2double( enof->width, 16 ) );
-    lsmash_ifprintf( fp, indent, "height = %f\n", lsmash_fixed2double( enof->height, 16 ) );
+    isom_print_box_common( printer, indent++, box, "Track Encoded Pixels Dimensions Box" );
+    isom_iprint_float( printer, indent, "width", lsmash_fixed2double( enof->width, 16 ) );
+    isom_iprint_float( printer, indent, "height", lsmash_fixed2double( enof->height, 16 ) );
     return 0;
 }
 
-static int isom_print_edts( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_edts( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Edit Box" );
+    return isom_print_simple( printer, box, level, "Edit Box" );
 }
 
-static int isom_print_elst( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_elst( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_elst_t *elst = (isom_elst_t *)box;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Edit List Box" );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", elst->list->entry_count );
+    isom_print_box_common( printer, indent++, box, "Edit List Box" );
+    isom_iprint_uint( printer, indent, "entry_count", elst->list->entry_count );
     for( lsmash_entry_t *entry = elst->list->head; entry; entry = entry->next )
     {
         isom_elst_entry_t *data = (isom_elst_entry_t *)entry->data;
-        lsmash_ifprintf( fp, indent++, "entry[%"PRIu32"]\n", i++ );
-        lsmash_ifprintf( fp, indent, "segment_duration = %"PRIu64"\n", data->segment_duration );
-        lsmash_ifprintf( fp, indent, "media_time = %"PRId64"\n", data->media_time );
-        lsmash_ifprintf( fp, indent--, "media_rate = %f\n", lsmash_fixed2double( data->media_rate, 16 ) );
+        isom_iprint_element( printer, indent++, "entry", i++ );
+        isom_iprint_uint( printer, indent, "segment_duration", data->segment_duration );
+        isom_iprint_int( printer, indent, "media_time", data->media_time );
+        isom_iprint_float( printer, indent--, "media_rate", lsmash_fixed2double( data->media_rate, 16 ) );
     }
     return 0;
 }
 
-static int isom_print_tref( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_tref( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Track Reference Box" );
+    return isom_print_simple( printer, box, level, "Track Reference Box" );
 }
 
-static int isom_print_track_reference_type( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_track_reference_type( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_tref_type_t *ref = (isom_tref_type_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Track Reference Type Box" );
+    isom_print_box_common( printer, indent++, box, "Track Reference Type Box" );
     for( uint32_t i = 0; i < ref->ref_count; i++ )
-        lsmash_ifprintf( fp, indent, "track_ID[%"PRIu32"] = %"PRIu32"\n", i, ref->track_ID[i] );
+        isom_iprint_uint_at( printer, indent, "track_ID", i, ref->track_ID[i] );
     return 0;
 }
 
-static int isom_print_mdia( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_mdia( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Media Box" );
+    return isom_print_simple( printer, box, level, "Media Box" );
 }
 
-static int isom_print_mdhd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_mdhd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_mdhd_t *mdhd = (isom_mdhd_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Media Header Box" );
-    lsmash_ifprintf( fp, indent, "creation_time = %s", isom_mp4time2utc( mdhd->creation_time ) );
-    lsmash_ifprintf( fp, indent, "modification_time = %s", isom_mp4time2utc( mdhd->modification_time ) );
-    lsmash_ifprintf( fp, indent, "timescale = %"PRIu32"\n", mdhd->timescale );
-    isom_ifprintf_duration( fp, indent, "duration", mdhd->duration, mdhd->timescale );
+    isom_print_box_common( printer, indent++, box, "Media Header Box" );
+    isom_ifprintf_time( printer, indent, "creation_time", mdhd->creation_time );
+    isom_ifprintf_time( printer, indent, "modification_time", mdhd->modification_time );
+    isom_iprint_uint( printer, indent, "timescale", mdhd->timescale );
+    isom_ifprintf_duration( printer, indent, "duration", mdhd->duration, mdhd->timescale );
     if( mdhd->language >= 0x800 )
-        lsmash_ifprintf( fp, indent, "language = %s\n", isom_unpack_iso_language( mdhd->language ) );
+        isom_iprint_string( printer, indent, "language", isom_unpack_iso_language( mdhd->language ) );
     else
-        lsmash_ifprintf( fp, indent, "language = %"PRIu16"\n", mdhd->language );
+        isom_iprint_uint( printer, indent, "language", mdhd->language );
     if( file->qt_compatible )
-        lsmash_ifprintf( fp, indent, "quality = %"PRId16"\n", mdhd->quality );
+        isom_iprint_int( printer, indent, "quality", mdhd->quality );
     else
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%04"PRIx16"\n", mdhd->quality );
+        isom_iprint_hex( printer, indent, "pre_defined", mdhd->quality, 4 );
     return 0;
 }
 
-static int isom_print_hdlr( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_hdlr( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_hdlr_t *hdlr = (isom_hdlr_t *)box;
     int indent = level;
@@ -653,314 +1377,300 @@ static int isom_print_hdlr( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
         return LSMASH_ERR_MEMORY_ALLOC;
     memcpy( str, hdlr->componentName, hdlr->componentName_length );
     str[hdlr->componentName_length] = 0;
-    isom_print_box_common( fp, indent++, box, "Handler Reference Box" );
+    isom_print_box_common( printer, indent++, box, "Handler Reference Box" );
     if( file->qt_compatible )
     {
-        lsmash_ifprintf( fp, indent, "componentType = %s\n", isom_4cc2str( hdlr->componentType ) );
-        lsmash_ifprintf( fp, indent, "componentSubtype = %s\n", isom_4cc2str( hdlr->componentSubtype ) );
-        lsmash_ifprintf( fp, indent, "componentManufacturer = %s\n", isom_4cc2str( hdlr->componentManufacturer ) );
-        lsmash_ifprintf( fp, indent, "componentFlags = 0x%08"PRIx32"\n", hdlr->componentFlags );
-        lsmash_ifprintf( fp, indent, "componentFlagsMask = 0x%08"PRIx32"\n", hdlr->componentFlagsMask );
+        isom_iprint_fourcc( printer, indent, "componentType", hdlr->componentType );
+        isom_iprint_fourcc( printer, indent, "componentSubtype", hdlr->componentSubtype );
+        isom_iprint_fourcc( printer, indent, "componentManufacturer", hdlr->componentManufacturer );
+        isom_iprint_hex( printer, indent, "componentFlags", hdlr->componentFlags, 8 );
+        isom_iprint_hex( printer, indent, "componentFlagsMask", hdlr->componentFlagsMask, 8 );
         if( hdlr->componentName_length )
-            lsmash_ifprintf( fp, indent, "componentName = %s\n", &str[1] );
+            isom_iprint_string( printer, indent, "componentName", &str[1] );
         else
-            lsmash_ifprintf( fp, indent, "componentName = \n" );
+            isom_iprint_string( printer, indent, "componentName", "" );
     }
     else
     {
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%08"PRIx32"\n", hdlr->componentType );
-        lsmash_ifprintf( fp, indent, "handler_type = %s\n", isom_4cc2str( hdlr->componentSubtype ) );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", hdlr->componentManufacturer );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", hdlr->componentFlags );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", hdlr->componentFlagsMask );
-        lsmash_ifprintf( fp, indent, "name = %s\n", str );
+        isom_iprint_hex( printer, indent, "pre_defined", hdlr->componentType, 8 );
+        isom_iprint_fourcc( printer, indent, "handler_type", hdlr->componentSubtype );
+        isom_iprint_hex( printer, indent, "reserved", hdlr->componentManufacturer, 8 );
+        isom_iprint_hex( printer, indent, "reserved", hdlr->componentFlags, 8 );
+        isom_iprint_hex( printer, indent, "reserved", hdlr->componentFlagsMask, 8 );
+        isom_iprint_string( printer, indent, "name", str );
     }
     lsmash_free( str );
     return 0;
 }
 
-static int isom_print_minf( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_minf( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Media Information Box" );
+    return isom_print_simple( printer, box, level, "Media Information Box" );
 }
 
-static int isom_print_vmhd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_vmhd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_vmhd_t *vmhd = (isom_vmhd_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Video Media Header Box" );
-    lsmash_ifprintf( fp, indent, "graphicsmode = %"PRIu16"\n", vmhd->graphicsmode );
-    lsmash_ifprintf( fp, indent, "opcolor\n" );
-    isom_ifprintf_rgb_color( fp, indent + 1, vmhd->opcolor );
+    isom_print_box_common( printer, indent++, box, "Video Media Header Box" );
+    isom_iprint_uint( printer, indent, "graphicsmode", vmhd->graphicsmode );
+    isom_ifprintf_rgb_color( printer, indent, "opcolor", vmhd->opcolor );
     return 0;
 }
 
-static int isom_print_smhd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_smhd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_smhd_t *smhd = (isom_smhd_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Sound Media Header Box" );
-    lsmash_ifprintf( fp, indent, "balance = %f\n", lsmash_fixed2double( smhd->balance, 8 ) );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%04"PRIx16"\n", smhd->reserved );
+    isom_print_box_common( printer, indent++, box, "Sound Media Header Box" );
+    isom_iprint_float( printer, indent, "balance", lsmash_fixed2double( smhd->balance, 8 ) );
+    isom_iprint_hex( printer, indent, "reserved", smhd->reserved, 4 );
     return 0;
 }
 
-static int isom_print_hmhd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_hmhd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_hmhd_t *hmhd = (isom_hmhd_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Hint Media Header Box" );
-    lsmash_ifprintf( fp, indent, "maxPDUsize = %"PRIu16"\n", hmhd->maxPDUsize );
-    lsmash_ifprintf( fp, indent, "avgPDUsize = %"PRIu16"\n", hmhd->avgPDUsize );
-    lsmash_ifprintf( fp, indent, "maxbitrate = %"PRIu32"\n", hmhd->maxbitrate );
-    lsmash_ifprintf( fp, indent, "avgbitrate = %"PRIu32"\n", hmhd->avgbitrate );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", hmhd->reserved );
+    isom_print_box_common( printer, indent++, box, "Hint Media Header Box" );
+    isom_iprint_uint( printer, indent, "maxPDUsize", hmhd->maxPDUsize );
+    isom_iprint_uint( printer, indent, "avgPDUsize", hmhd->avgPDUsize );
+    isom_iprint_uint( printer, indent, "maxbitrate", hmhd->maxbitrate );
+    isom_iprint_uint( printer, indent, "avgbitrate", hmhd->avgbitrate );
+    isom_iprint_hex( printer, indent, "reserved", hmhd->reserved, 8 );
     return 0;
 }
 
-static int isom_print_nmhd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_nmhd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    isom_print_box_common( fp, level, box, "Null Media Header Box" );
+    isom_print_box_common( printer, level, box, "Null Media Header Box" );
     return 0;
 }
 
-static int isom_print_gmhd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_gmhd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Generic Media Information Header Box" );
+    return isom_print_simple( printer, box, level, "Generic Media Information Header Box" );
 }
 
-static int isom_print_gmin( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_gmin( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_gmin_t *gmin = (isom_gmin_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Generic Media Information Box" );
-    lsmash_ifprintf( fp, indent, "graphicsmode = %"PRIu16"\n", gmin->graphicsmode );
-    lsmash_ifprintf( fp, indent, "opcolor\n" );
-    isom_ifprintf_rgb_color( fp, indent + 1, gmin->opcolor );
-    lsmash_ifprintf( fp, indent, "balance = %f\n", lsmash_fixed2double( gmin->balance, 8 ) );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%04"PRIx16"\n", gmin->reserved );
+    isom_print_box_common( printer, indent++, box, "Generic Media Information Box" );
+    isom_iprint_uint( printer, indent, "graphicsmode", gmin->graphicsmode );
+    isom_ifprintf_rgb_color( printer, indent, "opcolor", gmin->opcolor );
+    isom_iprint_float( printer, indent, "balance", lsmash_fixed2double( gmin->balance, 8 ) );
+    isom_iprint_hex( printer, indent, "reserved", gmin->reserved, 4 );
     return 0;
 }
 
-static int isom_print_text( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_text( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_text_t *text = (isom_text_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Text Media Information Box" );
-    lsmash_ifprintf( fp, indent, "Unknown matrix\n" );
-    isom_ifprintf_matrix( fp, indent + 1, text->matrix );
+    isom_print_box_common( printer, indent++, box, "Text Media Information Box" );
+    isom_ifprintf_matrix( printer, indent, "Unknown matrix", text->matrix );
     return 0;
 }
 
-static int isom_print_dinf( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_dinf( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Data Information Box" );
+    return isom_print_simple( printer, box, level, "Data Information Box" );
 }
 
-static int isom_print_dref( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_dref( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_dref_t *dref = (isom_dref_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Data Reference Box" );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu16"\n", dref->list.entry_count );
+    isom_print_box_common( printer, indent++, box, "Data Reference Box" );
+    isom_iprint_uint( printer, indent, "entry_count", dref->list.entry_count );
     return 0;
 }
 
-static int isom_print_url( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_url( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_dref_entry_t *url = (isom_dref_entry_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Data Entry Url Box" );
+    isom_print_box_common( printer, indent++, box, "Data Entry Url Box" );
     if( url->flags & 0x000001 )
-        lsmash_ifprintf( fp, indent, "location = in the same file\n" );
+        isom_iprint_string( printer, indent, "location", "in the same file" );
     else
-        lsmash_ifprintf( fp, indent, "location = %s\n", url->location );
+        isom_iprint_string( printer, indent, "location", url->location );
     return 0;
 }
 
-static int isom_print_stbl( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_stbl( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Sample Table Box" );
+    return isom_print_simple( printer, box, level, "Sample Table Box" );
 }
 
-static int isom_print_stsd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_stsd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_stsd_t *stsd = (isom_stsd_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Sample Description Box" );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", stsd->entry_count );
+    isom_print_box_common( printer, indent++, box, "Sample Description Box" );
+    isom_iprint_uint( printer, indent, "entry_count", stsd->entry_count );
     return 0;
 }
 
-static int isom_print_visual_description( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_visual_description( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_visual_entry_t *visual = (isom_visual_entry_t *)box;
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: Visual Description]\n", isom_4cc2str( visual->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", visual->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", visual->size );
-    isom_ifprintf_sample_description_common_reserved( fp, indent, visual->reserved );
-    lsmash_ifprintf( fp, indent, "data_reference_index = %"PRIu16"\n", visual->data_reference_index );
+    isom_iprint_box( printer, indent++, isom_4cc2str( visual->type.fourcc ), "Visual Description" );
+    isom_iprint_uint( printer, indent, "position", visual->pos );
+    isom_iprint_uint( printer, indent, "size", visual->size );
+    isom_ifprintf_sample_description_common_reserved( printer, indent, visual->reserved );
+    isom_iprint_uint( printer, indent, "data_reference_index", visual->data_reference_index );
     if( file->qt_compatible )
     {
-        lsmash_ifprintf( fp, indent, "version = %"PRId16"\n", visual->version );
-        lsmash_ifprintf( fp, indent, "revision_level = %"PRId16"\n", visual->revision_level );
-        lsmash_ifprintf( fp, indent, "vendor = %s\n", isom_4cc2str( visual->vendor ) );
-        lsmash_ifprintf( fp, indent, "temporalQuality = %"PRIu32"\n", visual->temporalQuality );
-        lsmash_ifprintf( fp, indent, "spatialQuality = %"PRIu32"\n", visual->spatialQuality );
-        lsmash_ifprintf( fp, indent, "width = %"PRIu16"\n", visual->width );
-        lsmash_ifprintf( fp, indent, "height = %"PRIu16"\n", visual->height );
-        lsmash_ifprintf( fp, indent, "horizresolution = %f\n", lsmash_fixed2double( visual->horizresolution, 16 ) );
-        lsmash_ifprintf( fp, indent, "vertresolution = %f\n", lsmash_fixed2double( visual->vertresolution, 16 ) );
-        lsmash_ifprintf( fp, indent, "dataSize = %"PRIu32"\n", visual->dataSize );
-        lsmash_ifprintf( fp, indent, "frame_count = %"PRIu16"\n", visual->frame_count );
-        lsmash_ifprintf( fp, indent, "compressorname_length = %"PRIu8"\n", visual->compressorname[0] );
-        lsmash_ifprintf( fp, indent, "compressorname = %s\n", visual->compressorname + 1 );
-        lsmash_ifprintf( fp, indent, "depth = 0x%04"PRIx16, visual->depth );
+        isom_iprint_int( printer, indent, "version", visual->version );
+        isom_iprint_int( printer, indent, "revision_level", visual->revision_level );
+        isom_iprint_fourcc( printer, indent, "vendor", visual->vendor );
+        isom_iprint_uint( printer, indent, "temporalQuality", visual->temporalQuality );
+        isom_iprint_uint( printer, indent, "spatialQuality", visual->spatialQuality );
+        isom_iprint_uint( printer, indent, "width", visual->width );
+        isom_iprint_uint( printer, indent, "height", visual->height );
+        isom_iprint_float( printer, indent, "horizresolution", lsmash_fixed2double( visual->horizresolution, 16 ) );
+        isom_iprint_float( printer, indent, "vertresolution", lsmash_fixed2double( visual->vertresolution, 16 ) );
+        isom_iprint_uint( printer, indent, "dataSize", visual->dataSize );
+        isom_iprint_uint( printer, indent, "frame_count", visual->frame_count );
+        isom_iprint_uint( printer, indent, "compressorname_length", visual->compressorname[0] );
+        isom_iprint_string( printer, indent, "compressorname", visual->compressorname + 1 );
+        isom_iprint_hex( printer, indent, "depth", visual->depth, 4 );
         if( visual->depth == 32 )
-            fprintf( fp, " (colour with alpha)\n" );
+            isom_iprint_note( printer, "colour with alpha" );
         else if( visual->depth >= 33 && visual->depth <= 40 )
-            fprintf( fp, " (grayscale with no alpha)\n" );
-        else
-            fprintf( fp, "\n" );
-        lsmash_ifprintf( fp, indent, "color_table_ID = %"PRId16"\n", visual->color_table_ID );
+            isom_iprint_note( printer, "grayscale with no alpha" );
+        isom_iprint_int( printer, indent, "color_table_ID", visual->color_table_ID );
         if( visual->color_table_ID == 0 )
-            isom_pring_qt_color_table( fp, indent, &visual->color_table );
+            isom_pring_qt_color_table( printer, indent, &visual->color_table );
     }
     else
     {
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%04"PRIx16"\n", visual->version );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%04"PRIx16"\n", visual->revision_level );
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%08"PRIx32"\n", visual->vendor );
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%08"PRIx32"\n", visual->temporalQuality );
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%08"PRIx32"\n", visual->spatialQuality );
-        lsmash_ifprintf( fp, indent, "width = %"PRIu16"\n", visual->width );
-        lsmash_ifprintf( fp, indent, "height = %"PRIu16"\n", visual->height );
-        lsmash_ifprintf( fp, indent, "horizresolution = %f\n", lsmash_fixed2double( visual->horizresolution, 16 ) );
-        lsmash_ifprintf( fp, indent, "vertresolution = %f\n", lsmash_fixed2double( visual->vertresolution, 16 ) );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", visual->dataSize );
-        lsmash_ifprintf( fp, indent, "frame_count = %"PRIu16"\n", visual->frame_count );
-        lsmash_ifprintf( fp, indent, "compressorname_length = %"PRIu8"\n", visual->compressorname[0] );
-        lsmash_ifprintf( fp, indent, "compressorname = %s\n", visual->compressorname + 1 );
-        lsmash_ifprintf( fp, indent, "depth = 0x%04"PRIx16, visual->depth );
+        isom_iprint_hex( printer, indent, "pre_defined", visual->version, 4 );
+        isom_iprint_hex( printer, indent, "reserved", visual->revision_level, 4 );
+        isom_iprint_hex( printer, indent, "pre_defined", visual->vendor, 8 );
+        isom_iprint_hex( printer, indent, "pre_defined", visual->temporalQuality, 8 );
+        isom_iprint_hex( printer, indent, "pre_defined", visual->spatialQuality, 8 );
+        isom_iprint_uint( printer, indent, "width", visual->width );
+        isom_iprint_uint( printer, indent, "height", visual->height );
+        isom_iprint_float( printer, indent, "horizresolution", lsmash_fixed2double( visual->horizresolution, 16 ) );
+        isom_iprint_float( printer, indent, "vertresolution", lsmash_fixed2double( visual->vertresolution, 16 ) );
+        isom_iprint_hex( printer, indent, "reserved", visual->dataSize, 8 );
+        isom_iprint_uint( printer, indent, "frame_count", visual->frame_count );
+        isom_iprint_uint( printer, indent, "compressorname_length", visual->compressorname[0] );
+        isom_iprint_string( printer, indent, "compressorname", visual->compressorname + 1 );
+        isom_iprint_hex( printer, indent, "depth", visual->depth, 4 );
         if( visual->depth == 0x0018 )
-            fprintf( fp, " (colour with no alpha)\n" );
+            isom_iprint_note( printer, "colour with no alpha" );
         else if( visual->depth == 0x0028 )
-            fprintf( fp, " (grayscale with no alpha)\n" );
+            isom_iprint_note( printer, "grayscale with no alpha" );
         else if( visual->depth == 0x0020 )
-            fprintf( fp, " (gray or colour with alpha)\n" );
-        else
-            fprintf( fp, "\n" );
-        lsmash_ifprintf( fp, indent, "pre_defined = 0x%04"PRIx16"\n", visual->color_table_ID );
+            isom_iprint_note( printer, "gray or colour with alpha" );
+        isom_iprint_hex( printer, indent, "pre_defined", visual->color_table_ID, 4 );
     }
     return 0;
 }
 
-static int isom_print_glbl( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_glbl( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_glbl_t *glbl = (isom_glbl_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Global Header Box" );
+    isom_print_box_common( printer, indent++, box, "Global Header Box" );
     if( glbl->header_data )
-    {
-        lsmash_ifprintf( fp, indent, "global_header[]\n" );
-        for( uint32_t i = 0; i < glbl->header_size; i += 8 )
-        {
-            lsmash_ifprintf( fp, indent + 1, "" );
-            for( uint32_t j = 0; ; j++ )
-                if( j == 7 || (i + j == glbl->header_size - 1) )
-                {
-                    fprintf( fp, "0x%02"PRIx8"\n", glbl->header_data[i + j] );
-                    break;
-                }
-                else
-                    fprintf( fp, "0x%02"PRIx8" ", glbl->header_data[i + j] );
-        }
-    }
+        isom_iprint_bytes( printer, indent, "global_header", glbl->header_data, glbl->header_size );
     return 0;
 }
 
-static int isom_print_clap( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_clap( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_clap_t *clap = (isom_clap_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Clean Aperture Box" );
-    lsmash_ifprintf( fp, indent, "cleanApertureWidthN = %"PRIu32"\n", clap->cleanApertureWidthN );
-    lsmash_ifprintf( fp, indent, "cleanApertureWidthD = %"PRIu32"\n", clap->cleanApertureWidthD );
-    lsmash_ifprintf( fp, indent, "cleanApertureHeightN = %"PRIu32"\n", clap->cleanApertureHeightN );
-    lsmash_ifprintf( fp, indent, "cleanApertureHeightD = %"PRIu32"\n", clap->cleanApertureHeightD );
-    lsmash_ifprintf( fp, indent, "horizOffN = %"PRId32"\n", clap->horizOffN );
-    lsmash_ifprintf( fp, indent, "horizOffD = %"PRIu32"\n", clap->horizOffD );
-    lsmash_ifprintf( fp, indent, "vertOffN = %"PRId32"\n", clap->vertOffN );
-    lsmash_ifprintf( fp, indent, "vertOffD = %"PRIu32"\n", clap->vertOffD );
+    isom_print_box_common( printer, indent++, box, "Clean Aperture Box" );
+    isom_iprint_uint( printer, indent, "cleanApertureWidthN", clap->cleanApertureWidthN );
+    isom_iprint_uint( printer, indent, "cleanApertureWidthD", clap->cleanApertureWidthD );
+    isom_iprint_uint( printer, indent, "cleanApertureHeightN", clap->cleanApertureHeightN );
+    isom_iprint_uint( printer, indent, "cleanApertureHeightD", clap->cleanApertureHeightD );
+    isom_iprint_int( printer, indent, "horizOffN", clap->horizOffN );
+    isom_iprint_uint( printer, indent, "horizOffD", clap->horizOffD );
+    isom_iprint_int( printer, indent, "vertOffN", clap->vertOffN );
+    isom_iprint_uint( printer, indent, "vertOffD", clap->vertOffD );
     return 0;
 }
 
-static int isom_print_pasp( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_pasp( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_pasp_t *pasp = (isom_pasp_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Pixel Aspect Ratio Box" );
-    lsmash_ifprintf( fp, indent, "hSpacing = %"PRIu32"\n", pasp->hSpacing );
-    lsmash_ifprintf( fp, indent, "vSpacing = %"PRIu32"\n", pasp->vSpacing );
+    isom_print_box_common( printer, indent++, box, "Pixel Aspect Ratio Box" );
+    isom_iprint_uint( printer, indent, "hSpacing", pasp->hSpacing );
+    isom_iprint_uint( printer, indent, "vSpacing", pasp->vSpacing );
     return 0;
 }
 
-static int isom_print_colr( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_colr( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_colr_t *colr = (isom_colr_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, colr->manager & LSMASH_QTFF_BASE ? "Color Parameter Box" : "Colour Information Box" );
-    lsmash_ifprintf( fp, indent, "color_parameter_type = %s\n", isom_4cc2str( colr->color_parameter_type ) );
+    isom_print_box_common( printer, indent++, box, colr->manager & LSMASH_QTFF_BASE ? "Color Parameter Box" : "Colour Information Box" );
+    isom_iprint_fourcc( printer, indent, "color_parameter_type", colr->color_parameter_type );
     if( colr->color_parameter_type == QT_COLOR_PARAMETER_TYPE_NCLC
      || colr->color_parameter_type == ISOM_COLOR_PARAMETER_TYPE_NCLX )
     {
-        lsmash_ifprintf( fp, indent, "primaries_index = %"PRIu16"\n", colr->primaries_index );
-        lsmash_ifprintf( fp, indent, "transfer_function_index = %"PRIu16"\n", colr->transfer_function_index );
-        lsmash_ifprintf( fp, indent, "matrix_index = %"PRIu16"\n", colr->matrix_index );
+        isom_iprint_uint( printer, indent, "primaries_index", colr->primaries_index );
+        isom_iprint_uint( printer, indent, "transfer_function_index", colr->transfer_function_index );
+        isom_iprint_uint( printer, indent, "matrix_index", colr->matrix_index );
         if( colr->color_parameter_type == ISOM_COLOR_PARAMETER_TYPE_NCLX )
         {
             if( colr->manager & LSMASH_INCOMPLETE_BOX )
             {
-                lsmash_ifprintf( fp, indent, "full_range_flag = N/A\n" );
-                lsmash_ifprintf( fp, indent, "reserved = N/A\n" );
+                isom_ifprintf_none( printer, indent, "full_range_flag", NULL, "N/A" );
+                isom_ifprintf_none( printer, indent, "reserved", NULL, "N/A" );
             }
             else
             {
-                lsmash_ifprintf( fp, indent, "full_range_flag = %"PRIu8"\n", colr->full_range_flag );
-                lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx8"\n", colr->reserved );
+                isom_iprint_uint( printer, indent, "full_range_flag", colr->full_range_flag );
+                isom_iprint_hex( printer, indent, "reserved", colr->reserved, 8 );
             }
         }
     }
     return 0;
 }
 
-static int isom_print_gama( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_gama( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_gama_t *gama = (isom_gama_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Gamma Level Box" );
+    isom_print_box_common( printer, indent++, box, "Gamma Level Box" );
     if( gama->level == 0x00023333 )
-        lsmash_ifprintf( fp, indent, "level = 2.2 (standard television video gamma)\n" );
+    {
+        /* 2.2 is approximated in the 16.16 fixed-point number. */
+        if( isom_printer_is_text( printer ) )
+            isom_iprint_string( printer, indent, "level", "2.2" );
+        else
+            isom_iprint_float( printer, indent, "level", 2.2 );
+        isom_iprint_note( printer, "standard television video gamma" );
+    }
     else
     {
-        lsmash_ifprintf( fp, indent, "level = %f", lsmash_fixed2double( gama->level, 16 ) );
+        isom_iprint_float( printer, indent, "level", lsmash_fixed2double( gama->level, 16 ) );
         if( gama->level == 0 )
-            fprintf( fp, " (platform's standard gamma)" );
+            isom_iprint_note( printer, "platform's standard gamma" );
         else if( gama->level == 0xffffffff )
-            fprintf( fp, " (no gamma-correction)" );
-        fprintf( fp, "\n" );
+            isom_iprint_note( printer, "no gamma-correction" );
     }
     return 0;
 }
 
-static int isom_print_fiel( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_fiel( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_fiel_t *fiel = (isom_fiel_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Field/Frame Information Box" );
-    lsmash_ifprintf( fp, indent, "fields = %"PRIu8" (%s)\n", fiel->fields, fiel->fields > 1 ? "interlaced" : "progressive scan" );
-    lsmash_ifprintf( fp, indent, "detail = %"PRIu8, fiel->detail );
+    isom_print_box_common( printer, indent++, box, "Field/Frame Information Box" );
+    isom_iprint_uint( printer, indent, "fields", fiel->fields );
+    isom_iprint_note( printer, "%s", fiel->fields > 1 ? "interlaced" : "progressive scan" );
+    isom_iprint_uint( printer, indent, "detail", fiel->detail );
     if( fiel->fields > 1 )
     {
         static const char *field_orderings[5] =
@@ -977,44 +1687,42 @@ static int isom_print_fiel( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
             else if( fiel->detail == QT_FIELD_ORDERINGS_SPATIAL_FIRST_LINE_LATE )
                 ordering = 4;
         }
-        fprintf( fp, " (%s)\n", field_orderings[ordering] );
+        isom_iprint_note( printer, "%s", field_orderings[ordering] );
     }
-    else
-        fprintf( fp, "\n" );
     return 0;
 }
 
-static int isom_print_clli( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level ) {
+static int isom_print_clli( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level ) {
     isom_clli_t *clli = (isom_clli_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Content Light Level Box" );
-    lsmash_ifprintf( fp, indent, "max_content_light_level = %"PRIu16"\n", clli->max_content_light_level );
-    lsmash_ifprintf( fp, indent, "max_pic_average_light_level = %"PRIu16"\n", clli->max_pic_average_light_level );
+    isom_print_box_common( printer, indent++, box, "Content Light Level Box" );
+    isom_iprint_uint( printer, indent, "max_content_light_level", clli->max_content_light_level );
+    isom_iprint_uint( printer, indent, "max_pic_average_light_level", clli->max_pic_average_light_level );
     return 0;
 }
 
-static int isom_print_mdcv( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level ) {
+static int isom_print_mdcv( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level ) {
     isom_mdcv_t *mdcv = (isom_mdcv_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Mastering Display Color Volume Box" );
-    lsmash_ifprintf( fp, indent, "display_primaries_g_x = %"PRIu16"\n", mdcv->display_primaries_g_x );
-    lsmash_ifprintf( fp, indent, "display_primaries_g_y = %"PRIu16"\n", mdcv->display_primaries_g_y );
-    lsmash_ifprintf( fp, indent, "display_primaries_b_x = %"PRIu16"\n", mdcv->display_primaries_b_x );
-    lsmash_ifprintf( fp, indent, "display_primaries_b_y = %"PRIu16"\n", mdcv->display_primaries_b_y );
-    lsmash_ifprintf( fp, indent, "display_primaries_r_x = %"PRIu16"\n", mdcv->display_primaries_r_x );
-    lsmash_ifprintf( fp, indent, "display_primaries_r_y = %"PRIu16"\n", mdcv->display_primaries_r_y );
-    lsmash_ifprintf( fp, indent, "white_point_x = %"PRIu16"\n", mdcv->white_point_x );
-    lsmash_ifprintf( fp, indent, "white_point_y = %"PRIu16"\n", mdcv->white_point_y );
-    lsmash_ifprintf( fp, indent, "max_display_mastering_luminance = %"PRIu32"\n", mdcv->max_display_mastering_luminance );
-    lsmash_ifprintf( fp, indent, "min_display_mastering_luminance = %"PRIu32"\n", mdcv->min_display_mastering_luminance );
+    isom_print_box_common( printer, indent++, box, "Mastering Display Color Volume Box" );
+    isom_iprint_uint( printer, indent, "display_primaries_g_x", mdcv->display_primaries_g_x );
+    isom_iprint_uint( printer, indent, "display_primaries_g_y", mdcv->display_primaries_g_y );
+    isom_iprint_uint( printer, indent, "display_primaries_b_x", mdcv->display_primaries_b_x );
+    isom_iprint_uint( printer, indent, "display_primaries_b_y", mdcv->display_primaries_b_y );
+    isom_iprint_uint( printer, indent, "display_primaries_r_x", mdcv->display_primaries_r_x );
+    isom_iprint_uint( printer, indent, "display_primaries_r_y", mdcv->display_primaries_r_y );
+    isom_iprint_uint( printer, indent, "white_point_x", mdcv->white_point_x );
+    isom_iprint_uint( printer, indent, "white_point_y", mdcv->white_point_y );
+    isom_iprint_uint( printer, indent, "max_display_mastering_luminance", mdcv->max_display_mastering_luminance );
+    isom_iprint_uint( printer, indent, "min_display_mastering_luminance", mdcv->min_display_mastering_luminance );
     return 0;
 }
 
-static int isom_print_cspc( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_cspc( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_cspc_t *cspc = (isom_cspc_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Colorspace Box" );
+    isom_print_box_common( printer, indent++, box, "Colorspace Box" );
     static const struct
     {
         lsmash_qt_pixel_format pixel_format;
@@ -1037,299 +1745,288 @@ static int isom_print_cspc( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
     for( int i = 0; unprintable_pixel_format_table[i].pixel_format; i++ )
         if( cspc->pixel_format == unprintable_pixel_format_table[i].pixel_format )
         {
-            lsmash_ifprintf( fp, indent, "pixel_format = 0x%08"PRIx32" (%s)\n", cspc->pixel_format, unprintable_pixel_format_table[i].description );
+            isom_iprint_hex( printer, indent, "pixel_format", cspc->pixel_format, 8 );
+            isom_iprint_note( printer, "%s", unprintable_pixel_format_table[i].description );
             return 0;
         }
-    lsmash_ifprintf( fp, indent, "pixel_format = %s\n", isom_4cc2str( cspc->pixel_format ) );
+    isom_iprint_fourcc( printer, indent, "pixel_format", cspc->pixel_format );
     return 0;
 }
 
-static int isom_print_sgbt( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_sgbt( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_sgbt_t *sgbt = (isom_sgbt_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Significant Bits Box" );
-    lsmash_ifprintf( fp, indent, "significantBits = %"PRIu8"\n", sgbt->significantBits );
+    isom_print_box_common( printer, indent++, box, "Significant Bits Box" );
+    isom_iprint_uint( printer, indent, "significantBits", sgbt->significantBits );
     return 0;
 }
 
-static int isom_print_stsl( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_stsl( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_stsl_t *stsl = (isom_stsl_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Sample Scale Box" );
-    lsmash_ifprintf( fp, indent, "constraint_flag = %s\n", (stsl->constraint_flag & 0x01) ? "on" : "off" );
-    lsmash_ifprintf( fp, indent, "scale_method = " );
+    isom_print_box_common( printer, indent++, box, "Sample Scale Box" );
+    isom_iprint_string( printer, indent, "constraint_flag", (stsl->constraint_flag & 0x01) ? "on" : "off" );
+    char *scale_method = "";
     if( stsl->scale_method == ISOM_SCALE_METHOD_FILL )
-        fprintf( fp, "'fill'\n" );
+        scale_method = "'fill'";
     else if( stsl->scale_method == ISOM_SCALE_METHOD_HIDDEN )
-        fprintf( fp, "'hidden'\n" );
+        scale_method = "'hidden'";
     else if( stsl->scale_method == ISOM_SCALE_METHOD_MEET )
-        fprintf( fp, "'meet'\n" );
+        scale_method = "'meet'";
     else if( stsl->scale_method == ISOM_SCALE_METHOD_SLICE_X )
-        fprintf( fp, "'slice' in the x-coodinate\n" );
+        scale_method = "'slice' in the x-coodinate";
     else if( stsl->scale_method == ISOM_SCALE_METHOD_SLICE_Y )
-        fprintf( fp, "'slice' in the y-coodinate\n" );
-    lsmash_ifprintf( fp, indent, "display_center_x = %"PRIu16"\n", stsl->display_center_x );
-    lsmash_ifprintf( fp, indent, "display_center_y = %"PRIu16"\n", stsl->display_center_y );
+        scale_method = "'slice' in the y-coodinate";
+    isom_iprint_string( printer, indent, "scale_method", scale_method );
+    isom_iprint_uint( printer, indent, "display_center_x", stsl->display_center_x );
+    isom_iprint_uint( printer, indent, "display_center_y", stsl->display_center_y );
     return 0;
 }
 
-static int isom_print_audio_description( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_audio_description( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_audio_entry_t *audio = (isom_audio_entry_t *)box;
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: Audio Description]\n", isom_4cc2str( audio->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", audio->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", audio->size );
-    isom_ifprintf_sample_description_common_reserved( fp, indent, audio->reserved );
-    lsmash_ifprintf( fp, indent, "data_reference_index = %"PRIu16"\n", audio->data_reference_index );
+    isom_iprint_box( printer, indent++, isom_4cc2str( audio->type.fourcc ), "Audio Description" );
+    isom_iprint_uint( printer, indent, "position", audio->pos );
+    isom_iprint_uint( printer, indent, "size", audio->size );
+    isom_ifprintf_sample_description_common_reserved( printer, indent, audio->reserved );
+    isom_iprint_uint( printer, indent, "data_reference_index", audio->data_reference_index );
     if( file->qt_compatible )
     {
-        lsmash_ifprintf( fp, indent, "version = %"PRId16"\n", audio->version );
-        lsmash_ifprintf( fp, indent, "revision_level = %"PRId16"\n", audio->revision_level );
-        lsmash_ifprintf( fp, indent, "vendor = %s\n", isom_4cc2str( audio->vendor ) );
-        lsmash_ifprintf( fp, indent, "channelcount = %"PRIu16"\n", audio->channelcount );
-        lsmash_ifprintf( fp, indent, "samplesize = %"PRIu16"\n", audio->samplesize );
-        lsmash_ifprintf( fp, indent, "compression_ID = %"PRId16"\n", audio->compression_ID );
-        lsmash_ifprintf( fp, indent, "packet_size = %"PRIu16"\n", audio->packet_size );
+        isom_iprint_int( printer, indent, "version", audio->version );
+        isom_iprint_int( printer, indent, "revision_level", audio->revision_level );
+        isom_iprint_fourcc( printer, indent, "vendor", audio->vendor );
+        isom_iprint_uint( printer, indent, "channelcount", audio->channelcount );
+        isom_iprint_uint( printer, indent, "samplesize", audio->samplesize );
+        isom_iprint_int( printer, indent, "compression_ID", audio->compression_ID );
+        isom_iprint_uint( printer, indent, "packet_size", audio->packet_size );
     }
     else
     {
-        lsmash_ifprintf( fp, indent, "reserved = 0x%04"PRIx16"\n", audio->version );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%04"PRIx16"\n", audio->revision_level );
-        lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", audio->vendor );
-        lsmash_ifprintf( fp, indent, "channelcount = %"PRIu16"\n", audio->channelcount );
-        lsmash_ifprintf( fp, indent, "samplesize = %"PRIu16"\n", audio->samplesize );
-        lsmash_ifprintf( fp, indent, "pre_defined = %"PRId16"\n", audio->compression_ID );
-        lsmash_ifprintf( fp, indent, "reserved = %"PRIu16"\n", audio->packet_size );
+        isom_iprint_hex( printer, indent, "reserved", audio->version, 4 );
+        isom_iprint_hex( printer, indent, "reserved", audio->revision_level, 4 );
+        isom_iprint_hex( printer, indent, "reserved", audio->vendor, 8 );
+        isom_iprint_uint( printer, indent, "channelcount", audio->channelcount );
+        isom_iprint_uint( printer, indent, "samplesize", audio->samplesize );
+        isom_iprint_int( printer, indent, "pre_defined", audio->compression_ID );
+        isom_iprint_uint( printer, indent, "reserved", audio->packet_size );
     }
-    lsmash_ifprintf( fp, indent, "samplerate = %f\n", lsmash_fixed2double( audio->samplerate, 16 ) );
+    isom_iprint_float( printer, indent, "samplerate", lsmash_fixed2double( audio->samplerate, 16 ) );
     if( audio->version == 1 && (audio->manager & LSMASH_QTFF_BASE) )
     {
-        lsmash_ifprintf( fp, indent, "samplesPerPacket = %"PRIu32"\n", audio->samplesPerPacket );
-        lsmash_ifprintf( fp, indent, "bytesPerPacket = %"PRIu32"\n", audio->bytesPerPacket );
-        lsmash_ifprintf( fp, indent, "bytesPerFrame = %"PRIu32"\n", audio->bytesPerFrame );
-        lsmash_ifprintf( fp, indent, "bytesPerSample = %"PRIu32"\n", audio->bytesPerSample );
+        isom_iprint_uint( printer, indent, "samplesPerPacket", audio->samplesPerPacket );
+        isom_iprint_uint( printer, indent, "bytesPerPacket", audio->bytesPerPacket );
+        isom_iprint_uint( printer, indent, "bytesPerFrame", audio->bytesPerFrame );
+        isom_iprint_uint( printer, indent, "bytesPerSample", audio->bytesPerSample );
     }
     else if( audio->version == 2 )
     {
-        lsmash_ifprintf( fp, indent, "sizeOfStructOnly = %"PRIu32"\n", audio->sizeOfStructOnly );
-        lsmash_ifprintf( fp, indent, "audioSampleRate = %lf\n", lsmash_int2float64( audio->audioSampleRate ) );
-        lsmash_ifprintf( fp, indent, "numAudioChannels = %"PRIu32"\n", audio->numAudioChannels );
-        lsmash_ifprintf( fp, indent, "always7F000000 = 0x%08"PRIx32"\n", audio->always7F000000 );
-        lsmash_ifprintf( fp, indent, "constBitsPerChannel = %"PRIu32"\n", audio->constBitsPerChannel );
-        lsmash_ifprintf( fp, indent++, "formatSpecificFlags = 0x%08"PRIx32"\n", audio->formatSpecificFlags );
+        isom_iprint_uint( printer, indent, "sizeOfStructOnly", audio->sizeOfStructOnly );
+        isom_iprint_float( printer, indent, "audioSampleRate", lsmash_int2float64( audio->audioSampleRate ) );
+        isom_iprint_uint( printer, indent, "numAudioChannels", audio->numAudioChannels );
+        isom_iprint_hex( printer, indent, "always7F000000", audio->always7F000000, 8 );
+        isom_iprint_uint( printer, indent, "constBitsPerChannel", audio->constBitsPerChannel );
+        isom_iprint_hex( printer, indent++, "formatSpecificFlags", audio->formatSpecificFlags, 8 );
         if( isom_is_lpcm_audio( audio ) )
         {
-            lsmash_ifprintf( fp, indent, "sample format: " );
-            if( audio->formatSpecificFlags & QT_LPCM_FORMAT_FLAG_FLOAT )
-                fprintf( fp, "floating point\n" );
+            uint32_t flags = audio->formatSpecificFlags;
+            if( flags & QT_LPCM_FORMAT_FLAG_FLOAT )
+                isom_ifprintf_property( printer, indent, "sample format", "floating point" );
             else
             {
-                fprintf( fp, "integer\n" );
-                lsmash_ifprintf( fp, indent, "signedness: " );
-                fprintf( fp, audio->formatSpecificFlags & QT_LPCM_FORMAT_FLAG_SIGNED_INTEGER ? "signed\n" : "unsigned\n" );
+                isom_ifprintf_property( printer, indent, "sample format", "integer" );
+                isom_ifprintf_property( printer, indent, "signedness", flags & QT_LPCM_FORMAT_FLAG_SIGNED_INTEGER ? "signed" : "unsigned" );
             }
             if( audio->constBytesPerAudioPacket != 1 )
-            {
-                lsmash_ifprintf( fp, indent, "endianness: " );
-                fprintf( fp, audio->formatSpecificFlags & QT_LPCM_FORMAT_FLAG_BIG_ENDIAN ? "big\n" : "little\n" );
-            }
-            lsmash_ifprintf( fp, indent, "packed: " );
-            if( audio->formatSpecificFlags & QT_LPCM_FORMAT_FLAG_PACKED )
-                fprintf( fp, "yes\n" );
+                isom_ifprintf_property( printer, indent, "endianness", flags & QT_LPCM_FORMAT_FLAG_BIG_ENDIAN ? "big" : "little" );
+            if( flags & QT_LPCM_FORMAT_FLAG_PACKED )
+                isom_ifprintf_property( printer, indent, "packed", "yes" );
             else
             {
-                fprintf( fp, "no\n" );
-                lsmash_ifprintf( fp, indent, "alignment: " );
-                fprintf( fp, audio->formatSpecificFlags & QT_LPCM_FORMAT_FLAG_ALIGNED_HIGH ? "high\n" : "low\n" );
+                isom_ifprintf_property( printer, indent, "packed", "no" );
+                isom_ifprintf_property( printer, indent, "alignment", flags & QT_LPCM_FORMAT_FLAG_ALIGNED_HIGH ? "high" : "low" );
             }
             if( audio->numAudioChannels > 1 )
-            {
-                lsmash_ifprintf( fp, indent, "interleved: " );
-                fprintf( fp, audio->formatSpecificFlags & QT_LPCM_FORMAT_FLAG_NON_INTERLEAVED ? "no\n" : "yes\n" );
-            }
+                isom_ifprintf_property( printer, indent, "interleved", flags & QT_LPCM_FORMAT_FLAG_NON_INTERLEAVED ? "no" : "yes" );
         }
-        lsmash_ifprintf( fp, --indent, "constBytesPerAudioPacket = %"PRIu32"\n", audio->constBytesPerAudioPacket );
-        lsmash_ifprintf( fp, indent, "constLPCMFramesPerAudioPacket = %"PRIu32"\n", audio->constLPCMFramesPerAudioPacket );
+        isom_iprint_uint( printer, --indent, "constBytesPerAudioPacket", audio->constBytesPerAudioPacket );
+        isom_iprint_uint( printer, indent, "constLPCMFramesPerAudioPacket", audio->constLPCMFramesPerAudioPacket );
     }
     return 0;
 }
 
-static int isom_print_wave( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_wave( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Sound Information Decompression Parameters Box" );
+    return isom_print_simple( printer, box, level, "Sound Information Decompression Parameters Box" );
 }
 
-static int isom_print_frma( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_frma( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_frma_t *frma = (isom_frma_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Format Box" );
-    lsmash_ifprintf( fp, indent, "data_format = %s\n", isom_4cc2str( frma->data_format ) );
+    isom_print_box_common( printer, indent++, box, "Format Box" );
+    isom_iprint_fourcc( printer, indent, "data_format", frma->data_format );
     return 0;
 }
 
-static int isom_print_enda( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_enda( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_enda_t *enda = (isom_enda_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Audio Endian Box" );
-    lsmash_ifprintf( fp, indent, "littleEndian = %s\n", enda->littleEndian ? "yes" : "no" );
+    isom_print_box_common( printer, indent++, box, "Audio Endian Box" );
+    isom_iprint_string( printer, indent, "littleEndian", enda->littleEndian ? "yes" : "no" );
     return 0;
 }
 
-static int isom_print_terminator( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_terminator( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_terminator_t *terminator = (isom_terminator_t *)box;
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[0x00000000: Terminator Box]\n" );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", terminator->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", terminator->size );
+    isom_iprint_box( printer, indent++, "0x00000000", "Terminator Box" );
+    isom_iprint_uint( printer, indent, "position", terminator->pos );
+    isom_iprint_uint( printer, indent, "size", terminator->size );
     return 0;
 }
 
-static int isom_print_chan( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_chan( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_chan_t *chan = (isom_chan_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Audio Channel Layout Box" );
-    lsmash_ifprintf( fp, indent, "channelLayoutTag = 0x%08"PRIx32"\n", chan->channelLayoutTag );
-    lsmash_ifprintf( fp, indent, "channelBitmap = 0x%08"PRIx32"\n", chan->channelBitmap );
-    lsmash_ifprintf( fp, indent, "numberChannelDescriptions = %"PRIu32"\n", chan->numberChannelDescriptions );
+    isom_print_box_common( printer, indent++, box, "Audio Channel Layout Box" );
+    isom_iprint_hex( printer, indent, "channelLayoutTag", chan->channelLayoutTag, 8 );
+    isom_iprint_hex( printer, indent, "channelBitmap", chan->channelBitmap, 8 );
+    isom_iprint_uint( printer, indent, "numberChannelDescriptions", chan->numberChannelDescriptions );
     if( chan->numberChannelDescriptions )
     {
         isom_channel_description_t *desc = chan->channelDescriptions;
         for( uint32_t i = 0; i < chan->numberChannelDescriptions; i++ )
         {
-            lsmash_ifprintf( fp, indent++, "ChannelDescriptions[%"PRIu32"]\n", i );
-            lsmash_ifprintf( fp, indent, "channelLabel = 0x%08"PRIx32"\n", desc->channelLabel );
-            lsmash_ifprintf( fp, indent, "channelFlags = 0x%08"PRIx32"\n", desc->channelFlags );
+            isom_iprint_element( printer, indent++, "ChannelDescriptions", i );
+            isom_iprint_hex( printer, indent, "channelLabel", desc->channelLabel, 8 );
+            isom_iprint_hex( printer, indent, "channelFlags", desc->channelFlags, 8 );
             for( int j = 0; j < 3; j++ )
-                lsmash_ifprintf( fp, indent, "coordinates[%d] = %f\n", j, lsmash_int2float32( desc->coordinates[j] ) );
+                isom_iprint_float_at( printer, indent, "coordinates", j, lsmash_int2float32( desc->coordinates[j] ) );
             --indent;
         }
     }
     return 0;
 }
 
-static int isom_print_srat( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_srat( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_srat_t *srat = (isom_srat_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Sampling Rate Box" );
-    lsmash_ifprintf( fp, indent, "sampling_rate = %"PRIu32"\n", srat->sampling_rate );
+    isom_print_box_common( printer, indent++, box, "Sampling Rate Box" );
+    isom_iprint_uint( printer, indent, "sampling_rate", srat->sampling_rate );
     return 0;
 }
 
-static int isom_print_text_description( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_text_description( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_qt_text_entry_t *text = (isom_qt_text_entry_t *)box;
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[text: QuickTime Text Description]\n" );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", text->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", text->size );
-    isom_ifprintf_sample_description_common_reserved( fp, indent, text->reserved );
-    lsmash_ifprintf( fp, indent, "data_reference_index = %"PRIu16"\n", text->data_reference_index );
-    lsmash_ifprintf( fp, indent, "displayFlags = 0x%08"PRId32"\n", text->displayFlags );
-    lsmash_ifprintf( fp, indent, "textJustification = %"PRId32"\n", text->textJustification );
-    lsmash_ifprintf( fp, indent, "bgColor\n" );
-    isom_ifprintf_rgb_color( fp, indent + 1, text->bgColor );
-    lsmash_ifprintf( fp, indent, "top = %"PRId16"\n", text->top );
-    lsmash_ifprintf( fp, indent, "left = %"PRId16"\n", text->left );
-    lsmash_ifprintf( fp, indent, "bottom = %"PRId16"\n", text->bottom );
-    lsmash_ifprintf( fp, indent, "right = %"PRId16"\n", text->right );
-    lsmash_ifprintf( fp, indent, "scrpStartChar = %"PRId32"\n", text->scrpStartChar );
-    lsmash_ifprintf( fp, indent, "scrpHeight = %"PRId16"\n", text->scrpHeight );
-    lsmash_ifprintf( fp, indent, "scrpAscent = %"PRId16"\n", text->scrpAscent );
-    lsmash_ifprintf( fp, indent, "scrpFont = %"PRId16"\n", text->scrpFont );
-    lsmash_ifprintf( fp, indent, "scrpFace = %"PRIu16"\n", text->scrpFace );
-    lsmash_ifprintf( fp, indent, "scrpSize = %"PRId16"\n", text->scrpSize );
-    lsmash_ifprintf( fp, indent, "scrpColor\n" );
-    isom_ifprintf_rgb_color( fp, indent + 1, text->scrpColor );
+    isom_iprint_box( printer, indent++, "text", "QuickTime Text Description" );
+    isom_iprint_uint( printer, indent, "position", text->pos );
+    isom_iprint_uint( printer, indent, "size", text->size );
+    isom_ifprintf_sample_description_common_reserved( printer, indent, text->reserved );
+    isom_iprint_uint( printer, indent, "data_reference_index", text->data_reference_index );
+    isom_iprint_hex( printer, indent, "displayFlags", text->displayFlags, 8 );
+    isom_iprint_int( printer, indent, "textJustification", text->textJustification );
+    isom_ifprintf_rgb_color( printer, indent, "bgColor", text->bgColor );
+    isom_iprint_int( printer, indent, "top", text->top );
+    isom_iprint_int( printer, indent, "left", text->left );
+    isom_iprint_int( printer, indent, "bottom", text->bottom );
+    isom_iprint_int( printer, indent, "right", text->right );
+    isom_iprint_int( printer, indent, "scrpStartChar", text->scrpStartChar );
+    isom_iprint_int( printer, indent, "scrpHeight", text->scrpHeight );
+    isom_iprint_int( printer, indent, "scrpAscent", text->scrpAscent );
+    isom_iprint_int( printer, indent, "scrpFont", text->scrpFont );
+    isom_iprint_uint( printer, indent, "scrpFace", text->scrpFace );
+    isom_iprint_int( printer, indent, "scrpSize", text->scrpSize );
+    isom_ifprintf_rgb_color( printer, indent, "scrpColor", text->scrpColor );
     if( text->font_name_length )
-        lsmash_ifprintf( fp, indent, "font_name = %s\n", text->font_name );
+        isom_iprint_string( printer, indent, "font_name", text->font_name );
     return 0;
 }
 
-static int isom_print_tx3g_description( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_tx3g_description( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_tx3g_entry_t *tx3g = (isom_tx3g_entry_t *)box;
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[tx3g: Timed Text Description]\n" );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", tx3g->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", tx3g->size );
-    isom_ifprintf_sample_description_common_reserved( fp, indent, tx3g->reserved );
-    lsmash_ifprintf( fp, indent, "data_reference_index = %"PRIu16"\n", tx3g->data_reference_index );
-    lsmash_ifprintf( fp, indent, "displayFlags = 0x%08"PRId32"\n", tx3g->displayFlags );
-    lsmash_ifprintf( fp, indent, "horizontal_justification = %"PRId8"\n", tx3g->horizontal_justification );
-    lsmash_ifprintf( fp, indent, "vertical_justification = %"PRId8"\n", tx3g->vertical_justification );
-    lsmash_ifprintf( fp, indent, "background_color_rgba\n" );
-    isom_ifprintf_rgba_color( fp, indent + 1, tx3g->background_color_rgba );
-    lsmash_ifprintf( fp, indent, "top = %"PRId16"\n", tx3g->top );
-    lsmash_ifprintf( fp, indent, "left = %"PRId16"\n", tx3g->left );
-    lsmash_ifprintf( fp, indent, "bottom = %"PRId16"\n", tx3g->bottom );
-    lsmash_ifprintf( fp, indent, "right = %"PRId16"\n", tx3g->right );
-    lsmash_ifprintf( fp, indent, "startChar = %"PRIu16"\n", tx3g->startChar );
-    lsmash_ifprintf( fp, indent, "endChar = %"PRIu16"\n", tx3g->endChar );
-    lsmash_ifprintf( fp, indent, "font_ID = %"PRIu16"\n", tx3g->font_ID );
-    lsmash_ifprintf( fp, indent, "face_style_flags = %"PRIu8"\n", tx3g->face_style_flags );
-    lsmash_ifprintf( fp, indent, "font_size = %"PRIu8"\n", tx3g->font_size );
-    lsmash_ifprintf( fp, indent, "text_color_rgba\n" );
-    isom_ifprintf_rgba_color( fp, indent + 1, tx3g->text_color_rgba );
-    return 0;
-}
-
-static int isom_print_ftab( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+    isom_iprint_box( printer, indent++, "tx3g", "Timed Text Description" );
+    isom_iprint_uint( printer, indent, "position", tx3g->pos );
+    isom_iprint_uint( printer, indent, "size", tx3g->size );
+    isom_ifprintf_sample_description_common_reserved( printer, indent, tx3g->reserved );
+    isom_iprint_uint( printer, indent, "data_reference_index", tx3g->data_reference_index );
+    isom_iprint_hex( printer, indent, "displayFlags", tx3g->displayFlags, 8 );
+    isom_iprint_int( printer, indent, "horizontal_justification", tx3g->horizontal_justification );
+    isom_iprint_int( printer, indent, "vertical_justification", tx3g->vertical_justification );
+    isom_ifprintf_rgba_color( printer, indent, "background_color_rgba", tx3g->background_color_rgba );
+    isom_iprint_int( printer, indent, "top", tx3g->top );
+    isom_iprint_int( printer, indent, "left", tx3g->left );
+    isom_iprint_int( printer, indent, "bottom", tx3g->bottom );
+    isom_iprint_int( printer, indent, "right", tx3g->right );
+    isom_iprint_uint( printer, indent, "startChar", tx3g->startChar );
+    isom_iprint_uint( printer, indent, "endChar", tx3g->endChar );
+    isom_iprint_uint( printer, indent, "font_ID", tx3g->font_ID );
+    isom_iprint_uint( printer, indent, "face_style_flags", tx3g->face_style_flags );
+    isom_iprint_uint( printer, indent, "font_size", tx3g->font_size );
+    isom_ifprintf_rgba_color( printer, indent, "text_color_rgba", tx3g->text_color_rgba );
+    return 0;
+}
+
+static int isom_print_ftab( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_ftab_t *)box)->list )
         return LSMASH_ERR_INVALID_DATA;
     isom_ftab_t *ftab = (isom_ftab_t *)box;
     int indent = level;
     uint16_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Font Table Box" );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu16"\n", ftab->list->entry_count );
+    isom_print_box_common( printer, indent++, box, "Font Table Box" );
+    isom_iprint_uint( printer, indent, "entry_count", ftab->list->entry_count );
     for( lsmash_entry_t *entry = ftab->list->head; entry; entry = entry->next )
     {
         isom_font_record_t *data = (isom_font_record_t *)entry->data;
-        lsmash_ifprintf( fp, indent++, "entry[%"PRIu16"]\n", i++ );
-        lsmash_ifprintf( fp, indent, "font_ID = %"PRIu16"\n", data->font_ID );
+        isom_iprint_element( printer, indent++, "entry", i++ );
+        isom_iprint_uint( printer, indent, "font_ID", data->font_ID );
         if( data->font_name_length )
-            lsmash_ifprintf( fp, indent, "font_name = %s\n", data->font_name );
+            isom_iprint_string( printer, indent, "font_name", data->font_name );
         --indent;
     }
     return 0;
 }
 
-static int isom_print_mp4s_description( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_mp4s_description( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_mp4s_entry_t *mp4s = (isom_mp4s_entry_t *)box;
     int indent = level;
-    lsmash_ifprintf( fp, indent++, "[%s: MPEG-4 Systems Description]\n", isom_4cc2str( mp4s->type.fourcc ) );
-    lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", mp4s->pos );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", mp4s->size );
-    isom_ifprintf_sample_description_common_reserved( fp, indent, mp4s->reserved );
-    lsmash_ifprintf( fp, indent, "data_reference_index = %"PRIu16"\n", mp4s->data_reference_index );
+    isom_iprint_box( printer, indent++, isom_4cc2str( mp4s->type.fourcc ), "MPEG-4 Systems Description" );
+    isom_iprint_uint( printer, indent, "position", mp4s->pos );
+    isom_iprint_uint( printer, indent, "size", mp4s->size );
+    isom_ifprintf_sample_description_common_reserved( printer, indent, mp4s->reserved );
+    isom_iprint_uint( printer, indent, "data_reference_index", mp4s->data_reference_index );
     return 0;
 }
 
-static int isom_print_sample_description_extesion( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_sample_description_extesion( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    extern int mp4sys_print_codec_specific( FILE *, lsmash_file_t *, isom_box_t *, int );
-    extern int h264_print_codec_specific( FILE *, lsmash_file_t *, isom_box_t *, int );
-    extern int hevc_print_codec_specific( FILE *, lsmash_file_t *, isom_box_t *, int );
-    extern int h264_print_bitrate( FILE *, lsmash_file_t *, isom_box_t *, int );
-    extern int vc1_print_codec_specific( FILE *, lsmash_file_t *, isom_box_t *, int );
-    extern int ac3_print_codec_specific( FILE *, lsmash_file_t *, isom_box_t *, int );
-    extern int eac3_print_codec_specific( FILE *, lsmash_file_t *, isom_box_t *, int );
-    extern int dts_print_codec_specific( FILE *, lsmash_file_t *, isom_box_t *, int );
-    extern int alac_print_codec_specific( FILE *, lsmash_file_t *, isom_box_t *, int );
-    extern int wma_print_codec_specific( FILE *, lsmash_file_t *, isom_box_t *, int );
+    extern int mp4sys_print_codec_specific( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
+    extern int h264_print_codec_specific( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
+    extern int hevc_print_codec_specific( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
+    extern int h264_print_bitrate( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
+    extern int vc1_print_codec_specific( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
+    extern int ac3_print_codec_specific( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
+    extern int eac3_print_codec_specific( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
+    extern int dts_print_codec_specific( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
+    extern int alac_print_codec_specific( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
+    extern int wma_print_codec_specific( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
     static struct print_description_extension_table_tag
     {
         lsmash_box_type_t type;
-        int (*print_func)( FILE *, lsmash_file_t *, isom_box_t *, int );
+        int (*print_func)( isom_printer_t *, lsmash_file_t *, isom_box_t *, int );
     } print_description_extension_table[32] = { { LSMASH_BOX_TYPE_INITIALIZER, NULL } };
     if( !print_description_extension_table[0].print_func )
     {
@@ -1370,265 +2067,269 @@ static int isom_print_sample_description_extesion( FILE *fp, lsmash_file_t *file
     }
     for( int i = 0; print_description_extension_table[i].print_func; i++ )
         if( lsmash_check_box_type_identical( box->type, print_description_extension_table[i].type ) )
-            return print_description_extension_table[i].print_func( fp, file, box, level );
-    return isom_print_unknown( fp, file, box, level );
+            return print_description_extension_table[i].print_func( printer, file, box, level );
+    return isom_print_unknown( printer, file, box, level );
 }
 
-static int isom_print_stts( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_stts( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_stts_t *)box)->list )
         return LSMASH_ERR_INVALID_DATA;
     isom_stts_t *stts = (isom_stts_t *)box;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Decoding Time to Sample Box" );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", stts->list->entry_count );
+    isom_print_box_common( printer, indent++, box, "Decoding Time to Sample Box" );
+    isom_iprint_uint( printer, indent, "entry_count", stts->list->entry_count );
     for( lsmash_entry_t *entry = stts->list->head; entry; entry = entry->next )
     {
         isom_stts_entry_t *data = (isom_stts_entry_t *)entry->data;
-        lsmash_ifprintf( fp, indent++, "entry[%"PRIu32"]\n", i++ );
-        lsmash_ifprintf( fp, indent, "sample_count = %"PRIu32"\n", data->sample_count );
-        lsmash_ifprintf( fp, indent--, "sample_delta = %"PRIu32"\n", data->sample_delta );
+        isom_iprint_element( printer, indent++, "entry", i++ );
+        isom_iprint_uint( printer, indent, "sample_count", data->sample_count );
+        isom_iprint_uint( printer, indent--, "sample_delta", data->sample_delta );
     }
     return 0;
 }
 
-static int isom_print_ctts( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_ctts( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_ctts_t *)box)->list )
         return LSMASH_ERR_INVALID_DATA;
     isom_ctts_t *ctts = (isom_ctts_t *)box;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Composition Time to Sample Box" );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", ctts->list->entry_count );
+    isom_print_box_common( printer, indent++, box, "Composition Time to Sample Box" );
+    isom_iprint_uint( printer, indent, "entry_count", ctts->list->entry_count );
     if( file->qt_compatible || ctts->version == 1 )
         for( lsmash_entry_t *entry = ctts->list->head; entry; entry = entry->next )
         {
             isom_ctts_entry_t *data = (isom_ctts_entry_t *)entry->data;
-            lsmash_ifprintf( fp, indent++, "entry[%"PRIu32"]\n", i++ );
-            lsmash_ifprintf( fp, indent, "sample_count = %"PRIu32"\n", data->sample_count );
+            isom_iprint_element( printer, indent++, "entry", i++ );
+            isom_iprint_uint( printer, indent, "sample_count", data->sample_count );
             if( data->sample_offset != ISOM_NON_OUTPUT_SAMPLE_OFFSET )
-                lsmash_ifprintf( fp, indent--, "sample_offset = %"PRId32"\n", (union {uint32_t ui; int32_t si;}){ data->sample_offset }.si );
+                isom_iprint_int( printer, indent--, "sample_offset", (union {uint32_t ui; int32_t si;}){ data->sample_offset }.si );
             else
-                lsmash_ifprintf( fp, indent--, "sample_offset = -2^31 (non-output sample)\n" );
+            {
+                if( isom_printer_is_text( printer ) )
+                    isom_iprint_string( printer, indent--, "sample_offset", "-2^31" );
+                else
+                    isom_iprint_int( printer, indent--, "sample_offset", INT32_MIN );
+                isom_iprint_note( printer, "non-output sample" );
+            }
         }
     else
         for( lsmash_entry_t *entry = ctts->list->head; entry; entry = entry->next )
         {
             isom_ctts_entry_t *data = (isom_ctts_entry_t *)entry->data;
-            lsmash_ifprintf( fp, indent++, "entry[%"PRIu32"]\n", i++ );
-            lsmash_ifprintf( fp, indent, "sample_count = %"PRIu32"\n", data->sample_count );
-            lsmash_ifprintf( fp, indent--, "sample_offset = %"PRIu32"\n", data->sample_offset );
+            isom_iprint_element( printer, indent++, "entry", i++ );
+            isom_iprint_uint( printer, indent, "sample_count", data->sample_count );
+            isom_iprint_uint( printer, indent--, "sample_offset", data->sample_offset );
         }
     return 0;
 }
 
-static int isom_print_cslg( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_cslg( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_cslg_t *cslg = (isom_cslg_t *)box;
     int indent = level;
     if( file->qt_compatible )
     {
-        isom_print_box_common( fp, indent++, box, "Composition Shift Least Greatest Box" );
-        lsmash_ifprintf( fp, indent, "compositionOffsetToDTDDeltaShift = %"PRId32"\n", cslg->compositionToDTSShift );
-        lsmash_ifprintf( fp, indent, "leastDecodeToDisplayDelta = %"PRId32"\n", cslg->leastDecodeToDisplayDelta );
-        lsmash_ifprintf( fp, indent, "greatestDecodeToDisplayDelta = %"PRId32"\n", cslg->greatestDecodeToDisplayDelta );
-        lsmash_ifprintf( fp, indent, "displayStartTime = %"PRId32"\n", cslg->compositionStartTime );
-        lsmash_ifprintf( fp, indent, "displayEndTime = %"PRId32"\n", cslg->compositionEndTime );
+        isom_print_box_common( printer, indent++, box, "Composition Shift Least Greatest Box" );
+        isom_iprint_int( printer, indent, "compositionOffsetToDTDDeltaShift", cslg->compositionToDTSShift );
+        isom_iprint_int( printer, indent, "leastDecodeToDisplayDelta", cslg->leastDecodeToDisplayDelta );
+        isom_iprint_int( printer, indent, "greatestDecodeToDisplayDelta", cslg->greatestDecodeToDisplayDelta );
+        isom_iprint_int( printer, indent, "displayStartTime", cslg->compositionStartTime );
+        isom_iprint_int( printer, indent, "displayEndTime", cslg->compositionEndTime );
     }
     else
     {
-        isom_print_box_common( fp, indent++, box, "Composition to Decode Box" );
-        lsmash_ifprintf( fp, indent, "compositionToDTSShift = %"PRId32"\n", cslg->compositionToDTSShift );
-        lsmash_ifprintf( fp, indent, "leastDecodeToDisplayDelta = %"PRId32"\n", cslg->leastDecodeToDisplayDelta );
-        lsmash_ifprintf( fp, indent, "greatestDecodeToDisplayDelta = %"PRId32"\n", cslg->greatestDecodeToDisplayDelta );
-        lsmash_ifprintf( fp, indent, "compositionStartTime = %"PRId32"\n", cslg->compositionStartTime );
-        lsmash_ifprintf( fp, indent, "compositionEndTime = %"PRId32"\n", cslg->compositionEndTime );
+        isom_print_box_common( printer, indent++, box, "Composition to Decode Box" );
+        isom_iprint_int( printer, indent, "compositionToDTSShift", cslg->compositionToDTSShift );
+        isom_iprint_int( printer, indent, "leastDecodeToDisplayDelta", cslg->leastDecodeToDisplayDelta );
+        isom_iprint_int( printer, indent, "greatestDecodeToDisplayDelta", cslg->greatestDecodeToDisplayDelta );
+        isom_iprint_int( printer, indent, "compositionStartTime", cslg->compositionStartTime );
+        isom_iprint_int( printer, indent, "compositionEndTime", cslg->compositionEndTime );
     }
     return 0;
 }
 
-static int isom_print_stss( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_stss( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_stss_t *)box)->list )
         return LSMASH_ERR_INVALID_DATA;
     isom_stss_t *stss = (isom_stss_t *)box;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Sync Sample Box" );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", stss->list->entry_count );
+    isom_print_box_common( printer, indent++, box, "Sync Sample Box" );
+    isom_iprint_uint( printer, indent, "entry_count", stss->list->entry_count );
     for( lsmash_entry_t *entry = stss->list->head; entry; entry = entry->next )
-        lsmash_ifprintf( fp, indent, "sample_number[%"PRIu32"] = %"PRIu32"\n", i++, ((isom_stss_entry_t *)entry->data)->sample_number );
+        isom_iprint_uint_at( printer, indent, "sample_number", i++, ((isom_stss_entry_t *)entry->data)->sample_number );
     return 0;
 }
 
-static int isom_print_stps( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_stps( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_stps_t *)box)->list )
         return LSMASH_ERR_INVALID_DATA;
     isom_stps_t *stps = (isom_stps_t *)box;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Partial Sync Sample Box" );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", stps->list->entry_count );
+    isom_print_box_common( printer, indent++, box, "Partial Sync Sample Box" );
+    isom_iprint_uint( printer, indent, "entry_count", stps->list->entry_count );
     for( lsmash_entry_t *entry = stps->list->head; entry; entry = entry->next )
-        lsmash_ifprintf( fp, indent, "sample_number[%"PRIu32"] = %"PRIu32"\n", i++, ((isom_stps_entry_t *)entry->data)->sample_number );
+        isom_iprint_uint_at( printer, indent, "sample_number", i++, ((isom_stps_entry_t *)entry->data)->sample_number );
     return 0;
 }
 
-static int isom_print_sdtp( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_sdtp( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_sdtp_t *)box)->list )
         return LSMASH_ERR_INVALID_DATA;
     isom_sdtp_t *sdtp = (isom_sdtp_t *)box;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Independent and Disposable Samples Box" );
+    isom_print_box_common( printer, indent++, box, "Independent and Disposable Samples Box" );
     for( lsmash_entry_t *entry = sdtp->list->head; entry; entry = entry->next )
     {
         isom_sdtp_entry_t *data = (isom_sdtp_entry_t *)entry->data;
-        lsmash_ifprintf( fp, indent++, "entry[%"PRIu32"]\n", i++ );
+        isom_iprint_element( printer, indent++, "entry", i++ );
         if( data->is_leading || data->sample_depends_on || data->sample_is_depended_on || data->sample_has_redundancy )
         {
             if( file->avc_extensions )
             {
                 if( data->is_leading == ISOM_SAMPLE_IS_UNDECODABLE_LEADING )
-                    lsmash_ifprintf( fp, indent, "undecodable leading\n" );
+                    isom_iprint_label( printer, indent, "undecodable leading" );
                 else if( data->is_leading == ISOM_SAMPLE_IS_NOT_LEADING )
-                    lsmash_ifprintf( fp, indent, "non-leading\n" );
+                    isom_iprint_label( printer, indent, "non-leading" );
                 else if( data->is_leading == ISOM_SAMPLE_IS_DECODABLE_LEADING )
-                    lsmash_ifprintf( fp, indent, "decodable leading\n" );
+                    isom_iprint_label( printer, indent, "decodable leading" );
             }
             else if( data->is_leading == QT_SAMPLE_EARLIER_PTS_ALLOWED )
-                lsmash_ifprintf( fp, indent, "early display times allowed\n" );
+                isom_iprint_label( printer, indent, "early display times allowed" );
             if( data->sample_depends_on == ISOM_SAMPLE_IS_INDEPENDENT )
-                lsmash_ifprintf( fp, indent, "independent\n" );
+                isom_iprint_label( printer, indent, "independent" );
             else if( data->sample_depends_on == ISOM_SAMPLE_IS_NOT_INDEPENDENT )
-                lsmash_ifprintf( fp, indent, "dependent\n" );
+                isom_iprint_label( printer, indent, "dependent" );
             if( data->sample_is_depended_on == ISOM_SAMPLE_IS_NOT_DISPOSABLE )
-                lsmash_ifprintf( fp, indent, "non-disposable\n" );
+                isom_iprint_label( printer, indent, "non-disposable" );
             else if( data->sample_is_depended_on == ISOM_SAMPLE_IS_DISPOSABLE )
-                lsmash_ifprintf( fp, indent, "disposable\n" );
+                isom_iprint_label( printer, indent, "disposable" );
             if( data->sample_has_redundancy == ISOM_SAMPLE_HAS_REDUNDANCY )
-                lsmash_ifprintf( fp, indent, "redundant\n" );
+                isom_iprint_label( printer, indent, "redundant" );
             else if( data->sample_has_redundancy == ISOM_SAMPLE_HAS_NO_REDUNDANCY )
-                lsmash_ifprintf( fp, indent, "non-redundant\n" );
+                isom_iprint_label( printer, indent, "non-redundant" );
         }
         else
-            lsmash_ifprintf( fp, indent, "no description\n" );
+            isom_iprint_label( printer, indent, "no description" );
         --indent;
     }
     return 0;
 }
 
-static int isom_print_stsc( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_stsc( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_stsc_t *)box)->list )
         return LSMASH_ERR_INVALID_DATA;
     isom_stsc_t *stsc = (isom_stsc_t *)box;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Sample To Chunk Box" );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", stsc->list->entry_count );
+    isom_print_box_common( printer, indent++, box, "Sample To Chunk Box" );
+    isom_iprint_uint( printer, indent, "entry_count", stsc->list->entry_count );
     for( lsmash_entry_t *entry = stsc->list->head; entry; entry = entry->next )
     {
         isom_stsc_entry_t *data = (isom_stsc_entry_t *)entry->data;
-        lsmash_ifprintf( fp, indent++, "entry[%"PRIu32"]\n", i++ );
-        lsmash_ifprintf( fp, indent, "first_chunk = %"PRIu32"\n", data->first_chunk );
-        lsmash_ifprintf( fp, indent, "samples_per_chunk = %"PRIu32"\n", data->samples_per_chunk );
-        lsmash_ifprintf( fp, indent--, "sample_description_index = %"PRIu32"\n", data->sample_description_index );
+        isom_iprint_element( printer, indent++, "entry", i++ );
+        isom_iprint_uint( printer, indent, "first_chunk", data->first_chunk );
+        isom_iprint_uint( printer, indent, "samples_per_chunk", data->samples_per_chunk );
+        isom_iprint_uint( printer, indent--, "sample_description_index", data->sample_description_index );
     }
     return 0;
 }
 
-static int isom_print_stsz( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_stsz( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_stsz_t *stsz = (isom_stsz_t *)box;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Sample Size Box" );
-    if( !stsz->sample_size )
-        lsmash_ifprintf( fp, indent, "sample_size = 0 (variable)\n" );
-    else
-        lsmash_ifprintf( fp, indent, "sample_size = %"PRIu32" (constant)\n", stsz->sample_size );
-    lsmash_ifprintf( fp, indent, "sample_count = %"PRIu32"\n", stsz->sample_count );
+    isom_print_box_common( printer, indent++, box, "Sample Size Box" );
+    isom_iprint_uint( printer, indent, "sample_size", stsz->sample_size );
+    isom_iprint_note( printer, stsz->sample_size ? "constant" : "variable" );
+    isom_iprint_uint( printer, indent, "sample_count", stsz->sample_count );
     if( !stsz->sample_size && stsz->list )
         for( lsmash_entry_t *entry = stsz->list->head; entry; entry = entry->next )
         {
             isom_stsz_entry_t *data = (isom_stsz_entry_t *)entry->data;
-            lsmash_ifprintf( fp, indent, "entry_size[%"PRIu32"] = %"PRIu32"\n", i++, data->entry_size );
+            isom_iprint_uint_at( printer, indent, "entry_size", i++, data->entry_size );
         }
     return 0;
 }
 
-static int isom_print_stz2( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_stz2( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_stz2_t *stz2 = (isom_stz2_t *)box;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Compact Sample Size Box" );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%06"PRIx32"\n", stz2->reserved );
-    lsmash_ifprintf( fp, indent, "field_size = %"PRIu8"\n", stz2->field_size );
-    lsmash_ifprintf( fp, indent, "sample_count = %"PRIu32"\n", stz2->sample_count );
+    isom_print_box_common( printer, indent++, box, "Compact Sample Size Box" );
+    isom_iprint_hex( printer, indent, "reserved", stz2->reserved, 6 );
+    isom_iprint_uint( printer, indent, "field_size", stz2->field_size );
+    isom_iprint_uint( printer, indent, "sample_count", stz2->sample_count );
     for( lsmash_entry_t *entry = stz2->list->head; entry; entry = entry->next )
     {
         isom_stsz_entry_t *data = (isom_stsz_entry_t *)entry->data;
-        lsmash_ifprintf( fp, indent, "entry_size[%"PRIu32"] = %"PRIu32"\n", i++, data->entry_size );
+        isom_iprint_uint_at( printer, indent, "entry_size", i++, data->entry_size );
     }
     return 0;
 }
 
-static int isom_print_stco( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_stco( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_stco_t *)box)->list )
         return LSMASH_ERR_INVALID_DATA;
     isom_stco_t *stco = (isom_stco_t *)box;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Chunk Offset Box" );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", stco->list->entry_count );
+    isom_print_box_common( printer, indent++, box, "Chunk Offset Box" );
+    isom_iprint_uint( printer, indent, "entry_count", stco->list->entry_count );
     if( lsmash_check_box_type_identical( stco->type, ISOM_BOX_TYPE_STCO ) )
     {
         for( lsmash_entry_t *entry = stco->list->head; entry; entry = entry->next )
-            lsmash_ifprintf( fp, indent, "chunk_offset[%"PRIu32"] = %"PRIu32"\n", i++, ((isom_stco_entry_t *)entry->data)->chunk_offset );
+            isom_iprint_uint_at( printer, indent, "chunk_offset", i++, ((isom_stco_entry_t *)entry->data)->chunk_offset );
     }
     else
     {
         for( lsmash_entry_t *entry = stco->list->head; entry; entry = entry->next )
-            lsmash_ifprintf( fp, indent, "chunk_offset[%"PRIu32"] = %"PRIu64"\n", i++, ((isom_co64_entry_t *)entry->data)->chunk_offset );
+            isom_iprint_uint_at( printer, indent, "chunk_offset", i++, ((isom_co64_entry_t *)entry->data)->chunk_offset );
     }
     return 0;
 }
 
-static int isom_print_sgpd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_sgpd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_sgpd_t *)box)->list )
         return LSMASH_ERR_INVALID_DATA;
     isom_sgpd_t *sgpd = (isom_sgpd_t *)box;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Sample Group Description Box" );
-    lsmash_ifprintf( fp, indent, "grouping_type = %s\n", isom_4cc2str( sgpd->grouping_type ) );
+    isom_print_box_common( printer, indent++, box, "Sample Group Description Box" );
+    isom_iprint_fourcc( printer, indent, "grouping_type", sgpd->grouping_type );
     if( sgpd->version == 1 )
     {
-        lsmash_ifprintf( fp, indent, "default_length = %"PRIu32, sgpd->default_length );
-        fprintf( fp, " %s\n", sgpd->default_length ? "(constant)" : "(variable)" );
+        isom_iprint_uint( printer, indent, "default_length", sgpd->default_length );
+        isom_iprint_note( printer, sgpd->default_length ? "constant" : "variable" );
     }
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", sgpd->list->entry_count );
+    isom_iprint_uint( printer, indent, "entry_count", sgpd->list->entry_count );
     switch( sgpd->grouping_type )
     {
         case ISOM_GROUP_TYPE_RAP :
             for( lsmash_entry_t *entry = sgpd->list->head; entry; entry = entry->next )
             {
                 if( sgpd->version == 1 && !sgpd->default_length )
-                    lsmash_ifprintf( fp, indent, "description_length[%"PRIu32"] = %"PRIu32"\n", i++, ((isom_rap_entry_t *)entry->data)->description_length );
+                    isom_iprint_uint_at( printer, indent, "description_length", i++, ((isom_rap_entry_t *)entry->data)->description_length );
                 else
                 {
                     isom_rap_entry_t *rap = (isom_rap_entry_t *)entry->data;
-                    lsmash_ifprintf( fp, indent++, "entry[%"PRIu32"]\n", i++ );
-                    lsmash_ifprintf( fp, indent, "num_leading_samples_known = %"PRIu8"\n", rap->num_leading_samples_known );
-                    lsmash_ifprintf( fp, indent--, "num_leading_samples = %"PRIu8"\n", rap->num_leading_samples );
+                    isom_iprint_element( printer, indent++, "entry", i++ );
+                    isom_iprint_uint( printer, indent, "num_leading_samples_known", rap->num_leading_samples_known );
+                    isom_iprint_uint( printer, indent--, "num_leading_samples", rap->num_leading_samples );
                 }
             }
             break;
@@ -1637,9 +2338,9 @@ static int isom_print_sgpd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
             for( lsmash_entry_t *entry = sgpd->list->head; entry; entry = entry->next )
             {
                 if( sgpd->version == 1 && !sgpd->default_length )
-                    lsmash_ifprintf( fp, indent, "description_length[%"PRIu32"] = %"PRIu32"\n", i++, ((isom_roll_entry_t *)entry->data)->description_length );
+                    isom_iprint_uint_at( printer, indent, "description_length", i++, ((isom_roll_entry_t *)entry->data)->description_length );
                 else
-                    lsmash_ifprintf( fp, indent, "roll_distance[%"PRIu32"] = %"PRId16"\n", i++, ((isom_roll_entry_t *)entry->data)->roll_distance );
+                    isom_iprint_int_at( printer, indent, "roll_distance", i++, ((isom_roll_entry_t *)entry->data)->roll_distance );
             }
             break;
         default :
@@ -1648,7 +2349,7 @@ static int isom_print_sgpd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
     return 0;
 }
 
-static int isom_print_sbgp( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_sbgp( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_sbgp_t *)box)->list )
         return LSMASH_ERR_INVALID_DATA;
@@ -1656,33 +2357,31 @@ static int isom_print_sbgp( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
     int indent = level;
     int is_fragment = lsmash_check_box_type_identical( sbgp->parent->type, ISOM_BOX_TYPE_TRAF );
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Sample to Group Box" );
-    lsmash_ifprintf( fp, indent, "grouping_type = %s\n", isom_4cc2str( sbgp->grouping_type ) );
+    isom_print_box_common( printer, indent++, box, "Sample to Group Box" );
+    isom_iprint_fourcc( printer, indent, "grouping_type", sbgp->grouping_type );
     if( sbgp->version == 1 )
-        lsmash_ifprintf( fp, indent, "grouping_type_parameter = %s\n", isom_4cc2str( sbgp->grouping_type_parameter ) );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", sbgp->list->entry_count );
+        isom_iprint_fourcc( printer, indent, "grouping_type_parameter", sbgp->grouping_type_parameter );
+    isom_iprint_uint( printer, indent, "entry_count", sbgp->list->entry_count );
     for( lsmash_entry_t *entry = sbgp->list->head; entry; entry = entry->next )
     {
         isom_group_assignment_entry_t *data = (isom_group_assignment_entry_t *)entry->data;
-        lsmash_ifprintf( fp, indent++, "entry[%"PRIu32"]\n", i++ );
-        lsmash_ifprintf( fp, indent, "sample_count = %"PRIu32"\n", data->sample_count );
-        lsmash_ifprintf( fp, indent--, "group_description_index = %"PRIu32, data->group_description_index );
+        isom_iprint_element( printer, indent++, "entry", i++ );
+        isom_iprint_uint( printer, indent, "sample_count", data->sample_count );
+        isom_iprint_uint( printer, indent--, "group_description_index", data->group_description_index );
         if( is_fragment && data->group_description_index >= 0x10000 )
-            fprintf( fp, " (i.e. %"PRIu32" for this fragment-local group)", data->group_description_index - 0x10000 );
+            isom_iprint_note( printer, "i.e. %"PRIu32" for this fragment-local group", data->group_description_index - 0x10000 );
         if( !data->group_description_index )
-            fprintf( fp, " (not in this grouping type)\n" );
-        else
-            fprintf( fp, "\n" );
+            isom_iprint_note( printer, "not in this grouping type" );
     }
     return 0;
 }
 
-static int isom_print_udta( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_udta( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "User Data Box" );
+    return isom_print_simple( printer, box, level, "User Data Box" );
 }
 
-static int isom_print_chpl( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_chpl( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_chpl_t *chpl = (isom_chpl_t *)box;
     uint32_t timescale;
@@ -1696,14 +2395,14 @@ static int isom_print_chpl( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
         timescale = 10000000;
     int indent = level;
     uint32_t i = 0;
-    isom_print_box_common( fp, indent++, box, "Chapter List Box" );
+    isom_print_box_common( printer, indent++, box, "Chapter List Box" );
     if( chpl->version == 1 )
     {
-        lsmash_ifprintf( fp, indent, "unknown = 0x%02"PRIx8"\n", chpl->unknown );
-        lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", chpl->list->entry_count );
+        isom_iprint_hex( printer, indent, "unknown", chpl->unknown, 2 );
+        isom_iprint_uint( printer, indent, "entry_count", chpl->list->entry_count );
     }
     else
-        lsmash_ifprintf( fp, indent, "entry_count = %"PRIu8"\n", (uint8_t)chpl->list->entry_count );
+        isom_iprint_uint( printer, indent, "entry_count", (uint8_t)chpl->list->entry_count );
     for( lsmash_entry_t *entry = chpl->list->head; entry; entry = entry->next )
     {
         isom_chpl_entry_t *data = (isom_chpl_entry_t *)entry->data;
@@ -1718,68 +2417,94 @@ static int isom_print_chpl( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
             data->chapter_name += 3;
             with_bom = 1;
         }
-        lsmash_ifprintf( fp, indent++, "chapter[%"PRIu32"]\n", i++ );
-        lsmash_ifprintf( fp, indent, "start_time = %02d:%02d:%02d.%03d\n", hh, mm, ss, ms );
-        lsmash_ifprintf( fp, indent--, with_bom ? "chapter_name = %s ( it has BOM in it )\n" : "chapter_name = %s\n", data->chapter_name );
+        isom_iprint_element( printer, indent++, "chapter", i++ );
+        /* The text shows the start time in the clock format, and the structured formats the number annotated with it. */
+        char clock[32];
+        sprintf( clock, "%02d:%02d:%02d.%03d", hh, mm, ss, ms );
+        if( isom_printer_is_text( printer ) )
+            isom_iprint_string( printer, indent, "start_time", clock );
+        else
+        {
+            isom_iprint_uint( printer, indent, "start_time", data->start_time );
+            isom_iprint_note( printer, "%s", clock );
+        }
+        isom_iprint_string( printer, indent--, "chapter_name", data->chapter_name );
+        if( with_bom )
+            isom_printer_put_attribute( printer, "note", " ( ", " )", "it has BOM in it" );
     }
     return 0;
 }
 
-static int isom_print_meta( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_meta( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     int indent = level;
     if( !(box->manager & LSMASH_QTFF_BASE) )
     {
-        isom_print_basebox_common( fp, indent++, box, "Meta Box" );
-        lsmash_ifprintf( fp, indent, "version = %"PRIu8"\n", box->version );
-        lsmash_ifprintf( fp, indent, "flags = 0x%06"PRIx32"\n", box->flags & 0x00ffffff );
+        isom_print_basebox_common( printer, indent++, box, "Meta Box" );
+        isom_iprint_uint( printer, indent, "version", box->version );
+        isom_iprint_hex( printer, indent, "flags", box->flags & 0x00ffffff, 6 );
     }
     else
-        isom_print_basebox_common( fp, indent, box, "Metadata Box" );
+        isom_print_basebox_common( printer, indent, box, "Metadata Box" );
     return 0;
 }
 
-static int isom_print_keys( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_keys( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     if( !((isom_keys_t *)box)->list )
         return LSMASH_ERR_INVALID_DATA;
     isom_keys_t *keys = (isom_keys_t *)box;
     int indent = level;
     uint32_t i = 1;
-    isom_print_box_common( fp, indent++, box, "Metadata Item Keys Box" );
-    lsmash_ifprintf( fp, indent, "entry_count = %"PRIu32"\n", keys->list->entry_count );
+    isom_print_box_common( printer, indent++, box, "Metadata Item Keys Box" );
+    isom_iprint_uint( printer, indent, "entry_count", keys->list->entry_count );
     for( lsmash_entry_t *entry = keys->list->head; entry; entry = entry->next )
     {
         isom_keys_entry_t *data = (isom_keys_entry_t *)entry->data;
-        lsmash_ifprintf( fp, indent++, "[key %"PRIu32"]\n", i++ );
-        lsmash_ifprintf( fp, indent, "key_size = %"PRIu32"\n", data->key_size );
-        lsmash_ifprintf( fp, indent, "key_namespace = %s\n", isom_4cc2str( data->key_namespace ) );
+        if( isom_printer_is_text( printer ) )
+        {
+            isom_printer_open_node( printer, indent );
+            lsmash_ifprintf( printer->emitter.fp, indent++, "[key %"PRIu32"]", i++ );
+        }
+        else
+            isom_iprint_element( printer, indent++, "key", i++ );
+        isom_iprint_uint( printer, indent, "key_size", data->key_size );
+        isom_iprint_fourcc( printer, indent, "key_namespace", data->key_namespace );
         uint32_t value_length = data->key_size - 8;
         char *str = lsmash_malloc( value_length + 1 );
         if( !str )
             return LSMASH_ERR_MEMORY_ALLOC;
         memcpy( str, data->key_value, value_length );
         str[value_length] = 0;
-        lsmash_ifprintf( fp, indent--, "key_value = %s\n", str );
+        isom_iprint_string( printer, indent--, "key_value", str );
         lsmash_free( str );
     }
     return 0;
 }
 
-static int isom_print_ilst( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_ilst( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Metadata Item List Box" );
+    return isom_print_simple( printer, box, level, "Metadata Item List Box" );
 }
 
-static int isom_print_metaitem( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_metaitem( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_metaitem_t *metaitem = (isom_metaitem_t *)box;
     if( box->parent->parent->manager & LSMASH_QTFF_BASE )
     {
         int indent = level;
-        lsmash_ifprintf( fp, indent++, "[key_index %"PRIu32": Metadata Item Box]\n", box->type.fourcc );
-        lsmash_ifprintf( fp, indent, "position = %"PRIu64"\n", box->pos );
-        lsmash_ifprintf( fp, indent, "size = %"PRIu64"\n", box->size );
+        if( isom_printer_is_text( printer ) )
+        {
+            isom_printer_open_node( printer, indent );
+            lsmash_ifprintf( printer->emitter.fp, indent++, "[key_index %"PRIu32": Metadata Item Box]", box->type.fourcc );
+        }
+        else
+        {
+            isom_iprint_box( printer, indent++, NULL, "Metadata Item Box" );
+            isom_iprint_uint( printer, indent, "key_index", box->type.fourcc );
+        }
+        isom_iprint_uint( printer, indent, "position", box->pos );
+        isom_iprint_uint( printer, indent, "size", box->size );
         return 0;
     }
     static const struct
@@ -1861,46 +2586,46 @@ static int isom_print_metaitem( FILE *fp, lsmash_file_t *file, isom_box_t *box,
     memcpy( display_name + 19, name, name_length );
     display_name[display_name_length - 1] = ')';
     display_name[display_name_length] = 0;
-    int ret = isom_print_simple( fp, box, level, display_name );
+    int ret = isom_print_simple( printer, box, level, display_name );
     lsmash_free( display_name );
     return ret;
 }
 
-static int isom_print_name( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_name( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_name_t *name = (isom_name_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Name Box" );
+    isom_print_box_common( printer, indent++, box, "Name Box" );
     char *str = lsmash_malloc( name->name_length + 1 );
     if( !str )
         return LSMASH_ERR_MEMORY_ALLOC;
     memcpy( str, name->name, name->name_length );
     str[name->name_length] = 0;
-    lsmash_ifprintf( fp, indent, "name = %s\n", str );
+    isom_iprint_string( printer, indent, "name", str );
     lsmash_free( str );
     return 0;
 }
 
-static int isom_print_mean( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_mean( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_mean_t *mean = (isom_mean_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Mean Box" );
+    isom_print_box_common( printer, indent++, box, "Mean Box" );
     char *str = lsmash_malloc( mean->meaning_string_length + 1 );
     if( !str )
         return LSMASH_ERR_MEMORY_ALLOC;
     memcpy( str, mean->meaning_string, mean->meaning_string_length );
     str[mean->meaning_string_length] = 0;
-    lsmash_ifprintf( fp, indent, "meaning_string = %s\n", str );
+    isom_iprint_string( printer, indent, "meaning_string", str );
     lsmash_free( str );
     return 0;
 }
 
-static int isom_print_data( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_data( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_data_t *data = (isom_data_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Data Box" );
+    isom_print_box_common( printer, indent++, box, "Data Box" );
     if( box->parent->parent->parent->manager & LSMASH_QTFF_BASE )
     {
         uint32_t type_set_indicator = data->reserved >> 8;
@@ -1935,12 +2660,13 @@ static int isom_print_data( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
                 well_known_type_name = well_known_type_table[table_index].name;
                 break;
             }
-        lsmash_ifprintf( fp, indent, "type_set_indicator = %"PRIu8"\n", type_set_indicator );
-        lsmash_ifprintf( fp, indent, "well_known_type = %"PRIu32" (%s)\n", well_known_type, well_known_type_name );
-        lsmash_ifprintf( fp, indent, "locale_indicator = %"PRIu32"\n", data->the_locale );
+        isom_iprint_uint( printer, indent, "type_set_indicator", type_set_indicator );
+        isom_iprint_uint( printer, indent, "well_known_type", well_known_type );
+        isom_iprint_note( printer, "%s", well_known_type_name );
+        isom_iprint_uint( printer, indent, "locale_indicator", data->the_locale );
         if( data->value_length == 0 )
         {
-            lsmash_ifprintf( fp, indent, "value = (null)\n" );
+            isom_ifprintf_none( printer, indent, "value", NULL, "(null)" );
             return 0;
         }
         if( well_known_type == 1 )
@@ -1951,11 +2677,11 @@ static int isom_print_data( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
                 return LSMASH_ERR_MEMORY_ALLOC;
             memcpy( str, data->value, data->value_length );
             str[data->value_length] = 0;
-            lsmash_ifprintf( fp, indent, "value = %s\n", str );
+            isom_iprint_string( printer, indent, "value", str );
             lsmash_free( str );
         }
         else if( well_known_type == 13 || well_known_type == 14 || well_known_type == 27 )
-            lsmash_ifprintf( fp, indent, "value = (binary data)\n" );
+            isom_ifprintf_binary( printer, indent, "value", data->value, data->value_length, "(binary data)" );
         else if( well_known_type == 21 && data->value_length <= 4 )
             /* a big-endian signed integer in 1,2,3 or 4 bytes */
             goto show_in_signed_integer;
@@ -1965,19 +2691,19 @@ static int isom_print_data( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
             uint32_t integer = data->value[0];
             for( uint32_t i = 1; i < data->value_length; i++ )
                 integer = (integer << 8) | data->value[i];
-            lsmash_ifprintf( fp, indent, "value = %"PRIu32"\n", integer );
+            isom_iprint_uint( printer, indent, "value", integer );
         }
         else if( well_known_type == 23 && data->value_length == 4 )
         {
             /* a big-endian 32-bit floating point value (IEEE754) */
             uint32_t float32 = LSMASH_GET_BE32( data->value );
-            lsmash_ifprintf( fp, indent, "value = %f\n", lsmash_int2float32( float32 ) );
+            isom_iprint_float( printer, indent, "value", lsmash_int2float32( float32 ) );
         }
         else if( well_known_type == 24 && data->value_length == 8 )
         {
             /* a big-endian 64-bit floating point value (IEEE754) */
             uint64_t float64 = LSMASH_GET_BE64( data->value );
-            lsmash_ifprintf( fp, indent, "value = %lf\n", lsmash_int2float64( float64 ) );
+            isom_iprint_float( printer, indent, "value", lsmash_int2float64( float64 ) );
         }
         else
             goto show_in_binary;
@@ -2020,35 +2746,31 @@ static int isom_print_data( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
                 basic_data_type_name = basic_data_type_table[table_index].name;
                 break;
             }
-        lsmash_ifprintf( fp, indent, "reserved = %"PRIu16"\n", data->reserved );
-        lsmash_ifprintf( fp, indent, "type_set_identifier = %"PRIu8"%s\n",
-                         data->type_set_identifier,
-                         data->type_set_identifier ? "" : " (basic type set)" );
-        lsmash_ifprintf( fp, indent, "type_code = %"PRIu8" (%s)\n", data->type_code, basic_data_type_name );
-        lsmash_ifprintf( fp, indent, "the_locale = %"PRIu32"\n", data->the_locale );
+        isom_iprint_uint( printer, indent, "reserved", data->reserved );
+        isom_iprint_uint( printer, indent, "type_set_identifier", data->type_set_identifier );
+        if( !data->type_set_identifier )
+            isom_iprint_note( printer, "basic type set" );
+        isom_iprint_uint( printer, indent, "type_code", data->type_code );
+        isom_iprint_note( printer, "%s", basic_data_type_name );
+        isom_iprint_uint( printer, indent, "the_locale", data->the_locale );
         if( data->value_length == 0 )
         {
-            lsmash_ifprintf( fp, indent, "value = (null)\n" );
+            isom_ifprintf_none( printer, indent, "value", NULL, "(null)" );
             return 0;
         }
         if( data->type_code == 6  || data->type_code == 7
          || data->type_code == 12 || data->type_code == 13
          || data->type_code == 14 || data->type_code == 27 )
-            lsmash_ifprintf( fp, indent, "value = (binary data)\n" );
+            isom_ifprintf_binary( printer, indent, "value", data->value, data->value_length, "(binary data)" );
         else if( data->type_code == 8 && data->value_length == 16 )
             /* UUID */
-            lsmash_ifprintf( fp, indent, "value = 0x%08"PRIx32"-%04"PRIx16"-%04"PRIx16"-%04"PRIx16"-%04"PRIx16"0x%08"PRIx32"\n",
-                             LSMASH_GET_BE32( &data->value[ 0] ),
-                             LSMASH_GET_BE16( &data->value[ 4] ),
-                             LSMASH_GET_BE16( &data->value[ 6] ),
-                             LSMASH_GET_BE16( &data->value[ 8] ),
-                             LSMASH_GET_BE16( &data->value[10] ),
-                             LSMASH_GET_BE32( &data->value[12] ) );
+            isom_ifprintf_uuid( printer, indent, "value", LSMASH_GET_BE32( data->value ), &data->value[4] );
         else if( data->type_code == 16 && data->value_length == 4 )
         {
             /* duration in milliseconds */
             uint32_t duration = LSMASH_GET_BE32( data->value );
-            lsmash_ifprintf( fp, indent, "value = %"PRIu32" milliseconds\n", duration );
+            isom_iprint_uint( printer, indent, "value", duration );
+            isom_iprint_unit( printer, "milliseconds" );
         }
         else if( data->type_code == 17 && (data->value_length == 4 || data->value_length == 8) )
         {
@@ -2056,7 +2778,7 @@ static int isom_print_data( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
             uint64_t mp4time = data->value_length == 8
                              ? LSMASH_GET_BE64( data->value )
                              : LSMASH_GET_BE32( data->value );
-            isom_mp4time2utc( mp4time );
+            isom_ifprintf_time( printer, indent, "value", mp4time );
         }
         else if( data->type_code == 21 && data->value_length <= 8 )
             /* a big-endian signed integer in 1,2,3,4 or 8 bytes */
@@ -2064,14 +2786,13 @@ static int isom_print_data( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
         else if( data->type_code == 24 )
         {
             /* RIAA-PA (RIAA Parental advisory) 8-bit integer */
-            lsmash_ifprintf( fp, indent, "value = %"PRIu8, data->value[0] );
+            isom_iprint_uint( printer, indent, "value", data->value[0] );
             if( data->value[0] == (uint8_t)-1 )
-                fprintf( fp, " (no)" );
+                isom_iprint_note( printer, "no" );
             else if( data->value[0] == 1 )
-                fprintf( fp, " (yes)" );
+                isom_iprint_note( printer, "yes" );
             else if( data->value[0] == 0 )
-                fprintf( fp, " (unspecified)" );
-            fprintf( fp, "\n" );
+                isom_iprint_note( printer, "unspecified" );
         }
         else if( data->type_code == 1  || data->type_code == 2  || data->type_code == 3
               || data->type_code == 9  || data->type_code == 10 || data->type_code == 15
@@ -2083,7 +2804,7 @@ static int isom_print_data( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
                 return LSMASH_ERR_MEMORY_ALLOC;
             memcpy( str, data->value, data->value_length );
             str[data->value_length] = 0;
-            lsmash_ifprintf( fp, indent, "value = %s\n", str );
+            isom_iprint_string( printer, indent, "value", str );
             lsmash_free( str );
         }
         else
@@ -2098,73 +2819,65 @@ show_in_signed_integer:;
         integer   = (integer   << 8) | data->value[i];
         max_value = (max_value << 8) | 0xff;
     }
-    lsmash_ifprintf( fp, indent, "value = %"PRId64"\n", (int64_t)(integer | (integer > (max_value >> 1) ? ~max_value : 0)) );
+    isom_iprint_int( printer, indent, "value", (int64_t)(integer | (integer > (max_value >> 1) ? ~max_value : 0)) );
     return 0;
 show_in_binary:
-    lsmash_ifprintf( fp, indent, "value = " );
-    if( data->value_length )
-    {
-        fprintf( fp, "0x" );
-        for( uint32_t i = 0; i < data->value_length; i++ )
-            fprintf( fp, "%02"PRIx8, data->value[i] );
-    }
-    fprintf( fp, "\n" );
+    isom_ifprintf_binary( printer, indent, "value", data->value, data->value_length, NULL );
     return 0;
 }
 
-static int isom_print_WLOC( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_WLOC( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_WLOC_t *WLOC = (isom_WLOC_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Window Location Box" );
-    lsmash_ifprintf( fp, indent, "x = %"PRIu16"\n", WLOC->x );
-    lsmash_ifprintf( fp, indent, "y = %"PRIu16"\n", WLOC->y );
+    isom_print_box_common( printer, indent++, box, "Window Location Box" );
+    isom_iprint_uint( printer, indent, "x", WLOC->x );
+    isom_iprint_uint( printer, indent, "y", WLOC->y );
     return 0;
 }
 
-static int isom_print_LOOP( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_LOOP( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_LOOP_t *LOOP = (isom_LOOP_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Looping Box" );
-    lsmash_ifprintf( fp, indent, "looping_mode = %"PRIu32, LOOP->looping_mode );
+    isom_print_box_common( printer, indent++, box, "Looping Box" );
+    isom_iprint_uint( printer, indent, "looping_mode", LOOP->looping_mode );
     switch( LOOP->looping_mode )
     {
         case 0 :
-            fprintf( fp, " (none)\n" );
+            isom_iprint_note( printer, "none" );
             break;
         case 1 :
-            fprintf( fp, " (looping)\n" );
+            isom_iprint_note( printer, "looping" );
             break;
         case 2 :
-            fprintf( fp, " (palindromic looping)\n" );
+            isom_iprint_note( printer, "palindromic looping" );
             break;
         default :
-            fprintf( fp, "\n" );
             break;
     }
     return 0;
 }
 
-static int isom_print_SelO( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_SelO( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_SelO_t *SelO = (isom_SelO_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Play Selection Only Box" );
-    lsmash_ifprintf( fp, indent, "selection_only = %"PRIu8"\n", SelO->selection_only );
+    isom_print_box_common( printer, indent++, box, "Play Selection Only Box" );
+    isom_iprint_uint( printer, indent, "selection_only", SelO->selection_only );
     return 0;
 }
 
-static int isom_print_AllF( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_AllF( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_AllF_t *AllF = (isom_AllF_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Play All Frames Box" );
-    lsmash_ifprintf( fp, indent, "play_all_frames = %"PRIu8"\n", AllF->play_all_frames );
+    isom_print_box_common( printer, indent++, box, "Play All Frames Box" );
+    isom_iprint_uint( printer, indent, "play_all_frames", AllF->play_all_frames );
     return 0;
 }
 
-static int isom_print_cprt( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_cprt( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_cprt_t *cprt = (isom_cprt_t *)box;
     int indent = level;
@@ -2173,135 +2886,133 @@ static int isom_print_cprt( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
         return LSMASH_ERR_MEMORY_ALLOC;
     memcpy( str, cprt->notice, cprt->notice_length );
     str[cprt->notice_length] = 0;
-    isom_print_box_common( fp, indent++, box, "Copyright Box" );
-    lsmash_ifprintf( fp, indent, "language = %s\n", isom_unpack_iso_language( cprt->language ) );
-    lsmash_ifprintf( fp, indent, "notice = %s\n", str );
+    isom_print_box_common( printer, indent++, box, "Copyright Box" );
+    isom_iprint_string( printer, indent, "language", isom_unpack_iso_language( cprt->language ) );
+    isom_iprint_string( printer, indent, "notice", str );
     lsmash_free( str );
     return 0;
 }
 
-static int isom_print_mvex( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_mvex( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Movie Extends Box" );
+    return isom_print_simple( printer, box, level, "Movie Extends Box" );
 }
 
-static int isom_print_mehd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_mehd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_mehd_t *mehd = (isom_mehd_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Movie Extends Header Box" );
+    isom_print_box_common( printer, indent++, box, "Movie Extends Header Box" );
     if( file->moov && file->moov->mvhd )
-        isom_ifprintf_duration( fp, indent, "fragment_duration", mehd->fragment_duration, file->moov->mvhd->timescale );
+        isom_ifprintf_duration( printer, indent, "fragment_duration", mehd->fragment_duration, file->moov->mvhd->timescale );
     else
-        isom_ifprintf_duration( fp, indent, "fragment_duration", mehd->fragment_duration, 0 );
+        isom_ifprintf_duration( printer, indent, "fragment_duration", mehd->fragment_duration, 0 );
     return 0;
 }
 
-static int isom_print_trex( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_trex( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_trex_t *trex = (isom_trex_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Track Extends Box" );
-    lsmash_ifprintf( fp, indent, "track_ID = %"PRIu32"\n", trex->track_ID );
-    lsmash_ifprintf( fp, indent, "default_sample_description_index = %"PRIu32"\n", trex->default_sample_description_index );
-    lsmash_ifprintf( fp, indent, "default_sample_duration = %"PRIu32"\n", trex->default_sample_duration );
-    lsmash_ifprintf( fp, indent, "default_sample_size = %"PRIu32"\n", trex->default_sample_size );
-    isom_ifprintf_sample_flags( fp, indent, "default_sample_flags", &trex->default_sample_flags );
+    isom_print_box_common( printer, indent++, box, "Track Extends Box" );
+    isom_iprint_uint( printer, indent, "track_ID", trex->track_ID );
+    isom_iprint_uint( printer, indent, "default_sample_description_index", trex->default_sample_description_index );
+    isom_iprint_uint( printer, indent, "default_sample_duration", trex->default_sample_duration );
+    isom_iprint_uint( printer, indent, "default_sample_size", trex->default_sample_size );
+    isom_ifprintf_sample_flags( printer, indent, "default_sample_flags", &trex->default_sample_flags );
     return 0;
 }
 
-static int isom_print_moof( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_moof( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Movie Fragment Box" );
+    return isom_print_simple( printer, box, level, "Movie Fragment Box" );
 }
 
-static int isom_print_mfhd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_mfhd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_mfhd_t *mfhd = (isom_mfhd_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Movie Fragment Header Box" );
-    lsmash_ifprintf( fp, indent, "sequence_number = %"PRIu32"\n", mfhd->sequence_number );
+    isom_print_box_common( printer, indent++, box, "Movie Fragment Header Box" );
+    isom_iprint_uint( printer, indent, "sequence_number", mfhd->sequence_number );
     return 0;
 }
 
-static int isom_print_traf( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_traf( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Track Fragment Box" );
+    return isom_print_simple( printer, box, level, "Track Fragment Box" );
 }
 
-static int isom_print_tfhd( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_tfhd( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_tfhd_t *tfhd = (isom_tfhd_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Track Fragment Header Box" );
+    isom_print_box_common( printer, indent++, box, "Track Fragment Header Box" );
     ++indent;
-    if( tfhd->flags & ISOM_TF_FLAGS_BASE_DATA_OFFSET_PRESENT         ) lsmash_ifprintf( fp, indent, "base-data-offset-present\n" );
-    if( tfhd->flags & ISOM_TF_FLAGS_SAMPLE_DESCRIPTION_INDEX_PRESENT ) lsmash_ifprintf( fp, indent, "sample-description-index-present\n" );
-    if( tfhd->flags & ISOM_TF_FLAGS_DEFAULT_SAMPLE_DURATION_PRESENT  ) lsmash_ifprintf( fp, indent, "default-sample-duration-present\n" );
-    if( tfhd->flags & ISOM_TF_FLAGS_DEFAULT_SAMPLE_SIZE_PRESENT      ) lsmash_ifprintf( fp, indent, "default-sample-size-present\n" );
-    if( tfhd->flags & ISOM_TF_FLAGS_DEFAULT_SAMPLE_FLAGS_PRESENT     ) lsmash_ifprintf( fp, indent, "default-sample-flags-present\n" );
-    if( tfhd->flags & ISOM_TF_FLAGS_DEFAULT_BASE_IS_MOOF             ) lsmash_ifprintf( fp, indent, "default-base-is-moof\n" );
-    lsmash_ifprintf( fp, --indent, "track_ID = %"PRIu32"\n", tfhd->track_ID );
+    if( tfhd->flags & ISOM_TF_FLAGS_BASE_DATA_OFFSET_PRESENT         ) isom_iprint_label( printer, indent, "base-data-offset-present" );
+    if( tfhd->flags & ISOM_TF_FLAGS_SAMPLE_DESCRIPTION_INDEX_PRESENT ) isom_iprint_label( printer, indent, "sample-description-index-present" );
+    if( tfhd->flags & ISOM_TF_FLAGS_DEFAULT_SAMPLE_DURATION_PRESENT  ) isom_iprint_label( printer, indent, "default-sample-duration-present" );
+    if( tfhd->flags & ISOM_TF_FLAGS_DEFAULT_SAMPLE_SIZE_PRESENT      ) isom_iprint_label( printer, indent, "default-sample-size-present" );
+    if( tfhd->flags & ISOM_TF_FLAGS_DEFAULT_SAMPLE_FLAGS_PRESENT     ) isom_iprint_label( printer, indent, "default-sample-flags-present" );
+    if( tfhd->flags & ISOM_TF_FLAGS_DEFAULT_BASE_IS_MOOF             ) isom_iprint_label( printer, indent, "default-base-is-moof" );
+    isom_iprint_uint( printer, --indent, "track_ID", tfhd->track_ID );
     if( tfhd->flags & ISOM_TF_FLAGS_BASE_DATA_OFFSET_PRESENT )
-        lsmash_ifprintf( fp, indent, "base_data_offset = %"PRIu64"\n", tfhd->base_data_offset );
+        isom_iprint_uint( printer, indent, "base_data_offset", tfhd->base_data_offset );
     if( tfhd->flags & ISOM_TF_FLAGS_SAMPLE_DESCRIPTION_INDEX_PRESENT )
-        lsmash_ifprintf( fp, indent, "sample_description_index = %"PRIu32"\n", tfhd->sample_description_index );
+        isom_iprint_uint( printer, indent, "sample_description_index", tfhd->sample_description_index );
     if( tfhd->flags & ISOM_TF_FLAGS_DEFAULT_SAMPLE_DURATION_PRESENT )
-        lsmash_ifprintf( fp, indent, "default_sample_duration = %"PRIu32"\n", tfhd->default_sample_duration );
+        isom_iprint_uint( printer, indent, "default_sample_duration", tfhd->default_sample_duration );
     if( tfhd->flags & ISOM_TF_FLAGS_DEFAULT_SAMPLE_SIZE_PRESENT )
-        lsmash_ifprintf( fp, indent, "default_sample_size = %"PRIu32"\n", tfhd->default_sample_size );
+        isom_iprint_uint( printer, indent, "default_sample_size", tfhd->default_sample_size );
     if( tfhd->flags & ISOM_TF_FLAGS_DEFAULT_SAMPLE_FLAGS_PRESENT )
-        isom_ifprintf_sample_flags( fp, indent, "default_sample_flags", &tfhd->default_sample_flags );
+        isom_ifprintf_sample_flags( printer, indent, "default_sample_flags", &tfhd->default_sample_flags );
     return 0;
 }
 
-static int isom_print_tfdt( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_tfdt( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_tfdt_t *tfdt = (isom_tfdt_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Track Fragment Base Media Decode Time Box" );
-    lsmash_ifprintf( fp, indent, "baseMediaDecodeTime = %"PRIu64"\n", tfdt->baseMediaDecodeTime );
+    isom_print_box_common( printer, indent++, box, "Track Fragment Base Media Decode Time Box" );
+    isom_iprint_uint( printer, indent, "baseMediaDecodeTime", tfdt->baseMediaDecodeTime );
     return 0;
 }
 
-static int isom_print_trun( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_trun( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_trun_t *trun = (isom_trun_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Track Fragment Run Box" );
+    isom_print_box_common( printer, indent++, box, "Track Fragment Run Box" );
     ++indent;
-    if( trun->flags & ISOM_TR_FLAGS_DATA_OFFSET_PRESENT                    ) lsmash_ifprintf( fp, indent, "data-offset-present\n" );
-    if( trun->flags & ISOM_TR_FLAGS_FIRST_SAMPLE_FLAGS_PRESENT             ) lsmash_ifprintf( fp, indent, "first-sample-flags-present\n" );
-    if( trun->flags & ISOM_TR_FLAGS_SAMPLE_DURATION_PRESENT                ) lsmash_ifprintf( fp, indent, "sample-duration-present\n" );
-    if( trun->flags & ISOM_TR_FLAGS_SAMPLE_SIZE_PRESENT                    ) lsmash_ifprintf( fp, indent, "sample-size-present\n" );
-    if( trun->flags & ISOM_TR_FLAGS_SAMPLE_FLAGS_PRESENT                   ) lsmash_ifprintf( fp, indent, "sample-flags-present\n" );
-    if( trun->flags & ISOM_TR_FLAGS_SAMPLE_COMPOSITION_TIME_OFFSET_PRESENT ) lsmash_ifprintf( fp, indent, "sample-composition-time-offsets-present\n" );
-    lsmash_ifprintf( fp, --indent, "sample_count = %"PRIu32"\n", trun->sample_count );
+    if( trun->flags & ISOM_TR_FLAGS_DATA_OFFSET_PRESENT                    ) isom_iprint_label( printer, indent, "data-offset-present" );
+    if( trun->flags & ISOM_TR_FLAGS_FIRST_SAMPLE_FLAGS_PRESENT             ) isom_iprint_label( printer, indent, "first-sample-flags-present" );
+    if( trun->flags & ISOM_TR_FLAGS_SAMPLE_DURATION_PRESENT                ) isom_iprint_label( printer, indent, "sample-duration-present" );
+    if( trun->flags & ISOM_TR_FLAGS_SAMPLE_SIZE_PRESENT                    ) isom_iprint_label( printer, indent, "sample-size-present" );
+    if( trun->flags & ISOM_TR_FLAGS_SAMPLE_FLAGS_PRESENT                   ) isom_iprint_label( printer, indent, "sample-flags-present" );
+    if( trun->flags & ISOM_TR_FLAGS_SAMPLE_COMPOSITION_TIME_OFFSET_PRESENT ) isom_iprint_label( printer, indent, "sample-composition-time-offsets-present" );
+    isom_iprint_uint( printer, --indent, "sample_count", trun->sample_count );
     if( trun->flags & ISOM_TR_FLAGS_DATA_OFFSET_PRESENT )
-        lsmash_ifprintf( fp, indent, "data_offset = %"PRId32"\n", trun->data_offset );
+        isom_iprint_int( printer, indent, "data_offset", trun->data_offset );
     if( trun->flags & ISOM_TR_FLAGS_FIRST_SAMPLE_FLAGS_PRESENT )
-        isom_ifprintf_sample_flags( fp, indent, "first_sample_flags", &trun->first_sample_flags );
+        isom_ifprintf_sample_flags( printer, indent, "first_sample_flags", &trun->first_sample_flags );
     if( trun->optional )
     {
         uint32_t i = 0;
         for( lsmash_entry_t *entry = trun->optional->head; entry; entry = entry->next )
         {
             isom_trun_optional_row_t *row = (isom_trun_optional_row_t *)entry->data;
-            lsmash_ifprintf( fp, indent++, "sample[%"PRIu32"]\n", i++ );
+            isom_iprint_element( printer, indent++, "sample", i++ );
             if( trun->flags & ISOM_TR_FLAGS_SAMPLE_DURATION_PRESENT )
-                lsmash_ifprintf( fp, indent, "sample_duration = %"PRIu32"\n", row->sample_duration );
+                isom_iprint_uint( printer, indent, "sample_duration", row->sample_duration );
             if( trun->flags & ISOM_TR_FLAGS_SAMPLE_SIZE_PRESENT )
-                lsmash_ifprintf( fp, indent, "sample_size = %"PRIu32"\n", row->sample_size );
+                isom_iprint_uint( printer, indent, "sample_size", row->sample_size );
             if( trun->flags & ISOM_TR_FLAGS_SAMPLE_FLAGS_PRESENT )
-                isom_ifprintf_sample_flags( fp, indent, "sample_flags", &row->sample_flags );
+                isom_ifprintf_sample_flags( printer, indent, "sample_flags", &row->sample_flags );
             if( trun->flags & ISOM_TR_FLAGS_SAMPLE_COMPOSITION_TIME_OFFSET_PRESENT )
             {
                 if( trun->version == 0 )
-                    lsmash_ifprintf( fp, indent, "sample_composition_time_offset = %"PRIu32"\n",
-                                     row->sample_composition_time_offset );
+                    isom_iprint_uint( printer, indent, "sample_composition_time_offset", row->sample_composition_time_offset );
                 else
-                    lsmash_ifprintf( fp, indent, "sample_composition_time_offset = %"PRId32"\n",
-                                     (union {uint32_t ui; int32_t si;}){ row->sample_composition_time_offset }.si );
+                    isom_iprint_int( printer, indent, "sample_composition_time_offset", (union {uint32_t ui; int32_t si;}){ row->sample_composition_time_offset }.si );
             }
             --indent;
         }
@@ -2309,56 +3020,56 @@ static int isom_print_trun( FILE *fp, lsmash_file_t *file, isom_box_t *box, int
     return 0;
 }
 
-static int isom_print_free( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_free( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Free Space Box" );
+    return isom_print_simple( printer, box, level, "Free Space Box" );
 }
 
-static int isom_print_mdat( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_mdat( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Media Data Box" );
+    return isom_print_simple( printer, box, level, "Media Data Box" );
 }
 
-static int isom_print_mfra( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_mfra( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
-    return isom_print_simple( fp, box, level, "Movie Fragment Random Access Box" );
+    return isom_print_simple( printer, box, level, "Movie Fragment Random Access Box" );
 }
 
-static int isom_print_tfra( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_tfra( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_tfra_t *tfra = (isom_tfra_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Track Fragment Random Access Box" );
-    lsmash_ifprintf( fp, indent, "track_ID = %"PRIu32"\n", tfra->track_ID );
-    lsmash_ifprintf( fp, indent, "reserved = 0x%08"PRIx32"\n", tfra->reserved );
-    lsmash_ifprintf( fp, indent, "length_size_of_traf_num = %"PRIu8"\n", tfra->length_size_of_traf_num );
-    lsmash_ifprintf( fp, indent, "length_size_of_trun_num = %"PRIu8"\n", tfra->length_size_of_trun_num );
-    lsmash_ifprintf( fp, indent, "length_size_of_sample_num = %"PRIu8"\n", tfra->length_size_of_sample_num );
-    lsmash_ifprintf( fp, indent, "number_of_entry = %"PRIu32"\n", tfra->number_of_entry );
+    isom_print_box_common( printer, indent++, box, "Track Fragment Random Access Box" );
+    isom_iprint_uint( printer, indent, "track_ID", tfra->track_ID );
+    isom_iprint_hex( printer, indent, "reserved", tfra->reserved, 8 );
+    isom_iprint_uint( printer, indent, "length_size_of_traf_num", tfra->length_size_of_traf_num );
+    isom_iprint_uint( printer, indent, "length_size_of_trun_num", tfra->length_size_of_trun_num );
+    isom_iprint_uint( printer, indent, "length_size_of_sample_num", tfra->length_size_of_sample_num );
+    isom_iprint_uint( printer, indent, "number_of_entry", tfra->number_of_entry );
     if( tfra->list )
     {
         uint32_t i = 0;
         for( lsmash_entry_t *entry = tfra->list->head; entry; entry = entry->next )
         {
             isom_tfra_location_time_entry_t *data = (isom_tfra_location_time_entry_t *)entry->data;
-            lsmash_ifprintf( fp, indent++, "entry[%"PRIu32"]\n", i++ );
-            lsmash_ifprintf( fp, indent, "time = %"PRIu64"\n", data->time );
-            lsmash_ifprintf( fp, indent, "moof_offset = %"PRIu64"\n", data->moof_offset );
-            lsmash_ifprintf( fp, indent, "traf_number = %"PRIu32"\n", data->traf_number );
-            lsmash_ifprintf( fp, indent, "trun_number = %"PRIu32"\n", data->trun_number );
-            lsmash_ifprintf( fp, indent, "sample_number = %"PRIu32"\n", data->sample_number );
+            isom_iprint_element( printer, indent++, "entry", i++ );
+            isom_iprint_uint( printer, indent, "time", data->time );
+            isom_iprint_uint( printer, indent, "moof_offset", data->moof_offset );
+            isom_iprint_uint( printer, indent, "traf_number", data->traf_number );
+            isom_iprint_uint( printer, indent, "trun_number", data->trun_number );
+            isom_iprint_uint( printer, indent, "sample_number", data->sample_number );
             --indent;
         }
     }
     return 0;
 }
 
-static int isom_print_mfro( FILE *fp, lsmash_file_t *file, isom_box_t *box, int level )
+static int isom_print_mfro( isom_printer_t *printer, lsmash_file_t *file, isom_box_t *box, int level )
 {
     isom_mfro_t *mfro = (isom_mfro_t *)box;
     int indent = level;
-    isom_print_box_common( fp, indent++, box, "Movie Fragment Random Access Offset Box" );
-    lsmash_ifprintf( fp, indent, "size = %"PRIu32"\n", mfro->length );
+    isom_print_box_common( printer, indent++, box, "Movie Fragment Random Access Offset Box" );
+    isom_iprint_uint( printer, indent, "size", mfro->length );
     return 0;
 }
 
@@ -2378,25 +3089,212 @@ int lsmash_print_movie( lsmash_root_t *root, const char *filename )
         if( !destination )
             return LSMASH_ERR_NAMELESS;
     }
-    fprintf( destination, "[File]\n" );
-    fprintf( destination, "    size = %"PRIu64"\n", file->size );
-    for( lsmash_entry_t *entry = file->print->head; entry; entry = entry->next )
+    isom_printer_t *printer = isom_printer_create( destination, LSMASH_PRINT_FORMAT_TEXT );
+    if( !printer )
+    {
+        fclose( destination );
+        return LSMASH_ERR_MEMORY_ALLOC;
+    }
+    isom_iprint_box( printer, 0, NULL, "File" );
+    isom_iprint_uint( printer, 1, "size", file->size );
+    int ret = 0;
+    for( lsmash_entry_t *entry = file->print->head; entry && ret == 0; entry = entry->next )
     {
         isom_print_entry_t *data = (isom_print_entry_t *)entry->data;
         if( !data || !data->box )
-        {
-            fclose( destination );
+            ret = LSMASH_ERR_NAMELESS;
+        else
+            ret = data->func( printer, file, data->box, data->level );
+    }
+    int err = isom_printer_destroy( printer );
+    fclose( destination );
+    return ret < 0 ? ret : err;
+}
+
+int lsmash_print_movie_streaming( lsmash_root_t *root, const char *filename, lsmash_print_format format )
+{
+    if( LSMASH_IS_NON_EXISTING_BOX( root ) )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    lsmash_file_t *file = root->file;
+    if( LSMASH_IS_NON_EXISTING_BOX( file )
+     || !file->bs
+     || !(file->flags & LSMASH_FILE_MODE_DUMP)
+     || file->print
+     || file->extensions.head
+     || format < LSMASH_PRINT_FORMAT_TEXT
+     || format > LSMASH_PRINT_FORMAT_CBOR )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    FILE *destination;
+    if( !strcmp( filename, "-" ) )
+        destination = stdout;
+    else
+    {
+        destination = lsmash_fopen( filename, "wb" );
+        if( !destination )
             return LSMASH_ERR_NAMELESS;
+    }
+    isom_printer_t *printer = isom_printer_create( destination, format );
+    if( !printer )
+    {
+        fclose( destination );
+        return LSMASH_ERR_MEMORY_ALLOC;
+    }
+    /* Boxes are released one by one while reading, so don't allocate them from the arena
+     * which releases nothing until the file is closed. */
+    if( file->arena )
+    {
+        lsmash_arena_destroy( file->arena );
+        file->arena = NULL;
+        file->extensions.arena = NULL;
+    }
+    isom_iprint_box( printer, 0, NULL, "File" );
+    int ret = 0;
+    lsmash_bs_t *bs = file->bs;
+    if( !bs->unseekable )
+    {
+        int64_t file_size = bs->seek( bs->stream, 0, SEEK_END );
+        if( file_size < 0 || bs->seek( bs->stream, 0, SEEK_SET ) != 0 )
+            ret = LSMASH_ERR_NAMELESS;
+        else
+            isom_iprint_uint( printer, 1, "size", file_size );
+    }
+    if( ret == 0 )
+        ret = isom_printer_flush( printer );
+    if( ret == 0 )
+    {
+        file->printer = printer;
+        isom_check_compatibility( file );
+        ret = isom_read_file( file );
+        file->printer = NULL;
+    }
+    int err = isom_printer_destroy( printer );
+    fclose( destination );
+    return ret < 0 ? ret : err;
+}
+
+/* the number of the samples whose information is got at a time */
+#define ISOM_PRINT_SAMPLE_INFO_BATCH 256
+
+static int isom_print_media_timestamps_in_text( FILE *fp, lsmash_root_t *root, uint32_t track_ID, uint32_t timescale )
+{
+    fprintf( fp, "track_ID: %"PRIu32"\n", track_ID );
+    fprintf( fp, "Media timescale: %"PRIu32"\n", timescale );
+    uint32_t ctd_shift;
+    int ret = lsmash_get_composition_to_decode_shift_from_media_timeline( root, track_ID, &ctd_shift );
+    if( ret < 0 )
+        return ret;
+    uint64_t dts[ISOM_PRINT_SAMPLE_INFO_BATCH];
+    uint64_t cts[ISOM_PRINT_SAMPLE_INFO_BATCH];
+    lsmash_sample_info_columns_t columns = { .dts = dts, .cts = cts };
+    for( uint32_t i = 1; (ret = lsmash_get_sample_info_range_from_media_timeline( root, track_ID, i, ISOM_PRINT_SAMPLE_INFO_BATCH, &columns )) > 0; i += ret )
+        for( int j = 0; j < ret; j++ )
+            fprintf( fp, "DTS = %"PRIu64", CTS = %"PRIu64"\n", dts[j], cts[j] + ctd_shift );
+    if( ret < 0 )
+        return ret;
+    fprintf( fp, "\n" );
+    return 0;
+}
+
+/* Put the samples of a track column by column, which is why the timeline is scanned once per column. */
+static int isom_print_media_timestamps_in_columns( isom_emitter_t *emitter, lsmash_root_t *root, uint32_t track_ID, uint32_t timescale )
+{
+    static const char *column_name[] = { "dts", "cts", "size", "offset", "flags" };
+    uint32_t ctd_shift;
+    int ret = lsmash_get_composition_to_decode_shift_from_media_timeline( root, track_ID, &ctd_shift );
+    if( ret < 0 )
+        return ret;
+    if( (ret = isom_emit_begin( emitter, 1 )) < 0 )
+        return ret;
+    isom_emit_key ( emitter, "track_ID" );
+    isom_emit_uint( emitter, track_ID );
+    isom_emit_key ( emitter, "timescale" );
+    isom_emit_uint( emitter, timescale );
+    uint64_t                 value [ISOM_PRINT_SAMPLE_INFO_BATCH];
+    uint32_t                 length[ISOM_PRINT_SAMPLE_INFO_BATCH];
+    lsmash_sample_property_t prop  [ISOM_PRINT_SAMPLE_INFO_BATCH];
+    for( int column = 0; column < 5; column++ )
+    {
+        isom_emit_key( emitter, column_name[column] );
+        if( (ret = isom_emit_begin( emitter, 0 )) < 0 )
+            return ret;
+        lsmash_sample_info_columns_t columns = { NULL };
+        switch( column )
+        {
+            case 0  : columns.dts    = value;  break;
+            case 1  : columns.cts    = value;  break;
+            case 2  : columns.length = length; break;
+            case 3  : columns.pos    = value;  break;
+            default : columns.prop   = prop;   break;
         }
-        int ret = data->func( destination, file, data->box, data->level );
+        for( uint32_t i = 1; (ret = lsmash_get_sample_info_range_from_media_timeline( root, track_ID, i, ISOM_PRINT_SAMPLE_INFO_BATCH, &columns )) > 0; i += ret )
+            for( int j = 0; j < ret; j++ )
+                isom_emit_uint( emitter, column == 1 ? value[j] + ctd_shift
+                                       : column == 2 ? length[j]
+                                       : column == 4 ? prop[j].ra_flags
+                                       :               value[j] );
         if( ret < 0 )
-        {
-            fclose( destination );
             return ret;
+        isom_emit_end( emitter );
+    }
+    isom_emit_end( emitter );
+    return 0;
+}
+
+int lsmash_print_media_timestamps( lsmash_root_t *root, const char *filename, lsmash_print_format format )
+{
+    if( LSMASH_IS_NON_EXISTING_BOX( root )
+     || LSMASH_IS_NON_EXISTING_BOX( root->file )
+     || format < LSMASH_PRINT_FORMAT_TEXT
+     || format > LSMASH_PRINT_FORMAT_CBOR )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    lsmash_movie_parameters_t movie_param;
+    lsmash_initialize_movie_parameters( &movie_param );
+    int ret = lsmash_get_movie_parameters( root, &movie_param );
+    if( ret < 0 )
+        return ret;
+    FILE *destination;
+    if( !strcmp( filename, "-" ) )
+        destination = stdout;
+    else
+    {
+        destination = lsmash_fopen( filename, "wb" );
+        if( !destination )
+            return LSMASH_ERR_NAMELESS;
+    }
+    isom_emitter_t emitter;
+    isom_emitter_init( &emitter, destination, format );
+    if( format != LSMASH_PRINT_FORMAT_TEXT )
+        isom_emit_begin( &emitter, 0 );
+    for( uint32_t track_number = 1; track_number <= movie_param.number_of_tracks; track_number++ )
+    {
+        uint32_t track_ID = lsmash_get_track_ID( root, track_number );
+        if( track_ID == 0 )
+        {
+            ret = LSMASH_ERR_NAMELESS;
+            break;
         }
+        lsmash_media_parameters_t media_param;
+        lsmash_initialize_media_parameters( &media_param );
+        if( (ret = lsmash_get_media_parameters( root, track_ID, &media_param )) < 0 )
+            break;
+        if( !isom_get_timeline( root, track_ID )
+         && (ret = lsmash_construct_timeline( root, track_ID )) < 0 )
+            break;
+        if( format == LSMASH_PRINT_FORMAT_TEXT )
+            ret = isom_print_media_timestamps_in_text( destination, root, track_ID, media_param.timescale );
+        else
+            ret = isom_print_media_timestamps_in_columns( &emitter, root, track_ID, media_param.timescale );
+        if( ret < 0 )
+            break;
+    }
+    if( ret == 0 && format != LSMASH_PRINT_FORMAT_TEXT )
+    {
+        isom_emit_end( &emitter );
+        if( format == LSMASH_PRINT_FORMAT_JSON )
+            fputc( '\n', destination );
     }
     fclose( destination );
-    return 0;
+    return ret;
 }
 
 static isom_print_box_t isom_select_print_func( isom_box_t *box )
@@ -2586,6 +3484,19 @@ int isom_add_print_func( lsmash_file_t *file, void *box, int level )
         isom_print_remove_plastic_box( box );
         return 0;
     }
+    if( file->printer )
+    {
+        /* Print the box right now. Boxes are read in file order and their ancestors are alive at this point. */
+        isom_print_box_t func = isom_select_print_func( (isom_box_t *)box );
+        assert( func );
+        int ret = func( file->printer, file, (isom_box_t *)box, level );
+        if( ret == 0 )
+            ret = isom_printer_flush( file->printer );
+        if( ret < 0 )
+            return ret;
+        isom_print_remove_plastic_box( box );
+        return 0;
+    }
     isom_print_entry_t *data = lsmash_malloc( sizeof(isom_print_entry_t) );
     if( !data )
     {
@@ -2623,3 +3534,39 @@ lsmash_entry_list_t *isom_printer_create_list( void )
 {
     return lsmash_list_create( isom_remove_print_func );
 }
+
+/* Release the boxes already printed by the streaming dump which no subsequent box refers to.
+ * Top level boxes other than ones a file has at most one of and the first Segment Type Box,
+ * which decides the compatibility, are released as soon as they have been read.
+ * The sample tables are released when their Sample Table Box has been read, except for the Sample Description Box
+ * which sample entries are printed with. */
+void isom_printer_release_boxes( lsmash_file_t *file, isom_box_t *parent )
+{
+    if( !file->printer )
+        return;
+    if( parent == (isom_box_t *)file )
+    {
+        if( !file->extensions.tail )
+            return;
+        isom_box_t *box = (isom_box_t *)file->extensions.tail->data;
+        if( LSMASH_IS_EXISTING_BOX( box )
+         && ((box->manager & LSMASH_UNKNOWN_BOX)
+          || (lsmash_check_box_type_identical( box->type, ISOM_BOX_TYPE_STYP ) && box != file->styp_list.head->data)
+          || lsmash_check_box_type_identical( box->type, ISOM_BOX_TYPE_SIDX )
+          || lsmash_check_box_type_identical( box->type, ISOM_BOX_TYPE_MOOF )) )
+            isom_remove_box_by_itself( box );
+    }
+    else if( lsmash_check_box_type_identical( parent->type, ISOM_BOX_TYPE_STBL ) )
+    {
+        lsmash_entry_t *entry = parent->extensions.head;
+        while( entry )
+        {
+            lsmash_entry_t *next = entry->next;
+            isom_box_t     *box  = (isom_box_t *)entry->data;
+            if( LSMASH_IS_EXISTING_BOX( box )
+             && !lsmash_check_box_type_identical( box->type, ISOM_BOX_TYPE_STSD ) )
+                lsmash_list_remove_entry_direct( &parent->extensions, entry );
+            entry = next;
+        }
+    }
+}
@@ -23,8 +23,33 @@
 #ifndef LSMASH_PRINT_H
 #define LSMASH_PRINT_H
 
+/* The box printers describe the fields of each box by the following functions, and the printer formats them
+ * either into the indented text or into the nodes of the structured formats.
+ * A field printed at a deeper indent than the preceding one belongs to it; e.g. the fields of a box belong to the box.
+ * INDEX, if any, is the position of the field in an array and is printed as 'name[index]' in the text. */
+void isom_iprint_box( isom_printer_t *printer, int indent, const char *type, const char *name );
+/* A descriptor is printed as a box identified by its tag. */
+void isom_iprint_tag( isom_printer_t *printer, int indent, uint8_t tag, const char *name );
+void isom_iprint_label( isom_printer_t *printer, int indent, const char *name );
+void isom_iprint_element( isom_printer_t *printer, int indent, const char *name, uint64_t index );
+void isom_iprint_uint( isom_printer_t *printer, int indent, const char *name, uint64_t value );
+void isom_iprint_int( isom_printer_t *printer, int indent, const char *name, int64_t value );
+void isom_iprint_hex( isom_printer_t *printer, int indent, const char *name, uint64_t value, int digits );
+void isom_iprint_float( isom_printer_t *printer, int indent, const char *name, double value );
+void isom_iprint_string( isom_printer_t *printer, int indent, const char *name, const char *value );
+void isom_iprint_fourcc( isom_printer_t *printer, int indent, const char *name, uint32_t fourcc );
+void isom_iprint_bytes( isom_printer_t *printer, int indent, const char *name, const uint8_t *data, uint32_t size );
+void isom_iprint_uint_at( isom_printer_t *printer, int indent, const char *name, uint64_t index, uint64_t value );
+void isom_iprint_int_at( isom_printer_t *printer, int indent, const char *name, uint64_t index, int64_t value );
+void isom_iprint_float_at( isom_printer_t *printer, int indent, const char *name, uint64_t index, double value );
+void isom_iprint_fourcc_at( isom_printer_t *printer, int indent, const char *name, uint64_t index, uint32_t fourcc );
+/* Annotate the field printed just before with the meaning or the unit of its value. */
+void isom_iprint_note( isom_printer_t *printer, const char *format, ... );
+void isom_iprint_unit( isom_printer_t *printer, const char *unit );
+
 int isom_add_print_func( lsmash_file_t *file, void *box, int level );
 void isom_printer_destory_list( lsmash_file_t *file );
 lsmash_entry_list_t *isom_printer_create_list( void );
+void isom_printer_release_boxes( lsmash_file_t *file, isom_box_t *parent );
 
 #endif /* LSMASH_PRINT_H */
@@ -109,7 +109,7 @@ static void isom_basebox_common_copy( isom_box_t *dst, const isom_box_t *src )
     dst->root    = src->root;
     dst->file    = src->file;
     dst->parent  = src->parent;
-    dst->manager = src->manager;
+    dst->manager = src->manager | (dst->manager & LSMASH_ARENA_BOX);
     dst->pos     = src->pos;
     dst->size    = src->size;
     dst->type    = src->type;
@@ -120,7 +120,7 @@ static void isom_fullbox_common_copy( isom_box_t *dst, const isom_box_t *src )
     dst->root    = src->root;
     dst->file    = src->file;
     dst->parent  = src->parent;
-    dst->manager = src->manager;
+    dst->manager = src->manager | (dst->manager & LSMASH_ARENA_BOX);
     dst->pos     = src->pos;
     dst->size    = src->size;
     dst->type    = src->type;
@@ -143,6 +143,36 @@ static void isom_box_common_copy( void *dst, const void *src )
         isom_basebox_common_copy( (isom_box_t *)dst, (isom_box_t *)src );
 }
 
+static void isom_remove_arena_entry( void *data )
+{
+    /* Entries allocated from an arena are released together with the arena. */
+}
+
+/* Append a new entry to a table read from the file.
+ * If the file has an arena and the table has no entries needing any specific eliminator,
+ * the table is switched to allocate its entries from the arena.
+ * Return the address of the new entry if successful. Return NULL otherwise. */
+static void *isom_add_table_entry( lsmash_file_t *file, lsmash_entry_list_t *list, size_t size )
+{
+    if( file->arena && !list->head
+     && list->eliminator == (lsmash_entry_data_eliminator)lsmash_free )
+    {
+        list->arena      = file->arena;
+        list->eliminator = isom_remove_arena_entry;
+    }
+    int in_arena = (list->eliminator == isom_remove_arena_entry);
+    void *data = in_arena ? lsmash_arena_alloc( list->arena, size ) : lsmash_malloc( size );
+    if( !data )
+        return NULL;
+    if( lsmash_list_add_entry( list, data ) < 0 )
+    {
+        if( !in_arena )
+            lsmash_free( data );
+        return NULL;
+    }
+    return data;
+}
+
 static void isom_skip_box_rest( lsmash_bs_t *bs, isom_box_t *box )
 {
     if( box->manager & LSMASH_LAST_BOX )
@@ -205,10 +235,19 @@ static int isom_read_children( lsmash_file_t *file, isom_box_t *box, void *paren
     uint64_t parent_pos = lsmash_bs_count( bs );
     while( !(ret = isom_read_box( file, box, parent_box, parent_pos, level )) )
     {
+        if( parent_box == (isom_box_t *)file && file->printer )
+        {
+            /* Boxes are printed as soon as read, so the compatibility can't wait for the end of the file.
+             * Top level boxes are released one by one. */
+            isom_check_compatibility( file );
+            isom_printer_release_boxes( file, parent_box );
+        }
         parent_pos += box->size;
         if( parent_box->size <= parent_pos || bs->eob || bs->error )
             break;
     }
+    if( parent_box != (isom_box_t *)file )
+        isom_printer_release_boxes( file, parent_box );
     box->size = parent_pos;    /* for file size */
     return ret;
 }
@@ -226,7 +265,7 @@ static int isom_read_unknown_box( lsmash_file_t *file, isom_box_t *box, isom_box
     uint64_t read_size = box->size - lsmash_bs_count( bs );
     if( box->manager & LSMASH_INCOMPLETE_BOX )
         return LSMASH_ERR_INVALID_DATA;
-    isom_unknown_box_t *unknown = ALLOCATE_BOX( unknown );
+    isom_unknown_box_t *unknown = ALLOCATE_BOX( unknown, isom_get_box_arena( parent ) );
     if( LSMASH_IS_NON_EXISTING_BOX( unknown ) )
         return LSMASH_ERR_MEMORY_ALLOC;
     if( lsmash_list_add_entry( &parent->extensions, unknown ) < 0 )
@@ -249,7 +288,7 @@ static int isom_read_unknown_box( lsmash_file_t *file, isom_box_t *box, isom_box
     if( !(file->flags & LSMASH_FILE_MODE_DUMP) )
         return 0;
     /* Create a dummy for dump. */
-    isom_dummy_t *dummy = ALLOCATE_BOX( dummy );
+    isom_dummy_t *dummy = ALLOCATE_BOX( dummy, NULL );
     if( LSMASH_IS_NON_EXISTING_BOX( dummy ) )
         return LSMASH_ERR_MEMORY_ALLOC;
     box->manager |= LSMASH_ABSENT_IN_FILE | LSMASH_UNKNOWN_BOX;
@@ -346,14 +385,9 @@ static int isom_read_sidx( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
          pos < box->size && sidx->list->entry_count < sidx->reference_count;
          pos = lsmash_bs_count( bs ) )
     {
-        isom_sidx_referenced_item_t *data = lsmash_malloc( sizeof(isom_sidx_referenced_item_t) );
+        isom_sidx_referenced_item_t *data = isom_add_table_entry( file, sidx->list, sizeof(isom_sidx_referenced_item_t) );
         if( !data )
             return LSMASH_ERR_MEMORY_ALLOC;
-        if( lsmash_list_add_entry( sidx->list, data ) < 0 )
-        {
-            lsmash_free( data );
-            return LSMASH_ERR_MEMORY_ALLOC;
-        }
         uint32_t temp32;
         temp32 = lsmash_bs_get_be32( bs );
         data->reference_type = (temp32 >> 31) & 0x00000001;
@@ -587,14 +621,9 @@ static int isom_read_elst( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
     uint32_t entry_count = lsmash_bs_get_be32( bs );
     for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && elst->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
     {
-        isom_elst_entry_t *data = lsmash_malloc( sizeof(isom_elst_entry_t) );
+        isom_elst_entry_t *data = isom_add_table_entry( file, elst->list, sizeof(isom_elst_entry_t) );
         if( !data )
             return LSMASH_ERR_MEMORY_ALLOC;
-        if( lsmash_list_add_entry( elst->list, data ) < 0 )
-        {
-            lsmash_free( data );
-            return LSMASH_ERR_MEMORY_ALLOC;
-        }
         if( box->version == 1 )
         {
             data->segment_duration =          lsmash_bs_get_be64( bs );
@@ -975,18 +1004,18 @@ static void *isom_sample_description_alloc( lsmash_codec_type_t sample_type, iso
     void *sample_desc = NULL;
     lsmash_media_type media_type = ((isom_mdia_t *)stsd->parent->parent->parent)->hdlr->componentSubtype;
     if( media_type == ISOM_MEDIA_HANDLER_TYPE_VIDEO_TRACK )
-        sample_desc = ALLOCATE_BOX( visual_entry );
+        sample_desc = ALLOCATE_BOX( visual_entry, isom_get_box_arena( stsd ) );
     else if( media_type == ISOM_MEDIA_HANDLER_TYPE_AUDIO_TRACK )
-        sample_desc = ALLOCATE_BOX( audio_entry );
+        sample_desc = ALLOCATE_BOX( audio_entry, isom_get_box_arena( stsd ) );
     else if( media_type == ISOM_MEDIA_HANDLER_TYPE_TEXT_TRACK )
     {
         if( lsmash_check_codec_type_identical( sample_type, ISOM_CODEC_TYPE_TX3G_TEXT ) )
-            sample_desc = ALLOCATE_BOX( tx3g_entry );
+            sample_desc = ALLOCATE_BOX( tx3g_entry, isom_get_box_arena( stsd ) );
         else if( lsmash_check_codec_type_identical( sample_type, QT_CODEC_TYPE_TEXT_TEXT ) )
-            sample_desc = ALLOCATE_BOX( qt_text_entry );
+            sample_desc = ALLOCATE_BOX( qt_text_entry, isom_get_box_arena( stsd ) );
     }
     else if( lsmash_check_codec_type_identical( sample_type, ISOM_CODEC_TYPE_MP4S_SYSTEM ) )
-        sample_desc = ALLOCATE_BOX( mp4s_entry );
+        sample_desc = ALLOCATE_BOX( mp4s_entry, isom_get_box_arena( stsd ) );
     if( !sample_desc )
         return NULL;
     ((isom_box_t *)sample_desc)->offset_in_parent = offsetof( isom_stsd_t, list );
@@ -1001,7 +1030,7 @@ static void *isom_add_description( lsmash_codec_type_t sample_type, isom_stsd_t
         return NULL;
     if( lsmash_list_add_entry( &stsd->list, sample_desc ) < 0 )
     {
-        lsmash_free( sample_desc );
+        isom_free_box( sample_desc );
         return NULL;
     }
     if( lsmash_list_add_entry( &stsd->extensions, sample_desc ) < 0 )
@@ -1009,6 +1038,10 @@ static void *isom_add_description( lsmash_codec_type_t sample_type, isom_stsd_t
         lsmash_list_remove_entry_tail( &stsd->list );
         return NULL;
     }
+    /* Set up the writer so that the sample description read from the file can be written back. */
+    ((isom_box_t *)sample_desc)->parent = (isom_box_t *)stsd;
+    ((isom_box_t *)sample_desc)->type   = sample_type;
+    isom_set_box_writer( (isom_box_t *)sample_desc );
     return sample_desc;
 }
 
@@ -1531,14 +1564,9 @@ static int isom_read_stts( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
     uint32_t entry_count = lsmash_bs_get_be32( bs );
     for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && stts->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
     {
-        isom_stts_entry_t *data = lsmash_malloc( sizeof(isom_stts_entry_t) );
+        isom_stts_entry_t *data = isom_add_table_entry( file, stts->list, sizeof(isom_stts_entry_t) );
         if( !data )
             return LSMASH_ERR_MEMORY_ALLOC;
-        if( lsmash_list_add_entry( stts->list, data ) < 0 )
-        {
-            lsmash_free( data );
-            return LSMASH_ERR_MEMORY_ALLOC;
-        }
         data->sample_count = lsmash_bs_get_be32( bs );
         data->sample_delta = lsmash_bs_get_be32( bs );
     }
@@ -1555,14 +1583,9 @@ static int isom_read_ctts( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
     uint32_t entry_count = lsmash_bs_get_be32( bs );
     for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && ctts->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
     {
-        isom_ctts_entry_t *data = lsmash_malloc( sizeof(isom_ctts_entry_t) );
+        isom_ctts_entry_t *data = isom_add_table_entry( file, ctts->list, sizeof(isom_ctts_entry_t) );
         if( !data )
             return LSMASH_ERR_MEMORY_ALLOC;
-        if( lsmash_list_add_entry( ctts->list, data ) < 0 )
-        {
-            lsmash_free( data );
-            return LSMASH_ERR_MEMORY_ALLOC;
-        }
         data->sample_count  = lsmash_bs_get_be32( bs );
         data->sample_offset = lsmash_bs_get_be32( bs );
     }
@@ -1594,14 +1617,9 @@ static int isom_read_stss( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
     uint32_t entry_count = lsmash_bs_get_be32( bs );
     for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && stss->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
     {
-        isom_stss_entry_t *data = lsmash_malloc( sizeof(isom_stss_entry_t) );
+        isom_stss_entry_t *data = isom_add_table_entry( file, stss->list, sizeof(isom_stss_entry_t) );
         if( !data )
             return LSMASH_ERR_MEMORY_ALLOC;
-        if( lsmash_list_add_entry( stss->list, data ) < 0 )
-        {
-            lsmash_free( data );
-            return LSMASH_ERR_MEMORY_ALLOC;
-        }
         data->sample_number = lsmash_bs_get_be32( bs );
     }
     return isom_read_leaf_box_common_last_process( file, box, level, stss );
@@ -1617,14 +1635,9 @@ static int isom_read_stps( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
     uint32_t entry_count = lsmash_bs_get_be32( bs );
     for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && stps->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
     {
-        isom_stps_entry_t *data = lsmash_malloc( sizeof(isom_stps_entry_t) );
+        isom_stps_entry_t *data = isom_add_table_entry( file, stps->list, sizeof(isom_stps_entry_t) );
         if( !data )
             return LSMASH_ERR_MEMORY_ALLOC;
-        if( lsmash_list_add_entry( stps->list, data ) < 0 )
-        {
-            lsmash_free( data );
-            return LSMASH_ERR_MEMORY_ALLOC;
-        }
         data->sample_number = lsmash_bs_get_be32( bs );
     }
     return isom_read_leaf_box_common_last_process( file, box, level, stps );
@@ -1641,14 +1654,9 @@ static int isom_read_sdtp( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
     lsmash_bs_t *bs = file->bs;
     for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size; pos = lsmash_bs_count( bs ) )
     {
-        isom_sdtp_entry_t *data = lsmash_malloc( sizeof(isom_sdtp_entry_t) );
+        isom_sdtp_entry_t *data = isom_add_table_entry( file, sdtp->list, sizeof(isom_sdtp_entry_t) );
         if( !data )
             return LSMASH_ERR_MEMORY_ALLOC;
-        if( lsmash_list_add_entry( sdtp->list, data ) < 0 )
-        {
-            lsmash_free( data );
-            return LSMASH_ERR_MEMORY_ALLOC;
-        }
         uint8_t temp = lsmash_bs_get_byte( bs );
         data->is_leading            = (temp >> 6) & 0x3;
         data->sample_depends_on     = (temp >> 4) & 0x3;
@@ -1668,14 +1676,9 @@ static int isom_read_stsc( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
     uint32_t entry_count = lsmash_bs_get_be32( bs );
     for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && stsc->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
     {
-        isom_stsc_entry_t *data = lsmash_malloc( sizeof(isom_stsc_entry_t) );
+        isom_stsc_entry_t *data = isom_add_table_entry( file, stsc->list, sizeof(isom_stsc_entry_t) );
         if( !data )
             return LSMASH_ERR_MEMORY_ALLOC;
-        if( lsmash_list_add_entry( stsc->list, data ) < 0 )
-        {
-            lsmash_free( data );
-            return LSMASH_ERR_MEMORY_ALLOC;
-        }
         data->first_chunk              = lsmash_bs_get_be32( bs );
         data->samples_per_chunk        = lsmash_bs_get_be32( bs );
         data->sample_description_index = lsmash_bs_get_be32( bs );
@@ -1700,14 +1703,9 @@ static int isom_read_stsz( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
             return LSMASH_ERR_MEMORY_ALLOC;
         for( ; pos < box->size && stsz->list->entry_count < stsz->sample_count; pos = lsmash_bs_count( bs ) )
         {
-            isom_stsz_entry_t *data = lsmash_malloc( sizeof(isom_stsz_entry_t) );
+            isom_stsz_entry_t *data = isom_add_table_entry( file, stsz->list, sizeof(isom_stsz_entry_t) );
             if( !data )
                 return LSMASH_ERR_MEMORY_ALLOC;
-            if( lsmash_list_add_entry( stsz->list, data ) < 0 )
-            {
-                lsmash_free( data );
-                return LSMASH_ERR_MEMORY_ALLOC;
-            }
             data->entry_size = lsmash_bs_get_be32( bs );
         }
     }
@@ -1738,14 +1736,9 @@ static int isom_read_stz2( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
             uint64_t (*bs_get_entry_size)( lsmash_bs_t * ) = bs_get_funcs[ stz2->field_size == 16 ? 1 : 0 ];
             for( ; pos < box->size && stz2->list->entry_count < stz2->sample_count; pos = lsmash_bs_count( bs ) )
             {
-                isom_stsz_entry_t *data = lsmash_malloc( sizeof(isom_stsz_entry_t) );
+                isom_stsz_entry_t *data = isom_add_table_entry( file, stz2->list, sizeof(isom_stsz_entry_t) );
                 if( !data )
                     return LSMASH_ERR_MEMORY_ALLOC;
-                if( lsmash_list_add_entry( stz2->list, data ) < 0 )
-                {
-                    lsmash_free( data );
-                    return LSMASH_ERR_MEMORY_ALLOC;
-                }
                 data->entry_size = bs_get_entry_size( bs );
             }
         }
@@ -1755,14 +1748,9 @@ static int isom_read_stz2( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
             uint8_t temp8;
             while( pos < box->size && stz2->list->entry_count < stz2->sample_count )
             {
-                isom_stsz_entry_t *data = lsmash_malloc( sizeof(isom_stsz_entry_t) );
+                isom_stsz_entry_t *data = isom_add_table_entry( file, stz2->list, sizeof(isom_stsz_entry_t) );
                 if( !data )
                     return LSMASH_ERR_MEMORY_ALLOC;
-                if( lsmash_list_add_entry( stz2->list, data ) < 0 )
-                {
-                    lsmash_free( data );
-                    return LSMASH_ERR_MEMORY_ALLOC;
-                }
                 /* Read a byte by two entries. */
                 if( parity )
                 {
@@ -1800,28 +1788,18 @@ static int isom_read_stco( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
     if( is_stco )
         for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && stco->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
         {
-            isom_stco_entry_t *data = lsmash_malloc( sizeof(isom_stco_entry_t) );
+            isom_stco_entry_t *data = isom_add_table_entry( file, stco->list, sizeof(isom_stco_entry_t) );
             if( !data )
                 return LSMASH_ERR_MEMORY_ALLOC;
-            if( lsmash_list_add_entry( stco->list, data ) < 0 )
-            {
-                lsmash_free( data );
-                return LSMASH_ERR_MEMORY_ALLOC;
-            }
             data->chunk_offset = lsmash_bs_get_be32( bs );
         }
     else
     {
         for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && stco->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
         {
-            isom_co64_entry_t *data = lsmash_malloc( sizeof(isom_co64_entry_t) );
+            isom_co64_entry_t *data = isom_add_table_entry( file, stco->list, sizeof(isom_co64_entry_t) );
             if( !data )
                 return LSMASH_ERR_MEMORY_ALLOC;
-            if( lsmash_list_add_entry( stco->list, data ) < 0 )
-            {
-                lsmash_free( data );
-                return LSMASH_ERR_MEMORY_ALLOC;
-            }
             data->chunk_offset = lsmash_bs_get_be64( bs );
         }
     }
@@ -1845,14 +1823,9 @@ static int isom_read_sgpd( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
         {
             for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && sgpd->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
             {
-                isom_rap_entry_t *data = lsmash_malloc( sizeof(isom_rap_entry_t) );
+                isom_rap_entry_t *data = isom_add_table_entry( file, sgpd->list, sizeof(isom_rap_entry_t) );
                 if( !data )
                     return LSMASH_ERR_MEMORY_ALLOC;
-                if( lsmash_list_add_entry( sgpd->list, data ) < 0 )
-                {
-                    lsmash_free( data );
-                    return LSMASH_ERR_MEMORY_ALLOC;
-                }
                 memset( data, 0, sizeof(isom_rap_entry_t) );
                 /* We don't know groups decided by variable description length. If encountering, skip getting of bytes of it. */
                 if( box->version == 1 && !sgpd->default_length )
@@ -1871,14 +1844,9 @@ static int isom_read_sgpd( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
         {
             for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && sgpd->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
             {
-                isom_roll_entry_t *data = lsmash_malloc( sizeof(isom_roll_entry_t) );
+                isom_roll_entry_t *data = isom_add_table_entry( file, sgpd->list, sizeof(isom_roll_entry_t) );
                 if( !data )
                     return LSMASH_ERR_MEMORY_ALLOC;
-                if( lsmash_list_add_entry( sgpd->list, data ) < 0 )
-                {
-                    lsmash_free( data );
-                    return LSMASH_ERR_MEMORY_ALLOC;
-                }
                 memset( data, 0, sizeof(isom_roll_entry_t) );
                 /* We don't know groups decided by variable description length. If encountering, skip getting of bytes of it. */
                 if( box->version == 1 && !sgpd->default_length )
@@ -1907,14 +1875,9 @@ static int isom_read_sbgp( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
     uint32_t entry_count = lsmash_bs_get_be32( bs );
     for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && sbgp->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
     {
-        isom_group_assignment_entry_t *data = lsmash_malloc( sizeof(isom_group_assignment_entry_t) );
+        isom_group_assignment_entry_t *data = isom_add_table_entry( file, sbgp->list, sizeof(isom_group_assignment_entry_t) );
         if( !data )
             return LSMASH_ERR_MEMORY_ALLOC;
-        if( lsmash_list_add_entry( sbgp->list, data ) < 0 )
-        {
-            lsmash_free( data );
-            return LSMASH_ERR_MEMORY_ALLOC;
-        }
         data->sample_count            = lsmash_bs_get_be32( bs );
         data->group_description_index = lsmash_bs_get_be32( bs );
     }
@@ -1953,14 +1916,9 @@ static int isom_read_chpl( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
         entry_count   = lsmash_bs_get_byte( bs );
     for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && chpl->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
     {
-        isom_chpl_entry_t *data = lsmash_malloc( sizeof(isom_chpl_entry_t) );
+        isom_chpl_entry_t *data = isom_add_table_entry( file, chpl->list, sizeof(isom_chpl_entry_t) );
         if( !data )
             return LSMASH_ERR_MEMORY_ALLOC;
-        if( lsmash_list_add_entry( chpl->list, data ) < 0 )
-        {
-            lsmash_free( data );
-            return LSMASH_ERR_MEMORY_ALLOC;
-        }
         data->start_time          = lsmash_bs_get_be64( bs );
         data->chapter_name_length = lsmash_bs_get_byte( bs );
         data->chapter_name        = lsmash_malloc( data->chapter_name_length + 1 );
@@ -2123,14 +2081,9 @@ static int isom_read_trun( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
             return LSMASH_ERR_MEMORY_ALLOC;
         for( uint32_t i = 0; i < trun->sample_count; i++ )
         {
-            isom_trun_optional_row_t *data = lsmash_malloc( sizeof(isom_trun_optional_row_t) );
+            isom_trun_optional_row_t *data = isom_add_table_entry( file, trun->optional, sizeof(isom_trun_optional_row_t) );
             if( !data )
                 return LSMASH_ERR_MEMORY_ALLOC;
-            if( lsmash_list_add_entry( trun->optional, data ) < 0 )
-            {
-                lsmash_free( data );
-                return LSMASH_ERR_MEMORY_ALLOC;
-            }
             if( box->flags & ISOM_TR_FLAGS_SAMPLE_DURATION_PRESENT                ) data->sample_duration                = lsmash_bs_get_be32( bs );
             if( box->flags & ISOM_TR_FLAGS_SAMPLE_SIZE_PRESENT                    ) data->sample_size                    = lsmash_bs_get_be32( bs );
             if( box->flags & ISOM_TR_FLAGS_SAMPLE_FLAGS_PRESENT                   ) data->sample_flags                   = isom_bs_get_sample_flags( bs );
@@ -2144,7 +2097,7 @@ static int isom_read_free( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
 {
     if( file->fake_file_mode )
         return isom_read_unknown_box( file, box, parent, level );
-    isom_skip_t *skip = ALLOCATE_BOX( skip );
+    isom_skip_t *skip = ALLOCATE_BOX( skip, NULL );
     if( LSMASH_IS_NON_EXISTING_BOX( skip ) )
         return LSMASH_ERR_MEMORY_ALLOC;
     isom_skip_box_rest( file->bs, box );
@@ -2163,7 +2116,7 @@ static int isom_read_mdat( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
 {
     if( file->fake_file_mode || !lsmash_check_box_type_identical( parent->type, LSMASH_BOX_TYPE_UNSPECIFIED ) )
         return isom_read_unknown_box( file, box, parent, level );
-    isom_mdat_t *mdat = ALLOCATE_BOX( mdat );
+    isom_mdat_t *mdat = ALLOCATE_BOX( mdat, NULL );
     if( LSMASH_IS_NON_EXISTING_BOX( mdat ) )
         return LSMASH_ERR_MEMORY_ALLOC;
     isom_skip_box_rest( file->bs, box );
@@ -2214,14 +2167,9 @@ static int isom_read_keys( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
     uint32_t entry_count = lsmash_bs_get_be32( bs );
     for( uint64_t pos = lsmash_bs_count( bs ); pos < box->size && keys->list->entry_count < entry_count; pos = lsmash_bs_count( bs ) )
     {
-        isom_keys_entry_t *data = lsmash_malloc( sizeof(isom_keys_entry_t) );
+        isom_keys_entry_t *data = isom_add_table_entry( file, keys->list, sizeof(isom_keys_entry_t) );
         if( !data )
             return LSMASH_ERR_MEMORY_ALLOC;
-        if( lsmash_list_add_entry( keys->list, data ) < 0 )
-        {
-            lsmash_free( data );
-            return LSMASH_ERR_MEMORY_ALLOC;
-        }
         data->key_size      = lsmash_bs_get_be32( bs );
         data->key_namespace = lsmash_bs_get_be32( bs );
         if( data->key_size > 8 )
@@ -2427,14 +2375,9 @@ static int isom_read_tfra( lsmash_file_t *file, isom_box_t *box, isom_box_t *par
         uint64_t (*bs_put_sample_number)( lsmash_bs_t * ) = bs_get_funcs[ tfra->length_size_of_sample_num ];
         for( uint32_t i = 0; i < tfra->number_of_entry; i++ )
         {
-            isom_tfra_location_time_entry_t *data = lsmash_malloc( sizeof(isom_tfra_location_time_entry_t) );
+            isom_tfra_location_time_entry_t *data = isom_add_table_entry( file, tfra->list, sizeof(isom_tfra_location_time_entry_t) );
             if( !data )
                 return LSMASH_ERR_MEMORY_ALLOC;
-            if( lsmash_list_add_entry( tfra->list, data ) < 0 )
-            {
-                lsmash_free( data );
-                return LSMASH_ERR_MEMORY_ALLOC;
-            }
             data->time          = bs_put_time         ( bs );
             data->moof_offset   = bs_put_moof_offset  ( bs );
             data->traf_number   = bs_put_traf_number  ( bs );
@@ -2556,6 +2499,7 @@ int isom_read_box( lsmash_file_t *file, isom_box_t *box, isom_box_t *parent, uin
     int ret = isom_bs_read_box_common( bs, box );
     if( !!ret )
         return ret;     /* return if reached EOF */
+    lsmash_stats_add( LSMASH_STATS_BOXES_PARSED, 1 );
     ++level;
     lsmash_box_type_t (*form_box_type_func)( lsmash_compact_box_type_t )   = NULL;
     int (*reader_func)( lsmash_file_t *, isom_box_t *, isom_box_t *, int ) = NULL;
@@ -2978,7 +2922,7 @@ int isom_read_file( lsmash_file_t *file )
         return LSMASH_ERR_NAMELESS;
     /* Reset the counter so that we can use it to get position within the box. */
     lsmash_bs_reset_counter( bs );
-    if( file->flags & LSMASH_FILE_MODE_DUMP )
+    if( (file->flags & LSMASH_FILE_MODE_DUMP) && !file->printer )
     {
         file->print = isom_printer_create_list();
         if( !file->print )
@@ -2986,7 +2930,9 @@ int isom_read_file( lsmash_file_t *file )
     }
     file->size = UINT64_MAX;
     isom_box_t box;
+    uint64_t start = lsmash_stats_begin_span( LSMASH_TRACE_SPAN_READ_FILE, NULL );
     int ret = isom_read_children( file, &box, file, 0 );
+    lsmash_stats_end_span( LSMASH_TRACE_SPAN_READ_FILE, NULL, start );
     file->size = box.size;
     lsmash_bs_empty( bs );
     bs->error = 0;  /* Clear error flag. */
@@ -0,0 +1,343 @@
+/*****************************************************************************
+ * sample.c
+ *****************************************************************************
+ * Copyright (C) 2026 L-SMASH project
+ *
+ * Authors: agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *****************************************************************************/
+
+/* This file is available under an ISC license. */
+
+#include "common/internal.h" /* must be placed first */
+
+#include <string.h>
+
+#include "common/thread.h"
+
+/* Sample buffer pool
+ * Buffers of sample data are recycled through free lists classified by capacities in four steps per power of two,
+ * which keeps the unused tail of a buffer under a quarter of its capacity.
+ * Each free list links buffers through their first bytes, so the smallest class shall hold a pointer. */
+#define SAMPLE_POOL_MIN_CLASS      8                    /* 256 bytes */
+#define SAMPLE_POOL_MAX_CLASS      26                   /* 64MiB */
+#define SAMPLE_POOL_CLASS_STEPS    4                    /* the number of classes per power of two */
+#define SAMPLE_POOL_NUM_CLASSES    ((SAMPLE_POOL_MAX_CLASS - SAMPLE_POOL_MIN_CLASS) * SAMPLE_POOL_CLASS_STEPS + 1)
+#define SAMPLE_POOL_DEFAULT_LIMIT  (64 * 1024 * 1024)
+
+/* The buffers taken from the pool and not returned yet, in an open addressing hash table keyed on their addresses.
+ * Whether the data of a sample came from the pool is known only by this registry since a sample may be allocated
+ * by the user and its data may be replaced by the user. */
+typedef struct
+{
+    uint8_t *buffer;
+    uint32_t capacity;
+} sample_pool_entry_t;
+
+typedef struct
+{
+    sample_pool_entry_t *entry;
+    uint32_t             size;      /* the number of entries, a power of two */
+    uint32_t             count;     /* the number of used entries */
+} sample_pool_registry_t;
+
+static struct
+{
+    lsmash_mutex_t              mutex;
+    void                       *free_list[SAMPLE_POOL_NUM_CLASSES];
+    sample_pool_registry_t      registry;
+    uint64_t                    limit;
+    lsmash_sample_pool_stats_t  stats;
+} sample_pool = { LSMASH_MUTEX_INITIALIZER, { NULL }, { NULL, 0, 0 }, SAMPLE_POOL_DEFAULT_LIMIT, { 0 } };
+
+/* Return the index of the smallest class holding 'size' bytes.
+ * Return SAMPLE_POOL_NUM_CLASSES if too large to be pooled. */
+static int sample_pool_get_class( uint32_t size )
+{
+    if( size <= ((uint32_t)1 << SAMPLE_POOL_MIN_CLASS) )
+        return 0;
+    if( size > ((uint32_t)1 << SAMPLE_POOL_MAX_CLASS) )
+        return SAMPLE_POOL_NUM_CLASSES;
+    /* 2^n < size <= 2^(n+1) */
+    int n = SAMPLE_POOL_MIN_CLASS;
+    while( ((uint32_t)2 << n) < size )
+        ++n;
+    uint32_t step = ((uint32_t)1 << n) / SAMPLE_POOL_CLASS_STEPS;
+    uint32_t k    = (size - ((uint32_t)1 << n) + step - 1) / step;
+    return (n - SAMPLE_POOL_MIN_CLASS) * SAMPLE_POOL_CLASS_STEPS + k;
+}
+
+static uint32_t sample_pool_get_class_capacity( int class_index )
+{
+    if( class_index == 0 )
+        return (uint32_t)1 << SAMPLE_POOL_MIN_CLASS;
+    int      n = SAMPLE_POOL_MIN_CLASS + (class_index - 1) / SAMPLE_POOL_CLASS_STEPS;
+    uint32_t k = (class_index - 1) % SAMPLE_POOL_CLASS_STEPS + 1;
+    return ((uint32_t)1 << n) + k * (((uint32_t)1 << n) / SAMPLE_POOL_CLASS_STEPS);
+}
+
+static inline uint32_t sample_pool_registry_hash( const uint8_t *buffer, uint32_t size )
+{
+    return (uint32_t)(((uint64_t)(uintptr_t)buffer >> 4) * UINT64_C(0x9E3779B97F4A7C15) >> 32) & (size - 1);
+}
+
+/* The caller shall lock the pool. */
+static int sample_pool_registry_add( sample_pool_registry_t *registry, uint8_t *buffer, uint32_t capacity )
+{
+    if( 2 * (registry->count + 1) > registry->size )
+    {
+        uint32_t size = registry->size ? 2 * registry->size : 64;
+        sample_pool_entry_t *entry = lsmash_malloc_zero( size * sizeof(sample_pool_entry_t) );
+        if( !entry )
+            return LSMASH_ERR_MEMORY_ALLOC;
+        for( uint32_t i = 0; i < registry->size; i++ )
+            if( registry->entry[i].buffer )
+            {
+                uint32_t j = sample_pool_registry_hash( registry->entry[i].buffer, size );
+                while( entry[j].buffer )
+                    j = (j + 1) & (size - 1);
+                entry[j] = registry->entry[i];
+            }
+        lsmash_free( registry->entry );
+        registry->entry = entry;
+        registry->size  = size;
+    }
+    uint32_t i = sample_pool_registry_hash( buffer, registry->size );
+    while( registry->entry[i].buffer )
+        i = (i + 1) & (registry->size - 1);
+    registry->entry[i].buffer   = buffer;
+    registry->entry[i].capacity = capacity;
+    ++ registry->count;
+    return 0;
+}
+
+/* Remove 'buffer' from the registry and return its capacity.
+ * Return 0 if not registered. The caller shall lock the pool. */
+static uint32_t sample_pool_registry_remove( sample_pool_registry_t *registry, const uint8_t *buffer )
+{
+    if( registry->count == 0 )
+        return 0;
+    uint32_t mask = registry->size - 1;
+    uint32_t i    = sample_pool_registry_hash( buffer, registry->size );
+    while( registry->entry[i].buffer != buffer )
+    {
+        if( !registry->entry[i].buffer )
+            return 0;
+        i = (i + 1) & mask;
+    }
+    uint32_t capacity = registry->entry[i].capacity;
+    /* Shift the following entries of the cluster back not to break their probe sequences. */
+    for( uint32_t j = (i + 1) & mask; registry->entry[j].buffer; j = (j + 1) & mask )
+    {
+        uint32_t home = sample_pool_registry_hash( registry->entry[j].buffer, registry->size );
+        if( ((j - home) & mask) >= ((j - i) & mask) )
+        {
+            registry->entry[i] = registry->entry[j];
+            i = j;
+        }
+    }
+    registry->entry[i].buffer   = NULL;
+    registry->entry[i].capacity = 0;
+    -- registry->count;
+    return capacity;
+}
+
+/* Take a buffer of 'size' bytes at least from the pool. Too large ones are allocated as usual and not registered. */
+static uint8_t *sample_pool_get_buffer( uint32_t size, uint32_t *capacity )
+{
+    int class_index = sample_pool_get_class( size );
+    if( class_index >= SAMPLE_POOL_NUM_CLASSES )
+    {
+        *capacity = size;
+        return lsmash_malloc( size );
+    }
+    uint32_t class_capacity = sample_pool_get_class_capacity( class_index );
+    void   **list           = &sample_pool.free_list[class_index];
+    lsmash_mutex_lock( &sample_pool.mutex );
+    uint8_t *buffer = *list;
+    if( buffer )
+    {
+        *list = *(void **)buffer;
+        sample_pool.stats.hits         += 1;
+        sample_pool.stats.cached_count -= 1;
+        sample_pool.stats.cached_size  -= class_capacity;
+    }
+    else
+    {
+        sample_pool.stats.misses += 1;
+        buffer = lsmash_malloc( class_capacity );
+    }
+    if( buffer && sample_pool_registry_add( &sample_pool.registry, buffer, class_capacity ) < 0 )
+    {
+        lsmash_free( buffer );
+        buffer = NULL;
+    }
+    lsmash_mutex_unlock( &sample_pool.mutex );
+    *capacity = class_capacity;
+    return buffer;
+}
+
+/* Release 'data' to the pool if it came from there. Otherwise, deallocate it as usual. */
+static void sample_pool_release( uint8_t *data )
+{
+    if( !data )
+        return;
+    lsmash_mutex_lock( &sample_pool.mutex );
+    uint32_t capacity = sample_pool_registry_remove( &sample_pool.registry, data );
+    if( capacity )
+    {
+        if( sample_pool.stats.cached_size + capacity <= sample_pool.limit )
+        {
+            void **list = &sample_pool.free_list[ sample_pool_get_class( capacity ) ];
+            *(void **)data = *list;
+            *list = data;
+            sample_pool.stats.recycled     += 1;
+            sample_pool.stats.cached_count += 1;
+            sample_pool.stats.cached_size  += capacity;
+            if( sample_pool.stats.peak_cached_size < sample_pool.stats.cached_size )
+                sample_pool.stats.peak_cached_size = sample_pool.stats.cached_size;
+            data = NULL;
+        }
+        else
+            sample_pool.stats.discarded += 1;
+    }
+    lsmash_mutex_unlock( &sample_pool.mutex );
+    lsmash_free( data );
+}
+
+/* Return the capacity of 'data' if it came from the pool, 0 if not. */
+static uint32_t sample_pool_get_capacity( const uint8_t *data )
+{
+    uint32_t capacity = 0;
+    if( !data )
+        return 0;
+    lsmash_mutex_lock( &sample_pool.mutex );
+    sample_pool_registry_t *registry = &sample_pool.registry;
+    if( registry->count )
+    {
+        uint32_t i = sample_pool_registry_hash( data, registry->size );
+        while( registry->entry[i].buffer && registry->entry[i].buffer != data )
+            i = (i + 1) & (registry->size - 1);
+        capacity = registry->entry[i].capacity;
+    }
+    lsmash_mutex_unlock( &sample_pool.mutex );
+    return capacity;
+}
+
+void lsmash_flush_sample_pool( void )
+{
+    lsmash_mutex_lock( &sample_pool.mutex );
+    for( int i = 0; i < SAMPLE_POOL_NUM_CLASSES; i++ )
+        while( sample_pool.free_list[i] )
+        {
+            void *buffer = sample_pool.free_list[i];
+            sample_pool.free_list[i] = *(void **)buffer;
+            lsmash_free( buffer );
+        }
+    sample_pool.stats.cached_count = 0;
+    sample_pool.stats.cached_size  = 0;
+    if( sample_pool.registry.count == 0 )
+    {
+        /* The table shall be deallocated by the allocator which allocated it. */
+        lsmash_free( sample_pool.registry.entry );
+        sample_pool.registry.entry = NULL;
+        sample_pool.registry.size  = 0;
+    }
+    lsmash_mutex_unlock( &sample_pool.mutex );
+}
+
+void lsmash_set_sample_pool_limit( uint64_t max_size )
+{
+    lsmash_mutex_lock( &sample_pool.mutex );
+    sample_pool.limit = max_size;
+    int over = (sample_pool.stats.cached_size > max_size);
+    lsmash_mutex_unlock( &sample_pool.mutex );
+    if( over )
+        lsmash_flush_sample_pool();
+}
+
+void lsmash_get_sample_pool_stats( lsmash_sample_pool_stats_t *stats )
+{
+    if( !stats )
+        return;
+    lsmash_mutex_lock( &sample_pool.mutex );
+    *stats = sample_pool.stats;
+    lsmash_mutex_unlock( &sample_pool.mutex );
+}
+
+lsmash_sample_t *lsmash_create_sample( uint32_t size )
+{
+    lsmash_sample_t *sample = lsmash_malloc_zero( sizeof(lsmash_sample_t) );
+    if( !sample )
+        return NULL;
+    if( size == 0 )
+        return sample;
+    uint32_t capacity;
+    sample->data = sample_pool_get_buffer( size, &capacity );
+    if( !sample->data )
+    {
+        lsmash_free( sample );
+        return NULL;
+    }
+    sample->length = size;
+    return sample;
+}
+
+int lsmash_sample_alloc( lsmash_sample_t *sample, uint32_t size )
+{
+    if( !sample )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    if( size == 0 )
+    {
+        sample_pool_release( sample->data );
+        sample->data   = NULL;
+        sample->length = 0;
+        return 0;
+    }
+    if( size == sample->length )
+        return 0;
+    uint32_t capacity = sample_pool_get_capacity( sample->data );
+    if( sample->data && capacity == 0 )
+    {
+        /* The data didn't come from the pool. Keep the way of reallocation. */
+        uint8_t *data = lsmash_realloc( sample->data, size );
+        if( !data )
+            return LSMASH_ERR_MEMORY_ALLOC;
+        sample->data   = data;
+        sample->length = size;
+        return 0;
+    }
+    if( size > capacity )
+    {
+        uint8_t *data = sample_pool_get_buffer( size, &capacity );
+        if( !data )
+            return LSMASH_ERR_MEMORY_ALLOC;
+        if( sample->data )
+        {
+            memcpy( data, sample->data, LSMASH_MIN( sample->length, size ) );
+            sample_pool_release( sample->data );
+        }
+        sample->data = data;
+    }
+    sample->length = size;
+    return 0;
+}
+
+void lsmash_delete_sample( lsmash_sample_t *sample )
+{
+    if( !sample )
+        return;
+    sample_pool_release( sample->data );
+    lsmash_free( sample );
+}
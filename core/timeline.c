@@ -27,6 +27,7 @@
 #include <inttypes.h>
 
 #include "box.h"
+#include "file.h"
 #include "timeline.h"
 
 #include "codecs/mp4a.h"
@@ -84,7 +85,9 @@ struct isom_timeline_tag
     int (*check_sample_existence)( isom_timeline_t *timeline, uint32_t sample_number );
 };
 
-isom_timeline_t *isom_get_timeline( lsmash_root_t *root, uint32_t track_ID )
+/* Search the timeline of a track without the cache of the last accessed one, so that concurrent callers don't write
+ * the file shared by them. */
+static isom_timeline_t *isom_search_timeline( lsmash_root_t *root, uint32_t track_ID )
 {
     if( isom_check_initializer_present( root ) < 0
      || track_ID == 0
@@ -101,6 +104,21 @@ isom_timeline_t *isom_get_timeline( lsmash_root_t *root, uint32_t track_ID )
     return NULL;
 }
 
+isom_timeline_t *isom_get_timeline( lsmash_root_t *root, uint32_t track_ID )
+{
+    if( isom_check_initializer_present( root ) < 0
+     || track_ID == 0 )
+        return NULL;
+    /* Callers usually access the same track repeatedly, so skip the search in that case. */
+    isom_timeline_t *timeline = root->file->last_accessed_timeline;
+    if( timeline && timeline->track_ID == track_ID )
+        return timeline;
+    timeline = isom_search_timeline( root, track_ID );
+    if( timeline )
+        root->file->last_accessed_timeline = timeline;
+    return timeline;
+}
+
 isom_timeline_t *isom_timeline_create( void )
 {
     isom_timeline_t *timeline = lsmash_malloc_zero( sizeof(isom_timeline_t) );
@@ -130,6 +148,8 @@ void isom_remove_timelines( lsmash_file_t *file )
     if( LSMASH_IS_NON_EXISTING_BOX( file ) || !file->timeline )
         return;
     lsmash_list_destroy( file->timeline );
+    file->timeline               = NULL;
+    file->last_accessed_timeline = NULL;
 }
 
 void lsmash_destruct_timeline( lsmash_root_t *root, uint32_t track_ID )
@@ -145,6 +165,8 @@ void lsmash_destruct_timeline( lsmash_root_t *root, uint32_t track_ID )
             continue;
         if( timeline->track_ID == track_ID )
         {
+            if( root->file->last_accessed_timeline == timeline )
+                root->file->last_accessed_timeline = NULL;
             lsmash_list_remove_entry_direct( root->file->timeline, entry );
             break;
         }
@@ -502,13 +524,28 @@ static lsmash_sample_t *isom_read_sample_data_from_stream
 {
     if( !file )
         return NULL;
-    lsmash_sample_t *sample = lsmash_create_sample( 0 );
+    lsmash_sample_t *sample = lsmash_create_sample( sample_length );
     if( !sample )
         return NULL;
     lsmash_bs_t *bs = file->bs;
+    if( bs->pread
+     && sample_length
+     && (sample_pos < bs->offset - bs->buffer.store || sample_pos > bs->offset)
+     && sample_pos != file->direct_read_end )
+    {
+        /* The sample is away from the buffer, so read only it rather than refilling the whole buffer there.
+         * A sample right after the one read in this way suggests sequential access again, and goes through the buffer. */
+        if( isom_read_file_at( file, sample_pos, sample->data, sample_length ) < 0 )
+        {
+            lsmash_delete_sample( sample );
+            return NULL;
+        }
+        file->direct_read_end = sample_pos + sample_length;
+        return sample;
+    }
     lsmash_bs_read_seek( bs, sample_pos, SEEK_SET );
-    sample->data = lsmash_bs_get_bytes( bs, sample_length );
-    if( !sample->data )
+    if( sample_length == 0
+     || lsmash_bs_get_bytes_ex( bs, sample_length, sample->data ) != sample_length )
     {
         lsmash_delete_sample( sample );
         return NULL;
@@ -594,6 +631,48 @@ static int isom_get_sample_info_from_media_timeline( isom_timeline_t *timeline,
     return 0;
 }
 
+static inline void isom_put_sample_info_to_columns( lsmash_sample_info_columns_t *columns, uint32_t i, const lsmash_sample_t *sample )
+{
+    if( columns->dts    ) columns->dts   [i] = sample->dts;
+    if( columns->cts    ) columns->cts   [i] = sample->cts;
+    if( columns->pos    ) columns->pos   [i] = sample->pos;
+    if( columns->length ) columns->length[i] = sample->length;
+    if( columns->index  ) columns->index [i] = sample->index;
+    if( columns->prop   ) columns->prop  [i] = sample->prop;
+}
+
+/* Get the information of the consecutive samples in one walk over the info list.
+ * Both the timestamp cache and the list cache are advanced sample by sample, so accessing the next range or the next sample
+ * afterwards stays in constant time. */
+static uint32_t isom_get_sample_info_range_from_info_list( isom_timeline_t *timeline, uint32_t sample_number, uint32_t count, lsmash_sample_info_columns_t *columns )
+{
+    uint64_t dts;
+    if( isom_get_dts_from_info_list( timeline, sample_number, &dts ) < 0 )
+        return 0;
+    uint64_t last_dts = dts;
+    uint32_t i;
+    for( i = 0; i < count; i++ )
+    {
+        isom_sample_info_t *info = (isom_sample_info_t *)lsmash_list_get_entry_data( timeline->info_list, sample_number + i );
+        if( !info )
+            break;
+        if( columns->dts    ) columns->dts   [i] = dts;
+        if( columns->cts    ) columns->cts   [i] = isom_make_cts( dts, info->offset, timeline->ctd_shift );
+        if( columns->pos    ) columns->pos   [i] = info->pos;
+        if( columns->length ) columns->length[i] = info->length;
+        if( columns->index  ) columns->index [i] = info->index;
+        if( columns->prop   ) columns->prop  [i] = info->prop;
+        last_dts = dts;
+        dts += info->duration;
+    }
+    if( i )
+    {
+        timeline->last_accessed_sample_number = sample_number + i - 1;
+        timeline->last_accessed_sample_dts    = last_dts;
+    }
+    return i;
+}
+
 static int isom_get_lpcm_sample_property_from_media_timeline( isom_timeline_t *timeline, uint32_t sample_number, lsmash_sample_property_t *prop )
 {
     memset( prop, 0, sizeof(lsmash_sample_property_t) );
@@ -750,7 +829,7 @@ static int isom_get_random_access_point_grouping_info
     return 0;
 }
 
-int isom_timeline_construct( lsmash_root_t *root, uint32_t track_ID )
+static int isom_timeline_construct_internal( lsmash_root_t *root, uint32_t track_ID )
 {
     if( isom_check_initializer_present( root ) < 0 )
         return LSMASH_ERR_FUNCTION_PARAM;
@@ -1411,6 +1490,14 @@ fail:
     return err;
 }
 
+int isom_timeline_construct( lsmash_root_t *root, uint32_t track_ID )
+{
+    uint64_t start = lsmash_stats_begin_span( LSMASH_TRACE_SPAN_CONSTRUCT_TIMELINE, NULL );
+    int ret = isom_timeline_construct_internal( root, track_ID );
+    lsmash_stats_end_span( LSMASH_TRACE_SPAN_CONSTRUCT_TIMELINE, NULL, start );
+    return ret;
+}
+
 int lsmash_construct_timeline( lsmash_root_t *root, uint32_t track_ID )
 {
     if( LSMASH_IS_NON_EXISTING_BOX( root )
@@ -1445,6 +1532,44 @@ int lsmash_construct_timeline( lsmash_root_t *root, uint32_t track_ID )
     return lsmash_importer_construct_timeline( root->file->importer, track_number );
 }
 
+uint32_t isom_timeline_get_chunk_range
+(
+    isom_timeline_t *timeline,
+    uint32_t         sample_number,
+    lsmash_file_t  **file,
+    uint64_t        *pos,
+    uint64_t        *length
+)
+{
+    /* LPCM bunches may span chunks and are not handled here. */
+    if( !timeline
+     || timeline->info_list->entry_count == 0 )
+        return 0;
+    lsmash_entry_t *entry = lsmash_list_get_entry( timeline->info_list, sample_number );
+    if( !entry || !entry->data )
+        return 0;
+    isom_sample_info_t *first = (isom_sample_info_t *)entry->data;
+    if( !first->chunk || LSMASH_IS_NON_EXISTING_BOX( first->chunk->file ) )
+        return 0;
+    uint32_t count = 0;
+    uint64_t end   = first->pos;
+    for( ; entry; entry = entry->next )
+    {
+        isom_sample_info_t *info = (isom_sample_info_t *)entry->data;
+        if( !info
+         || info->chunk != first->chunk
+         || info->index != first->index
+         || info->pos   != end )
+            break;
+        end += info->length;
+        ++count;
+    }
+    *file   = first->chunk->file;
+    *pos    = first->pos;
+    *length = end - first->pos;
+    return count;
+}
+
 int lsmash_get_dts_from_media_timeline( lsmash_root_t *root, uint32_t track_ID, uint32_t sample_number, uint64_t *dts )
 {
     if( !sample_number || !dts )
@@ -1479,6 +1604,30 @@ int lsmash_get_sample_info_from_media_timeline( lsmash_root_t *root, uint32_t tr
     return timeline ? timeline->get_sample_info( timeline, sample_number, sample ) : -1;
 }
 
+int lsmash_get_sample_info_range_from_media_timeline( lsmash_root_t *root, uint32_t track_ID, uint32_t sample_number, uint32_t count, lsmash_sample_info_columns_t *columns )
+{
+    if( sample_number == 0 || !columns )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    isom_timeline_t *timeline = isom_get_timeline( root, track_ID );
+    if( !timeline )
+        return LSMASH_ERR_NAMELESS;
+    if( sample_number > timeline->sample_count )
+        return 0;
+    count = LSMASH_MIN( count, timeline->sample_count - sample_number + 1 );
+    count = LSMASH_MIN( count, INT32_MAX );
+    if( timeline->info_list->entry_count )
+        return isom_get_sample_info_range_from_info_list( timeline, sample_number, count, columns ) == count ? (int)count : LSMASH_ERR_NAMELESS;
+    for( uint32_t i = 0; i < count; i++ )
+    {
+        lsmash_sample_t sample;
+        int err = timeline->get_sample_info( timeline, sample_number + i, &sample );
+        if( err < 0 )
+            return err;
+        isom_put_sample_info_to_columns( columns, i, &sample );
+    }
+    return count;
+}
+
 int lsmash_get_sample_property_from_media_timeline( lsmash_root_t *root, uint32_t track_ID, uint32_t sample_number, lsmash_sample_property_t *prop )
 {
     if( !prop )
@@ -1721,6 +1870,164 @@ int lsmash_check_sample_existence_in_media_timeline( lsmash_root_t *root, uint32
     return timeline ? timeline->check_sample_existence( timeline, sample_number ) : 0;
 }
 
+/*---- track readers ----*/
+struct lsmash_track_reader_tag
+{
+    isom_timeline_t *timeline;  /* the shared timeline, which is never modified through track readers */
+    lsmash_entry_t  *entry;     /* the last accessed entry in the list of sample info or LPCM bunches */
+    uint32_t         number;    /* the number of the first sample in the last accessed entry */
+    uint64_t         dts;       /* the DTS of the first sample in the last accessed entry */
+};
+
+static int isom_get_reader_entry_span( isom_timeline_t *timeline, lsmash_entry_t *entry, uint32_t *sample_count, uint32_t *duration )
+{
+    if( !entry || !entry->data )
+        return LSMASH_ERR_NAMELESS;
+    if( timeline->info_list->entry_count )
+    {
+        *sample_count = 1;
+        *duration     = ((isom_sample_info_t *)entry->data)->duration;
+    }
+    else
+    {
+        *sample_count = ((isom_lpcm_bunch_t *)entry->data)->sample_count;
+        *duration     = ((isom_lpcm_bunch_t *)entry->data)->duration;
+    }
+    return 0;
+}
+
+/* Move the cursor of a track reader to the entry containing a given sample.
+ * Like the caches of the timeline, the cursor is moved from the last accessed entry unless it's far. */
+static int isom_seek_track_reader( lsmash_track_reader_t *reader, uint32_t sample_number )
+{
+    isom_timeline_t *timeline = reader->timeline;
+    if( sample_number == 0 || sample_number > timeline->sample_count )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    if( !reader->entry || sample_number < reader->number / 2 )
+    {
+        reader->entry  = timeline->info_list->entry_count ? timeline->info_list->head : timeline->bunch_list->head;
+        reader->number = 1;
+        reader->dts    = 0;
+    }
+    uint32_t sample_count;
+    uint32_t duration;
+    while( 1 )
+    {
+        int ret = isom_get_reader_entry_span( timeline, reader->entry, &sample_count, &duration );
+        if( ret < 0 )
+            return ret;
+        if( sample_number < reader->number )
+        {
+            lsmash_entry_t *prev = reader->entry->prev;
+            if( (ret = isom_get_reader_entry_span( timeline, prev, &sample_count, &duration )) < 0 )
+                return ret;
+            reader->entry   = prev;
+            reader->number -= sample_count;
+            reader->dts    -= (uint64_t)duration * sample_count;
+        }
+        else if( sample_number >= reader->number + sample_count )
+        {
+            reader->entry   = reader->entry->next;
+            reader->number += sample_count;
+            reader->dts    += (uint64_t)duration * sample_count;
+        }
+        else
+            return 0;
+    }
+}
+
+static int isom_get_sample_info_from_track_reader
+(
+    lsmash_track_reader_t  *reader,
+    uint32_t                sample_number,
+    lsmash_sample_t        *sample,
+    isom_portable_chunk_t **chunk
+)
+{
+    int ret = isom_seek_track_reader( reader, sample_number );
+    if( ret < 0 )
+        return ret;
+    isom_timeline_t *timeline = reader->timeline;
+    if( timeline->info_list->entry_count )
+    {
+        isom_sample_info_t *info = (isom_sample_info_t *)reader->entry->data;
+        sample->dts    = reader->dts;
+        sample->cts    = isom_make_cts( reader->dts, info->offset, timeline->ctd_shift );
+        sample->pos    = info->pos;
+        sample->length = info->length;
+        sample->index  = info->index;
+        sample->prop   = info->prop;
+        *chunk = info->chunk;
+    }
+    else
+    {
+        isom_lpcm_bunch_t *bunch = (isom_lpcm_bunch_t *)reader->entry->data;
+        uint64_t sample_number_offset = sample_number - reader->number;
+        sample->dts    = reader->dts + sample_number_offset * bunch->duration;
+        sample->cts    = isom_make_cts( sample->dts, bunch->offset, timeline->ctd_shift );
+        sample->pos    = bunch->pos + sample_number_offset * bunch->length;
+        sample->length = bunch->length;
+        sample->index  = bunch->index;
+        sample->prop   = bunch->prop;
+        *chunk = bunch->chunk;
+    }
+    return 0;
+}
+
+lsmash_track_reader_t *lsmash_create_track_reader( lsmash_root_t *root, uint32_t track_ID )
+{
+    /* Readers may be created concurrently. */
+    isom_timeline_t *timeline = isom_search_timeline( root, track_ID );
+    if( !timeline )
+        return NULL;
+    lsmash_track_reader_t *reader = lsmash_malloc_zero( sizeof(lsmash_track_reader_t) );
+    if( !reader )
+        return NULL;
+    reader->timeline = timeline;
+    return reader;
+}
+
+void lsmash_destroy_track_reader( lsmash_track_reader_t *reader )
+{
+    lsmash_free( reader );
+}
+
+lsmash_sample_t *lsmash_get_sample_from_track_reader( lsmash_track_reader_t *reader, uint32_t sample_number )
+{
+    if( !reader )
+        return NULL;
+    lsmash_sample_t        info;
+    isom_portable_chunk_t *chunk;
+    if( isom_get_sample_info_from_track_reader( reader, sample_number, &info, &chunk ) < 0
+     || !chunk
+     || !chunk->file
+     || info.length == 0 )
+        return NULL;
+    lsmash_sample_t *sample = lsmash_create_sample( info.length );
+    if( !sample )
+        return NULL;
+    if( isom_read_file_at( chunk->file, info.pos, sample->data, info.length ) < 0 )
+    {
+        lsmash_delete_sample( sample );
+        return NULL;
+    }
+    sample->dts    = info.dts;
+    sample->cts    = info.cts;
+    sample->pos    = info.pos;
+    sample->length = info.length;
+    sample->index  = info.index;
+    sample->prop   = info.prop;
+    return sample;
+}
+
+int lsmash_get_sample_info_from_track_reader( lsmash_track_reader_t *reader, uint32_t sample_number, lsmash_sample_t *sample )
+{
+    if( !reader || !sample )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    isom_portable_chunk_t *chunk;
+    return isom_get_sample_info_from_track_reader( reader, sample_number, sample, &chunk );
+}
+
 int lsmash_get_last_sample_delta_from_media_timeline( lsmash_root_t *root, uint32_t track_ID, uint32_t *last_sample_delta )
 {
     if( !last_sample_delta )
@@ -1964,6 +2271,115 @@ int lsmash_set_media_timestamps( lsmash_root_t *root, uint32_t track_ID, lsmash_
     return 0;
 }
 
+static int isom_add_timing_entry( lsmash_entry_list_t *list, uint32_t value )
+{
+    /* Both entries of stts and ctts consist of sample_count and a following 32-bit value. */
+    isom_stts_entry_t *data = list->tail ? (isom_stts_entry_t *)list->tail->data : NULL;
+    if( data && data->sample_delta == value && data->sample_count < UINT32_MAX )
+    {
+        ++ data->sample_count;
+        return 0;
+    }
+    data = lsmash_malloc( sizeof(isom_stts_entry_t) );
+    if( !data )
+        return LSMASH_ERR_MEMORY_ALLOC;
+    data->sample_count = 1;
+    data->sample_delta = value;
+    if( lsmash_list_add_entry( list, data ) < 0 )
+    {
+        lsmash_free( data );
+        return LSMASH_ERR_MEMORY_ALLOC;
+    }
+    return 0;
+}
+
+int lsmash_update_sample_timing_tables( lsmash_root_t *root, uint32_t track_ID, uint32_t media_timescale, uint32_t last_sample_delta )
+{
+    isom_timeline_t *timeline = isom_get_timeline( root, track_ID );
+    if( !timeline )
+        return LSMASH_ERR_NAMELESS;
+    lsmash_file_t *file = root->file;
+    isom_trak_t   *trak = isom_get_trak( file, track_ID );
+    if( LSMASH_IS_NON_EXISTING_BOX( trak )
+     || LSMASH_IS_NON_EXISTING_BOX( trak->mdia->mdhd )
+     || LSMASH_IS_NON_EXISTING_BOX( trak->mdia->minf->stbl->stts )
+     || !trak->cache )
+        return LSMASH_ERR_NAMELESS;
+    if( timeline->info_list->entry_count == 0 )
+    {
+        lsmash_log( timeline, LSMASH_LOG_ERROR, "Changing timestamps of LPCM track is not supported.\n" );
+        return LSMASH_ERR_PATCH_WELCOME;
+    }
+    if( file->fragment || LSMASH_IS_EXISTING_BOX( file->moov->mvex ) )
+    {
+        lsmash_log( timeline, LSMASH_LOG_ERROR, "Rebuilding sample tables of fragmented movie is not supported.\n" );
+        return LSMASH_ERR_PATCH_WELCOME;
+    }
+    isom_stbl_t *stbl = trak->mdia->minf->stbl;
+    if( timeline->info_list->entry_count != isom_get_sample_count( trak ) )
+        return LSMASH_ERR_INVALID_DATA;
+    /* Build new tables aside so that the current ones stay intact on failure. */
+    int err = LSMASH_ERR_MEMORY_ALLOC;
+    int has_offset     = 0;
+    int has_non_output = 0;
+    lsmash_entry_list_t *stts_list = lsmash_list_create_simple();
+    lsmash_entry_list_t *ctts_list = lsmash_list_create_simple();
+    if( !stts_list || !ctts_list )
+        goto fail;
+    for( lsmash_entry_t *entry = timeline->info_list->head; entry; entry = entry->next )
+    {
+        isom_sample_info_t *info = (isom_sample_info_t *)entry->data;
+        if( !info )
+        {
+            err = LSMASH_ERR_INVALID_DATA;
+            goto fail;
+        }
+        has_offset     |= (info->offset != 0);
+        has_non_output |= (info->offset == ISOM_NON_OUTPUT_SAMPLE_OFFSET);
+        if( (err = isom_add_timing_entry( stts_list, info->duration )) < 0
+         || (err = isom_add_timing_entry( ctts_list, info->offset   )) < 0 )
+            goto fail;
+    }
+    if( has_offset )
+    {
+        if( LSMASH_IS_NON_EXISTING_BOX( stbl->ctts ) )
+        {
+            if( LSMASH_IS_BOX_ADDITION_FAILURE( isom_add_ctts( stbl ) ) )
+            {
+                err = LSMASH_ERR_NAMELESS;
+                goto fail;
+            }
+            isom_reorder_tail_box( (isom_box_t *)stbl );
+        }
+        lsmash_list_destroy( stbl->ctts->list );
+        stbl->ctts->list    = ctts_list;
+        stbl->ctts->version = has_non_output || (timeline->ctd_shift && !file->qt_compatible);
+    }
+    else
+    {
+        /* All samples have no composition offset. */
+        lsmash_list_destroy( ctts_list );
+        isom_remove_box_by_itself( stbl->ctts );
+        isom_remove_box_by_itself( stbl->cslg );
+    }
+    lsmash_list_destroy( stbl->stts->list );
+    stbl->stts->list = stts_list;
+    trak->cache->timestamp.ctd_shift = timeline->ctd_shift;
+    /* The statistics measured with the old timestamps are no longer valid. */
+    trak->cache->stats_invalid       = 1;
+    if( media_timescale )
+    {
+        trak->mdia->mdhd->timescale = media_timescale;
+        timeline->media_timescale   = media_timescale;
+    }
+    trak->mdia->mdhd->duration = 0;
+    return lsmash_update_track_duration( root, track_ID, last_sample_delta );
+fail:
+    lsmash_list_destroy( stts_list );
+    lsmash_list_destroy( ctts_list );
+    return err;
+}
+
 int lsmash_get_media_timestamps( lsmash_root_t *root, uint32_t track_ID, lsmash_media_ts_list_t *ts_list )
 {
     if( !ts_list )
@@ -122,6 +122,18 @@ int isom_add_lpcm_bunch_entry
     isom_lpcm_bunch_t *src_bunch
 );
 
+/* Get the byte range of the samples stored contiguously within the same chunk, starting from 'sample_number'.
+ * Return the number of the samples in the range if successful.
+ * Return 0 otherwise, e.g. if the media timeline consists of LPCM bunches. */
+uint32_t isom_timeline_get_chunk_range
+(
+    isom_timeline_t *timeline,
+    uint32_t         sample_number,
+    lsmash_file_t  **file,
+    uint64_t        *pos,
+    uint64_t        *length
+);
+
 isom_elst_entry_t *isom_timelime_get_explicit_timeline_map
 (
     lsmash_root_t *root,
@@ -27,6 +27,7 @@
 #include <inttypes.h>
 
 #include "box.h"
+#include "file.h"
 #include "write.h"
 
 #include "codecs/mp4a.h"
@@ -1416,7 +1417,9 @@ static int isom_write_mdat( lsmash_bs_t *bs, isom_box_t *box )
             isom_sample_pool_t *pool = (isom_sample_pool_t *)entry->data;
             if( !pool )
                 return LSMASH_ERR_NAMELESS;
-            lsmash_bs_put_bytes( bs, pool->size, pool->data );
+            int err = isom_put_pooled_samples( bs, pool );
+            if( err < 0 )
+                return err;
         }
         mdat->media_size = file->fragment->pool_size;
         return 0;
@@ -1560,6 +1563,7 @@ int isom_write_box( lsmash_bs_t *bs, isom_box_t *box )
         return ret;
     if( bs->stream )
     {
+        lsmash_stats_add( LSMASH_STATS_BOXES_WRITTEN, 1 );
         if( (ret = lsmash_bs_flush_buffer( bs )) < 0 )
             return ret;
         /* Don't write any child box if this box is a placeholder or an incomplete box. */
@@ -1567,6 +1571,7 @@ int isom_write_box( lsmash_bs_t *bs, isom_box_t *box )
             return 0;
         else
             box->manager |= LSMASH_WRITTEN_BOX;
+        isom_estimate_written_box( bs, box );
     }
     return isom_write_children( bs, box );
 }
@@ -96,6 +96,29 @@ static const uint32_t ac3_frame_size_table[19][3] =
     { 2560,  2786,  3840 }
 };
 
+static uint32_t ac3_get_frame_size( uint8_t fscod, uint8_t frmsizecod )
+{
+    uint32_t frame_size = ac3_frame_size_table[ frmsizecod >> 1 ][ fscod ];
+    if( fscod == 0x1 && frmsizecod & 0x1 )
+        frame_size += 2;
+    return frame_size;
+}
+
+static uint32_t ac3_get_syncframe_length( const uint8_t *header )
+{
+    uint8_t fscod      = header[4] >> 6;    /* syncword (16), crc1 (16), fscod (2) */
+    uint8_t frmsizecod = header[4] & 0x3F;  /* frmsizecod (6) */
+    uint8_t bsid       = header[5] >> 3;    /* bsid (5) */
+    if( fscod == 0x3 || frmsizecod > 0x25 || bsid >= 10 )
+        return 0;
+    return ac3_get_frame_size( fscod, frmsizecod );
+}
+
+static const importer_sync_t ac3_sync =
+{
+    { 0x0B770000 }, { 0xFFFF0000 }, 1, 6, AC3_MAX_SYNCFRAME_LENGTH, ac3_get_syncframe_length
+};
+
 static lsmash_audio_summary_t *ac3_create_summary( ac3_info_t *info )
 {
     lsmash_audio_summary_t *summary = (lsmash_audio_summary_t *)lsmash_create_summary( LSMASH_SUMMARY_TYPE_AUDIO );
@@ -172,9 +195,7 @@ static int ac3_importer_get_accessunit( importer_t *importer, uint32_t track_num
     if( current_status == IMPORTER_EOF )
         return IMPORTER_EOF;
     lsmash_ac3_specific_parameters_t *param = &info->dac3_param;
-    uint32_t frame_size = ac3_frame_size_table[ param->frmsizecod >> 1 ][ param->fscod ];
-    if( param->fscod == 0x1 && param->frmsizecod & 0x1 )
-        frame_size += 2;
+    uint32_t frame_size = ac3_get_frame_size( param->fscod, param->frmsizecod );
     if( current_status == IMPORTER_CHANGE )
     {
         lsmash_codec_specific_t *cs = isom_get_codec_specific( summary->opaque, LSMASH_CODEC_SPECIFIC_DATA_TYPE_ISOM_AUDIO_AC_3 );
@@ -200,43 +221,61 @@ static int ac3_importer_get_accessunit( importer_t *importer, uint32_t track_num
     lsmash_bs_t *bs = info->bits->bs;
     ac3_imp->next_frame_pos += frame_size;
     lsmash_bs_read_seek( bs, ac3_imp->next_frame_pos, SEEK_SET );
-    uint8_t syncword[2] =
+    lsmash_ac3_specific_parameters_t current_param = info->dac3_param;
+    while( 1 )
     {
-        lsmash_bs_show_byte( bs, 0 ),
-        lsmash_bs_show_byte( bs, 1 )
-    };
-    if( bs->eob || (bs->eof && 0 == lsmash_bs_get_remaining_buffer_size( bs )) )
-        importer->status = IMPORTER_EOF;
-    else
-    {
-        /* Parse the next syncframe header. */
-        if( syncword[0] != 0x0b
-         || syncword[1] != 0x77
-         || ac3_buffer_frame( ac3_imp->buffer, bs ) < 0 )
+        uint8_t syncword[2] =
         {
-            importer->status = IMPORTER_ERROR;
+            lsmash_bs_show_byte( bs, 0 ),
+            lsmash_bs_show_byte( bs, 1 )
+        };
+        if( bs->eob || (bs->eof && 0 == lsmash_bs_get_remaining_buffer_size( bs )) )
+        {
+            importer->status = IMPORTER_EOF;
             return current_status;
         }
-        lsmash_ac3_specific_parameters_t current_param = info->dac3_param;
-        ac3_parse_syncframe_header( info );
-        if( ac3_compare_specific_param( &current_param, &info->dac3_param ) )
+        /* Parse the next syncframe header. */
+        if( syncword[0] == 0x0b
+         && syncword[1] == 0x77 )
         {
-            uint32_t dummy;
-            uint8_t *dac3 = lsmash_create_ac3_specific_info( &info->dac3_param, &dummy );
-            if( !dac3 )
+            if( ac3_buffer_frame( ac3_imp->buffer, bs ) < 0 )
             {
                 importer->status = IMPORTER_ERROR;
                 return current_status;
             }
-            ac3_imp->next_dac3 = dac3;
-            importer->status = IMPORTER_CHANGE;
+            if( ac3_parse_syncframe_header( info ) == 0 )
+                break;
         }
-        else
-            importer->status = IMPORTER_OK;
+        int err = lsmash_importer_resync( importer, &ac3_sync, ac3_imp->next_frame_pos );
+        if( err < 0 )
+        {
+            importer->status = err == LSMASH_ERR_INVALID_DATA ? IMPORTER_EOF : IMPORTER_ERROR;
+            return current_status;
+        }
+        ac3_imp->next_frame_pos = lsmash_bs_get_stream_pos( bs );
     }
+    if( ac3_compare_specific_param( &current_param, &info->dac3_param ) )
+    {
+        uint32_t dummy;
+        uint8_t *dac3 = lsmash_create_ac3_specific_info( &info->dac3_param, &dummy );
+        if( !dac3 )
+        {
+            importer->status = IMPORTER_ERROR;
+            return current_status;
+        }
+        ac3_imp->next_dac3 = dac3;
+        importer->status = IMPORTER_CHANGE;
+    }
+    else
+        importer->status = IMPORTER_OK;
     return current_status;
 }
 
+static int ac3_importer_detect( importer_t *importer, const uint8_t *data, uint64_t size, int eof )
+{
+    return lsmash_importer_detect_syncframe( importer, &ac3_sync, data, size, eof );
+}
+
 static int ac3_importer_probe( importer_t *importer )
 {
     ac3_importer_t *ac3_imp = create_ac3_importer( importer );
@@ -247,6 +286,9 @@ static int ac3_importer_probe( importer_t *importer )
     bs->buffer.max_size = AC3_MAX_SYNCFRAME_LENGTH;
     /* Check the syncword and parse the syncframe header */
     int err;
+    if( (err = lsmash_importer_skip_leading_garbage( importer, &ac3_sync )) < 0 )
+        goto fail;
+    ac3_imp->next_frame_pos = lsmash_bs_get_stream_pos( bs );
     if( lsmash_bs_show_byte( bs, 0 ) != 0x0b
      || lsmash_bs_show_byte( bs, 1 ) != 0x77 )
     {
@@ -289,8 +331,9 @@ static uint32_t ac3_importer_get_last_delta( importer_t *importer, uint32_t trac
 
 const importer_functions ac3_importer =
 {
-    { "AC-3" },
+    { "AC-3", offsetof( importer_t, log_level ) },
     1,
+    ac3_importer_detect,
     ac3_importer_probe,
     ac3_importer_get_accessunit,
     ac3_importer_get_last_delta,
@@ -303,6 +346,23 @@ const importer_functions ac3_importer =
 ***************************************************************************/
 #define EAC3_MIN_SAMPLE_DURATION 256
 
+static uint32_t eac3_get_syncframe_length( const uint8_t *header )
+{
+    uint8_t  strmtyp = header[2] >> 6;                          /* syncword (16), strmtyp (2) */
+    uint16_t frmsiz  = ((header[2] & 0x07) << 8) | header[3];  /* substreamid (3), frmsiz (11) */
+    uint8_t  fscod   = header[4] >> 6;                          /* fscod (2) */
+    uint8_t  fscod2  = (header[4] >> 4) & 0x03;                 /* fscod2 or numblkscod (2) */
+    uint8_t  bsid    = header[5] >> 3;                          /* acmod (3), lfeon (1), bsid (5) */
+    if( strmtyp == 0x3 || (fscod == 0x3 && fscod2 == 0x3) || bsid < 10 || bsid > 16 )
+        return 0;
+    return (frmsiz + 1) * 2;
+}
+
+static const importer_sync_t eac3_sync =
+{
+    { 0x0B770000 }, { 0xFFFF0000 }, 1, 6, EAC3_MAX_SYNCFRAME_LENGTH, eac3_get_syncframe_length
+};
+
 typedef struct
 {
     eac3_info_t info;
@@ -412,25 +472,32 @@ static int eac3_importer_get_next_accessunit_internal( importer_t *importer )
         }
         else
         {
-            /* Check the syncword. */
+            /* Check the syncword and parse syncframe.
+             * Once the stream has been detected, resynchronise with the next syncframe if broken. */
+            lsmash_log_level level = eac3_imp->au_number ? LSMASH_LOG_WARNING : LSMASH_LOG_ERROR;
+            info->frame_size = 0;
+            int err = LSMASH_ERR_INVALID_DATA;
             if( lsmash_bs_show_byte( bs, 0 ) != 0x0b
              || lsmash_bs_show_byte( bs, 1 ) != 0x77 )
+                lsmash_log( importer, level, "a syncword is not found.\n" );
+            else if( (err = eac3_parse_syncframe( info )) < 0 )
+                lsmash_log( importer, level, "failed to parse syncframe.\n" );
+            else if( remain_size < info->frame_size )
             {
-                lsmash_log( importer, LSMASH_LOG_ERROR, "a syncword is not found.\n" );
-                return LSMASH_ERR_INVALID_DATA;
+                lsmash_log( importer, level, "a frame is truncated.\n" );
+                err = LSMASH_ERR_INVALID_DATA;
             }
-            /* Parse syncframe. */
-            info->frame_size = 0;
-            int err = eac3_parse_syncframe( info );
             if( err < 0 )
             {
-                lsmash_log( importer, LSMASH_LOG_ERROR, "failed to parse syncframe.\n" );
-                return err;
-            }
-            if( remain_size < info->frame_size )
-            {
-                lsmash_log( importer, LSMASH_LOG_ERROR, "a frame is truncated.\n" );
-                return LSMASH_ERR_INVALID_DATA;
+                if( eac3_imp->au_number == 0 )
+                    return err;
+                if( (err = lsmash_importer_resync( importer, &eac3_sync, eac3_imp->next_frame_pos )) < 0
+                 && err != LSMASH_ERR_INVALID_DATA )
+                    return err;
+                /* If no more syncframes are found, the stream is regarded as ending at here. */
+                eac3_imp->next_frame_pos = lsmash_bs_get_stream_pos( bs );
+                info->frame_size = 0;
+                continue;
             }
             int independent = info->strmtyp != 0x1;
             if( independent && info->substreamid == 0x0 )
@@ -600,6 +667,11 @@ static lsmash_audio_summary_t *eac3_create_summary( eac3_importer_t *eac3_imp )
     return summary;
 }
 
+static int eac3_importer_detect( importer_t *importer, const uint8_t *data, uint64_t size, int eof )
+{
+    return lsmash_importer_detect_syncframe( importer, &eac3_sync, data, size, eof );
+}
+
 static int eac3_importer_probe( importer_t *importer )
 {
     eac3_importer_t *eac3_imp = create_eac3_importer( importer );
@@ -609,8 +681,11 @@ static int eac3_importer_probe( importer_t *importer )
     lsmash_bs_t   *bs   = bits->bs;
     bs->buffer.max_size = EAC3_MAX_SYNCFRAME_LENGTH;
     importer->info = eac3_imp;
-    int err = eac3_importer_get_next_accessunit_internal( importer );
-    if( err < 0 )
+    int err;
+    if( (err = lsmash_importer_skip_leading_garbage( importer, &eac3_sync )) < 0 )
+        goto fail;
+    eac3_imp->next_frame_pos = lsmash_bs_get_stream_pos( bs );
+    if( (err = eac3_importer_get_next_accessunit_internal( importer )) < 0 )
         goto fail;
     lsmash_audio_summary_t *summary = eac3_create_summary( eac3_imp );
     if( !summary )
@@ -648,6 +723,7 @@ const importer_functions eac3_importer =
 {
     { "Enhanced AC-3", offsetof( importer_t, log_level ) },
     1,
+    eac3_importer_detect,
     eac3_importer_probe,
     eac3_importer_get_accessunit,
     eac3_importer_get_last_delta,
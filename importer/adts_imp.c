@@ -98,7 +98,7 @@ static void mp4sys_adts_cleanup( importer_t *importer )
 
 static void mp4sys_adts_parse_fixed_header
 (
-    uint8_t                    *buf,
+    const uint8_t              *buf,
     mp4sys_adts_fixed_header_t *header
 )
 {
@@ -131,6 +131,27 @@ static int mp4sys_adts_check_fixed_header
     return 0;
 }
 
+static uint32_t mp4sys_adts_get_syncframe_length
+(
+    const uint8_t *header
+)
+{
+    mp4sys_adts_fixed_header_t fixed_header;
+    mp4sys_adts_parse_fixed_header( header, &fixed_header );
+    if( mp4sys_adts_check_fixed_header( &fixed_header ) < 0 )
+        return 0;
+    uint32_t frame_length = ((header[3] << 11) | (header[4] << 3) | (header[5] >> 5)) & 0x1FFF;
+    if( frame_length <= MP4SYS_ADTS_BASIC_HEADER_LENGTH + 2 * (fixed_header.protection_absent == 0) )
+        return 0;
+    return frame_length;
+}
+
+/* Only the syncword and the layer are generic over ADTS streams. */
+static const importer_sync_t mp4sys_adts_sync =
+{
+    { 0xFFF00000 }, { 0xFFF60000 }, 1, MP4SYS_ADTS_BASIC_HEADER_LENGTH, MP4SYS_ADTS_MAX_FRAME_LENGTH, mp4sys_adts_get_syncframe_length
+};
+
 static int mp4sys_adts_parse_variable_header
 (
     lsmash_bs_t                   *bs,
@@ -368,18 +389,6 @@ static int mp4sys_adts_get_accessunit
 
     /* preparation for next frame */
 
-    uint8_t buf[MP4SYS_ADTS_MAX_FRAME_LENGTH];
-    int64_t ret = lsmash_bs_get_bytes_ex( bs, MP4SYS_ADTS_BASIC_HEADER_LENGTH, buf );
-    if( ret == 0 )
-    {
-        importer->status = IMPORTER_EOF;
-        return 0;
-    }
-    if( ret != MP4SYS_ADTS_BASIC_HEADER_LENGTH )
-    {
-        importer->status = IMPORTER_ERROR;
-        return 0;
-    }
     /*
      * NOTE: About the spec of ADTS headers.
      * By the spec definition, ADTS's fixed header cannot change in the middle of stream.
@@ -400,12 +409,39 @@ static int mp4sys_adts_get_accessunit
      * But then we have to cache and memcpy every frame so that it requires more clocks and memory.
      * To avoid them, I adopted this separate retrieving method.
      */
+    /*
+     * NOTE: About broken or lost frames.
+     * Broadcast captures may contain garbage instead of frames.
+     * We search for the next frame whose fixed header agrees with this stream, and skip the garbage.
+     */
+    uint8_t buf[MP4SYS_ADTS_MAX_FRAME_LENGTH];
     mp4sys_adts_fixed_header_t header = { 0 };
     mp4sys_adts_variable_header_t variable_header = { 0 };
-    if( mp4sys_adts_parse_headers( bs, buf, &header, &variable_header ) < 0 )
+    while( 1 )
     {
-        importer->status = IMPORTER_ERROR;
-        return 0;
+        uint64_t header_pos = lsmash_bs_get_stream_pos( bs );
+        int64_t ret = lsmash_bs_get_bytes_ex( bs, MP4SYS_ADTS_BASIC_HEADER_LENGTH, buf );
+        if( ret == 0 )
+        {
+            importer->status = IMPORTER_EOF;
+            return 0;
+        }
+        if( ret == MP4SYS_ADTS_BASIC_HEADER_LENGTH
+         && mp4sys_adts_parse_headers( bs, buf, &header, &variable_header ) == 0 )
+            break;
+        importer_sync_t sync = mp4sys_adts_sync;
+        sync.syncword[0] = 0xFFF00000
+                         | (adts_imp->header.ID                       << 19)
+                         | (adts_imp->header.layer                    << 17)
+                         | (adts_imp->header.profile_ObjectType       << 14)
+                         | (adts_imp->header.sampling_frequency_index << 10);
+        sync.mask    [0] = 0xFFFEFC00;  /* except for protection_absent, private_bit and channel_configuration */
+        int err = lsmash_importer_resync( importer, &sync, header_pos );
+        if( err < 0 )
+        {
+            importer->status = err == LSMASH_ERR_INVALID_DATA ? IMPORTER_EOF : IMPORTER_ERROR;
+            return 0;
+        }
     }
     adts_imp->variable_header = variable_header;
     /*
@@ -453,6 +489,18 @@ static int mp4sys_adts_get_accessunit
     return 0;
 }
 
+/* Score the stream by the chain of ADTS frames. */
+static int mp4sys_adts_detect
+(
+    importer_t    *importer,
+    const uint8_t *data,
+    uint64_t       size,
+    int            eof
+)
+{
+    return lsmash_importer_detect_syncframe( importer, &mp4sys_adts_sync, data, size, eof );
+}
+
 /* returns 0 if it seems adts. */
 static int mp4sys_adts_probe
 (
@@ -463,6 +511,8 @@ static int mp4sys_adts_probe
     if( !adts_imp )
         return LSMASH_ERR_MEMORY_ALLOC;
     int err;
+    if( (err = lsmash_importer_skip_leading_garbage( importer, &mp4sys_adts_sync )) < 0 )
+        goto fail;
     uint8_t buf[MP4SYS_ADTS_MAX_FRAME_LENGTH];
     if( lsmash_bs_get_bytes_ex( importer->bs, MP4SYS_ADTS_BASIC_HEADER_LENGTH, buf ) != MP4SYS_ADTS_BASIC_HEADER_LENGTH )
     {
@@ -515,8 +565,9 @@ static uint32_t mp4sys_adts_get_last_delta
 
 const importer_functions mp4sys_adts_importer =
 {
-    { "adts" },
+    { "adts", offsetof( importer_t, log_level ) },
     1,
+    mp4sys_adts_detect,
     mp4sys_adts_probe,
     mp4sys_adts_get_accessunit,
     mp4sys_adts_get_last_delta,
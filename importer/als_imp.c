@@ -328,6 +328,12 @@ fail:
     return NULL;
 }
 
+static int mp4a_als_importer_detect( importer_t *importer, const uint8_t *data, uint64_t size, int eof )
+{
+    /* ALS identifier */
+    return size >= 4 && LSMASH_GET_BE32( data ) == 0x414C5300 ? IMPORTER_DETECT_SCORE_MAX : 0;
+}
+
 static int mp4a_als_importer_probe( importer_t *importer )
 {
     mp4a_als_importer_t *als_imp = create_mp4a_als_importer( importer );
@@ -376,6 +382,7 @@ const importer_functions mp4a_als_importer =
 {
     { "MPEG-4 ALS", offsetof( importer_t, log_level ) },
     1,
+    mp4a_als_importer_detect,
     mp4a_als_importer_probe,
     mp4a_als_importer_get_accessunit,
     mp4a_als_importer_get_last_delta,
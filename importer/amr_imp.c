@@ -230,6 +230,20 @@ static lsmash_audio_summary_t *amr_create_summary
     return summary;
 }
 
+static int amr_detect
+(
+    importer_t    *importer,
+    const uint8_t *data,
+    uint64_t       size,
+    int            eof
+)
+{
+    if( (size >= 6 && !memcmp( data, "#!AMR\n",    6 ))
+     || (size >= 9 && !memcmp( data, "#!AMR-WB\n", 9 )) )
+        return IMPORTER_DETECT_SCORE_MAX;
+    return 0;
+}
+
 static int amr_probe
 (
     importer_t *importer
@@ -281,6 +295,7 @@ const importer_functions amr_importer =
 {
     { "AMR", offsetof( importer_t, log_level ) },
     1,
+    amr_detect,
     amr_probe,
     amr_get_accessunit,
     amr_get_last_delta,
@@ -48,6 +48,37 @@ typedef struct
     uint32_t au_number;
 } dts_importer_t;
 
+static uint32_t dts_get_syncframe_length( const uint8_t *header )
+{
+    if( LSMASH_GET_BE32( header ) == 0x7FFE8001 )
+    {
+        /* FTYPE (1), SHORT (5), CPF (1), NBLKS (7), FSIZE (14) */
+        uint32_t nblks = (((header[4] & 0x01) << 6) | (header[5] >> 2)) + 1;
+        uint32_t fsize = (((header[5] & 0x03) << 12) | (header[6] << 4) | (header[7] >> 4)) + 1;
+        return nblks > 5 && fsize >= 96 ? fsize : 0;
+    }
+    /* UserDefinedBits (8), nExtSSIndex (2), bHeaderSizeType (1), nuExtSSHeaderSize (8 or 12), nuExtSSFsize (16 or 20) */
+    uint32_t header_size;
+    uint32_t fsize;
+    if( header[5] & 0x20 )
+    {
+        header_size = (((header[5] & 0x1F) << 7) | (header[6] >> 1)) + 1;
+        fsize       = (((header[6] & 0x01) << 19) | (header[7] << 11) | (header[8] << 3) | (header[9] >> 5)) + 1;
+    }
+    else
+    {
+        header_size = (((header[5] & 0x1F) << 3) | (header[6] >> 5)) + 1;
+        fsize       = (((header[6] & 0x1F) << 11) | (header[7] << 3) | (header[8] >> 5)) + 1;
+    }
+    return fsize >= 10 && fsize >= header_size ? fsize : 0;
+}
+
+/* the syncwords of the core substream (SYNC) and the extension substream (SYNCEXTSSH) */
+static const importer_sync_t dts_sync =
+{
+    { 0x7FFE8001, 0x64582025 }, { 0xFFFFFFFF, 0xFFFFFFFF }, 2, 10, DTS_MAX_EXSS_SIZE, dts_get_syncframe_length
+};
+
 static void remove_dts_importer( dts_importer_t *dts_imp )
 {
     if( !dts_imp )
@@ -136,10 +167,13 @@ static int dts_importer_get_next_accessunit_internal( importer_t *importer )
         }
         else
         {
-            /* Parse substream frame. */
+            /* Parse substream frame.
+             * Once the stream has been detected, resynchronise with the next frame if broken. */
             dts_substream_type prev_substream_type = info->substream_type;
+            uint8_t            prev_exss_index     = info->exss_index;
+            lsmash_log_level   level               = dts_imp->au_number ? LSMASH_LOG_WARNING : LSMASH_LOG_ERROR;
             info->substream_type = dts_get_substream_type( info );
-            int err;
+            int err = 0;
             int (*dts_parse_frame)( dts_info_t * ) = NULL;
             switch( info->substream_type )
             {
@@ -150,30 +184,43 @@ static int dts_importer_get_next_accessunit_internal( importer_t *importer )
                     dts_parse_frame = dts_parse_core_substream;
                     break;
                 case DTS_SUBSTREAM_TYPE_EXTENSION :
-                {
-                    uint8_t prev_exss_index = info->exss_index;
                     if( (err = dts_get_exss_index( info, &info->exss_index )) < 0 )
                     {
-                        lsmash_log( importer, LSMASH_LOG_ERROR, "failed to get the index of an extension substream.\n" );
-                        return err;
+                        lsmash_log( importer, level, "failed to get the index of an extension substream.\n" );
+                        break;
                     }
                     if( prev_substream_type == DTS_SUBSTREAM_TYPE_EXTENSION
                      && info->exss_index <= prev_exss_index )
                         au_completed = 1;
                     dts_parse_frame = dts_parse_extension_substream;
                     break;
-                }
                 default :
-                    lsmash_log( importer, LSMASH_LOG_ERROR, "unknown substream type is detected.\n" );
-                    return LSMASH_ERR_NAMELESS;
+                    lsmash_log( importer, level, "unknown substream type is detected.\n" );
+                    err = LSMASH_ERR_NAMELESS;
+                    break;
             }
-            if( !info->ddts_param_initialized && au_completed )
-                dts_update_specific_param( info );
-            info->frame_size = 0;
-            if( (err = dts_parse_frame( info )) < 0 )
+            if( err == 0 )
             {
-                lsmash_log( importer, LSMASH_LOG_ERROR, "failed to parse a frame.\n" );
-                return err;
+                if( !info->ddts_param_initialized && au_completed )
+                    dts_update_specific_param( info );
+                info->frame_size = 0;
+                if( (err = dts_parse_frame( info )) < 0 )
+                    lsmash_log( importer, level, "failed to parse a frame.\n" );
+            }
+            if( err < 0 )
+            {
+                if( dts_imp->au_number == 0 )
+                    return err;
+                info->substream_type = prev_substream_type;
+                info->exss_index     = prev_exss_index;
+                info->frame_size     = 0;
+                au_completed         = 0;
+                if( (err = lsmash_importer_resync( importer, &dts_sync, dts_imp->next_frame_pos )) < 0
+                 && err != LSMASH_ERR_INVALID_DATA )
+                    return err;
+                /* If no more frames are found, the stream is regarded as ending at here. */
+                dts_imp->next_frame_pos = lsmash_bs_get_stream_pos( bs );
+                continue;
             }
         }
         if( au_completed )
@@ -308,6 +355,11 @@ static lsmash_audio_summary_t *dts_create_summary( dts_info_t *info )
     return summary;
 }
 
+static int dts_importer_detect( importer_t *importer, const uint8_t *data, uint64_t size, int eof )
+{
+    return lsmash_importer_detect_syncframe( importer, &dts_sync, data, size, eof );
+}
+
 static int dts_importer_probe( importer_t *importer )
 {
     dts_importer_t *dts_imp = create_dts_importer( importer );
@@ -317,8 +369,11 @@ static int dts_importer_probe( importer_t *importer )
     lsmash_bs_t   *bs   = bits->bs;
     bs->buffer.max_size = DTS_MAX_EXSS_SIZE;
     importer->info = dts_imp;
-    int err = dts_importer_get_next_accessunit_internal( importer );
-    if( err < 0 )
+    int err;
+    if( (err = lsmash_importer_skip_leading_garbage( importer, &dts_sync )) < 0 )
+        goto fail;
+    dts_imp->next_frame_pos = lsmash_bs_get_stream_pos( bs );
+    if( (err = dts_importer_get_next_accessunit_internal( importer )) < 0 )
         goto fail;
     lsmash_audio_summary_t *summary = dts_create_summary( &dts_imp->info );
     if( !summary )
@@ -359,6 +414,7 @@ const importer_functions dts_importer =
 {
     { "DTS Coherent Acoustics", offsetof( importer_t, log_level ) },
     1,
+    dts_importer_detect,
     dts_importer_probe,
     dts_importer_get_accessunit,
     dts_importer_get_last_delta,
@@ -24,6 +24,7 @@
 #include "common/internal.h" /* must be placed first */
 
 #include <string.h>
+#include <inttypes.h>
 
 #define LSMASH_IMPORTER_INTERNAL
 #include "importer.h"
@@ -125,33 +126,108 @@ void lsmash_importer_close( importer_t *importer )
     lsmash_importer_destroy( importer );
 }
 
+static int importer_probe_with_span( importer_t *importer, const importer_functions *funcs )
+{
+    uint64_t start = lsmash_stats_begin_span( LSMASH_TRACE_SPAN_PROBE_IMPORTER, funcs->class.name );
+    int err = funcs->probe( importer );
+    lsmash_stats_end_span( LSMASH_TRACE_SPAN_PROBE_IMPORTER, funcs->class.name, start );
+    return err;
+}
+
+static int importer_seems_box_structure( const uint8_t *data, uint64_t size )
+{
+    if( size < ISOM_BASEBOX_COMMON_SIZE )
+        return 0;
+    uint32_t box_size = LSMASH_GET_BE32( data );
+    if( box_size == 1 || box_size >= ISOM_BASEBOX_COMMON_SIZE )
+    {
+        /* Check if the box type consists of printable characters. */
+        for( uint32_t i = 4; i < ISOM_BASEBOX_COMMON_SIZE; i++ )
+            if( data[i] < 0x20 || data[i] > 0x7E )
+                return 0;
+        return 1;
+    }
+    return 0;
+}
+
+typedef struct
+{
+    const importer_functions *funcs;
+    int                       score;
+} importer_candidate_t;
+
+/* Rank the detectable importers by the signatures in the bytes from the beginning of the stream.
+ * Return the number of the candidates, or a negative value if failed. */
+static int importer_rank_candidates( importer_t *importer, importer_candidate_t *candidates )
+{
+    lsmash_bs_t *bs = importer->bs;
+    lsmash_bs_show_byte( bs, IMPORTER_DETECT_PREFIX_SIZE - 1 );
+    if( bs->error )
+        return LSMASH_ERR_IO;
+    const uint8_t *data = lsmash_bs_get_buffer_data( bs );
+    uint64_t       size = lsmash_bs_get_remaining_buffer_size( bs );
+    /* The importers of syncframes are allowed to skip leading garbage as the last resort
+     * unless the stream seems a box structure since the frames of a stream could be stored in it. */
+    importer->sync_search_limit = importer_seems_box_structure( data, size ) ? 0 : IMPORTER_SYNC_SEARCH_LIMIT;
+    int num_candidates = 0;
+    const importer_functions *funcs;
+    for( int i = 0; (funcs = importer_func_table[i]) != NULL; i++ )
+    {
+        if( !funcs->detectable )
+            continue;
+        importer->class = &funcs->class;
+        int score = funcs->detect( importer, data, size, bs->eof );
+        if( score <= 0 )
+            continue;
+        /* insertion sort keeping the order of the table if tied */
+        int j = num_candidates++;
+        for( ; j > 0 && candidates[j - 1].score < score; j-- )
+            candidates[j] = candidates[j - 1];
+        candidates[j].funcs = funcs;
+        candidates[j].score = score;
+    }
+    return num_candidates;
+}
+
 int lsmash_importer_find( importer_t *importer, const char *format, int auto_detect )
 {
     importer->log_level = LSMASH_LOG_QUIET; /* Any error log is confusing for the probe step. */
-    const importer_functions *funcs;
+    const importer_functions *funcs = NULL;
     int err = LSMASH_ERR_NAMELESS;
     if( auto_detect )
     {
-        /* just rely on detector. */
-        for( int i = 0; (funcs = importer_func_table[i]) != NULL; i++ )
+        /* just rely on detector.
+         * First, rank the candidates by the cheap signature detection over the bytes shared by all the detectors.
+         * Then, probe the candidates in the ranked order until one of them succeeds so that the streams of
+         * the other formats don't pay for the probes requiring more bytes, e.g. the whole stream analysis. */
+        importer_candidate_t candidates[sizeof(importer_func_table) / sizeof(importer_func_table[0])];
+        int num_candidates = importer_rank_candidates( importer, candidates );
+        if( num_candidates < 0 )
+            err = num_candidates;
+        for( int i = 0; i < num_candidates; i++ )
         {
-            importer->class = &funcs->class;
-            if( !funcs->detectable )
-                continue;
-            if( (err = funcs->probe( importer )) == 0
-             || lsmash_bs_read_seek( importer->bs, 0, SEEK_SET ) != 0 )
+            importer->class = &candidates[i].funcs->class;
+            importer->sync_search_limit = candidates[i].score == IMPORTER_DETECT_SCORE_GARBAGE ? IMPORTER_SYNC_SEARCH_LIMIT : 0;
+            if( (err = importer_probe_with_span( importer, candidates[i].funcs )) == 0 )
+            {
+                funcs = candidates[i].funcs;
+                break;
+            }
+            if( lsmash_bs_read_seek( importer->bs, 0, SEEK_SET ) != 0 )
                 break;
         }
     }
     else
     {
-        /* needs name matching. */
+        /* needs name matching.
+         * The importers of syncframes may skip leading garbage, e.g. a broadcast capture starting in the middle of a frame. */
+        importer->sync_search_limit = IMPORTER_SYNC_SEARCH_LIMIT;
         for( int i = 0; (funcs = importer_func_table[i]) != NULL; i++ )
         {
             importer->class = &funcs->class;
             if( strcmp( importer->class->name, format ) )
                 continue;
-            if( (err = funcs->probe( importer )) < 0 )
+            if( (err = importer_probe_with_span( importer, funcs )) < 0 )
                 funcs = NULL;
             break;
         }
@@ -217,6 +293,24 @@ int lsmash_importer_get_access_unit( importer_t *importer, uint32_t track_number
     return importer->funcs.get_accessunit( importer, track_number, p_sample );
 }
 
+int lsmash_importer_get_access_unit_info( importer_t *importer, uint32_t track_number, lsmash_sample_t *info, uint32_t count )
+{
+    if( !importer || !info )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    if( !importer->funcs.get_accessunit_info )
+        return LSMASH_ERR_PATCH_WELCOME;
+    return importer->funcs.get_accessunit_info( importer, track_number, info, count );
+}
+
+int lsmash_importer_set_lpcm_format( importer_t *importer, uint32_t track_number, lsmash_codec_type_t sample_type )
+{
+    if( !importer )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    if( !importer->funcs.set_lpcm_format )
+        return LSMASH_ERR_PATCH_WELCOME;
+    return importer->funcs.set_lpcm_format( importer, track_number, sample_type );
+}
+
 /* Return 0 if failed, otherwise succeeded. */
 uint32_t lsmash_importer_get_last_delta( importer_t *importer, uint32_t track_number )
 {
@@ -321,3 +415,169 @@ void lsmash_importer_break_fake_movie( importer_t *importer )
         return;
     isom_remove_box_by_itself( importer->file->moov );
 }
+
+/******** syncword scanner ********/
+static uint64_t importer_find_byte( const uint8_t *data, uint64_t pos, uint64_t end, uint8_t byte )
+{
+    const uint8_t *p = memchr( data + pos, byte, end - pos );
+    return p ? (uint64_t)(p - data) : end;
+}
+
+static int importer_match_syncword( const importer_sync_t *sync, const uint8_t *header )
+{
+    uint32_t word = LSMASH_GET_BE32( header );
+    for( int i = 0; i < sync->num_syncwords; i++ )
+        if( (word & sync->mask[i]) == sync->syncword[i] )
+            return 1;
+    return 0;
+}
+
+static int importer_check_syncframe_chain( const importer_sync_t *sync, const uint8_t *data, uint64_t size, int eof, int chain_length )
+{
+    uint64_t pos = 0;
+    for( int i = 0; i < chain_length; i++ )
+    {
+        if( pos + sync->header_length > size )
+            return eof && i > 0;
+        if( !importer_match_syncword( sync, data + pos ) )
+            return 0;
+        uint32_t frame_length = sync->get_frame_length( data + pos );
+        if( frame_length < sync->header_length
+         || frame_length > sync->max_frame_length )
+            return 0;
+        pos += frame_length;
+    }
+    return 1;
+}
+
+/* Return the offset of the first genuine syncframe starting within 'scan_size' bytes of the buffer, or 'scan_size' if not found.
+ * Candidates are found by the first byte of the syncwords since memchr() is vectorised in most C libraries. */
+static uint64_t importer_scan_syncframe( const importer_sync_t *sync, const uint8_t *data, uint64_t size, uint64_t scan_size,
+                                         int eof, int chain_length )
+{
+    uint64_t next[IMPORTER_MAX_NUM_SYNCWORDS];
+    for( int i = 0; i < sync->num_syncwords; i++ )
+        next[i] = importer_find_byte( data, 0, scan_size, sync->syncword[i] >> 24 );
+    while( 1 )
+    {
+        uint64_t pos = scan_size;
+        for( int i = 0; i < sync->num_syncwords; i++ )
+            pos = LSMASH_MIN( pos, next[i] );
+        if( pos == scan_size
+         || importer_check_syncframe_chain( sync, data + pos, size - pos, eof, chain_length ) )
+            return pos;
+        for( int i = 0; i < sync->num_syncwords; i++ )
+            if( next[i] == pos )
+                next[i] = importer_find_byte( data, pos + 1, scan_size, sync->syncword[i] >> 24 );
+    }
+}
+
+int64_t lsmash_importer_find_syncframe( lsmash_bs_t *bs, const importer_sync_t *sync, int chain_length, uint64_t limit )
+{
+    /* Keep enough bytes in the buffer to check the chain of syncframes from any candidate.
+     * Buffer at least twice as many bytes so as to scan no fewer bytes than the lookahead at a time. */
+    uint32_t lookahead = chain_length * sync->max_frame_length + sync->header_length;
+    uint64_t skipped   = 0;
+    while( 1 )
+    {
+        lsmash_bs_show_byte( bs, 2 * lookahead - 1 );
+        if( bs->error )
+            return LSMASH_ERR_NAMELESS;
+        const uint8_t *data = lsmash_bs_get_buffer_data( bs );
+        uint64_t size = lsmash_bs_get_remaining_buffer_size( bs );
+        uint64_t scan_size;
+        if( bs->eof )
+            scan_size = size >= sync->header_length ? size - sync->header_length + 1 : 0;
+        else
+            scan_size = size - lookahead + 1;
+        if( scan_size && scan_size - 1 > limit - skipped )
+            scan_size = limit - skipped + 1;
+        uint64_t pos = importer_scan_syncframe( sync, data, size, scan_size, bs->eof, chain_length );
+        if( pos < scan_size )
+        {
+            lsmash_bs_skip_bytes_64( bs, pos );
+            return skipped + pos;
+        }
+        if( bs->eof )
+        {
+            /* No more syncframes in the stream. */
+            lsmash_bs_skip_bytes_64( bs, size );
+            return LSMASH_ERR_INVALID_DATA;
+        }
+        lsmash_bs_skip_bytes_64( bs, scan_size );
+        skipped += scan_size;
+        if( skipped > limit )
+            return LSMASH_ERR_INVALID_DATA;
+    }
+}
+
+int lsmash_importer_resync( importer_t *importer, const importer_sync_t *sync, uint64_t lost_pos )
+{
+    lsmash_bs_t *bs = importer->bs;
+    /* Don't find the lost syncframe again. */
+    if( lsmash_bs_read_seek( bs, lost_pos + 1, SEEK_SET ) < 0 )
+        return LSMASH_ERR_NAMELESS;
+    int64_t skipped = lsmash_importer_find_syncframe( bs, sync, IMPORTER_SYNC_CHAIN_LENGTH, UINT64_MAX );
+    if( skipped == LSMASH_ERR_INVALID_DATA )
+        lsmash_log( importer, LSMASH_LOG_WARNING, "no more syncframes are found after %"PRIu64" bytes.\n", lost_pos );
+    else if( skipped >= 0 )
+        lsmash_log( importer, LSMASH_LOG_WARNING, "skipped %"PRIu64" bytes at %"PRIu64" to find the next syncframe.\n",
+                    lsmash_bs_get_stream_pos( bs ) - lost_pos, lost_pos );
+    return skipped < 0 ? (int)skipped : 0;
+}
+
+int lsmash_importer_skip_leading_garbage( importer_t *importer, const importer_sync_t *sync )
+{
+    if( importer->sync_search_limit == 0 )
+        return 0;
+    int64_t skipped = lsmash_importer_find_syncframe( importer->bs, sync, IMPORTER_SYNC_CHAIN_LENGTH, importer->sync_search_limit );
+    if( skipped < 0 )
+        return (int)skipped;
+    if( skipped > 0 )
+        lsmash_log( importer, LSMASH_LOG_WARNING, "skipped %"PRId64" bytes of leading garbage.\n", skipped );
+    return 0;
+}
+
+int lsmash_importer_detect_syncframe( importer_t *importer, const importer_sync_t *sync, const uint8_t *data, uint64_t size, int eof )
+{
+    /* Score by the number of the consecutive syncframes from the beginning.
+     * The frames reaching the end of the stream are regarded as consecutive. */
+    int      syncword_found = 0;
+    int      count          = 0;
+    uint64_t pos            = 0;
+    while( count < IMPORTER_SYNC_CHAIN_LENGTH )
+    {
+        if( pos + sync->header_length > size )
+        {
+            if( eof && count > 0 )
+                count = IMPORTER_SYNC_CHAIN_LENGTH;
+            break;
+        }
+        if( !importer_match_syncword( sync, data + pos ) )
+            break;
+        syncword_found = 1;
+        uint32_t frame_length = sync->get_frame_length( data + pos );
+        if( frame_length < sync->header_length
+         || frame_length > sync->max_frame_length )
+            break;
+        pos += frame_length;
+        ++count;
+    }
+    if( count > 0 )
+        return 10 + count * 20;
+    if( importer->sync_search_limit )
+    {
+        /* Search the chain of syncframes after leading garbage within the given bytes. */
+        uint64_t lookahead = IMPORTER_SYNC_CHAIN_LENGTH * sync->max_frame_length + sync->header_length;
+        uint64_t scan_size;
+        if( eof )
+            scan_size = size >= sync->header_length ? size - sync->header_length + 1 : 0;
+        else
+            scan_size = size >= lookahead ? size - lookahead + 1 : 0;
+        scan_size = LSMASH_MIN( scan_size, importer->sync_search_limit + 1 );
+        if( importer_scan_syncframe( sync, data, size, scan_size, eof, IMPORTER_SYNC_CHAIN_LENGTH ) < scan_size )
+            return IMPORTER_DETECT_SCORE_GARBAGE;
+    }
+    /* Only the syncword might be there. Let the probe judge it. */
+    return syncword_found ? 10 : 0;
+}
@@ -34,11 +34,14 @@ typedef struct importer_tag importer_t;
 #include "core/box.h"
 #include "codecs/description.h"
 
-typedef void     ( *importer_cleanup )           ( importer_t * );
-typedef int      ( *importer_get_accessunit )    ( importer_t *, uint32_t, lsmash_sample_t ** );
-typedef int      ( *importer_probe )             ( importer_t * );
-typedef uint32_t ( *importer_get_last_duration ) ( importer_t *, uint32_t );
-typedef int      ( *importer_construct_timeline )( importer_t *, uint32_t );
+typedef void     ( *importer_cleanup )            ( importer_t * );
+typedef int      ( *importer_detect )             ( importer_t *, const uint8_t *, uint64_t, int );
+typedef int      ( *importer_get_accessunit )     ( importer_t *, uint32_t, lsmash_sample_t ** );
+typedef int      ( *importer_probe )              ( importer_t * );
+typedef uint32_t ( *importer_get_last_duration )  ( importer_t *, uint32_t );
+typedef int      ( *importer_construct_timeline ) ( importer_t *, uint32_t );
+typedef int      ( *importer_get_accessunit_info )( importer_t *, uint32_t, lsmash_sample_t *, uint32_t );
+typedef int      ( *importer_set_lpcm_format )    ( importer_t *, uint32_t, lsmash_codec_type_t );
 
 typedef enum
 {
@@ -48,15 +51,40 @@ typedef enum
     IMPORTER_EOF    = 2,
 } importer_status;
 
+/* the syncword scanner for the importers of the streams consisting of syncframes */
+#define IMPORTER_MAX_NUM_SYNCWORDS 2
+#define IMPORTER_SYNC_CHAIN_LENGTH 3            /* the number of consecutive frames to regard a syncword as genuine */
+#define IMPORTER_SYNC_SEARCH_LIMIT (1 << 20)    /* the maximum number of leading bytes skipped at the probe step */
+
+typedef struct
+{
+    uint32_t syncword[IMPORTER_MAX_NUM_SYNCWORDS];  /* placed at the most significant bits */
+    uint32_t mask    [IMPORTER_MAX_NUM_SYNCWORDS];  /* The most significant 8 bits shall be set. */
+    int      num_syncwords;
+    uint32_t header_length;                         /* the number of bytes required to get the frame length */
+    uint32_t max_frame_length;
+    uint32_t (*get_frame_length)( const uint8_t *header );  /* Return 0 if the header is invalid. */
+} importer_sync_t;
+
+/* the scores of the signature detection at the first stage of the auto detection
+ * A detector returns 0 only if its probe never succeeds for the stream starting with the given bytes.
+ * The candidates are probed in descending order of the scores, and in the order of the importer table if tied. */
+#define IMPORTER_DETECT_SCORE_MAX     100   /* a magic number unique to the format */
+#define IMPORTER_DETECT_SCORE_GARBAGE 1     /* found only after leading garbage, and probed with importer->sync_search_limit */
+#define IMPORTER_DETECT_PREFIX_SIZE   (IMPORTER_SYNC_SEARCH_LIMIT + (1 << 18))  /* the number of bytes shared by the detectors */
+
 typedef struct
 {
-    lsmash_class_t              class;
-    int                         detectable;
-    importer_probe              probe;
-    importer_get_accessunit     get_accessunit;
-    importer_get_last_duration  get_last_delta;
-    importer_cleanup            cleanup;
-    importer_construct_timeline construct_timeline;
+    lsmash_class_t               class;
+    int                          detectable;
+    importer_detect              detect;                /* required if detectable */
+    importer_probe               probe;
+    importer_get_accessunit      get_accessunit;
+    importer_get_last_duration   get_last_delta;
+    importer_cleanup             cleanup;
+    importer_construct_timeline  construct_timeline;
+    importer_get_accessunit_info get_accessunit_info;   /* optional */
+    importer_set_lpcm_format     set_lpcm_format;       /* optional */
 } importer_functions;
 
 struct importer_tag
@@ -71,6 +99,8 @@ struct importer_tag
     void                    *info;          /* importer internal status information. */
     importer_functions       funcs;
     lsmash_entry_list_t     *summaries;
+    uint64_t                 sync_search_limit; /* the maximum number of leading bytes skippable to find the first syncframe
+                                                 * at the probe step */
     int                      is_adhoc_open; /* If set to 1, it means this importer is not allocated by lsmash_read_file().
                                              * This is a poor design due to historical implementation between the importer
                                              * framework and ISOBMFF demuxer framework. The importer shall be hidden inside
@@ -78,6 +108,51 @@ struct importer_tag
                                              * and the remuxer CLIs. */
 };
 
+/* Search the stream for the first of 'chain_length' consecutive syncframes, starting at the current position.
+ * The frames reaching the end of the stream are regarded as consecutive.
+ * The position is moved to the found syncframe, or past the scanned bytes if not found.
+ * Return the number of the skipped bytes if found within 'limit' bytes.
+ * Return LSMASH_ERR_INVALID_DATA if not found. Otherwise, return a negative value. */
+int64_t lsmash_importer_find_syncframe
+(
+    lsmash_bs_t           *bs,
+    const importer_sync_t *sync,
+    int                    chain_length,
+    uint64_t               limit
+);
+
+/* Resynchronise with the syncframes of the stream after a broken or lost one at 'lost_pos'.
+ * The position is moved to the found syncframe, or the end of the stream if not found.
+ * Return 0 if found.
+ * Return LSMASH_ERR_INVALID_DATA if no more syncframes are found. Otherwise, return a negative value. */
+int lsmash_importer_resync
+(
+    importer_t            *importer,
+    const importer_sync_t *sync,
+    uint64_t               lost_pos
+);
+
+/* Skip garbage ahead of the first syncframe at the probe step within importer->sync_search_limit bytes.
+ * Nothing is done if the limit is 0.
+ * Return 0 if successful. Otherwise, return a negative value. */
+int lsmash_importer_skip_leading_garbage
+(
+    importer_t            *importer,
+    const importer_sync_t *sync
+);
+
+/* Score the stream consisting of syncframes by the chain of syncframes from the beginning of the given bytes.
+ * If no syncframe is there and importer->sync_search_limit is not 0, search the chain within the limit
+ * and return IMPORTER_DETECT_SCORE_GARBAGE if found. */
+int lsmash_importer_detect_syncframe
+(
+    importer_t            *importer,
+    const importer_sync_t *sync,
+    const uint8_t         *data,
+    uint64_t               size,
+    int                    eof
+);
+
 int lsmash_importer_make_fake_movie
 (
     importer_t *importer
@@ -140,6 +215,35 @@ int lsmash_importer_get_access_unit
     lsmash_sample_t **p_sample
 );
 
+/* Get the information of up to 'count' access units following the last one got, without reading their data.
+ * 'info' shall be an array of at least 'count' samples, whose 'data' is set to NULL.
+ * This shares the position in the track with lsmash_importer_get_access_unit().
+ * The access units got at once share the sample description, and a change of it starts the next call
+ * after which the summary of the track describes the new one as if lsmash_importer_get_access_unit() reported the change.
+ * Detect the change by comparing 'index' of the first access unit with the previous one.
+ * Return the number of the access units got if successful; 0 means no more access units.
+ * Return a negative value otherwise, e.g. LSMASH_ERR_PATCH_WELCOME if the importer has no support. */
+int lsmash_importer_get_access_unit_info
+(
+    importer_t      *importer,
+    uint32_t         track_number,
+    lsmash_sample_t *info,
+    uint32_t         count
+);
+
+/* Convert the LPCM samples of a track into the layout of the given QuickTime sample type,
+ * e.g. QT_CODEC_TYPE_TWOS_AUDIO for 16-bit big endian, while getting access units.
+ * The summary of the track is updated to describe the converted samples.
+ * This shall be called before getting any access unit and constructing the timeline of the track.
+ * Return 0 if successful.
+ * Return a negative value otherwise, e.g. LSMASH_ERR_PATCH_WELCOME if the conversion is not supported. */
+int lsmash_importer_set_lpcm_format
+(
+    importer_t         *importer,
+    uint32_t            track_number,
+    lsmash_codec_type_t sample_type
+);
+
 uint32_t lsmash_importer_get_last_delta
 (
     importer_t *importer,
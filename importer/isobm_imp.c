@@ -30,36 +30,38 @@
 /*********************************************************************************
     ISO Base Media File Format (ISOBMFF) / QuickTime File Format (QTFF) importer
 
-    TODO: Make this importer work for multiple tracks.
+    All tracks of the input movie are exposed through one importer instance.
+    The movie is parsed only once, and each track has its own cursor in the
+    shared ROOT.
 **********************************************************************************/
 #include "core/read.h"
 #include "core/timeline.h"
 
 typedef struct
 {
-    uint64_t       timebase;
-    uint32_t       track_ID;
-    uint32_t       current_sample_description_index;
-    uint32_t       au_number;
+    uint64_t timebase;
+    uint32_t track_ID;
+    uint32_t current_sample_description_index;
+    uint32_t au_number;
+} isobm_track_t;
+
+typedef struct
+{
+    isobm_track_t *track;
+    uint32_t       track_count;
 } isobm_importer_t;
 
 static void remove_isobm_importer( isobm_importer_t *isobm_imp )
 {
     if( !isobm_imp )
         return;
+    lsmash_free( isobm_imp->track );
     lsmash_free( isobm_imp );
 }
 
 static isobm_importer_t *create_isobm_importer( importer_t *importer )
 {
-    isobm_importer_t *isobm_imp = (isobm_importer_t *)lsmash_malloc_zero( sizeof(isobm_importer_t) );
-    if( isobm_imp )
-    {
-        isobm_imp->timebase = 1;
-        return isobm_imp;
-    }
-    else
-        return NULL;
+    return (isobm_importer_t *)lsmash_malloc_zero( sizeof(isobm_importer_t) );
 }
 
 static void isobm_importer_cleanup( importer_t *importer )
@@ -68,61 +70,155 @@ static void isobm_importer_cleanup( importer_t *importer )
         remove_isobm_importer( importer->info );
 }
 
+static isobm_track_t *isobm_get_track( isobm_importer_t *isobm_imp, uint32_t track_number )
+{
+    if( !isobm_imp || track_number == 0 || track_number > isobm_imp->track_count )
+        return NULL;
+    return &isobm_imp->track[track_number - 1];
+}
+
+/* Get the information of up to 'count' samples from 'sample_number' without reading their data.
+ * Return the number of the samples got, which is less than 'count' only if the end of the track is reached.
+ * Return a negative value if failed. */
+static int isobm_get_sample_info( lsmash_root_t *root, uint32_t track_ID, uint32_t sample_number, lsmash_sample_t *info, uint32_t count )
+{
+    uint32_t i;
+    for( i = 0; i < count; i++ )
+    {
+        if( lsmash_get_sample_info_from_media_timeline( root, track_ID, sample_number + i, &info[i] ) < 0 )
+        {
+            if( lsmash_check_sample_existence_in_media_timeline( root, track_ID, sample_number + i ) )
+                return LSMASH_ERR_NAMELESS;
+            /* No more samples. */
+            break;
+        }
+        info[i].data = NULL;
+    }
+    return i;
+}
+
+/* Make the summary of the sample description 'index' active in the track. */
+static int isobm_update_summary( importer_t *importer, uint32_t track_number, isobm_track_t *track, uint32_t index )
+{
+    lsmash_entry_t *entry = lsmash_list_get_entry( importer->summaries, track_number );
+    if( !entry )
+        return LSMASH_ERR_NAMELESS;
+    lsmash_summary_t *summary = lsmash_get_summary( importer->root, track->track_ID, index );
+    if( !summary )
+        return LSMASH_ERR_NAMELESS;
+    lsmash_cleanup_summary( entry->data );
+    entry->data = summary;
+    track->current_sample_description_index = index;
+    return 0;
+}
+
 static int isobm_importer_get_accessunit( importer_t *importer, uint32_t track_number, lsmash_sample_t **p_sample )
 {
     if( !importer->info )
         return LSMASH_ERR_NAMELESS;
-    if( track_number != 1 )
+    isobm_importer_t *isobm_imp = (isobm_importer_t *)importer->info;
+    isobm_track_t    *track     = isobm_get_track( isobm_imp, track_number );
+    if( !track )
         return LSMASH_ERR_FUNCTION_PARAM;
-    importer_status current_status = importer->status;
-    if( current_status == IMPORTER_ERROR )
+    if( importer->status == IMPORTER_ERROR )
         return LSMASH_ERR_NAMELESS;
-    if( current_status == IMPORTER_EOF )
+    /* A track whose timeline could not be constructed has no samples to import. */
+    if( track->track_ID == 0 )
         return IMPORTER_EOF;
-    isobm_importer_t *isobm_imp = (isobm_importer_t *)importer->info;
-    lsmash_root_t *root     = importer->root;
-    uint32_t       track_ID = lsmash_get_track_ID( root, track_number );
-    if( track_ID != isobm_imp->track_ID )
-        return LSMASH_ERR_PATCH_WELCOME;
-    lsmash_sample_t *sample = lsmash_get_sample_from_media_timeline( root, track_ID, isobm_imp->au_number + 1 );
+    lsmash_root_t   *root     = importer->root;
+    uint32_t         track_ID = track->track_ID;
+    lsmash_sample_t *sample   = lsmash_get_sample_from_media_timeline( root, track_ID, track->au_number + 1 );
     if( !sample )
     {
-        if( lsmash_check_sample_existence_in_media_timeline( root, track_ID, isobm_imp->au_number + 1 ) )
+        if( lsmash_check_sample_existence_in_media_timeline( root, track_ID, track->au_number + 1 ) )
             return LSMASH_ERR_NAMELESS;
         else
-        {
             /* No more samples. */
-            importer->status = IMPORTER_EOF;
             return IMPORTER_EOF;
-        }
     }
-    sample->dts /= isobm_imp->timebase;
-    sample->cts /= isobm_imp->timebase;
-    if( sample->index != isobm_imp->current_sample_description_index )
+    sample->dts /= track->timebase;
+    sample->cts /= track->timebase;
+    int current_status = IMPORTER_OK;
+    if( sample->index != track->current_sample_description_index )
     {
         /* Update the active summary. */
-        lsmash_summary_t *summary = lsmash_get_summary( root, track_ID, sample->index );
-        if( !summary )
-        {
-            lsmash_delete_sample( sample );
-            return LSMASH_ERR_NAMELESS;
-        }
-        lsmash_list_remove_entry( importer->summaries, track_number );
-        if( lsmash_list_add_entry( importer->summaries, summary ) < 0 )
+        int err = isobm_update_summary( importer, track_number, track, sample->index );
+        if( err < 0 )
         {
             lsmash_delete_sample( sample );
-            lsmash_cleanup_summary( (lsmash_summary_t *)summary );
-            return LSMASH_ERR_MEMORY_ALLOC;
+            return err;
         }
-        isobm_imp->current_sample_description_index = sample->index;
-        importer->status = IMPORTER_OK;
-        current_status   = IMPORTER_CHANGE;
+        current_status = IMPORTER_CHANGE;
     }
     *p_sample = sample;
-    ++ isobm_imp->au_number;
+    ++ track->au_number;
     return current_status;
 }
 
+static int isobm_importer_get_accessunit_info( importer_t *importer, uint32_t track_number, lsmash_sample_t *info, uint32_t count )
+{
+    if( !importer->info )
+        return LSMASH_ERR_NAMELESS;
+    isobm_track_t *track = isobm_get_track( (isobm_importer_t *)importer->info, track_number );
+    if( !track )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    if( importer->status == IMPORTER_ERROR )
+        return LSMASH_ERR_NAMELESS;
+    if( track->track_ID == 0 )
+        return 0;
+    int ret = isobm_get_sample_info( importer->root, track->track_ID, track->au_number + 1, info, count );
+    if( ret <= 0 )
+        return ret;
+    /* Update the active summary as getting the first access unit does, and stop the batch
+     * before a change of the sample description so that all the access units in a batch share the summary. */
+    if( info[0].index != track->current_sample_description_index )
+    {
+        int err = isobm_update_summary( importer, track_number, track, info[0].index );
+        if( err < 0 )
+            return err;
+    }
+    int i;
+    for( i = 0; i < ret && info[i].index == info[0].index; i++ )
+    {
+        info[i].dts /= track->timebase;
+        info[i].cts /= track->timebase;
+    }
+    track->au_number += i;
+    return i;
+}
+
+static int isobm_importer_detect( importer_t *importer, const uint8_t *data, uint64_t size, int eof )
+{
+    if( size < ISOM_BASEBOX_COMMON_SIZE )
+        return 0;
+    uint32_t box_size = LSMASH_GET_BE32( &data[0] );
+    uint32_t box_type = LSMASH_GET_BE32( &data[4] );
+    if( box_size > 1 && box_size < ISOM_BASEBOX_COMMON_SIZE )
+        return 0;
+    switch( box_type )
+    {
+        /* the boxes which usually come first */
+        case LSMASH_4CC( 'f', 't', 'y', 'p' ) :
+        case LSMASH_4CC( 's', 't', 'y', 'p' ) :
+        case LSMASH_4CC( 'm', 'o', 'o', 'v' ) :
+        case LSMASH_4CC( 'm', 'o', 'o', 'f' ) :
+        case LSMASH_4CC( 'm', 'd', 'a', 't' ) :
+        case LSMASH_4CC( 'f', 'r', 'e', 'e' ) :
+        case LSMASH_4CC( 's', 'k', 'i', 'p' ) :
+        case LSMASH_4CC( 'w', 'i', 'd', 'e' ) :
+        case LSMASH_4CC( 's', 'i', 'd', 'x' ) :
+        case LSMASH_4CC( 'p', 'd', 'i', 'n' ) :
+            return IMPORTER_DETECT_SCORE_MAX;
+        default :
+            break;
+    }
+    /* Any box type usually consists of printable characters. */
+    for( int i = 4; i < ISOM_BASEBOX_COMMON_SIZE; i++ )
+        if( data[i] < 0x20 || data[i] > 0x7E )
+            return 0;
+    return 25;
+}
+
 static int isobm_importer_probe( importer_t *importer )
 {
     isobm_importer_t *isobm_imp = create_isobm_importer( importer );
@@ -158,23 +254,49 @@ static int isobm_importer_probe( importer_t *importer )
     if( importer->is_adhoc_open )
     {
         lsmash_root_t *root = importer->root;
-        if( (isobm_imp->track_ID = lsmash_get_track_ID( root, 1 )) == 0 )
+        uint32_t track_count = importer->file->moov->trak_list.entry_count;
+        if( track_count == 0 )
         {
             err = LSMASH_ERR_PATCH_WELCOME;
             goto fail;
         }
-        lsmash_summary_t *summary = lsmash_get_summary( root, isobm_imp->track_ID, 1 );
-        if( (err = lsmash_list_add_entry( importer->summaries, summary )) < 0 )
+        isobm_imp->track = (isobm_track_t *)lsmash_malloc_zero( track_count * sizeof(isobm_track_t) );
+        if( !isobm_imp->track )
+        {
+            err = LSMASH_ERR_MEMORY_ALLOC;
+            goto fail;
+        }
+        /* Expose every track which has a summary of its first sample description.
+         * The others, e.g. tracks of unsupported media types, are skipped. */
+        for( uint32_t track_number = 1; track_number <= track_count; track_number++ )
+        {
+            uint32_t track_ID = lsmash_get_track_ID( root, track_number );
+            if( track_ID == 0 )
+                break;
+            lsmash_summary_t *summary = lsmash_get_summary( root, track_ID, 1 );
+            if( !summary )
+                continue;
+            if( (err = lsmash_list_add_entry( importer->summaries, summary )) < 0 )
+            {
+                lsmash_cleanup_summary( (lsmash_summary_t *)summary );
+                goto fail;
+            }
+            isobm_track_t *track = &isobm_imp->track[ isobm_imp->track_count ++ ];
+            track->timebase                         = 1;
+            track->track_ID                         = track_ID;
+            track->current_sample_description_index = 1;
+        }
+        if( isobm_imp->track_count == 0 )
         {
-            lsmash_cleanup_summary( (lsmash_summary_t *)summary );
+            err = LSMASH_ERR_PATCH_WELCOME;
             goto fail;
         }
-        isobm_imp->current_sample_description_index = 1;
     }
     importer->info   = isobm_imp;
     importer->status = IMPORTER_OK;
     return 0;
 fail:
+    lsmash_list_remove_entries( importer->summaries );
     remove_isobm_importer( isobm_imp );
     return err;
 }
@@ -183,49 +305,71 @@ static uint32_t isobm_importer_get_last_delta( importer_t *importer, uint32_t tr
 {
     debug_if( !importer || !importer->info )
         return 0;
-    isobm_importer_t *isobm_imp = (isobm_importer_t *)importer->info;
-    if( !isobm_imp || track_number != 1 )
+    isobm_track_t *track = isobm_get_track( (isobm_importer_t *)importer->info, track_number );
+    if( !track || track->track_ID == 0 )
         return 0;
     uint32_t last_sample_delta;
-    if( lsmash_get_last_sample_delta_from_media_timeline( importer->root, isobm_imp->track_ID, &last_sample_delta ) < 0 )
+    if( lsmash_get_last_sample_delta_from_media_timeline( importer->root, track->track_ID, &last_sample_delta ) < 0 )
         return 0;
-    return last_sample_delta / isobm_imp->timebase;
+    return last_sample_delta / track->timebase;
 }
 
 static int isobm_importer_construct_timeline( importer_t *importer, uint32_t track_number )
 {
     lsmash_root_t *root = importer->root;
-    uint32_t track_ID = lsmash_get_track_ID( root, track_number );
+    if( !importer->is_adhoc_open )
+        /* Here, the track number is the one in the movie read by lsmash_read_file(). */
+        return isom_timeline_construct( root, lsmash_get_track_ID( root, track_number ) );
+    isobm_track_t *track = isobm_get_track( (isobm_importer_t *)importer->info, track_number );
+    if( !track )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    uint32_t track_ID = track->track_ID;
     int err = isom_timeline_construct( root, track_ID );
     if( err < 0 )
+    {
+        /* This track cannot be imported but the others still can. */
+        track->track_ID = 0;
         return err;
-    if( importer->is_adhoc_open )
+    }
+    lsmash_summary_t *summary = lsmash_list_get_entry_data( importer->summaries, track_number );
+    if( !summary )
+        return LSMASH_ERR_NAMELESS;
+    summary->max_au_length = lsmash_get_max_sample_size_in_media_timeline( root, track_ID );
+    if( summary->summary_type == LSMASH_SUMMARY_TYPE_VIDEO )
     {
-        lsmash_summary_t *summary = lsmash_list_get_entry_data( importer->summaries, track_number );
-        if( !summary )
-            return LSMASH_ERR_NAMELESS;
-        summary->max_au_length = lsmash_get_max_sample_size_in_media_timeline( root, track_ID );
-        if( summary->summary_type == LSMASH_SUMMARY_TYPE_VIDEO )
+        uint32_t last_sample_delta;
+        if( (err = lsmash_get_last_sample_delta_from_media_timeline( root, track_ID, &last_sample_delta )) < 0 )
+            return err;
+        /* The GCD of the differences between adjacent timestamps in ascending order equals the GCD of the differences
+         * from any single timestamp. So, the timebase can be measured in one pass in decoding order, without copying
+         * and sorting the timestamps of the whole track. */
+        lsmash_sample_t info[64];
+        uint64_t first_dts = 0;
+        uint64_t first_cts = 0;
+        track->timebase = last_sample_delta;
+        for( uint32_t sample_number = 1; ; )
         {
-            lsmash_media_ts_list_t ts_list;
-            if( (err = lsmash_get_media_timestamps( root, track_ID, &ts_list )) < 0 )
-                return err;
-            uint32_t last_sample_delta;
-            if( (err = lsmash_get_last_sample_delta_from_media_timeline( root, track_ID, &last_sample_delta )) < 0 )
-                return err;
-            isobm_importer_t *isobm_imp = (isobm_importer_t *)importer->info;
-            isobm_imp->timebase = last_sample_delta;
-            for( uint32_t i = 1; i < ts_list.sample_count; i++ )
-                isobm_imp->timebase = lsmash_get_gcd( isobm_imp->timebase, ts_list.timestamp[i].dts - ts_list.timestamp[i - 1].dts );
-            lsmash_sort_timestamps_composition_order( &ts_list );
-            for( uint32_t i = 1; i < ts_list.sample_count; i++ )
-                isobm_imp->timebase = lsmash_get_gcd( isobm_imp->timebase, ts_list.timestamp[i].cts - ts_list.timestamp[i - 1].cts );
-            lsmash_delete_media_timestamps( &ts_list );
-            if( isobm_imp->timebase == 0 )
-                isobm_imp->timebase = 1;
-            ((lsmash_video_summary_t *)summary)->timebase  = isobm_imp->timebase;
-            ((lsmash_video_summary_t *)summary)->timescale = lsmash_get_media_timescale( root, track_ID );
+            int count = isobm_get_sample_info( root, track_ID, sample_number, info, sizeof(info) / sizeof(info[0]) );
+            if( count < 0 )
+                return count;
+            if( count == 0 )
+                break;
+            if( sample_number == 1 )
+            {
+                first_dts = info[0].dts;
+                first_cts = info[0].cts;
+            }
+            for( int i = 0; i < count; i++ )
+            {
+                track->timebase = lsmash_get_gcd( track->timebase, info[i].dts - first_dts );
+                track->timebase = lsmash_get_gcd( track->timebase, info[i].cts >= first_cts ? info[i].cts - first_cts : first_cts - info[i].cts );
+            }
+            sample_number += count;
         }
+        if( track->timebase == 0 )
+            track->timebase = 1;
+        ((lsmash_video_summary_t *)summary)->timebase  = track->timebase;
+        ((lsmash_video_summary_t *)summary)->timescale = lsmash_get_media_timescale( root, track_ID );
     }
     return 0;
 }
@@ -234,9 +378,11 @@ const importer_functions isobm_importer =
 {
     { "ISOBMFF/QTFF", offsetof( importer_t, log_level ) },
     1,
+    isobm_importer_detect,
     isobm_importer_probe,
     isobm_importer_get_accessunit,
     isobm_importer_get_last_delta,
     isobm_importer_cleanup,
-    isobm_importer_construct_timeline
+    isobm_importer_construct_timeline,
+    isobm_importer_get_accessunit_info
 };
@@ -94,7 +94,7 @@ static void mp4sys_mp3_cleanup( importer_t *importer )
         remove_mp4sys_mp3_importer( importer->info );
 }
 
-static int mp4sys_mp3_parse_header( uint8_t *buf, mp4sys_mp3_header_t *header )
+static int mp4sys_mp3_parse_header( const uint8_t *buf, mp4sys_mp3_header_t *header )
 {
     /* FIXME: should we rewrite these code using bitstream reader? */
     uint32_t data = LSMASH_GET_BE32( buf );
@@ -126,6 +126,59 @@ static const uint32_t mp4sys_mp3_frequency_tbl[2][3] =
     { 44100, 48000, 32000 }  /* MPEG-1 audio */
 };
 
+static const uint32_t mp4sys_mp3_bitrate_tbl[2][3][16] =
+{
+    {   /* MPEG-2 BC audio */
+        { 1,  8, 16, 24,  32,  40,  48,  56,  64,  80,  96, 112, 128, 144, 160, 0 }, /* Layer III */
+        { 1,  8, 16, 24,  32,  40,  48,  56,  64,  80,  96, 112, 128, 144, 160, 0 }, /* Layer II  */
+        { 1, 32, 48, 56,  64,  80,  96, 112, 128, 144, 160, 176, 192, 224, 256, 0 }  /* Layer I   */
+    },
+    {   /* MPEG-1 audio */
+        { 1, 32, 40, 48,  56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320, 0 }, /* Layer III */
+        { 1, 32, 48, 56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320, 384, 0 }, /* Layer II  */
+        { 1, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 }  /* Layer I   */
+    }
+};
+
+/* Return 0 if the frame size is unknown. */
+static uint32_t mp4sys_mp3_get_frame_size( mp4sys_mp3_header_t *header )
+{
+    /* bitrate */
+    uint32_t bitrate = mp4sys_mp3_bitrate_tbl[ header->ID ][ header->layer - 1 ][ header->bitrate_index ];
+    if( bitrate <= 1 )
+        return 0;   /* forbidden or free format */
+    /* sampling frequency */
+    uint32_t frequency = mp4sys_mp3_frequency_tbl[header->ID][header->sampling_frequency];
+    /* frame size */
+    uint32_t frame_size;
+    if( header->layer == MP4SYS_LAYER_I )
+        /* mp1's 'slot' is 4 bytes unit. see 11172-3, Audio Sequence General. */
+        frame_size = (12 * 1000 * bitrate / frequency + header->padding_bit) * 4;
+    else
+    {
+        /* mp2/3's 'slot' is 1 bytes unit. */
+        uint32_t div = frequency;
+        if( header->layer == MP4SYS_LAYER_III && header->ID == 0 )
+            div <<= 1;
+        frame_size = 144 * 1000 * bitrate / div + header->padding_bit;
+    }
+    return frame_size > MP4SYS_MP3_HEADER_LENGTH ? frame_size : 0;
+}
+
+static uint32_t mp4sys_mp3_get_syncframe_length( const uint8_t *buf )
+{
+    mp4sys_mp3_header_t header;
+    if( mp4sys_mp3_parse_header( buf, &header ) < 0 )
+        return 0;
+    return mp4sys_mp3_get_frame_size( &header );
+}
+
+/* Only the syncword and the layer are generic over MPEG-1/2BC audio streams, and the layer 0b00 is reserved. */
+static const importer_sync_t mp4sys_mp3_sync =
+{
+    { 0xFFF00000 }, { 0xFFF00000 }, 1, MP4SYS_MP3_HEADER_LENGTH, MP4SYS_MP3_MAX_FRAME_LENGTH, mp4sys_mp3_get_syncframe_length
+};
+
 static int mp4sys_mp3_samples_in_frame( mp4sys_mp3_header_t *header )
 {
     if( header->layer == MP4SYS_LAYER_I )
@@ -252,43 +305,8 @@ static int mp4sys_mp3_get_accessunit( importer_t *importer, uint32_t track_numbe
     mp4sys_mp3_importer_t *mp3_imp        = (mp4sys_mp3_importer_t *)importer->info;
     mp4sys_mp3_header_t   *header         = (mp4sys_mp3_header_t *)&mp3_imp->header;
     importer_status        current_status = importer->status;
-    /* bitrate */
-    const uint32_t bitrate_tbl[2][3][16] =
-    {
-        {   /* MPEG-2 BC audio */
-            { 1,  8, 16, 24,  32,  40,  48,  56,  64,  80,  96, 112, 128, 144, 160, 0 }, /* Layer III */
-            { 1,  8, 16, 24,  32,  40,  48,  56,  64,  80,  96, 112, 128, 144, 160, 0 }, /* Layer II  */
-            { 1, 32, 48, 56,  64,  80,  96, 112, 128, 144, 160, 176, 192, 224, 256, 0 }  /* Layer I   */
-        },
-        {   /* MPEG-1 audio */
-            { 1, 32, 40, 48,  56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320, 0 }, /* Layer III */
-            { 1, 32, 48, 56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320, 384, 0 }, /* Layer II  */
-            { 1, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 }  /* Layer I   */
-        }
-    };
-    uint32_t bitrate = bitrate_tbl[ header->ID ][ header->layer - 1 ][ header->bitrate_index ];
-    if( bitrate == 0 )
-        return LSMASH_ERR_INVALID_DATA;
-    else if( bitrate == 1 )
-        return LSMASH_ERR_PATCH_WELCOME;    /* free format */
-    /* sampling frequency */
-    uint32_t frequency = mp4sys_mp3_frequency_tbl[header->ID][header->sampling_frequency];
-    if( frequency == 0 )
-        return LSMASH_ERR_NAMELESS;         /* reserved */
-    /* frame size */
-    uint32_t frame_size;
-    if( header->layer == MP4SYS_LAYER_I )
-        /* mp1's 'slot' is 4 bytes unit. see 11172-3, Audio Sequence General. */
-        frame_size = (12 * 1000 * bitrate / frequency + header->padding_bit) * 4;
-    else
-    {
-        /* mp2/3's 'slot' is 1 bytes unit. */
-        uint32_t div = frequency;
-        if( header->layer == MP4SYS_LAYER_III && header->ID == 0 )
-            div <<= 1;
-        frame_size = 144 * 1000 * bitrate / div + header->padding_bit;
-    }
-    if( frame_size <= 4 )
+    uint32_t frame_size = mp4sys_mp3_get_frame_size( header );
+    if( frame_size == 0 )
         return LSMASH_ERR_INVALID_DATA;
     if( current_status == IMPORTER_ERROR )
         return LSMASH_ERR_NAMELESS;
@@ -384,35 +402,41 @@ static int mp4sys_mp3_get_accessunit( importer_t *importer, uint32_t track_numbe
     /* preparation for next frame */
 
     uint8_t buf[MP4SYS_MP3_HEADER_LENGTH];
-    int64_t ret = lsmash_bs_get_bytes_ex( importer->bs, MP4SYS_MP3_HEADER_LENGTH, buf );
-    if( ret == 0 )
-    {
-        importer->status = IMPORTER_EOF;
-        return 0;
-    }
-    if( ret >= 2 && (!memcmp( buf, "TA", 2 ) || !memcmp( buf, "AP", 2 )) )
-    {
-        /* ID3v1 or APE tag */
-        importer->status = IMPORTER_EOF;
-        return 0;
-    }
-    if( ret == 1 && *buf == 0x00 )
-    {
-        /* NOTE: ugly hack for mp1 stream created with SCMPX. */
-        importer->status = IMPORTER_EOF;
-        return 0;
-    }
-    if( ret != MP4SYS_MP3_HEADER_LENGTH )
-    {
-        importer->status = IMPORTER_ERROR;
-        return 0;
-    }
-
     mp4sys_mp3_header_t new_header = { 0 };
-    if( mp4sys_mp3_parse_header( buf, &new_header ) < 0 )
+    while( 1 )
     {
-        importer->status = IMPORTER_ERROR;
-        return 0;
+        uint64_t header_pos = lsmash_bs_get_stream_pos( importer->bs );
+        int64_t ret = lsmash_bs_get_bytes_ex( importer->bs, MP4SYS_MP3_HEADER_LENGTH, buf );
+        if( ret == 0 )
+        {
+            importer->status = IMPORTER_EOF;
+            return 0;
+        }
+        if( ret >= 2 && (!memcmp( buf, "TA", 2 ) || !memcmp( buf, "AP", 2 )) )
+        {
+            /* ID3v1 or APE tag */
+            importer->status = IMPORTER_EOF;
+            return 0;
+        }
+        if( ret == 1 && *buf == 0x00 )
+        {
+            /* NOTE: ugly hack for mp1 stream created with SCMPX. */
+            importer->status = IMPORTER_EOF;
+            return 0;
+        }
+        if( ret == MP4SYS_MP3_HEADER_LENGTH
+         && mp4sys_mp3_parse_header( buf, &new_header ) == 0 )
+            break;
+        /* Skip garbage until the next frame of this stream, of which ID, layer and sampling_frequency shall be unchanged. */
+        importer_sync_t sync = mp4sys_mp3_sync;
+        sync.mask    [0] = 0xFFFE0C00;
+        sync.syncword[0] = LSMASH_GET_BE32( mp3_imp->raw_header ) & sync.mask[0];
+        int err = lsmash_importer_resync( importer, &sync, header_pos );
+        if( err < 0 )
+        {
+            importer->status = err == LSMASH_ERR_INVALID_DATA ? IMPORTER_EOF : IMPORTER_ERROR;
+            return 0;
+        }
     }
     memcpy( mp3_imp->raw_header, buf, MP4SYS_MP3_HEADER_LENGTH );
 
@@ -436,6 +460,27 @@ static int mp4sys_mp3_get_accessunit( importer_t *importer, uint32_t track_numbe
     return 0;
 }
 
+static int mp4sys_mp3_detect( importer_t *importer, const uint8_t *data, uint64_t size, int eof )
+{
+    /* Skip ID3 tags in the same manner as the probe. */
+    uint64_t pos = 0;
+    while( pos + 10 <= size
+        && data[pos] == 'I' && data[pos + 1] == 'D' && data[pos + 2] == '3' )
+    {
+        uint32_t tag_size = 0;
+        for( int i = 6; i < 10; i++ )
+        {
+            tag_size <<= 7;
+            tag_size |= data[pos + i];
+        }
+        pos += 10 + (uint64_t)tag_size;
+    }
+    if( pos > size )
+        /* The ID3 tags are large enough to hide the first frame. */
+        return IMPORTER_DETECT_SCORE_MAX / 2;
+    return lsmash_importer_detect_syncframe( importer, &mp4sys_mp3_sync, data + pos, size - pos, eof );
+}
+
 static int mp4sys_mp3_probe( importer_t *importer )
 {
     mp4sys_mp3_importer_t *mp3_imp = create_mp4sys_mp3_importer( importer );
@@ -458,6 +503,8 @@ static int mp4sys_mp3_probe( importer_t *importer )
     }
     /* Parse the header. */
     int err;
+    if( (err = lsmash_importer_skip_leading_garbage( importer, &mp4sys_mp3_sync )) < 0 )
+        goto fail;
     uint8_t buf[MP4SYS_MP3_HEADER_LENGTH];
     if( lsmash_bs_get_bytes_ex( bs, MP4SYS_MP3_HEADER_LENGTH, buf ) != MP4SYS_MP3_HEADER_LENGTH )
     {
@@ -504,8 +551,9 @@ static uint32_t mp4sys_mp3_get_last_delta( importer_t *importer, uint32_t track_
 
 const importer_functions mp4sys_mp3_importer =
 {
-    { "MPEG-1/2BC Audio Legacy" },
+    { "MPEG-1/2BC Audio Legacy", offsetof( importer_t, log_level ) },
     1,
+    mp4sys_mp3_detect,
     mp4sys_mp3_probe,
     mp4sys_mp3_get_accessunit,
     mp4sys_mp3_get_last_delta,
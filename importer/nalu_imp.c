@@ -25,10 +25,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include <limits.h>
 
 #define LSMASH_IMPORTER_INTERNAL
 #include "importer.h"
 
+#include "common/thread.h"
+
 /***************************************************************************
     H.264 importer
     ITU-T Recommendation H.264 (04/13)
@@ -530,8 +533,9 @@ static void nalu_deduplicate_poc
         /* Encountered a new coded video sequence or no more POCs.
          * Add poc_offset to each POC of the previous coded video sequence. */
         poc_offset -= poc_min;
-        int64_t poc_max = 0;
-        for( uint32_t j = last_poc_reset; j < i + !!npt[i].reset; j++ )
+        int64_t  poc_max = 0;
+        uint32_t cvs_end = i + (i < num_access_units && npt[i].reset);
+        for( uint32_t j = last_poc_reset; j < cvs_end; j++ )
             if( npt[j].poc >= 0 || (j <= last_poc_reset + max_num_reorder_pics) )
             {
                 npt[j].poc += poc_offset;
@@ -544,7 +548,7 @@ static void nalu_deduplicate_poc
             /* Pictures with invalid negative POC is probably supposed to be composited
              * both before the next coded video sequence and after the current one. */
             poc_offset -= invalid_poc_min;
-            for( uint32_t j = invalid_poc_start; j < i + !!npt[i].reset; j++ )
+            for( uint32_t j = invalid_poc_start; j < cvs_end; j++ )
                 if( npt[j].poc < 0 )
                 {
                     npt[j].poc += poc_offset;
@@ -700,6 +704,423 @@ static void nalu_reduce_timescale
 #endif
 }
 
+/* Whole stream analysis by ranges
+ * A range starting with an access unit that carries all the parameter sets ahead of a random access picture
+ * can be analyzed from scratch, i.e. by its own parser state, so the ranges of a large stream are analyzed
+ * concurrently and the results are concatenated in decoding order. Each codec checks whether the results
+ * are the same as the sequential analysis, and the stream is analyzed sequentially if not. */
+#define NALU_ANALYSIS_MIN_RANGE_SIZE        (1 << 21)   /* Smaller ranges don't pay for the threads. */
+#define NALU_ANALYSIS_MAX_NUM_RANGES        64
+#define NALU_ANALYSIS_MAX_NUM_PICTURE_TYPES 16          /* enough for both H.264 and HEVC */
+#define NALU_SPLIT_MAX_NUM_PS               16
+#define NALU_SPLIT_WINDOW_SIZE              (1 << 20)
+
+/* the classes of NAL units to find the split points */
+enum
+{
+    NALU_SPLIT_CLASS_OTHER = 0,
+    NALU_SPLIT_CLASS_PICTURE,           /* a NAL unit after which a non-VCL NAL unit starts a new access unit */
+    NALU_SPLIT_CLASS_RANDOM_ACCESS,     /* a slice of a picture from which decoding starts without any state */
+    NALU_SPLIT_CLASS_PARAMETER_SET,
+    NALU_SPLIT_CLASS_SEI,
+    NALU_SPLIT_CLASS_AUD,
+};
+
+typedef struct
+{
+    nal_pic_timing_t *npt;
+    uint32_t          npt_alloc;    /* in bytes */
+    uint32_t          num_access_units;
+    uint32_t          picture_stats[NALU_ANALYSIS_MAX_NUM_PICTURE_TYPES];
+} nalu_analysis_t;
+
+typedef struct
+{
+    uint64_t pos;                                   /* the position of the start code of the first NAL unit */
+    uint32_t num_ps;                                /* the number of the parameter sets ahead of the first picture */
+    uint64_t ps_pos   [NALU_SPLIT_MAX_NUM_PS];
+    uint32_t ps_length[NALU_SPLIT_MAX_NUM_PS];
+    uint8_t *ps       [NALU_SPLIT_MAX_NUM_PS];
+} nalu_split_t;
+
+/* a stream reading only a range of the stream of the importer by positioned reads */
+typedef struct
+{
+    lsmash_bs_t *src;
+    uint64_t     pos;
+    uint64_t     end;
+} nalu_range_stream_t;
+
+typedef struct nalu_analyzer_tag nalu_analyzer_t;
+
+typedef struct
+{
+    const nalu_analyzer_t *analyzer;
+    importer_t             importer;    /* the importer reading only the range */
+    nalu_range_stream_t    stream;
+    nalu_split_t           split;
+    nalu_analysis_t        analysis;
+    lsmash_thread_t        thread;
+    int                    threaded;
+    int                    err;
+} nalu_analysis_worker_t;
+
+struct nalu_analyzer_tag
+{
+    uint32_t nalu_header_length;
+    int    (*classify_nalu)( const uint8_t *nalu_header );
+    /* Set up importer->info to analyze the stream from the start code at 'sc_head_pos'. */
+    int    (*setup)  ( importer_t *importer, uint64_t sc_head_pos );
+    void   (*cleanup)( importer_t *importer );
+    /* Analyze the access units from the current position to the end of the stream. */
+    int    (*analyze)( importer_t *importer, nalu_analysis_t *analysis );
+    /* Take over the results of the workers in importer->info.
+     * Return 1 if the results are the same as the sequential analysis, 0 if not. */
+    int    (*merge)  ( importer_t *importer, nalu_analysis_worker_t *workers, int num_workers );
+};
+
+static nal_pic_timing_t *nalu_get_next_pic_timing( nalu_analysis_t *analysis )
+{
+    if( analysis->npt_alloc <= analysis->num_access_units * sizeof(nal_pic_timing_t) )
+    {
+        uint32_t alloc = analysis->num_access_units
+                       ? 2 * analysis->num_access_units * sizeof(nal_pic_timing_t)
+                       : (1 << 12) * sizeof(nal_pic_timing_t);
+        nal_pic_timing_t *temp = (nal_pic_timing_t *)lsmash_realloc( analysis->npt, alloc );
+        if( !temp )
+            return NULL;
+        analysis->npt       = temp;
+        analysis->npt_alloc = alloc;
+    }
+    return &analysis->npt[ analysis->num_access_units++ ];
+}
+
+static int nalu_append_analysis( nalu_analysis_t *dst, nalu_analysis_t *src )
+{
+    uint32_t alloc = (dst->num_access_units + src->num_access_units) * sizeof(nal_pic_timing_t);
+    if( dst->npt_alloc < alloc )
+    {
+        nal_pic_timing_t *temp = (nal_pic_timing_t *)lsmash_realloc( dst->npt, alloc );
+        if( !temp )
+            return LSMASH_ERR_MEMORY_ALLOC;
+        dst->npt       = temp;
+        dst->npt_alloc = alloc;
+    }
+    if( src->num_access_units )
+        memcpy( dst->npt + dst->num_access_units, src->npt, src->num_access_units * sizeof(nal_pic_timing_t) );
+    dst->num_access_units += src->num_access_units;
+    for( int i = 0; i < NALU_ANALYSIS_MAX_NUM_PICTURE_TYPES; i++ )
+        dst->picture_stats[i] += src->picture_stats[i];
+    return 0;
+}
+
+static int64_t nalu_pread( lsmash_bs_t *bs, uint8_t *buf, uint64_t size, uint64_t pos )
+{
+    uint64_t done = 0;
+    while( done < size )
+    {
+        int read_size = bs->pread( bs->stream, buf + done, LSMASH_MIN( size - done, INT_MAX ), pos + done );
+        if( read_size < 0 )
+            return LSMASH_ERR_IO;
+        if( read_size == 0 )
+            break;
+        done += read_size;
+    }
+    return done;
+}
+
+static int nalu_range_stream_pread( void *opaque, uint8_t *buf, int size, uint64_t offset )
+{
+    nalu_range_stream_t *stream = (nalu_range_stream_t *)opaque;
+    if( offset >= stream->end )
+        return 0;
+    size = LSMASH_MIN( (uint64_t)size, stream->end - offset );
+    return stream->src->pread( stream->src->stream, buf, size, offset );
+}
+
+static int nalu_range_stream_read( void *opaque, uint8_t *buf, int size )
+{
+    nalu_range_stream_t *stream = (nalu_range_stream_t *)opaque;
+    int read_size = nalu_range_stream_pread( opaque, buf, size, stream->pos );
+    if( read_size > 0 )
+        stream->pos += read_size;
+    return read_size;
+}
+
+static int64_t nalu_range_stream_seek( void *opaque, int64_t offset, int whence )
+{
+    /* The analysis seeks only to the absolute positions. */
+    if( whence != SEEK_SET || offset < 0 )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    ((nalu_range_stream_t *)opaque)->pos = offset;
+    return offset;
+}
+
+/* Find the first split point at or after 'pos' before 'limit', i.e. the start code of the first NAL unit of an access
+ * unit that follows a picture and consists of parameter sets, SEIs and access unit delimiters ahead of a random access
+ * picture. The parameter sets shall precede any SEI so that they are active when parsing the SEIs.
+ * Return 1 if found, 0 if not found. Otherwise, return a negative value. */
+static int nalu_find_split_point
+(
+    lsmash_bs_t           *bs,
+    const nalu_analyzer_t *analyzer,
+    uint8_t               *window,
+    uint64_t               pos,
+    uint64_t               limit,
+    nalu_split_t          *split
+)
+{
+    uint32_t header_length = analyzer->nalu_header_length;
+    uint64_t window_pos    = pos;
+    uint64_t window_size   = 0;
+    uint64_t i             = 0;
+    int      eof           = 0;
+    int      prev_class    = NALU_SPLIT_CLASS_OTHER;
+    int      in_run        = 0;     /* within the leading NAL units of a candidate */
+    int      sei_present   = 0;
+    int      ps_pending    = 0;     /* The length of the last parameter set is unknown yet. */
+    while( 1 )
+    {
+        /* The NAL unit header next to a start code shall be within the window. */
+        if( i + header_length >= window_size )
+        {
+            if( eof )
+                return 0;
+            /* Keep the bytes just before the current position to check the zero bytes preceding 0x01. */
+            if( window_size )
+                window_pos += i - NALU_SHORT_START_CODE_LENGTH;
+            int64_t ret = nalu_pread( bs, window, NALU_SPLIT_WINDOW_SIZE, window_pos );
+            if( ret < 0 )
+                return ret;
+            window_size = ret;
+            eof         = window_size < NALU_SPLIT_WINDOW_SIZE;
+            i           = NALU_SHORT_START_CODE_LENGTH;
+            continue;
+        }
+        uint8_t *p = memchr( window + i, 0x01, window_size - header_length - i );
+        if( !p )
+        {
+            i = window_size - header_length;
+            continue;
+        }
+        i = p - window;
+        if( window[i - 1] || window[i - 2] )
+        {
+            ++i;
+            continue;
+        }
+        /* Found a start code. */
+        uint64_t sc_pos = window_pos + i - 2;
+        if( ps_pending )
+        {
+            /* Any NAL unit has no consecutive zero bytes at the end. */
+            uint64_t end = i - 2;
+            while( end && window[end - 1] == 0x00 )
+                --end;
+            uint64_t ps_length = window_pos + end - split->ps_pos[ split->num_ps ];
+            if( ps_length <= UINT16_MAX )
+                split->ps_length[ split->num_ps++ ] = ps_length;
+            else
+                in_run = 0;     /* never within a decoder configuration record */
+            ps_pending = 0;
+        }
+        int nalu_class = analyzer->classify_nalu( window + i + 1 );
+        if( in_run )
+        {
+            if( nalu_class == NALU_SPLIT_CLASS_RANDOM_ACCESS )
+                return 1;
+            else if( nalu_class == NALU_SPLIT_CLASS_PARAMETER_SET && !sei_present && split->num_ps < NALU_SPLIT_MAX_NUM_PS )
+            {
+                split->ps_pos[ split->num_ps ] = sc_pos + NALU_SHORT_START_CODE_LENGTH;
+                ps_pending = 1;
+            }
+            else if( nalu_class == NALU_SPLIT_CLASS_SEI )
+                sei_present = 1;
+            else if( nalu_class != NALU_SPLIT_CLASS_AUD )
+                in_run = 0;
+        }
+        else if( sc_pos > limit )
+            return 0;
+        else if( (prev_class == NALU_SPLIT_CLASS_PICTURE || prev_class == NALU_SPLIT_CLASS_RANDOM_ACCESS)
+              && (nalu_class == NALU_SPLIT_CLASS_PARAMETER_SET
+               || nalu_class == NALU_SPLIT_CLASS_SEI
+               || nalu_class == NALU_SPLIT_CLASS_AUD)
+              && window[i - 3] == 0x00 )
+        {
+            /* The first NAL unit of an access unit has a long start code.
+             * The zero byte preceding it is a part of the start code and the others are trailing zero bytes. */
+            in_run         = 1;
+            sei_present    = (nalu_class == NALU_SPLIT_CLASS_SEI);
+            split->pos     = sc_pos - 1;
+            split->num_ps  = 0;
+            if( nalu_class == NALU_SPLIT_CLASS_PARAMETER_SET )
+            {
+                split->ps_pos[0] = sc_pos + NALU_SHORT_START_CODE_LENGTH;
+                ps_pending = 1;
+            }
+        }
+        prev_class = nalu_class;
+        ++i;
+    }
+}
+
+static void *nalu_run_analysis_worker( void *arg )
+{
+    nalu_analysis_worker_t *worker = (nalu_analysis_worker_t *)arg;
+    worker->err = worker->analyzer->analyze( &worker->importer, &worker->analysis );
+    return NULL;
+}
+
+static int nalu_setup_analysis_worker
+(
+    importer_t             *importer,
+    const nalu_analyzer_t  *analyzer,
+    nalu_analysis_worker_t *worker,
+    uint64_t                end
+)
+{
+    nalu_split_t *split = &worker->split;
+    for( uint32_t i = 0; i < split->num_ps; i++ )
+    {
+        split->ps[i] = lsmash_malloc( split->ps_length[i] );
+        if( !split->ps[i] )
+            return LSMASH_ERR_MEMORY_ALLOC;
+        int64_t ret = nalu_pread( importer->bs, split->ps[i], split->ps_length[i], split->ps_pos[i] );
+        if( ret < 0 )
+            return ret;
+        if( ret != split->ps_length[i] )
+            return LSMASH_ERR_INVALID_DATA;
+    }
+    worker->analyzer   = analyzer;
+    worker->stream.src = importer->bs;
+    worker->stream.pos = split->pos;
+    worker->stream.end = end;
+    lsmash_bs_t *bs = lsmash_bs_create();
+    if( !bs )
+        return LSMASH_ERR_MEMORY_ALLOC;
+    bs->stream          = &worker->stream;
+    bs->read            = nalu_range_stream_read;
+    bs->seek            = nalu_range_stream_seek;
+    bs->pread           = nalu_range_stream_pread;
+    bs->unseekable      = 0;
+    bs->buffer.max_size = importer->bs->buffer.max_size;
+    worker->importer.class     = importer->class;
+    worker->importer.log_level = importer->log_level;
+    worker->importer.bs        = bs;
+    if( lsmash_bs_read_seek( bs, split->pos, SEEK_SET ) < 0 )
+        return LSMASH_ERR_NAMELESS;
+    return analyzer->setup( &worker->importer, split->pos );
+}
+
+/* Analyze the ranges of the stream starting at 'first_sc_head_pos' concurrently.
+ * Return 1 if analyzed, or 0 if the stream shall be analyzed sequentially. Otherwise, return a negative value. */
+static int nalu_analyze_in_parallel
+(
+    importer_t            *importer,
+    const nalu_analyzer_t *analyzer,
+    uint64_t               first_sc_head_pos,
+    nalu_analysis_t       *analysis
+)
+{
+    lsmash_bs_t *bs = importer->bs;
+    if( !bs->pread || !bs->seek || bs->unseekable )
+        return 0;
+    int num_ranges = LSMASH_MIN( lsmash_get_cpu_count(), NALU_ANALYSIS_MAX_NUM_RANGES );
+    if( num_ranges < 2 )
+        return 0;
+    int64_t stream_end = bs->seek( bs->stream, 0, SEEK_END );
+    if( stream_end < 0 || (uint64_t)stream_end <= first_sc_head_pos )
+        return 0;
+    uint64_t stream_size = stream_end - first_sc_head_pos;
+    num_ranges = LSMASH_MIN( (uint64_t)num_ranges, stream_size / NALU_ANALYSIS_MIN_RANGE_SIZE );
+    if( num_ranges < 2 )
+        return 0;
+    nalu_analysis_worker_t *workers = lsmash_malloc_zero( num_ranges * sizeof(nalu_analysis_worker_t) );
+    uint8_t                *window  = lsmash_malloc( NALU_SPLIT_WINDOW_SIZE );
+    int num_workers = 0;
+    int ret         = LSMASH_ERR_MEMORY_ALLOC;
+    if( !workers || !window )
+        goto cleanup;
+    /* Find the split points around the evenly spaced positions. */
+    workers[ num_workers++ ].split.pos = first_sc_head_pos;
+    for( int i = 1; i < num_ranges; i++ )
+    {
+        uint64_t pos   = first_sc_head_pos + i       * stream_size / num_ranges;
+        uint64_t limit = first_sc_head_pos + (i + 1) * stream_size / num_ranges;
+        if( (ret = nalu_find_split_point( bs, analyzer, window, pos, limit, &workers[num_workers].split )) < 0 )
+            goto cleanup;
+        num_workers += ret;
+    }
+    ret = 0;
+    if( num_workers < 2 )
+        goto cleanup;
+    for( int i = 0; i < num_workers; i++ )
+    {
+        uint64_t end = i + 1 < num_workers ? workers[i + 1].split.pos : UINT64_MAX;
+        if( (ret = nalu_setup_analysis_worker( importer, analyzer, &workers[i], end )) < 0 )
+            goto cleanup;
+    }
+    /* Analyze the first range on the current thread. */
+    for( int i = 1; i < num_workers; i++ )
+        workers[i].threaded = lsmash_thread_create( &workers[i].thread, nalu_run_analysis_worker, &workers[i] ) == 0;
+    nalu_run_analysis_worker( &workers[0] );
+    for( int i = 1; i < num_workers; i++ )
+        if( workers[i].threaded )
+            lsmash_thread_join( &workers[i].thread, NULL );
+        else
+            nalu_run_analysis_worker( &workers[i] );
+    /* Any error is left to the sequential analysis. */
+    ret = 0;
+    for( int i = 0; i < num_workers; i++ )
+        if( workers[i].err < 0 )
+            goto cleanup;
+    if( (ret = analyzer->merge( importer, workers, num_workers )) <= 0 )
+        goto cleanup;
+    for( int i = 0; i < num_workers; i++ )
+    {
+        int err = nalu_append_analysis( analysis, &workers[i].analysis );
+        if( err < 0 )
+        {
+            ret = err;
+            goto cleanup;
+        }
+    }
+cleanup:
+    for( int i = 0; i < num_workers; i++ )
+    {
+        nalu_analysis_worker_t *worker = &workers[i];
+        if( worker->importer.info )
+            analyzer->cleanup( &worker->importer );
+        lsmash_bs_cleanup( worker->importer.bs );
+        lsmash_free( worker->analysis.npt );
+        for( uint32_t j = 0; j < worker->split.num_ps; j++ )
+            lsmash_free( worker->split.ps[j] );
+    }
+    lsmash_free( workers );
+    lsmash_free( window );
+    return ret;
+}
+
+/* Check if a list of parameter sets within a decoder configuration record is carried by the NAL units ahead of
+ * the first picture of a range. */
+static int nalu_ps_list_is_carried( lsmash_entry_list_t *ps_list, nalu_split_t *split )
+{
+    for( lsmash_entry_t *entry = ps_list->head; entry; entry = entry->next )
+    {
+        isom_dcr_ps_entry_t *ps = (isom_dcr_ps_entry_t *)entry->data;
+        if( !ps )
+            return 0;
+        uint32_t i;
+        for( i = 0; i < split->num_ps; i++ )
+            if( split->ps_length[i] == ps->nalUnitLength
+             && memcmp( split->ps[i], ps->nalUnit, ps->nalUnitLength ) == 0 )
+                break;
+        if( i == split->num_ps )
+            return 0;
+    }
+    return 1;
+}
+
 static lsmash_video_summary_t *h264_setup_first_summary
 (
     importer_t *importer
@@ -728,50 +1149,63 @@ static lsmash_video_summary_t *h264_setup_first_summary
     return summary;
 }
 
-static int h264_analyze_whole_stream
+static int h264_classify_nalu_for_split( const uint8_t *nalu_header )
+{
+    if( nalu_header[0] >> 7 )
+        return NALU_SPLIT_CLASS_OTHER;  /* forbidden_zero_bit */
+    switch( nalu_header[0] & 0x1f )
+    {
+        case H264_NALU_TYPE_SLICE_IDR :
+            return NALU_SPLIT_CLASS_RANDOM_ACCESS;
+        case H264_NALU_TYPE_SLICE_N_IDR :
+        case H264_NALU_TYPE_SLICE_DP_A :
+        case H264_NALU_TYPE_SLICE_DP_B :
+        case H264_NALU_TYPE_SLICE_DP_C :
+        case H264_NALU_TYPE_FD :
+        case H264_NALU_TYPE_SLICE_AUX :
+            return NALU_SPLIT_CLASS_PICTURE;
+        case H264_NALU_TYPE_SPS :
+        case H264_NALU_TYPE_PPS :
+            return NALU_SPLIT_CLASS_PARAMETER_SET;
+        case H264_NALU_TYPE_SEI :
+            return NALU_SPLIT_CLASS_SEI;
+        case H264_NALU_TYPE_AUD :
+            return NALU_SPLIT_CLASS_AUD;
+        default :
+            return NALU_SPLIT_CLASS_OTHER;
+    }
+}
+
+static int h264_analyze_access_units
 (
-    importer_t *importer
+    importer_t      *importer,
+    nalu_analysis_t *analysis
 )
 {
-    /* Parse all NALU in the stream for preparation of calculating timestamps. */
-    uint32_t npt_alloc = (1 << 12) * sizeof(nal_pic_timing_t);
-    nal_pic_timing_t *npt = lsmash_malloc( npt_alloc );
-    if( !npt )
-        return LSMASH_ERR_MEMORY_ALLOC;
-    uint32_t picture_stats[H264_PICTURE_TYPE_NONE + 1] = { 0 };
-    uint32_t num_access_units = 0;
-    lsmash_class_t *logger = &(lsmash_class_t){ "H.264" };
-    lsmash_log( &logger, LSMASH_LOG_INFO, "Analyzing stream as H.264\r" );
     h264_importer_t *h264_imp = (h264_importer_t *)importer->info;
     h264_info_t     *info     = &h264_imp->info;
+    uint32_t *picture_stats = analysis->picture_stats;
     importer->status = IMPORTER_OK;
-    int err = LSMASH_ERR_MEMORY_ALLOC;
     while( importer->status != IMPORTER_EOF )
     {
 #if 0
-        lsmash_log( &logger, LSMASH_LOG_INFO, "Analyzing stream as H.264: %"PRIu32"\n", num_access_units + 1 );
+        lsmash_log( importer, LSMASH_LOG_INFO, "Analyzing stream as H.264: %"PRIu32"\n", analysis->num_access_units + 1 );
 #endif
         h264_picture_info_t     *picture = &info->au.picture;
         h264_picture_info_t prev_picture = *picture;
+        int err;
         if( (err = h264_get_access_unit_internal( importer, 1 ))       < 0
          || (err = h264_calculate_poc( info, picture, &prev_picture )) < 0 )
-            goto fail;
+            return err;
         h264_importer_check_eof( importer, &info->au );
-        if( npt_alloc <= num_access_units * sizeof(nal_pic_timing_t) )
-        {
-            uint32_t alloc = 2 * num_access_units * sizeof(nal_pic_timing_t);
-            nal_pic_timing_t *temp = (nal_pic_timing_t *)lsmash_realloc( npt, alloc );
-            if( !temp )
-                goto fail;
-            npt       = temp;
-            npt_alloc = alloc;
-        }
+        nal_pic_timing_t *npt = nalu_get_next_pic_timing( analysis );
+        if( !npt )
+            return LSMASH_ERR_MEMORY_ALLOC;
         h264_imp->field_pic_present |= picture->field_pic_flag;
-        npt[num_access_units].poc       = picture->PicOrderCnt;
-        npt[num_access_units].delta     = picture->delta;
-        npt[num_access_units].poc_delta = picture->field_pic_flag ? 1 : 2;
-        npt[num_access_units].reset     = picture->has_mmco5;
-        ++num_access_units;
+        npt->poc       = picture->PicOrderCnt;
+        npt->delta     = picture->delta;
+        npt->poc_delta = picture->field_pic_flag ? 1 : 2;
+        npt->reset     = picture->has_mmco5;
         h264_imp->max_au_length = LSMASH_MAX( info->au.length, h264_imp->max_au_length );
         if( picture->idr )
             ++picture_stats[H264_PICTURE_TYPE_IDR];
@@ -780,6 +1214,106 @@ static int h264_analyze_whole_stream
         else
             ++picture_stats[ picture->type ];
     }
+    return 0;
+}
+
+static int h264_setup_analysis( importer_t *importer, uint64_t sc_head_pos )
+{
+    h264_importer_t *h264_imp = create_h264_importer( importer );
+    if( !h264_imp )
+        return LSMASH_ERR_MEMORY_ALLOC;
+    h264_imp->sc_head_pos = sc_head_pos;
+    importer->info = h264_imp;
+    return 0;
+}
+
+static int h264_param_is_identical
+(
+    lsmash_h264_specific_parameters_t *a,
+    lsmash_h264_specific_parameters_t *b
+)
+{
+    uint32_t length[2];
+    uint8_t *dcr[2] = { lsmash_create_h264_specific_info( a, &length[0] ),
+                        lsmash_create_h264_specific_info( b, &length[1] ) };
+    int identical = dcr[0] && dcr[1] && length[0] == length[1] && memcmp( dcr[0], dcr[1], length[0] ) == 0;
+    lsmash_free( dcr[0] );
+    lsmash_free( dcr[1] );
+    return identical;
+}
+
+static int h264_merge_analysis
+(
+    importer_t             *importer,
+    nalu_analysis_worker_t *workers,
+    int                     num_workers
+)
+{
+    /* The parser state at each split point is reproduced from scratch if the parameter sets never change through
+     * the stream and all of them are repeated ahead of the random access picture.
+     * A single SPS makes the active SPS for parsing SEIs the same as the sequential analysis too. */
+    h264_importer_t *first_imp = (h264_importer_t *)workers[0].importer.info;
+    lsmash_h264_specific_parameters_t *param = &first_imp->info.avcC_param;
+    if( !param->parameter_sets || param->parameter_sets->sps_list->entry_count != 1 )
+        return 0;
+    for( int i = 0; i < num_workers; i++ )
+    {
+        h264_importer_t *worker_imp = (h264_importer_t *)workers[i].importer.info;
+        lsmash_h264_specific_parameters_t *worker_param = &worker_imp->info.avcC_param;
+        if( worker_imp->avcC_list->entry_count
+         || worker_imp->info.avcC_pending
+         || !h264_param_is_identical( worker_param, param ) )
+            return 0;
+        if( i > 0
+         && (!nalu_ps_list_is_carried( worker_param->parameter_sets->sps_list,    &workers[i].split )
+          || !nalu_ps_list_is_carried( worker_param->parameter_sets->pps_list,    &workers[i].split )
+          || !nalu_ps_list_is_carried( worker_param->parameter_sets->spsext_list, &workers[i].split )) )
+            return 0;
+    }
+    h264_importer_t *h264_imp = (h264_importer_t *)importer->info;
+    for( int i = 0; i < num_workers; i++ )
+    {
+        h264_importer_t *worker_imp = (h264_importer_t *)workers[i].importer.info;
+        h264_imp->max_au_length      = LSMASH_MAX( h264_imp->max_au_length, worker_imp->max_au_length );
+        h264_imp->field_pic_present |= worker_imp->field_pic_present;
+    }
+    /* Take over the parser state at the end of the stream. */
+    h264_importer_t *last_imp = (h264_importer_t *)workers[num_workers - 1].importer.info;
+    h264_info_t temp = h264_imp->info;
+    h264_imp->info = last_imp->info;
+    last_imp->info = temp;
+    return 1;
+}
+
+static const nalu_analyzer_t h264_analyzer =
+{
+    1,
+    h264_classify_nalu_for_split,
+    h264_setup_analysis,
+    h264_importer_cleanup,
+    h264_analyze_access_units,
+    h264_merge_analysis
+};
+
+static int h264_analyze_whole_stream
+(
+    importer_t *importer
+)
+{
+    /* Parse all NALU in the stream for preparation of calculating timestamps. */
+    nalu_analysis_t analysis = { 0 };
+    uint32_t *picture_stats = analysis.picture_stats;
+    lsmash_class_t *logger = &(lsmash_class_t){ "H.264" };
+    lsmash_log( &logger, LSMASH_LOG_INFO, "Analyzing stream as H.264\r" );
+    h264_importer_t *h264_imp = (h264_importer_t *)importer->info;
+    h264_info_t     *info     = &h264_imp->info;
+    int err = nalu_analyze_in_parallel( importer, &h264_analyzer, h264_imp->sc_head_pos, &analysis );
+    if( err == 0 )
+        err = h264_analyze_access_units( importer, &analysis );
+    if( err < 0 )
+        goto fail;
+    nal_pic_timing_t *npt              = analysis.npt;
+    uint32_t          num_access_units = analysis.num_access_units;
     lsmash_log_refresh_line( &logger );
     lsmash_log( &logger, LSMASH_LOG_INFO,
                 "IDR: %"PRIu32", I: %"PRIu32", P: %"PRIu32", B: %"PRIu32", "
@@ -807,7 +1341,10 @@ static int h264_analyze_whole_stream
     /* Allocate timestamps. */
     lsmash_media_ts_t *timestamp = lsmash_malloc( num_access_units * sizeof(lsmash_media_ts_t) );
     if( !timestamp )
+    {
+        err = LSMASH_ERR_MEMORY_ALLOC;
         goto fail;
+    }
     /* Count leading samples that are undecodable. */
     for( uint32_t i = 0; i < num_access_units; i++ )
     {
@@ -830,10 +1367,50 @@ static int h264_analyze_whole_stream
     return 0;
 fail:
     lsmash_log_refresh_line( &logger );
-    lsmash_free( npt );
+    lsmash_free( analysis.npt );
     return err;
 }
 
+static int h264_nalu_header_is_plausible( const uint8_t *nalu_header )
+{
+    uint8_t forbidden_zero_bit = nalu_header[0] >> 7;
+    uint8_t nal_ref_idc        = (nalu_header[0] >> 5) & 0x03;
+    uint8_t nal_unit_type      = nalu_header[0] & 0x1f;
+    if( forbidden_zero_bit )
+        return 0;
+    switch( nal_unit_type )
+    {
+        case H264_NALU_TYPE_SLICE_N_IDR :
+        case H264_NALU_TYPE_SLICE_DP_A :
+        case H264_NALU_TYPE_SLICE_DP_B :
+        case H264_NALU_TYPE_SLICE_DP_C :
+        case H264_NALU_TYPE_SPS :
+        case H264_NALU_TYPE_PPS :
+        case H264_NALU_TYPE_SPS_EXT :
+        case H264_NALU_TYPE_PREFIX :
+        case H264_NALU_TYPE_SUBSET_SPS :
+        case H264_NALU_TYPE_SLICE_AUX :
+        case H264_NALU_TYPE_SLICE_EXT :
+        case H264_NALU_TYPE_SLICE_EXT_DVC :
+            return 1;
+        case H264_NALU_TYPE_SLICE_IDR :
+            return nal_ref_idc != 0;
+        case H264_NALU_TYPE_SEI :
+        case H264_NALU_TYPE_AUD :
+        case H264_NALU_TYPE_EOS :
+        case H264_NALU_TYPE_EOB :
+        case H264_NALU_TYPE_FD :
+            return nal_ref_idc == 0;
+        default :
+            return 0;   /* reserved or unspecified */
+    }
+}
+
+static int h264_importer_detect( importer_t *importer, const uint8_t *data, uint64_t size, int eof )
+{
+    return nalu_detect_byte_stream( data, size, eof, 1, h264_nalu_header_is_plausible );
+}
+
 static int h264_importer_probe( importer_t *importer )
 {
     /* Find the first start code. */
@@ -901,6 +1478,7 @@ const importer_functions h264_importer =
 {
     { "H.264", offsetof( importer_t, log_level ) },
     1,
+    h264_importer_detect,
     h264_importer_probe,
     h264_importer_get_accessunit,
     h264_importer_get_last_delta,
@@ -1387,50 +1965,64 @@ static lsmash_video_summary_t *hevc_setup_first_summary
     return summary;
 }
 
-static int hevc_analyze_whole_stream
+static int hevc_classify_nalu_for_split( const uint8_t *nalu_header )
+{
+    uint8_t nal_unit_type = (nalu_header[0] >> 1) & 0x3f;
+    uint8_t nuh_layer_id  = ((nalu_header[0] & 0x01) << 5) | (nalu_header[1] >> 3);
+    if( (nalu_header[0] >> 7) || nuh_layer_id )
+        return NALU_SPLIT_CLASS_OTHER;  /* forbidden_zero_bit or any layer other than the base layer */
+    if( nal_unit_type == HEVC_NALU_TYPE_IDR_W_RADL || nal_unit_type == HEVC_NALU_TYPE_IDR_N_LP )
+        return NALU_SPLIT_CLASS_RANDOM_ACCESS;
+    if( nal_unit_type <= HEVC_NALU_TYPE_RSV_VCL31 )
+        return NALU_SPLIT_CLASS_PICTURE;
+    switch( nal_unit_type )
+    {
+        case HEVC_NALU_TYPE_FD :
+        case HEVC_NALU_TYPE_SUFFIX_SEI :    /* trails the picture in the same access unit */
+            return NALU_SPLIT_CLASS_PICTURE;
+        case HEVC_NALU_TYPE_VPS :
+        case HEVC_NALU_TYPE_SPS :
+        case HEVC_NALU_TYPE_PPS :
+            return NALU_SPLIT_CLASS_PARAMETER_SET;
+        case HEVC_NALU_TYPE_PREFIX_SEI :
+            return NALU_SPLIT_CLASS_SEI;
+        case HEVC_NALU_TYPE_AUD :
+            return NALU_SPLIT_CLASS_AUD;
+        default :
+            return NALU_SPLIT_CLASS_OTHER;
+    }
+}
+
+static int hevc_analyze_access_units
 (
-    importer_t *importer
+    importer_t      *importer,
+    nalu_analysis_t *analysis
 )
 {
-    /* Parse all NALU in the stream for preparation of calculating timestamps. */
-    uint32_t npt_alloc = (1 << 12) * sizeof(nal_pic_timing_t);
-    nal_pic_timing_t *npt = (nal_pic_timing_t *)lsmash_malloc( npt_alloc );
-    if( !npt )
-        return LSMASH_ERR_MEMORY_ALLOC;
-    uint32_t picture_stats[HEVC_PICTURE_TYPE_NONE + 1] = { 0 };
-    uint32_t num_access_units = 0;
-    lsmash_class_t *logger = &(lsmash_class_t){ "HEVC" };
-    lsmash_log( &logger, LSMASH_LOG_INFO, "Analyzing stream as HEVC\r" );
     hevc_importer_t *hevc_imp = (hevc_importer_t *)importer->info;
     hevc_info_t     *info     = &hevc_imp->info;
+    uint32_t *picture_stats = analysis->picture_stats;
     importer->status = IMPORTER_OK;
-    int err = LSMASH_ERR_MEMORY_ALLOC;
     while( importer->status != IMPORTER_EOF )
     {
 #if 0
-        lsmash_log( &logger, LSMASH_LOG_INFO, "Analyzing stream as HEVC: %"PRIu32"\n", num_access_units + 1 );
+        lsmash_log( importer, LSMASH_LOG_INFO, "Analyzing stream as HEVC: %"PRIu32"\n", analysis->num_access_units + 1 );
 #endif
         hevc_picture_info_t     *picture = &info->au.picture;
         hevc_picture_info_t prev_picture = *picture;
+        int err;
         if( (err = hevc_get_access_unit_internal( importer, 1 ))                 < 0
          || (err = hevc_calculate_poc( info, &info->au.picture, &prev_picture )) < 0 )
-            goto fail;
+            return err;
         hevc_importer_check_eof( importer, &info->au );
-        if( npt_alloc <= num_access_units * sizeof(nal_pic_timing_t) )
-        {
-            uint32_t alloc = 2 * num_access_units * sizeof(nal_pic_timing_t);
-            nal_pic_timing_t *temp = (nal_pic_timing_t *)lsmash_realloc( npt, alloc );
-            if( !temp )
-                goto fail;
-            npt = temp;
-            npt_alloc = alloc;
-        }
+        nal_pic_timing_t *npt = nalu_get_next_pic_timing( analysis );
+        if( !npt )
+            return LSMASH_ERR_MEMORY_ALLOC;
         hevc_imp->field_pic_present |= picture->field_coded;
-        npt[num_access_units].poc       = picture->poc;
-        npt[num_access_units].delta     = picture->delta;
-        npt[num_access_units].poc_delta = 1;
-        npt[num_access_units].reset     = 0;
-        ++num_access_units;
+        npt->poc       = picture->poc;
+        npt->delta     = picture->delta;
+        npt->poc_delta = 1;
+        npt->reset     = 0;
         hevc_imp->max_au_length  = LSMASH_MAX( hevc_imp->max_au_length,  info->au.length );
         hevc_imp->max_TemporalId = LSMASH_MAX( hevc_imp->max_TemporalId, info->au.TemporalId );
         if( picture->idr )
@@ -1442,6 +2034,107 @@ static int hevc_analyze_whole_stream
         else
             ++picture_stats[ picture->type ];
     }
+    return 0;
+}
+
+static int hevc_setup_analysis( importer_t *importer, uint64_t sc_head_pos )
+{
+    hevc_importer_t *hevc_imp = create_hevc_importer( importer );
+    if( !hevc_imp )
+        return LSMASH_ERR_MEMORY_ALLOC;
+    hevc_imp->sc_head_pos = sc_head_pos;
+    importer->info = hevc_imp;
+    return 0;
+}
+
+static int hevc_param_is_identical
+(
+    lsmash_hevc_specific_parameters_t *a,
+    lsmash_hevc_specific_parameters_t *b
+)
+{
+    uint32_t length[2];
+    uint8_t *dcr[2] = { lsmash_create_hevc_specific_info( a, &length[0] ),
+                        lsmash_create_hevc_specific_info( b, &length[1] ) };
+    int identical = dcr[0] && dcr[1] && length[0] == length[1] && memcmp( dcr[0], dcr[1], length[0] ) == 0;
+    lsmash_free( dcr[0] );
+    lsmash_free( dcr[1] );
+    return identical;
+}
+
+static int hevc_merge_analysis
+(
+    importer_t             *importer,
+    nalu_analysis_worker_t *workers,
+    int                     num_workers
+)
+{
+    /* Same as H.264. A single VPS and a single SPS make the active ones for parsing SEIs the same as the sequential
+     * analysis. Only IDR pictures are split points since the handling of a CRA picture depends on its preceding ones. */
+    hevc_importer_t *first_imp = (hevc_importer_t *)workers[0].importer.info;
+    lsmash_hevc_specific_parameters_t *param = &first_imp->info.hvcC_param;
+    if( !param->parameter_arrays
+     || param->parameter_arrays->ps_array[HEVC_DCR_NALU_TYPE_VPS].list->entry_count != 1
+     || param->parameter_arrays->ps_array[HEVC_DCR_NALU_TYPE_SPS].list->entry_count != 1 )
+        return 0;
+    for( int i = 0; i < num_workers; i++ )
+    {
+        hevc_importer_t *worker_imp = (hevc_importer_t *)workers[i].importer.info;
+        lsmash_hevc_specific_parameters_t *worker_param = &worker_imp->info.hvcC_param;
+        if( worker_imp->hvcC_list->entry_count
+         || worker_imp->info.hvcC_pending
+         || !hevc_param_is_identical( worker_param, param ) )
+            return 0;
+        if( i > 0 )
+            for( int j = 0; j < HEVC_DCR_NALU_TYPE_NUM; j++ )
+                if( !nalu_ps_list_is_carried( worker_param->parameter_arrays->ps_array[j].list, &workers[i].split ) )
+                    return 0;
+    }
+    hevc_importer_t *hevc_imp = (hevc_importer_t *)importer->info;
+    for( int i = 0; i < num_workers; i++ )
+    {
+        hevc_importer_t *worker_imp = (hevc_importer_t *)workers[i].importer.info;
+        hevc_imp->max_au_length      = LSMASH_MAX( hevc_imp->max_au_length,  worker_imp->max_au_length );
+        hevc_imp->max_TemporalId     = LSMASH_MAX( hevc_imp->max_TemporalId, worker_imp->max_TemporalId );
+        hevc_imp->field_pic_present |= worker_imp->field_pic_present;
+    }
+    /* Take over the parser state at the end of the stream. */
+    hevc_importer_t *last_imp = (hevc_importer_t *)workers[num_workers - 1].importer.info;
+    hevc_info_t temp = hevc_imp->info;
+    hevc_imp->info = last_imp->info;
+    last_imp->info = temp;
+    return 1;
+}
+
+static const nalu_analyzer_t hevc_analyzer =
+{
+    2,
+    hevc_classify_nalu_for_split,
+    hevc_setup_analysis,
+    hevc_importer_cleanup,
+    hevc_analyze_access_units,
+    hevc_merge_analysis
+};
+
+static int hevc_analyze_whole_stream
+(
+    importer_t *importer
+)
+{
+    /* Parse all NALU in the stream for preparation of calculating timestamps. */
+    nalu_analysis_t analysis = { 0 };
+    uint32_t *picture_stats = analysis.picture_stats;
+    lsmash_class_t *logger = &(lsmash_class_t){ "HEVC" };
+    lsmash_log( &logger, LSMASH_LOG_INFO, "Analyzing stream as HEVC\r" );
+    hevc_importer_t *hevc_imp = (hevc_importer_t *)importer->info;
+    hevc_info_t     *info     = &hevc_imp->info;
+    int err = nalu_analyze_in_parallel( importer, &hevc_analyzer, hevc_imp->sc_head_pos, &analysis );
+    if( err == 0 )
+        err = hevc_analyze_access_units( importer, &analysis );
+    if( err < 0 )
+        goto fail;
+    nal_pic_timing_t *npt              = analysis.npt;
+    uint32_t          num_access_units = analysis.num_access_units;
     lsmash_log_refresh_line( &logger );
     lsmash_log( &logger, LSMASH_LOG_INFO,
                 "IDR: %"PRIu32", CRA: %"PRIu32", BLA: %"PRIu32", I: %"PRIu32", P: %"PRIu32", B: %"PRIu32", Unknown: %"PRIu32"\n",
@@ -1462,7 +2155,10 @@ static int hevc_analyze_whole_stream
     /* */
     lsmash_media_ts_t *timestamp = lsmash_malloc( num_access_units * sizeof(lsmash_media_ts_t) );
     if( !timestamp )
+    {
+        err = LSMASH_ERR_MEMORY_ALLOC;
         goto fail;
+    }
     /* Count leading samples that are undecodable. */
     for( uint32_t i = 0; i < num_access_units; i++ )
     {
@@ -1488,10 +2184,51 @@ static int hevc_analyze_whole_stream
     return 0;
 fail:
     lsmash_log_refresh_line( &logger );
-    lsmash_free( npt );
+    lsmash_free( analysis.npt );
     return err;
 }
 
+static int hevc_nalu_header_is_plausible( const uint8_t *nalu_header )
+{
+    uint8_t forbidden_zero_bit    = nalu_header[0] >> 7;
+    uint8_t nal_unit_type         = (nalu_header[0] >> 1) & 0x3f;
+    uint8_t nuh_layer_id          = ((nalu_header[0] & 0x01) << 5) | (nalu_header[1] >> 3);
+    uint8_t nuh_temporal_id_plus1 = nalu_header[1] & 0x07;
+    /* nuh_layer_id shall be 0 in the specification we refer to. */
+    if( forbidden_zero_bit || nuh_layer_id || nuh_temporal_id_plus1 == 0 )
+        return 0;
+    if( nal_unit_type <= HEVC_NALU_TYPE_RASL_R )
+        return 1;
+    switch( nal_unit_type )
+    {
+        /* TemporalId of these shall be equal to 0. */
+        case HEVC_NALU_TYPE_BLA_W_LP :
+        case HEVC_NALU_TYPE_BLA_W_RADL :
+        case HEVC_NALU_TYPE_BLA_N_LP :
+        case HEVC_NALU_TYPE_IDR_W_RADL :
+        case HEVC_NALU_TYPE_IDR_N_LP :
+        case HEVC_NALU_TYPE_CRA :
+        case HEVC_NALU_TYPE_VPS :
+        case HEVC_NALU_TYPE_SPS :
+        case HEVC_NALU_TYPE_EOS :
+        case HEVC_NALU_TYPE_EOB :
+            return nuh_temporal_id_plus1 == 1;
+        case HEVC_NALU_TYPE_PPS :
+        case HEVC_NALU_TYPE_AUD :
+        case HEVC_NALU_TYPE_FD :
+        case HEVC_NALU_TYPE_PREFIX_SEI :
+        case HEVC_NALU_TYPE_SUFFIX_SEI :
+            return 1;
+        default :
+            return 0;   /* reserved or unspecified */
+    }
+}
+
+static int hevc_importer_detect( importer_t *importer, const uint8_t *data, uint64_t size, int eof )
+{
+    return nalu_detect_byte_stream( data, size, eof, 2, hevc_nalu_header_is_plausible );
+}
+
 static int hevc_importer_probe( importer_t *importer )
 {
     /* Find the first start code. */
@@ -1559,6 +2296,7 @@ const importer_functions hevc_importer =
 {
     { "HEVC", offsetof( importer_t, log_level ) },
     1,
+    hevc_importer_detect,
     hevc_importer_probe,
     hevc_importer_get_accessunit,
     hevc_importer_get_last_delta,
@@ -459,6 +459,40 @@ fail:
     return err;
 }
 
+static int vc1_importer_detect( importer_t *importer, const uint8_t *data, uint64_t size, int eof )
+{
+    /* The first EBDU in decoding order of the stream shall have start code (0x000001),
+     * and only zero bytes may precede it as the probe requires. */
+    uint64_t pos = 0;
+    while( pos < size && data[pos] == 0x00 )
+        ++pos;
+    if( pos == size )
+        return eof ? 0 : 5; /* Nothing but zero bytes so far. */
+    if( data[pos] != 0x01 || pos < VC1_START_CODE_PREFIX_LENGTH - 1 )
+        return 0;
+    /* Score by the number of EBDUs with a defined BDU type in a row. */
+    int count = 0;
+    for( ++pos; count < 4 && pos < size; count++ )
+    {
+        uint8_t bdu_type = data[pos];
+        if( !(bdu_type >= 0x0A && bdu_type <= 0x0F)
+         && !(bdu_type >= 0x1B && bdu_type <= 0x1F) )
+            break;
+        /* Find the start code prefix of the next EBDU. */
+        pos += VC1_START_CODE_SUFFIX_LENGTH;
+        while( 1 )
+        {
+            const uint8_t *next = memchr( data + pos, 0x01, size - pos );
+            if( !next )
+                return 5 + (count + 1) * 15;
+            pos = next - data + 1;
+            if( next[-1] == 0x00 && next[-2] == 0x00 )
+                break;
+        }
+    }
+    return 5 + count * 15;
+}
+
 static int vc1_importer_probe( importer_t *importer )
 {
     /* Find the first start code. */
@@ -475,6 +509,11 @@ static int vc1_importer_probe( importer_t *importer )
             err = LSMASH_ERR_IO;
             goto fail;
         }
+        if( lsmash_bs_is_end( bs, first_ebdu_head_pos + VC1_START_CODE_LENGTH ) )
+        {
+            err = LSMASH_ERR_INVALID_DATA;
+            goto fail;
+        }
         /* The first EBDU in decoding order of the stream shall have start code (0x000001). */
         if( 0x000001 == lsmash_bs_show_be24( bs, first_ebdu_head_pos ) )
             break;
@@ -540,6 +579,7 @@ const importer_functions vc1_importer =
 {
     { "VC-1", offsetof( importer_t, log_level ) },
     1,
+    vc1_importer_detect,
     vc1_importer_probe,
     vc1_importer_get_accessunit,
     vc1_importer_get_last_delta,
@@ -41,6 +41,7 @@
 #define WAVE_MIN_FILESIZE 45
 
 #define WAVE_FORMAT_TYPE_ID_PCM        0x0001   /* WAVE_FORMAT_PCM */
+#define WAVE_FORMAT_TYPE_ID_IEEE_FLOAT 0x0003   /* WAVE_FORMAT_IEEE_FLOAT */
 #define WAVE_FORMAT_TYPE_ID_EXTENSIBLE 0xFFFE   /* WAVE_FORMAT_EXTENSIBLE */
 
 #define PASS_GUID( _0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15 ) \
@@ -56,6 +57,14 @@ DEFINE_WAVEFORMAT_EXTENSIBLE_SUBTYPE_GUID
                0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 )
 );
 
+/* KSDATAFORMAT_SUBTYPE_IEEE_FLOAT := 00000003-0000-0010-8000-00aa00389b71 */
+DEFINE_WAVEFORMAT_EXTENSIBLE_SUBTYPE_GUID
+(
+    WAVEFORMAT_EXTENSIBLE_SUBTYPE_GUID_IEEE_FLOAT,
+    PASS_GUID( 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+               0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 )
+);
+
 typedef struct
 {
     uint16_t wFormatTag;
@@ -80,11 +89,25 @@ typedef struct
     uint8_t guid[16];
 } waveformat_extensible_t;
 
+/* conversion of LPCM samples applied to each access unit in place */
+typedef enum
+{
+    WAVE_CONVERSION_NONE = 0,
+    WAVE_CONVERSION_SIGN_8,         /* unsigned 8-bit into signed 8-bit */
+    WAVE_CONVERSION_SWAP_16,        /* little endian into big endian */
+    WAVE_CONVERSION_SWAP_24,
+    WAVE_CONVERSION_SWAP_32,
+    WAVE_CONVERSION_SWAP_64,
+    WAVE_CONVERSION_EXPAND_24_32,   /* 24-bit little endian into the high bits of 32-bit big endian */
+} wave_conversion_t;
+
 typedef struct
 {
     uint32_t number_of_samples;
     uint32_t au_length;
     uint32_t au_number;
+    wave_conversion_t       conversion;
+    uint32_t                output_block_align; /* the size of an audio frame after conversion */
     waveformat_extensible_t fmt;
     isom_portable_chunk_t   chunk;
 } wave_importer_t;
@@ -107,6 +130,131 @@ static void wave_importer_cleanup( importer_t *importer )
         remove_wave_importer( importer->info );
 }
 
+/* The conversion kernels below work on 64-bit words holding several samples at once where possible.
+ * Swapping the bytes within each lane of a word gives the same result on any host byte order,
+ * and the tails shorter than a word are handled byte by byte. */
+static void wave_convert_sign_8( uint8_t *data, uint32_t length )
+{
+    uint32_t i = 0;
+    for( ; i + 8 <= length; i += 8 )
+    {
+        uint64_t x;
+        memcpy( &x, data + i, 8 );
+        x ^= UINT64_C(0x8080808080808080);
+        memcpy( data + i, &x, 8 );
+    }
+    for( ; i < length; i++ )
+        data[i] ^= 0x80;
+}
+
+static void wave_convert_swap_16( uint8_t *data, uint32_t length )
+{
+    uint32_t i = 0;
+    for( ; i + 8 <= length; i += 8 )
+    {
+        uint64_t x;
+        memcpy( &x, data + i, 8 );
+        x = ((x & UINT64_C(0x00FF00FF00FF00FF)) << 8) | ((x >> 8) & UINT64_C(0x00FF00FF00FF00FF));
+        memcpy( data + i, &x, 8 );
+    }
+    for( ; i + 2 <= length; i += 2 )
+    {
+        uint8_t temp = data[i];
+        data[i    ] = data[i + 1];
+        data[i + 1] = temp;
+    }
+}
+
+static void wave_convert_swap_24( uint8_t *data, uint32_t length )
+{
+    for( uint32_t i = 0; i + 3 <= length; i += 3 )
+    {
+        uint8_t temp = data[i];
+        data[i    ] = data[i + 2];
+        data[i + 2] = temp;
+    }
+}
+
+static void wave_convert_swap_32( uint8_t *data, uint32_t length )
+{
+    uint32_t i = 0;
+    for( ; i + 8 <= length; i += 8 )
+    {
+        uint64_t x;
+        memcpy( &x, data + i, 8 );
+        x = ((x & UINT64_C(0x00FF00FF00FF00FF)) << 8)  | ((x >> 8)  & UINT64_C(0x00FF00FF00FF00FF));
+        x = ((x & UINT64_C(0x0000FFFF0000FFFF)) << 16) | ((x >> 16) & UINT64_C(0x0000FFFF0000FFFF));
+        memcpy( data + i, &x, 8 );
+    }
+    for( ; i + 4 <= length; i += 4 )
+    {
+        uint32_t x = LSMASH_GET_LE32( data + i );
+        data[i    ] = x >> 24;
+        data[i + 1] = x >> 16;
+        data[i + 2] = x >>  8;
+        data[i + 3] = x;
+    }
+}
+
+static void wave_convert_swap_64( uint8_t *data, uint32_t length )
+{
+    for( uint32_t i = 0; i + 8 <= length; i += 8 )
+    {
+        uint64_t x;
+        memcpy( &x, data + i, 8 );
+        x = ((x & UINT64_C(0x00FF00FF00FF00FF)) << 8)  | ((x >> 8)  & UINT64_C(0x00FF00FF00FF00FF));
+        x = ((x & UINT64_C(0x0000FFFF0000FFFF)) << 16) | ((x >> 16) & UINT64_C(0x0000FFFF0000FFFF));
+        x = (x << 32) | (x >> 32);
+        memcpy( data + i, &x, 8 );
+    }
+}
+
+/* 'data' holds 'length' bytes of 24-bit samples and has room for the expanded ones.
+ * The samples are expanded from the last one so that no sample is overwritten before being read. */
+static void wave_convert_expand_24_32( uint8_t *data, uint32_t length )
+{
+    uint32_t count = length / 3;
+    for( uint32_t i = count; i; i-- )
+    {
+        uint8_t *src = data + (i - 1) * 3;
+        uint8_t *dst = data + (i - 1) * 4;
+        uint8_t b0 = src[0];
+        uint8_t b1 = src[1];
+        uint8_t b2 = src[2];
+        dst[0] = b2;
+        dst[1] = b1;
+        dst[2] = b0;
+        dst[3] = 0;
+    }
+}
+
+static void wave_convert_samples( wave_conversion_t conversion, uint8_t *data, uint32_t length )
+{
+    switch( conversion )
+    {
+        case WAVE_CONVERSION_SIGN_8 :
+            wave_convert_sign_8( data, length );
+            break;
+        case WAVE_CONVERSION_SWAP_16 :
+            wave_convert_swap_16( data, length );
+            break;
+        case WAVE_CONVERSION_SWAP_24 :
+            wave_convert_swap_24( data, length );
+            break;
+        case WAVE_CONVERSION_SWAP_32 :
+            wave_convert_swap_32( data, length );
+            break;
+        case WAVE_CONVERSION_SWAP_64 :
+            wave_convert_swap_64( data, length );
+            break;
+        case WAVE_CONVERSION_EXPAND_24_32 :
+            wave_convert_expand_24_32( data, length );
+            break;
+        default :
+            break;
+    }
+}
+
 static int wave_importer_get_accessunit( importer_t *importer, uint32_t track_number, lsmash_sample_t **p_sample )
 {
     if( !importer->info )
@@ -123,7 +271,7 @@ static int wave_importer_get_accessunit( importer_t *importer, uint32_t track_nu
     if( current_status == IMPORTER_EOF )
         return IMPORTER_EOF;
     if( wave_imp->number_of_samples / summary->samples_in_frame > wave_imp->au_number )
-        wave_imp->au_length = summary->bytes_per_frame;
+        wave_imp->au_length = wave_imp->fmt.wfx.nBlockAlign * summary->samples_in_frame;
     else
     {
         wave_imp->au_length = wave_imp->fmt.wfx.nBlockAlign * (wave_imp->number_of_samples % summary->samples_in_frame);
@@ -131,7 +279,9 @@ static int wave_importer_get_accessunit( importer_t *importer, uint32_t track_nu
         if( wave_imp->au_length == 0 )
             return IMPORTER_EOF;
     }
-    lsmash_sample_t *sample = lsmash_create_sample( wave_imp->au_length );
+    /* The size of an access unit may change by conversion. */
+    uint32_t output_length = wave_imp->au_length / wave_imp->fmt.wfx.nBlockAlign * wave_imp->output_block_align;
+    lsmash_sample_t *sample = lsmash_create_sample( LSMASH_MAX( wave_imp->au_length, output_length ) );
     if( !sample )
         return LSMASH_ERR_MEMORY_ALLOC;
     *p_sample = sample;
@@ -140,7 +290,8 @@ static int wave_importer_get_accessunit( importer_t *importer, uint32_t track_nu
         importer->status = IMPORTER_ERROR;
         return LSMASH_ERR_INVALID_DATA;
     }
-    sample->length        = wave_imp->au_length;
+    wave_convert_samples( wave_imp->conversion, sample->data, wave_imp->au_length );
+    sample->length        = output_length;
     sample->dts           = wave_imp->au_number ++ * summary->samples_in_frame;
     sample->cts           = sample->dts;
     sample->prop.ra_flags = ISOM_SAMPLE_RANDOM_ACCESS_FLAG_SYNC;
@@ -166,6 +317,8 @@ static int wave_parse_fmt_chunk( wave_importer_t *wave_imp, lsmash_bs_t *bs )
     {
         case WAVE_FORMAT_TYPE_ID_PCM :
             return 0;
+        case WAVE_FORMAT_TYPE_ID_IEEE_FLOAT :
+            return wfx->wBitsPerSample == 32 || wfx->wBitsPerSample == 64 ? 0 : LSMASH_ERR_INVALID_DATA;
         case WAVE_FORMAT_TYPE_ID_EXTENSIBLE :
             wfx->cbSize = lsmash_bs_get_le16( bs );
             if( wfx->cbSize < 22 )
@@ -175,14 +328,25 @@ static int wave_parse_fmt_chunk( wave_importer_t *wave_imp, lsmash_bs_t *bs )
             if( lsmash_bs_get_bytes_ex( bs, 16, fmt->guid ) != 16 )
                 return LSMASH_ERR_NAMELESS;
             /* We support only PCM audio currently. */
-            if( wave_fmt_subtype_cmp( fmt, WAVEFORMAT_EXTENSIBLE_SUBTYPE_GUID_PCM ) )
-                return LSMASH_ERR_INVALID_DATA;
-            return 0;
+            if( wave_fmt_subtype_cmp( fmt, WAVEFORMAT_EXTENSIBLE_SUBTYPE_GUID_PCM ) == 0 )
+                return 0;
+            if( wave_fmt_subtype_cmp( fmt, WAVEFORMAT_EXTENSIBLE_SUBTYPE_GUID_IEEE_FLOAT ) == 0
+             && (wfx->wBitsPerSample == 32 || wfx->wBitsPerSample == 64)
+             && fmt->Samples.wValidBitsPerSample == wfx->wBitsPerSample )
+                return 0;
+            return LSMASH_ERR_INVALID_DATA;
         default :
             return LSMASH_ERR_NAMELESS;
     }
 }
 
+static inline int wave_is_float( const waveformat_extensible_t *fmt )
+{
+    return fmt->wfx.wFormatTag == WAVE_FORMAT_TYPE_ID_IEEE_FLOAT
+        || (fmt->wfx.wFormatTag == WAVE_FORMAT_TYPE_ID_EXTENSIBLE
+         && wave_fmt_subtype_cmp( fmt, WAVEFORMAT_EXTENSIBLE_SUBTYPE_GUID_IEEE_FLOAT ) == 0);
+}
+
 static lsmash_audio_summary_t *wave_create_summary( waveformat_extensible_t *fmt )
 {
     lsmash_audio_summary_t *summary = (lsmash_audio_summary_t *)lsmash_create_summary( LSMASH_SUMMARY_TYPE_AUDIO );
@@ -209,7 +373,9 @@ static lsmash_audio_summary_t *wave_create_summary( waveformat_extensible_t *fmt
         lpcm->format_flags |= QT_AUDIO_FORMAT_FLAG_PACKED;
     else
         lpcm->format_flags |= QT_AUDIO_FORMAT_FLAG_ALIGNED_HIGH;
-    if( summary->sample_size > 8 )
+    if( wave_is_float( fmt ) )
+        lpcm->format_flags |= QT_AUDIO_FORMAT_FLAG_FLOAT;
+    else if( summary->sample_size > 8 )
         lpcm->format_flags |= QT_AUDIO_FORMAT_FLAG_SIGNED_INTEGER;
     if( lsmash_list_add_entry( &summary->opaque->list, cs ) < 0 )
     {
@@ -245,6 +411,15 @@ fail:
     return NULL;
 }
 
+static int wave_importer_detect( importer_t *importer, const uint8_t *data, uint64_t size, int eof )
+{
+    if( size >= 12
+     && LSMASH_GET_BE32( &data[0] ) == LSMASH_4CC( 'R', 'I', 'F', 'F' )
+     && LSMASH_GET_BE32( &data[8] ) == LSMASH_4CC( 'W', 'A', 'V', 'E' ) )
+        return IMPORTER_DETECT_SCORE_MAX;
+    return 0;
+}
+
 static int wave_importer_probe( importer_t *importer )
 {
     wave_importer_t *wave_imp = create_wave_importer( importer );
@@ -346,6 +521,7 @@ static int wave_importer_probe( importer_t *importer )
         lsmash_cleanup_summary( (lsmash_summary_t *)summary );
         goto fail;
     }
+    wave_imp->output_block_align = wave_imp->fmt.wfx.nBlockAlign;
     importer->info   = wave_imp;
     importer->status = IMPORTER_OK;
     return 0;
@@ -372,6 +548,65 @@ static uint32_t wave_importer_get_last_delta( importer_t *importer, uint32_t tra
          : (wave_imp->number_of_samples % summary->samples_in_frame);
 }
 
+static int wave_importer_set_lpcm_format( importer_t *importer, uint32_t track_number, lsmash_codec_type_t sample_type )
+{
+    if( !importer->info )
+        return LSMASH_ERR_NAMELESS;
+    if( track_number != 1 )
+        return LSMASH_ERR_FUNCTION_PARAM;
+    wave_importer_t *wave_imp = (wave_importer_t *)importer->info;
+    lsmash_audio_summary_t *summary = (lsmash_audio_summary_t *)lsmash_list_get_entry_data( importer->summaries, track_number );
+    if( !summary || wave_imp->au_number || wave_imp->conversion != WAVE_CONVERSION_NONE )
+        return LSMASH_ERR_NAMELESS;
+    lsmash_codec_specific_t *cs = isom_get_codec_specific( summary->opaque, LSMASH_CODEC_SPECIFIC_DATA_TYPE_QT_AUDIO_FORMAT_SPECIFIC_FLAGS );
+    if( !cs )
+        return LSMASH_ERR_NAMELESS;
+    lsmash_qt_audio_format_specific_flags_t *lpcm = (lsmash_qt_audio_format_specific_flags_t *)cs->data.structured;
+    waveformat_extended_t *wfx = &wave_imp->fmt.wfx;
+    uint32_t bits_per_sample = wfx->nChannels ? 8 * (wfx->nBlockAlign / wfx->nChannels) : 0;
+    int      is_float        = wave_is_float( &wave_imp->fmt );
+    if( lsmash_check_codec_type_identical( sample_type, QT_CODEC_TYPE_LPCM_AUDIO ) )
+        return 0;   /* as it is */
+    /* Every sample shall occupy the whole bits of its container to be converted. */
+    if( summary->sample_size != bits_per_sample )
+        return LSMASH_ERR_PATCH_WELCOME;
+    wave_conversion_t conversion;
+    uint32_t          sample_size = bits_per_sample;
+    if( lsmash_check_codec_type_identical( sample_type, QT_CODEC_TYPE_SOWT_AUDIO ) && !is_float && bits_per_sample == 16 )
+        conversion = WAVE_CONVERSION_NONE;
+    else if( lsmash_check_codec_type_identical( sample_type, QT_CODEC_TYPE_TWOS_AUDIO ) && !is_float && bits_per_sample == 8 )
+        conversion = WAVE_CONVERSION_SIGN_8;
+    else if( lsmash_check_codec_type_identical( sample_type, QT_CODEC_TYPE_TWOS_AUDIO ) && !is_float && bits_per_sample == 16 )
+        conversion = WAVE_CONVERSION_SWAP_16;
+    else if( lsmash_check_codec_type_identical( sample_type, QT_CODEC_TYPE_IN24_AUDIO ) && !is_float && bits_per_sample == 24 )
+        conversion = WAVE_CONVERSION_SWAP_24;
+    else if( lsmash_check_codec_type_identical( sample_type, QT_CODEC_TYPE_IN32_AUDIO ) && !is_float && bits_per_sample == 32 )
+        conversion = WAVE_CONVERSION_SWAP_32;
+    else if( lsmash_check_codec_type_identical( sample_type, QT_CODEC_TYPE_IN32_AUDIO ) && !is_float && bits_per_sample == 24 )
+    {
+        conversion  = WAVE_CONVERSION_EXPAND_24_32;
+        sample_size = 32;
+    }
+    else if( lsmash_check_codec_type_identical( sample_type, QT_CODEC_TYPE_FL32_AUDIO ) && is_float && bits_per_sample == 32 )
+        conversion = WAVE_CONVERSION_SWAP_32;
+    else if( lsmash_check_codec_type_identical( sample_type, QT_CODEC_TYPE_FL64_AUDIO ) && is_float && bits_per_sample == 64 )
+        conversion = WAVE_CONVERSION_SWAP_64;
+    else
+        return LSMASH_ERR_PATCH_WELCOME;
+    wave_imp->conversion         = conversion;
+    wave_imp->output_block_align = wfx->nChannels * (sample_size / 8);
+    summary->sample_type     = sample_type;
+    summary->sample_size     = sample_size;
+    summary->bytes_per_frame = wave_imp->output_block_align * summary->samples_in_frame;
+    summary->max_au_length   = summary->bytes_per_frame;
+    /* 'twos' requires the big endian flag even for 8-bit samples. */
+    if( conversion == WAVE_CONVERSION_SIGN_8 )
+        lpcm->format_flags |= QT_AUDIO_FORMAT_FLAG_SIGNED_INTEGER;
+    if( conversion != WAVE_CONVERSION_NONE )
+        lpcm->format_flags |= QT_AUDIO_FORMAT_FLAG_BIG_ENDIAN;
+    return 0;
+}
+
 static int wave_importer_construct_timeline( importer_t *importer, uint32_t track_number )
 {
     lsmash_audio_summary_t *summary = (lsmash_audio_summary_t *)lsmash_list_get_entry_data( importer->summaries, track_number );
@@ -393,6 +628,13 @@ static int wave_importer_construct_timeline( importer_t *importer, uint32_t trac
         }
     }
     wave_importer_t *wave_imp = (wave_importer_t *)importer->info;
+    if( wave_imp->output_block_align != wave_imp->fmt.wfx.nBlockAlign
+     || wave_imp->conversion != WAVE_CONVERSION_NONE )
+    {
+        /* The media timeline maps the samples stored in the file as they are, which differ from the converted ones. */
+        err = LSMASH_ERR_PATCH_WELCOME;
+        goto fail;
+    }
     if( (err = isom_timeline_set_track_ID( timeline, 1 )) < 0
      || (err = isom_timeline_set_movie_timescale( timeline, wave_imp->fmt.wfx.nSamplesPerSec )) < 0
      || (err = isom_timeline_set_media_timescale( timeline, wave_imp->fmt.wfx.nSamplesPerSec )) < 0
@@ -438,9 +680,12 @@ const importer_functions wave_importer =
 {
     { "WAVE", offsetof( importer_t, log_level ) },
     1,
+    wave_importer_detect,
     wave_importer_probe,
     wave_importer_get_accessunit,
     wave_importer_get_last_delta,
     wave_importer_cleanup,
-    wave_importer_construct_timeline
+    wave_importer_construct_timeline,
+    NULL,
+    wave_importer_set_lpcm_format
 };
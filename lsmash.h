@@ -46,9 +46,9 @@ extern "C" {
 /****************************************************************************
  * Version
  ****************************************************************************/
-#define LSMASH_VERSION_MAJOR  2
-#define LSMASH_VERSION_MINOR 16
-#define LSMASH_VERSION_MICRO  1
+#define LSMASH_VERSION_MAJOR  3
+#define LSMASH_VERSION_MINOR  0
+#define LSMASH_VERSION_MICRO  0
 
 #define LSMASH_VERSION_INT( a, b, c ) (((a) << 16) | ((b) << 8) | (c))
 
@@ -108,6 +108,7 @@ typedef enum
     LSMASH_FILE_MODE_MEDIA             = 1<<6,  /* media data */
     LSMASH_FILE_MODE_INDEX             = 1<<7,
     LSMASH_FILE_MODE_SEGMENT           = 1<<8,  /* segment */
+    LSMASH_FILE_MODE_PREAD             = 1<<9,  /* 'pread' in lsmash_file_parameters_t is available */
     LSMASH_FILE_MODE_WRITE_FRAGMENTED  = LSMASH_FILE_MODE_WRITE | LSMASH_FILE_MODE_FRAGMENTED,  /* deprecated */
 } lsmash_file_mode;
 
@@ -201,6 +202,9 @@ typedef enum
     ISOM_BRAND_TYPE_SSSS  = LSMASH_4CC( 's', 's', 's', 's' ),   /* Subsegment Index Segment */
 } lsmash_brand_type;
 
+/* Parameters of a file.
+ * Users setting up the custom I/O by themselves shall zero the whole structure before filling it
+ * so that members unknown to them keep the default behaviors. */
 typedef struct
 {
     lsmash_file_mode mode;  /* file modes */
@@ -255,6 +259,24 @@ typedef struct
     uint64_t max_chunk_size;            /* max size per chunk in bytes. 4*1024*1024 (4MiB) is default value. */
     /** demuxing only **/
     uint64_t max_read_size;             /* max size of reading from the file at a time. 4*1024*1024 (4MiB) is default value. */
+    /** optional custom I/O stuff **/
+    /* Attempt to read up to 'size' bytes at 'offset' bytes from the beginning of the file referenced by 'opaque'
+     * into the buffer starting at 'buf' without changing the location of the read/write pointer.
+     * This is optional and used only if 'mode' has LSMASH_FILE_MODE_PREAD but not LSMASH_FILE_MODE_WRITE and 'seek' is set.
+     * If used, reads don't need a seek beforehand, and samples can be fetched concurrently by track readers.
+     * lsmash_open_file() sets this and LSMASH_FILE_MODE_PREAD for regular files opened with 'open_mode' 1
+     * where the system supports it.
+     *
+     * Return the number of bytes read if successful.
+     * Return 0 if no more read.
+     * Return a negative value otherwise. */
+    int (*pread)
+    (
+        void    *opaque,
+        uint8_t *buf,
+        int      size,
+        uint64_t offset
+    );
 } lsmash_file_parameters_t;
 
 typedef int (*lsmash_adhoc_remux_callback)( void *param, uint64_t done, uint64_t total );
@@ -267,13 +289,19 @@ typedef struct
 
 /* Open a file where the path is given.
  * And if successful, set up the parameters by 'open_mode'.
- * Here, the 'open_mode' parameter is either 0 or 1 as follows:
+ * Here, the 'open_mode' parameter is either 0, 1, 2 or 3 as follows:
  *   0: Create a file for output/muxing operations.
  *      If a file with the same name already exists, its contents are discarded and the file is treated as a new file.
  *      If user specifies "-" for 'filename', operations are done on stdout.
  *      The file types or segment types are set up as specified in 'param'.
  *   1: Open a file for input/demuxing operations. The file must exist.
  *      If user specifies "-" for 'filename', operations are done on stdin.
+ *   2: Open a file for input/demuxing operations and in-place updating by lsmash_write_movie_in_place().
+ *      The file must exist. Standard streams are not available.
+ *   3: Create a virtual file for output/muxing operations to estimate the output by lsmash_get_output_estimate().
+ *      No file is created and no I/O is performed. 'filename' is not used except that "-" makes the file
+ *      behave like stdout, i.e. unseekable and fragmented.
+ *      Samples without data can be appended into this file, see lsmash_append_sample().
  *
  * This function sets up file modes minimally.
  * User can add additional modes and/or remove modes already set later.
@@ -304,6 +332,32 @@ int lsmash_close_file
     lsmash_file_parameters_t *param
 );
 
+typedef struct
+{
+    uint64_t file_size;         /* the size of the whole file */
+    uint64_t moov_size;         /* the size of the Movie Box */
+    uint32_t co64_track_count;  /* the number of tracks using the Chunk Large Offset Box instead of the Chunk Offset Box */
+    uint32_t fragment_count;    /* the number of Movie Fragment Boxes */
+    uint64_t moof_size;         /* the total size of Movie Fragment Boxes */
+    uint32_t sidx_count;        /* the number of Segment Index Boxes */
+    uint64_t sidx_size;         /* the total size of Segment Index Boxes */
+    uint64_t mfra_size;         /* the size of the Movie Fragment Random Access Box */
+} lsmash_output_estimate_t;
+
+/* Get the layout of the output written into the active file in a given ROOT so far.
+ * The file shall be opened with 'open_mode' = 3 by lsmash_open_file().
+ * The layout is exactly the same as the one of the output into a real file with the same operations
+ * because the virtual file goes through the whole muxing except for the I/O.
+ * The final layout is available after lsmash_finish_movie().
+ *
+ * Return 0 if successful.
+ * Return a negative value otherwise. */
+int lsmash_get_output_estimate
+(
+    lsmash_root_t            *root,
+    lsmash_output_estimate_t *estimate
+);
+
 /* Associate a file with a ROOT and allocate the handle of that file.
  * The all allocated handles can be deallocated by lsmash_destroy_root().
  * If the ROOT has no associated file yet, the first associated file is activated.
@@ -361,6 +415,61 @@ int lsmash_switch_media_segment
     lsmash_adhoc_remux_t *remux
 );
 
+/****************************************************************************
+ * Performance Counters
+ ****************************************************************************/
+/* Timing spans around the heavy phases of processing */
+typedef enum
+{
+    LSMASH_TRACE_SPAN_READ_FILE          = 0,   /* reading the boxes of a file */
+    LSMASH_TRACE_SPAN_CONSTRUCT_TIMELINE = 1,   /* constructing the media timeline of a track */
+    LSMASH_TRACE_SPAN_FINISH_MOVIE       = 2,   /* finishing a movie by lsmash_finish_movie() */
+    LSMASH_TRACE_SPAN_PROBE_IMPORTER     = 3,   /* probing an input stream by an importer */
+    LSMASH_TRACE_SPAN_COUNT
+} lsmash_trace_span;
+
+/* The counters are shared by the whole process and updated by all threads. */
+typedef struct
+{
+    uint64_t bytes_read;                            /* the number of bytes read from streams */
+    uint64_t bytes_written;                         /* the number of bytes written into streams */
+    uint64_t read_calls;                            /* the number of calls of the read functions of streams */
+    uint64_t write_calls;                           /* the number of calls of the write functions of streams */
+    uint64_t seek_calls;                            /* the number of calls of the seek functions of streams */
+    uint64_t buffer_refills;                        /* the number of refills of the read buffers of streams */
+    uint64_t samples_pooled;                        /* the number of samples pooled to be interleaved */
+    uint64_t samples_flushed;                       /* the number of pooled samples written into streams */
+    uint64_t chunks_created;                        /* the number of chunks created in tracks */
+    uint64_t boxes_parsed;                          /* the number of boxes read from streams */
+    uint64_t boxes_written;                         /* the number of boxes written into streams */
+    uint64_t span_count[LSMASH_TRACE_SPAN_COUNT];   /* the number of finished spans for each kind */
+    uint64_t span_time [LSMASH_TRACE_SPAN_COUNT];   /* the total time of finished spans for each kind, in nanoseconds */
+} lsmash_stats_t;
+
+/* Get the current values of the performance counters. */
+void lsmash_get_stats
+(
+    lsmash_stats_t *stats
+);
+
+/* Reset all the performance counters to 0. */
+void lsmash_reset_stats( void );
+
+/* A trace callback is called at both the beginning and the end of each span.
+ * 'name' is the name of the importer for LSMASH_TRACE_SPAN_PROBE_IMPORTER, or NULL otherwise.
+ * 'is_end' is 0 at the beginning and 1 at the end.
+ * 'time' is the time of a monotonic clock in nanoseconds.
+ * The callback may be called from any thread where the library is used. */
+typedef void (*lsmash_trace_callback)( void *param, lsmash_trace_span span, const char *name, int is_end, uint64_t time );
+
+/* Set a trace callback, or unset it if 'func' is NULL.
+ * Users shall not call this function while the library is used by any other thread. */
+void lsmash_set_trace_callback
+(
+    lsmash_trace_callback func,
+    void                 *param
+);
+
 /****************************************************************************
  * Basic Types
  ****************************************************************************/
@@ -386,6 +495,37 @@ typedef enum
 /****************************************************************************
  * Allocation
  ****************************************************************************/
+/* Memory allocator
+ * All memory blocks allocated or deallocated by L-SMASH, including the data of samples,
+ * go through the functions of the current allocator.
+ * 'opaque' is passed to each function as it is. */
+typedef struct
+{
+    void *(*malloc) ( void *opaque, size_t size );              /* the same semantics as malloc() of standard C lib */
+    void *(*realloc)( void *opaque, void *ptr, size_t size );   /* the same semantics as realloc() of standard C lib */
+    void  (*free)   ( void *opaque, void *ptr );                /* the same semantics as free() of standard C lib */
+    void   *opaque;
+} lsmash_allocator_t;
+
+/* Replace the allocator used by L-SMASH.
+ * If 'allocator' is NULL, the allocator is restored to the default one based on the standard C lib.
+ * Buffers kept in the sample buffer pool are deallocated by the previous allocator before replacement.
+ * The allocator is shared by the whole process, so call this function before any other function of L-SMASH
+ * and don't change it while any memory block allocated by the previous allocator remains.
+ *
+ * Return 0 if successful.
+ * Return a negative value otherwise. */
+int lsmash_set_allocator
+(
+    const lsmash_allocator_t *allocator
+);
+
+/* Get the current allocator. */
+void lsmash_get_allocator
+(
+    lsmash_allocator_t *allocator
+);
+
 /* Allocate a memory block.
  * The allocated memory block can be deallocate by lsmash_free().
  *
@@ -1589,6 +1729,7 @@ typedef struct
 /* Allocate a sample and then allocate data of the allocated sample by 'size'.
  * If 'size' is set to 0, data of the allocated sample won't be allocated and will be set to NULL instead.
  * The allocated sample can be deallocated by lsmash_delete_sample().
+ * The data of the allocated sample is taken from the sample buffer pool if possible.
  *
  * Return the address of an allocated sample if successful.
  * Return NULL otherwise. */
@@ -1599,6 +1740,7 @@ lsmash_sample_t *lsmash_create_sample
 
 /* Allocate data of a given allocated sample by 'size'.
  * If the sample data is already allocated, reallocate it by 'size'.
+ * Data taken from the sample buffer pool is replaced with a larger buffer from the pool if needed.
  *
  * Return 0 if successful.
  * Return a negative value otherwise. */
@@ -1608,16 +1750,54 @@ int lsmash_sample_alloc
     uint32_t         size       /* size of sample data you request */
 );
 
-/* Deallocate a given sample. */
+/* Deallocate a given sample.
+ * The data of the sample goes back to the sample buffer pool if it came from there.
+ * Otherwise, the data is deallocated by lsmash_free().
+ * Don't deallocate the data taken from the pool by yourself. Use lsmash_sample_alloc() with 'size' 0 instead. */
 void lsmash_delete_sample
 (
     lsmash_sample_t *sample     /* the address of a sample you want to deallocate */
 );
 
+/* Sample buffer pool
+ * Sample data is recycled through the pool shared by the whole process so that steady-state
+ * muxing and demuxing need no heap allocation for sample data.
+ * Buffers are classified by capacities in four steps per power of two up to 64MiB. Larger ones are never pooled.
+ * The pool is thread-safe. */
+typedef struct
+{
+    uint64_t hits;              /* the number of buffers reused from the pool */
+    uint64_t misses;            /* the number of buffers newly allocated since the pool had no one fitting */
+    uint64_t recycled;          /* the number of buffers returned to the pool */
+    uint64_t discarded;         /* the number of buffers deallocated since the pool reached the limit */
+    uint64_t cached_count;      /* the number of buffers kept in the pool now */
+    uint64_t cached_size;       /* the total size of buffers kept in the pool now, in bytes */
+    uint64_t peak_cached_size;  /* the maximum value of 'cached_size' so far */
+} lsmash_sample_pool_stats_t;
+
+/* Set the maximum total size of buffers kept in the sample buffer pool.
+ * The default is 64MiB. 0 disables pooling of returned buffers.
+ * If the pool keeps more than 'max_size' bytes, all kept buffers are deallocated. */
+void lsmash_set_sample_pool_limit
+(
+    uint64_t max_size       /* the maximum total size, in bytes */
+);
+
+/* Deallocate all buffers kept in the sample buffer pool. */
+void lsmash_flush_sample_pool( void );
+
+/* Get the statistics of the sample buffer pool. */
+void lsmash_get_sample_pool_stats
+(
+    lsmash_sample_pool_stats_t *stats
+);
+
 /* Append a sample to a track.
  * Note:
  *   The appended sample will be deleted by lsmash_delete_sample() internally.
  *   Users shall not deallocate the sample by lsmash_delete_sample() if successful to append the sample.
+ *   For a virtual file to estimate the output, the data of the sample can be NULL.
+ *   Then only the size of the sample given by 'length' is used.
  *
  * Return 0 if successful.
  * Return a negative value otherwise. */
@@ -1628,6 +1808,32 @@ int lsmash_append_sample
     lsmash_sample_t *sample
 );
 
+/* Append the samples in a chunk of a track in a movie read from a file to another track.
+ * The samples from 'sample_number' to the end of the chunk containing it in the media timeline of the source track
+ * are appended as a new chunk. Their data is copied verbatim as one contiguous byte range, so the copy is done
+ * without per-sample processing and, for plain local files, in the kernel if possible.
+ * Any sample pooled in the destination track is written as a chunk in advance.
+ * The sample description index and the timestamps of each sample are kept as they are in the source track,
+ * so the destination track shall have the same sample descriptions in the same order.
+ * The number of the appended samples is set to '*sample_count', and the next chunk starts at 'sample_number' plus it.
+ * Note:
+ *   The media timeline of the source track shall be constructed in advance.
+ *   This function is available only for non-fragmented movies.
+ *   LPCM audio and hint tracks are not supported since their samples need processing.
+ *
+ * Return 0 if successful.
+ * Return LSMASH_ERR_PATCH_WELCOME if the samples cannot be copied verbatim, and then use lsmash_append_sample() instead.
+ * Return a negative value otherwise. */
+int lsmash_append_chunk_from_media_timeline
+(
+    lsmash_root_t *root,
+    uint32_t       track_ID,
+    lsmash_root_t *src_root,
+    uint32_t       src_track_ID,
+    uint32_t       sample_number,
+    uint32_t      *sample_count
+);
+
 /****************************************************************************
  * Media Layer
  ****************************************************************************/
@@ -1868,6 +2074,7 @@ int lsmash_get_media_parameters
 );
 
 /* Get the duration of a media.
+ * While muxing, this follows the samples appended after the media duration was updated last, in constant time.
  *
  * Return the duration of a media if successful.
  * Return 0 otherwise. */
@@ -1877,6 +2084,27 @@ uint64_t lsmash_get_media_duration
     uint32_t       track_ID
 );
 
+typedef struct
+{
+    uint32_t bufferSizeDB;  /* the size of the largest sample in bytes */
+    uint32_t maxBitrate;    /* the largest number of bits in any window of one second */
+    uint32_t avgBitrate;    /* the average bitrate in bits per second */
+} lsmash_bitrate_t;
+
+/* Get the bitrate of the samples associated with a sample description in a media.
+ * While muxing, this is available at any time, and doesn't rescan the sample tables.
+ * The average bitrate is measured over the media duration, or over the span of the samples appended so far if larger.
+ *
+ * Return 0 if successful.
+ * Return a negative value otherwise. */
+int lsmash_get_bitrate
+(
+    lsmash_root_t    *root,
+    uint32_t          track_ID,
+    uint32_t          sample_description_index,
+    lsmash_bitrate_t *bitrate
+);
+
 /* Get the timescale of a media.
  *
  * Return the timescale of a media if successful.
@@ -2275,6 +2503,22 @@ int lsmash_finish_movie
     lsmash_adhoc_remux_t *remux
 );
 
+/* Write the Movie Box of a non-fragmented movie read from a file opened with 'open_mode' = 2 back into that file.
+ * The media data is never moved, so the chunk offsets in the movie are kept as they are.
+ * The new Movie Box is placed as follows:
+ *   1. over the old one, and the following Free Space Boxes if any, when it fits there;
+ *   2. into a Free Space Box large enough elsewhere, and the old one is turned into a Free Space Box;
+ *   3. at the end of the file, and the old one is turned into a Free Space Box.
+ * Any remaining space is left as a Free Space Box.
+ * The movie shall not be read any more after calling this function.
+ *
+ * Return 0 if successful.
+ * Return a negative value otherwise. */
+int lsmash_write_movie_in_place
+(
+    lsmash_root_t *root
+);
+
 /* Update the modification time of a movie to the most recent.
  * If the creation time of that movie is larger than the modification time,
  * then override the creation one with the modification one.
@@ -2383,6 +2627,34 @@ int lsmash_create_fragment_movie
     lsmash_root_t *root
 );
 
+/* Set the sequence number of the next movie fragment created by lsmash_create_fragment_movie().
+ * This is useful when media segments of a presentation are written independently of each other,
+ * e.g. by separate ROOTs in parallel, since each ROOT numbers its movie fragments from 1 by default.
+ * Call this function after the active file is switched to the media segment and
+ * before the first movie fragment in it is created.
+ *
+ * Return 0 if successful.
+ * Return a negative value otherwise. */
+int lsmash_set_fragment_sequence_number
+(
+    lsmash_root_t *root,
+    uint32_t       sequence_number      /* the sequence_number of the next movie fragment ( >= 1) */
+);
+
+/* Set the sum of the durations of the subsegments preceding the next subsegment of a track.
+ * The Segment Index Boxes written afterwards express the earliest presentation times relative to this duration.
+ * Like lsmash_set_fragment_sequence_number(), this is useful when media segments of a presentation are written
+ * independently of each other.
+ *
+ * Return 0 if successful.
+ * Return a negative value otherwise. */
+int lsmash_set_preceding_subsegment_duration
+(
+    lsmash_root_t *root,
+    uint32_t       track_ID,
+    uint64_t       duration             /* the duration in the media timescale */
+);
+
 /* Create an empty duration track in the current movie fragment.
  * Don't specify track_ID any track fragment in the current movie fragment has.
  *
@@ -2408,6 +2680,59 @@ int lsmash_print_movie
     const char    *filename     /* the path of a file as the destination */
 );
 
+typedef enum
+{
+    LSMASH_PRINT_FORMAT_TEXT = 0,   /* human-readable indented text */
+    LSMASH_PRINT_FORMAT_JSON = 1,   /* JSON */
+    LSMASH_PRINT_FORMAT_CBOR = 2,   /* CBOR (Concise Binary Object Representation) */
+} lsmash_print_format;
+
+/* Read the active file in ROOT and print its box structure into the destination box by box.
+ * Unlike lsmash_print_movie(), each box is printed as soon as it has been read and then released
+ * unless subsequent boxes need it, so memory usage doesn't grow with the number of movie fragments.
+ * The file shall be set with LSMASH_FILE_MODE_DUMP and not be read by lsmash_read_file() yet.
+ * After this function returns, ROOT holds only a part of the boxes; nothing but destroying it is meaningful.
+ *
+ * The structured formats carry the same information as the text.
+ * The output is an array of nodes, and each box, descriptor or field makes a node, a map which has
+ *   "box"      : the box type, only for a box,
+ *   "tag"      : the descriptor tag, only for a descriptor,
+ *   "name"     : the name of the box, the descriptor or the field,
+ *   "index"    : the position of the field in an array, if any,
+ *   "value"    : the value of the field, if any,
+ *   "note"     : the meaning of the value, e.g. the description of a brand or the UTC of a time,
+ *   "unit"     : the unit of the value, and
+ *   "children" : an array of the nodes under this one, i.e. the fields and the child boxes.
+ * A value is typed: integers and fixed-point numbers are numbers, four-character codes and texts are strings,
+ * matrices and colors are arrays of numbers, times and durations are the raw numbers whose readable forms are in "note",
+ * binary data is a byte string in CBOR or an array of numbers in JSON, and an absent value is null.
+ *
+ * Return 0 if successful.
+ * Return a negative value otherwise. */
+int lsmash_print_movie_streaming
+(
+    lsmash_root_t      *root,       /* the address of ROOT you want to dump and print */
+    const char         *filename,   /* the path of a file as the destination */
+    lsmash_print_format format      /* the format of the output */
+);
+
+/* Print the decoding and composition timestamps of the samples of all tracks in the active file in ROOT.
+ * The media timelines of the tracks are constructed if not yet.
+ * The text format lists the timestamps sample by sample.
+ * The structured formats are column-oriented; the output is an array of maps, one per track, which has
+ *   "track_ID", "timescale" and the arrays "dts", "cts", "size", "offset" and "flags" (lsmash_random_access_flag)
+ * in decoding order.
+ * Composition timestamps are shifted by the composition to decode shift so that they are never less than decoding ones.
+ *
+ * Return 0 if successful.
+ * Return a negative value otherwise. */
+int lsmash_print_media_timestamps
+(
+    lsmash_root_t      *root,       /* the address of ROOT containing the tracks to print */
+    const char         *filename,   /* the path of a file as the destination */
+    lsmash_print_format format      /* the format of the output */
+);
+
 /* Print a chapter list written as a user data on stdout.
  * This function might output BOM on Windows.
  *
@@ -2602,6 +2927,36 @@ int lsmash_get_sample_info_from_media_timeline
     lsmash_sample_t *sample
 );
 
+/* the information of consecutive samples stored column by column
+ * Each non-NULL member points to an array which has at least as many elements as the requested samples.
+ * NULL members are skipped. */
+typedef struct
+{
+    uint64_t                 *dts;      /* Decoding TimeStamps */
+    uint64_t                 *cts;      /* Composition TimeStamps */
+    uint64_t                 *pos;      /* the absolute file offsets of the sample data */
+    uint32_t                 *length;   /* the sizes of the samples in bytes */
+    uint32_t                 *index;    /* the indexes of the sample descriptions */
+    lsmash_sample_property_t *prop;     /* the sample properties */
+} lsmash_sample_info_columns_t;
+
+/* Get the information of up to 'count' consecutive samples starting from a given sample number from the media timeline for a track.
+ * The information of each sample is stored into the arrays given by 'columns' in decoding order, the i-th sample of the range
+ * into the i-th elements. It is the same as what lsmash_get_sample_info_from_media_timeline() gets.
+ * Getting the information of the whole track range by range is as cheap as walking through the sample tables once.
+ *
+ * Return the number of the samples got if successful.
+ * It is less than 'count' only if the range goes beyond the last sample, and 0 if 'sample_number' does.
+ * Return a negative value otherwise. */
+int lsmash_get_sample_info_range_from_media_timeline
+(
+    lsmash_root_t                *root,
+    uint32_t                      track_ID,
+    uint32_t                      sample_number,
+    uint32_t                      count,
+    lsmash_sample_info_columns_t *columns
+);
+
 /* Get the properties of the sample correspondint to a given sample number from the media timeline for a track.
  *
  * Return 0 if successful.
@@ -2625,6 +2980,60 @@ int lsmash_check_sample_existence_in_media_timeline
     uint32_t       sample_number
 );
 
+/* A track reader is a lightweight cursor on the media timeline for a track.
+ * The functions above update the caches of the last accessed sample in the media timeline and read sample data
+ * through the bytestream shared by all tracks in the file, so they cannot be called concurrently.
+ * Each track reader owns its caches and reads sample data by positioned reads instead, so multiple threads can
+ * get samples from the same timeline or from different timelines in the same ROOT concurrently as long as each
+ * thread uses its own track readers.
+ *
+ * While track readers are in use,
+ *   - the ROOT shall not be modified, e.g. by constructing or destructing timelines and by reading boxes,
+ *   - the functions getting samples from the media timeline above shall not be called for the ROOT, and
+ *   - the track readers shall be deallocated by lsmash_destroy_track_reader() before the timeline is destructed.
+ * If the stream of a file has no positioned read, reads of sample data from the file are serialized. */
+typedef struct lsmash_track_reader_tag lsmash_track_reader_t;
+
+/* Allocate a track reader on the media timeline for a track.
+ * The timeline shall be constructed before this function is called.
+ *
+ * Return the address of an allocated track reader if successful.
+ * Return NULL otherwise. */
+lsmash_track_reader_t *lsmash_create_track_reader
+(
+    lsmash_root_t *root,
+    uint32_t       track_ID
+);
+
+/* Deallocate a given track reader. */
+void lsmash_destroy_track_reader
+(
+    lsmash_track_reader_t *reader
+);
+
+/* Allocate and get the sample corresponding to a given sample number by a track reader.
+ * The allocated sample can be deallocated by lsmash_delete_sample().
+ *
+ * Return the address of an allocated and gotten sample if successful.
+ * Return NULL otherwise. */
+lsmash_sample_t *lsmash_get_sample_from_track_reader
+(
+    lsmash_track_reader_t *reader,
+    uint32_t               sample_number
+);
+
+/* Get the information of the sample corresponding to a given sample number by a track reader.
+ * The information includes the size, timestamps and properties of the sample.
+ *
+ * Return 0 if successful.
+ * Return a negative value otherwise. */
+int lsmash_get_sample_info_from_track_reader
+(
+    lsmash_track_reader_t *reader,
+    uint32_t               sample_number,
+    lsmash_sample_t       *sample
+);
+
 /* Set or change the decoding and composition timestamps in the media timeline for a track.
  * This function doesn't support for any LPCM track currently.
  *
@@ -2637,6 +3046,23 @@ int lsmash_set_media_timestamps
     lsmash_media_ts_list_t *ts_list
 );
 
+/* Rebuild the Decoding Time to Sample Box, the Composition Time to Sample Box and the Composition to Decode Box
+ * of a track in a movie read from a file from the timestamps in its media timeline, e.g. set by
+ * lsmash_set_media_timestamps(), and then update the durations of the media, the track and the movie.
+ * If 'media_timescale' is not 0, the media timescale is replaced with it.
+ * The tables describing the sizes and the locations of samples are left as they are.
+ * This function doesn't support for any LPCM track and any fragmented movie currently.
+ *
+ * Return 0 if successful.
+ * Return a negative value othewise. */
+int lsmash_update_sample_timing_tables
+(
+    lsmash_root_t *root,
+    uint32_t       track_ID,
+    uint32_t       media_timescale,
+    uint32_t       last_sample_delta
+);
+
 /* Allocate and get the decoding and composition timestamps from the media timeline for a track.
  * The allocated decoding and composition timestamps can be deallocated by lsmash_delete_media_timestamps().
  *